@@ -0,0 +1,237 @@
+/*
+ * Glyph C6 Monitor - Wake-Cycle Energy Benchmark (host)
+ *
+ * Runs the deep-sleep firmware through the wake-cycle simulator under a
+ * set of seeded scenarios and prints mAh/day, awake seconds/day, delivered
+ * reports and the charge per delivered report. With a baseline file the
+ * run fails when any scenario spends more charge per delivered report
+ * than the baseline plus the threshold:
+ *
+ *     energy_bench [--days N] [--scenario NAME]
+ *                  [--baseline FILE] [--threshold PCT] [--write-baseline FILE]
+ *
+ * Results are deterministic for a given firmware and model; after an
+ * intended change, regenerate the baseline with --write-baseline.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "wake_sim.h"
+
+#define BENCH_DEFAULT_DAYS        30
+#define BENCH_DEFAULT_THRESHOLD   5.0     // Percent
+#define BENCH_MAX_SCENARIOS       8
+
+typedef struct {
+    const char *name;
+    void (*tweak)(wake_sim_config_t *cfg);
+} bench_scenario_t;
+
+static void tweak_none(wake_sim_config_t *cfg) { (void)cfg; }
+
+static void tweak_flaky_network(wake_sim_config_t *cfg)
+{
+    cfg->rejoin_ms = 1500;
+    cfg->rejoin_jitter_ms = 2000;
+    cfg->rejoin_failure = 0.10f;
+}
+
+static void tweak_noisy_sensor(wake_sim_config_t *cfg)
+{
+    cfg->sensor.noise_counts = 6.0f;
+    cfg->sensor.nack_probability = 0.01f;
+    cfg->sensor.glitch_probability = 0.005f;
+}
+
+static void tweak_dry_spell(wake_sim_config_t *cfg)
+{
+    cfg->watering_interval_days = 0.0f;
+}
+
+// Parent degrades on day 3 while a second router stays in range
+static void tweak_weak_parent(wake_sim_config_t *cfg)
+{
+    cfg->routers[0] = (host_zb_router_t){ .short_addr = 0x0000, .lqi = 200, .rssi = -60, .loss = 0.0f };
+    cfg->routers[1] = (host_zb_router_t){ .short_addr = 0x7A10, .lqi = 160, .rssi = -71, .loss = 0.02f };
+    cfg->router_count = 2;
+    cfg->link_change_day = 3.0f;
+    cfg->link_change_router = 0;
+    cfg->link_change_lqi = 70;
+    cfg->link_change_rssi = -88;
+    cfg->link_change_loss = 0.35f;
+}
+
+// Paired for the commissioning-free uplink; the sink misses some copies
+static void tweak_gp_uplink(wake_sim_config_t *cfg)
+{
+    cfg->gp_uplink = true;
+    cfg->gp_loss = 0.10f;
+}
+
+// Outdoor node: small panel, 30 mA at noon over 12 h of daylight
+static void tweak_solar(wake_sim_config_t *cfg)
+{
+    cfg->solar_peak_ma = 30.0f;
+    cfg->solar_day_hours = 12.0f;
+}
+
+// SHT4x on the STEMMA QT chain next to the soil sensor
+static void tweak_ambient(wake_sim_config_t *cfg)
+{
+    cfg->ambient = true;
+}
+
+static const bench_scenario_t scenarios[] = {
+    { "nominal",      tweak_none },
+    { "flaky_net",    tweak_flaky_network },
+    { "noisy_sensor", tweak_noisy_sensor },
+    { "dry_spell",    tweak_dry_spell },
+    { "weak_parent",  tweak_weak_parent },
+    { "gp_uplink",    tweak_gp_uplink },
+    { "solar",        tweak_solar },
+    { "ambient",      tweak_ambient },
+};
+
+#define NUM_SCENARIOS (sizeof(scenarios) / sizeof(scenarios[0]))
+
+typedef struct {
+    char name[32];
+    double uah_per_report;
+} baseline_entry_t;
+
+static int load_baseline(const char *path, baseline_entry_t *entries, int max)
+{
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "energy_bench: cannot read baseline %s\n", path);
+        return -1;
+    }
+    char line[128];
+    int n = 0;
+    while (n < max && fgets(line, sizeof(line), f)) {
+        if (line[0] == '#' || line[0] == '\n') {
+            continue;
+        }
+        if (sscanf(line, "%31s %lf", entries[n].name, &entries[n].uah_per_report) == 2) {
+            n++;
+        }
+    }
+    fclose(f);
+    return n;
+}
+
+static const baseline_entry_t *find_baseline(const baseline_entry_t *entries, int n, const char *name)
+{
+    for (int i = 0; i < n; i++) {
+        if (strcmp(entries[i].name, name) == 0) {
+            return &entries[i];
+        }
+    }
+    return NULL;
+}
+
+static void usage(void)
+{
+    fprintf(stderr, "usage: energy_bench [--days N] [--scenario NAME] [--baseline FILE]\n"
+                    "                    [--threshold PCT] [--write-baseline FILE]\n");
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t days = BENCH_DEFAULT_DAYS;
+    double threshold = BENCH_DEFAULT_THRESHOLD;
+    const char *only = NULL;
+    const char *baseline_path = NULL;
+    const char *write_path = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--days") == 0 && i + 1 < argc) {
+            days = (uint32_t)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--scenario") == 0 && i + 1 < argc) {
+            only = argv[++i];
+        } else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+            baseline_path = argv[++i];
+        } else if (strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) {
+            threshold = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--write-baseline") == 0 && i + 1 < argc) {
+            write_path = argv[++i];
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (days == 0) {
+        usage();
+        return 2;
+    }
+
+    baseline_entry_t baseline[BENCH_MAX_SCENARIOS];
+    int baseline_count = 0;
+    if (baseline_path) {
+        baseline_count = load_baseline(baseline_path, baseline, BENCH_MAX_SCENARIOS);
+        if (baseline_count < 0) {
+            return 2;
+        }
+    }
+
+    FILE *out = NULL;
+    if (write_path) {
+        out = fopen(write_path, "w");
+        if (!out) {
+            fprintf(stderr, "energy_bench: cannot write %s\n", write_path);
+            return 2;
+        }
+        fprintf(out, "# energy_bench baseline: uAh per delivered report (%lu days, seeded)\n",
+                (unsigned long)days);
+    }
+
+    printf("Deep-sleep firmware, %lu simulated days per scenario\n", (unsigned long)days);
+    printf("%-13s %8s %9s %8s %8s %7s %10s %8s %s\n", "scenario", "mAh/day", "awake s/d",
+           "wakes/d", "reports", "rep/d", "uAh/report", "life d", "vs baseline");
+
+    int failures = 0;
+    for (size_t i = 0; i < NUM_SCENARIOS; i++) {
+        if (only && strcmp(only, scenarios[i].name) != 0) {
+            continue;
+        }
+        wake_sim_config_t cfg;
+        wake_sim_default_config(&cfg);
+        cfg.days = days;
+        scenarios[i].tweak(&cfg);
+
+        wake_sim_result_t res;
+        if (wake_sim_run(&cfg, &res) != ESP_OK) {
+            printf("%-13s FAILED (firmware did not deep sleep)\n", scenarios[i].name);
+            failures++;
+            continue;
+        }
+
+        char verdict[48] = "";
+        const baseline_entry_t *base = find_baseline(baseline, baseline_count, scenarios[i].name);
+        if (base && base->uah_per_report > 0.0) {
+            double delta = (res.uah_per_report / base->uah_per_report - 1.0) * 100.0;
+            bool regressed = res.reports == 0 || delta > threshold;
+            snprintf(verdict, sizeof(verdict), "%+.1f%%%s", delta, regressed ? " REGRESSION" : "");
+            if (regressed) {
+                failures++;
+            }
+        }
+
+        printf("%-13s %8.3f %9.1f %8.1f %8lu %7.2f %10.1f %8.0f %s\n", scenarios[i].name,
+               res.mah_per_day, res.awake_s_per_day, res.wakes / res.days,
+               (unsigned long)res.reports, res.reports_per_day, res.uah_per_report,
+               res.battery_days, verdict);
+        if (out) {
+            fprintf(out, "%s %.1f\n", scenarios[i].name, res.uah_per_report);
+        }
+    }
+
+    if (out) {
+        fclose(out);
+    }
+    if (failures) {
+        printf("%d scenario(s) regressed more than %.1f%% per delivered report\n", failures, threshold);
+    }
+    return failures ? 1 : 0;
+}
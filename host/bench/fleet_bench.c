@@ -0,0 +1,132 @@
+/*
+ * Glyph C6 Monitor - Fleet Reporting Benchmark (host)
+ *
+ * Runs N simulated nodes against one coordinator on a shared 802.15.4
+ * channel and prints channel utilization, collision and retry rates,
+ * per-node awake time and end-to-end report delivery latency:
+ *
+ *     fleet_bench [--nodes N] [--days N] [--spread S] [--scenario NAME]
+ *                 [--min-delivery PCT]
+ *
+ * "staggered" powers the fleet on over --spread seconds; "synchronized"
+ * powers every node on within one second (a site after a power cut), so
+ * their wake cycles stay aligned and contend for the channel. With
+ * --min-delivery the run fails when any scenario delivers a smaller share
+ * of its reports.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "fleet_sim.h"
+
+#define BENCH_DEFAULT_NODES       50
+#define BENCH_DEFAULT_DAYS        3
+#define BENCH_DEFAULT_SPREAD_S    3600.0f
+
+typedef struct {
+    const char *name;
+    void (*tweak)(fleet_sim_config_t *cfg);
+} bench_scenario_t;
+
+static void tweak_none(fleet_sim_config_t *cfg) { (void)cfg; }
+
+static void tweak_synchronized(fleet_sim_config_t *cfg)
+{
+    cfg->start_spread_s = 1.0f;
+    cfg->env_jitter = 0.0f;
+}
+
+static const bench_scenario_t scenarios[] = {
+    { "staggered",    tweak_none },
+    { "synchronized", tweak_synchronized },
+};
+
+#define NUM_SCENARIOS (sizeof(scenarios) / sizeof(scenarios[0]))
+
+static double ratio_pct(uint64_t part, uint64_t whole)
+{
+    return whole ? 100.0 * (double)part / (double)whole : 0.0;
+}
+
+static void usage(void)
+{
+    fprintf(stderr, "usage: fleet_bench [--nodes N] [--days N] [--spread S] [--scenario NAME]\n"
+                    "                   [--min-delivery PCT]\n");
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t nodes = BENCH_DEFAULT_NODES;
+    uint32_t days = BENCH_DEFAULT_DAYS;
+    float spread_s = BENCH_DEFAULT_SPREAD_S;
+    double min_delivery = 0.0;
+    const char *only = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--nodes") == 0 && i + 1 < argc) {
+            nodes = (uint32_t)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--days") == 0 && i + 1 < argc) {
+            days = (uint32_t)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--spread") == 0 && i + 1 < argc) {
+            spread_s = (float)atof(argv[++i]);
+        } else if (strcmp(argv[i], "--scenario") == 0 && i + 1 < argc) {
+            only = argv[++i];
+        } else if (strcmp(argv[i], "--min-delivery") == 0 && i + 1 < argc) {
+            min_delivery = atof(argv[++i]);
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (nodes == 0 || days == 0) {
+        usage();
+        return 2;
+    }
+
+    printf("%lu nodes, one coordinator, %lu simulated days per scenario\n",
+           (unsigned long)nodes, (unsigned long)days);
+    printf("%-12s %7s %7s %7s %7s %8s %9s %9s %9s %7s %7s %9s\n", "scenario", "util%", "peak%",
+           "coll%", "retry%", "cca-bsy%", "delivered", "lat p50", "lat p99", "ind exp",
+           "ind pk", "awake s/d");
+
+    int failures = 0;
+    for (size_t i = 0; i < NUM_SCENARIOS; i++) {
+        if (only && strcmp(only, scenarios[i].name) != 0) {
+            continue;
+        }
+        fleet_sim_config_t cfg;
+        fleet_sim_default_config(&cfg);
+        cfg.nodes = nodes;
+        cfg.days = days;
+        cfg.start_spread_s = spread_s;
+        scenarios[i].tweak(&cfg);
+
+        fleet_sim_result_t res;
+        esp_err_t ret = fleet_sim_run(&cfg, &res);
+        if (ret != ESP_OK) {
+            printf("%-12s FAILED (%s)\n", scenarios[i].name,
+                   ret == ESP_ERR_NO_MEM ? "out of memory" : "firmware did not deep sleep");
+            failures++;
+            continue;
+        }
+
+        double delivered = ratio_pct(res.reports_delivered, res.reports);
+        bool short_delivery = res.reports == 0 || delivered < min_delivery;
+        printf("%-12s %7.3f %7.1f %7.2f %7.2f %8.2f %8.2f%% %7.1fms %7.1fms %7lu %7lu %9.1f%s\n",
+               scenarios[i].name, res.utilization * 100.0, res.peak_utilization * 100.0,
+               ratio_pct(res.collisions, res.attempts), ratio_pct(res.retries, res.attempts),
+               ratio_pct(res.cca_busy, res.cca_checks), delivered,
+               res.latency_p50_ms, res.latency_p99_ms, (unsigned long)res.indirect_expired,
+               (unsigned long)res.indirect_peak, res.awake_s_per_day_mean,
+               short_delivery && min_delivery > 0.0 ? "  BELOW MIN" : "");
+        if (short_delivery && min_delivery > 0.0) {
+            failures++;
+        }
+    }
+
+    if (failures) {
+        printf("%d scenario(s) failed or delivered less than %.1f%% of reports\n", failures, min_delivery);
+    }
+    return failures ? 1 : 0;
+}
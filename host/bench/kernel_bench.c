@@ -0,0 +1,173 @@
+/*
+ * Glyph C6 Monitor - RV32 Kernel Instruction-Count Benchmark (host)
+ *
+ * Runs the cross-compiled kernel harness (host/bench/rv32/kernels.c,
+ * built with the firmware's -Os RV32IMAC flags) under the instruction
+ * set simulator and prints, per kernel:
+ *
+ * - retired instructions per call, and the share spent in "__" runtime
+ *   helpers (soft-float, 64-bit multiply/divide)
+ * - code size of the kernel itself and of everything it reached
+ * - bytes per reading of the reading codec over the harness's series
+ *   (encoded natively: the format is the same on every target)
+ *
+ *     kernel_bench KERNELS_ELF [--profile]
+ *
+ * --profile adds the instructions retired per function over the whole run.
+ * Counts are exact and deterministic for a given compiler and source, so a
+ * float vs fixed-point or -Os vs -O2 change can be judged by diffing two
+ * runs. They are instruction counts, not cycles: flash cache misses and
+ * multi-cycle divides are not modelled.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "rv32_iss.h"
+#include "reading_codec.h"
+#include "reading_series.h"
+
+#define BENCH_MAX_INSTRUCTIONS   100000000ULL
+#define BENCH_PROFILE_TOP        25
+
+static void usage(void)
+{
+    fprintf(stderr, "usage: kernel_bench KERNELS_ELF [--profile]\n");
+}
+
+/**
+ * @brief Kernel symbol by region name (also matches GCC clones: name.constprop.0)
+ */
+static const rv32_symbol_t *kernel_symbol(const rv32_iss_t *iss, const char *name)
+{
+    size_t len = strlen(name);
+    for (size_t i = 0; i < iss->symbol_count; i++) {
+        const char *sym = iss->symbols[i].name;
+        if (strncmp(sym, name, len) == 0 && (sym[len] == '\0' || sym[len] == '.')) {
+            return &iss->symbols[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Encoded size of the harness's reading series
+ */
+static void print_codec_size(void)
+{
+    history_reading_t series[READING_SERIES_LEN];
+    uint8_t buf[READING_CODEC_MAX_RECORD];
+    reading_series_fill(series, READING_SERIES_LEN);
+
+    reading_codec_state_t codec;
+    reading_codec_begin(&codec, &series[0]);
+    size_t bytes = READING_CODEC_ABSOLUTE_LEN;
+    for (size_t i = 1; i < READING_SERIES_LEN; i++) {
+        bytes += reading_codec_encode(&codec, &series[i], buf, sizeof(buf));
+    }
+    printf("\nreading_codec: %u readings in %zu bytes, %.2f bytes/reading "
+           "(history_reading_t %zu, v1 flash record 6)\n", READING_SERIES_LEN, bytes,
+           (double)bytes / READING_SERIES_LEN, sizeof(history_reading_t));
+}
+
+static int by_executed(const void *a, const void *b)
+{
+    const rv32_symbol_t *sa = *(const rv32_symbol_t *const *)a;
+    const rv32_symbol_t *sb = *(const rv32_symbol_t *const *)b;
+    return (sb->executed > sa->executed) - (sb->executed < sa->executed);
+}
+
+static void print_profile(const rv32_iss_t *iss)
+{
+    const rv32_symbol_t **order = malloc(iss->symbol_count * sizeof(*order));
+    if (!order) {
+        return;
+    }
+    for (size_t i = 0; i < iss->symbol_count; i++) {
+        order[i] = &iss->symbols[i];
+    }
+    qsort(order, iss->symbol_count, sizeof(*order), by_executed);
+
+    printf("\n%-40s %12s %7s\n", "function (whole run)", "instructions", "bytes");
+    for (size_t i = 0; i < iss->symbol_count && i < BENCH_PROFILE_TOP; i++) {
+        if (order[i]->executed == 0) {
+            break;
+        }
+        printf("%-40s %12llu %7lu\n", order[i]->name, (unsigned long long)order[i]->executed,
+               (unsigned long)order[i]->size);
+    }
+    free(order);
+}
+
+int main(int argc, char **argv)
+{
+    const char *path = NULL;
+    bool profile = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--profile") == 0) {
+            profile = true;
+        } else if (argv[i][0] != '-' && !path) {
+            path = argv[i];
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (!path) {
+        usage();
+        return 2;
+    }
+
+    rv32_iss_t iss;
+    esp_err_t err = rv32_iss_load_elf(&iss, path);
+    if (err != ESP_OK) {
+        fprintf(stderr, "kernel_bench: cannot load %s (%s)\n", path,
+                err == ESP_ERR_NOT_FOUND ? "no such file" : "not an RV32 executable");
+        return 2;
+    }
+
+    rv32_stop_t stop = rv32_iss_run(&iss, BENCH_MAX_INSTRUCTIONS);
+    if (stop != RV32_STOP_EXIT || iss.exit_code != 0) {
+        if (stop == RV32_STOP_FAULT) {
+            fprintf(stderr, "kernel_bench: fault at pc 0x%08lx (insn 0x%08lx)\n",
+                    (unsigned long)iss.fault_pc, (unsigned long)iss.fault_insn);
+        } else if (stop == RV32_STOP_LIMIT) {
+            fprintf(stderr, "kernel_bench: no exit after %llu instructions\n",
+                    (unsigned long long)BENCH_MAX_INSTRUCTIONS);
+        } else {
+            fprintf(stderr, "kernel_bench: harness exited with %d\n", iss.exit_code);
+        }
+        rv32_iss_free(&iss);
+        return 1;
+    }
+    if (iss.region_count == 0) {
+        fprintf(stderr, "kernel_bench: harness reported no kernels\n");
+        rv32_iss_free(&iss);
+        return 1;
+    }
+
+    printf("RV32IMAC kernels from %s (%llu instructions retired)\n", path,
+           (unsigned long long)iss.instret);
+    printf("%-36s %6s %9s %8s %7s %7s %6s\n", "kernel", "calls", "insn/call", "helpers",
+           "bytes", "reach", "funcs");
+    for (size_t i = 0; i < iss.region_count; i++) {
+        const rv32_region_t *r = &iss.regions[i];
+        const rv32_symbol_t *sym = kernel_symbol(&iss, r->name);
+        char own[16] = "-";
+        if (sym) {
+            snprintf(own, sizeof(own), "%lu", (unsigned long)sym->size);
+        }
+        double per_call = r->calls ? (double)r->instructions / r->calls : 0.0;
+        double helpers = r->instructions ? 100.0 * r->helper_instructions / r->instructions : 0.0;
+        printf("%-36s %6lu %9.1f %7.1f%% %7s %7lu %6lu\n", r->name, (unsigned long)r->calls, per_call,
+               helpers, own, (unsigned long)r->reach_bytes, (unsigned long)r->functions);
+    }
+
+    print_codec_size();
+    if (profile) {
+        print_profile(&iss);
+    }
+    rv32_iss_free(&iss);
+    return 0;
+}
@@ -0,0 +1,196 @@
+/*
+ * Glyph C6 Monitor - Field Trace Replay Benchmark (host)
+ *
+ * Replays a field trace (console capture of the "FTRACE" dump, see
+ * main/field_trace.h) into the host build of the firmware and prints the
+ * recorded run next to the replayed one:
+ *
+ *     replay_bench TRACE [--days N] [--strict]
+ *     replay_bench --record TRACE [--days N] [--scenario NAME]
+ *
+ * --record writes the trace the firmware records under the wake-cycle
+ * simulator instead, in the device dump format. --strict fails the run
+ * when any replayed interaction had no recorded counterpart, or when a
+ * replay of unchanged firmware would not reproduce the trace (wake count
+ * or charge off by more than 1 %).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "field_trace.h"
+#include "trace_replay.h"
+#include "wake_sim.h"
+
+#define BENCH_RECORD_DEFAULT_DAYS   3
+#define BENCH_STRICT_TOLERANCE      0.01
+
+static void tweak_none(wake_sim_config_t *cfg) { (void)cfg; }
+
+static void tweak_flaky_network(wake_sim_config_t *cfg)
+{
+    cfg->rejoin_ms = 1500;
+    cfg->rejoin_jitter_ms = 2000;
+    cfg->rejoin_failure = 0.10f;
+}
+
+static void tweak_noisy_sensor(wake_sim_config_t *cfg)
+{
+    cfg->sensor.noise_counts = 6.0f;
+    cfg->sensor.nack_probability = 0.01f;
+    cfg->sensor.glitch_probability = 0.005f;
+}
+
+static const struct {
+    const char *name;
+    void (*tweak)(wake_sim_config_t *cfg);
+} scenarios[] = {
+    { "nominal",      tweak_none },
+    { "flaky_net",    tweak_flaky_network },
+    { "noisy_sensor", tweak_noisy_sensor },
+};
+
+#define NUM_SCENARIOS (sizeof(scenarios) / sizeof(scenarios[0]))
+
+static void usage(void)
+{
+    fprintf(stderr, "usage: replay_bench TRACE [--days N] [--strict]\n"
+                    "       replay_bench --record TRACE [--days N] [--scenario NAME]\n");
+}
+
+static int record(const char *path, uint32_t days, const char *scenario)
+{
+    wake_sim_config_t cfg;
+    wake_sim_default_config(&cfg);
+    cfg.days = days ? days : BENCH_RECORD_DEFAULT_DAYS;
+    size_t i = 0;
+    while (i < NUM_SCENARIOS && strcmp(scenarios[i].name, scenario) != 0) {
+        i++;
+    }
+    if (i == NUM_SCENARIOS) {
+        fprintf(stderr, "replay_bench: unknown scenario %s\n", scenario);
+        return 2;
+    }
+    scenarios[i].tweak(&cfg);
+
+    wake_sim_result_t res;
+    if (wake_sim_run(&cfg, &res) != ESP_OK) {
+        fprintf(stderr, "replay_bench: firmware did not deep sleep\n");
+        return 1;
+    }
+    size_t count = field_trace_export(NULL, 0);
+    field_trace_record_t *records = malloc((count ? count : 1) * sizeof(*records));
+    if (!records) {
+        return 1;
+    }
+    count = field_trace_export(records, count);
+    esp_err_t err = trace_replay_save(path, records, count);
+    free(records);
+    if (err != ESP_OK) {
+        fprintf(stderr, "replay_bench: cannot write %s\n", path);
+        return 2;
+    }
+    printf("Recorded %s: %lu records, %lu wakes over %lu days\n", scenario,
+           (unsigned long)count, (unsigned long)res.wakes, (unsigned long)cfg.days);
+    return 0;
+}
+
+static double per_day(double value, double days)
+{
+    return days > 0.0 ? value / days : 0.0;
+}
+
+static bool within(double replayed, double recorded)
+{
+    if (recorded == 0.0) {
+        return replayed == 0.0;
+    }
+    return fabs(replayed / recorded - 1.0) <= BENCH_STRICT_TOLERANCE;
+}
+
+int main(int argc, char **argv)
+{
+    const char *trace_path = NULL;
+    const char *record_path = NULL;
+    const char *scenario = "nominal";
+    uint32_t days = 0;
+    bool strict = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--days") == 0 && i + 1 < argc) {
+            days = (uint32_t)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            record_path = argv[++i];
+        } else if (strcmp(argv[i], "--scenario") == 0 && i + 1 < argc) {
+            scenario = argv[++i];
+        } else if (strcmp(argv[i], "--strict") == 0) {
+            strict = true;
+        } else if (argv[i][0] != '-' && !trace_path) {
+            trace_path = argv[i];
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (record_path) {
+        return trace_path ? (usage(), 2) : record(record_path, days, scenario);
+    }
+    if (!trace_path) {
+        usage();
+        return 2;
+    }
+
+    field_trace_record_t *records;
+    size_t count;
+    esp_err_t err = trace_replay_load(trace_path, &records, &count);
+    if (err != ESP_OK) {
+        fprintf(stderr, "replay_bench: cannot read %s (%s)\n", trace_path, esp_err_to_name(err));
+        return 2;
+    }
+
+    trace_replay_config_t cfg;
+    trace_replay_default_config(&cfg);
+    cfg.days = days;
+    trace_replay_result_t res;
+    err = trace_replay_run(records, count, &cfg, &res);
+    free(records);
+    if (err != ESP_OK) {
+        fprintf(stderr, "replay_bench: replay failed (%s)\n", esp_err_to_name(err));
+        return 1;
+    }
+
+    printf("Trace %s: %lu records, %.2f days\n", trace_path, (unsigned long)count, res.trace_days);
+    printf("%-8s %8s %8s %9s %9s %8s %8s\n", "", "wakes", "radio", "awake s/d", "radio s/d",
+           "mAh/day", "reports");
+    printf("%-8s %8lu %8lu %9.1f %9.1f %8.3f %8s\n", "trace",
+           (unsigned long)res.trace_wakes, (unsigned long)res.trace_radio_wakes,
+           per_day(res.trace_awake_s, res.trace_days), per_day(res.trace_radio_s, res.trace_days),
+           per_day(res.trace_charge_mah, res.trace_days), "-");
+    printf("%-8s %8lu %8lu %9.1f %9.1f %8.3f %8lu\n", "replay",
+           (unsigned long)res.wakes, (unsigned long)res.radio_wakes,
+           per_day(res.awake_s, res.days), per_day(res.radio_s, res.days),
+           per_day(res.charge_mah, res.days), (unsigned long)res.reports);
+    printf("Fidelity: i2c %lu exact, %lu held, %lu unmatched (%lu recorded failures); "
+           "adc %lu exact, %lu held, %lu unmatched\n",
+           (unsigned long)res.i2c_exact, (unsigned long)res.i2c_held,
+           (unsigned long)res.i2c_unmatched, (unsigned long)res.i2c_errors,
+           (unsigned long)res.adc_exact, (unsigned long)res.adc_held,
+           (unsigned long)res.adc_unmatched);
+
+    if (!strict) {
+        return 0;
+    }
+    int failures = 0;
+    if (res.i2c_unmatched || res.adc_unmatched) {
+        printf("STRICT: replayed interactions without a recorded counterpart\n");
+        failures++;
+    }
+    if (!within(res.wakes, res.trace_wakes) ||
+        !within(per_day(res.charge_mah, res.days), per_day(res.trace_charge_mah, res.trace_days))) {
+        printf("STRICT: replay diverges from the trace by more than %.0f%%\n",
+               BENCH_STRICT_TOLERANCE * 100.0);
+        failures++;
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,228 @@
+/*
+ * Glyph C6 Monitor - RV32 Kernel Harness (cross-compiled)
+ *
+ * Built with the RISC-V toolchain and the firmware's compiler flags, run
+ * under host/sim/rv32_iss by kernel_bench. Each kernel is called over a
+ * fixed input set inside a counted region; the simulator charges only the
+ * instructions retired outside main() - the kernel and what it calls
+ * (soft-float and 64-bit runtime helpers).
+ *
+ * Inputs are volatile and results go to volatile sinks, so -Os cannot
+ * fold or drop the calls. The inline averaging loops of main.c and
+ * battery_monitoring.c are mirrored here as noinline functions. The
+ * reading codec runs over reading_series.h, the series kernel_bench
+ * reports bytes per reading for.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "sensor_convert.h"
+#include "sample_window.h"
+#include "reading_codec.h"
+#include "reading_series.h"
+#include "system_config.h"
+
+// System calls of host/sim/rv32_iss.h
+#define SYS_REGION_BEGIN    0x4B0
+#define SYS_REGION_END      0x4B1
+
+#define COUNT_OF(a)         (sizeof(a) / sizeof((a)[0]))
+#define UP_TO(n, a)         ((n) < COUNT_OF(a) ? (n) : COUNT_OF(a))
+
+static inline __attribute__((always_inline)) long sys_call2(long n, long arg0, long arg1)
+{
+    register long a0 __asm__("a0") = arg0;
+    register long a1 __asm__("a1") = arg1;
+    register long a7 __asm__("a7") = n;
+    __asm__ volatile ("ecall" : "+r"(a0) : "r"(a1), "r"(a7) : "memory");
+    return a0;
+}
+
+#define REGION_BEGIN(name, calls)  sys_call2(SYS_REGION_BEGIN, (long)(name), (long)(calls))
+#define REGION_END()               sys_call2(SYS_REGION_END, 0, 0)
+
+// ============================================================================
+// INPUTS
+// ============================================================================
+
+// Dry air to beyond saturation
+static volatile uint16_t moisture_raw[] = {
+    250, 329, 400, 512, 600, 689, 750, 800, 875, 950, 1000, 1050, 1100, 1150, 700, 420,
+};
+
+// Seesaw 16.16 temperature: -5 °C to 45 °C
+static volatile int32_t temp_raw[] = {
+    -327680, 0, 327680, 786432, 1048576, 1310720, 1474560, 1638400, 2293760, 2949120,
+};
+
+// Calibrated pin millivolts (2:1 divider) and battery volts over every curve segment
+static volatile int adc_mv[] = { 1450, 1550, 1700, 1800, 1900, 2000, 2100, 2200, 2300 };
+static volatile float voltage[] = { 2.9f, 3.2f, 3.5f, 3.65f, 3.75f, 3.85f, 4.0f, 4.15f, 4.25f, 4.4f };
+
+static volatile float percent[] = { 0.0f, 12.5f, 33.3f, 50.0f, 66.7f, 87.5f, 99.9f, 100.0f };
+static volatile float celsius[] = { -5.25f, 0.0f, 12.5f, 21.75f, 30.0f, 44.9f };
+
+static volatile float sink_f;
+static volatile uint32_t sink_u;
+
+static sample_window_t window;
+static sample_window_stats_t stats;
+static uint8_t record[SAMPLE_WINDOW_RECORD_LEN];
+
+static history_reading_t series[READING_SERIES_LEN];
+static history_reading_t decoded[READING_SERIES_LEN];
+static uint8_t encoded[READING_SERIES_LEN * READING_CODEC_MAX_RECORD];
+
+// ============================================================================
+// MIRRORED KERNELS
+// ============================================================================
+
+/**
+ * @brief Float average of one report's samples (main.c read_averaged_sensors
+ *        before the soil path moved to integer 0.01 units; battery still)
+ */
+static __attribute__((noinline)) float average_samples(const volatile float *samples, int n)
+{
+    float sum = 0.0f;
+    int valid = 0;
+    for (int i = 0; i < n; i++) {
+        sum += samples[i];
+        valid++;
+    }
+    return valid > 0 ? sum / valid : 0.0f;
+}
+
+/**
+ * @brief Integer average (battery_monitoring.c millivolts, main.c soil 0.01 units)
+ */
+static __attribute__((noinline)) int average_mv(const volatile int *samples, int n)
+{
+    int total = 0;
+    int valid = 0;
+    for (int i = 0; i < n; i++) {
+        total += samples[i];
+        valid++;
+    }
+    return valid > 0 ? total / valid : 0;
+}
+
+// ============================================================================
+// HARNESS
+// ============================================================================
+
+int main(void)
+{
+    REGION_BEGIN("sensor_convert_moisture_percent", COUNT_OF(moisture_raw));
+    for (size_t i = 0; i < COUNT_OF(moisture_raw); i++) {
+        sink_f = sensor_convert_moisture_percent(moisture_raw[i]);
+    }
+    REGION_END();
+
+    REGION_BEGIN("sensor_convert_moisture_centi", COUNT_OF(moisture_raw));
+    for (size_t i = 0; i < COUNT_OF(moisture_raw); i++) {
+        sink_u = sensor_convert_moisture_centi(moisture_raw[i]);
+    }
+    REGION_END();
+
+    REGION_BEGIN("sensor_convert_temp_c", COUNT_OF(temp_raw));
+    for (size_t i = 0; i < COUNT_OF(temp_raw); i++) {
+        sink_f = sensor_convert_temp_c(temp_raw[i]);
+    }
+    REGION_END();
+
+    REGION_BEGIN("sensor_convert_temp_centi", COUNT_OF(temp_raw));
+    for (size_t i = 0; i < COUNT_OF(temp_raw); i++) {
+        sink_u = (uint32_t)sensor_convert_temp_centi(temp_raw[i]);
+    }
+    REGION_END();
+
+    REGION_BEGIN("sensor_convert_c_to_f", COUNT_OF(celsius));
+    for (size_t i = 0; i < COUNT_OF(celsius); i++) {
+        sink_f = sensor_convert_c_to_f(celsius[i]);
+    }
+    REGION_END();
+
+    REGION_BEGIN("sensor_convert_battery_voltage", COUNT_OF(adc_mv));
+    for (size_t i = 0; i < COUNT_OF(adc_mv); i++) {
+        sink_f = sensor_convert_battery_voltage(adc_mv[i]);
+    }
+    REGION_END();
+
+    REGION_BEGIN("sensor_convert_battery_percent", COUNT_OF(voltage));
+    for (size_t i = 0; i < COUNT_OF(voltage); i++) {
+        sink_f = sensor_convert_battery_percent(voltage[i]);
+    }
+    REGION_END();
+
+    REGION_BEGIN("average_samples", 1);
+    sink_f = average_samples(percent, UP_TO(POWER_FRUGAL_NUM_SAMPLES, percent));
+    REGION_END();
+
+    REGION_BEGIN("average_mv", 1);
+    sink_u = (uint32_t)average_mv(adc_mv, UP_TO(BATTERY_SAMPLES_AVG, adc_mv));
+    REGION_END();
+
+    REGION_BEGIN("sensor_convert_zcl_humidity", COUNT_OF(percent));
+    for (size_t i = 0; i < COUNT_OF(percent); i++) {
+        sink_u = sensor_convert_zcl_humidity(percent[i]);
+    }
+    REGION_END();
+
+    REGION_BEGIN("sensor_convert_zcl_temperature", COUNT_OF(celsius));
+    for (size_t i = 0; i < COUNT_OF(celsius); i++) {
+        sink_u = (uint16_t)sensor_convert_zcl_temperature(celsius[i]);
+    }
+    REGION_END();
+
+    REGION_BEGIN("sensor_convert_zcl_battery_percent", COUNT_OF(percent));
+    for (size_t i = 0; i < COUNT_OF(percent); i++) {
+        sink_u = sensor_convert_zcl_battery_percent(percent[i]);
+    }
+    REGION_END();
+
+    REGION_BEGIN("sensor_convert_zcl_battery_voltage", COUNT_OF(voltage));
+    for (size_t i = 0; i < COUNT_OF(voltage); i++) {
+        uint8_t dv = 0;
+        sink_u = sensor_convert_zcl_battery_voltage(voltage[i], &dv) ? dv : 0xFF;
+    }
+    REGION_END();
+
+    sample_window_reset(&window, 0);
+    REGION_BEGIN("sample_window_add", COUNT_OF(moisture_raw));
+    for (size_t i = 0; i < COUNT_OF(moisture_raw); i++) {
+        sample_window_add(&window, (uint16_t)(moisture_raw[i] * 8u), (int16_t)(temp_raw[i % COUNT_OF(temp_raw)] >> 10));
+    }
+    REGION_END();
+
+    REGION_BEGIN("sample_window_get_stats", 1);
+    sink_u = sample_window_get_stats(&window, 3600, &stats);
+    REGION_END();
+
+    REGION_BEGIN("sample_window_encode", 1);
+    sink_u = (uint32_t)sample_window_encode(&stats, record, sizeof(record));
+    REGION_END();
+
+    // One record per reading after the absolute first one
+    reading_series_fill(series, READING_SERIES_LEN);
+    reading_codec_state_t codec;
+    size_t len = 0;
+    reading_codec_begin(&codec, &series[0]);
+    REGION_BEGIN("reading_codec_encode", READING_SERIES_LEN - 1);
+    for (size_t i = 1; i < READING_SERIES_LEN; i++) {
+        len += reading_codec_encode(&codec, &series[i], &encoded[len], sizeof(encoded) - len);
+    }
+    REGION_END();
+
+    size_t pos = 0;
+    reading_codec_begin(&codec, &series[0]);
+    REGION_BEGIN("reading_codec_decode", READING_SERIES_LEN - 1);
+    for (size_t i = 1; i < READING_SERIES_LEN; i++) {
+        pos += reading_codec_decode(&codec, &encoded[pos], len - pos, &decoded[i]);
+    }
+    REGION_END();
+    if (pos != len || decoded[READING_SERIES_LEN - 1].time != series[READING_SERIES_LEN - 1].time) {
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,35 @@
+/*
+ * Glyph C6 Monitor - Reading Series for the Codec Kernels
+ *
+ * A deterministic field-like history (10-minute wakes with a second of
+ * jitter, slowly drying soil with sensor noise, a daily temperature
+ * cycle), shared by the cross-compiled harness (kernels.c, encode/decode
+ * instruction counts) and kernel_bench (bytes per reading), so both
+ * describe the same data. No libc.
+ */
+
+#ifndef READING_SERIES_H
+#define READING_SERIES_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "reading_codec.h"
+
+#define READING_SERIES_LEN      144     // One day
+
+static inline void reading_series_fill(history_reading_t *out, size_t n)
+{
+    // Triangle wave over the day: 16 °C at night to 24 °C mid-afternoon
+    uint32_t seed = 0x1234567u;
+    for (size_t i = 0; i < n; i++) {
+        seed = seed * 1103515245u + 12345u;
+        uint32_t noise = (seed >> 16) & 0x0F;
+        uint32_t hour_of_day = (uint32_t)(i % 144);
+        int32_t cycle = hour_of_day < 72 ? (int32_t)hour_of_day : (int32_t)(144 - hour_of_day);
+        out[i].time = 1000u + (uint32_t)i * 600u + ((seed >> 28) & 1u);
+        out[i].moisture_centi = (uint16_t)(6500u - (uint32_t)i * 2u + noise);
+        out[i].temp_centi = (int16_t)(1600 + cycle * 11 + (int32_t)(noise & 3));
+    }
+}
+
+#endif // READING_SERIES_H
@@ -0,0 +1,124 @@
+/*
+ * Glyph C6 Monitor - Soil Sensor Read Benchmark (host)
+ *
+ * Runs soil_sensor_read_all() against the Seesaw simulator under a set of
+ * timing/fault scenarios and prints, per scenario: success rate, virtual
+ * time per read (what the wake cycle pays), bus transfers per read and
+ * the moisture error against the noise-free value. Use it to evaluate
+ * driver delays, retries, bus speed and burst sampling without hardware.
+ *
+ *     seesaw_bench [reads_per_scenario]
+ *
+ * Exits non-zero if the nominal scenario does not read cleanly.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "host_sim.h"
+#include "seesaw_sim.h"
+#include "soil_sensor.h"
+#include "system_config.h"
+#include "driver/i2c_master.h"
+#include "esp_zigbee_core.h"
+
+#define BENCH_DEFAULT_READS   200
+#define BENCH_CAPACITANCE     700
+
+typedef struct {
+    const char *name;
+    void (*tweak)(seesaw_sim_config_t *cfg);
+} bench_scenario_t;
+
+static void tweak_none(seesaw_sim_config_t *cfg) { (void)cfg; }
+static void tweak_noise(seesaw_sim_config_t *cfg) { cfg->noise_counts = 8.0f; }
+static void tweak_slow(seesaw_sim_config_t *cfg) { cfg->touch_conversion_us = 6000; }
+static void tweak_nack(seesaw_sim_config_t *cfg) { cfg->nack_probability = 0.02f; }
+static void tweak_glitch(seesaw_sim_config_t *cfg) { cfg->glitch_probability = 0.01f; }
+
+static const bench_scenario_t scenarios[] = {
+    { "nominal",     tweak_none },
+    { "noise 8cnt",  tweak_noise },
+    { "slow 6ms",    tweak_slow },
+    { "nack 2%",     tweak_nack },
+    { "glitch 1%",   tweak_glitch },
+};
+
+// The host Zigbee stack calls into the application; no signals are raised here
+void esp_zb_app_signal_handler(esp_zb_app_signal_t *signal_struct)
+{
+    (void)signal_struct;
+}
+
+/**
+ * @brief Run one scenario; returns the number of clean reads
+ */
+static int run_scenario(const bench_scenario_t *sc, int reads)
+{
+    host_sim_reset();
+    host_log_set_level(0);   // ESP_LOG_NONE: failures are counted, not printed
+
+    seesaw_sim_config_t cfg;
+    seesaw_sim_default_config(&cfg);
+    cfg.seed = 1;
+    sc->tweak(&cfg);
+
+    static seesaw_sim_t sim;
+    i2c_master_bus_config_t bus_cfg = { .i2c_port = I2C_NUM_0 };
+    i2c_master_bus_handle_t bus;
+    i2c_new_master_bus(&bus_cfg, &bus);
+    seesaw_sim_attach(&sim, &cfg, SOIL_SENSOR_ADDR);
+    soil_sensor_init(bus);
+    seesaw_sim_set_capacitance(&sim, BENCH_CAPACITANCE);
+
+    float expected = ((float)(BENCH_CAPACITANCE - SOIL_VALUE_DRY) /
+                      (float)(SOIL_VALUE_WET - SOIL_VALUE_DRY)) * 100.0f;
+    uint32_t transfers_start = host_i2c_transfer_count();
+    uint64_t start = host_time_now_us();
+    int ok = 0, clean = 0;
+    double err_sum = 0.0, err_max = 0.0;
+
+    for (int i = 0; i < reads; i++) {
+        soil_data_t data;
+        if (soil_sensor_read_all(&data) != ESP_OK) {
+            continue;
+        }
+        ok++;
+        double err = fabs(data.moisture_centi / 100.0 - expected);
+        err_sum += err;
+        if (err > err_max) {
+            err_max = err;
+        }
+        if (data.moisture_raw != 0xFFFF && err < 5.0) {
+            clean++;
+        }
+    }
+
+    double per_read_ms = (double)(host_time_now_us() - start) / 1000.0 / reads;
+    double transfers = (double)(host_i2c_transfer_count() - transfers_start) / reads;
+    printf("%-12s %7.1f%% %7.1f%% %9.2f %9.1f %8.2f %8.2f\n", sc->name,
+           100.0 * ok / reads, 100.0 * clean / reads, per_read_ms, transfers,
+           ok ? err_sum / ok : 0.0, err_max);
+    return clean;
+}
+
+int main(int argc, char **argv)
+{
+    int reads = (argc > 1) ? atoi(argv[1]) : BENCH_DEFAULT_READS;
+    if (reads <= 0) {
+        reads = BENCH_DEFAULT_READS;
+    }
+
+    printf("soil_sensor_read_all x %d per scenario (virtual time)\n", reads);
+    printf("%-12s %8s %8s %9s %9s %8s %8s\n", "scenario", "ok", "clean",
+           "ms/read", "xfer/rd", "err avg", "err max");
+
+    int nominal_clean = 0;
+    for (size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+        int clean = run_scenario(&scenarios[i], reads);
+        if (i == 0) {
+            nominal_clean = clean;
+        }
+    }
+    return (nominal_clean == reads) ? 0 : 1;
+}
@@ -0,0 +1,264 @@
+/*
+ * Glyph C6 Monitor - Zigbee2MQTT Report Recorder (host)
+ *
+ * Runs the deep-sleep firmware under the wake-cycle simulator and records
+ * every ZCL attribute report it sends, as the coordinator receives them,
+ * for the converter harness in z2m/test:
+ *
+ *     z2m_record OUT.json [--days N] [--history-hours H]
+ *
+ * The explicit reports (windowStats, wateringEvents, historyChunk, power
+ * source, configPending) come from the report log. Measurements travel by
+ * configured reporting, which the host stack does not model: they are
+ * recorded from the attribute store next to each windowStats report, for
+ * the soil endpoint and the ambient one (an SHT4x is on the simulated bus).
+ *
+ * On the first joined wake after the second half of the run the recorder
+ * writes historyRequest for the last H hours (default: the whole run), as
+ * the converter's history_request does, and stores the readings the flash
+ * history holds for that range. The harness checks that the decoded
+ * history chunks reproduce them exactly.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "wake_sim.h"
+#include "host_sim.h"
+#include "zigbee_core.h"
+#include "history_log.h"
+#include "deep_sleep.h"
+#include "system_config.h"
+
+#define RECORD_DEFAULT_DAYS        6
+#define RECORD_MAX_MESSAGES        8192
+#define RECORD_MAX_HISTORY         8192
+#define RECORD_REQUEST_DELAY_US    200000ULL   // After join: while the wake reports
+
+// ZCL identifiers of the measurements (esp_zigbee_cluster.h values)
+#define ZCL_CLUSTER_POWER_CONFIG   0x0001
+#define ZCL_CLUSTER_TEMPERATURE    0x0402
+#define ZCL_CLUSTER_HUMIDITY       0x0405
+#define ZCL_ATTR_BATTERY_VOLTAGE   0x0020
+#define ZCL_ATTR_BATTERY_PERCENT   0x0021
+#define ZCL_ATTR_MEASURED_VALUE    0x0000
+
+typedef struct {
+    uint64_t time_us;
+    uint8_t endpoint;
+    uint16_t cluster_id;
+    uint16_t attr_id;
+    uint8_t value[64];
+    uint8_t value_len;
+} record_message_t;
+
+typedef struct {
+    record_message_t *messages;
+    size_t count;
+    bool overflow;
+    bool started;
+    uint64_t start_us;                // First stack activity of the run
+    uint64_t request_after_us;        // Relative to start_us
+    uint32_t history_hours;
+    bool requested;
+    uint32_t request_age_sec;
+    history_reading_t *history;
+    size_t history_count;
+} recorder_t;
+
+static recorder_t rec;
+
+static void usage(void)
+{
+    fprintf(stderr, "usage: z2m_record OUT.json [--days N] [--history-hours H]\n");
+}
+
+static void add_message(uint64_t time_us, uint8_t endpoint, uint16_t cluster_id, uint16_t attr_id,
+                        const uint8_t *value, size_t len)
+{
+    if (rec.count == RECORD_MAX_MESSAGES) {
+        rec.overflow = true;
+        return;
+    }
+    record_message_t *m = &rec.messages[rec.count++];
+    m->time_us = time_us;
+    m->endpoint = endpoint;
+    m->cluster_id = cluster_id;
+    m->attr_id = attr_id;
+    m->value_len = (uint8_t)(len < sizeof(m->value) ? len : sizeof(m->value));
+    memcpy(m->value, value, m->value_len);
+}
+
+/**
+ * @brief Measurements as configured reporting would deliver them
+ */
+static void add_measurements(uint64_t time_us)
+{
+    static const struct {
+        uint8_t endpoint;
+        uint16_t cluster_id;
+        uint16_t attr_id;
+    } measurements[] = {
+        { HA_ESP_SENSOR_ENDPOINT,  ZCL_CLUSTER_HUMIDITY,     ZCL_ATTR_MEASURED_VALUE },
+        { HA_ESP_SENSOR_ENDPOINT,  ZCL_CLUSTER_TEMPERATURE,  ZCL_ATTR_MEASURED_VALUE },
+        { HA_ESP_SENSOR_ENDPOINT,  ZCL_CLUSTER_POWER_CONFIG, ZCL_ATTR_BATTERY_VOLTAGE },
+        { HA_ESP_SENSOR_ENDPOINT,  ZCL_CLUSTER_POWER_CONFIG, ZCL_ATTR_BATTERY_PERCENT },
+        { HA_ESP_AMBIENT_ENDPOINT, ZCL_CLUSTER_HUMIDITY,     ZCL_ATTR_MEASURED_VALUE },
+        { HA_ESP_AMBIENT_ENDPOINT, ZCL_CLUSTER_TEMPERATURE,  ZCL_ATTR_MEASURED_VALUE },
+    };
+    for (size_t i = 0; i < sizeof(measurements) / sizeof(measurements[0]); i++) {
+        uint8_t value[4];
+        int len = host_zb_get_attr(measurements[i].endpoint, measurements[i].cluster_id,
+                                   measurements[i].attr_id, value, sizeof(value));
+        if (len > 0) {
+            add_message(time_us, measurements[i].endpoint, measurements[i].cluster_id,
+                        measurements[i].attr_id, value, (size_t)len);
+        }
+    }
+}
+
+/**
+ * @brief Coordinator side of history_request: expected readings, then the write
+ */
+static void send_history_request(void *arg)
+{
+    (void)arg;
+    uint32_t now = deep_sleep_get_time_sec();
+    uint32_t start = rec.request_age_sec < now ? now - rec.request_age_sec : 0;
+
+    history_cursor_t cursor;
+    if (history_log_query(start, now, &cursor) == ESP_OK) {
+        size_t n;
+        while (rec.history_count < RECORD_MAX_HISTORY &&
+               (n = history_log_read(&cursor, &rec.history[rec.history_count],
+                                     RECORD_MAX_HISTORY - rec.history_count)) > 0) {
+            rec.history_count += n;
+        }
+    }
+
+    // Octet string: length, start_age u32, end_age u32 (little-endian)
+    uint8_t value[9] = { 8 };
+    for (int i = 0; i < 4; i++) {
+        value[1 + i] = (uint8_t)(rec.request_age_sec >> (8 * i));
+    }
+    if (host_zb_write_attr(HA_ESP_SENSOR_ENDPOINT, GLYPH_CLUSTER_ID_STATS,
+                           GLYPH_ATTR_HISTORY_REQUEST_ID, value, sizeof(value)) != ESP_OK) {
+        fprintf(stderr, "z2m_record: historyRequest write rejected\n");
+    }
+}
+
+static void on_zb_event(const host_zb_event_t *event, void *ctx)
+{
+    (void)ctx;
+    if (!rec.started) {
+        rec.started = true;
+        rec.start_us = event->time_us;
+    }
+    if (event->type == HOST_ZB_EVENT_JOINED && !rec.requested &&
+        event->time_us - rec.start_us >= rec.request_after_us) {
+        rec.requested = true;
+        host_time_schedule(RECORD_REQUEST_DELAY_US, send_history_request, NULL);
+        return;
+    }
+    if (event->type != HOST_ZB_EVENT_REPORT) {
+        return;
+    }
+    const host_zb_report_t *r = host_zb_report_get(host_zb_report_count() - 1);
+    if (!r) {
+        return;
+    }
+    if (r->cluster_id == GLYPH_CLUSTER_ID_STATS && r->attr_id == GLYPH_ATTR_WINDOW_STATS_ID) {
+        add_measurements(r->time_us);
+    }
+    add_message(r->time_us, HA_ESP_SENSOR_ENDPOINT, r->cluster_id, r->attr_id, r->value, r->value_len);
+}
+
+static int write_json(const char *path, uint32_t days)
+{
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        return -1;
+    }
+    fprintf(f, "{\n  \"source\": \"z2m_record\",\n  \"days\": %lu,\n  \"history_request_hours\": %lu,\n",
+            (unsigned long)days, (unsigned long)rec.history_hours);
+    fprintf(f, "  \"messages\": [\n");
+    for (size_t i = 0; i < rec.count; i++) {
+        const record_message_t *m = &rec.messages[i];
+        fprintf(f, "    {\"t_ms\": %llu, \"type\": \"attributeReport\", \"ep\": %u, \"cluster\": %u, \"attr\": %u, \"value\": \"",
+                (unsigned long long)(m->time_us / 1000), m->endpoint, m->cluster_id, m->attr_id);
+        for (size_t j = 0; j < m->value_len; j++) {
+            fprintf(f, "%02x", m->value[j]);
+        }
+        fprintf(f, "\"}%s\n", i + 1 < rec.count ? "," : "");
+    }
+    fprintf(f, "  ],\n  \"history\": [\n");
+    for (size_t i = 0; i < rec.history_count; i++) {
+        const history_reading_t *h = &rec.history[i];
+        fprintf(f, "    [%u, %d]%s\n", h->moisture_centi, h->temp_centi,
+                i + 1 < rec.history_count ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+    return fclose(f);
+}
+
+int main(int argc, char **argv)
+{
+    const char *path = NULL;
+    uint32_t days = RECORD_DEFAULT_DAYS;
+    uint32_t hours = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--days") == 0 && i + 1 < argc) {
+            days = (uint32_t)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--history-hours") == 0 && i + 1 < argc) {
+            hours = (uint32_t)atoi(argv[++i]);
+        } else if (argv[i][0] != '-' && !path) {
+            path = argv[i];
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (!path || days == 0) {
+        usage();
+        return 2;
+    }
+
+    rec.messages = calloc(RECORD_MAX_MESSAGES, sizeof(*rec.messages));
+    rec.history = calloc(RECORD_MAX_HISTORY, sizeof(*rec.history));
+    if (!rec.messages || !rec.history) {
+        return 1;
+    }
+    rec.history_hours = hours ? hours : days * 24;
+    rec.request_age_sec = rec.history_hours * 3600;
+
+    wake_sim_config_t cfg;
+    wake_sim_default_config(&cfg);
+    cfg.days = days;
+    cfg.ambient = true;
+    cfg.zb_event_hook = on_zb_event;
+    rec.request_after_us = (uint64_t)days * 43200ULL * 1000000ULL;
+
+    wake_sim_result_t res;
+    int ret = 0;
+    if (wake_sim_run(&cfg, &res) != ESP_OK) {
+        fprintf(stderr, "z2m_record: firmware did not deep sleep\n");
+        ret = 1;
+    } else if (!rec.requested) {
+        fprintf(stderr, "z2m_record: no joined wake to pull history in\n");
+        ret = 1;
+    } else if (rec.overflow) {
+        fprintf(stderr, "z2m_record: more than %d reports, shorten --days\n", RECORD_MAX_MESSAGES);
+        ret = 1;
+    } else if (write_json(path, days) != 0) {
+        fprintf(stderr, "z2m_record: cannot write %s\n", path);
+        ret = 2;
+    } else {
+        printf("Recorded %lu reports over %lu days (%lu wakes); history pull of %lu h: %lu readings\n",
+               (unsigned long)rec.count, (unsigned long)days, (unsigned long)res.wakes,
+               (unsigned long)rec.history_hours, (unsigned long)rec.history_count);
+    }
+    free(rec.messages);
+    free(rec.history);
+    return ret;
+}
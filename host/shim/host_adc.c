@@ -0,0 +1,174 @@
+/*
+ * Glyph C6 Monitor - Host Shim: ADC Oneshot and Calibration
+ *
+ * Version: 1.0.0
+ *
+ * 12-bit conversion over a linear 0..3300 mV range (12 dB attenuation);
+ * the curve-fitting scheme is the exact inverse, so calibrated readings
+ * return the pin voltage within one LSB.
+ */
+
+#include "host_sim.h"
+#include "host_internal.h"
+#include "esp_adc/adc_oneshot.h"
+#include "esp_adc/adc_cali.h"
+#include "esp_adc/adc_cali_scheme.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define HOST_ADC_CHANNELS   8
+#define HOST_ADC_FULL_MV    3300
+#define HOST_ADC_MAX_RAW    4095
+
+struct host_adc_unit {
+    adc_unit_t unit_id;
+};
+
+struct host_adc_cali {
+    adc_unit_t unit_id;
+};
+
+typedef struct {
+    int millivolts;
+    host_adc_source_t source;
+    void *ctx;
+} host_adc_channel_t;
+
+static host_adc_channel_t channels[HOST_ADC_CHANNELS];
+static int fail_next;
+static bool calibration_available;
+static uint32_t reads;
+
+// ============================================================================
+// SIMULATION CONTROL
+// ============================================================================
+
+void host_adc_reset(void)
+{
+    memset(channels, 0, sizeof(channels));
+    fail_next = 0;
+    calibration_available = true;
+    reads = 0;
+}
+
+void host_adc_set_mv(int channel, int millivolts)
+{
+    if (channel >= 0 && channel < HOST_ADC_CHANNELS) {
+        channels[channel].millivolts = millivolts;
+        channels[channel].source = NULL;
+    }
+}
+
+void host_adc_set_source(int channel, host_adc_source_t source, void *ctx)
+{
+    if (channel >= 0 && channel < HOST_ADC_CHANNELS) {
+        channels[channel].source = source;
+        channels[channel].ctx = ctx;
+    }
+}
+
+int host_adc_raw_to_mv(int raw)
+{
+    return (raw * HOST_ADC_FULL_MV + HOST_ADC_MAX_RAW / 2) / HOST_ADC_MAX_RAW;
+}
+
+void host_adc_fail_next(int n)
+{
+    fail_next = n;
+}
+
+void host_adc_set_calibration_available(bool available)
+{
+    calibration_available = available;
+}
+
+uint32_t host_adc_read_count(void)
+{
+    return reads;
+}
+
+// ============================================================================
+// DRIVER API
+// ============================================================================
+
+esp_err_t adc_oneshot_new_unit(const adc_oneshot_unit_init_cfg_t *init_config, adc_oneshot_unit_handle_t *ret_unit)
+{
+    if (!init_config || !ret_unit) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    struct host_adc_unit *unit = calloc(1, sizeof(*unit));
+    if (!unit) {
+        return ESP_ERR_NO_MEM;
+    }
+    unit->unit_id = init_config->unit_id;
+    *ret_unit = unit;
+    return ESP_OK;
+}
+
+esp_err_t adc_oneshot_config_channel(adc_oneshot_unit_handle_t handle, adc_channel_t channel,
+                                     const adc_oneshot_chan_cfg_t *config)
+{
+    if (!handle || !config || channel >= HOST_ADC_CHANNELS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return ESP_OK;
+}
+
+esp_err_t adc_oneshot_read(adc_oneshot_unit_handle_t handle, adc_channel_t chan, int *out_raw)
+{
+    if (!handle || !out_raw || chan >= HOST_ADC_CHANNELS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    reads++;
+    if (fail_next > 0) {
+        fail_next--;
+        return ESP_ERR_TIMEOUT;
+    }
+    const host_adc_channel_t *ch = &channels[chan];
+    int mv = ch->source ? ch->source((int)chan, ch->ctx) : ch->millivolts;
+    if (ch->source && mv < 0) {
+        return ESP_ERR_TIMEOUT;  // Source scripted a failed conversion
+    }
+    int raw = (int)(((int64_t)mv * HOST_ADC_MAX_RAW + HOST_ADC_FULL_MV / 2) / HOST_ADC_FULL_MV);
+    *out_raw = raw < 0 ? 0 : (raw > HOST_ADC_MAX_RAW ? HOST_ADC_MAX_RAW : raw);
+    return ESP_OK;
+}
+
+esp_err_t adc_oneshot_del_unit(adc_oneshot_unit_handle_t handle)
+{
+    free(handle);
+    return ESP_OK;
+}
+
+esp_err_t adc_cali_create_scheme_curve_fitting(const adc_cali_curve_fitting_config_t *config,
+                                               adc_cali_handle_t *ret_handle)
+{
+    if (!config || !ret_handle) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!calibration_available) {
+        return ESP_ERR_NOT_SUPPORTED;  // eFuse not burnt
+    }
+    struct host_adc_cali *cali = calloc(1, sizeof(*cali));
+    if (!cali) {
+        return ESP_ERR_NO_MEM;
+    }
+    cali->unit_id = config->unit_id;
+    *ret_handle = cali;
+    return ESP_OK;
+}
+
+esp_err_t adc_cali_delete_scheme_curve_fitting(adc_cali_handle_t handle)
+{
+    free(handle);
+    return ESP_OK;
+}
+
+esp_err_t adc_cali_raw_to_voltage(adc_cali_handle_t handle, int raw, int *voltage)
+{
+    if (!handle || !voltage) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *voltage = (raw * HOST_ADC_FULL_MV + HOST_ADC_MAX_RAW / 2) / HOST_ADC_MAX_RAW;
+    return ESP_OK;
+}
@@ -0,0 +1,268 @@
+/*
+ * Glyph C6 Monitor - Host Shim: AES-128 CCM
+ *
+ * Version: 1.0.0
+ *
+ * FIPS 197 AES-128 (encryption only, all CCM needs) and RFC 3610 CCM
+ * behind the mbedtls API the firmware uses (the chip's mbedtls runs on
+ * the AES accelerator). Only 13-byte nonces (L = 2) are supported, as
+ * used by 802.15.4 / Zigbee CCM*.
+ */
+
+#include "mbedtls/ccm.h"
+#include <string.h>
+
+#define CCM_NONCE_LEN   13
+#define CCM_MAX_LENGTH  0xFFFF        // L = 2 length field
+
+static const uint8_t sbox[256] = {
+    0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
+    0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
+    0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+    0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
+    0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
+    0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+    0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
+    0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
+    0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+    0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
+    0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
+    0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+    0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
+    0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
+    0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+    0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16,
+};
+
+// ============================================================================
+// AES-128
+// ============================================================================
+
+static uint32_t sub_word(uint32_t w)
+{
+    return ((uint32_t)sbox[w >> 24] << 24) | ((uint32_t)sbox[(w >> 16) & 0xFF] << 16) |
+           ((uint32_t)sbox[(w >> 8) & 0xFF] << 8) | sbox[w & 0xFF];
+}
+
+static void expand_key(uint32_t rk[44], const uint8_t key[16])
+{
+    static const uint8_t rcon[10] = { 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1b, 0x36 };
+    for (int i = 0; i < 4; i++) {
+        rk[i] = ((uint32_t)key[4 * i] << 24) | ((uint32_t)key[4 * i + 1] << 16) |
+                ((uint32_t)key[4 * i + 2] << 8) | key[4 * i + 3];
+    }
+    for (int i = 4; i < 44; i++) {
+        uint32_t t = rk[i - 1];
+        if (i % 4 == 0) {
+            t = sub_word((t << 8) | (t >> 24)) ^ ((uint32_t)rcon[i / 4 - 1] << 24);
+        }
+        rk[i] = rk[i - 4] ^ t;
+    }
+}
+
+static uint8_t xtime(uint8_t x)
+{
+    return (uint8_t)((x << 1) ^ ((x & 0x80) ? 0x1b : 0x00));
+}
+
+static void add_round_key(uint8_t s[16], const uint32_t *rk)
+{
+    for (int c = 0; c < 4; c++) {
+        s[4 * c] ^= (uint8_t)(rk[c] >> 24);
+        s[4 * c + 1] ^= (uint8_t)(rk[c] >> 16);
+        s[4 * c + 2] ^= (uint8_t)(rk[c] >> 8);
+        s[4 * c + 3] ^= (uint8_t)rk[c];
+    }
+}
+
+static void encrypt_block(const uint32_t rk[44], const uint8_t in[16], uint8_t out[16])
+{
+    uint8_t s[16];
+    memcpy(s, in, 16);
+    add_round_key(s, rk);
+
+    for (int round = 1; round <= 10; round++) {
+        // SubBytes + ShiftRows (state is column-major)
+        uint8_t t[16];
+        for (int c = 0; c < 4; c++) {
+            for (int r = 0; r < 4; r++) {
+                t[4 * c + r] = sbox[s[4 * ((c + r) % 4) + r]];
+            }
+        }
+        // MixColumns (not in the last round)
+        if (round < 10) {
+            for (int c = 0; c < 4; c++) {
+                uint8_t *col = &t[4 * c];
+                uint8_t a0 = col[0], a1 = col[1], a2 = col[2], a3 = col[3];
+                uint8_t all = a0 ^ a1 ^ a2 ^ a3;
+                col[0] ^= all ^ xtime(a0 ^ a1);
+                col[1] ^= all ^ xtime(a1 ^ a2);
+                col[2] ^= all ^ xtime(a2 ^ a3);
+                col[3] ^= all ^ xtime(a3 ^ a0);
+            }
+        }
+        memcpy(s, t, 16);
+        add_round_key(s, &rk[4 * round]);
+    }
+    memcpy(out, s, 16);
+}
+
+// ============================================================================
+// CCM (RFC 3610)
+// ============================================================================
+
+static void xor_block(uint8_t *dst, const uint8_t *src, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        dst[i] ^= src[i];
+    }
+}
+
+/**
+ * @brief CBC-MAC over B0, the encoded associated data and the plaintext
+ */
+static void cbc_mac(const mbedtls_ccm_context *ctx, size_t length, const uint8_t *nonce,
+                    const uint8_t *ad, size_t ad_len, const uint8_t *plain, size_t tag_len,
+                    uint8_t mac[16])
+{
+    uint8_t block[16];
+    block[0] = (uint8_t)((ad_len ? 0x40 : 0x00) | (((tag_len - 2) / 2) << 3) | 0x01);
+    memcpy(&block[1], nonce, CCM_NONCE_LEN);
+    block[14] = (uint8_t)(length >> 8);
+    block[15] = (uint8_t)length;
+    encrypt_block(ctx->round_keys, block, mac);
+
+    if (ad_len) {
+        // 2-byte length prefix, then the data, zero padded to whole blocks
+        memset(block, 0, sizeof(block));
+        block[0] = (uint8_t)(ad_len >> 8);
+        block[1] = (uint8_t)ad_len;
+        size_t used = 2;
+        size_t pos = 0;
+        while (pos < ad_len) {
+            size_t n = ad_len - pos < 16 - used ? ad_len - pos : 16 - used;
+            memcpy(&block[used], &ad[pos], n);
+            pos += n;
+            xor_block(mac, block, 16);
+            encrypt_block(ctx->round_keys, mac, mac);
+            memset(block, 0, sizeof(block));
+            used = 0;
+        }
+    }
+    for (size_t pos = 0; pos < length; pos += 16) {
+        size_t n = length - pos < 16 ? length - pos : 16;
+        xor_block(mac, &plain[pos], n);
+        encrypt_block(ctx->round_keys, mac, mac);
+    }
+}
+
+/**
+ * @brief Counter mode keystream block A_i
+ */
+static void keystream(const mbedtls_ccm_context *ctx, const uint8_t *nonce, uint16_t i, uint8_t out[16])
+{
+    uint8_t a[16];
+    a[0] = 0x01;
+    memcpy(&a[1], nonce, CCM_NONCE_LEN);
+    a[14] = (uint8_t)(i >> 8);
+    a[15] = (uint8_t)i;
+    encrypt_block(ctx->round_keys, a, out);
+}
+
+static void ctr_crypt(const mbedtls_ccm_context *ctx, const uint8_t *nonce, size_t length,
+                      const uint8_t *in, uint8_t *out)
+{
+    uint8_t s[16];
+    for (size_t pos = 0; pos < length; pos += 16) {
+        size_t n = length - pos < 16 ? length - pos : 16;
+        keystream(ctx, nonce, (uint16_t)(pos / 16 + 1), s);
+        for (size_t j = 0; j < n; j++) {
+            out[pos + j] = in[pos + j] ^ s[j];
+        }
+    }
+}
+
+static int check_args(const mbedtls_ccm_context *ctx, size_t length, size_t iv_len, size_t ad_len,
+                      size_t tag_len)
+{
+    if (!ctx->ready || iv_len != CCM_NONCE_LEN || length > CCM_MAX_LENGTH ||
+        ad_len >= 0xFF00 || tag_len < 4 || tag_len > 16 || tag_len % 2) {
+        return MBEDTLS_ERR_CCM_BAD_INPUT;
+    }
+    return 0;
+}
+
+// ============================================================================
+// PUBLIC FUNCTIONS
+// ============================================================================
+
+void mbedtls_ccm_init(mbedtls_ccm_context *ctx)
+{
+    memset(ctx, 0, sizeof(*ctx));
+}
+
+void mbedtls_ccm_free(mbedtls_ccm_context *ctx)
+{
+    if (ctx) {
+        memset(ctx, 0, sizeof(*ctx));
+    }
+}
+
+int mbedtls_ccm_setkey(mbedtls_ccm_context *ctx, mbedtls_cipher_id_t cipher,
+                       const unsigned char *key, unsigned int keybits)
+{
+    if (cipher != MBEDTLS_CIPHER_ID_AES || keybits != 128) {
+        return MBEDTLS_ERR_CCM_BAD_INPUT;
+    }
+    expand_key(ctx->round_keys, key);
+    ctx->ready = 1;
+    return 0;
+}
+
+int mbedtls_ccm_encrypt_and_tag(mbedtls_ccm_context *ctx, size_t length,
+                                const unsigned char *iv, size_t iv_len,
+                                const unsigned char *ad, size_t ad_len,
+                                const unsigned char *input, unsigned char *output,
+                                unsigned char *tag, size_t tag_len)
+{
+    int ret = check_args(ctx, length, iv_len, ad_len, tag_len);
+    if (ret) {
+        return ret;
+    }
+    uint8_t mac[16];
+    uint8_t s0[16];
+    cbc_mac(ctx, length, iv, ad, ad_len, input, tag_len, mac);
+    ctr_crypt(ctx, iv, length, input, output);
+    keystream(ctx, iv, 0, s0);
+    for (size_t i = 0; i < tag_len; i++) {
+        tag[i] = mac[i] ^ s0[i];
+    }
+    return 0;
+}
+
+int mbedtls_ccm_auth_decrypt(mbedtls_ccm_context *ctx, size_t length,
+                             const unsigned char *iv, size_t iv_len,
+                             const unsigned char *ad, size_t ad_len,
+                             const unsigned char *input, unsigned char *output,
+                             const unsigned char *tag, size_t tag_len)
+{
+    int ret = check_args(ctx, length, iv_len, ad_len, tag_len);
+    if (ret) {
+        return ret;
+    }
+    uint8_t mac[16];
+    uint8_t s0[16];
+    ctr_crypt(ctx, iv, length, input, output);
+    cbc_mac(ctx, length, iv, ad, ad_len, output, tag_len, mac);
+    keystream(ctx, iv, 0, s0);
+
+    uint8_t diff = 0;
+    for (size_t i = 0; i < tag_len; i++) {
+        diff |= (uint8_t)(tag[i] ^ mac[i] ^ s0[i]);
+    }
+    if (diff) {
+        memset(output, 0, length);
+        return MBEDTLS_ERR_CCM_AUTH_FAILED;
+    }
+    return 0;
+}
@@ -0,0 +1,384 @@
+/*
+ * Glyph C6 Monitor - Host Shim: FreeRTOS
+ *
+ * Version: 1.0.0
+ *
+ * Single-threaded: delays advance virtual time (running due events),
+ * created tasks are recorded and only run through host_task_run(),
+ * mutexes never block, a queue receive runs events until an item
+ * arrives and software timers are virtual-time events.
+ */
+
+#include "host_sim.h"
+#include "host_internal.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/queue.h"
+#include "freertos/timers.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HOST_MAX_TASKS   8
+
+struct host_task {
+    bool used;
+    char name[16];
+    TaskFunction_t fn;
+    void *param;
+    uint32_t stack_depth;
+    uint32_t notify_value;
+    bool notify_pending;
+};
+
+struct host_semaphore {
+    int depth;
+};
+
+static struct host_task tasks[HOST_MAX_TASKS + 1];   // Slot 0: the harness ("main")
+
+// ============================================================================
+// TASKS
+// ============================================================================
+
+void host_freertos_reset(void)
+{
+    memset(tasks, 0, sizeof(tasks));
+    tasks[0].used = true;
+    strcpy(tasks[0].name, "main");
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    host_time_advance_us((uint64_t)ticks * (1000000ULL / configTICK_RATE_HZ));
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)(host_time_since_boot_us() / (1000000ULL / configTICK_RATE_HZ));
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack_depth,
+                       void *param, UBaseType_t priority, TaskHandle_t *handle)
+{
+    (void)priority;
+    for (int i = 1; i <= HOST_MAX_TASKS; i++) {
+        if (!tasks[i].used) {
+            memset(&tasks[i], 0, sizeof(tasks[i]));
+            tasks[i].used = true;
+            strncpy(tasks[i].name, name ? name : "", sizeof(tasks[i].name) - 1);
+            tasks[i].fn = fn;
+            tasks[i].param = param;
+            tasks[i].stack_depth = stack_depth;
+            if (handle) {
+                *handle = &tasks[i];
+            }
+            return pdPASS;
+        }
+    }
+    return pdFAIL;
+}
+
+TaskHandle_t xTaskCreateStatic(TaskFunction_t fn, const char *name, uint32_t stack_depth,
+                               void *param, UBaseType_t priority, StackType_t *stack,
+                               StaticTask_t *tcb)
+{
+    TaskHandle_t handle = NULL;
+    if (!stack || !tcb) {
+        return NULL;
+    }
+    return xTaskCreate(fn, name, stack_depth, param, priority, &handle) == pdPASS ? handle : NULL;
+}
+
+void vTaskDelete(TaskHandle_t handle)
+{
+    if (handle && handle != &tasks[0]) {
+        handle->used = false;
+    }
+}
+
+bool host_task_run(const char *name)
+{
+    for (int i = 1; i <= HOST_MAX_TASKS; i++) {
+        if (tasks[i].used && strcmp(tasks[i].name, name) == 0) {
+            TaskFunction_t fn = tasks[i].fn;
+            void *param = tasks[i].param;
+            tasks[i].used = false;   // The slot is free once the task ends
+            fn(param);
+            return true;
+        }
+    }
+    return false;
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t handle)
+{
+    // Host tasks run on the harness stack: nothing of their own is ever used
+    return handle ? handle->stack_depth : 0;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return &tasks[0];
+}
+
+BaseType_t xTaskNotify(TaskHandle_t handle, uint32_t value, eNotifyAction action)
+{
+    if (!handle) {
+        return pdFAIL;
+    }
+    switch (action) {
+    case eSetBits:
+        handle->notify_value |= value;
+        break;
+    case eIncrement:
+        handle->notify_value++;
+        break;
+    case eSetValueWithoutOverwrite:
+        if (handle->notify_pending) {
+            return pdFAIL;
+        }
+        handle->notify_value = value;
+        break;
+    case eSetValueWithOverwrite:
+        handle->notify_value = value;
+        break;
+    default:
+        break;
+    }
+    handle->notify_pending = true;
+    return pdPASS;
+}
+
+BaseType_t xTaskNotifyWait(uint32_t clear_on_entry, uint32_t clear_on_exit,
+                           uint32_t *value, TickType_t ticks_to_wait)
+{
+    struct host_task *self = &tasks[0];
+    if (!self->notify_pending) {
+        self->notify_value &= ~clear_on_entry;
+        // Nothing else can run while we wait, except events on virtual time
+        if (ticks_to_wait != portMAX_DELAY) {
+            vTaskDelay(ticks_to_wait);
+        }
+        if (!self->notify_pending) {
+            return pdFALSE;
+        }
+    }
+    if (value) {
+        *value = self->notify_value;
+    }
+    self->notify_value &= ~clear_on_exit;
+    self->notify_pending = false;
+    return pdTRUE;
+}
+
+// ============================================================================
+// SEMAPHORES
+// ============================================================================
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    return calloc(1, sizeof(struct host_semaphore));
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks_to_wait)
+{
+    (void)ticks_to_wait;
+    if (!sem) {
+        return pdFAIL;
+    }
+    sem->depth++;
+    return pdPASS;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem)
+{
+    if (!sem || sem->depth == 0) {
+        return pdFAIL;
+    }
+    sem->depth--;
+    return pdPASS;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t sem)
+{
+    free(sem);
+}
+
+// ============================================================================
+// QUEUES
+// ============================================================================
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size)
+{
+    StaticQueue_t *queue = calloc(1, sizeof(*queue));
+    uint8_t *storage = calloc(length, item_size);
+    if (!queue || !storage) {
+        free(queue);
+        free(storage);
+        return NULL;
+    }
+    return xQueueCreateStatic(length, item_size, storage, queue);
+}
+
+QueueHandle_t xQueueCreateStatic(UBaseType_t length, UBaseType_t item_size,
+                                 uint8_t *storage, StaticQueue_t *queue)
+{
+    if (!queue || !storage || length == 0 || item_size == 0) {
+        return NULL;
+    }
+    memset(queue, 0, sizeof(*queue));
+    queue->storage = storage;
+    queue->length = length;
+    queue->item_size = item_size;
+    return queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks_to_wait)
+{
+    // Only the receiver could make room, and it is not running
+    (void)ticks_to_wait;
+    if (!queue || queue->count == queue->length) {
+        return errQUEUE_FULL;
+    }
+    UBaseType_t tail = (queue->head + queue->count) % queue->length;
+    memcpy(&queue->storage[tail * queue->item_size], item, queue->item_size);
+    queue->count++;
+    return pdPASS;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks_to_wait)
+{
+    if (!queue) {
+        return pdFAIL;
+    }
+    uint64_t deadline_us = (ticks_to_wait == portMAX_DELAY) ? UINT64_MAX :
+        host_time_now_us() + (uint64_t)ticks_to_wait * (1000000ULL / configTICK_RATE_HZ);
+    
+    // Nothing else can run while we wait, except events on virtual time
+    while (queue->count == 0) {
+        if (!host_time_run_next(deadline_us)) {
+            if (ticks_to_wait == portMAX_DELAY) {
+                fprintf(stderr, "host_freertos: queue wait forever with nothing scheduled\n");
+                abort();
+            }
+            host_time_run_until_us(deadline_us);
+            return errQUEUE_EMPTY;
+        }
+    }
+    memcpy(item, &queue->storage[queue->head * queue->item_size], queue->item_size);
+    queue->head = (queue->head + 1) % queue->length;
+    queue->count--;
+    return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue)
+{
+    return queue ? queue->count : 0;
+}
+
+void vQueueDelete(QueueHandle_t queue)
+{
+    // Static queues live in the caller's memory; dynamic ones leak like the heap on reboot
+    (void)queue;
+}
+
+// ============================================================================
+// SOFTWARE TIMERS
+// ============================================================================
+
+static void timer_expired(void *arg)
+{
+    TimerHandle_t timer = arg;
+    timer->event_id = 0;
+    if (timer->auto_reload) {
+        timer->event_id = host_time_schedule((uint64_t)timer->period * (1000000ULL / configTICK_RATE_HZ),
+                                             timer_expired, timer);
+    }
+    timer->callback(timer);
+}
+
+TimerHandle_t xTimerCreate(const char *name, TickType_t period, UBaseType_t auto_reload,
+                           void *id, TimerCallbackFunction_t callback)
+{
+    StaticTimer_t *buffer = calloc(1, sizeof(*buffer));
+    return buffer ? xTimerCreateStatic(name, period, auto_reload, id, callback, buffer) : NULL;
+}
+
+TimerHandle_t xTimerCreateStatic(const char *name, TickType_t period, UBaseType_t auto_reload,
+                                 void *id, TimerCallbackFunction_t callback, StaticTimer_t *buffer)
+{
+    if (!buffer || !callback || period == 0) {
+        return NULL;
+    }
+    memset(buffer, 0, sizeof(*buffer));
+    buffer->name = name;
+    buffer->period = period;
+    buffer->auto_reload = auto_reload;
+    buffer->id = id;
+    buffer->callback = callback;
+    return buffer;
+}
+
+BaseType_t xTimerStart(TimerHandle_t timer, TickType_t ticks_to_wait)
+{
+    return xTimerReset(timer, ticks_to_wait);
+}
+
+BaseType_t xTimerStop(TimerHandle_t timer, TickType_t ticks_to_wait)
+{
+    (void)ticks_to_wait;
+    if (!timer) {
+        return pdFAIL;
+    }
+    host_time_cancel(timer->event_id);
+    timer->event_id = 0;
+    return pdPASS;
+}
+
+BaseType_t xTimerReset(TimerHandle_t timer, TickType_t ticks_to_wait)
+{
+    if (xTimerStop(timer, ticks_to_wait) != pdPASS) {
+        return pdFAIL;
+    }
+    timer->event_id = host_time_schedule((uint64_t)timer->period * (1000000ULL / configTICK_RATE_HZ),
+                                         timer_expired, timer);
+    return pdPASS;
+}
+
+BaseType_t xTimerChangePeriod(TimerHandle_t timer, TickType_t period, TickType_t ticks_to_wait)
+{
+    if (!timer || period == 0) {
+        return pdFAIL;
+    }
+    timer->period = period;
+    return xTimerReset(timer, ticks_to_wait);   // Also starts a dormant timer
+}
+
+BaseType_t xTimerIsTimerActive(TimerHandle_t timer)
+{
+    return (timer && timer->event_id != 0) ? pdTRUE : pdFALSE;
+}
+
+void vTimerSetReloadMode(TimerHandle_t timer, UBaseType_t auto_reload)
+{
+    if (timer) {
+        timer->auto_reload = auto_reload;
+    }
+}
+
+TickType_t xTimerGetPeriod(TimerHandle_t timer)
+{
+    return timer ? timer->period : 0;
+}
+
+void *pvTimerGetTimerID(TimerHandle_t timer)
+{
+    return timer ? timer->id : NULL;
+}
+
+BaseType_t xTimerDelete(TimerHandle_t timer, TickType_t ticks_to_wait)
+{
+    return xTimerStop(timer, ticks_to_wait);
+}
@@ -0,0 +1,238 @@
+/*
+ * Glyph C6 Monitor - Host Shim: I2C Master
+ *
+ * Version: 1.0.0
+ */
+
+#include "host_sim.h"
+#include "host_internal.h"
+#include "driver/i2c_master.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define HOST_I2C_ADDRS   128
+
+struct host_i2c_bus {
+    i2c_master_bus_config_t config;
+};
+
+struct host_i2c_dev {
+    uint16_t addr;
+    uint32_t scl_hz;
+};
+
+typedef struct {
+    const host_i2c_device_ops_t *ops;
+    void *ctx;
+} host_i2c_slot_t;
+
+static host_i2c_slot_t slots[HOST_I2C_ADDRS];
+static uint32_t transfers;
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+/**
+ * @brief Charge bus time: start + address byte + data bytes (9 bits each) + stop
+ */
+static void charge_bus_time(const struct host_i2c_dev *dev, size_t len)
+{
+    uint64_t bits = 2 + 9 * (uint64_t)(len + 1);
+    uint32_t hz = dev->scl_hz ? dev->scl_hz : 100000;
+    host_time_advance_us((bits * 1000000ULL + hz - 1) / hz);
+}
+
+/**
+ * @brief A device reporting ESP_ERR_TIMEOUT held the bus for the whole timeout
+ */
+static esp_err_t finish_transfer(esp_err_t ret, int xfer_timeout_ms)
+{
+    if (ret == ESP_ERR_TIMEOUT && xfer_timeout_ms > 0) {
+        host_time_advance_us((uint64_t)xfer_timeout_ms * 1000);
+    }
+    return ret;
+}
+
+static esp_err_t script_transmit(void *ctx, const uint8_t *data, size_t len)
+{
+    host_i2c_script_t *s = ctx;
+    s->write_count++;
+    s->last_write_len = (uint8_t)(len < HOST_I2C_SCRIPT_MAX_BYTES ? len : HOST_I2C_SCRIPT_MAX_BYTES);
+    memcpy(s->last_write, data, s->last_write_len);
+    return s->write_result;
+}
+
+static esp_err_t script_receive(void *ctx, uint8_t *data, size_t len)
+{
+    host_i2c_script_t *s = ctx;
+    if (s->read_head >= s->read_count) {
+        return ESP_FAIL;  // Nothing scripted: the device NACKs
+    }
+    const host_i2c_script_step_t *step = &s->reads[s->read_head++];
+    if (step->result != ESP_OK) {
+        return step->result;
+    }
+    memset(data, 0, len);
+    memcpy(data, step->data, step->len < len ? step->len : len);
+    return ESP_OK;
+}
+
+static const host_i2c_device_ops_t script_ops = {
+    .transmit = script_transmit,
+    .receive = script_receive,
+};
+
+// ============================================================================
+// SIMULATION CONTROL
+// ============================================================================
+
+void host_i2c_reset(void)
+{
+    memset(slots, 0, sizeof(slots));
+    transfers = 0;
+}
+
+void host_i2c_attach(uint16_t addr, const host_i2c_device_ops_t *ops, void *ctx)
+{
+    if (addr < HOST_I2C_ADDRS) {
+        slots[addr].ops = ops;
+        slots[addr].ctx = ctx;
+    }
+}
+
+void host_i2c_detach(uint16_t addr)
+{
+    if (addr < HOST_I2C_ADDRS) {
+        slots[addr].ops = NULL;
+        slots[addr].ctx = NULL;
+    }
+}
+
+uint32_t host_i2c_transfer_count(void)
+{
+    return transfers;
+}
+
+void host_i2c_script_attach(host_i2c_script_t *script, uint16_t addr)
+{
+    memset(script, 0, sizeof(*script));
+    host_i2c_attach(addr, &script_ops, script);
+}
+
+void host_i2c_script_push_read(host_i2c_script_t *script, esp_err_t result,
+                               const uint8_t *data, size_t len)
+{
+    if (script->read_count >= HOST_I2C_SCRIPT_MAX_STEPS) {
+        // Compact consumed steps before giving up
+        memmove(script->reads, &script->reads[script->read_head],
+                (script->read_count - script->read_head) * sizeof(script->reads[0]));
+        script->read_count -= script->read_head;
+        script->read_head = 0;
+        if (script->read_count >= HOST_I2C_SCRIPT_MAX_STEPS) {
+            return;
+        }
+    }
+    host_i2c_script_step_t *step = &script->reads[script->read_count++];
+    step->result = result;
+    step->len = (uint8_t)(len < HOST_I2C_SCRIPT_MAX_BYTES ? len : HOST_I2C_SCRIPT_MAX_BYTES);
+    if (data) {
+        memcpy(step->data, data, step->len);
+    }
+}
+
+// ============================================================================
+// DRIVER API
+// ============================================================================
+
+esp_err_t i2c_new_master_bus(const i2c_master_bus_config_t *bus_config, i2c_master_bus_handle_t *ret_bus_handle)
+{
+    if (!bus_config || !ret_bus_handle) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    struct host_i2c_bus *bus = calloc(1, sizeof(*bus));
+    if (!bus) {
+        return ESP_ERR_NO_MEM;
+    }
+    bus->config = *bus_config;
+    *ret_bus_handle = bus;
+    return ESP_OK;
+}
+
+esp_err_t i2c_del_master_bus(i2c_master_bus_handle_t bus_handle)
+{
+    free(bus_handle);
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_bus_add_device(i2c_master_bus_handle_t bus_handle, const i2c_device_config_t *dev_config,
+                                    i2c_master_dev_handle_t *ret_handle)
+{
+    if (!bus_handle || !dev_config || !ret_handle || dev_config->device_address >= HOST_I2C_ADDRS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    struct host_i2c_dev *dev = calloc(1, sizeof(*dev));
+    if (!dev) {
+        return ESP_ERR_NO_MEM;
+    }
+    dev->addr = dev_config->device_address;
+    dev->scl_hz = dev_config->scl_speed_hz;
+    *ret_handle = dev;
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_bus_rm_device(i2c_master_dev_handle_t handle)
+{
+    free(handle);
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_transmit(i2c_master_dev_handle_t i2c_dev, const uint8_t *write_buffer, size_t write_size,
+                              int xfer_timeout_ms)
+{
+    if (!i2c_dev || (!write_buffer && write_size)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    transfers++;
+    charge_bus_time(i2c_dev, write_size);
+    const host_i2c_slot_t *slot = &slots[i2c_dev->addr];
+    if (!slot->ops || !slot->ops->transmit) {
+        return ESP_FAIL;  // Address NACK
+    }
+    return finish_transfer(slot->ops->transmit(slot->ctx, write_buffer, write_size), xfer_timeout_ms);
+}
+
+esp_err_t i2c_master_receive(i2c_master_dev_handle_t i2c_dev, uint8_t *read_buffer, size_t read_size,
+                             int xfer_timeout_ms)
+{
+    if (!i2c_dev || !read_buffer || read_size == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    transfers++;
+    charge_bus_time(i2c_dev, read_size);
+    const host_i2c_slot_t *slot = &slots[i2c_dev->addr];
+    if (!slot->ops || !slot->ops->receive) {
+        return ESP_FAIL;
+    }
+    return finish_transfer(slot->ops->receive(slot->ctx, read_buffer, read_size), xfer_timeout_ms);
+}
+
+esp_err_t i2c_master_transmit_receive(i2c_master_dev_handle_t i2c_dev, const uint8_t *write_buffer,
+                                      size_t write_size, uint8_t *read_buffer, size_t read_size,
+                                      int xfer_timeout_ms)
+{
+    esp_err_t ret = i2c_master_transmit(i2c_dev, write_buffer, write_size, xfer_timeout_ms);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    return i2c_master_receive(i2c_dev, read_buffer, read_size, xfer_timeout_ms);
+}
+
+esp_err_t i2c_master_probe(i2c_master_bus_handle_t bus_handle, uint16_t address, int xfer_timeout_ms)
+{
+    (void)xfer_timeout_ms;
+    if (!bus_handle || address >= HOST_I2C_ADDRS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return slots[address].ops ? ESP_OK : ESP_ERR_NOT_FOUND;
+}
@@ -0,0 +1,137 @@
+/*
+ * Glyph C6 Monitor - Host Shim: Raw IEEE 802.15.4 Radio
+ *
+ * Version: 1.0.0
+ *
+ * Transmit-only model of the esp_ieee802154 driver: frames are logged
+ * with their channel and send time, passed to an optional receiver hook
+ * and charged their airtime (250 kbit/s, preamble + SFD + PHR included).
+ * On-time counts from enable to disable, like host_zb_radio_on_us() for
+ * the Zigbee stack.
+ */
+
+#include "host_sim.h"
+#include "host_internal.h"
+#include "esp_ieee802154.h"
+#include <string.h>
+
+#define US_PER_OCTET        32        // 250 kbit/s
+#define PHY_HEADER_OCTETS   6         // Preamble, SFD, PHR
+
+static bool enabled;
+static uint8_t channel;
+static uint64_t enabled_at_us;
+static uint64_t on_us;                // Radio on time of finished enable periods
+static host_ieee802154_frame_t frames[HOST_IEEE802154_MAX_FRAMES];
+static uint32_t frame_count;
+static host_ieee802154_hook_t tx_hook;
+static void *tx_hook_ctx;
+
+void host_ieee802154_reset(void)
+{
+    enabled = false;
+    channel = 11;
+    enabled_at_us = 0;
+    on_us = 0;
+    frame_count = 0;
+    tx_hook = NULL;
+    tx_hook_ctx = NULL;
+    memset(frames, 0, sizeof(frames));
+}
+
+void host_ieee802154_on_reboot(void)
+{
+    esp_ieee802154_disable();
+}
+
+void host_ieee802154_set_tx_hook(host_ieee802154_hook_t hook, void *ctx)
+{
+    tx_hook = hook;
+    tx_hook_ctx = ctx;
+}
+
+uint32_t host_ieee802154_frame_count(void)
+{
+    return frame_count;
+}
+
+const host_ieee802154_frame_t *host_ieee802154_frame_get(uint32_t index)
+{
+    if (index >= frame_count || frame_count - index > HOST_IEEE802154_MAX_FRAMES) {
+        return NULL;
+    }
+    return &frames[index % HOST_IEEE802154_MAX_FRAMES];
+}
+
+uint64_t host_ieee802154_on_us(void)
+{
+    return on_us + (enabled ? host_time_now_us() - enabled_at_us : 0);
+}
+
+// ============================================================================
+// esp_ieee802154.h
+// ============================================================================
+
+esp_err_t esp_ieee802154_enable(void)
+{
+    if (!enabled) {
+        enabled = true;
+        enabled_at_us = host_time_now_us();
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_ieee802154_disable(void)
+{
+    if (enabled) {
+        on_us += host_time_now_us() - enabled_at_us;
+        enabled = false;
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_ieee802154_set_channel(uint8_t ch)
+{
+    if (ch < 11 || ch > 26) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    channel = ch;
+    return ESP_OK;
+}
+
+esp_err_t esp_ieee802154_set_rx_when_idle(bool enable)
+{
+    (void)enable;
+    return ESP_OK;
+}
+
+esp_err_t esp_ieee802154_transmit(const uint8_t *frame, bool cca)
+{
+    (void)cca;
+    if (!enabled) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    // PHR length covers the 2-byte FCS the radio appends
+    if (!frame || frame[0] < 3 || frame[0] - 2 > HOST_IEEE802154_MAX_PSDU) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    host_ieee802154_frame_t *f = &frames[frame_count % HOST_IEEE802154_MAX_FRAMES];
+    f->time_us = host_time_now_us();
+    f->channel = channel;
+    f->len = (uint8_t)(frame[0] - 2);
+    memcpy(f->psdu, &frame[1], f->len);
+    frame_count++;
+
+    // Transmit completes before the call returns (state back to idle)
+    host_time_advance_us((uint64_t)(PHY_HEADER_OCTETS + frame[0]) * US_PER_OCTET);
+    if (tx_hook) {
+        tx_hook(f, tx_hook_ctx);
+    }
+    return ESP_OK;
+}
+
+esp_ieee802154_state_t esp_ieee802154_get_state(void)
+{
+    return enabled ? ESP_IEEE802154_RADIO_IDLE : ESP_IEEE802154_RADIO_DISABLE;
+}
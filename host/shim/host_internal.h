@@ -0,0 +1,37 @@
+/*
+ * Glyph C6 Monitor - Host Shim Internals
+ *
+ * Hooks between the shim modules (not for tests or simulators).
+ */
+
+#ifndef HOST_INTERNAL_H
+#define HOST_INTERNAL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Per-module power-on reset (called by host_sim_reset)
+void host_time_reset(void);
+void host_freertos_reset(void);
+void host_log_reset(void);
+void host_i2c_reset(void);
+void host_adc_reset(void);
+void host_sleep_reset(void);
+void host_zb_reset(void);
+void host_nvs_reset(void);
+void host_partition_reset(void);
+void host_ieee802154_reset(void);
+void host_random_reset(void);
+
+// Run the earliest event due by deadline_us, moving the clock to it;
+// false (clock untouched) if there is none
+bool host_time_run_next(uint64_t deadline_us);
+
+// Simulated chip reset: volatile state of the stack is lost, RTC/flash kept
+void host_zb_on_reboot(void);
+void host_ieee802154_on_reboot(void);
+
+// Simulated chip reset: firmware statics back to their initializers
+void host_ram_reset(void);
+
+#endif // HOST_INTERNAL_H
@@ -0,0 +1,81 @@
+/*
+ * Glyph C6 Monitor - Host Shim: Logging and Errors
+ *
+ * Version: 1.0.0
+ */
+
+#include "host_sim.h"
+#include "host_internal.h"
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_ota_ops.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static int log_level = ESP_LOG_WARN;
+
+void host_log_reset(void)
+{
+    log_level = ESP_LOG_WARN;
+}
+
+void host_log_set_level(int level)
+{
+    log_level = level;
+}
+
+uint32_t esp_log_timestamp(void)
+{
+    return (uint32_t)(host_time_since_boot_us() / 1000);
+}
+
+void esp_log_write(esp_log_level_t level, const char *tag, const char *format, ...)
+{
+    static const char letters[] = "NEWIDV";
+    if ((int)level > log_level || level == ESP_LOG_NONE) {
+        return;
+    }
+    // Firmware format strings end without a newline (ESP_LOGx adds it)
+    printf("%c (%lu) %s: ", letters[level], (unsigned long)esp_log_timestamp(), tag);
+    va_list args;
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+    printf("\n");
+}
+
+const char *esp_err_to_name(esp_err_t code)
+{
+    switch (code) {
+    case ESP_OK:                        return "ESP_OK";
+    case ESP_FAIL:                      return "ESP_FAIL";
+    case ESP_ERR_NO_MEM:                return "ESP_ERR_NO_MEM";
+    case ESP_ERR_INVALID_ARG:           return "ESP_ERR_INVALID_ARG";
+    case ESP_ERR_INVALID_STATE:         return "ESP_ERR_INVALID_STATE";
+    case ESP_ERR_INVALID_SIZE:          return "ESP_ERR_INVALID_SIZE";
+    case ESP_ERR_NOT_FOUND:             return "ESP_ERR_NOT_FOUND";
+    case ESP_ERR_NOT_SUPPORTED:         return "ESP_ERR_NOT_SUPPORTED";
+    case ESP_ERR_TIMEOUT:               return "ESP_ERR_TIMEOUT";
+    case ESP_ERR_INVALID_RESPONSE:      return "ESP_ERR_INVALID_RESPONSE";
+    case ESP_ERR_INVALID_CRC:           return "ESP_ERR_INVALID_CRC";
+    case ESP_ERR_INVALID_VERSION:       return "ESP_ERR_INVALID_VERSION";
+    case ESP_ERR_NVS_NOT_INITIALIZED:   return "ESP_ERR_NVS_NOT_INITIALIZED";
+    case ESP_ERR_NVS_NOT_FOUND:         return "ESP_ERR_NVS_NOT_FOUND";
+    case ESP_ERR_NVS_READ_ONLY:         return "ESP_ERR_NVS_READ_ONLY";
+    case ESP_ERR_NVS_NOT_ENOUGH_SPACE:  return "ESP_ERR_NVS_NOT_ENOUGH_SPACE";
+    case ESP_ERR_NVS_INVALID_HANDLE:    return "ESP_ERR_NVS_INVALID_HANDLE";
+    case ESP_ERR_NVS_INVALID_LENGTH:    return "ESP_ERR_NVS_INVALID_LENGTH";
+    case ESP_ERR_NVS_NO_FREE_PAGES:     return "ESP_ERR_NVS_NO_FREE_PAGES";
+    case ESP_ERR_NVS_NEW_VERSION_FOUND: return "ESP_ERR_NVS_NEW_VERSION_FOUND";
+    case ESP_ERR_OTA_VALIDATE_FAILED:   return "ESP_ERR_OTA_VALIDATE_FAILED";
+    default:                            return "UNKNOWN ERROR";
+    }
+}
+
+void host_esp_error_check_failed(esp_err_t rc, const char *file, int line, const char *expr)
+{
+    fprintf(stderr, "ESP_ERROR_CHECK failed: esp_err_t 0x%x (%s) at %s:%d\nexpression: %s\n",
+            rc, esp_err_to_name(rc), file, line, expr);
+    abort();
+}
@@ -0,0 +1,209 @@
+/*
+ * Glyph C6 Monitor - Host Shim: System, Random, GPIO and Global Reset
+ *
+ * Version: 1.0.0
+ */
+
+#include "host_sim.h"
+#include "host_internal.h"
+#include "esp_system.h"
+#include "esp_app_desc.h"
+#include "esp_chip_info.h"
+#include "esp_flash.h"
+#include "esp_random.h"
+#include "driver/gpio.h"
+#include <stdlib.h>
+#include <string.h>
+
+static uint8_t gpio_levels[GPIO_NUM_MAX];
+static uint32_t random_state;
+
+// RTC memory sections (see esp_attr.h), bounds provided by the linker
+extern char __start_rtc_data[] __attribute__((weak));
+extern char __stop_rtc_data[] __attribute__((weak));
+extern char __start_rtc_noinit[] __attribute__((weak));
+extern char __stop_rtc_noinit[] __attribute__((weak));
+
+// Ordinary RAM of the firmware modules (.data/.bss renamed at build time,
+// see glyph_fw_object() in CMakeLists.txt)
+extern char __start_fw_data[] __attribute__((weak));
+extern char __stop_fw_data[] __attribute__((weak));
+extern char __start_fw_bss[] __attribute__((weak));
+extern char __stop_fw_bss[] __attribute__((weak));
+
+static char *rtc_data_image;
+static char *fw_data_image;
+
+/**
+ * @brief Restore a section to its load image (kept on the first call)
+ */
+static void restore_section(char *start, char *stop, char **image)
+{
+    if (!start || (uintptr_t)stop <= (uintptr_t)start) {
+        return;
+    }
+    size_t len = (size_t)(stop - start);
+    if (!*image) {
+        // First reset runs before any firmware code: keep the load image
+        *image = malloc(len);
+        memcpy(*image, start, len);
+    }
+    memcpy(start, *image, len);
+}
+
+static void clear_section(char *start, char *stop)
+{
+    if (start && (uintptr_t)stop > (uintptr_t)start) {
+        memset(start, 0, (size_t)(stop - start));
+    }
+}
+
+/**
+ * @brief Power-on state of RTC memory: initializers restored, noinit cleared
+ */
+static void reset_rtc_memory(void)
+{
+    restore_section(__start_rtc_data, __stop_rtc_data, &rtc_data_image);
+    clear_section(__start_rtc_noinit, __stop_rtc_noinit);
+}
+
+void host_ram_reset(void)
+{
+    restore_section(__start_fw_data, __stop_fw_data, &fw_data_image);
+    clear_section(__start_fw_bss, __stop_fw_bss);
+}
+
+void host_sim_reset(void)
+{
+    reset_rtc_memory();
+    host_ram_reset();
+    host_time_reset();
+    host_freertos_reset();
+    host_log_reset();
+    host_i2c_reset();
+    host_adc_reset();
+    host_sleep_reset();
+    host_zb_reset();
+    host_nvs_reset();
+    host_partition_reset();
+    host_ieee802154_reset();
+    host_random_reset();
+    memset(gpio_levels, 0, sizeof(gpio_levels));
+}
+
+void host_sim_power_cycle(void)
+{
+    reset_rtc_memory();
+    host_time_reboot();
+}
+
+// ============================================================================
+// SYSTEM
+// ============================================================================
+
+uint32_t esp_get_free_heap_size(void)
+{
+    return 256 * 1024;
+}
+
+int esp_app_get_elf_sha256(char *dst, size_t size)
+{
+    static const char sha[] = "0000000000000000000000000000000000000000000000000000000000000000";
+    if (!dst || size == 0) {
+        return 0;
+    }
+    size_t n = size - 1 < sizeof(sha) - 1 ? size - 1 : sizeof(sha) - 1;
+    memcpy(dst, sha, n);
+    dst[n] = '\0';
+    return (int)(n + 1);
+}
+
+void esp_chip_info(esp_chip_info_t *out_info)
+{
+    memset(out_info, 0, sizeof(*out_info));
+    out_info->model = 13;            // CHIP_ESP32C6
+    out_info->cores = 1;
+}
+
+esp_err_t esp_flash_get_size(esp_flash_t *chip, uint32_t *out_size)
+{
+    (void)chip;
+    *out_size = 4 * 1024 * 1024;
+    return ESP_OK;
+}
+
+// ============================================================================
+// RANDOM (deterministic: same sequence after every host_sim_reset)
+// ============================================================================
+
+void host_random_reset(void)
+{
+    random_state = 0x2545F491u;
+}
+
+uint32_t esp_random(void)
+{
+    // xorshift32
+    uint32_t x = random_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    random_state = x;
+    return x;
+}
+
+void esp_fill_random(void *buf, size_t len)
+{
+    uint8_t *p = buf;
+    for (size_t i = 0; i < len; i += 4) {
+        uint32_t r = esp_random();
+        size_t n = len - i < 4 ? len - i : 4;
+        memcpy(&p[i], &r, n);
+    }
+}
+
+// ============================================================================
+// GPIO
+// ============================================================================
+
+esp_err_t gpio_config(const gpio_config_t *cfg)
+{
+    return cfg ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t gpio_set_level(gpio_num_t gpio_num, uint32_t level)
+{
+    if (gpio_num < 0 || gpio_num >= GPIO_NUM_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    gpio_levels[gpio_num] = level ? 1 : 0;
+    return ESP_OK;
+}
+
+int gpio_get_level(gpio_num_t gpio_num)
+{
+    return (gpio_num >= 0 && gpio_num < GPIO_NUM_MAX) ? gpio_levels[gpio_num] : 0;
+}
+
+esp_err_t gpio_reset_pin(gpio_num_t gpio_num)
+{
+    return gpio_set_level(gpio_num, 0);
+}
+
+esp_err_t gpio_set_direction(gpio_num_t gpio_num, gpio_mode_t mode)
+{
+    (void)mode;
+    return (gpio_num >= 0 && gpio_num < GPIO_NUM_MAX) ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t gpio_hold_en(gpio_num_t gpio_num)
+{
+    (void)gpio_num;
+    return ESP_OK;
+}
+
+esp_err_t gpio_hold_dis(gpio_num_t gpio_num)
+{
+    (void)gpio_num;
+    return ESP_OK;
+}
@@ -0,0 +1,252 @@
+/*
+ * Glyph C6 Monitor - Host Shim: NVS
+ *
+ * Version: 1.0.0
+ *
+ * RAM-backed key/value store. Writes are visible immediately; commits are
+ * only counted. Contents survive simulated resets (host_time_reboot) and
+ * are cleared by host_sim_reset.
+ */
+
+#include "host_sim.h"
+#include "host_internal.h"
+#include "nvs.h"
+#include "nvs_flash.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define HOST_NVS_MAX_ENTRIES   64
+#define HOST_NVS_MAX_HANDLES   8
+#define HOST_NVS_KEY_LEN       16     // NVS_KEY_NAME_MAX_SIZE
+
+typedef struct {
+    bool used;
+    char ns[HOST_NVS_KEY_LEN];
+    char key[HOST_NVS_KEY_LEN];
+    void *data;
+    size_t len;
+} host_nvs_entry_t;
+
+typedef struct {
+    bool open;
+    bool writable;
+    char ns[HOST_NVS_KEY_LEN];
+} host_nvs_handle_t;
+
+static host_nvs_entry_t entries[HOST_NVS_MAX_ENTRIES];
+static host_nvs_handle_t handles[HOST_NVS_MAX_HANDLES];
+static uint32_t commits;
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+static host_nvs_handle_t *get_handle(nvs_handle_t handle)
+{
+    if (handle == 0 || handle > HOST_NVS_MAX_HANDLES || !handles[handle - 1].open) {
+        return NULL;
+    }
+    return &handles[handle - 1];
+}
+
+static host_nvs_entry_t *find_entry(const char *ns, const char *key)
+{
+    for (int i = 0; i < HOST_NVS_MAX_ENTRIES; i++) {
+        if (entries[i].used && strcmp(entries[i].ns, ns) == 0 && strcmp(entries[i].key, key) == 0) {
+            return &entries[i];
+        }
+    }
+    return NULL;
+}
+
+static bool namespace_exists(const char *ns)
+{
+    for (int i = 0; i < HOST_NVS_MAX_ENTRIES; i++) {
+        if (entries[i].used && strcmp(entries[i].ns, ns) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static esp_err_t set_value(nvs_handle_t handle, const char *key, const void *value, size_t length)
+{
+    host_nvs_handle_t *h = get_handle(handle);
+    if (!h) {
+        return ESP_ERR_NVS_INVALID_HANDLE;
+    }
+    if (!h->writable) {
+        return ESP_ERR_NVS_READ_ONLY;
+    }
+    if (!key || strlen(key) >= HOST_NVS_KEY_LEN) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    host_nvs_entry_t *e = find_entry(h->ns, key);
+    if (!e) {
+        for (int i = 0; i < HOST_NVS_MAX_ENTRIES && !e; i++) {
+            if (!entries[i].used) {
+                e = &entries[i];
+            }
+        }
+        if (!e) {
+            return ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+        }
+        memset(e, 0, sizeof(*e));
+        e->used = true;
+        strcpy(e->ns, h->ns);
+        strcpy(e->key, key);
+    }
+    void *data = realloc(e->data, length ? length : 1);
+    if (!data) {
+        return ESP_ERR_NO_MEM;
+    }
+    memcpy(data, value, length);
+    e->data = data;
+    e->len = length;
+    return ESP_OK;
+}
+
+static esp_err_t get_value(nvs_handle_t handle, const char *key, host_nvs_entry_t **out)
+{
+    host_nvs_handle_t *h = get_handle(handle);
+    if (!h) {
+        return ESP_ERR_NVS_INVALID_HANDLE;
+    }
+    *out = find_entry(h->ns, key);
+    return *out ? ESP_OK : ESP_ERR_NVS_NOT_FOUND;
+}
+
+// ============================================================================
+// SIMULATION CONTROL
+// ============================================================================
+
+void host_nvs_reset(void)
+{
+    for (int i = 0; i < HOST_NVS_MAX_ENTRIES; i++) {
+        free(entries[i].data);
+    }
+    memset(entries, 0, sizeof(entries));
+    memset(handles, 0, sizeof(handles));
+    commits = 0;
+}
+
+uint32_t host_nvs_commit_count(void)
+{
+    return commits;
+}
+
+// ============================================================================
+// NVS API
+// ============================================================================
+
+esp_err_t nvs_flash_init(void)
+{
+    return ESP_OK;
+}
+
+esp_err_t nvs_flash_erase(void)
+{
+    host_nvs_reset();
+    return ESP_OK;
+}
+
+esp_err_t nvs_open(const char *namespace_name, nvs_open_mode_t open_mode, nvs_handle_t *out_handle)
+{
+    if (!namespace_name || !out_handle || strlen(namespace_name) >= HOST_NVS_KEY_LEN) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    // Like the real store, a read-only open of an unknown namespace fails
+    if (open_mode == NVS_READONLY && !namespace_exists(namespace_name)) {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    for (int i = 0; i < HOST_NVS_MAX_HANDLES; i++) {
+        if (!handles[i].open) {
+            handles[i].open = true;
+            handles[i].writable = (open_mode == NVS_READWRITE);
+            strcpy(handles[i].ns, namespace_name);
+            *out_handle = (nvs_handle_t)(i + 1);
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_NO_MEM;
+}
+
+void nvs_close(nvs_handle_t handle)
+{
+    host_nvs_handle_t *h = get_handle(handle);
+    if (h) {
+        h->open = false;
+    }
+}
+
+esp_err_t nvs_commit(nvs_handle_t handle)
+{
+    if (!get_handle(handle)) {
+        return ESP_ERR_NVS_INVALID_HANDLE;
+    }
+    commits++;
+    return ESP_OK;
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char *key, const void *value, size_t length)
+{
+    return set_value(handle, key, value, length);
+}
+
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char *key, void *out_value, size_t *length)
+{
+    host_nvs_entry_t *e;
+    esp_err_t ret = get_value(handle, key, &e);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    if (!length) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!out_value) {
+        *length = e->len;   // Size query
+        return ESP_OK;
+    }
+    if (*length < e->len) {
+        *length = e->len;
+        return ESP_ERR_NVS_INVALID_LENGTH;
+    }
+    memcpy(out_value, e->data, e->len);
+    *length = e->len;
+    return ESP_OK;
+}
+
+esp_err_t nvs_set_u32(nvs_handle_t handle, const char *key, uint32_t value)
+{
+    return set_value(handle, key, &value, sizeof(value));
+}
+
+esp_err_t nvs_get_u32(nvs_handle_t handle, const char *key, uint32_t *out_value)
+{
+    host_nvs_entry_t *e;
+    esp_err_t ret = get_value(handle, key, &e);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    if (e->len != sizeof(uint32_t)) {
+        return ESP_ERR_NVS_NOT_FOUND;  // Stored with another type
+    }
+    memcpy(out_value, e->data, sizeof(uint32_t));
+    return ESP_OK;
+}
+
+esp_err_t nvs_erase_key(nvs_handle_t handle, const char *key)
+{
+    host_nvs_entry_t *e;
+    host_nvs_handle_t *h = get_handle(handle);
+    if (h && !h->writable) {
+        return ESP_ERR_NVS_READ_ONLY;
+    }
+    esp_err_t ret = get_value(handle, key, &e);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    free(e->data);
+    memset(e, 0, sizeof(*e));
+    return ESP_OK;
+}
@@ -0,0 +1,246 @@
+/*
+ * Glyph C6 Monitor - Host Shim: Flash Partitions
+ *
+ * Version: 1.0.0
+ *
+ * RAM-backed partitions with NOR semantics: erase sets whole 4 KB
+ * sectors to 0xFF, writes can only clear bits. The two app slots of
+ * partitions.csv exist for OTA; the image runs from ota_0 until
+ * esp_ota_set_boot_partition() selects the other one.
+ */
+
+#include "host_sim.h"
+#include "host_internal.h"
+#include "esp_partition.h"
+#include "esp_ota_ops.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define HOST_MAX_PARTITIONS       6
+#define HOST_SECTOR_SIZE          4096
+#define HOST_HISTORY_DEFAULT_SIZE (256 * 1024)
+#define HOST_TRACE_DEFAULT_SIZE   (256 * 1024)
+#define HOST_APP_SLOT_SIZE        0x180000
+#define HOST_APP_IMAGE_MAGIC      0xE9
+
+typedef struct {
+    bool defined;
+    esp_partition_t part;
+    uint8_t *data;                // Allocated at first lookup
+} host_partition_t;
+
+static host_partition_t partitions[HOST_MAX_PARTITIONS];
+static uint32_t erases;
+static uint32_t writes;
+static const esp_partition_t *boot_slot;
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+static host_partition_t *find(const char *label)
+{
+    for (int i = 0; i < HOST_MAX_PARTITIONS; i++) {
+        if (partitions[i].defined && strcmp(partitions[i].part.label, label) == 0) {
+            return &partitions[i];
+        }
+    }
+    return NULL;
+}
+
+static host_partition_t *from_handle(const esp_partition_t *partition)
+{
+    for (int i = 0; i < HOST_MAX_PARTITIONS; i++) {
+        if (partitions[i].defined && &partitions[i].part == partition) {
+            return &partitions[i];
+        }
+    }
+    return NULL;
+}
+
+static bool in_range(const host_partition_t *p, size_t offset, size_t size)
+{
+    return offset <= p->part.size && size <= p->part.size - offset;
+}
+
+static host_partition_t *define(const char *label, esp_partition_type_t type, uint8_t subtype, size_t size)
+{
+    host_partition_t *p = find(label);
+    for (int i = 0; i < HOST_MAX_PARTITIONS && !p; i++) {
+        if (!partitions[i].defined) {
+            p = &partitions[i];
+        }
+    }
+    if (!p) {
+        return NULL;
+    }
+    free(p->data);
+    memset(p, 0, sizeof(*p));
+    if (size == 0) {
+        return NULL;  // Size 0 removes the partition
+    }
+    p->defined = true;
+    p->part.type = type;
+    p->part.subtype = subtype;
+    p->part.address = 0x300000 + (uint32_t)(p - partitions) * 0x100000;
+    p->part.size = (uint32_t)(size / HOST_SECTOR_SIZE * HOST_SECTOR_SIZE);
+    p->part.erase_size = HOST_SECTOR_SIZE;
+    strncpy(p->part.label, label, sizeof(p->part.label) - 1);
+    return p;
+}
+
+static const esp_partition_t *app_slot(esp_partition_subtype_t subtype)
+{
+    return esp_partition_find_first(ESP_PARTITION_TYPE_APP, subtype, NULL);
+}
+
+// ============================================================================
+// SIMULATION CONTROL
+// ============================================================================
+
+void host_partition_reset(void)
+{
+    for (int i = 0; i < HOST_MAX_PARTITIONS; i++) {
+        free(partitions[i].data);
+    }
+    memset(partitions, 0, sizeof(partitions));
+    erases = 0;
+    writes = 0;
+    boot_slot = NULL;
+    host_partition_define("history", HOST_HISTORY_DEFAULT_SIZE);
+    host_partition_define("trace", HOST_TRACE_DEFAULT_SIZE);
+    define("ota_0", ESP_PARTITION_TYPE_APP, ESP_PARTITION_SUBTYPE_APP_OTA_0, HOST_APP_SLOT_SIZE);
+    define("ota_1", ESP_PARTITION_TYPE_APP, ESP_PARTITION_SUBTYPE_APP_OTA_1, HOST_APP_SLOT_SIZE);
+}
+
+void host_partition_define(const char *label, size_t size)
+{
+    define(label, ESP_PARTITION_TYPE_DATA, 0x40, size);   // Custom data subtype
+}
+
+const char *host_partition_boot_label(void)
+{
+    const esp_partition_t *boot = esp_ota_get_boot_partition();
+    return boot ? boot->label : "";
+}
+
+uint32_t host_partition_erase_count(void)
+{
+    return erases;
+}
+
+uint32_t host_partition_write_count(void)
+{
+    return writes;
+}
+
+// ============================================================================
+// PARTITION API
+// ============================================================================
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype,
+                                                const char *label)
+{
+    for (int i = 0; i < HOST_MAX_PARTITIONS; i++) {
+        host_partition_t *p = &partitions[i];
+        if (!p->defined || p->part.type != type ||
+            (subtype != ESP_PARTITION_SUBTYPE_ANY && p->part.subtype != subtype) ||
+            (label && strcmp(p->part.label, label) != 0)) {
+            continue;
+        }
+        if (!p->data) {
+            p->data = malloc(p->part.size);
+            if (!p->data) {
+                return NULL;
+            }
+            memset(p->data, 0xFF, p->part.size);
+        }
+        return &p->part;
+    }
+    return NULL;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t *partition, size_t src_offset, void *dst, size_t size)
+{
+    host_partition_t *p = from_handle(partition);
+    if (!p || !dst) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!in_range(p, src_offset, size)) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memcpy(dst, p->data + src_offset, size);
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_write(const esp_partition_t *partition, size_t dst_offset, const void *src, size_t size)
+{
+    host_partition_t *p = from_handle(partition);
+    if (!p || !src) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!in_range(p, dst_offset, size)) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    const uint8_t *in = src;
+    for (size_t i = 0; i < size; i++) {
+        p->data[dst_offset + i] &= in[i];
+    }
+    writes++;
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t *partition, size_t offset, size_t size)
+{
+    host_partition_t *p = from_handle(partition);
+    if (!p) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (offset % HOST_SECTOR_SIZE || size % HOST_SECTOR_SIZE) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!in_range(p, offset, size)) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memset(p->data + offset, 0xFF, size);
+    erases++;
+    return ESP_OK;
+}
+
+// ============================================================================
+// OTA API
+// ============================================================================
+
+const esp_partition_t *esp_ota_get_running_partition(void)
+{
+    return app_slot(ESP_PARTITION_SUBTYPE_APP_OTA_0);
+}
+
+const esp_partition_t *esp_ota_get_boot_partition(void)
+{
+    return boot_slot ? boot_slot : esp_ota_get_running_partition();
+}
+
+const esp_partition_t *esp_ota_get_next_update_partition(const esp_partition_t *start_from)
+{
+    const esp_partition_t *from = start_from ? start_from : esp_ota_get_running_partition();
+    if (!from) {
+        return NULL;
+    }
+    return app_slot(from->subtype == ESP_PARTITION_SUBTYPE_APP_OTA_0 ?
+                    ESP_PARTITION_SUBTYPE_APP_OTA_1 : ESP_PARTITION_SUBTYPE_APP_OTA_0);
+}
+
+esp_err_t esp_ota_set_boot_partition(const esp_partition_t *partition)
+{
+    host_partition_t *p = from_handle(partition);
+    if (!p || p->part.type != ESP_PARTITION_TYPE_APP) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    // Stands in for esp_image_verify(): an erased or foreign slot is rejected
+    if (!p->data || p->data[0] != HOST_APP_IMAGE_MAGIC) {
+        return ESP_ERR_OTA_VALIDATE_FAILED;
+    }
+    boot_slot = partition;
+    return ESP_OK;
+}
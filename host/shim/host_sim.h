@@ -0,0 +1,502 @@
+/*
+ * Glyph C6 Monitor - Host Build Simulation Control
+ *
+ * Version: 1.0.0
+ *
+ * Control surface of the host shims: the firmware modules are compiled
+ * unchanged against the ESP-IDF headers in shim/include, and tests or
+ * simulators drive the fakes through this header.
+ *
+ * - Virtual time: a single clock (RTC time, survives simulated deep sleep)
+ *   plus a boot-relative clock (esp_timer / FreeRTOS ticks). Nothing in
+ *   the host build reads the wall clock; delays advance virtual time and
+ *   run the events that fall due on the way.
+ * - I2C: devices are attached per 7-bit address with transmit/receive
+ *   callbacks; bus time is charged per transferred bit at the device SCL.
+ * - ADC: per-channel millivolt source (constant or callback), scripted
+ *   read failures.
+ * - Deep sleep: esp_deep_sleep_start() advances the clock by the armed
+ *   timer and long-jumps back to the harness (HOST_DEEP_SLEEP_CATCH).
+ * - Zigbee: in-memory attribute store built from the registered endpoint,
+ *   report log, scheduler alarms on virtual time and a scripted join.
+ * - Raw 802.15.4: transmit log with airtime and radio on-time.
+ * - NVS / flash partitions: RAM-backed with NOR write semantics.
+ */
+
+#ifndef HOST_SIM_H
+#define HOST_SIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include "esp_err.h"
+
+// ============================================================================
+// GLOBAL
+// ============================================================================
+
+/**
+ * @brief Reset every fake to its power-on state (clock, devices, stores)
+ *
+ * Also restores RTC_DATA_ATTR variables to their initializers, clears
+ * RTC_NOINIT_ATTR memory and resets the ordinary statics of the firmware
+ * modules (as host_time_reboot()) - re-run their init functions.
+ */
+void host_sim_reset(void);
+
+/**
+ * @brief Simulated power loss: RTC memory back to power-on, NVS and flash kept
+ *
+ * A host_time_reboot() that also restores RTC_DATA_ATTR variables and
+ * clears RTC_NOINIT_ATTR memory - re-run the init functions.
+ */
+void host_sim_power_cycle(void);
+
+// ============================================================================
+// VIRTUAL TIME
+// ============================================================================
+
+typedef void (*host_event_cb_t)(void *arg);
+
+/**
+ * @brief Virtual RTC time in microseconds (keeps counting through deep sleep)
+ */
+uint64_t host_time_now_us(void);
+
+/**
+ * @brief Virtual time since the last (simulated) boot in microseconds
+ */
+uint64_t host_time_since_boot_us(void);
+
+/**
+ * @brief Advance virtual time, running due events in order
+ * @param us Microseconds to advance
+ */
+void host_time_advance_us(uint64_t us);
+
+/**
+ * @brief Advance virtual time to an absolute deadline, running due events
+ * @param deadline_us Absolute virtual time to stop at (no-op if in the past)
+ */
+void host_time_run_until_us(uint64_t deadline_us);
+
+/**
+ * @brief Schedule a callback at now + delay_us
+ * @return Event id (> 0) for host_time_cancel()
+ */
+uint32_t host_time_schedule(uint64_t delay_us, host_event_cb_t cb, void *arg);
+
+/**
+ * @brief Cancel a pending event
+ */
+void host_time_cancel(uint32_t id);
+
+/**
+ * @brief Simulated chip reset
+ *
+ * Drops pending events and created tasks, restarts the boot-relative
+ * clock, restores the firmware's ordinary statics (.data/.bss) to their
+ * initializers and forgets the volatile Zigbee stack state. RTC memory,
+ * NVS and flash are kept. Heap allocations of the previous boot leak.
+ */
+void host_time_reboot(void);
+
+// ============================================================================
+// TASKS
+// ============================================================================
+
+/**
+ * @brief Run a task created with xTaskCreate() on the caller's stack
+ *
+ * Created tasks are recorded, not scheduled; the harness runs the ones it
+ * needs. Returns when the task function returns (never if it deep sleeps).
+ *
+ * @param name Task name given to xTaskCreate()
+ * @return false if no such task exists
+ */
+bool host_task_run(const char *name);
+
+// ============================================================================
+// I2C
+// ============================================================================
+
+// Return ESP_FAIL for a NACK; ESP_ERR_TIMEOUT (stuck bus) also charges the
+// caller's transfer timeout
+typedef struct {
+    esp_err_t (*transmit)(void *ctx, const uint8_t *data, size_t len);
+    esp_err_t (*receive)(void *ctx, uint8_t *data, size_t len);
+} host_i2c_device_ops_t;
+
+/**
+ * @brief Attach a simulated device to the bus
+ * @param addr 7-bit address
+ * @param ops Transfer callbacks (called after bus time is charged)
+ * @param ctx Device context
+ */
+void host_i2c_attach(uint16_t addr, const host_i2c_device_ops_t *ops, void *ctx);
+
+/**
+ * @brief Detach a device (transfers to it NACK with ESP_FAIL)
+ */
+void host_i2c_detach(uint16_t addr);
+
+/**
+ * @brief Number of transfers issued since reset (all devices)
+ */
+uint32_t host_i2c_transfer_count(void);
+
+// Scripted device: writes are recorded, reads are served from a queue
+#define HOST_I2C_SCRIPT_MAX_STEPS   32
+#define HOST_I2C_SCRIPT_MAX_BYTES   8
+
+typedef struct {
+    esp_err_t result;
+    uint8_t len;
+    uint8_t data[HOST_I2C_SCRIPT_MAX_BYTES];
+} host_i2c_script_step_t;
+
+typedef struct {
+    host_i2c_script_step_t reads[HOST_I2C_SCRIPT_MAX_STEPS];
+    uint8_t read_head;
+    uint8_t read_count;
+    uint8_t last_write[HOST_I2C_SCRIPT_MAX_BYTES];
+    uint8_t last_write_len;
+    uint32_t write_count;
+    esp_err_t write_result;                  // Returned by every write
+} host_i2c_script_t;
+
+/**
+ * @brief Attach a scripted device (queue reads with host_i2c_script_push_read)
+ */
+void host_i2c_script_attach(host_i2c_script_t *script, uint16_t addr);
+
+/**
+ * @brief Queue the response of the next read
+ * @param result ESP_OK to return data, or the error to fail the read with
+ */
+void host_i2c_script_push_read(host_i2c_script_t *script, esp_err_t result,
+                               const uint8_t *data, size_t len);
+
+// ============================================================================
+// ADC
+// ============================================================================
+
+typedef int (*host_adc_source_t)(int channel, void *ctx);   // Returns millivolts at the pin
+
+/**
+ * @brief Constant millivolts at an ADC channel pin
+ */
+void host_adc_set_mv(int channel, int millivolts);
+
+/**
+ * @brief Dynamic millivolts at an ADC channel pin (e.g. a battery model)
+ *
+ * A negative value from the source fails that conversion (ESP_ERR_TIMEOUT).
+ */
+void host_adc_set_source(int channel, host_adc_source_t source, void *ctx);
+
+/**
+ * @brief Pin millivolts that the host conversion turns into this raw value
+ */
+int host_adc_raw_to_mv(int raw);
+
+/**
+ * @brief Fail the next n oneshot reads with ESP_ERR_TIMEOUT
+ */
+void host_adc_fail_next(int n);
+
+/**
+ * @brief Make calibration scheme creation fail (raw values only)
+ */
+void host_adc_set_calibration_available(bool available);
+
+/**
+ * @brief Number of oneshot conversions since reset
+ */
+uint32_t host_adc_read_count(void);
+
+// ============================================================================
+// DEEP SLEEP
+// ============================================================================
+
+/**
+ * @brief Catch esp_deep_sleep_start() in the calling frame
+ *
+ * Evaluates to false when armed and to true after the device "woke up"
+ * (the clock has advanced by the sleep duration and the wake cause is
+ * TIMER). Usage:
+ *
+ *     if (!HOST_DEEP_SLEEP_CATCH()) {
+ *         deep_sleep_enter();      // does not return
+ *     }
+ *     // woke up here
+ */
+#define HOST_DEEP_SLEEP_CATCH()  (setjmp(*host_sleep_arm()) != 0)
+
+/**
+ * @brief Arm the deep sleep catch point (use HOST_DEEP_SLEEP_CATCH)
+ */
+jmp_buf *host_sleep_arm(void);
+
+/**
+ * @brief Duration of the last deep sleep in microseconds (0 if none)
+ */
+uint64_t host_sleep_last_duration_us(void);
+
+/**
+ * @brief Time awake (since boot) when the last deep sleep started (0 if none)
+ */
+uint64_t host_sleep_last_awake_us(void);
+
+/**
+ * @brief Number of deep sleeps since reset
+ */
+uint32_t host_sleep_count(void);
+
+/**
+ * @brief Wake cause reported by esp_sleep_get_wakeup_cause() (int cast)
+ */
+void host_sleep_set_wakeup_cause(int cause);
+
+// ============================================================================
+// ZIGBEE
+// ============================================================================
+
+typedef struct {
+    uint64_t time_us;                        // Virtual time of the request
+    uint16_t cluster_id;
+    uint16_t attr_id;
+    uint8_t value[64];                       // Attribute value at report time
+    uint8_t value_len;
+    bool delivered;                          // Reached the coordinator (parent link loss)
+} host_zb_report_t;
+
+#define HOST_ZB_MAX_REPORTS   256
+
+// Stack activity as seen on the air (for channel / fleet models)
+typedef enum {
+    HOST_ZB_EVENT_STACK_START = 0,           // esp_zb_start(): radio on
+    HOST_ZB_EVENT_JOINED,                    // Steering or rejoin succeeded
+    HOST_ZB_EVENT_REPORT,                    // Attribute report sent
+    HOST_ZB_EVENT_STACK_STOP,                // Chip reset or deep sleep: radio off
+    HOST_ZB_EVENT_POLL,                      // MAC data request to the parent
+} host_zb_event_type_t;
+
+typedef struct {
+    host_zb_event_type_t type;
+    uint64_t time_us;
+    uint16_t cluster_id;                     // REPORT only
+    uint16_t attr_id;                        // REPORT only
+    uint16_t value_len;                      // REPORT only: attribute value size
+} host_zb_event_t;
+
+typedef void (*host_zb_event_hook_t)(const host_zb_event_t *event, void *ctx);
+
+/**
+ * @brief Observe stack activity (cleared by host_sim_reset)
+ */
+void host_zb_set_event_hook(host_zb_event_hook_t hook, void *ctx);
+
+/**
+ * @brief Read an attribute from the store
+ * @return Value size copied, or -1 if the attribute does not exist
+ */
+int host_zb_get_attr(uint8_t endpoint, uint16_t cluster_id, uint16_t attr_id,
+                     void *out, size_t max_len);
+
+/**
+ * @brief Number of attribute reports sent since reset
+ */
+uint32_t host_zb_report_count(void);
+
+/**
+ * @brief Get a logged report (oldest first, last HOST_ZB_MAX_REPORTS kept)
+ */
+const host_zb_report_t *host_zb_report_get(uint32_t index);
+
+/**
+ * @brief Script the network: factory-new state and steering outcome
+ * @param factory_new true = not commissioned (first start steers)
+ * @param steering_status Status of each steering attempt (ESP_OK = joined)
+ * @param steering_latency_ms Time from steering start to its signal
+ */
+void host_zb_set_network(bool factory_new, esp_err_t steering_status, uint32_t steering_latency_ms);
+
+/**
+ * @brief Script the rejoin of a commissioned device (INITIALIZATION)
+ * @param status Status of DEVICE_REBOOT (ESP_OK = rejoined)
+ * @param latency_ms Extra time before DEVICE_REBOOT is delivered (default 0)
+ */
+void host_zb_set_rejoin(esp_err_t status, uint32_t latency_ms);
+
+/**
+ * @brief Script esp_zb_zcl_report_attr_cmd_req() (default ESP_OK)
+ * @param status Anything but ESP_OK: reports are refused, nothing is sent
+ */
+void host_zb_set_report_status(esp_err_t status);
+
+// Routers in range of the device (the coordinator counts as one)
+typedef struct {
+    uint16_t short_addr;
+    uint8_t lqi;                             // As seen by the device (neighbor table)
+    int8_t rssi;                             // dBm
+    float loss;                              // Probability a frame through it is not delivered
+} host_zb_router_t;
+
+#define HOST_ZB_MAX_ROUTERS   4
+
+/**
+ * @brief Script the routers in range (default: the coordinator only, lossless)
+ *
+ * Steering and leave-with-rejoin pick the router with the best LQI as
+ * parent; a rejoin from NVRAM keeps the previous parent.
+ *
+ * @param routers Router table (copied)
+ * @param count Number of routers (1..HOST_ZB_MAX_ROUTERS)
+ */
+void host_zb_set_routers(const host_zb_router_t *routers, size_t count);
+
+/**
+ * @brief Change the link to one router (LQI, RSSI and loss) from now on
+ */
+void host_zb_set_router_link(size_t index, uint8_t lqi, int8_t rssi, float loss);
+
+/**
+ * @brief Index of the current parent in the router table
+ */
+size_t host_zb_parent_index(void);
+
+/**
+ * @brief Total time the Zigbee stack ran (esp_zb_start to reboot) since reset
+ */
+uint64_t host_zb_radio_on_us(void);
+
+/**
+ * @brief Deliver an application signal to esp_zb_app_signal_handler()
+ */
+void host_zb_emit_signal(uint32_t signal, esp_err_t status);
+
+/**
+ * @brief Simulate a coordinator attribute write (store + action handler)
+ * @return Action handler result (ESP_ERR_NOT_FOUND for an unknown attribute,
+ *         ESP_ERR_INVALID_ARG when the cluster's check_value handler refuses
+ *         the value: answered with INVALID_VALUE, nothing stored)
+ */
+esp_err_t host_zb_write_attr(uint8_t endpoint, uint16_t cluster_id, uint16_t attr_id,
+                             const void *value, size_t len);
+
+#define HOST_ZB_MAX_INDIRECT  8
+
+/**
+ * @brief Queue a coordinator attribute write at the parent (indirect frame)
+ *
+ * A sleepy device only gets it by polling: each data request releases
+ * the oldest queued frame, delivered like host_zb_write_attr(). The
+ * queue lives at the parent, so it survives reboots and deep sleep.
+ *
+ * @return ESP_ERR_NO_MEM when HOST_ZB_MAX_INDIRECT frames are queued
+ */
+esp_err_t host_zb_queue_write(uint8_t endpoint, uint16_t cluster_id, uint16_t attr_id,
+                              const void *value, size_t len);
+
+/**
+ * @brief Queue a frame that is not a ZCL write at the parent (e.g. a ZDO
+ *        request, profile 0)
+ *
+ * Released by a data poll like host_zb_queue_write(); only the APS data
+ * indication handler sees it.
+ *
+ * @return ESP_ERR_INVALID_ARG for the HA profile, ESP_ERR_NO_MEM when full
+ */
+esp_err_t host_zb_queue_frame(uint16_t profile_id, uint16_t cluster_id);
+
+/**
+ * @brief Frames still queued at the parent
+ */
+size_t host_zb_indirect_pending(void);
+
+/**
+ * @brief MAC data requests sent since reset
+ */
+uint32_t host_zb_poll_count(void);
+
+// ============================================================================
+// RAW 802.15.4 (esp_ieee802154)
+// ============================================================================
+
+#define HOST_IEEE802154_MAX_PSDU    125   // 127-octet PHY payload without the FCS
+#define HOST_IEEE802154_MAX_FRAMES  64    // Transmit log (oldest overwritten)
+
+typedef struct {
+    uint64_t time_us;                        // Virtual time the transmit started
+    uint8_t channel;
+    uint8_t len;                             // MAC frame length without the FCS
+    uint8_t psdu[HOST_IEEE802154_MAX_PSDU];
+} host_ieee802154_frame_t;
+
+typedef void (*host_ieee802154_hook_t)(const host_ieee802154_frame_t *frame, void *ctx);
+
+/**
+ * @brief Receive every transmitted frame (e.g. a sink model; cleared by host_sim_reset)
+ */
+void host_ieee802154_set_tx_hook(host_ieee802154_hook_t hook, void *ctx);
+
+/**
+ * @brief Frames transmitted since reset
+ */
+uint32_t host_ieee802154_frame_count(void);
+
+/**
+ * @brief A logged frame
+ * @return Frame, or NULL if out of range or already overwritten
+ */
+const host_ieee802154_frame_t *host_ieee802154_frame_get(uint32_t index);
+
+/**
+ * @brief Total time the raw radio was enabled since reset
+ */
+uint64_t host_ieee802154_on_us(void);
+
+// ============================================================================
+// NVS / FLASH
+// ============================================================================
+
+/**
+ * @brief Size of the RAM-backed data partition with the given label
+ *
+ * Must be called before the firmware looks the partition up; the
+ * "history" partition defaults to 256 KB, "trace" to 256 KB (partitions.csv).
+ */
+void host_partition_define(const char *label, size_t size);
+
+/**
+ * @brief Flash operation counters since reset
+ */
+uint32_t host_partition_erase_count(void);
+uint32_t host_partition_write_count(void);
+
+/**
+ * @brief Label of the app slot selected for the next boot
+ *
+ * The image runs from "ota_0"; an OTA that ends in
+ * esp_ota_set_boot_partition() switches this to "ota_1".
+ */
+const char *host_partition_boot_label(void);
+
+/**
+ * @brief Number of NVS commits since reset
+ */
+uint32_t host_nvs_commit_count(void);
+
+// ============================================================================
+// LOGGING
+// ============================================================================
+
+/**
+ * @brief Print ESP_LOGx output at or below this level (default: warnings)
+ * @param level esp_log_level_t value (ESP_LOG_NONE..ESP_LOG_VERBOSE)
+ */
+void host_log_set_level(int level);
+
+#endif // HOST_SIM_H
@@ -0,0 +1,112 @@
+/*
+ * Glyph C6 Monitor - Host Shim: Deep Sleep and Restart
+ *
+ * Version: 1.0.0
+ */
+
+#include "host_sim.h"
+#include "host_internal.h"
+#include "esp_sleep.h"
+#include "esp_system.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+static jmp_buf catch_point;
+static bool armed;
+static uint64_t timer_wakeup_us;
+static uint64_t last_duration_us;
+static uint64_t last_awake_us;
+static uint32_t sleeps;
+static esp_sleep_wakeup_cause_t wakeup_cause;
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+static void __attribute__((noreturn)) reboot_to_catch_point(const char *what)
+{
+    if (!armed) {
+        fprintf(stderr, "host_sleep: %s without HOST_DEEP_SLEEP_CATCH()\n", what);
+        abort();
+    }
+    armed = false;
+    host_time_reboot();
+    longjmp(catch_point, 1);
+}
+
+// ============================================================================
+// SIMULATION CONTROL
+// ============================================================================
+
+void host_sleep_reset(void)
+{
+    armed = false;
+    timer_wakeup_us = 0;
+    last_duration_us = 0;
+    last_awake_us = 0;
+    sleeps = 0;
+    wakeup_cause = ESP_SLEEP_WAKEUP_UNDEFINED;
+}
+
+jmp_buf *host_sleep_arm(void)
+{
+    armed = true;
+    return &catch_point;
+}
+
+uint64_t host_sleep_last_duration_us(void)
+{
+    return last_duration_us;
+}
+
+uint64_t host_sleep_last_awake_us(void)
+{
+    return last_awake_us;
+}
+
+uint32_t host_sleep_count(void)
+{
+    return sleeps;
+}
+
+void host_sleep_set_wakeup_cause(int cause)
+{
+    wakeup_cause = (esp_sleep_wakeup_cause_t)cause;
+}
+
+// ============================================================================
+// ESP-IDF API
+// ============================================================================
+
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause(void)
+{
+    return wakeup_cause;
+}
+
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t time_in_us)
+{
+    timer_wakeup_us = time_in_us;
+    return ESP_OK;
+}
+
+void esp_deep_sleep_start(void)
+{
+    if (!armed) {
+        fprintf(stderr, "host_sleep: esp_deep_sleep_start() without HOST_DEEP_SLEEP_CATCH()\n");
+        abort();
+    }
+    last_duration_us = timer_wakeup_us;
+    last_awake_us = host_time_since_boot_us();
+    sleeps++;
+    wakeup_cause = ESP_SLEEP_WAKEUP_TIMER;
+
+    host_time_reboot();                      // Volatile state is lost at sleep entry
+    host_time_advance_us(timer_wakeup_us);   // Nothing is scheduled while asleep
+    reboot_to_catch_point("esp_deep_sleep_start()");
+}
+
+void esp_restart(void)
+{
+    wakeup_cause = ESP_SLEEP_WAKEUP_UNDEFINED;
+    reboot_to_catch_point("esp_restart()");
+}
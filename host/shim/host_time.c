@@ -0,0 +1,167 @@
+/*
+ * Glyph C6 Monitor - Host Shim: Virtual Time
+ *
+ * Version: 1.0.0
+ */
+
+#include "host_sim.h"
+#include "host_internal.h"
+#include "esp_timer.h"
+#include "esp_rom_sys.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+
+#define HOST_MAX_EVENTS   64
+
+typedef struct {
+    uint32_t id;                  // 0 = free slot
+    uint64_t at_us;
+    uint64_t seq;                 // FIFO order for events due at the same time
+    host_event_cb_t cb;
+    void *arg;
+} host_event_t;
+
+static uint64_t now_us;
+static uint64_t boot_us;
+static uint32_t next_id;
+static uint64_t next_seq;
+static host_event_t events[HOST_MAX_EVENTS];
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+static host_event_t *earliest_due(uint64_t deadline_us)
+{
+    host_event_t *best = NULL;
+    for (int i = 0; i < HOST_MAX_EVENTS; i++) {
+        host_event_t *ev = &events[i];
+        if (ev->id == 0 || ev->at_us > deadline_us) {
+            continue;
+        }
+        if (!best || ev->at_us < best->at_us ||
+            (ev->at_us == best->at_us && ev->seq < best->seq)) {
+            best = ev;
+        }
+    }
+    return best;
+}
+
+// ============================================================================
+// PUBLIC FUNCTIONS
+// ============================================================================
+
+void host_time_reset(void)
+{
+    // Start well past the epoch so "time since" arithmetic never underflows
+    now_us = 1000000ULL;
+    boot_us = now_us;
+    next_id = 1;
+    next_seq = 0;
+    for (int i = 0; i < HOST_MAX_EVENTS; i++) {
+        events[i].id = 0;
+    }
+}
+
+uint64_t host_time_now_us(void)
+{
+    return now_us;
+}
+
+uint64_t host_time_since_boot_us(void)
+{
+    return now_us - boot_us;
+}
+
+bool host_time_run_next(uint64_t deadline_us)
+{
+    host_event_t *ev = earliest_due(deadline_us);
+    if (!ev) {
+        return false;
+    }
+    host_event_cb_t cb = ev->cb;
+    void *arg = ev->arg;
+    if (ev->at_us > now_us) {
+        now_us = ev->at_us;
+    }
+    ev->id = 0;
+    cb(arg);
+    return true;
+}
+
+void host_time_run_until_us(uint64_t deadline_us)
+{
+    while (host_time_run_next(deadline_us)) {
+    }
+    if (deadline_us > now_us) {
+        now_us = deadline_us;
+    }
+}
+
+void host_time_advance_us(uint64_t us)
+{
+    host_time_run_until_us(now_us + us);
+}
+
+uint32_t host_time_schedule(uint64_t delay_us, host_event_cb_t cb, void *arg)
+{
+    for (int i = 0; i < HOST_MAX_EVENTS; i++) {
+        host_event_t *ev = &events[i];
+        if (ev->id == 0) {
+            ev->id = next_id++;
+            if (next_id == 0) {
+                next_id = 1;
+            }
+            ev->at_us = now_us + delay_us;
+            ev->seq = next_seq++;
+            ev->cb = cb;
+            ev->arg = arg;
+            return ev->id;
+        }
+    }
+    fprintf(stderr, "host_time: event queue full (%d)\n", HOST_MAX_EVENTS);
+    abort();
+}
+
+void host_time_cancel(uint32_t id)
+{
+    for (int i = 0; i < HOST_MAX_EVENTS && id != 0; i++) {
+        if (events[i].id == id) {
+            events[i].id = 0;
+        }
+    }
+}
+
+void host_time_reboot(void)
+{
+    for (int i = 0; i < HOST_MAX_EVENTS; i++) {
+        events[i].id = 0;
+    }
+    boot_us = now_us;
+    host_ram_reset();
+    host_freertos_reset();   // Tasks die with the chip
+    host_zb_on_reboot();
+    host_ieee802154_on_reboot();
+}
+
+void esp_rom_delay_us(uint32_t us)
+{
+    host_time_advance_us(us);
+}
+
+int64_t esp_timer_get_time(void)
+{
+    return (int64_t)host_time_since_boot_us();
+}
+
+// Linked with -Wl,--wrap=gettimeofday: the RTC clock is virtual
+int __wrap_gettimeofday(struct timeval *tv, void *tz)
+{
+    (void)tz;
+    if (tv) {
+        tv->tv_sec = (time_t)(now_us / 1000000ULL);
+        tv->tv_usec = (suseconds_t)(now_us % 1000000ULL);
+    }
+    return 0;
+}
@@ -0,0 +1,1199 @@
+/*
+ * Glyph C6 Monitor - Host Shim: Zigbee Stack Fake
+ *
+ * Version: 1.0.0
+ *
+ * Keeps the clusters registered by the firmware as a plain attribute
+ * store, logs attribute reports, runs scheduler alarms on virtual time
+ * and plays a scripted commissioning sequence:
+ *
+ *   esp_zb_start()              -> SKIP_STARTUP
+ *   INITIALIZATION              -> DEVICE_FIRST_START (factory new) / DEVICE_REBOOT
+ *                                  (rejoin: scripted latency and status)
+ *   NETWORK_STEERING            -> STEERING after the scripted latency and status
+ *   leave request with rejoin   -> LEAVE (type REJOIN), then DEVICE_REBOOT after a
+ *                                  beacon scan and the scripted rejoin
+ *
+ * Frames go through a parent picked from a scripted router table; each
+ * report is delivered or lost with the parent's loss probability and
+ * confirmed to the send-status handler shortly after. Coordinator writes
+ * queued at the parent (indirect frames) reach the device one per data
+ * poll, the frame-pending bit standing for "more queued".
+ *
+ * Signals are delivered to the application's esp_zb_app_signal_handler().
+ */
+
+#include "host_sim.h"
+#include "host_internal.h"
+#include "esp_zigbee_core.h"
+#include "zboss_api.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HOST_ZB_MAX_ALARMS     32
+#define HOST_ZB_SIGNAL_DELAY_US  5000     // Stack latency before a signal is delivered
+#define HOST_ZB_SEND_STATUS_US   20000    // Report request to APS ack / MAC failure
+#define HOST_ZB_BEACON_SCAN_US   200000   // Active scan of a leave-with-rejoin
+#define HOST_ZB_POLL_US          5000     // Data request to queued frame / empty ack
+
+// ============================================================================
+// ATTRIBUTE STORE
+// ============================================================================
+
+typedef struct {
+    uint16_t id;
+    uint8_t type;
+    uint8_t access;
+    uint16_t capacity;            // Bytes reserved (strings: length byte + max length)
+    uint8_t *value;
+} host_zb_attr_t;
+
+struct host_zb_attr_list {
+    uint16_t cluster_id;
+    uint8_t role;
+    size_t count;
+    host_zb_attr_t *attrs;
+    struct host_zb_attr_list *next_alloc;
+};
+
+struct host_zb_cluster_list {
+    size_t count;
+    esp_zb_attribute_list_t *clusters[16];
+    struct host_zb_cluster_list *next_alloc;
+};
+
+struct host_zb_ep_list {
+    size_t count;
+    esp_zb_endpoint_config_t config[4];
+    esp_zb_cluster_list_t *clusters[4];
+    struct host_zb_ep_list *next_alloc;
+};
+
+// Everything allocated since reset (freed by host_zb_reset)
+static esp_zb_attribute_list_t *attr_lists;
+static esp_zb_cluster_list_t *cluster_lists;
+static esp_zb_ep_list_t *ep_lists;
+static esp_zb_ep_list_t *registered;
+
+// ============================================================================
+// STACK STATE
+// ============================================================================
+
+typedef struct {
+    bool used;
+    uint32_t event_id;
+    esp_zb_callback_t cb;
+    uint8_t param;
+} host_zb_alarm_t;
+
+static host_zb_alarm_t alarms[HOST_ZB_MAX_ALARMS];
+static esp_zb_core_action_handler_t action_handler;
+static int lock_depth;
+static bool started;
+static uint64_t started_at_us;       // Virtual time the stack was started
+static uint64_t radio_on_us;         // Stack running time of finished boots
+
+// Scripted network
+static bool factory_new;
+static esp_err_t steering_status;
+static uint32_t steering_latency_ms;
+static esp_err_t rejoin_status;
+static uint32_t rejoin_latency_ms;
+static esp_err_t report_status;            // esp_zb_zcl_report_attr_cmd_req() result
+static bool joined;
+
+// Routers in range and the current parent (kept across reboots like NVRAM)
+static host_zb_router_t routers[HOST_ZB_MAX_ROUTERS];
+static size_t router_count;
+static size_t parent;
+static uint32_t link_rng;
+
+// Delivery confirmations and leave-with-rejoin
+static esp_zb_zcl_command_send_status_callback_t send_status_handler;
+static esp_zb_zdo_signal_leave_params_t leave_params;
+static esp_zb_zdo_mgmt_leave_callback_t leave_cb;
+static void *leave_cb_ctx;
+static bool leave_rejoin_pending;
+
+// Frames the parent holds for this device (survive reboots like the parent):
+// attribute writes (HA profile) or other APS frames (e.g. ZDO, profile 0)
+typedef struct {
+    uint16_t profile_id;
+    uint8_t endpoint;
+    uint16_t cluster_id;
+    uint16_t attr_id;
+    uint8_t value[64];
+    uint8_t len;
+} host_zb_indirect_t;
+
+static host_zb_indirect_t indirect[HOST_ZB_MAX_INDIRECT];
+static size_t indirect_count;
+static uint32_t poll_total;
+static esp_zb_zcl_raw_command_callback_t raw_handler;
+static esp_zb_aps_data_indication_callback_t aps_handler;
+
+// Custom cluster handlers (esp_zb_zcl_custom_cluster_handlers_update)
+#define HOST_ZB_MAX_CLUSTER_HANDLERS  4
+static esp_zb_zcl_custom_cluster_handlers_t cluster_handlers[HOST_ZB_MAX_CLUSTER_HANDLERS];
+static size_t cluster_handler_count;
+
+// Activity observer
+static host_zb_event_hook_t event_hook;
+static void *event_hook_ctx;
+
+// Report log (ring)
+static host_zb_report_t reports[HOST_ZB_MAX_REPORTS];
+static uint32_t report_total;
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+static uint16_t type_size(uint8_t type, const void *value_p)
+{
+    switch (type) {
+    case ESP_ZB_ZCL_ATTR_TYPE_BOOL:
+    case ESP_ZB_ZCL_ATTR_TYPE_8BITMAP:
+    case ESP_ZB_ZCL_ATTR_TYPE_U8:
+    case ESP_ZB_ZCL_ATTR_TYPE_S8:
+    case ESP_ZB_ZCL_ATTR_TYPE_8BIT_ENUM:
+        return 1;
+    case ESP_ZB_ZCL_ATTR_TYPE_U16:
+    case ESP_ZB_ZCL_ATTR_TYPE_S16:
+        return 2;
+    case ESP_ZB_ZCL_ATTR_TYPE_U32:
+    case ESP_ZB_ZCL_ATTR_TYPE_S32:
+    case ESP_ZB_ZCL_ATTR_TYPE_UTC_TIME:
+        return 4;
+    case ESP_ZB_ZCL_ATTR_TYPE_OCTET_STRING:
+    case ESP_ZB_ZCL_ATTR_TYPE_CHAR_STRING:
+        // Strings are sized by their initial length byte
+        return (uint16_t)(1 + (value_p ? *(const uint8_t *)value_p : 0));
+    default:
+        return 4;
+    }
+}
+
+static bool is_string(uint8_t type)
+{
+    return type == ESP_ZB_ZCL_ATTR_TYPE_OCTET_STRING || type == ESP_ZB_ZCL_ATTR_TYPE_CHAR_STRING;
+}
+
+static esp_err_t list_add(esp_zb_attribute_list_t *list, uint16_t attr_id, uint8_t type,
+                          uint8_t access, const void *value_p)
+{
+    if (!list) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (size_t i = 0; i < list->count; i++) {
+        if (list->attrs[i].id == attr_id) {
+            return ESP_ERR_INVALID_STATE;  // Duplicate attribute
+        }
+    }
+    host_zb_attr_t *attrs = realloc(list->attrs, (list->count + 1) * sizeof(*attrs));
+    if (!attrs) {
+        return ESP_ERR_NO_MEM;
+    }
+    list->attrs = attrs;
+    host_zb_attr_t *attr = &attrs[list->count];
+    attr->id = attr_id;
+    attr->type = type;
+    attr->access = access;
+    attr->capacity = type_size(type, value_p);
+    attr->value = calloc(1, attr->capacity);
+    if (!attr->value) {
+        return ESP_ERR_NO_MEM;
+    }
+    if (value_p) {
+        memcpy(attr->value, value_p, attr->capacity);
+    }
+    list->count++;
+    return ESP_OK;
+}
+
+static esp_zb_attribute_list_t *list_create(uint16_t cluster_id)
+{
+    esp_zb_attribute_list_t *list = calloc(1, sizeof(*list));
+    if (list) {
+        list->cluster_id = cluster_id;
+        list->next_alloc = attr_lists;
+        attr_lists = list;
+    }
+    return list;
+}
+
+static host_zb_attr_t *find_attr(uint8_t endpoint, uint16_t cluster_id, uint8_t role, uint16_t attr_id)
+{
+    if (!registered) {
+        return NULL;
+    }
+    for (size_t e = 0; e < registered->count; e++) {
+        if (registered->config[e].endpoint != endpoint || !registered->clusters[e]) {
+            continue;
+        }
+        const esp_zb_cluster_list_t *cl = registered->clusters[e];
+        for (size_t c = 0; c < cl->count; c++) {
+            esp_zb_attribute_list_t *list = cl->clusters[c];
+            if (list->cluster_id != cluster_id || (role && list->role != role)) {
+                continue;
+            }
+            for (size_t a = 0; a < list->count; a++) {
+                if (list->attrs[a].id == attr_id) {
+                    return &list->attrs[a];
+                }
+            }
+        }
+    }
+    return NULL;
+}
+
+static void attr_store(host_zb_attr_t *attr, const void *value_p)
+{
+    if (is_string(attr->type)) {
+        uint8_t len = *(const uint8_t *)value_p;
+        if (len > attr->capacity - 1) {
+            len = (uint8_t)(attr->capacity - 1);
+        }
+        memcpy(attr->value + 1, (const uint8_t *)value_p + 1, len);
+        attr->value[0] = len;
+    } else {
+        memcpy(attr->value, value_p, attr->capacity);
+    }
+}
+
+static uint16_t attr_len(const host_zb_attr_t *attr)
+{
+    return is_string(attr->type) ? (uint16_t)(1 + attr->value[0]) : attr->capacity;
+}
+
+static esp_err_t cluster_list_add(esp_zb_cluster_list_t *l, esp_zb_attribute_list_t *a, uint8_t role)
+{
+    if (!l || !a) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (l->count >= sizeof(l->clusters) / sizeof(l->clusters[0])) {
+        return ESP_ERR_NO_MEM;
+    }
+    a->role = role;
+    l->clusters[l->count++] = a;
+    return ESP_OK;
+}
+
+static void emit_event(host_zb_event_type_t type, uint16_t cluster_id, uint16_t attr_id, uint16_t len)
+{
+    if (!event_hook) {
+        return;
+    }
+    host_zb_event_t event = {
+        .type = type,
+        .time_us = host_time_now_us(),
+        .cluster_id = cluster_id,
+        .attr_id = attr_id,
+        .value_len = len,
+    };
+    event_hook(&event, event_hook_ctx);
+}
+
+static float link_uniform(void)
+{
+    // xorshift32
+    uint32_t x = link_rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    link_rng = x;
+    return (float)(x >> 8) / 16777216.0f;   // [0, 1)
+}
+
+/**
+ * @brief Router with the best LQI (what a beacon scan would pick)
+ */
+static size_t best_router(void)
+{
+    size_t best = 0;
+    for (size_t i = 1; i < router_count; i++) {
+        if (routers[i].lqi > routers[best].lqi) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+// Signal and status travel in the event argument (no allocation to leak on reboot)
+static void deliver_signal(void *arg)
+{
+    uint64_t packed = (uint64_t)(uintptr_t)arg;
+    uint32_t signal = (uint32_t)(packed >> 32);
+    esp_err_t status = (esp_err_t)(int32_t)(uint32_t)packed;
+    if (signal == ESP_ZB_BDB_SIGNAL_STEERING && status == ESP_OK) {
+        joined = true;
+        factory_new = false;
+        parent = best_router();
+        emit_event(HOST_ZB_EVENT_JOINED, 0, 0, 0);
+    } else if (signal == ESP_ZB_BDB_SIGNAL_DEVICE_REBOOT && status == ESP_OK) {
+        joined = true;   // Rejoin from NVRAM keeps the parent, a leave-with-rejoin scans
+        if (leave_rejoin_pending) {
+            parent = best_router();
+        }
+        emit_event(HOST_ZB_EVENT_JOINED, 0, 0, 0);
+    } else if (signal == ESP_ZB_ZDO_SIGNAL_LEAVE) {
+        joined = false;
+        if (leave_cb) {
+            leave_cb(ESP_ZB_ZDP_STATUS_SUCCESS, leave_cb_ctx);
+            leave_cb = NULL;
+        }
+    }
+    if (signal == ESP_ZB_BDB_SIGNAL_DEVICE_REBOOT) {
+        leave_rejoin_pending = false;
+    }
+    host_zb_emit_signal(signal, status);
+}
+
+// Delivery status travels in the event argument like signals
+static void deliver_send_status(void *arg)
+{
+    if (!send_status_handler) {
+        return;
+    }
+    esp_zb_zcl_command_send_status_message_t message = {
+        .dst_addr = { .addr_short = 0x0000 },
+        .dst_endpoint = 1,
+        .src_endpoint = 1,
+        .status = arg ? ESP_OK : ESP_FAIL,
+    };
+    send_status_handler(message);
+}
+
+/**
+ * @brief Incoming APS data frame seen by the APS indication handler
+ * @return true if the application consumed it
+ */
+static bool deliver_aps(uint16_t profile_id, uint8_t endpoint, uint16_t cluster_id)
+{
+    if (!aps_handler) {
+        return false;
+    }
+    esp_zb_apsde_data_ind_t ind = {
+        .dst_addr_mode = ESP_ZB_APS_ADDR_MODE_16_ENDP_PRESENT,
+        .dst_endpoint = endpoint,
+        .src_short_addr = 0x0000,
+        .src_endpoint = profile_id ? 1 : 0,
+        .profile_id = profile_id,
+        .cluster_id = cluster_id,
+        .lqi = routers[parent].lqi,
+    };
+    return aps_handler(ind);
+}
+
+/**
+ * @brief Incoming write: APS and raw handlers first, then store + action handler
+ */
+static esp_err_t deliver_write(uint8_t endpoint, uint16_t cluster_id, uint16_t attr_id,
+                               const void *value, size_t len)
+{
+    if (deliver_aps(ESP_ZB_AF_HA_PROFILE_ID, endpoint, cluster_id)) {
+        return ESP_OK;   // Consumed by the application
+    }
+    if (raw_handler && raw_handler(0)) {
+        return ESP_OK;   // Consumed by the application
+    }
+    host_zb_attr_t *attr = find_attr(endpoint, cluster_id, ESP_ZB_ZCL_CLUSTER_SERVER_ROLE, attr_id);
+    if (!attr || !value) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (is_string(attr->type) ? len < 1 : len != attr->capacity) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    for (size_t i = 0; i < cluster_handler_count; i++) {
+        const esp_zb_zcl_custom_cluster_handlers_t *h = &cluster_handlers[i];
+        if (h->cluster_id == cluster_id && h->cluster_role == ESP_ZB_ZCL_CLUSTER_SERVER_ROLE &&
+            h->check_value_cb && h->check_value_cb(attr_id, endpoint, (uint8_t *)value) != ESP_OK) {
+            return ESP_ERR_INVALID_ARG;  // Answered with INVALID_VALUE, nothing stored
+        }
+    }
+    attr_store(attr, value);
+    if (!action_handler) {
+        return ESP_OK;
+    }
+    esp_zb_zcl_set_attr_value_message_t message = {
+        .info = {
+            .status = ESP_ZB_ZCL_STATUS_SUCCESS,
+            .src_address = 0x0000,
+            .src_endpoint = 1,
+            .dst_endpoint = endpoint,
+            .cluster = cluster_id,
+            .profile = ESP_ZB_AF_HA_PROFILE_ID,
+        },
+        .attribute = {
+            .id = attr_id,
+            .data = {
+                .type = attr->type,
+                .size = attr_len(attr),
+                .value = attr->value,
+            },
+        },
+    };
+    return action_handler(ESP_ZB_CORE_SET_ATTR_VALUE_CB_ID, &message);
+}
+
+// Packets left in the turbo poll travel in the event argument
+static void deliver_poll(void *arg)
+{
+    uint8_t packets = (uint8_t)(uintptr_t)arg;
+    if (!started || !joined) {
+        return;
+    }
+    poll_total++;
+    emit_event(HOST_ZB_EVENT_POLL, 0, 0, 0);
+    if (indirect_count == 0) {
+        return;   // Ack without frame pending: nothing queued
+    }
+    host_zb_indirect_t frame = indirect[0];
+    indirect_count--;
+    memmove(&indirect[0], &indirect[1], indirect_count * sizeof(indirect[0]));
+    if (frame.profile_id == ESP_ZB_AF_HA_PROFILE_ID) {
+        deliver_write(frame.endpoint, frame.cluster_id, frame.attr_id, frame.value, frame.len);
+    } else {
+        deliver_aps(frame.profile_id, frame.endpoint, frame.cluster_id);
+    }
+    if (packets > 1 && indirect_count > 0) {
+        host_time_schedule(HOST_ZB_POLL_US, deliver_poll, (void *)(uintptr_t)(packets - 1));
+    }
+}
+
+static void schedule_signal(uint32_t signal, esp_err_t status, uint64_t delay_us)
+{
+    uint64_t packed = ((uint64_t)signal << 32) | (uint32_t)status;
+    host_time_schedule(delay_us, deliver_signal, (void *)(uintptr_t)packed);
+}
+
+/**
+ * @brief Outcome of INITIALIZATION: first start, or a scripted rejoin
+ */
+static void schedule_initialization(void)
+{
+    if (factory_new) {
+        schedule_signal(ESP_ZB_BDB_SIGNAL_DEVICE_FIRST_START, ESP_OK, HOST_ZB_SIGNAL_DELAY_US);
+    } else {
+        schedule_signal(ESP_ZB_BDB_SIGNAL_DEVICE_REBOOT, rejoin_status,
+                        HOST_ZB_SIGNAL_DELAY_US + (uint64_t)rejoin_latency_ms * 1000);
+    }
+}
+
+static void run_alarm(void *arg)
+{
+    host_zb_alarm_t *alarm = arg;
+    esp_zb_callback_t cb = alarm->cb;
+    uint8_t param = alarm->param;
+    alarm->used = false;
+    cb(param);
+}
+
+// ============================================================================
+// SIMULATION CONTROL
+// ============================================================================
+
+void host_zb_on_reboot(void)
+{
+    // The registered endpoint, its attribute lists and the alarms die with
+    // the stack; the firmware rebuilds them on the next start
+    while (attr_lists) {
+        esp_zb_attribute_list_t *next = attr_lists->next_alloc;
+        for (size_t i = 0; i < attr_lists->count; i++) {
+            free(attr_lists->attrs[i].value);
+        }
+        free(attr_lists->attrs);
+        free(attr_lists);
+        attr_lists = next;
+    }
+    while (cluster_lists) {
+        esp_zb_cluster_list_t *next = cluster_lists->next_alloc;
+        free(cluster_lists);
+        cluster_lists = next;
+    }
+    while (ep_lists) {
+        esp_zb_ep_list_t *next = ep_lists->next_alloc;
+        free(ep_lists);
+        ep_lists = next;
+    }
+    registered = NULL;
+    memset(alarms, 0, sizeof(alarms));
+    action_handler = NULL;
+    send_status_handler = NULL;
+    raw_handler = NULL;
+    aps_handler = NULL;
+    cluster_handler_count = 0;
+    leave_cb = NULL;
+    leave_rejoin_pending = false;
+    lock_depth = 0;
+    if (started) {
+        radio_on_us += host_time_now_us() - started_at_us;
+        emit_event(HOST_ZB_EVENT_STACK_STOP, 0, 0, 0);
+    }
+    started = false;
+    joined = false;
+}
+
+void host_zb_reset(void)
+{
+    started = false;
+    event_hook = NULL;
+    event_hook_ctx = NULL;
+    host_zb_on_reboot();
+    radio_on_us = 0;
+    factory_new = true;
+    steering_status = ESP_OK;
+    steering_latency_ms = 2000;
+    rejoin_status = ESP_OK;
+    rejoin_latency_ms = 0;
+    report_status = ESP_OK;
+    report_total = 0;
+    indirect_count = 0;
+    poll_total = 0;
+    memset(routers, 0, sizeof(routers));
+    routers[0] = (host_zb_router_t){ .short_addr = 0x0000, .lqi = 220, .rssi = -55, .loss = 0.0f };
+    router_count = 1;
+    parent = 0;
+    link_rng = 0x2545F491u;
+}
+
+int host_zb_get_attr(uint8_t endpoint, uint16_t cluster_id, uint16_t attr_id,
+                     void *out, size_t max_len)
+{
+    const host_zb_attr_t *attr = find_attr(endpoint, cluster_id, 0, attr_id);
+    if (!attr) {
+        return -1;
+    }
+    size_t len = attr_len(attr);
+    if (len > max_len) {
+        len = max_len;
+    }
+    memcpy(out, attr->value, len);
+    return (int)len;
+}
+
+uint32_t host_zb_report_count(void)
+{
+    return report_total;
+}
+
+const host_zb_report_t *host_zb_report_get(uint32_t index)
+{
+    if (index >= report_total || report_total - index > HOST_ZB_MAX_REPORTS) {
+        return NULL;
+    }
+    return &reports[index % HOST_ZB_MAX_REPORTS];
+}
+
+void host_zb_set_network(bool is_factory_new, esp_err_t status, uint32_t latency_ms)
+{
+    factory_new = is_factory_new;
+    steering_status = status;
+    steering_latency_ms = latency_ms;
+}
+
+void host_zb_set_rejoin(esp_err_t status, uint32_t latency_ms)
+{
+    rejoin_status = status;
+    rejoin_latency_ms = latency_ms;
+}
+
+void host_zb_set_report_status(esp_err_t status)
+{
+    report_status = status;
+}
+
+void host_zb_set_routers(const host_zb_router_t *table, size_t count)
+{
+    if (count == 0 || count > HOST_ZB_MAX_ROUTERS) {
+        fprintf(stderr, "host_zigbee: router count %zu out of range\n", count);
+        abort();
+    }
+    memcpy(routers, table, count * sizeof(*table));
+    router_count = count;
+    if (parent >= router_count) {
+        parent = best_router();
+    }
+}
+
+void host_zb_set_router_link(size_t index, uint8_t lqi, int8_t rssi, float loss)
+{
+    if (index < router_count) {
+        routers[index].lqi = lqi;
+        routers[index].rssi = rssi;
+        routers[index].loss = loss;
+    }
+}
+
+size_t host_zb_parent_index(void)
+{
+    return parent;
+}
+
+void host_zb_set_event_hook(host_zb_event_hook_t hook, void *ctx)
+{
+    event_hook = hook;
+    event_hook_ctx = ctx;
+}
+
+uint64_t host_zb_radio_on_us(void)
+{
+    return radio_on_us + (started ? host_time_now_us() - started_at_us : 0);
+}
+
+void host_zb_emit_signal(uint32_t signal, esp_err_t status)
+{
+    uint32_t sig = signal;
+    esp_zb_app_signal_t signal_struct = {
+        .p_app_signal = &sig,
+        .esp_err_status = status,
+    };
+    esp_zb_app_signal_handler(&signal_struct);
+}
+
+esp_err_t host_zb_write_attr(uint8_t endpoint, uint16_t cluster_id, uint16_t attr_id,
+                             const void *value, size_t len)
+{
+    return deliver_write(endpoint, cluster_id, attr_id, value, len);
+}
+
+esp_err_t host_zb_queue_write(uint8_t endpoint, uint16_t cluster_id, uint16_t attr_id,
+                              const void *value, size_t len)
+{
+    if (!value || len > sizeof(indirect[0].value)) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if (indirect_count >= HOST_ZB_MAX_INDIRECT) {
+        return ESP_ERR_NO_MEM;
+    }
+    host_zb_indirect_t *frame = &indirect[indirect_count++];
+    frame->profile_id = ESP_ZB_AF_HA_PROFILE_ID;
+    frame->endpoint = endpoint;
+    frame->cluster_id = cluster_id;
+    frame->attr_id = attr_id;
+    memcpy(frame->value, value, len);
+    frame->len = (uint8_t)len;
+    return ESP_OK;
+}
+
+esp_err_t host_zb_queue_frame(uint16_t profile_id, uint16_t cluster_id)
+{
+    if (profile_id == ESP_ZB_AF_HA_PROFILE_ID) {
+        return ESP_ERR_INVALID_ARG;   // Attribute writes go through host_zb_queue_write()
+    }
+    if (indirect_count >= HOST_ZB_MAX_INDIRECT) {
+        return ESP_ERR_NO_MEM;
+    }
+    indirect[indirect_count++] = (host_zb_indirect_t){ .profile_id = profile_id, .cluster_id = cluster_id };
+    return ESP_OK;
+}
+
+size_t host_zb_indirect_pending(void)
+{
+    return indirect_count;
+}
+
+uint32_t host_zb_poll_count(void)
+{
+    return poll_total;
+}
+
+// ============================================================================
+// STACK API
+// ============================================================================
+
+void esp_zb_init(esp_zb_cfg_t *nwk_cfg)
+{
+    (void)nwk_cfg;
+}
+
+esp_err_t esp_zb_start(bool autostart)
+{
+    if (!registered || started) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    started = true;
+    started_at_us = host_time_now_us();
+    emit_event(HOST_ZB_EVENT_STACK_START, 0, 0, 0);
+    if (autostart) {
+        schedule_initialization();
+    } else {
+        schedule_signal(ESP_ZB_ZDO_SIGNAL_SKIP_STARTUP, ESP_OK, HOST_ZB_SIGNAL_DELAY_US);
+    }
+    return ESP_OK;
+}
+
+void esp_zb_stack_main_loop(void)
+{
+    // Stack work runs as virtual-time events; nothing to iterate here
+}
+
+void esp_zb_main_loop_iteration(void)
+{
+}
+
+bool esp_zb_lock_acquire(TickType_t block_ticks)
+{
+    (void)block_ticks;
+    lock_depth++;
+    return true;
+}
+
+void esp_zb_lock_release(void)
+{
+    if (lock_depth > 0) {
+        lock_depth--;
+    }
+}
+
+void esp_zb_scheduler_alarm(esp_zb_callback_t cb, uint8_t param, uint32_t time)
+{
+    for (int i = 0; i < HOST_ZB_MAX_ALARMS; i++) {
+        if (!alarms[i].used) {
+            alarms[i].used = true;
+            alarms[i].cb = cb;
+            alarms[i].param = param;
+            alarms[i].event_id = host_time_schedule((uint64_t)time * 1000, run_alarm, &alarms[i]);
+            return;
+        }
+    }
+    fprintf(stderr, "host_zigbee: scheduler alarm pool full (%d)\n", HOST_ZB_MAX_ALARMS);
+    abort();
+}
+
+void esp_zb_scheduler_alarm_cancel(esp_zb_callback_t cb, uint8_t param)
+{
+    for (int i = 0; i < HOST_ZB_MAX_ALARMS; i++) {
+        if (alarms[i].used && alarms[i].cb == cb && alarms[i].param == param) {
+            host_time_cancel(alarms[i].event_id);
+            alarms[i].used = false;
+        }
+    }
+}
+
+void esp_zb_sleep_enable(bool enable)
+{
+    (void)enable;
+}
+
+void esp_zb_sleep_now(void)
+{
+}
+
+void esp_zb_set_tx_power(int8_t power)
+{
+    (void)power;
+}
+
+void esp_zb_nvram_erase_at_start(bool erase)
+{
+    if (erase) {
+        factory_new = true;
+    }
+}
+
+esp_err_t esp_zb_set_primary_network_channel_set(uint32_t channel_mask)
+{
+    (void)channel_mask;
+    return ESP_OK;
+}
+
+esp_err_t esp_zb_device_register(esp_zb_ep_list_t *ep_list)
+{
+    if (!ep_list) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    registered = ep_list;
+    return ESP_OK;
+}
+
+void esp_zb_core_action_handler_register(esp_zb_core_action_handler_t cb)
+{
+    action_handler = cb;
+}
+
+const char *esp_zb_zdo_signal_to_string(esp_zb_app_signal_type_t signal)
+{
+    switch (signal) {
+    case ESP_ZB_ZDO_SIGNAL_DEFAULT_START:       return "ZDO_SIGNAL_DEFAULT_START";
+    case ESP_ZB_ZDO_SIGNAL_SKIP_STARTUP:        return "ZDO_SIGNAL_SKIP_STARTUP";
+    case ESP_ZB_ZDO_SIGNAL_DEVICE_ANNCE:        return "ZDO_SIGNAL_DEVICE_ANNCE";
+    case ESP_ZB_ZDO_SIGNAL_LEAVE:               return "ZDO_SIGNAL_LEAVE";
+    case ESP_ZB_ZDO_SIGNAL_ERROR:               return "ZDO_SIGNAL_ERROR";
+    case ESP_ZB_BDB_SIGNAL_DEVICE_FIRST_START:  return "BDB_SIGNAL_DEVICE_FIRST_START";
+    case ESP_ZB_BDB_SIGNAL_DEVICE_REBOOT:       return "BDB_SIGNAL_DEVICE_REBOOT";
+    case ESP_ZB_BDB_SIGNAL_STEERING:            return "BDB_SIGNAL_STEERING";
+    case ESP_ZB_BDB_SIGNAL_FORMATION:           return "BDB_SIGNAL_FORMATION";
+    case ESP_ZB_COMMON_SIGNAL_CAN_SLEEP:        return "COMMON_SIGNAL_CAN_SLEEP";
+    default:                                    return "UNKNOWN_SIGNAL";
+    }
+}
+
+esp_err_t esp_zb_bdb_start_top_level_commissioning(uint8_t mode_mask)
+{
+    if (!started) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (mode_mask == ESP_ZB_BDB_MODE_INITIALIZATION) {
+        schedule_initialization();
+    } else if (mode_mask & ESP_ZB_BDB_MODE_NETWORK_STEERING) {
+        schedule_signal(ESP_ZB_BDB_SIGNAL_STEERING, steering_status, (uint64_t)steering_latency_ms * 1000);
+    }
+    return ESP_OK;
+}
+
+bool esp_zb_bdb_is_factory_new(void)
+{
+    return factory_new;
+}
+
+uint16_t esp_zb_get_pan_id(void)
+{
+    return joined ? 0x1A62 : 0xFFFF;
+}
+
+uint8_t esp_zb_get_current_channel(void)
+{
+    return joined ? 15 : 0;
+}
+
+uint16_t esp_zb_get_short_address(void)
+{
+    return joined ? 0x4B2D : 0xFFFE;
+}
+
+void esp_zb_get_extended_pan_id(esp_zb_ieee_addr_t ext_pan_id)
+{
+    static const esp_zb_ieee_addr_t ext = { 0xDD, 0xDD, 0xDD, 0xDD, 0xDD, 0xDD, 0xDD, 0xDD };
+    memcpy(ext_pan_id, joined ? ext : (const esp_zb_ieee_addr_t){ 0 }, sizeof(esp_zb_ieee_addr_t));
+}
+
+void esp_zb_get_long_address(esp_zb_ieee_addr_t addr)
+{
+    static const esp_zb_ieee_addr_t ieee = { 0x6C, 0x1A, 0x2B, 0xFE, 0xFF, 0x8E, 0x4A, 0x40 };
+    memcpy(addr, ieee, sizeof(esp_zb_ieee_addr_t));
+}
+
+void *esp_zb_app_signal_get_params(uint32_t *signal_p)
+{
+    return (signal_p && *signal_p == ESP_ZB_ZDO_SIGNAL_LEAVE) ? &leave_params : NULL;
+}
+
+esp_err_t esp_zb_nwk_get_next_neighbor(esp_zb_nwk_info_iterator_t *iterator, esp_zb_nwk_neighbor_info_t *nbr_info)
+{
+    if (!iterator || !nbr_info) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!started || *iterator >= router_count) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    const host_zb_router_t *r = &routers[*iterator];
+    memset(nbr_info, 0, sizeof(*nbr_info));
+    nbr_info->short_addr = r->short_addr;
+    nbr_info->device_type = r->short_addr == 0x0000 ? ESP_ZB_DEVICE_TYPE_COORDINATOR : ESP_ZB_DEVICE_TYPE_ROUTER;
+    nbr_info->rx_on_when_idle = 1;
+    nbr_info->relationship = (joined && *iterator == parent) ? ESP_ZB_NWK_RELATIONSHIP_PARENT
+                                                             : ESP_ZB_NWK_RELATIONSHIP_NONE_OF_THE_ABOVE;
+    nbr_info->lqi = r->lqi;
+    nbr_info->rssi = r->rssi;
+    (*iterator)++;
+    return ESP_OK;
+}
+
+void esp_zb_zdo_device_leave_req(esp_zb_zdo_mgmt_leave_req_param_t *cmd_req, esp_zb_zdo_mgmt_leave_callback_t user_cb,
+                                 void *user_ctx)
+{
+    if (!started || !cmd_req) {
+        if (user_cb) {
+            user_cb(ESP_ZB_ZDP_STATUS_TIMEOUT, user_ctx);
+        }
+        return;
+    }
+    leave_cb = user_cb;
+    leave_cb_ctx = user_ctx;
+    leave_params.leave_type = cmd_req->rejoin ? ESP_ZB_NWK_LEAVE_TYPE_REJOIN : ESP_ZB_NWK_LEAVE_TYPE_RESET;
+    schedule_signal(ESP_ZB_ZDO_SIGNAL_LEAVE, ESP_OK, HOST_ZB_SIGNAL_DELAY_US);
+    if (cmd_req->rejoin) {
+        leave_rejoin_pending = true;
+        schedule_signal(ESP_ZB_BDB_SIGNAL_DEVICE_REBOOT, rejoin_status,
+                        HOST_ZB_SIGNAL_DELAY_US + HOST_ZB_BEACON_SCAN_US + (uint64_t)rejoin_latency_ms * 1000);
+    } else {
+        factory_new = true;
+    }
+}
+
+// ============================================================================
+// ATTRIBUTES / REPORTING
+// ============================================================================
+
+esp_zb_zcl_status_t esp_zb_zcl_set_attribute_val(uint8_t endpoint, uint16_t cluster_id, uint8_t cluster_role,
+                                                 uint16_t attr_id, void *value_p, bool check)
+{
+    (void)check;
+    host_zb_attr_t *attr = find_attr(endpoint, cluster_id, cluster_role, attr_id);
+    if (!attr) {
+        return ESP_ZB_ZCL_STATUS_UNSUP_ATTRIB;
+    }
+    if (!value_p) {
+        return ESP_ZB_ZCL_STATUS_INVALID_VALUE;
+    }
+    attr_store(attr, value_p);
+    return ESP_ZB_ZCL_STATUS_SUCCESS;
+}
+
+esp_err_t esp_zb_zcl_report_attr_cmd_req(esp_zb_zcl_report_attr_cmd_t *cmd_req)
+{
+    if (!cmd_req) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    uint8_t role = cmd_req->direction == ESP_ZB_ZCL_CMD_DIRECTION_TO_CLI ?
+                   ESP_ZB_ZCL_CLUSTER_SERVER_ROLE : ESP_ZB_ZCL_CLUSTER_CLIENT_ROLE;
+    const host_zb_attr_t *attr = find_attr(cmd_req->zcl_basic_cmd.src_endpoint, cmd_req->clusterID,
+                                           role, cmd_req->attributeID);
+    if (!attr) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (report_status != ESP_OK) {
+        return report_status;   // Not queued: no report, no send status
+    }
+    host_zb_report_t *r = &reports[report_total % HOST_ZB_MAX_REPORTS];
+    r->time_us = host_time_now_us();
+    r->cluster_id = cmd_req->clusterID;
+    r->attr_id = cmd_req->attributeID;
+    uint16_t len = attr_len(attr);
+    r->value_len = (uint8_t)(len < sizeof(r->value) ? len : sizeof(r->value));
+    memcpy(r->value, attr->value, r->value_len);
+    float loss = joined ? routers[parent].loss : 1.0f;
+    r->delivered = loss <= 0.0f || (loss < 1.0f && link_uniform() >= loss);
+    report_total++;
+    emit_event(HOST_ZB_EVENT_REPORT, cmd_req->clusterID, cmd_req->attributeID, len);
+    host_time_schedule(HOST_ZB_SEND_STATUS_US, deliver_send_status, (void *)(uintptr_t)r->delivered);
+    return ESP_OK;
+}
+
+void esp_zb_zcl_command_send_status_handler_register(esp_zb_zcl_command_send_status_callback_t cb)
+{
+    send_status_handler = cb;
+}
+
+void esp_zb_raw_command_handler_register(esp_zb_zcl_raw_command_callback_t cb)
+{
+    raw_handler = cb;
+}
+
+void esp_zb_aps_data_indication_handler_register(esp_zb_aps_data_indication_callback_t cb)
+{
+    aps_handler = cb;
+}
+
+esp_err_t esp_zb_zcl_custom_cluster_handlers_update(esp_zb_zcl_custom_cluster_handlers_t obj)
+{
+    for (size_t i = 0; i < cluster_handler_count; i++) {
+        if (cluster_handlers[i].cluster_id == obj.cluster_id &&
+            cluster_handlers[i].cluster_role == obj.cluster_role) {
+            cluster_handlers[i] = obj;
+            return ESP_OK;
+        }
+    }
+    if (cluster_handler_count >= HOST_ZB_MAX_CLUSTER_HANDLERS) {
+        return ESP_ERR_NO_MEM;
+    }
+    cluster_handlers[cluster_handler_count++] = obj;
+    return ESP_OK;
+}
+
+// ============================================================================
+// POLL CONTROL (ZBOSS)
+// ============================================================================
+
+void zb_zdo_pim_start_turbo_poll_packets(zb_uint8_t n_packets)
+{
+    if (!started || !joined || n_packets == 0) {
+        return;
+    }
+    host_time_schedule(HOST_ZB_POLL_US, deliver_poll, (void *)(uintptr_t)n_packets);
+}
+
+// ============================================================================
+// CLUSTERS
+// ============================================================================
+
+esp_zb_attribute_list_t *esp_zb_zcl_attr_list_create(uint16_t cluster_id)
+{
+    return list_create(cluster_id);
+}
+
+esp_zb_attribute_list_t *esp_zb_basic_cluster_create(esp_zb_basic_cluster_cfg_t *basic_cfg)
+{
+    esp_zb_attribute_list_t *list = list_create(ESP_ZB_ZCL_CLUSTER_ID_BASIC);
+    if (list && basic_cfg) {
+        list_add(list, ESP_ZB_ZCL_ATTR_BASIC_ZCL_VERSION_ID, ESP_ZB_ZCL_ATTR_TYPE_U8,
+                 ESP_ZB_ZCL_ATTR_ACCESS_READ_ONLY, &basic_cfg->zcl_version);
+        list_add(list, ESP_ZB_ZCL_ATTR_BASIC_POWER_SOURCE_ID, ESP_ZB_ZCL_ATTR_TYPE_8BIT_ENUM,
+                 ESP_ZB_ZCL_ATTR_ACCESS_READ_ONLY, &basic_cfg->power_source);
+    }
+    return list;
+}
+
+esp_zb_attribute_list_t *esp_zb_identify_cluster_create(esp_zb_identify_cluster_cfg_t *identify_cfg)
+{
+    esp_zb_attribute_list_t *list = list_create(ESP_ZB_ZCL_CLUSTER_ID_IDENTIFY);
+    if (list && identify_cfg) {
+        list_add(list, ESP_ZB_ZCL_ATTR_IDENTIFY_IDENTIFY_TIME_ID, ESP_ZB_ZCL_ATTR_TYPE_U16,
+                 ESP_ZB_ZCL_ATTR_ACCESS_READ_WRITE, &identify_cfg->identify_time);
+    }
+    return list;
+}
+
+esp_zb_attribute_list_t *esp_zb_power_config_cluster_create(esp_zb_power_config_cluster_cfg_t *power_cfg)
+{
+    esp_zb_attribute_list_t *list = list_create(ESP_ZB_ZCL_CLUSTER_ID_POWER_CONFIG);
+    if (list && power_cfg) {
+        list_add(list, ESP_ZB_ZCL_ATTR_POWER_CONFIG_MAINS_VOLTAGE_ID, ESP_ZB_ZCL_ATTR_TYPE_U16,
+                 ESP_ZB_ZCL_ATTR_ACCESS_READ_ONLY, &power_cfg->main_voltage);
+    }
+    return list;
+}
+
+esp_zb_attribute_list_t *esp_zb_on_off_cluster_create(esp_zb_on_off_cluster_cfg_t *on_off_cfg)
+{
+    esp_zb_attribute_list_t *list = list_create(ESP_ZB_ZCL_CLUSTER_ID_ON_OFF);
+    if (list && on_off_cfg) {
+        list_add(list, ESP_ZB_ZCL_ATTR_ON_OFF_ON_OFF_ID, ESP_ZB_ZCL_ATTR_TYPE_BOOL,
+                 ESP_ZB_ZCL_ATTR_ACCESS_READ_WRITE | ESP_ZB_ZCL_ATTR_ACCESS_REPORTING, &on_off_cfg->on_off);
+    }
+    return list;
+}
+
+esp_zb_attribute_list_t *esp_zb_temperature_meas_cluster_create(esp_zb_temperature_meas_cluster_cfg_t *temp_cfg)
+{
+    esp_zb_attribute_list_t *list = list_create(ESP_ZB_ZCL_CLUSTER_ID_TEMP_MEASUREMENT);
+    if (list && temp_cfg) {
+        list_add(list, ESP_ZB_ZCL_ATTR_TEMP_MEASUREMENT_VALUE_ID, ESP_ZB_ZCL_ATTR_TYPE_S16,
+                 ESP_ZB_ZCL_ATTR_ACCESS_READ_ONLY | ESP_ZB_ZCL_ATTR_ACCESS_REPORTING, &temp_cfg->measured_value);
+        list_add(list, ESP_ZB_ZCL_ATTR_TEMP_MEASUREMENT_MIN_VALUE_ID, ESP_ZB_ZCL_ATTR_TYPE_S16,
+                 ESP_ZB_ZCL_ATTR_ACCESS_READ_ONLY, &temp_cfg->min_value);
+        list_add(list, ESP_ZB_ZCL_ATTR_TEMP_MEASUREMENT_MAX_VALUE_ID, ESP_ZB_ZCL_ATTR_TYPE_S16,
+                 ESP_ZB_ZCL_ATTR_ACCESS_READ_ONLY, &temp_cfg->max_value);
+    }
+    return list;
+}
+
+esp_zb_attribute_list_t *esp_zb_humidity_meas_cluster_create(esp_zb_humidity_meas_cluster_cfg_t *hum_cfg)
+{
+    esp_zb_attribute_list_t *list = list_create(ESP_ZB_ZCL_CLUSTER_ID_REL_HUMIDITY_MEASUREMENT);
+    if (list && hum_cfg) {
+        list_add(list, ESP_ZB_ZCL_ATTR_REL_HUMIDITY_MEASUREMENT_VALUE_ID, ESP_ZB_ZCL_ATTR_TYPE_U16,
+                 ESP_ZB_ZCL_ATTR_ACCESS_READ_ONLY | ESP_ZB_ZCL_ATTR_ACCESS_REPORTING, &hum_cfg->measured_value);
+        list_add(list, ESP_ZB_ZCL_ATTR_REL_HUMIDITY_MEASUREMENT_MIN_VALUE_ID, ESP_ZB_ZCL_ATTR_TYPE_U16,
+                 ESP_ZB_ZCL_ATTR_ACCESS_READ_ONLY, &hum_cfg->min_value);
+        list_add(list, ESP_ZB_ZCL_ATTR_REL_HUMIDITY_MEASUREMENT_MAX_VALUE_ID, ESP_ZB_ZCL_ATTR_TYPE_U16,
+                 ESP_ZB_ZCL_ATTR_ACCESS_READ_ONLY, &hum_cfg->max_value);
+    }
+    return list;
+}
+
+esp_zb_attribute_list_t *esp_zb_ota_cluster_create(esp_zb_ota_cluster_cfg_t *ota_cfg)
+{
+    esp_zb_attribute_list_t *list = list_create(ESP_ZB_ZCL_CLUSTER_ID_OTA_UPGRADE);
+    if (list && ota_cfg) {
+        list_add(list, ESP_ZB_ZCL_ATTR_OTA_UPGRADE_FILE_VERSION_ID, ESP_ZB_ZCL_ATTR_TYPE_U32,
+                 ESP_ZB_ZCL_ATTR_ACCESS_READ_ONLY, &ota_cfg->ota_upgrade_file_version);
+        list_add(list, ESP_ZB_ZCL_ATTR_OTA_UPGRADE_DOWNLOADED_FILE_VERSION_ID, ESP_ZB_ZCL_ATTR_TYPE_U32,
+                 ESP_ZB_ZCL_ATTR_ACCESS_READ_ONLY, &ota_cfg->ota_upgrade_downloaded_file_ver);
+        list_add(list, ESP_ZB_ZCL_ATTR_OTA_UPGRADE_MANUFACTURE_ID, ESP_ZB_ZCL_ATTR_TYPE_U16,
+                 ESP_ZB_ZCL_ATTR_ACCESS_READ_ONLY, &ota_cfg->ota_upgrade_manufacturer);
+        list_add(list, ESP_ZB_ZCL_ATTR_OTA_UPGRADE_IMAGE_TYPE_ID, ESP_ZB_ZCL_ATTR_TYPE_U16,
+                 ESP_ZB_ZCL_ATTR_ACCESS_READ_ONLY, &ota_cfg->ota_upgrade_image_type);
+    }
+    return list;
+}
+
+esp_err_t esp_zb_basic_cluster_add_attr(esp_zb_attribute_list_t *attr_list, uint16_t attr_id, void *value_p)
+{
+    uint8_t type = ESP_ZB_ZCL_ATTR_TYPE_CHAR_STRING;
+    if (attr_id == ESP_ZB_ZCL_ATTR_BASIC_DEVICE_ENABLED_ID) {
+        type = ESP_ZB_ZCL_ATTR_TYPE_BOOL;
+    } else if (attr_id == ESP_ZB_ZCL_ATTR_BASIC_POWER_SOURCE_ID) {
+        type = ESP_ZB_ZCL_ATTR_TYPE_8BIT_ENUM;
+    }
+    return list_add(attr_list, attr_id, type, ESP_ZB_ZCL_ATTR_ACCESS_READ_ONLY, value_p);
+}
+
+esp_err_t esp_zb_power_config_cluster_add_attr(esp_zb_attribute_list_t *attr_list, uint16_t attr_id, void *value_p)
+{
+    return list_add(attr_list, attr_id, ESP_ZB_ZCL_ATTR_TYPE_U8,
+                    ESP_ZB_ZCL_ATTR_ACCESS_READ_ONLY | ESP_ZB_ZCL_ATTR_ACCESS_REPORTING, value_p);
+}
+
+esp_err_t esp_zb_cluster_add_attr(esp_zb_attribute_list_t *attr_list, uint16_t cluster_id, uint16_t attr_id,
+                                  uint8_t attr_type, uint8_t attr_access, void *value_p)
+{
+    if (!attr_list || attr_list->cluster_id != cluster_id) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return list_add(attr_list, attr_id, attr_type, attr_access, value_p);
+}
+
+esp_err_t esp_zb_custom_cluster_add_custom_attr(esp_zb_attribute_list_t *attr_list, uint16_t attr_id,
+                                                uint8_t attr_type, uint8_t attr_access, void *value_p)
+{
+    return list_add(attr_list, attr_id, attr_type, attr_access, value_p);
+}
+
+// ============================================================================
+// CLUSTER / ENDPOINT LISTS
+// ============================================================================
+
+esp_zb_cluster_list_t *esp_zb_zcl_cluster_list_create(void)
+{
+    esp_zb_cluster_list_t *l = calloc(1, sizeof(*l));
+    if (l) {
+        l->next_alloc = cluster_lists;
+        cluster_lists = l;
+    }
+    return l;
+}
+
+#define HOST_ZB_CLUSTER_LIST_ADD(name)                                                      \
+    esp_err_t esp_zb_cluster_list_add_##name##_cluster(esp_zb_cluster_list_t *l,            \
+                                                       esp_zb_attribute_list_t *a, uint8_t role) \
+    {                                                                                       \
+        return cluster_list_add(l, a, role);                                                \
+    }
+
+HOST_ZB_CLUSTER_LIST_ADD(basic)
+HOST_ZB_CLUSTER_LIST_ADD(identify)
+HOST_ZB_CLUSTER_LIST_ADD(power_config)
+HOST_ZB_CLUSTER_LIST_ADD(on_off)
+HOST_ZB_CLUSTER_LIST_ADD(time)
+HOST_ZB_CLUSTER_LIST_ADD(temperature_meas)
+HOST_ZB_CLUSTER_LIST_ADD(humidity_meas)
+HOST_ZB_CLUSTER_LIST_ADD(ota)
+HOST_ZB_CLUSTER_LIST_ADD(custom)
+
+esp_zb_ep_list_t *esp_zb_ep_list_create(void)
+{
+    esp_zb_ep_list_t *l = calloc(1, sizeof(*l));
+    if (l) {
+        l->next_alloc = ep_lists;
+        ep_lists = l;
+    }
+    return l;
+}
+
+esp_err_t esp_zb_ep_list_add_ep(esp_zb_ep_list_t *ep_list, esp_zb_cluster_list_t *cluster_list,
+                                esp_zb_endpoint_config_t endpoint_config)
+{
+    if (!ep_list || !cluster_list) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (ep_list->count >= sizeof(ep_list->config) / sizeof(ep_list->config[0])) {
+        return ESP_ERR_NO_MEM;
+    }
+    ep_list->config[ep_list->count] = endpoint_config;
+    ep_list->clusters[ep_list->count] = cluster_list;
+    ep_list->count++;
+    return ESP_OK;
+}
@@ -0,0 +1,15 @@
+/*
+ * Host shim: esp_adc/adc_cali.h
+ */
+
+#ifndef HOST_ESP_ADC_CALI_H
+#define HOST_ESP_ADC_CALI_H
+
+#include "esp_err.h"
+#include "esp_adc/adc_oneshot.h"
+
+typedef struct host_adc_cali *adc_cali_handle_t;
+
+esp_err_t adc_cali_raw_to_voltage(adc_cali_handle_t handle, int raw, int *voltage);
+
+#endif // HOST_ESP_ADC_CALI_H
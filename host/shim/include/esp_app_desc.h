@@ -0,0 +1,12 @@
+/*
+ * Host shim: esp_app_desc.h
+ */
+
+#ifndef HOST_ESP_APP_DESC_H
+#define HOST_ESP_APP_DESC_H
+
+#include <stddef.h>
+
+int esp_app_get_elf_sha256(char *dst, size_t size);
+
+#endif // HOST_ESP_APP_DESC_H
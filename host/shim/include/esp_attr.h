@@ -0,0 +1,17 @@
+/*
+ * Host shim: esp_attr.h
+ *
+ * RTC variables go to their own sections so a simulator can snapshot
+ * and restore them across a simulated reset (__start_/__stop_ symbols).
+ */
+
+#ifndef HOST_ESP_ATTR_H
+#define HOST_ESP_ATTR_H
+
+#define RTC_DATA_ATTR       __attribute__((section("rtc_data"), used))
+#define RTC_NOINIT_ATTR     __attribute__((section("rtc_noinit"), used))
+#define RTC_SLOW_ATTR       RTC_DATA_ATTR
+#define IRAM_ATTR
+#define DRAM_ATTR
+
+#endif // HOST_ESP_ATTR_H
@@ -0,0 +1,30 @@
+/*
+ * Host shim: esp_ieee802154.h (raw 802.15.4 transmit, see host_sim.h)
+ */
+
+#ifndef HOST_ESP_IEEE802154_H
+#define HOST_ESP_IEEE802154_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+typedef enum {
+    ESP_IEEE802154_RADIO_DISABLE = 0,
+    ESP_IEEE802154_RADIO_IDLE,
+    ESP_IEEE802154_RADIO_SLEEP,
+    ESP_IEEE802154_RADIO_RECEIVE,
+    ESP_IEEE802154_RADIO_TX_CCA,
+    ESP_IEEE802154_RADIO_TRANSMIT,
+} esp_ieee802154_state_t;
+
+esp_err_t esp_ieee802154_enable(void);
+esp_err_t esp_ieee802154_disable(void);
+esp_err_t esp_ieee802154_set_channel(uint8_t channel);
+esp_err_t esp_ieee802154_set_rx_when_idle(bool enable);
+
+// frame[0] is the PHY payload length (FCS included), the MAC frame follows
+esp_err_t esp_ieee802154_transmit(const uint8_t *frame, bool cca);
+esp_ieee802154_state_t esp_ieee802154_get_state(void);
+
+#endif // HOST_ESP_IEEE802154_H
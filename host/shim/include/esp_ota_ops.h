@@ -0,0 +1,21 @@
+/*
+ * Host shim: esp_ota_ops.h (app slots are RAM-backed partitions)
+ */
+
+#ifndef HOST_ESP_OTA_OPS_H
+#define HOST_ESP_OTA_OPS_H
+
+#include "esp_err.h"
+#include "esp_partition.h"
+
+#define ESP_ERR_OTA_BASE                0x1500
+#define ESP_ERR_OTA_PARTITION_CONFLICT  (ESP_ERR_OTA_BASE + 0x01)
+#define ESP_ERR_OTA_SELECT_INFO_INVALID (ESP_ERR_OTA_BASE + 0x02)
+#define ESP_ERR_OTA_VALIDATE_FAILED     (ESP_ERR_OTA_BASE + 0x03)
+
+const esp_partition_t *esp_ota_get_running_partition(void);
+const esp_partition_t *esp_ota_get_boot_partition(void);
+const esp_partition_t *esp_ota_get_next_update_partition(const esp_partition_t *start_from);
+esp_err_t esp_ota_set_boot_partition(const esp_partition_t *partition);
+
+#endif // HOST_ESP_OTA_OPS_H
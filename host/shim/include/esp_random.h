@@ -0,0 +1,14 @@
+/*
+ * Host shim: esp_random.h (seeded PRNG, reset by host_sim_reset)
+ */
+
+#ifndef HOST_ESP_RANDOM_H
+#define HOST_ESP_RANDOM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+uint32_t esp_random(void);
+void esp_fill_random(void *buf, size_t len);
+
+#endif // HOST_ESP_RANDOM_H
@@ -0,0 +1,12 @@
+/*
+ * Host shim: esp_rom_sys.h (busy wait advances virtual time)
+ */
+
+#ifndef HOST_ESP_ROM_SYS_H
+#define HOST_ESP_ROM_SYS_H
+
+#include <stdint.h>
+
+void esp_rom_delay_us(uint32_t us);
+
+#endif // HOST_ESP_ROM_SYS_H
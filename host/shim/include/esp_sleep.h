@@ -0,0 +1,26 @@
+/*
+ * Host shim: esp_sleep.h
+ */
+
+#ifndef HOST_ESP_SLEEP_H
+#define HOST_ESP_SLEEP_H
+
+#include <stdint.h>
+#include "esp_err.h"
+
+typedef enum {
+    ESP_SLEEP_WAKEUP_UNDEFINED,
+    ESP_SLEEP_WAKEUP_ALL,
+    ESP_SLEEP_WAKEUP_EXT0,
+    ESP_SLEEP_WAKEUP_EXT1,
+    ESP_SLEEP_WAKEUP_TIMER,
+    ESP_SLEEP_WAKEUP_TOUCHPAD,
+    ESP_SLEEP_WAKEUP_ULP,
+    ESP_SLEEP_WAKEUP_GPIO,
+} esp_sleep_wakeup_cause_t;
+
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause(void);
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t time_in_us);
+void esp_deep_sleep_start(void) __attribute__((noreturn));
+
+#endif // HOST_ESP_SLEEP_H
@@ -0,0 +1,14 @@
+/*
+ * Host shim: esp_system.h
+ */
+
+#ifndef HOST_ESP_SYSTEM_H
+#define HOST_ESP_SYSTEM_H
+
+#include <stdint.h>
+#include "esp_err.h"
+
+void esp_restart(void) __attribute__((noreturn));
+uint32_t esp_get_free_heap_size(void);
+
+#endif // HOST_ESP_SYSTEM_H
@@ -0,0 +1,12 @@
+/*
+ * Host shim: esp_timer.h (virtual time since boot)
+ */
+
+#ifndef HOST_ESP_TIMER_H
+#define HOST_ESP_TIMER_H
+
+#include <stdint.h>
+
+int64_t esp_timer_get_time(void);
+
+#endif // HOST_ESP_TIMER_H
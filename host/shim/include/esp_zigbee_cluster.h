@@ -0,0 +1,10 @@
+/*
+ * Host shim: esp_zigbee_cluster.h (everything lives in esp_zigbee_core.h)
+ */
+
+#ifndef HOST_ESP_ZIGBEE_CLUSTER_H
+#define HOST_ESP_ZIGBEE_CLUSTER_H
+
+#include "esp_zigbee_core.h"
+
+#endif // HOST_ESP_ZIGBEE_CLUSTER_H
@@ -0,0 +1,529 @@
+/*
+ * Host shim: esp_zigbee_core.h (and the cluster/endpoint/attribute headers)
+ *
+ * Types and constants of esp-zigbee-lib 1.6 used by the firmware. Values
+ * match the ZCL specification; the stack itself is the fake in
+ * host_zigbee.c (attribute store, report log, scripted commissioning).
+ */
+
+#ifndef HOST_ESP_ZIGBEE_CORE_H
+#define HOST_ESP_ZIGBEE_CORE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+
+// ============================================================================
+// NETWORK
+// ============================================================================
+
+typedef uint8_t esp_zb_ieee_addr_t[8];
+
+typedef enum {
+    ESP_ZB_DEVICE_TYPE_COORDINATOR = 0x00,
+    ESP_ZB_DEVICE_TYPE_ROUTER = 0x01,
+    ESP_ZB_DEVICE_TYPE_ED = 0x02,
+} esp_zb_nwk_device_type_t;
+
+typedef enum {
+    ESP_ZB_ED_AGING_TIMEOUT_10SEC = 0x00,
+    ESP_ZB_ED_AGING_TIMEOUT_2MIN,
+    ESP_ZB_ED_AGING_TIMEOUT_4MIN,
+    ESP_ZB_ED_AGING_TIMEOUT_8MIN,
+    ESP_ZB_ED_AGING_TIMEOUT_16MIN,
+    ESP_ZB_ED_AGING_TIMEOUT_32MIN,
+    ESP_ZB_ED_AGING_TIMEOUT_64MIN,
+    ESP_ZB_ED_AGING_TIMEOUT_128MIN,
+    ESP_ZB_ED_AGING_TIMEOUT_256MIN,
+} esp_zb_aging_timeout_t;
+
+typedef struct {
+    uint8_t ed_timeout;
+    uint32_t keep_alive;
+} esp_zb_zed_cfg_t;
+
+typedef struct {
+    uint8_t max_children;
+} esp_zb_zczr_cfg_t;
+
+typedef struct {
+    esp_zb_nwk_device_type_t esp_zb_role;
+    bool install_code_policy;
+    union {
+        esp_zb_zczr_cfg_t zczr_cfg;
+        esp_zb_zed_cfg_t zed_cfg;
+    } nwk_cfg;
+} esp_zb_cfg_t;
+
+#define ESP_ZB_TRANSCEIVER_ALL_CHANNELS_MASK   0x07FFF800U
+
+typedef enum {
+    ESP_ZB_NWK_RELATIONSHIP_PARENT = 0x00,
+    ESP_ZB_NWK_RELATIONSHIP_CHILD = 0x01,
+    ESP_ZB_NWK_RELATIONSHIP_SIBLING = 0x02,
+    ESP_ZB_NWK_RELATIONSHIP_NONE_OF_THE_ABOVE = 0x03,
+    ESP_ZB_NWK_RELATIONSHIP_PREVIOUS_CHILD = 0x04,
+    ESP_ZB_NWK_RELATIONSHIP_UNAUTHENTICATED_CHILD = 0x05,
+} esp_zb_nwk_relationship_t;
+
+typedef uint16_t esp_zb_nwk_info_iterator_t;
+#define ESP_ZB_NWK_INFO_ITERATOR_INIT   0
+
+typedef struct {
+    esp_zb_ieee_addr_t ieee_addr;
+    uint16_t short_addr;
+    uint8_t device_type;
+    uint8_t depth;
+    uint8_t rx_on_when_idle;
+    uint8_t relationship;
+    uint8_t lqi;
+    int8_t rssi;
+    uint8_t outgoing_cost;
+    uint8_t age;
+    uint32_t device_timeout;
+    uint32_t timeout_counter;
+} esp_zb_nwk_neighbor_info_t;
+
+typedef enum {
+    ESP_ZB_NWK_LEAVE_TYPE_RESET = 0x00,
+    ESP_ZB_NWK_LEAVE_TYPE_REJOIN = 0x01,
+} esp_zb_nwk_leave_type_t;
+
+typedef struct {
+    esp_zb_ieee_addr_t device_address;
+    uint16_t dst_nwk_addr;
+    uint8_t reserved:6;
+    uint8_t remove_children:1;
+    uint8_t rejoin:1;
+} esp_zb_zdo_mgmt_leave_req_param_t;
+
+typedef enum {
+    ESP_ZB_ZDP_STATUS_SUCCESS = 0x00,
+    ESP_ZB_ZDP_STATUS_TIMEOUT = 0x85,
+} esp_zb_zdp_status_t;
+
+typedef void (*esp_zb_zdo_mgmt_leave_callback_t)(esp_zb_zdp_status_t zdo_status, void *user_ctx);
+
+typedef enum {
+    ESP_ZB_BDB_MODE_INITIALIZATION = 0x00,
+    ESP_ZB_BDB_MODE_TOUCHLINK_COMMISSIONING = 0x01,
+    ESP_ZB_BDB_MODE_NETWORK_STEERING = 0x02,
+    ESP_ZB_BDB_MODE_NETWORK_FORMATION = 0x04,
+} esp_zb_bdb_commissioning_mode_mask_t;
+
+// ============================================================================
+// SIGNALS
+// ============================================================================
+
+typedef enum {
+    ESP_ZB_ZDO_SIGNAL_DEFAULT_START = 0x00,
+    ESP_ZB_ZDO_SIGNAL_SKIP_STARTUP = 0x01,
+    ESP_ZB_ZDO_SIGNAL_DEVICE_ANNCE = 0x02,
+    ESP_ZB_ZDO_SIGNAL_LEAVE = 0x03,
+    ESP_ZB_ZDO_SIGNAL_ERROR = 0x04,
+    ESP_ZB_BDB_SIGNAL_DEVICE_FIRST_START = 0x05,
+    ESP_ZB_BDB_SIGNAL_DEVICE_REBOOT = 0x06,
+    ESP_ZB_BDB_SIGNAL_STEERING = 0x0A,
+    ESP_ZB_BDB_SIGNAL_FORMATION = 0x0B,
+    ESP_ZB_COMMON_SIGNAL_CAN_SLEEP = 0x16,
+    ESP_ZB_ZDO_SIGNAL_PRODUCTION_CONFIG_READY = 0x17,
+    ESP_ZB_NWK_SIGNAL_NO_ACTIVE_LINKS_LEFT = 0x18,
+    ESP_ZB_NWK_SIGNAL_PERMIT_JOIN_STATUS = 0x1C,
+    ESP_ZB_ZDO_SIGNAL_LEAVE_INDICATION = 0x1E,
+} esp_zb_app_signal_type_t;
+
+typedef struct {
+    uint32_t *p_app_signal;
+    esp_err_t esp_err_status;
+} esp_zb_app_signal_t;
+
+typedef struct {
+    uint8_t leave_type;               // esp_zb_nwk_leave_type_t
+} esp_zb_zdo_signal_leave_params_t;
+
+typedef void (*esp_zb_callback_t)(uint8_t param);
+
+// ============================================================================
+// ZCL
+// ============================================================================
+
+typedef enum {
+    ESP_ZB_ZCL_STATUS_SUCCESS = 0x00,
+    ESP_ZB_ZCL_STATUS_FAIL = 0x01,
+    ESP_ZB_ZCL_STATUS_NOT_AUTHORIZED = 0x7E,
+    ESP_ZB_ZCL_STATUS_INVALID_VALUE = 0x87,
+    ESP_ZB_ZCL_STATUS_UNSUP_ATTRIB = 0x86,
+    ESP_ZB_ZCL_STATUS_INVALID_TYPE = 0x8D,
+    ESP_ZB_ZCL_STATUS_READ_ONLY = 0x88,
+    ESP_ZB_ZCL_STATUS_ABORT = 0x95,
+} esp_zb_zcl_status_t;
+
+typedef enum {
+    ESP_ZB_ZCL_CLUSTER_SERVER_ROLE = 0x01,
+    ESP_ZB_ZCL_CLUSTER_CLIENT_ROLE = 0x02,
+} esp_zb_zcl_cluster_role_t;
+
+typedef enum {
+    ESP_ZB_ZCL_CMD_DIRECTION_TO_SRV = 0x00,
+    ESP_ZB_ZCL_CMD_DIRECTION_TO_CLI = 0x01,
+} esp_zb_zcl_cmd_direction_t;
+
+typedef enum {
+    ESP_ZB_APS_ADDR_MODE_DST_ADDR_ENDP_NOT_PRESENT = 0x00,
+    ESP_ZB_APS_ADDR_MODE_16_GROUP_ENDP_NOT_PRESENT = 0x01,
+    ESP_ZB_APS_ADDR_MODE_16_ENDP_PRESENT = 0x02,
+    ESP_ZB_APS_ADDR_MODE_64_ENDP_PRESENT = 0x03,
+} esp_zb_aps_address_mode_t;
+
+#define ESP_ZB_AF_HA_PROFILE_ID                 0x0104U
+#define ESP_ZB_HA_SIMPLE_SENSOR_DEVICE_ID       0x000CU
+#define ESP_ZB_HA_TEMPERATURE_SENSOR_DEVICE_ID  0x0302U
+
+// Cluster IDs
+#define ESP_ZB_ZCL_CLUSTER_ID_BASIC                   0x0000U
+#define ESP_ZB_ZCL_CLUSTER_ID_POWER_CONFIG            0x0001U
+#define ESP_ZB_ZCL_CLUSTER_ID_IDENTIFY                0x0003U
+#define ESP_ZB_ZCL_CLUSTER_ID_ON_OFF                  0x0006U
+#define ESP_ZB_ZCL_CLUSTER_ID_TIME                    0x000AU
+#define ESP_ZB_ZCL_CLUSTER_ID_OTA_UPGRADE             0x0019U
+#define ESP_ZB_ZCL_CLUSTER_ID_TEMP_MEASUREMENT        0x0402U
+#define ESP_ZB_ZCL_CLUSTER_ID_REL_HUMIDITY_MEASUREMENT 0x0405U
+
+// Attribute types
+typedef enum {
+    ESP_ZB_ZCL_ATTR_TYPE_NULL = 0x00,
+    ESP_ZB_ZCL_ATTR_TYPE_BOOL = 0x10,
+    ESP_ZB_ZCL_ATTR_TYPE_8BITMAP = 0x18,
+    ESP_ZB_ZCL_ATTR_TYPE_U8 = 0x20,
+    ESP_ZB_ZCL_ATTR_TYPE_U16 = 0x21,
+    ESP_ZB_ZCL_ATTR_TYPE_U32 = 0x23,
+    ESP_ZB_ZCL_ATTR_TYPE_S8 = 0x28,
+    ESP_ZB_ZCL_ATTR_TYPE_S16 = 0x29,
+    ESP_ZB_ZCL_ATTR_TYPE_S32 = 0x2B,
+    ESP_ZB_ZCL_ATTR_TYPE_8BIT_ENUM = 0x30,
+    ESP_ZB_ZCL_ATTR_TYPE_OCTET_STRING = 0x41,
+    ESP_ZB_ZCL_ATTR_TYPE_CHAR_STRING = 0x42,
+    ESP_ZB_ZCL_ATTR_TYPE_UTC_TIME = 0xE2,
+} esp_zb_zcl_attr_type_t;
+
+// Attribute access
+#define ESP_ZB_ZCL_ATTR_ACCESS_READ_ONLY    0x01U
+#define ESP_ZB_ZCL_ATTR_ACCESS_WRITE_ONLY   0x02U
+#define ESP_ZB_ZCL_ATTR_ACCESS_READ_WRITE   0x03U
+#define ESP_ZB_ZCL_ATTR_ACCESS_REPORTING    0x04U
+
+// Basic cluster
+#define ESP_ZB_ZCL_ATTR_BASIC_ZCL_VERSION_ID          0x0000U
+#define ESP_ZB_ZCL_ATTR_BASIC_MANUFACTURER_NAME_ID    0x0004U
+#define ESP_ZB_ZCL_ATTR_BASIC_MODEL_IDENTIFIER_ID     0x0005U
+#define ESP_ZB_ZCL_ATTR_BASIC_POWER_SOURCE_ID         0x0007U
+#define ESP_ZB_ZCL_ATTR_BASIC_DEVICE_ENABLED_ID       0x0012U
+#define ESP_ZB_ZCL_ATTR_BASIC_SW_BUILD_ID             0x4000U
+#define ESP_ZB_ZCL_BASIC_ZCL_VERSION_DEFAULT_VALUE    0x08
+#define ESP_ZB_ZCL_BASIC_POWER_SOURCE_BATTERY         0x03
+#define ESP_ZB_ZCL_BASIC_POWER_SOURCE_DC_SOURCE       0x04
+
+// Identify cluster
+#define ESP_ZB_ZCL_ATTR_IDENTIFY_IDENTIFY_TIME_ID     0x0000U
+#define ESP_ZB_ZCL_IDENTIFY_IDENTIFY_TIME_DEFAULT_VALUE 0x0000
+
+// Power configuration cluster
+#define ESP_ZB_ZCL_ATTR_POWER_CONFIG_MAINS_VOLTAGE_ID 0x0000U
+#define ESP_ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_VOLTAGE_ID 0x0020U
+#define ESP_ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_PERCENTAGE_REMAINING_ID 0x0021U
+
+// On/Off cluster
+#define ESP_ZB_ZCL_ATTR_ON_OFF_ON_OFF_ID              0x0000U
+#define ESP_ZB_ZCL_ON_OFF_ON_OFF_DEFAULT_VALUE        false
+
+// Time cluster
+#define ESP_ZB_ZCL_ATTR_TIME_TIME_ID                  0x0000U
+#define ESP_ZB_ZCL_ATTR_TIME_TIME_STATUS_ID           0x0001U
+
+// Temperature / relative humidity measurement clusters
+#define ESP_ZB_ZCL_ATTR_TEMP_MEASUREMENT_VALUE_ID     0x0000U
+#define ESP_ZB_ZCL_ATTR_TEMP_MEASUREMENT_MIN_VALUE_ID 0x0001U
+#define ESP_ZB_ZCL_ATTR_TEMP_MEASUREMENT_MAX_VALUE_ID 0x0002U
+#define ESP_ZB_ZCL_TEMP_MEASUREMENT_MEASURED_VALUE_DEFAULT ((int16_t)0x8000)
+#define ESP_ZB_ZCL_ATTR_REL_HUMIDITY_MEASUREMENT_VALUE_ID     0x0000U
+#define ESP_ZB_ZCL_ATTR_REL_HUMIDITY_MEASUREMENT_MIN_VALUE_ID 0x0001U
+#define ESP_ZB_ZCL_ATTR_REL_HUMIDITY_MEASUREMENT_MAX_VALUE_ID 0x0002U
+#define ESP_ZB_ZCL_REL_HUMIDITY_MEASUREMENT_MEASURED_VALUE_DEFAULT 0xFFFF
+
+// OTA upgrade cluster
+#define ESP_ZB_ZCL_ATTR_OTA_UPGRADE_FILE_VERSION_ID        0x0002U
+#define ESP_ZB_ZCL_ATTR_OTA_UPGRADE_DOWNLOADED_FILE_VERSION_ID 0x0004U
+#define ESP_ZB_ZCL_ATTR_OTA_UPGRADE_MANUFACTURE_ID         0x0007U
+#define ESP_ZB_ZCL_ATTR_OTA_UPGRADE_IMAGE_TYPE_ID          0x0008U
+
+typedef enum {
+    ESP_ZB_ZCL_OTA_UPGRADE_STATUS_START = 0x0000,
+    ESP_ZB_ZCL_OTA_UPGRADE_STATUS_APPLY,
+    ESP_ZB_ZCL_OTA_UPGRADE_STATUS_RECEIVE,
+    ESP_ZB_ZCL_OTA_UPGRADE_STATUS_FINISH,
+    ESP_ZB_ZCL_OTA_UPGRADE_STATUS_ABORT,
+    ESP_ZB_ZCL_OTA_UPGRADE_STATUS_CHECK,
+    ESP_ZB_ZCL_OTA_UPGRADE_STATUS_OK,
+    ESP_ZB_ZCL_OTA_UPGRADE_STATUS_ERROR,
+} esp_zb_zcl_ota_upgrade_status_t;
+
+// Cluster configurations
+typedef struct {
+    uint8_t zcl_version;
+    uint8_t power_source;
+} esp_zb_basic_cluster_cfg_t;
+
+typedef struct {
+    uint16_t identify_time;
+} esp_zb_identify_cluster_cfg_t;
+
+typedef struct {
+    uint16_t main_voltage;
+    uint8_t main_freq;
+    uint8_t main_alarm_mask;
+    uint16_t main_voltage_min;
+    uint16_t main_voltage_max;
+    uint16_t main_voltage_dwell;
+} esp_zb_power_config_cluster_cfg_t;
+
+typedef struct {
+    bool on_off;
+} esp_zb_on_off_cluster_cfg_t;
+
+typedef struct {
+    int16_t measured_value;
+    int16_t min_value;
+    int16_t max_value;
+} esp_zb_temperature_meas_cluster_cfg_t;
+
+typedef struct {
+    uint16_t measured_value;
+    uint16_t min_value;
+    uint16_t max_value;
+} esp_zb_humidity_meas_cluster_cfg_t;
+
+typedef struct {
+    uint32_t ota_upgrade_file_version;
+    uint16_t ota_upgrade_manufacturer;
+    uint16_t ota_upgrade_image_type;
+    uint32_t ota_min_block_reque;
+    uint32_t ota_upgrade_file_offset;
+    uint32_t ota_upgrade_downloaded_file_ver;
+    esp_zb_ieee_addr_t ota_upgrade_server_id;
+    uint8_t ota_image_upgrade_status;
+} esp_zb_ota_cluster_cfg_t;
+
+// Attribute / cluster / endpoint lists (opaque, owned by the fake)
+typedef struct host_zb_attr_list esp_zb_attribute_list_t;
+typedef struct host_zb_cluster_list esp_zb_cluster_list_t;
+typedef struct host_zb_ep_list esp_zb_ep_list_t;
+
+typedef struct {
+    uint8_t endpoint;
+    uint16_t app_profile_id;
+    uint16_t app_device_id;
+    uint32_t app_device_version;
+} esp_zb_endpoint_config_t;
+
+// Commands
+typedef union {
+    uint16_t addr_short;
+    esp_zb_ieee_addr_t addr_long;
+} esp_zb_addr_u;
+
+typedef struct {
+    esp_zb_addr_u dst_addr_u;
+    uint8_t dst_endpoint;
+    uint8_t src_endpoint;
+} esp_zb_zcl_basic_cmd_t;
+
+typedef struct {
+    esp_zb_zcl_basic_cmd_t zcl_basic_cmd;
+    esp_zb_aps_address_mode_t address_mode;
+    uint16_t clusterID;
+    uint16_t attributeID;
+    uint8_t direction;
+    uint8_t manuf_specific;
+    uint16_t manuf_code;
+} esp_zb_zcl_report_attr_cmd_t;
+
+// Delivery status of a sent ZCL command (APS ack or MAC failure)
+typedef struct {
+    uint8_t tsn;
+    esp_zb_addr_u dst_addr;
+    uint8_t dst_endpoint;
+    uint8_t src_endpoint;
+    esp_err_t status;
+} esp_zb_zcl_command_send_status_message_t;
+
+typedef void (*esp_zb_zcl_command_send_status_callback_t)(esp_zb_zcl_command_send_status_message_t message);
+
+// Every incoming ZCL frame before the stack handles it (true = consumed by the application)
+typedef bool (*esp_zb_zcl_raw_command_callback_t)(uint8_t bufid);
+
+// Every incoming APS data frame (ZCL, ZDO, other profiles) before the stack
+// handles it (true = consumed by the application)
+typedef struct {
+    uint8_t status;
+    uint8_t dst_addr_mode;
+    uint16_t dst_short_addr;
+    uint8_t dst_endpoint;
+    uint16_t src_short_addr;
+    uint8_t src_endpoint;
+    uint16_t profile_id;
+    uint16_t cluster_id;
+    uint32_t asdu_length;
+    uint8_t *asdu;
+    uint8_t security_status;
+    uint8_t lqi;
+    int rx_time;
+} esp_zb_apsde_data_ind_t;
+
+typedef bool (*esp_zb_aps_data_indication_callback_t)(esp_zb_apsde_data_ind_t ind);
+
+// Custom cluster handlers: check_value runs before a remote write is
+// stored; anything but ESP_OK answers the write with INVALID_VALUE
+typedef esp_err_t (*esp_zb_zcl_cluster_check_value_callback_t)(uint16_t attr_id, uint8_t endpoint, uint8_t *value);
+typedef void (*esp_zb_zcl_cluster_write_attr_callback_t)(uint8_t endpoint, uint16_t attr_id, uint8_t *new_value,
+                                                         uint16_t manuf_code);
+
+typedef struct {
+    uint16_t cluster_id;
+    uint8_t cluster_role;
+    esp_zb_zcl_cluster_check_value_callback_t check_value_cb;
+    esp_zb_zcl_cluster_write_attr_callback_t write_attr_cb;
+} esp_zb_zcl_custom_cluster_handlers_t;
+
+// Action callbacks
+typedef enum {
+    ESP_ZB_CORE_SET_ATTR_VALUE_CB_ID = 0x0000,
+    ESP_ZB_CORE_OTA_UPGRADE_VALUE_CB_ID = 0x0004,
+    ESP_ZB_CORE_CMD_READ_ATTR_RESP_CB_ID = 0x1000,
+    ESP_ZB_CORE_CMD_REPORT_CONFIG_RESP_CB_ID = 0x1002,
+    ESP_ZB_CORE_CMD_DEFAULT_RESP_CB_ID = 0x1005,
+} esp_zb_core_action_callback_id_t;
+
+typedef esp_err_t (*esp_zb_core_action_handler_t)(esp_zb_core_action_callback_id_t callback_id, const void *message);
+
+typedef struct {
+    esp_zb_zcl_status_t status;
+    uint16_t src_address;
+    uint8_t src_endpoint;
+    uint8_t dst_endpoint;
+    uint16_t cluster;
+    uint16_t profile;
+} esp_zb_zcl_cmd_info_t;
+
+typedef struct {
+    esp_zb_zcl_attr_type_t type;
+    uint16_t size;
+    void *value;
+} esp_zb_zcl_attribute_data_t;
+
+typedef struct {
+    uint16_t id;
+    esp_zb_zcl_attribute_data_t data;
+} esp_zb_zcl_attribute_t;
+
+typedef struct {
+    esp_zb_zcl_cmd_info_t info;
+    esp_zb_zcl_attribute_t attribute;
+} esp_zb_zcl_set_attr_value_message_t;
+
+typedef struct {
+    uint16_t header_version;
+    uint16_t header_length;
+    uint16_t field_control;
+    uint16_t manufacturer_code;
+    uint16_t image_type;
+    uint32_t file_version;
+    uint16_t stack_version;
+    uint32_t image_size;
+} esp_zb_zcl_ota_upgrade_header_t;
+
+typedef struct {
+    esp_zb_zcl_cmd_info_t info;
+    esp_zb_zcl_ota_upgrade_status_t upgrade_status;
+    esp_zb_zcl_ota_upgrade_header_t ota_header;
+    uint16_t payload_size;
+    const uint8_t *payload;
+} esp_zb_zcl_ota_upgrade_value_message_t;
+
+// ============================================================================
+// API
+// ============================================================================
+
+// Stack
+void esp_zb_init(esp_zb_cfg_t *nwk_cfg);
+esp_err_t esp_zb_start(bool autostart);
+void esp_zb_stack_main_loop(void);
+void esp_zb_main_loop_iteration(void);
+bool esp_zb_lock_acquire(TickType_t block_ticks);
+void esp_zb_lock_release(void);
+void esp_zb_scheduler_alarm(esp_zb_callback_t cb, uint8_t param, uint32_t time);
+void esp_zb_scheduler_alarm_cancel(esp_zb_callback_t cb, uint8_t param);
+void esp_zb_sleep_enable(bool enable);
+void esp_zb_sleep_now(void);
+void esp_zb_set_tx_power(int8_t power);
+void esp_zb_nvram_erase_at_start(bool erase);
+esp_err_t esp_zb_set_primary_network_channel_set(uint32_t channel_mask);
+esp_err_t esp_zb_device_register(esp_zb_ep_list_t *ep_list);
+void esp_zb_core_action_handler_register(esp_zb_core_action_handler_t cb);
+void esp_zb_app_signal_handler(esp_zb_app_signal_t *signal_s);
+void *esp_zb_app_signal_get_params(uint32_t *signal_p);
+const char *esp_zb_zdo_signal_to_string(esp_zb_app_signal_type_t signal);
+
+// Commissioning / network info
+esp_err_t esp_zb_bdb_start_top_level_commissioning(uint8_t mode_mask);
+bool esp_zb_bdb_is_factory_new(void);
+uint16_t esp_zb_get_pan_id(void);
+uint8_t esp_zb_get_current_channel(void);
+uint16_t esp_zb_get_short_address(void);
+void esp_zb_get_extended_pan_id(esp_zb_ieee_addr_t ext_pan_id);
+void esp_zb_get_long_address(esp_zb_ieee_addr_t addr);
+esp_err_t esp_zb_nwk_get_next_neighbor(esp_zb_nwk_info_iterator_t *iterator, esp_zb_nwk_neighbor_info_t *nbr_info);
+void esp_zb_zdo_device_leave_req(esp_zb_zdo_mgmt_leave_req_param_t *cmd_req, esp_zb_zdo_mgmt_leave_callback_t user_cb,
+                                 void *user_ctx);
+
+// Attributes / reporting
+esp_zb_zcl_status_t esp_zb_zcl_set_attribute_val(uint8_t endpoint, uint16_t cluster_id, uint8_t cluster_role,
+                                                 uint16_t attr_id, void *value_p, bool check);
+esp_err_t esp_zb_zcl_report_attr_cmd_req(esp_zb_zcl_report_attr_cmd_t *cmd_req);
+void esp_zb_zcl_command_send_status_handler_register(esp_zb_zcl_command_send_status_callback_t cb);
+void esp_zb_raw_command_handler_register(esp_zb_zcl_raw_command_callback_t cb);
+void esp_zb_aps_data_indication_handler_register(esp_zb_aps_data_indication_callback_t cb);
+esp_err_t esp_zb_zcl_custom_cluster_handlers_update(esp_zb_zcl_custom_cluster_handlers_t obj);
+
+// Clusters
+esp_zb_attribute_list_t *esp_zb_zcl_attr_list_create(uint16_t cluster_id);
+esp_zb_attribute_list_t *esp_zb_basic_cluster_create(esp_zb_basic_cluster_cfg_t *basic_cfg);
+esp_zb_attribute_list_t *esp_zb_identify_cluster_create(esp_zb_identify_cluster_cfg_t *identify_cfg);
+esp_zb_attribute_list_t *esp_zb_power_config_cluster_create(esp_zb_power_config_cluster_cfg_t *power_cfg);
+esp_zb_attribute_list_t *esp_zb_on_off_cluster_create(esp_zb_on_off_cluster_cfg_t *on_off_cfg);
+esp_zb_attribute_list_t *esp_zb_temperature_meas_cluster_create(esp_zb_temperature_meas_cluster_cfg_t *temp_cfg);
+esp_zb_attribute_list_t *esp_zb_humidity_meas_cluster_create(esp_zb_humidity_meas_cluster_cfg_t *hum_cfg);
+esp_zb_attribute_list_t *esp_zb_ota_cluster_create(esp_zb_ota_cluster_cfg_t *ota_cfg);
+esp_err_t esp_zb_basic_cluster_add_attr(esp_zb_attribute_list_t *attr_list, uint16_t attr_id, void *value_p);
+esp_err_t esp_zb_power_config_cluster_add_attr(esp_zb_attribute_list_t *attr_list, uint16_t attr_id, void *value_p);
+esp_err_t esp_zb_cluster_add_attr(esp_zb_attribute_list_t *attr_list, uint16_t cluster_id, uint16_t attr_id,
+                                  uint8_t attr_type, uint8_t attr_access, void *value_p);
+esp_err_t esp_zb_custom_cluster_add_custom_attr(esp_zb_attribute_list_t *attr_list, uint16_t attr_id,
+                                                uint8_t attr_type, uint8_t attr_access, void *value_p);
+
+// Cluster / endpoint lists
+esp_zb_cluster_list_t *esp_zb_zcl_cluster_list_create(void);
+esp_err_t esp_zb_cluster_list_add_basic_cluster(esp_zb_cluster_list_t *l, esp_zb_attribute_list_t *a, uint8_t role);
+esp_err_t esp_zb_cluster_list_add_identify_cluster(esp_zb_cluster_list_t *l, esp_zb_attribute_list_t *a, uint8_t role);
+esp_err_t esp_zb_cluster_list_add_power_config_cluster(esp_zb_cluster_list_t *l, esp_zb_attribute_list_t *a, uint8_t role);
+esp_err_t esp_zb_cluster_list_add_on_off_cluster(esp_zb_cluster_list_t *l, esp_zb_attribute_list_t *a, uint8_t role);
+esp_err_t esp_zb_cluster_list_add_time_cluster(esp_zb_cluster_list_t *l, esp_zb_attribute_list_t *a, uint8_t role);
+esp_err_t esp_zb_cluster_list_add_temperature_meas_cluster(esp_zb_cluster_list_t *l, esp_zb_attribute_list_t *a, uint8_t role);
+esp_err_t esp_zb_cluster_list_add_humidity_meas_cluster(esp_zb_cluster_list_t *l, esp_zb_attribute_list_t *a, uint8_t role);
+esp_err_t esp_zb_cluster_list_add_ota_cluster(esp_zb_cluster_list_t *l, esp_zb_attribute_list_t *a, uint8_t role);
+esp_err_t esp_zb_cluster_list_add_custom_cluster(esp_zb_cluster_list_t *l, esp_zb_attribute_list_t *a, uint8_t role);
+esp_zb_ep_list_t *esp_zb_ep_list_create(void);
+esp_err_t esp_zb_ep_list_add_ep(esp_zb_ep_list_t *ep_list, esp_zb_cluster_list_t *cluster_list,
+                                esp_zb_endpoint_config_t endpoint_config);
+
+#endif // HOST_ESP_ZIGBEE_CORE_H
@@ -0,0 +1,10 @@
+/*
+ * Host shim: esp_zigbee_endpoint.h (everything lives in esp_zigbee_core.h)
+ */
+
+#ifndef HOST_ESP_ZIGBEE_ENDPOINT_H
+#define HOST_ESP_ZIGBEE_ENDPOINT_H
+
+#include "esp_zigbee_core.h"
+
+#endif // HOST_ESP_ZIGBEE_ENDPOINT_H
@@ -0,0 +1,35 @@
+/*
+ * Host shim: FreeRTOS.h (single-threaded, virtual time)
+ */
+
+#ifndef HOST_FREERTOS_H
+#define HOST_FREERTOS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_system.h"     // Pulled in by the RISC-V portmacro.h in ESP-IDF
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint8_t StackType_t;        // ESP-IDF: stack depths are in bytes
+
+#define configTICK_RATE_HZ          1000       // CONFIG_FREERTOS_HZ in sdkconfig.defaults
+#define portTICK_PERIOD_MS          ((TickType_t)1000 / configTICK_RATE_HZ)
+#define portMAX_DELAY               ((TickType_t)0xffffffffUL)
+#define pdMS_TO_TICKS(ms)           ((TickType_t)(((uint64_t)(ms) * configTICK_RATE_HZ) / 1000U))
+
+#define pdFALSE                     ((BaseType_t)0)
+#define pdTRUE                      ((BaseType_t)1)
+#define pdPASS                      pdTRUE
+#define pdFAIL                      pdFALSE
+
+typedef struct {
+    int owner;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED    { 0 }
+#define portENTER_CRITICAL(mux)         ((void)(mux))
+#define portEXIT_CRITICAL(mux)          ((void)(mux))
+
+#endif // HOST_FREERTOS_H
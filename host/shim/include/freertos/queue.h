@@ -0,0 +1,38 @@
+/*
+ * Host shim: queue.h (single-threaded)
+ *
+ * Sending never blocks (a full queue fails at once). Receiving from an
+ * empty queue runs the events on virtual time until one of them sends an
+ * item or the wait times out; waiting forever with nothing scheduled is a
+ * deadlock and aborts.
+ */
+
+#ifndef HOST_FREERTOS_QUEUE_H
+#define HOST_FREERTOS_QUEUE_H
+
+#include "freertos/FreeRTOS.h"
+
+#define errQUEUE_EMPTY              ((BaseType_t)0)
+#define errQUEUE_FULL               ((BaseType_t)0)
+
+typedef struct host_queue {
+    uint8_t *storage;
+    UBaseType_t length;
+    UBaseType_t item_size;
+    UBaseType_t head;
+    UBaseType_t count;
+} StaticQueue_t;
+
+typedef struct host_queue *QueueHandle_t;
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size);
+QueueHandle_t xQueueCreateStatic(UBaseType_t length, UBaseType_t item_size,
+                                 uint8_t *storage, StaticQueue_t *queue);
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks_to_wait);
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks_to_wait);
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue);
+void vQueueDelete(QueueHandle_t queue);
+
+#define xQueueSendToBack(queue, item, ticks)    xQueueSend((queue), (item), (ticks))
+
+#endif // HOST_FREERTOS_QUEUE_H
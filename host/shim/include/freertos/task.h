@@ -0,0 +1,45 @@
+/*
+ * Host shim: task.h
+ *
+ * vTaskDelay() advances virtual time. Created tasks are recorded but not
+ * run - drive the code under test directly from the harness. Host tasks
+ * run on the harness stack, so the high-water mark reports the whole
+ * requested stack as unused.
+ */
+
+#ifndef HOST_FREERTOS_TASK_H
+#define HOST_FREERTOS_TASK_H
+
+#include "freertos/FreeRTOS.h"
+
+typedef void (*TaskFunction_t)(void *);
+typedef struct host_task *TaskHandle_t;
+
+// Static tasks are recorded like dynamic ones; the buffers are not used
+typedef struct {
+    void *reserved;
+} StaticTask_t;
+
+typedef enum {
+    eNoAction = 0,
+    eSetBits,
+    eIncrement,
+    eSetValueWithOverwrite,
+    eSetValueWithoutOverwrite,
+} eNotifyAction;
+
+void vTaskDelay(TickType_t ticks);
+TickType_t xTaskGetTickCount(void);
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack_depth,
+                       void *param, UBaseType_t priority, TaskHandle_t *handle);
+TaskHandle_t xTaskCreateStatic(TaskFunction_t fn, const char *name, uint32_t stack_depth,
+                               void *param, UBaseType_t priority, StackType_t *stack,
+                               StaticTask_t *tcb);
+void vTaskDelete(TaskHandle_t handle);
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t handle);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+BaseType_t xTaskNotify(TaskHandle_t handle, uint32_t value, eNotifyAction action);
+BaseType_t xTaskNotifyWait(uint32_t clear_on_entry, uint32_t clear_on_exit,
+                           uint32_t *value, TickType_t ticks_to_wait);
+
+#endif // HOST_FREERTOS_TASK_H
@@ -0,0 +1,40 @@
+/*
+ * Host shim: timers.h (software timers on virtual time)
+ *
+ * Callbacks run from the virtual-time event loop, like the FreeRTOS timer
+ * service task runs them between other tasks. Command queue timeouts are
+ * ignored - commands always succeed at once.
+ */
+
+#ifndef HOST_FREERTOS_TIMERS_H
+#define HOST_FREERTOS_TIMERS_H
+
+#include "freertos/FreeRTOS.h"
+
+typedef struct host_timer *TimerHandle_t;
+typedef void (*TimerCallbackFunction_t)(TimerHandle_t timer);
+
+typedef struct host_timer {
+    const char *name;
+    TickType_t period;
+    UBaseType_t auto_reload;
+    void *id;
+    TimerCallbackFunction_t callback;
+    uint32_t event_id;            // Pending virtual-time event (0 = dormant)
+} StaticTimer_t;
+
+TimerHandle_t xTimerCreate(const char *name, TickType_t period, UBaseType_t auto_reload,
+                           void *id, TimerCallbackFunction_t callback);
+TimerHandle_t xTimerCreateStatic(const char *name, TickType_t period, UBaseType_t auto_reload,
+                                 void *id, TimerCallbackFunction_t callback, StaticTimer_t *buffer);
+BaseType_t xTimerStart(TimerHandle_t timer, TickType_t ticks_to_wait);
+BaseType_t xTimerStop(TimerHandle_t timer, TickType_t ticks_to_wait);
+BaseType_t xTimerReset(TimerHandle_t timer, TickType_t ticks_to_wait);
+BaseType_t xTimerChangePeriod(TimerHandle_t timer, TickType_t period, TickType_t ticks_to_wait);
+BaseType_t xTimerIsTimerActive(TimerHandle_t timer);
+void vTimerSetReloadMode(TimerHandle_t timer, UBaseType_t auto_reload);
+TickType_t xTimerGetPeriod(TimerHandle_t timer);
+void *pvTimerGetTimerID(TimerHandle_t timer);
+BaseType_t xTimerDelete(TimerHandle_t timer, TickType_t ticks_to_wait);
+
+#endif // HOST_FREERTOS_TIMERS_H
@@ -0,0 +1,40 @@
+/*
+ * Host shim: mbedtls/ccm.h (AES-128 CCM, mbedtls 3.x signatures)
+ */
+
+#ifndef HOST_MBEDTLS_CCM_H
+#define HOST_MBEDTLS_CCM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define MBEDTLS_ERR_CCM_BAD_INPUT       -0x000D
+#define MBEDTLS_ERR_CCM_AUTH_FAILED     -0x000F
+
+typedef enum {
+    MBEDTLS_CIPHER_ID_NONE = 0,
+    MBEDTLS_CIPHER_ID_NULL,
+    MBEDTLS_CIPHER_ID_AES,
+} mbedtls_cipher_id_t;
+
+typedef struct {
+    uint32_t round_keys[44];      // AES-128 key schedule
+    int ready;
+} mbedtls_ccm_context;
+
+void mbedtls_ccm_init(mbedtls_ccm_context *ctx);
+void mbedtls_ccm_free(mbedtls_ccm_context *ctx);
+int mbedtls_ccm_setkey(mbedtls_ccm_context *ctx, mbedtls_cipher_id_t cipher,
+                       const unsigned char *key, unsigned int keybits);
+int mbedtls_ccm_encrypt_and_tag(mbedtls_ccm_context *ctx, size_t length,
+                                const unsigned char *iv, size_t iv_len,
+                                const unsigned char *ad, size_t ad_len,
+                                const unsigned char *input, unsigned char *output,
+                                unsigned char *tag, size_t tag_len);
+int mbedtls_ccm_auth_decrypt(mbedtls_ccm_context *ctx, size_t length,
+                             const unsigned char *iv, size_t iv_len,
+                             const unsigned char *ad, size_t ad_len,
+                             const unsigned char *input, unsigned char *output,
+                             const unsigned char *tag, size_t tag_len);
+
+#endif // HOST_MBEDTLS_CCM_H
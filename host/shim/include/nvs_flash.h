@@ -0,0 +1,13 @@
+/*
+ * Host shim: nvs_flash.h
+ */
+
+#ifndef HOST_NVS_FLASH_H
+#define HOST_NVS_FLASH_H
+
+#include "esp_err.h"
+
+esp_err_t nvs_flash_init(void);
+esp_err_t nvs_flash_erase(void);
+
+#endif // HOST_NVS_FLASH_H
@@ -0,0 +1,47 @@
+/*
+ * Host shim: sdkconfig.h
+ *
+ * Mirrors the "Balanced" performance profile defaults of
+ * main/Kconfig.projbuild - keep in sync when the profile changes.
+ */
+
+#ifndef HOST_SDKCONFIG_H
+#define HOST_SDKCONFIG_H
+
+#define CONFIG_FREERTOS_HZ                          1000
+#define CONFIG_GLYPH_PERF_PROFILE_BALANCED          1
+#define CONFIG_GLYPH_BATT_SAMPLE_INTERVAL_SEC       3600
+#define CONFIG_GLYPH_BATT_REPORT_INTERVAL_SEC       14400
+#define CONFIG_GLYPH_BATT_NUM_SAMPLES               5
+#define CONFIG_GLYPH_BATT_SAMPLE_SPACING_MS         5000
+#define CONFIG_GLYPH_BATT_MOISTURE_DEADBAND_CENTI   200
+#define CONFIG_GLYPH_BATT_TEMP_DEADBAND_CENTI       50
+#define CONFIG_GLYPH_SENSE_INTERVAL_SEC             600
+#define CONFIG_GLYPH_USB_SAMPLE_INTERVAL_SEC        60
+#define CONFIG_GLYPH_USB_REPORT_INTERVAL_SEC        300
+#define CONFIG_GLYPH_USB_NUM_SAMPLES                3
+#define CONFIG_GLYPH_USB_SAMPLE_SPACING_MS          1000
+#define CONFIG_GLYPH_USB_MOISTURE_DEADBAND_CENTI    50
+#define CONFIG_GLYPH_USB_TEMP_DEADBAND_CENTI        20
+#define CONFIG_GLYPH_BATTERY_REPORT_INTERVAL_SEC    14400
+#define CONFIG_GLYPH_JOIN_TIMEOUT_MS                30000
+#define CONFIG_GLYPH_TX_LINGER_MS                   5000
+#define CONFIG_GLYPH_ED_KEEP_ALIVE_MS               3000
+#define CONFIG_GLYPH_OTA_DOWNLOAD_TIMEOUT_SEC       300
+#define CONFIG_GLYPH_ZCL_IDENTIFY                   1
+#define CONFIG_GLYPH_ZCL_LED                        1
+
+// Not a profile default: the host build records field traces so the
+// replay round trip is exercised by the tests
+#define CONFIG_GLYPH_FIELD_TRACE                    1
+
+// Not a profile default: compiled in so the uplink can be paired in tests
+// and simulations (unpaired nodes behave as without it)
+#define CONFIG_GLYPH_GP_UPLINK                      1
+#define CONFIG_GLYPH_GP_FULL_WAKE_REPORTS           12
+
+// Not a profile default: the second endpoint and its driver are built so
+// the shared bus window is exercised (absent sensors just NACK)
+#define CONFIG_GLYPH_AMBIENT_SHT4X                  1
+
+#endif // HOST_SDKCONFIG_H
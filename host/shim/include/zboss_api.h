@@ -0,0 +1,17 @@
+/*
+ * Host shim: zboss_api.h (ESP-Zigbee API in esp_zigbee_core.h, plus the
+ * few raw ZBOSS calls the firmware uses)
+ */
+
+#ifndef HOST_ZBOSS_API_H
+#define HOST_ZBOSS_API_H
+
+#include "esp_zigbee_core.h"
+
+typedef uint8_t zb_uint8_t;
+
+// Poll control: send n_packets MAC data requests back to back, each one as
+// soon as the previous poll completed (turbo poll)
+void zb_zdo_pim_start_turbo_poll_packets(zb_uint8_t n_packets);
+
+#endif // HOST_ZBOSS_API_H
@@ -0,0 +1,755 @@
+/*
+ * Glyph C6 Monitor - Fleet Reporting Simulator
+ *
+ * Version: 1.0.0
+ */
+
+#include "fleet_sim.h"
+#include "system_config.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// 802.15.4 O-QPSK (2.4 GHz) timing
+#define SYMBOL_US             16
+#define BYTE_US               32
+#define UNIT_BACKOFF_US       (20 * SYMBOL_US)       // aUnitBackoffPeriod
+#define CCA_US                (8 * SYMBOL_US)
+#define TURNAROUND_US         (12 * SYMBOL_US)       // aTurnaroundTime
+#define ACK_WAIT_US           (54 * SYMBOL_US)       // macAckWaitDuration
+#define PHY_OVERHEAD          6                      // Preamble, SFD, PHR
+#define MAX_MPDU              127
+
+// MPDU sizes: MAC header 9 + FCS 2, NWK header 8 + NWK security 18, APS header 8
+#define MPDU_ACK              5
+#define MPDU_POLL             12                     // MAC header 9 + command 1 + FCS 2
+#define MPDU_NWK              (9 + 2 + 8 + 18)
+#define MPDU_REPORT_BASE      (MPDU_NWK + 8 + 3 + 3) // + ZCL header, attribute id + type
+#define MPDU_REJOIN_REQ       (MPDU_NWK + 2)
+#define MPDU_REJOIN_RSP       (MPDU_NWK + 4)
+#define MPDU_APS_ACK          (MPDU_NWK + 8)
+
+#define NO_FRAME              UINT32_MAX
+#define TX_POOL_SIZE          512
+
+typedef enum {
+    FRAME_REPORT = 0,
+    FRAME_POLL,
+    FRAME_REJOIN,
+    FRAME_REJOIN_RSP,
+    FRAME_APS_ACK,
+} frame_kind_t;
+
+typedef struct {
+    uint64_t ready_us;                // Handed to the MAC
+    uint32_t seq;                     // Tie-break: creation order
+    uint32_t node;                    // Node the frame is from / for
+    uint32_t next;                    // Station queue link
+    uint8_t mpdu;
+    uint8_t kind;
+    bool downlink;
+    bool received;
+} fleet_frame_t;
+
+typedef struct {
+    fleet_frame_t *items;
+    size_t count;
+    size_t cap;
+} frame_vec_t;
+
+// ============================================================================
+// PHASE 1: NODE TRACES
+// ============================================================================
+
+typedef struct {
+    frame_vec_t *frames;
+    uint32_t node;
+    uint64_t offset_us;
+    uint64_t poll_us;
+    bool joined;
+    uint64_t joined_us;
+    bool oom;
+} node_capture_t;
+
+static fleet_frame_t *frame_push(frame_vec_t *vec, uint64_t ready_us, uint32_t node,
+                                 frame_kind_t kind, uint32_t mpdu, bool downlink)
+{
+    if (vec->count == vec->cap) {
+        size_t cap = vec->cap ? vec->cap * 2 : 4096;
+        fleet_frame_t *items = realloc(vec->items, cap * sizeof(*items));
+        if (!items) {
+            return NULL;
+        }
+        vec->items = items;
+        vec->cap = cap;
+    }
+    fleet_frame_t *f = &vec->items[vec->count];
+    memset(f, 0, sizeof(*f));
+    f->ready_us = ready_us;
+    f->seq = (uint32_t)vec->count;
+    f->node = node;
+    f->next = NO_FRAME;
+    f->mpdu = (uint8_t)(mpdu > MAX_MPDU ? MAX_MPDU : mpdu);
+    f->kind = (uint8_t)kind;
+    f->downlink = downlink;
+    vec->count++;
+    return f;
+}
+
+static void capture_hook(const host_zb_event_t *event, void *ctx)
+{
+    node_capture_t *cap = ctx;
+    uint64_t t = event->time_us + cap->offset_us;
+    bool ok = true;
+
+    switch (event->type) {
+    case HOST_ZB_EVENT_STACK_START:
+        cap->joined = false;
+        break;
+    case HOST_ZB_EVENT_JOINED:
+        cap->joined = true;
+        cap->joined_us = t;
+        ok = frame_push(cap->frames, t, cap->node, FRAME_REJOIN, MPDU_REJOIN_REQ, false) != NULL;
+        break;
+    case HOST_ZB_EVENT_REPORT:
+        ok = frame_push(cap->frames, t, cap->node, FRAME_REPORT,
+                        MPDU_REPORT_BASE + event->value_len, false) != NULL;
+        break;
+    case HOST_ZB_EVENT_STACK_STOP:
+        // Data polls while joined, up to the moment the radio went down
+        for (uint64_t p = cap->joined_us + cap->poll_us; cap->joined && p < t && ok; p += cap->poll_us) {
+            ok = frame_push(cap->frames, p, cap->node, FRAME_POLL, MPDU_POLL, false) != NULL;
+        }
+        cap->joined = false;
+        break;
+    case HOST_ZB_EVENT_POLL:
+        // Firmware-driven data request (queue drain) on top of the keep-alive polls
+        ok = frame_push(cap->frames, t, cap->node, FRAME_POLL, MPDU_POLL, false) != NULL;
+        break;
+    }
+    if (!ok) {
+        cap->oom = true;
+    }
+}
+
+static int frame_order(const void *a, const void *b)
+{
+    const fleet_frame_t *fa = a, *fb = b;
+    if (fa->ready_us != fb->ready_us) {
+        return fa->ready_us < fb->ready_us ? -1 : 1;
+    }
+    return fa->seq < fb->seq ? -1 : (fa->seq > fb->seq);
+}
+
+// ============================================================================
+// PHASE 2: CHANNEL, MAC AND COORDINATOR
+// ============================================================================
+
+typedef enum {
+    EV_BACKOFF_END = 0,
+    EV_TX_START,
+    EV_TX_END,
+    EV_ACK_START,
+    EV_ACK_END,
+    EV_ACK_WAIT_END,
+} event_type_t;
+
+typedef struct {
+    uint64_t time_us;
+    uint64_t seq;
+    uint32_t station;
+    uint32_t arg;
+    uint8_t type;
+} event_t;
+
+typedef struct {
+    uint32_t head;
+    uint32_t tail;
+    bool busy;                        // MAC working on the head frame
+    bool acked;
+    uint8_t nb;
+    uint8_t be;
+    uint8_t retries;
+} station_t;
+
+typedef struct {
+    bool used;
+    bool collided;
+    uint64_t start_us;
+    uint64_t end_us;
+    uint32_t station;                 // Transmitter
+    uint32_t frame;                   // Data frame, or the frame being acknowledged
+} tx_t;
+
+typedef struct {
+    uint32_t frame;
+    uint64_t queued_us;
+} indirect_entry_t;
+
+typedef struct {
+    const fleet_sim_config_t *cfg;
+    fleet_sim_result_t *res;
+    frame_vec_t frames;
+    station_t *stations;
+    uint32_t coordinator;             // Station index of the coordinator
+
+    event_t *heap;
+    size_t heap_count;
+    size_t heap_cap;
+    uint64_t event_seq;
+
+    tx_t txs[TX_POOL_SIZE];
+    uint32_t active[TX_POOL_SIZE];
+    uint32_t active_count;
+
+    indirect_entry_t *indirect;
+    uint32_t indirect_count;
+
+    uint32_t *busy_per_sec;           // Airtime (us) per 1 s bucket
+    uint64_t busy_secs;
+    uint64_t busy_total_us;
+    uint64_t busy_until_us;
+
+    double *latencies;
+    uint64_t latency_count;
+
+    uint32_t rng;
+    bool oom;
+} channel_t;
+
+static uint32_t rng_next(uint32_t *state)
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static float rng_uniform(uint32_t *state)
+{
+    return (float)(rng_next(state) >> 8) / 16777216.0f;
+}
+
+static uint64_t airtime_us(uint32_t mpdu)
+{
+    return (uint64_t)(PHY_OVERHEAD + mpdu) * BYTE_US;
+}
+
+// ---------------------------------------------------------------- events
+
+static bool event_before(const event_t *a, const event_t *b)
+{
+    return a->time_us < b->time_us || (a->time_us == b->time_us && a->seq < b->seq);
+}
+
+static void schedule(channel_t *ch, uint64_t time_us, event_type_t type, uint32_t station, uint32_t arg)
+{
+    if (ch->heap_count == ch->heap_cap) {
+        size_t cap = ch->heap_cap ? ch->heap_cap * 2 : 1024;
+        event_t *heap = realloc(ch->heap, cap * sizeof(*heap));
+        if (!heap) {
+            ch->oom = true;
+            return;
+        }
+        ch->heap = heap;
+        ch->heap_cap = cap;
+    }
+    size_t i = ch->heap_count++;
+    event_t ev = { time_us, ch->event_seq++, station, arg, (uint8_t)type };
+    while (i > 0) {
+        size_t parent = (i - 1) / 2;
+        if (!event_before(&ev, &ch->heap[parent])) {
+            break;
+        }
+        ch->heap[i] = ch->heap[parent];
+        i = parent;
+    }
+    ch->heap[i] = ev;
+}
+
+static event_t pop_event(channel_t *ch)
+{
+    event_t top = ch->heap[0];
+    event_t last = ch->heap[--ch->heap_count];
+    size_t i = 0;
+    for (;;) {
+        size_t child = 2 * i + 1;
+        if (child >= ch->heap_count) {
+            break;
+        }
+        if (child + 1 < ch->heap_count && event_before(&ch->heap[child + 1], &ch->heap[child])) {
+            child++;
+        }
+        if (!event_before(&ch->heap[child], &last)) {
+            break;
+        }
+        ch->heap[i] = ch->heap[child];
+        i = child;
+    }
+    if (ch->heap_count > 0) {
+        ch->heap[i] = last;
+    }
+    return top;
+}
+
+// ---------------------------------------------------------------- airtime
+
+static void prune_active(channel_t *ch, uint64_t now)
+{
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < ch->active_count; i++) {
+        if (ch->txs[ch->active[i]].end_us > now) {
+            ch->active[n++] = ch->active[i];
+        }
+    }
+    ch->active_count = n;
+}
+
+static bool channel_busy(channel_t *ch, uint64_t now)
+{
+    prune_active(ch, now);
+    for (uint32_t i = 0; i < ch->active_count; i++) {
+        if (ch->txs[ch->active[i]].start_us <= now) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Time the channel is occupied (overlapping transmissions count once)
+ */
+static void account_airtime(channel_t *ch, uint64_t start_us, uint64_t end_us)
+{
+    if (start_us < ch->busy_until_us) {
+        start_us = ch->busy_until_us;
+    }
+    if (end_us <= start_us) {
+        return;
+    }
+    ch->busy_until_us = end_us;
+    ch->busy_total_us += end_us - start_us;
+    uint64_t sec = start_us / 1000000ULL;
+    if (sec < ch->busy_secs) {
+        ch->busy_per_sec[sec] += (uint32_t)(end_us - start_us);
+    }
+}
+
+/**
+ * @brief Put a transmission on the air; overlapping transmissions are all lost
+ * @return Pool index, or TX_POOL_SIZE if the pool is exhausted
+ */
+static uint32_t start_tx(channel_t *ch, uint64_t now, uint32_t station, uint32_t frame, uint64_t dur_us)
+{
+    uint32_t id = 0;
+    while (id < TX_POOL_SIZE && ch->txs[id].used) {
+        id++;
+    }
+    if (id == TX_POOL_SIZE) {
+        ch->oom = true;
+        return id;
+    }
+    prune_active(ch, now);
+    tx_t *tx = &ch->txs[id];
+    *tx = (tx_t){ .used = true, .start_us = now, .end_us = now + dur_us, .station = station, .frame = frame };
+    for (uint32_t i = 0; i < ch->active_count; i++) {
+        tx_t *other = &ch->txs[ch->active[i]];
+        if (!other->collided) {
+            ch->res->collisions++;
+        }
+        if (!tx->collided) {
+            ch->res->collisions++;
+        }
+        other->collided = true;
+        tx->collided = true;
+    }
+    ch->active[ch->active_count++] = id;
+    account_airtime(ch, now, now + dur_us);
+    return id;
+}
+
+// ---------------------------------------------------------------- indirect queue
+
+static void indirect_expire(channel_t *ch, uint64_t now)
+{
+    uint64_t timeout_us = (uint64_t)ch->cfg->indirect_timeout_ms * 1000ULL;
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < ch->indirect_count; i++) {
+        if (now - ch->indirect[i].queued_us > timeout_us) {
+            ch->res->indirect_expired++;
+        } else {
+            ch->indirect[n++] = ch->indirect[i];
+        }
+    }
+    ch->indirect_count = n;
+}
+
+static void indirect_push(channel_t *ch, uint64_t now, uint32_t node, frame_kind_t kind, uint32_t mpdu)
+{
+    indirect_expire(ch, now);
+    if (ch->indirect_count >= ch->cfg->indirect_capacity) {
+        ch->res->indirect_overflow++;
+        return;
+    }
+    fleet_frame_t *f = frame_push(&ch->frames, now, node, kind, mpdu, true);
+    if (!f) {
+        ch->oom = true;
+        return;
+    }
+    ch->indirect[ch->indirect_count++] = (indirect_entry_t){ (uint32_t)(f - ch->frames.items), now };
+    ch->res->indirect_queued++;
+    if (ch->indirect_count > ch->res->indirect_peak) {
+        ch->res->indirect_peak = ch->indirect_count;
+    }
+}
+
+// ---------------------------------------------------------------- MAC
+
+static void start_csma(channel_t *ch, uint32_t s, uint64_t now)
+{
+    station_t *st = &ch->stations[s];
+    st->nb = 0;
+    st->be = ch->cfg->min_be;
+    uint32_t slots = rng_next(&ch->rng) % (1u << st->be);
+    schedule(ch, now + (uint64_t)slots * UNIT_BACKOFF_US, EV_BACKOFF_END, s, 0);
+}
+
+static void station_enqueue(channel_t *ch, uint32_t s, uint32_t frame, uint64_t now)
+{
+    station_t *st = &ch->stations[s];
+    ch->frames.items[frame].next = NO_FRAME;
+    if (st->head == NO_FRAME) {
+        st->head = frame;
+    } else {
+        ch->frames.items[st->tail].next = frame;
+    }
+    st->tail = frame;
+    ch->res->frames++;
+    if (!st->busy) {
+        st->busy = true;
+        st->retries = 0;
+        start_csma(ch, s, now);
+    }
+}
+
+static void frame_done(channel_t *ch, uint32_t s, uint64_t now, bool delivered)
+{
+    station_t *st = &ch->stations[s];
+    fleet_frame_t *f = &ch->frames.items[st->head];
+    if (f->kind == FRAME_REPORT) {
+        ch->res->reports++;
+        if (delivered) {
+            ch->res->reports_delivered++;
+            ch->latencies[ch->latency_count++] = (double)(now - f->ready_us) / 1000.0;
+        }
+    }
+    st->head = f->next;
+    if (st->head == NO_FRAME) {
+        st->tail = NO_FRAME;
+        st->busy = false;
+        return;
+    }
+    st->retries = 0;
+    start_csma(ch, s, now);
+}
+
+/**
+ * @brief First reception of a frame by its destination
+ */
+static void on_received(channel_t *ch, fleet_frame_t *f, uint64_t now)
+{
+    f->received = true;
+    if (f->downlink) {
+        ch->res->indirect_delivered++;
+        return;
+    }
+    uint32_t node = f->node;
+    switch (f->kind) {
+    case FRAME_REPORT:
+        if (ch->cfg->aps_ack) {
+            indirect_push(ch, now, node, FRAME_APS_ACK, MPDU_APS_ACK);
+        }
+        break;
+    case FRAME_REJOIN:
+        indirect_push(ch, now, node, FRAME_REJOIN_RSP, MPDU_REJOIN_RSP);
+        break;
+    case FRAME_POLL:
+        // Frame pending: the coordinator sends the oldest entry for this node
+        indirect_expire(ch, now);
+        for (uint32_t i = 0; i < ch->indirect_count; i++) {
+            uint32_t frame = ch->indirect[i].frame;
+            if (ch->frames.items[frame].node == node) {
+                memmove(&ch->indirect[i], &ch->indirect[i + 1],
+                        (ch->indirect_count - i - 1) * sizeof(ch->indirect[0]));
+                ch->indirect_count--;
+                // Contention starts once the coordinator has sent the poll's ack
+                station_enqueue(ch, ch->coordinator, frame, now + TURNAROUND_US + airtime_us(MPDU_ACK));
+                break;
+            }
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+static void handle_event(channel_t *ch, const event_t *ev)
+{
+    uint64_t now = ev->time_us;
+    station_t *st = &ch->stations[ev->station];
+
+    switch (ev->type) {
+    case EV_BACKOFF_END:
+        ch->res->cca_checks++;
+        if (channel_busy(ch, now)) {
+            ch->res->cca_busy++;
+            st->nb++;
+            if (st->be < ch->cfg->max_be) {
+                st->be++;
+            }
+            if (st->nb > ch->cfg->max_csma_backoffs) {
+                ch->res->csma_failures++;
+                frame_done(ch, ev->station, now, false);
+                break;
+            }
+            uint32_t slots = rng_next(&ch->rng) % (1u << st->be);
+            schedule(ch, now + (uint64_t)slots * UNIT_BACKOFF_US, EV_BACKOFF_END, ev->station, 0);
+        } else {
+            schedule(ch, now + CCA_US + TURNAROUND_US, EV_TX_START, ev->station, 0);
+        }
+        break;
+
+    case EV_TX_START: {
+        fleet_frame_t *f = &ch->frames.items[st->head];
+        ch->res->attempts++;
+        st->acked = false;
+        uint32_t tx = start_tx(ch, now, ev->station, st->head, airtime_us(f->mpdu));
+        if (tx < TX_POOL_SIZE) {
+            schedule(ch, ch->txs[tx].end_us, EV_TX_END, ev->station, tx);
+        }
+        break;
+    }
+
+    case EV_TX_END: {
+        tx_t *tx = &ch->txs[ev->arg];
+        uint32_t frame = tx->frame;
+        bool ok = !tx->collided;
+        tx->used = false;
+        if (ok) {
+            fleet_frame_t *f = &ch->frames.items[frame];
+            uint32_t receiver = f->downlink ? f->node : ch->coordinator;
+            if (!f->received) {
+                on_received(ch, f, now);
+            }
+            schedule(ch, now + TURNAROUND_US, EV_ACK_START, receiver, ev->station);
+        }
+        schedule(ch, now + ACK_WAIT_US, EV_ACK_WAIT_END, ev->station, 0);
+        break;
+    }
+
+    case EV_ACK_START: {
+        uint32_t tx = start_tx(ch, now, ev->station, ev->arg, airtime_us(MPDU_ACK));
+        if (tx < TX_POOL_SIZE) {
+            schedule(ch, ch->txs[tx].end_us, EV_ACK_END, ev->station, tx);
+        }
+        break;
+    }
+
+    case EV_ACK_END: {
+        tx_t *tx = &ch->txs[ev->arg];
+        if (!tx->collided) {
+            ch->stations[tx->frame].acked = true;   // tx->frame: the acknowledged station
+        }
+        tx->used = false;
+        break;
+    }
+
+    case EV_ACK_WAIT_END:
+        if (st->acked) {
+            frame_done(ch, ev->station, now, true);
+        } else if (st->retries < ch->cfg->max_frame_retries) {
+            st->retries++;
+            ch->res->retries++;
+            start_csma(ch, ev->station, now);
+        } else {
+            ch->res->retry_failures++;
+            frame_done(ch, ev->station, now, false);
+        }
+        break;
+    }
+}
+
+static int cmp_double(const void *a, const void *b)
+{
+    double da = *(const double *)a, db = *(const double *)b;
+    return (da > db) - (da < db);
+}
+
+/**
+ * @brief Replay the uplink frames (sorted) through the channel
+ */
+static esp_err_t run_channel(channel_t *ch, size_t uplink_count, uint64_t horizon_us)
+{
+    const fleet_sim_config_t *cfg = ch->cfg;
+    uint32_t station_count = cfg->nodes + 1;
+    ch->coordinator = cfg->nodes;
+    ch->stations = calloc(station_count, sizeof(station_t));
+    ch->indirect = calloc(cfg->indirect_capacity ? cfg->indirect_capacity : 1, sizeof(indirect_entry_t));
+    ch->latencies = calloc(uplink_count ? uplink_count : 1, sizeof(double));
+    ch->busy_secs = horizon_us / 1000000ULL + 2;
+    ch->busy_per_sec = calloc(ch->busy_secs, sizeof(uint32_t));
+    if (!ch->stations || !ch->indirect || !ch->latencies || !ch->busy_per_sec) {
+        return ESP_ERR_NO_MEM;
+    }
+    for (uint32_t i = 0; i < station_count; i++) {
+        ch->stations[i].head = ch->stations[i].tail = NO_FRAME;
+    }
+
+    size_t next = 0;
+    uint64_t last_us = 0;
+    while (next < uplink_count || ch->heap_count > 0) {
+        bool take_frame = next < uplink_count &&
+                          (ch->heap_count == 0 || ch->frames.items[next].ready_us <= ch->heap[0].time_us);
+        if (take_frame) {
+            last_us = ch->frames.items[next].ready_us;
+            station_enqueue(ch, ch->frames.items[next].node, (uint32_t)next, last_us);
+            next++;
+        } else {
+            event_t ev = pop_event(ch);
+            last_us = ev.time_us;
+            handle_event(ch, &ev);
+        }
+        if (ch->oom) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    indirect_expire(ch, UINT64_MAX / 2);
+    ch->res->indirect_expired += ch->indirect_count;
+    ch->indirect_count = 0;
+
+    fleet_sim_result_t *res = ch->res;
+    double span_us = (double)(last_us > horizon_us ? last_us : horizon_us);
+    res->utilization = span_us > 0 ? (double)ch->busy_total_us / span_us : 0.0;
+    uint32_t peak = 0;
+    for (uint64_t i = 0; i < ch->busy_secs; i++) {
+        if (ch->busy_per_sec[i] > peak) {
+            peak = ch->busy_per_sec[i];
+        }
+    }
+    res->peak_utilization = peak / 1e6;
+
+    if (ch->latency_count) {
+        qsort(ch->latencies, ch->latency_count, sizeof(double), cmp_double);
+        double sum = 0.0;
+        for (uint64_t i = 0; i < ch->latency_count; i++) {
+            sum += ch->latencies[i];
+        }
+        res->latency_mean_ms = sum / ch->latency_count;
+        res->latency_p50_ms = ch->latencies[ch->latency_count / 2];
+        res->latency_p99_ms = ch->latencies[(ch->latency_count * 99) / 100];
+        res->latency_max_ms = ch->latencies[ch->latency_count - 1];
+    }
+    return ESP_OK;
+}
+
+static void channel_free(channel_t *ch)
+{
+    free(ch->frames.items);
+    free(ch->stations);
+    free(ch->heap);
+    free(ch->indirect);
+    free(ch->busy_per_sec);
+    free(ch->latencies);
+}
+
+// ============================================================================
+// PUBLIC FUNCTIONS
+// ============================================================================
+
+void fleet_sim_default_config(fleet_sim_config_t *config)
+{
+    memset(config, 0, sizeof(*config));
+    config->nodes = 50;
+    config->days = 7;
+    config->seed = 1;
+    config->start_spread_s = 3600.0f;
+    config->env_jitter = 0.25f;
+    wake_sim_default_config(&config->node);
+
+    config->poll_interval_ms = ED_KEEP_ALIVE;
+    config->aps_ack = true;
+    config->indirect_capacity = 16;
+    config->indirect_timeout_ms = 7680;       // 802.15.4 default persistence (2.4 GHz)
+    config->max_csma_backoffs = 4;
+    config->min_be = 3;
+    config->max_be = 5;
+    config->max_frame_retries = 3;
+}
+
+esp_err_t fleet_sim_run(const fleet_sim_config_t *config, fleet_sim_result_t *result)
+{
+    memset(result, 0, sizeof(*result));
+    result->nodes = config->nodes;
+    result->days = config->days;
+
+    channel_t *ch = calloc(1, sizeof(*ch));
+    if (!ch) {
+        return ESP_ERR_NO_MEM;
+    }
+    ch->cfg = config;
+    ch->res = result;
+    ch->rng = config->seed ? config->seed : 0x2545F491u;
+
+    // Phase 1: every node on its own, collecting its frames
+    uint32_t rng = ch->rng ^ 0xA5A5A5A5u;
+    uint64_t horizon_us = 0;
+    esp_err_t ret = ESP_OK;
+    for (uint32_t n = 0; n < config->nodes && ret == ESP_OK; n++) {
+        node_capture_t cap = {
+            .frames = &ch->frames,
+            .node = n,
+            .offset_us = (uint64_t)(rng_uniform(&rng) * config->start_spread_s * 1e6f),
+            .poll_us = (uint64_t)(config->poll_interval_ms ? config->poll_interval_ms : 1000) * 1000ULL,
+        };
+        wake_sim_config_t node = config->node;
+        node.days = config->days;
+        node.seed = config->seed * 7919u + n + 1;
+        node.sensor.seed = node.seed;
+        float jitter = 1.0f + config->env_jitter * (2.0f * rng_uniform(&rng) - 1.0f);
+        node.drying_pct_per_day *= jitter;
+        node.watering_interval_days *= jitter;
+        node.zb_event_hook = capture_hook;
+        node.zb_event_ctx = &cap;
+
+        wake_sim_result_t node_res;
+        ret = wake_sim_run(&node, &node_res);
+        if (cap.oom) {
+            ret = ESP_ERR_NO_MEM;
+        }
+        result->awake_s_per_day_mean += node_res.awake_s_per_day / config->nodes;
+        result->mah_per_day_mean += node_res.mah_per_day / config->nodes;
+        if (node_res.awake_s_per_day > result->awake_s_per_day_max) {
+            result->awake_s_per_day_max = node_res.awake_s_per_day;
+        }
+        if (node_res.mah_per_day > result->mah_per_day_max) {
+            result->mah_per_day_max = node_res.mah_per_day;
+        }
+        uint64_t end_us = (uint64_t)(node_res.days * 86400e6) + cap.offset_us;
+        if (end_us > horizon_us) {
+            horizon_us = end_us;
+        }
+    }
+
+    // Phase 2: all frames through one channel
+    if (ret == ESP_OK) {
+        size_t uplink_count = ch->frames.count;
+        qsort(ch->frames.items, uplink_count, sizeof(fleet_frame_t), frame_order);
+        ret = run_channel(ch, uplink_count, horizon_us);
+    }
+
+    channel_free(ch);
+    free(ch);
+    return ret;
+}
@@ -0,0 +1,102 @@
+/*
+ * Glyph C6 Monitor - Fleet Reporting Simulator
+ *
+ * Version: 1.0.0
+ *
+ * N end devices running the host build of the deep-sleep firmware share
+ * one 802.15.4 channel with their parent (the coordinator):
+ *
+ * 1. Every node runs through the wake-cycle simulator with its own seed,
+ *    soil model and power-on time; its stack activity (rejoin, data polls
+ *    while joined, attribute reports) becomes a list of frames.
+ * 2. All frames are replayed through an unslotted CSMA/CA channel model
+ *    (backoff, CCA, turnaround, collisions, acknowledgements, frame
+ *    retries) and a coordinator that keeps downlink frames (APS acks,
+ *    rejoin responses) in an indirect queue until the node polls.
+ *
+ * The two phases are exact for the current firmware: it never looks at
+ * report delivery, so the channel cannot change what a node does. Joins
+ * are the exception - rejoin latency and failures come from the node
+ * model, not from the channel.
+ */
+
+#ifndef FLEET_SIM_H
+#define FLEET_SIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "wake_sim.h"
+
+typedef struct {
+    uint32_t nodes;
+    uint32_t days;
+    uint32_t seed;
+    float start_spread_s;             // Power-on times spread uniformly over this window
+    float env_jitter;                 // Relative per-node spread of drying rate / watering
+
+    wake_sim_config_t node;           // Node model (seed and soil varied per node)
+
+    // Coordinator (parent of every node) and MAC
+    uint32_t poll_interval_ms;        // Data poll period while joined
+    bool aps_ack;                     // Coordinator acknowledges each report (indirect)
+    uint16_t indirect_capacity;       // Pending downlink frames
+    uint32_t indirect_timeout_ms;     // macTransactionPersistenceTime
+    uint8_t max_csma_backoffs;        // macMaxCSMABackoffs
+    uint8_t min_be;                   // macMinBE
+    uint8_t max_be;                   // macMaxBE
+    uint8_t max_frame_retries;        // macMaxFrameRetries
+} fleet_sim_config_t;
+
+typedef struct {
+    uint32_t nodes;
+    double days;
+
+    // Channel
+    double utilization;               // Airtime / time (frames + acks)
+    double peak_utilization;          // Busiest 1 s window
+    uint64_t frames;                  // Frames handed to the MAC
+    uint64_t attempts;                // Transmissions (incl. retries)
+    uint64_t cca_checks;
+    uint64_t cca_busy;
+    uint64_t collisions;              // Transmissions lost to overlap
+    uint64_t retries;
+    uint64_t csma_failures;           // Channel access failures
+    uint64_t retry_failures;          // No ack after all retries
+
+    // Reports (uplink, end to end)
+    uint64_t reports;
+    uint64_t reports_delivered;
+    double latency_mean_ms;
+    double latency_p50_ms;
+    double latency_p99_ms;
+    double latency_max_ms;
+
+    // Coordinator indirect queue
+    uint64_t indirect_queued;
+    uint64_t indirect_delivered;
+    uint64_t indirect_expired;        // Node slept before polling it out
+    uint64_t indirect_overflow;
+    uint32_t indirect_peak;
+
+    // Nodes
+    double awake_s_per_day_mean;
+    double awake_s_per_day_max;
+    double mah_per_day_mean;
+    double mah_per_day_max;
+} fleet_sim_result_t;
+
+/**
+ * @brief 802.15.4 / Zigbee defaults, 50 nodes powered on within an hour
+ */
+void fleet_sim_default_config(fleet_sim_config_t *config);
+
+/**
+ * @brief Simulate the fleet
+ * @param config Fleet, node and channel model
+ * @param result Channel, delivery, queue and per-node figures
+ * @return ESP_OK, ESP_ERR_NO_MEM, or ESP_FAIL if a node stopped deep sleeping
+ */
+esp_err_t fleet_sim_run(const fleet_sim_config_t *config, fleet_sim_result_t *result);
+
+#endif // FLEET_SIM_H
@@ -0,0 +1,200 @@
+/*
+ * Glyph C6 Monitor - Green Power Sink Simulator
+ *
+ * Version: 1.0.0
+ */
+
+#include "gp_sink.h"
+#include "mbedtls/ccm.h"
+#include <string.h>
+
+#define NONCE_LEN            13
+#define NONCE_SEC_CONTROL    0x05
+#define MAC_HEADER_LEN       7        // FCF, seq, dst PAN, dst addr
+#define NWK_HEADER_LEN       6        // NWK FC, ext FC, SrcID
+#define COMMISSION_LEN       28       // Command byte included
+
+// "ZigBeeAlliance09"
+static const uint8_t tc_link_key[GP_SINK_KEY_LEN] = {
+    0x5A, 0x69, 0x67, 0x42, 0x65, 0x65, 0x41, 0x6C, 0x6C, 0x69, 0x61, 0x6E, 0x63, 0x65, 0x30, 0x39,
+};
+
+static uint16_t get_u16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void put_u32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static void make_nonce(uint8_t nonce[NONCE_LEN], uint32_t src_id, uint32_t counter)
+{
+    put_u32(&nonce[0], src_id);
+    put_u32(&nonce[4], src_id);
+    put_u32(&nonce[8], counter);
+    nonce[12] = NONCE_SEC_CONTROL;
+}
+
+static bool ccm_check(const uint8_t *key, const uint8_t *nonce, const uint8_t *ad, size_t ad_len,
+                      const uint8_t *in, uint8_t *out, size_t len, const uint8_t *mic)
+{
+    mbedtls_ccm_context ccm;
+    mbedtls_ccm_init(&ccm);
+    int ret = mbedtls_ccm_setkey(&ccm, MBEDTLS_CIPHER_ID_AES, key, GP_SINK_KEY_LEN * 8);
+    if (ret == 0) {
+        ret = mbedtls_ccm_auth_decrypt(&ccm, len, nonce, NONCE_LEN, ad, ad_len, in, out, mic, GP_MIC_LEN);
+    }
+    mbedtls_ccm_free(&ccm);
+    return ret == 0;
+}
+
+static float rng_uniform(gp_sink_t *sink)
+{
+    uint32_t x = sink->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    sink->rng = x;
+    return (float)(x >> 8) / 16777216.0f;
+}
+
+static gp_sink_result_t count(gp_sink_t *sink, gp_sink_result_t result)
+{
+    switch (result) {
+    case GP_SINK_COMMISSIONED: sink->stats.commissioned++; break;
+    case GP_SINK_READING:      sink->stats.readings++; break;
+    case GP_SINK_DUPLICATE:    sink->stats.duplicates++; break;
+    case GP_SINK_REJECTED:     sink->stats.rejected++; break;
+    default:                   sink->stats.ignored++; break;
+    }
+    return result;
+}
+
+/**
+ * @brief Commissioning frame (p: command byte onwards)
+ */
+static gp_sink_result_t commission(gp_sink_t *sink, uint32_t src_id, const uint8_t *p, size_t len)
+{
+    if (!sink->commissioning || len < COMMISSION_LEN ||
+        p[1] != GP_DEVICE_ID || p[3] != GP_COMMISSION_EXT_OPTIONS) {
+        return GP_SINK_IGNORED;
+    }
+    uint8_t nonce[NONCE_LEN];
+    make_nonce(nonce, src_id, src_id);
+    uint8_t src[4];
+    put_u32(src, src_id);
+    uint8_t key[GP_SINK_KEY_LEN];
+    if (!ccm_check(tc_link_key, nonce, src, sizeof(src), &p[4], key, GP_SINK_KEY_LEN, &p[20])) {
+        return GP_SINK_REJECTED;
+    }
+
+    uint32_t counter = get_u32(&p[24]);
+    bool same = sink->paired && sink->src_id == src_id && memcmp(sink->key, key, sizeof(key)) == 0;
+    if (same && counter == sink->commissioned_counter) {
+        return GP_SINK_DUPLICATE;         // Repeated copy
+    }
+    sink->paired = true;
+    sink->src_id = src_id;
+    memcpy(sink->key, key, sizeof(key));
+    // Data frames start at the announced counter
+    sink->commissioned_counter = counter;
+    sink->next_counter = counter;
+    return GP_SINK_COMMISSIONED;
+}
+
+static void decode_reading(const uint8_t *p, gp_reading_t *r)
+{
+    r->flags = p[0];
+    r->moisture_centi = get_u16(&p[1]);
+    r->temp_centi = (int16_t)get_u16(&p[3]);
+    r->battery_decivolts = p[5];
+    r->battery_half_pct = p[6];
+    r->watering_events = get_u16(&p[7]);
+    r->age_sec = get_u16(&p[9]);
+}
+
+// ============================================================================
+// PUBLIC FUNCTIONS
+// ============================================================================
+
+void gp_sink_init(gp_sink_t *sink)
+{
+    memset(sink, 0, sizeof(*sink));
+    sink->rng = 0x9E3779B9u;
+}
+
+void gp_sink_set_commissioning(gp_sink_t *sink, bool enable)
+{
+    sink->commissioning = enable;
+}
+
+void gp_sink_set_loss(gp_sink_t *sink, float probability, uint32_t seed)
+{
+    sink->loss = probability;
+    sink->rng = seed ? seed : 0x9E3779B9u;
+}
+
+gp_sink_result_t gp_sink_receive(gp_sink_t *sink, const uint8_t *psdu, size_t len, gp_reading_t *reading)
+{
+    if (len < MAC_HEADER_LEN + NWK_HEADER_LEN + 1 || get_u16(psdu) != GP_MAC_FCF ||
+        psdu[MAC_HEADER_LEN] != GP_NWK_FC) {
+        return count(sink, GP_SINK_IGNORED);
+    }
+    const uint8_t *nwk = &psdu[MAC_HEADER_LEN];
+    uint8_t ext_fc = nwk[1];
+    uint32_t src_id = get_u32(&nwk[2]);
+    const uint8_t *p = &nwk[NWK_HEADER_LEN];
+    size_t rest = len - MAC_HEADER_LEN - NWK_HEADER_LEN;
+
+    if (ext_fc == GP_EXT_NWK_FC_PLAIN) {
+        if (p[0] != GP_CMD_COMMISSIONING) {
+            return count(sink, GP_SINK_IGNORED);
+        }
+        return count(sink, commission(sink, src_id, p, rest));
+    }
+    if (ext_fc != GP_EXT_NWK_FC_SECURED || !sink->paired || src_id != sink->src_id ||
+        rest < 4 + 1 + GP_MIC_LEN) {
+        return count(sink, GP_SINK_IGNORED);
+    }
+
+    // Level 2: MIC over NWK header, counter and payload
+    uint32_t counter = get_u32(p);
+    size_t ad_len = NWK_HEADER_LEN + rest - GP_MIC_LEN;
+    uint8_t nonce[NONCE_LEN];
+    make_nonce(nonce, src_id, counter);
+    if (!ccm_check(sink->key, nonce, nwk, ad_len, NULL, NULL, 0, &psdu[len - GP_MIC_LEN])) {
+        return count(sink, GP_SINK_REJECTED);
+    }
+    if (counter < sink->next_counter) {
+        return count(sink, GP_SINK_DUPLICATE);
+    }
+    sink->next_counter = counter + 1;
+
+    if (p[4] != GP_CMD_READING || rest - 5 - GP_MIC_LEN < GP_READING_LEN) {
+        return count(sink, GP_SINK_IGNORED);
+    }
+    decode_reading(&p[5], &sink->last_reading);
+    if (reading) {
+        *reading = sink->last_reading;
+    }
+    return count(sink, GP_SINK_READING);
+}
+
+void gp_sink_tx_hook(const host_ieee802154_frame_t *frame, void *ctx)
+{
+    gp_sink_t *sink = ctx;
+    if (sink->loss > 0.0f && rng_uniform(sink) < sink->loss) {
+        return;
+    }
+    gp_sink_receive(sink, frame->psdu, frame->len, NULL);
+}
@@ -0,0 +1,88 @@
+/*
+ * Glyph C6 Monitor - Green Power Sink Simulator
+ *
+ * Version: 1.0.0
+ *
+ * Reference receiver for the frames gp_uplink.c sends, doing what a GP
+ * sink on the coordinator side does with them:
+ *
+ * - In commissioning mode, accepts a GP Commissioning frame: decrypts the
+ *   GPD key with the Zigbee default link key, checks its MIC and stores
+ *   the SrcID, key and frame counter
+ * - Checks the MIC of every secured data frame against the stored key
+ * - Drops frames whose counter is not above the last accepted one, which
+ *   covers both the repeated copies of a frame and replays
+ *
+ * Feed it from host_ieee802154_set_tx_hook(), or frame by frame.
+ */
+
+#ifndef GP_SINK_H
+#define GP_SINK_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "host_sim.h"
+#include "gp_uplink.h"
+
+#define GP_SINK_KEY_LEN     16
+
+typedef enum {
+    GP_SINK_IGNORED = 0,              // Not a GPDF, unknown SrcID, or commissioning while not in mode
+    GP_SINK_COMMISSIONED,             // SrcID paired (or re-paired)
+    GP_SINK_READING,                  // Authentic reading, decoded
+    GP_SINK_DUPLICATE,                // Repeated copy or replayed counter
+    GP_SINK_REJECTED,                 // MIC check failed
+} gp_sink_result_t;
+
+typedef struct {
+    uint32_t commissioned;
+    uint32_t readings;
+    uint32_t duplicates;
+    uint32_t rejected;
+    uint32_t ignored;
+} gp_sink_stats_t;
+
+typedef struct {
+    bool commissioning;               // Accepts commissioning frames
+    bool paired;
+    uint32_t src_id;
+    uint8_t key[GP_SINK_KEY_LEN];
+    uint32_t next_counter;            // Lowest frame counter still accepted
+    uint32_t commissioned_counter;    // Counter of the last commissioning frame
+    float loss;                       // Probability a copy is not received
+    uint32_t rng;
+    gp_reading_t last_reading;
+    gp_sink_stats_t stats;
+} gp_sink_t;
+
+/**
+ * @brief Empty sink, not in commissioning mode, no loss
+ */
+void gp_sink_init(gp_sink_t *sink);
+
+/**
+ * @brief Enter or leave commissioning mode
+ */
+void gp_sink_set_commissioning(gp_sink_t *sink, bool enable);
+
+/**
+ * @brief Independent loss of each received copy (seeded, reproducible)
+ */
+void gp_sink_set_loss(gp_sink_t *sink, float probability, uint32_t seed);
+
+/**
+ * @brief Process one MAC frame (PSDU without the FCS)
+ * @param sink Sink
+ * @param psdu MAC frame
+ * @param len Length in bytes
+ * @param reading Decoded reading for GP_SINK_READING (optional)
+ */
+gp_sink_result_t gp_sink_receive(gp_sink_t *sink, const uint8_t *psdu, size_t len, gp_reading_t *reading);
+
+/**
+ * @brief host_ieee802154 transmit hook: ctx is the gp_sink_t
+ */
+void gp_sink_tx_hook(const host_ieee802154_frame_t *frame, void *ctx);
+
+#endif // GP_SINK_H
@@ -0,0 +1,769 @@
+/*
+ * Glyph C6 Monitor - RV32IMAC Instruction Set Simulator
+ *
+ * Version: 1.0.0
+ */
+
+#include "rv32_iss.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define EM_RISCV        243
+#define PT_LOAD         1
+#define SHT_SYMTAB      2
+#define STT_FUNC        2
+
+#define CSR_CYCLE       0xC00
+#define CSR_TIME        0xC01
+#define CSR_INSTRET     0xC02
+#define CSR_CYCLEH      0xC80
+#define CSR_TIMEH       0xC81
+#define CSR_INSTRETH    0xC82
+#define CSR_MCYCLE      0xB00
+#define CSR_MINSTRET    0xB02
+
+// ============================================================================
+// MEMORY
+// ============================================================================
+
+static bool mem_ok(const rv32_iss_t *iss, uint32_t addr, uint32_t len)
+{
+    return addr >= iss->mem_base && (uint64_t)addr + len <= (uint64_t)iss->mem_base + iss->mem_size;
+}
+
+static void fault(rv32_iss_t *iss, uint32_t insn)
+{
+    iss->stop = RV32_STOP_FAULT;
+    iss->fault_pc = iss->pc;
+    iss->fault_insn = insn;
+}
+
+static bool load(rv32_iss_t *iss, uint32_t addr, uint32_t len, uint32_t *value)
+{
+    if (!mem_ok(iss, addr, len)) {
+        return false;
+    }
+    const uint8_t *p = iss->mem + (addr - iss->mem_base);
+    uint32_t v = 0;
+    for (uint32_t i = 0; i < len; i++) {
+        v |= (uint32_t)p[i] << (8 * i);
+    }
+    *value = v;
+    return true;
+}
+
+static bool store(rv32_iss_t *iss, uint32_t addr, uint32_t len, uint32_t value)
+{
+    if (!mem_ok(iss, addr, len)) {
+        return false;
+    }
+    uint8_t *p = iss->mem + (addr - iss->mem_base);
+    for (uint32_t i = 0; i < len; i++) {
+        p[i] = (uint8_t)(value >> (8 * i));
+    }
+    if (iss->reserved && addr <= iss->reservation + 3 && iss->reservation <= addr + len - 1) {
+        iss->reserved = false;
+    }
+    return true;
+}
+
+bool rv32_iss_write_mem(rv32_iss_t *iss, uint32_t addr, const void *data, size_t len)
+{
+    if (len > UINT32_MAX || !mem_ok(iss, addr, (uint32_t)len)) {
+        return false;
+    }
+    memcpy(iss->mem + (addr - iss->mem_base), data, len);
+    return true;
+}
+
+// ============================================================================
+// SYMBOLS AND REGIONS
+// ============================================================================
+
+static size_t symbol_index(rv32_iss_t *iss, uint32_t addr)
+{
+    if (iss->last_symbol < iss->symbol_count) {
+        const rv32_symbol_t *s = &iss->symbols[iss->last_symbol];
+        if (addr >= s->addr && addr - s->addr < s->size) {
+            return iss->last_symbol;
+        }
+    }
+    size_t lo = 0, hi = iss->symbol_count;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (iss->symbols[mid].addr <= addr) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo == 0) {
+        return SIZE_MAX;
+    }
+    const rv32_symbol_t *s = &iss->symbols[lo - 1];
+    if (addr - s->addr >= s->size) {
+        return SIZE_MAX;
+    }
+    iss->last_symbol = lo - 1;
+    return lo - 1;
+}
+
+esp_err_t rv32_iss_add_symbol(rv32_iss_t *iss, const char *name, uint32_t addr, uint32_t size)
+{
+    rv32_symbol_t *grown = realloc(iss->symbols, (iss->symbol_count + 1) * sizeof(rv32_symbol_t));
+    if (!grown) {
+        return ESP_ERR_NO_MEM;
+    }
+    iss->symbols = grown;
+
+    // Keep sorted by address (symbol tables are mostly sorted already)
+    size_t at = iss->symbol_count;
+    while (at > 0 && iss->symbols[at - 1].addr > addr) {
+        iss->symbols[at] = iss->symbols[at - 1];
+        at--;
+    }
+    rv32_symbol_t *s = &iss->symbols[at];
+    memset(s, 0, sizeof(*s));
+    snprintf(s->name, sizeof(s->name), "%s", name);
+    s->addr = addr;
+    s->size = size;
+    iss->symbol_count++;
+    iss->last_symbol = SIZE_MAX;
+    return ESP_OK;
+}
+
+const rv32_symbol_t *rv32_iss_symbol_at(rv32_iss_t *iss, uint32_t addr)
+{
+    size_t i = symbol_index(iss, addr);
+    return i == SIZE_MAX ? NULL : &iss->symbols[i];
+}
+
+const rv32_symbol_t *rv32_iss_find_symbol(const rv32_iss_t *iss, const char *name)
+{
+    for (size_t i = 0; i < iss->symbol_count; i++) {
+        if (strcmp(iss->symbols[i].name, name) == 0) {
+            return &iss->symbols[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Charge the instruction at pc to the whole-run and region profiles
+ */
+static void profile(rv32_iss_t *iss)
+{
+    size_t sym = symbol_index(iss, iss->pc);
+    if (sym != SIZE_MAX) {
+        iss->symbols[sym].executed++;
+    }
+    if (!iss->region_open || sym == iss->region_owner) {
+        return;
+    }
+    rv32_region_t *r = &iss->regions[iss->region_count - 1];
+    r->instructions++;
+    if (sym == SIZE_MAX) {
+        return;
+    }
+    rv32_symbol_t *s = &iss->symbols[sym];
+    if (strncmp(s->name, "__", 2) == 0) {
+        r->helper_instructions++;
+    }
+    if (s->region_mark != iss->region_count) {
+        s->region_mark = (uint32_t)iss->region_count;
+        r->functions++;
+        r->reach_bytes += s->size;
+    }
+}
+
+// ============================================================================
+// SYSTEM CALLS
+// ============================================================================
+
+static void guest_string(rv32_iss_t *iss, uint32_t addr, char *out, size_t max)
+{
+    size_t n = 0;
+    uint32_t c;
+    while (n + 1 < max && load(iss, addr + (uint32_t)n, 1, &c) && c != 0) {
+        out[n++] = (char)c;
+    }
+    out[n] = '\0';
+}
+
+static void ecall(rv32_iss_t *iss)
+{
+    uint32_t *x = iss->x;
+    switch (x[17]) {
+    case RV32_SYS_WRITE: {
+        uint32_t fd = x[10], buf = x[11], len = x[12];
+        if ((fd != 1 && fd != 2) || !mem_ok(iss, buf, len)) {
+            x[10] = (uint32_t)-1;
+            break;
+        }
+        if (iss->console) {
+            fwrite(iss->mem + (buf - iss->mem_base), 1, len, fd == 1 ? stdout : stderr);
+        }
+        x[10] = len;
+        break;
+    }
+    case RV32_SYS_EXIT:
+        iss->stop = RV32_STOP_EXIT;
+        iss->exit_code = (int32_t)x[10];
+        break;
+    case RV32_SYS_REGION_BEGIN:
+        if (iss->region_open || iss->region_count == RV32_ISS_MAX_REGIONS) {
+            x[10] = (uint32_t)-1;
+            break;
+        }
+        rv32_region_t *r = &iss->regions[iss->region_count++];
+        memset(r, 0, sizeof(*r));
+        guest_string(iss, x[10], r->name, sizeof(r->name));
+        r->calls = x[11];
+        iss->region_open = true;
+        iss->region_owner = symbol_index(iss, iss->pc);
+        x[10] = 0;
+        break;
+    case RV32_SYS_REGION_END:
+        x[10] = iss->region_open ? 0 : (uint32_t)-1;
+        iss->region_open = false;
+        break;
+    default:
+        x[10] = (uint32_t)-38;            // ENOSYS
+        break;
+    }
+}
+
+static uint32_t csr_read(const rv32_iss_t *iss, uint32_t csr)
+{
+    switch (csr) {
+    case CSR_CYCLE:
+    case CSR_TIME:
+    case CSR_INSTRET:
+    case CSR_MCYCLE:
+    case CSR_MINSTRET:
+        return (uint32_t)iss->instret;
+    case CSR_CYCLEH:
+    case CSR_TIMEH:
+    case CSR_INSTRETH:
+        return (uint32_t)(iss->instret >> 32);
+    default:
+        return 0;
+    }
+}
+
+// ============================================================================
+// 32-BIT INSTRUCTIONS
+// ============================================================================
+
+static int32_t sext(uint32_t value, int bits)
+{
+    uint32_t m = 1u << (bits - 1);
+    return (int32_t)((value ^ m) - m);
+}
+
+static uint32_t mul_op(uint32_t f3, uint32_t a, uint32_t b)
+{
+    int32_t sa = (int32_t)a, sb = (int32_t)b;
+    switch (f3) {
+    case 0: return a * b;
+    case 1: return (uint32_t)(((int64_t)sa * (int64_t)sb) >> 32);
+    case 2: return (uint32_t)(((int64_t)sa * (int64_t)(uint64_t)b) >> 32);
+    case 3: return (uint32_t)(((uint64_t)a * (uint64_t)b) >> 32);
+    case 4:
+        if (b == 0) return UINT32_MAX;
+        if (sa == INT32_MIN && sb == -1) return a;
+        return (uint32_t)(sa / sb);
+    case 5: return b == 0 ? UINT32_MAX : a / b;
+    case 6:
+        if (b == 0) return a;
+        if (sa == INT32_MIN && sb == -1) return 0;
+        return (uint32_t)(sa % sb);
+    default: return b == 0 ? a : a % b;
+    }
+}
+
+static bool alu_op(uint32_t f3, uint32_t f7, uint32_t a, uint32_t b, bool imm, uint32_t *out)
+{
+    uint32_t sh = b & 31;
+    switch (f3) {
+    case 0: *out = (!imm && f7 == 0x20) ? a - b : a + b; return imm || f7 == 0 || f7 == 0x20;
+    case 1: *out = a << sh; return f7 == 0;
+    case 2: *out = (int32_t)a < (int32_t)b; return imm || f7 == 0;
+    case 3: *out = a < b; return imm || f7 == 0;
+    case 4: *out = a ^ b; return imm || f7 == 0;
+    case 5:
+        *out = f7 == 0x20 ? (uint32_t)((int32_t)a >> sh) : a >> sh;
+        return f7 == 0 || f7 == 0x20;
+    case 6: *out = a | b; return imm || f7 == 0;
+    default: *out = a & b; return imm || f7 == 0;
+    }
+}
+
+static uint32_t amo_op(uint32_t f5, uint32_t mem, uint32_t reg)
+{
+    switch (f5) {
+    case 0x00: return mem + reg;
+    case 0x01: return reg;
+    case 0x04: return mem ^ reg;
+    case 0x08: return mem | reg;
+    case 0x0C: return mem & reg;
+    case 0x10: return (int32_t)mem < (int32_t)reg ? mem : reg;
+    case 0x14: return (int32_t)mem > (int32_t)reg ? mem : reg;
+    case 0x18: return mem < reg ? mem : reg;
+    default:   return mem > reg ? mem : reg;
+    }
+}
+
+/**
+ * @brief Execute one 32-bit instruction
+ * @return Next pc (iss->stop set on a fault)
+ */
+static uint32_t exec32(rv32_iss_t *iss, uint32_t in)
+{
+    uint32_t *x = iss->x;
+    uint32_t pc = iss->pc, next = pc + 4;
+    uint32_t rd = (in >> 7) & 31, rs1 = (in >> 15) & 31, rs2 = (in >> 20) & 31;
+    uint32_t f3 = (in >> 12) & 7, f7 = in >> 25;
+    uint32_t a = x[rs1], b = x[rs2], v = 0;
+    int32_t imm_i = (int32_t)in >> 20;
+    int32_t imm_s = ((int32_t)in >> 25 << 5) | (int32_t)((in >> 7) & 31);
+    bool write = true;
+
+    switch (in & 0x7F) {
+    case 0x37: v = in & 0xFFFFF000u; break;                                   // LUI
+    case 0x17: v = pc + (in & 0xFFFFF000u); break;                            // AUIPC
+    case 0x6F: {                                                              // JAL
+        uint32_t off = ((in >> 31) << 20) | (((in >> 12) & 0xFF) << 12) |
+                       (((in >> 20) & 1) << 11) | (((in >> 21) & 0x3FF) << 1);
+        v = next;
+        next = pc + (uint32_t)sext(off, 21);
+        break;
+    }
+    case 0x67:                                                                // JALR
+        if (f3 != 0) { fault(iss, in); return pc; }
+        v = next;
+        next = (a + (uint32_t)imm_i) & ~1u;
+        break;
+    case 0x63: {                                                              // BRANCH
+        uint32_t off = ((in >> 31) << 12) | (((in >> 7) & 1) << 11) |
+                       (((in >> 25) & 0x3F) << 5) | (((in >> 8) & 0xF) << 1);
+        bool take;
+        switch (f3) {
+        case 0: take = a == b; break;
+        case 1: take = a != b; break;
+        case 4: take = (int32_t)a < (int32_t)b; break;
+        case 5: take = (int32_t)a >= (int32_t)b; break;
+        case 6: take = a < b; break;
+        case 7: take = a >= b; break;
+        default: fault(iss, in); return pc;
+        }
+        if (take) {
+            next = pc + (uint32_t)sext(off, 13);
+        }
+        write = false;
+        break;
+    }
+    case 0x03: {                                                              // LOAD
+        static const uint8_t size[8] = { 1, 2, 4, 0, 1, 2, 0, 0 };
+        uint32_t addr = a + (uint32_t)imm_i;
+        if (!size[f3] || !load(iss, addr, size[f3], &v)) { fault(iss, in); return pc; }
+        if (f3 == 0) v = (uint32_t)sext(v, 8);
+        if (f3 == 1) v = (uint32_t)sext(v, 16);
+        break;
+    }
+    case 0x23:                                                                // STORE
+        if (f3 > 2 || !store(iss, a + (uint32_t)imm_s, 1u << f3, b)) { fault(iss, in); return pc; }
+        write = false;
+        break;
+    case 0x13: {                                                              // OP-IMM
+        uint32_t f7_imm = (f3 == 1 || f3 == 5) ? f7 : 0;
+        if (!alu_op(f3, f7_imm, a, (uint32_t)imm_i, true, &v)) { fault(iss, in); return pc; }
+        break;
+    }
+    case 0x33:                                                                // OP / M
+        if (f7 == 1) {
+            v = mul_op(f3, a, b);
+        } else if (!alu_op(f3, f7, a, b, false, &v)) {
+            fault(iss, in);
+            return pc;
+        }
+        break;
+    case 0x0F:                                                                // FENCE, FENCE.I
+        write = false;
+        break;
+    case 0x2F: {                                                              // AMO (A)
+        uint32_t f5 = in >> 27, old;
+        if (f3 != 2 || !load(iss, a, 4, &old)) { fault(iss, in); return pc; }
+        if (f5 == 0x02) {                                                     // LR.W
+            v = old;
+            iss->reserved = true;
+            iss->reservation = a;
+        } else if (f5 == 0x03) {                                              // SC.W
+            bool ok = iss->reserved && iss->reservation == a;
+            iss->reserved = false;
+            if (ok) store(iss, a, 4, b);
+            v = ok ? 0 : 1;
+        } else {
+            v = old;
+            store(iss, a, 4, amo_op(f5, old, b));
+        }
+        break;
+    }
+    case 0x73:                                                                // SYSTEM
+        if (f3 == 0) {
+            if (in == 0x00000073) {                                           // ECALL
+                ecall(iss);
+                write = false;
+                break;
+            }
+            fault(iss, in);                                                   // EBREAK, xRET, WFI
+            return pc;
+        } else if (f3 != 4) {                                                 // Zicsr (writes ignored)
+            v = csr_read(iss, in >> 20);
+            break;
+        }
+        fault(iss, in);
+        return pc;
+    default:
+        fault(iss, in);
+        return pc;
+    }
+
+    if (write && rd != 0) {
+        x[rd] = v;
+    }
+    return next;
+}
+
+// ============================================================================
+// COMPRESSED INSTRUCTIONS (RV32C)
+// ============================================================================
+
+static uint32_t cj_offset(uint32_t in)
+{
+    uint32_t off = (((in >> 12) & 1) << 11) | (((in >> 11) & 1) << 4) | (((in >> 9) & 3) << 8) |
+                   (((in >> 8) & 1) << 10) | (((in >> 7) & 1) << 6) | (((in >> 6) & 1) << 7) |
+                   (((in >> 3) & 7) << 1) | (((in >> 2) & 1) << 5);
+    return (uint32_t)sext(off, 12);
+}
+
+static uint32_t cb_offset(uint32_t in)
+{
+    uint32_t off = (((in >> 12) & 1) << 8) | (((in >> 10) & 3) << 3) | (((in >> 5) & 3) << 6) |
+                   (((in >> 3) & 3) << 1) | (((in >> 2) & 1) << 5);
+    return (uint32_t)sext(off, 9);
+}
+
+/**
+ * @brief Execute one 16-bit instruction
+ * @return Next pc (iss->stop set on a fault)
+ */
+static uint32_t exec16(rv32_iss_t *iss, uint32_t in)
+{
+    uint32_t *x = iss->x;
+    uint32_t pc = iss->pc, next = pc + 2;
+    uint32_t f3 = (in >> 13) & 7;
+    uint32_t rd = (in >> 7) & 31, rs2 = (in >> 2) & 31;
+    uint32_t rdp = 8 + ((in >> 2) & 7), rs1p = 8 + ((in >> 7) & 7);
+    int32_t imm6 = sext((((in >> 12) & 1) << 5) | ((in >> 2) & 31), 6);
+    uint32_t v;
+
+    switch (((in & 3) << 3) | f3) {
+    case 0x00: {                                                              // C.ADDI4SPN
+        uint32_t imm = (((in >> 11) & 3) << 4) | (((in >> 7) & 15) << 6) |
+                       (((in >> 6) & 1) << 2) | (((in >> 5) & 1) << 3);
+        if (imm == 0) { fault(iss, in); return pc; }
+        x[rdp] = x[2] + imm;
+        break;
+    }
+    case 0x02:                                                                // C.LW
+    case 0x06: {                                                              // C.SW
+        uint32_t off = (((in >> 10) & 7) << 3) | (((in >> 6) & 1) << 2) | (((in >> 5) & 1) << 6);
+        uint32_t addr = x[rs1p] + off;
+        bool ok = f3 == 2 ? load(iss, addr, 4, &v) : store(iss, addr, 4, x[rdp]);
+        if (!ok) { fault(iss, in); return pc; }
+        if (f3 == 2) x[rdp] = v;
+        break;
+    }
+    case 0x08:                                                                // C.ADDI / C.NOP
+        if (rd) x[rd] += (uint32_t)imm6;
+        break;
+    case 0x09:                                                                // C.JAL
+        x[1] = next;
+        next = pc + cj_offset(in);
+        break;
+    case 0x0A:                                                                // C.LI
+        if (rd) x[rd] = (uint32_t)imm6;
+        break;
+    case 0x0B:
+        if (rd == 2) {                                                        // C.ADDI16SP
+            uint32_t imm = (((in >> 12) & 1) << 9) | (((in >> 6) & 1) << 4) | (((in >> 5) & 1) << 6) |
+                           (((in >> 3) & 3) << 7) | (((in >> 2) & 1) << 5);
+            if (imm == 0) { fault(iss, in); return pc; }
+            x[2] += (uint32_t)sext(imm, 10);
+        } else {                                                              // C.LUI
+            if (imm6 == 0) { fault(iss, in); return pc; }
+            if (rd) x[rd] = (uint32_t)imm6 << 12;
+        }
+        break;
+    case 0x0C: {                                                              // Misc ALU
+        uint32_t f2 = (in >> 10) & 3, shamt = (uint32_t)imm6 & 63;
+        if (f2 < 2 && shamt > 31) { fault(iss, in); return pc; }
+        if (f2 == 0) {
+            x[rs1p] >>= shamt;                                                // C.SRLI
+        } else if (f2 == 1) {
+            x[rs1p] = (uint32_t)((int32_t)x[rs1p] >> shamt);                  // C.SRAI
+        } else if (f2 == 2) {
+            x[rs1p] &= (uint32_t)imm6;                                        // C.ANDI
+        } else {
+            if ((in >> 12) & 1) { fault(iss, in); return pc; }
+            switch ((in >> 5) & 3) {
+            case 0: x[rs1p] -= x[rdp]; break;                                 // C.SUB
+            case 1: x[rs1p] ^= x[rdp]; break;                                 // C.XOR
+            case 2: x[rs1p] |= x[rdp]; break;                                 // C.OR
+            default: x[rs1p] &= x[rdp]; break;                                // C.AND
+            }
+        }
+        break;
+    }
+    case 0x0D:                                                                // C.J
+        next = pc + cj_offset(in);
+        break;
+    case 0x0E:                                                                // C.BEQZ
+        if (x[rs1p] == 0) next = pc + cb_offset(in);
+        break;
+    case 0x0F:                                                                // C.BNEZ
+        if (x[rs1p] != 0) next = pc + cb_offset(in);
+        break;
+    case 0x10: {                                                              // C.SLLI
+        uint32_t shamt = (uint32_t)imm6 & 63;
+        if (shamt > 31) { fault(iss, in); return pc; }
+        if (rd) x[rd] <<= shamt;
+        break;
+    }
+    case 0x12: {                                                              // C.LWSP
+        uint32_t off = (((in >> 12) & 1) << 5) | (((in >> 4) & 7) << 2) | (((in >> 2) & 3) << 6);
+        if (rd == 0 || !load(iss, x[2] + off, 4, &v)) { fault(iss, in); return pc; }
+        x[rd] = v;
+        break;
+    }
+    case 0x14:
+        if (((in >> 12) & 1) == 0) {
+            if (rs2 == 0) {                                                   // C.JR
+                if (rd == 0) { fault(iss, in); return pc; }
+                next = x[rd] & ~1u;
+            } else if (rd) {                                                  // C.MV
+                x[rd] = x[rs2];
+            }
+        } else if (rs2 == 0) {
+            if (rd == 0) { fault(iss, in); return pc; }                       // C.EBREAK
+            uint32_t target = x[rd] & ~1u;                                    // C.JALR
+            x[1] = next;
+            next = target;
+        } else if (rd) {                                                      // C.ADD
+            x[rd] += x[rs2];
+        }
+        break;
+    case 0x16: {                                                              // C.SWSP
+        uint32_t off = (((in >> 9) & 15) << 2) | (((in >> 7) & 3) << 6);
+        if (!store(iss, x[2] + off, 4, x[rs2])) { fault(iss, in); return pc; }
+        break;
+    }
+    default:                                                                  // F/D forms, reserved
+        fault(iss, in);
+        return pc;
+    }
+    return next;
+}
+
+// ============================================================================
+// PUBLIC FUNCTIONS
+// ============================================================================
+
+esp_err_t rv32_iss_init(rv32_iss_t *iss, uint32_t base, uint32_t size)
+{
+    memset(iss, 0, sizeof(*iss));
+    iss->mem = calloc(1, size);
+    if (!iss->mem) {
+        return ESP_ERR_NO_MEM;
+    }
+    iss->mem_base = base;
+    iss->mem_size = size;
+    iss->x[2] = (base + size - 16) & ~15u;
+    iss->pc = base;
+    iss->console = true;
+    iss->last_symbol = SIZE_MAX;
+    iss->region_owner = SIZE_MAX;
+    return ESP_OK;
+}
+
+void rv32_iss_free(rv32_iss_t *iss)
+{
+    free(iss->mem);
+    free(iss->symbols);
+    iss->mem = NULL;
+    iss->symbols = NULL;
+    iss->symbol_count = 0;
+}
+
+static uint32_t rd16(const uint8_t *p) { return (uint32_t)p[0] | ((uint32_t)p[1] << 8); }
+static uint32_t rd32(const uint8_t *p) { return rd16(p) | (rd16(p + 2) << 16); }
+
+static bool in_file(size_t file_len, uint32_t off, uint32_t len)
+{
+    return (uint64_t)off + len <= file_len;
+}
+
+static esp_err_t load_symbols(rv32_iss_t *iss, const uint8_t *img, size_t len)
+{
+    uint32_t shoff = rd32(img + 32), shentsize = rd16(img + 46), shnum = rd16(img + 48);
+    if (shoff == 0 || shentsize < 40 || !in_file(len, shoff, shentsize * shnum)) {
+        return ESP_OK;                                                        // Stripped
+    }
+    for (uint32_t i = 0; i < shnum; i++) {
+        const uint8_t *sh = img + shoff + i * shentsize;
+        if (rd32(sh + 4) != SHT_SYMTAB) {
+            continue;
+        }
+        uint32_t off = rd32(sh + 16), size = rd32(sh + 20), link = rd32(sh + 24);
+        if (link >= shnum || !in_file(len, off, size)) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        const uint8_t *strsh = img + shoff + link * shentsize;
+        uint32_t stroff = rd32(strsh + 16), strsize = rd32(strsh + 20);
+        if (!in_file(len, stroff, strsize)) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        for (uint32_t s = 0; s + 16 <= size; s += 16) {
+            const uint8_t *sym = img + off + s;
+            uint32_t name = rd32(sym), value = rd32(sym + 4), sym_size = rd32(sym + 8);
+            if ((sym[12] & 0xF) != STT_FUNC || sym_size == 0 || name >= strsize) {
+                continue;
+            }
+            char buf[RV32_ISS_NAME_LEN];
+            size_t n = 0;
+            while (n + 1 < sizeof(buf) && name + n < strsize && img[stroff + name + n]) {
+                buf[n] = (char)img[stroff + name + n];
+                n++;
+            }
+            buf[n] = '\0';
+            esp_err_t err = rv32_iss_add_symbol(iss, buf, value & ~1u, sym_size);
+            if (err != ESP_OK) {
+                return err;
+            }
+        }
+    }
+    return ESP_OK;
+}
+
+static esp_err_t load_image(rv32_iss_t *iss, const uint8_t *img, size_t len)
+{
+    if (len < 52 || memcmp(img, "\x7F" "ELF", 4) != 0 || img[4] != 1 || img[5] != 1 ||
+        rd16(img + 18) != EM_RISCV) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    uint32_t entry = rd32(img + 24), phoff = rd32(img + 28);
+    uint32_t phentsize = rd16(img + 42), phnum = rd16(img + 44);
+    if (phentsize < 32 || !in_file(len, phoff, phentsize * phnum)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint64_t lo = UINT64_MAX, hi = 0;
+    for (uint32_t i = 0; i < phnum; i++) {
+        const uint8_t *ph = img + phoff + i * phentsize;
+        if (rd32(ph) != PT_LOAD || rd32(ph + 20) == 0) {
+            continue;
+        }
+        uint64_t vaddr = rd32(ph + 8);
+        lo = vaddr < lo ? vaddr : lo;
+        hi = vaddr + rd32(ph + 20) > hi ? vaddr + rd32(ph + 20) : hi;
+    }
+    if (lo == UINT64_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    lo &= ~0xFFFull;
+    uint64_t size = ((hi - lo + 0xFFF) & ~0xFFFull) + RV32_ISS_STACK_BYTES;
+    if (lo + size > UINT32_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_err_t err = rv32_iss_init(iss, (uint32_t)lo, (uint32_t)size);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    for (uint32_t i = 0; i < phnum; i++) {
+        const uint8_t *ph = img + phoff + i * phentsize;
+        if (rd32(ph) != PT_LOAD) {
+            continue;
+        }
+        uint32_t off = rd32(ph + 4), vaddr = rd32(ph + 8), filesz = rd32(ph + 16);
+        if (filesz > rd32(ph + 20) || !in_file(len, off, filesz) ||
+            !rv32_iss_write_mem(iss, vaddr, img + off, filesz)) {
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+    iss->pc = entry;
+    return load_symbols(iss, img, len);
+}
+
+esp_err_t rv32_iss_load_elf(rv32_iss_t *iss, const char *path)
+{
+    memset(iss, 0, sizeof(*iss));
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    fseek(f, 0, SEEK_END);
+    long len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t *img = len > 0 ? malloc((size_t)len) : NULL;
+    if (!img || fread(img, 1, (size_t)len, f) != (size_t)len) {
+        free(img);
+        fclose(f);
+        return len > 0 ? ESP_ERR_NO_MEM : ESP_ERR_INVALID_ARG;
+    }
+    fclose(f);
+
+    esp_err_t err = load_image(iss, img, (size_t)len);
+    free(img);
+    if (err != ESP_OK) {
+        rv32_iss_free(iss);
+    }
+    return err;
+}
+
+rv32_stop_t rv32_iss_run(rv32_iss_t *iss, uint64_t max_instructions)
+{
+    iss->stop = RV32_STOP_LIMIT;
+    for (uint64_t n = 0; n < max_instructions; n++) {
+        uint32_t lo;
+        if (!load(iss, iss->pc, 2, &lo)) {
+            fault(iss, 0);
+            return iss->stop;
+        }
+        uint32_t in = lo, next;
+        profile(iss);
+        if ((lo & 3) == 3) {
+            uint32_t hi;
+            if (!load(iss, iss->pc + 2, 2, &hi)) {
+                fault(iss, lo);
+                return iss->stop;
+            }
+            in |= hi << 16;
+            next = exec32(iss, in);
+        } else {
+            next = exec16(iss, in);
+        }
+        if (iss->stop == RV32_STOP_FAULT) {
+            return iss->stop;
+        }
+        iss->instret++;
+        iss->pc = next;
+        if (iss->stop == RV32_STOP_EXIT) {
+            return iss->stop;
+        }
+        iss->stop = RV32_STOP_LIMIT;
+    }
+    return iss->stop;
+}
@@ -0,0 +1,143 @@
+/*
+ * Glyph C6 Monitor - RV32IMAC Instruction Set Simulator
+ *
+ * Version: 1.0.0
+ *
+ * User-mode interpreter for the ESP32-C6 instruction set (RV32IMAC +
+ * Zicsr, no FPU), used to count the instructions the firmware's hot
+ * kernels retire when cross-compiled with the firmware flags
+ * (host/bench/kernel_bench.c). It runs a static ELF the way a Linux
+ * user-mode emulator would: the image is loaded at its link addresses,
+ * sp points at the top of a private stack, and ecall is a system call
+ * (a7 = number, a0.. = arguments):
+ *
+ * - 64 write(fd, buf, len): fd 1/2 go to the host stdout/stderr
+ * - 93 exit(code)
+ * - RV32_SYS_REGION_BEGIN(name, calls) / RV32_SYS_REGION_END(): count
+ *   the instructions retired between the two calls, excluding those of
+ *   the function that issued them (the harness loop), and record which
+ *   functions ran
+ *
+ * Cycle, time and instret CSRs read the retired instruction count; other
+ * CSRs read as zero. Timing is not modelled: the count is what the core
+ * retires, not how long it takes (no cache, flash or pipeline model).
+ */
+
+#ifndef RV32_ISS_H
+#define RV32_ISS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+// System call numbers (a7); the cross-compiled harness uses the same values
+#define RV32_SYS_WRITE          64
+#define RV32_SYS_EXIT           93
+#define RV32_SYS_REGION_BEGIN   0x4B0
+#define RV32_SYS_REGION_END     0x4B1
+
+#define RV32_ISS_STACK_BYTES    (256 * 1024)
+#define RV32_ISS_MAX_REGIONS    32
+#define RV32_ISS_NAME_LEN       48
+
+typedef enum {
+    RV32_STOP_EXIT = 0,               // exit() system call
+    RV32_STOP_LIMIT,                  // Instruction budget exhausted
+    RV32_STOP_FAULT,                  // Illegal instruction, bad access, ebreak
+} rv32_stop_t;
+
+typedef struct {
+    char name[RV32_ISS_NAME_LEN];
+    uint32_t addr;
+    uint32_t size;                    // Bytes (st_size)
+    uint64_t executed;                // Instructions retired inside, whole run
+    uint32_t region_mark;             // Last region (index + 1) it ran in
+} rv32_symbol_t;
+
+typedef struct {
+    char name[RV32_ISS_NAME_LEN];
+    uint32_t calls;                   // Kernel calls the harness made in the region
+    uint64_t instructions;            // Retired outside the harness function
+    uint64_t helper_instructions;     // Of which in "__" runtime helpers (soft-float, 64-bit)
+    uint32_t functions;               // Distinct functions that ran (excluding the harness)
+    uint32_t reach_bytes;             // Their total code size
+} rv32_region_t;
+
+typedef struct {
+    uint32_t x[32];
+    uint32_t pc;
+    uint64_t instret;
+
+    uint8_t *mem;
+    uint32_t mem_base;
+    uint32_t mem_size;
+    bool reserved;                    // LR/SC reservation
+    uint32_t reservation;
+
+    rv32_symbol_t *symbols;           // Sorted by address
+    size_t symbol_count;
+    size_t last_symbol;               // Lookup cache
+
+    rv32_region_t regions[RV32_ISS_MAX_REGIONS];
+    size_t region_count;
+    bool region_open;
+    size_t region_owner;              // Symbol that opened the region (SIZE_MAX if none)
+
+    bool console;                     // Forward write() to the host (default true)
+    rv32_stop_t stop;
+    int exit_code;
+    uint32_t fault_pc;
+    uint32_t fault_insn;
+} rv32_iss_t;
+
+/**
+ * @brief Create an empty machine with zeroed memory at [base, base + size)
+ *
+ * sp is set to the top of memory, pc to base.
+ */
+esp_err_t rv32_iss_init(rv32_iss_t *iss, uint32_t base, uint32_t size);
+
+/**
+ * @brief Create a machine from a static RV32 ELF executable
+ *
+ * Loads every PT_LOAD segment, adds RV32_ISS_STACK_BYTES of stack above
+ * the image, reads the function symbols and sets pc to the entry point.
+ *
+ * @return ESP_OK, ESP_ERR_NOT_FOUND (no file), ESP_ERR_INVALID_ARG (not a
+ *         32-bit RISC-V executable), ESP_ERR_NO_MEM
+ */
+esp_err_t rv32_iss_load_elf(rv32_iss_t *iss, const char *path);
+
+/**
+ * @brief Release the machine's memory and symbols
+ */
+void rv32_iss_free(rv32_iss_t *iss);
+
+/**
+ * @brief Copy bytes into guest memory
+ * @return false if the range is outside memory
+ */
+bool rv32_iss_write_mem(rv32_iss_t *iss, uint32_t addr, const void *data, size_t len);
+
+/**
+ * @brief Register a function symbol (the ELF loader does this for the image)
+ */
+esp_err_t rv32_iss_add_symbol(rv32_iss_t *iss, const char *name, uint32_t addr, uint32_t size);
+
+/**
+ * @brief Symbol containing an address (NULL if none)
+ */
+const rv32_symbol_t *rv32_iss_symbol_at(rv32_iss_t *iss, uint32_t addr);
+
+/**
+ * @brief Symbol by name (NULL if none)
+ */
+const rv32_symbol_t *rv32_iss_find_symbol(const rv32_iss_t *iss, const char *name);
+
+/**
+ * @brief Run until exit, a fault or max_instructions more retired instructions
+ */
+rv32_stop_t rv32_iss_run(rv32_iss_t *iss, uint64_t max_instructions);
+
+#endif // RV32_ISS_H
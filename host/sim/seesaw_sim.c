@@ -0,0 +1,219 @@
+/*
+ * Glyph C6 Monitor - Adafruit 4026 Seesaw Simulator
+ *
+ * Version: 1.0.0
+ */
+
+#include "seesaw_sim.h"
+#include "host_sim.h"
+#include <math.h>
+#include <string.h>
+
+// Seesaw registers (same as soil_sensor.c)
+#define SEESAW_STATUS_BASE          0x00
+#define SEESAW_STATUS_HW_ID         0x01
+#define SEESAW_STATUS_VERSION       0x02
+#define SEESAW_STATUS_TEMP          0x04
+#define SEESAW_STATUS_SWRST         0x7F
+#define SEESAW_TOUCH_BASE           0x0F
+#define SEESAW_TOUCH_CHANNEL_OFFSET 0x10
+
+#define SEESAW_HW_ID                0x55
+#define SEESAW_PRODUCT_CODE         4026
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+static uint32_t rng_next(seesaw_sim_t *sim)
+{
+    // xorshift32
+    uint32_t x = sim->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    sim->rng = x;
+    return x;
+}
+
+static float rng_uniform(seesaw_sim_t *sim)
+{
+    return (float)((rng_next(sim) >> 8) + 1) / 16777217.0f;   // (0, 1)
+}
+
+static float rng_gaussian(seesaw_sim_t *sim)
+{
+    // Box-Muller
+    float u1 = rng_uniform(sim);
+    float u2 = rng_uniform(sim);
+    return sqrtf(-2.0f * logf(u1)) * cosf(6.2831853f * u2);
+}
+
+static bool chance(seesaw_sim_t *sim, float probability)
+{
+    return probability > 0.0f && rng_uniform(sim) < probability;
+}
+
+/**
+ * @brief Common bus-level outcome of a transfer (stuck, booting, NACK)
+ */
+static esp_err_t bus_check(seesaw_sim_t *sim)
+{
+    if (sim->stuck) {
+        sim->stats.timeouts++;
+        return ESP_ERR_TIMEOUT;
+    }
+    if (host_time_now_us() < sim->boot_done_us || chance(sim, sim->config.nack_probability)) {
+        sim->stats.nacks++;
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief Store the low len bytes of value big-endian (len <= 4)
+ */
+static void put_be(uint8_t *data, size_t len, uint32_t value)
+{
+    for (size_t i = 0; i < len; i++) {
+        data[i] = (uint8_t)(value >> (8 * (len - 1 - i)));
+    }
+}
+
+static esp_err_t sim_transmit(void *ctx, const uint8_t *data, size_t len)
+{
+    seesaw_sim_t *sim = ctx;
+    esp_err_t ret = bus_check(sim);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    sim->stats.writes++;
+    if (len < 2) {
+        return ESP_OK;
+    }
+
+    uint64_t now = host_time_now_us();
+    uint8_t base = data[0];
+    uint8_t func = data[1];
+    sim->pending = SEESAW_SIM_PENDING_NONE;
+    sim->ready_us = now;
+
+    if (base == SEESAW_STATUS_BASE) {
+        switch (func) {
+        case SEESAW_STATUS_SWRST:
+            sim->stats.resets++;
+            sim->boot_done_us = now + sim->config.boot_time_us;
+            break;
+        case SEESAW_STATUS_TEMP:
+            sim->pending = SEESAW_SIM_PENDING_TEMP;
+            sim->ready_us = now + sim->config.temp_conversion_us;
+            break;
+        case SEESAW_STATUS_HW_ID:
+            sim->pending = SEESAW_SIM_PENDING_HW_ID;
+            break;
+        case SEESAW_STATUS_VERSION:
+            sim->pending = SEESAW_SIM_PENDING_VERSION;
+            break;
+        default:
+            break;
+        }
+    } else if (base == SEESAW_TOUCH_BASE && func >= SEESAW_TOUCH_CHANNEL_OFFSET) {
+        sim->pending = SEESAW_SIM_PENDING_TOUCH;
+        sim->ready_us = now + sim->config.touch_conversion_us;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t sim_receive(void *ctx, uint8_t *data, size_t len)
+{
+    seesaw_sim_t *sim = ctx;
+    esp_err_t ret = bus_check(sim);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    sim->stats.reads++;
+    memset(data, 0xFF, len);
+
+    if (sim->pending == SEESAW_SIM_PENDING_NONE) {
+        return ESP_OK;
+    }
+    if (host_time_now_us() < sim->ready_us) {
+        sim->stats.early_reads++;
+        return ESP_OK;  // Conversion still running: bus reads idle-high
+    }
+
+    switch (sim->pending) {
+    case SEESAW_SIM_PENDING_TOUCH: {
+        uint32_t value = 0xFFFF;
+        if (chance(sim, sim->config.glitch_probability)) {
+            sim->stats.glitches++;
+        } else {
+            float noisy = (float)sim->capacitance;
+            if (sim->config.noise_counts > 0.0f) {
+                noisy += sim->config.noise_counts * rng_gaussian(sim);
+            }
+            value = noisy < 0.0f ? 0 : (noisy > 0xFFFE ? 0xFFFE : (uint32_t)lrintf(noisy));
+        }
+        put_be(data, len < 2 ? len : 2, value);
+        break;
+    }
+    case SEESAW_SIM_PENDING_TEMP:
+        put_be(data, len < 4 ? len : 4, (uint32_t)(int32_t)lrintf(sim->temperature_c * 65536.0f));
+        break;
+    case SEESAW_SIM_PENDING_HW_ID:
+        data[0] = SEESAW_HW_ID;
+        break;
+    case SEESAW_SIM_PENDING_VERSION:
+        put_be(data, len < 4 ? len : 4, (uint32_t)SEESAW_PRODUCT_CODE << 16);
+        break;
+    default:
+        break;
+    }
+    return ESP_OK;
+}
+
+static const host_i2c_device_ops_t seesaw_ops = {
+    .transmit = sim_transmit,
+    .receive = sim_receive,
+};
+
+// ============================================================================
+// PUBLIC FUNCTIONS
+// ============================================================================
+
+void seesaw_sim_default_config(seesaw_sim_config_t *config)
+{
+    memset(config, 0, sizeof(*config));
+    config->boot_time_us = 500000;        // Adafruit library waits 500 ms after SWRST
+    config->touch_conversion_us = 3000;   // Library waits 3 ms before reading touch
+    config->temp_conversion_us = 1000;    // Library waits 1 ms before reading temperature
+}
+
+void seesaw_sim_attach(seesaw_sim_t *sim, const seesaw_sim_config_t *config, uint16_t addr)
+{
+    memset(sim, 0, sizeof(*sim));
+    if (config) {
+        sim->config = *config;
+    } else {
+        seesaw_sim_default_config(&sim->config);
+    }
+    sim->rng = sim->config.seed ? sim->config.seed : 0x5EE5A3u;
+    sim->capacitance = 700;
+    sim->temperature_c = 21.0f;
+    host_i2c_attach(addr, &seesaw_ops, sim);
+}
+
+void seesaw_sim_set_capacitance(seesaw_sim_t *sim, uint16_t capacitance)
+{
+    sim->capacitance = capacitance;
+}
+
+void seesaw_sim_set_temperature(seesaw_sim_t *sim, float temperature_c)
+{
+    sim->temperature_c = temperature_c;
+}
+
+void seesaw_sim_set_stuck(seesaw_sim_t *sim, bool stuck)
+{
+    sim->stuck = stuck;
+}
@@ -0,0 +1,96 @@
+/*
+ * Glyph C6 Monitor - Adafruit 4026 Seesaw Simulator
+ *
+ * Version: 1.0.0
+ *
+ * Simulated STEMMA soil sensor on the host I2C bus, speaking the register
+ * protocol used by soil_sensor.c:
+ *
+ * - STATUS_BASE/SWRST: reboots the chip; every transfer NACKs until the
+ *   boot time has passed
+ * - STATUS_BASE/TEMP: 4-byte 16.16 temperature after a conversion delay
+ * - TOUCH_BASE/CHANNEL_OFFSET: 2-byte capacitance after a conversion delay
+ *
+ * Reading before the conversion finished returns 0xFF bytes, as the real
+ * chip does. Faults: random NACKs, gaussian capacitance noise, 0xFFFF
+ * capacitance glitches and a stuck bus (every transfer times out). All
+ * randomness comes from a seeded PRNG, so runs are reproducible.
+ */
+
+#ifndef SEESAW_SIM_H
+#define SEESAW_SIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Timing and fault model
+typedef struct {
+    uint32_t boot_time_us;            // SWRST to first ACK
+    uint32_t touch_conversion_us;     // Capacitance request to data ready
+    uint32_t temp_conversion_us;      // Temperature request to data ready
+    float nack_probability;           // Per transfer
+    float glitch_probability;         // Per capacitance read: 0xFFFF
+    float noise_counts;               // Capacitance noise (standard deviation, counts)
+    uint32_t seed;                    // PRNG seed (0 = fixed default)
+} seesaw_sim_config_t;
+
+// Counters since attach
+typedef struct {
+    uint32_t writes;
+    uint32_t reads;
+    uint32_t resets;
+    uint32_t nacks;                   // Injected NACKs and NACKs while booting
+    uint32_t early_reads;             // Reads before the conversion finished
+    uint32_t glitches;
+    uint32_t timeouts;                // Transfers on a stuck bus
+} seesaw_sim_stats_t;
+
+typedef enum {
+    SEESAW_SIM_PENDING_NONE = 0,
+    SEESAW_SIM_PENDING_TOUCH,
+    SEESAW_SIM_PENDING_TEMP,
+    SEESAW_SIM_PENDING_HW_ID,
+    SEESAW_SIM_PENDING_VERSION,
+} seesaw_sim_pending_t;
+
+typedef struct {
+    seesaw_sim_config_t config;
+    seesaw_sim_stats_t stats;
+    uint16_t capacitance;             // Noise-free reading (dry ~330, wet ~1050)
+    float temperature_c;
+    bool stuck;
+    uint64_t boot_done_us;            // Virtual time the chip answers again
+    seesaw_sim_pending_t pending;
+    uint64_t ready_us;                // Virtual time the pending conversion completes
+    uint32_t rng;
+} seesaw_sim_t;
+
+/**
+ * @brief Realistic defaults: no faults, datasheet-order timings
+ */
+void seesaw_sim_default_config(seesaw_sim_config_t *config);
+
+/**
+ * @brief Attach the simulator to the host I2C bus
+ * @param sim Simulator state (must outlive the attachment)
+ * @param config Timing/fault model (NULL = defaults)
+ * @param addr 7-bit address (SOIL_SENSOR_ADDR)
+ */
+void seesaw_sim_attach(seesaw_sim_t *sim, const seesaw_sim_config_t *config, uint16_t addr);
+
+/**
+ * @brief Set the noise-free capacitance reading
+ */
+void seesaw_sim_set_capacitance(seesaw_sim_t *sim, uint16_t capacitance);
+
+/**
+ * @brief Set the temperature reported by the chip
+ */
+void seesaw_sim_set_temperature(seesaw_sim_t *sim, float temperature_c);
+
+/**
+ * @brief Hold the bus (SDA stuck low): every transfer times out until cleared
+ */
+void seesaw_sim_set_stuck(seesaw_sim_t *sim, bool stuck);
+
+#endif // SEESAW_SIM_H
@@ -0,0 +1,164 @@
+/*
+ * Glyph C6 Monitor - Sensirion SHT4x Simulator
+ *
+ * Version: 1.0.0
+ */
+
+#include "sht4x_sim.h"
+#include "host_sim.h"
+#include <math.h>
+#include <string.h>
+
+// SHT4x commands (same as ambient_sensor.c)
+#define SHT4X_CMD_SOFT_RESET        0x94
+#define SHT4X_CMD_MEASURE_HIGH      0xFD
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+static uint32_t rng_next(sht4x_sim_t *sim)
+{
+    // xorshift32
+    uint32_t x = sim->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    sim->rng = x;
+    return x;
+}
+
+static bool chance(sht4x_sim_t *sim, float probability)
+{
+    return probability > 0.0f && (float)((rng_next(sim) >> 8) + 1) / 16777217.0f < probability;
+}
+
+/**
+ * @brief Datasheet CRC-8: polynomial 0x31, init 0xFF, no reflection
+ */
+static uint8_t crc8(const uint8_t *data, size_t len)
+{
+    uint8_t crc = 0xFF;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x31) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+/**
+ * @brief Physical value to a raw word: raw = (value - offset) * 65535 / span
+ */
+static uint16_t to_raw(float value, float offset, float span)
+{
+    float raw = (value - offset) * 65535.0f / span;
+    return raw < 0.0f ? 0 : (raw > 65535.0f ? 65535 : (uint16_t)lrintf(raw));
+}
+
+static void put_word(uint8_t *data, uint16_t word)
+{
+    data[0] = (uint8_t)(word >> 8);
+    data[1] = (uint8_t)word;
+    data[2] = crc8(data, 2);
+}
+
+static esp_err_t sim_transmit(void *ctx, const uint8_t *data, size_t len)
+{
+    sht4x_sim_t *sim = ctx;
+    uint64_t now = host_time_now_us();
+    if (now < sim->reset_done_us || chance(sim, sim->config.nack_probability)) {
+        sim->stats.nacks++;
+        return ESP_FAIL;
+    }
+    sim->stats.writes++;
+    if (len < 1) {
+        return ESP_OK;
+    }
+
+    // A new command abandons a measurement in progress
+    sim->pending = false;
+    switch (data[0]) {
+    case SHT4X_CMD_SOFT_RESET:
+        sim->stats.resets++;
+        sim->reset_done_us = now + sim->config.reset_time_us;
+        break;
+    case SHT4X_CMD_MEASURE_HIGH:
+        sim->stats.measurements++;
+        sim->pending = true;
+        sim->ready_us = now + sim->config.measure_time_us;
+        break;
+    default:
+        break;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t sim_receive(void *ctx, uint8_t *data, size_t len)
+{
+    sht4x_sim_t *sim = ctx;
+    uint64_t now = host_time_now_us();
+    if (now < sim->reset_done_us || chance(sim, sim->config.nack_probability)) {
+        sim->stats.nacks++;
+        return ESP_FAIL;
+    }
+    if (!sim->pending) {
+        sim->stats.nacks++;
+        return ESP_FAIL;  // Nothing to read
+    }
+    if (now < sim->ready_us) {
+        sim->stats.early_reads++;
+        sim->stats.nacks++;
+        return ESP_FAIL;  // Still measuring: the chip NACKs its address
+    }
+    sim->stats.reads++;
+    sim->pending = false;
+
+    uint8_t frame[6];
+    put_word(&frame[0], to_raw(sim->temperature_c, -45.0f, 175.0f));
+    put_word(&frame[3], to_raw(sim->humidity_pct, -6.0f, 125.0f));
+    if (chance(sim, sim->config.crc_error_probability)) {
+        sim->stats.crc_errors++;
+        frame[5] ^= 0x5A;
+    }
+    memset(data, 0xFF, len);
+    memcpy(data, frame, len < sizeof(frame) ? len : sizeof(frame));
+    return ESP_OK;
+}
+
+static const host_i2c_device_ops_t sht4x_ops = {
+    .transmit = sim_transmit,
+    .receive = sim_receive,
+};
+
+// ============================================================================
+// PUBLIC FUNCTIONS
+// ============================================================================
+
+void sht4x_sim_default_config(sht4x_sim_config_t *config)
+{
+    memset(config, 0, sizeof(*config));
+    config->reset_time_us = 1000;         // Soft reset time (datasheet max)
+    config->measure_time_us = 8300;       // High repeatability (datasheet max)
+}
+
+void sht4x_sim_attach(sht4x_sim_t *sim, const sht4x_sim_config_t *config, uint16_t addr)
+{
+    memset(sim, 0, sizeof(*sim));
+    if (config) {
+        sim->config = *config;
+    } else {
+        sht4x_sim_default_config(&sim->config);
+    }
+    sim->rng = sim->config.seed ? sim->config.seed : 0x5E74u;
+    sim->temperature_c = 22.0f;
+    sim->humidity_pct = 45.0f;
+    host_i2c_attach(addr, &sht4x_ops, sim);
+}
+
+void sht4x_sim_set_air(sht4x_sim_t *sim, float temperature_c, float humidity_pct)
+{
+    sim->temperature_c = temperature_c;
+    sim->humidity_pct = humidity_pct;
+}
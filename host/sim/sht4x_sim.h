@@ -0,0 +1,72 @@
+/*
+ * Glyph C6 Monitor - Sensirion SHT4x Simulator
+ *
+ * Version: 1.0.0
+ *
+ * Simulated SHT40/41/45 on the host I2C bus, speaking the command set used
+ * by ambient_sensor.c:
+ *
+ * - 0x94 soft reset: every transfer NACKs until the reset time has passed
+ * - 0xFD high repeatability measurement: 6 bytes (T, CRC, RH, CRC) after
+ *   the measurement time; reading earlier NACKs, as the real chip does
+ *
+ * Faults: random NACKs and corrupted CRC bytes, from a seeded PRNG so runs
+ * are reproducible.
+ */
+
+#ifndef SHT4X_SIM_H
+#define SHT4X_SIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Timing and fault model
+typedef struct {
+    uint32_t reset_time_us;           // Soft reset to first ACK
+    uint32_t measure_time_us;         // Measurement command to data ready
+    float nack_probability;           // Per transfer
+    float crc_error_probability;      // Per measurement read: a wrong CRC byte
+    uint32_t seed;                    // PRNG seed (0 = fixed default)
+} sht4x_sim_config_t;
+
+// Counters since attach
+typedef struct {
+    uint32_t writes;
+    uint32_t reads;
+    uint32_t resets;
+    uint32_t measurements;
+    uint32_t nacks;                   // Injected NACKs, NACKs while resetting or measuring
+    uint32_t early_reads;             // Reads before the measurement finished
+    uint32_t crc_errors;
+} sht4x_sim_stats_t;
+
+typedef struct {
+    sht4x_sim_config_t config;
+    sht4x_sim_stats_t stats;
+    float temperature_c;
+    float humidity_pct;
+    uint64_t reset_done_us;           // Virtual time the chip answers again
+    bool pending;                     // Measurement started and not read yet
+    uint64_t ready_us;                // Virtual time the measurement completes
+    uint32_t rng;
+} sht4x_sim_t;
+
+/**
+ * @brief Datasheet defaults: no faults, maximum reset/measurement times
+ */
+void sht4x_sim_default_config(sht4x_sim_config_t *config);
+
+/**
+ * @brief Attach the simulator to the host I2C bus
+ * @param sim Simulator state (must outlive the attachment)
+ * @param config Timing/fault model (NULL = defaults)
+ * @param addr 7-bit address (AMBIENT_SENSOR_ADDR)
+ */
+void sht4x_sim_attach(sht4x_sim_t *sim, const sht4x_sim_config_t *config, uint16_t addr);
+
+/**
+ * @brief Set the air the chip measures
+ */
+void sht4x_sim_set_air(sht4x_sim_t *sim, float temperature_c, float humidity_pct);
+
+#endif // SHT4X_SIM_H
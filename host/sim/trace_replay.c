@@ -0,0 +1,619 @@
+/*
+ * Glyph C6 Monitor - Field Trace Replay
+ *
+ * Version: 1.0.0
+ */
+
+#include "trace_replay.h"
+#include "host_sim.h"
+#include "system_config.h"
+#include "zigbee_core.h"
+#include "esp_zigbee_core.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define REPLAY_MAX_DEVICES       4
+#define REPLAY_MAX_ADC_CHANNELS  8
+#define REPLAY_MAX_COUNTERS      32
+#define REPLAY_KEY_NONE          0xFFFF        // Read without a register written before it
+#define REPLAY_I2C_SCL_HZ        100000        // soil_sensor.c device clock
+#define REPLAY_SIGNAL_DELAY_MS   5             // Host stack delay before a signal (host_zigbee.c)
+#define REPLAY_WAKE_SLACK_S      1.0           // Recorded wake times are whole RTC seconds
+#define SECONDS_PER_DAY          86400.0
+
+// Firmware entry point (main.c) - creates the "app_loop" task
+extern void app_main(void);
+
+// One recorded wake (WAKE record up to the next WAKE record)
+typedef struct {
+    size_t first;
+    size_t end;
+    double offset_s;                  // Since the first recorded wake (monotonic)
+    bool complete;                    // Ended with a SLEEP record
+    uint32_t awake_us;
+    uint32_t sleep_sec;
+    bool radio;                       // Zigbee stack started
+    uint32_t radio_start_us;          // First stack signal
+    bool first_start;                 // DEVICE_FIRST_START: not commissioned
+    bool rejoin;
+    esp_err_t rejoin_status;
+    uint32_t rejoin_ms;
+    bool steering;
+    esp_err_t steering_status;
+    uint32_t steering_ms;
+} trace_wake_t;
+
+// Occurrences of one interaction in the current replay wake
+typedef struct {
+    uint8_t type;
+    uint16_t source;
+    uint16_t key;
+    uint16_t count;
+} replay_counter_t;
+
+typedef struct {
+    uint16_t addr;
+    uint16_t last_key;                // Register written last in this wake
+} replay_device_t;
+
+// ============================================================================
+// REPLAY STATE (static: survives the deep sleep longjmp)
+// ============================================================================
+
+typedef struct {
+    const field_trace_record_t *records;
+    uint16_t *keys;                   // Per record: I2C register key
+    trace_wake_t *wakes;
+    size_t wake_count;
+    trace_replay_config_t config;
+    trace_replay_result_t result;
+
+    replay_device_t devices[REPLAY_MAX_DEVICES];
+    size_t device_count;
+    size_t current;                   // Recorded wake matching the replay wake
+    replay_counter_t counters[REPLAY_MAX_COUNTERS];
+    size_t counter_count;
+
+    uint64_t start_us;
+    uint64_t end_us;
+    uint32_t reports_before;
+    uint64_t radio_before_us;
+} trace_replay_state_t;
+
+static trace_replay_state_t replay;
+
+// ============================================================================
+// TRACE INDEX
+// ============================================================================
+
+static uint16_t i2c_key(const field_trace_record_t *r)
+{
+    if (r->len == 0) {
+        return REPLAY_KEY_NONE;
+    }
+    return (uint16_t)((r->data[0] << 8) | (r->len > 1 ? r->data[1] : 0xFF));
+}
+
+/**
+ * @brief Split the trace into wakes and derive the network script of each
+ */
+static esp_err_t index_trace(const field_trace_record_t *records, size_t count)
+{
+    replay.keys = calloc(count ? count : 1, sizeof(uint16_t));
+    replay.wakes = calloc(count ? count : 1, sizeof(trace_wake_t));
+    if (!replay.keys || !replay.wakes) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    trace_wake_t *w = NULL;
+    uint32_t prev_rtc = 0;
+    uint16_t last_tx[REPLAY_MAX_DEVICES] = { 0 };
+    uint16_t last_tx_addr[REPLAY_MAX_DEVICES] = { 0 };
+    size_t tx_slots = 0;
+    uint32_t commissioning_us = 0;    // Signal that started the pending commissioning step
+
+    for (size_t i = 0; i < count; i++) {
+        const field_trace_record_t *r = &records[i];
+        replay.keys[i] = REPLAY_KEY_NONE;
+
+        if (r->type == FIELD_TRACE_WAKE) {
+            uint32_t rtc;
+            memcpy(&rtc, r->data, sizeof(rtc));
+            trace_wake_t *prev = w;
+            w = &replay.wakes[replay.wake_count++];
+            w->first = i;
+            if (!prev) {
+                w->offset_s = 0.0;
+            } else if (rtc >= prev_rtc) {
+                w->offset_s = prev->offset_s + (rtc - prev_rtc);
+            } else {
+                // RTC restarted (power loss): continue after the previous wake
+                w->offset_s = prev->offset_s + prev->awake_us / 1e6 + prev->sleep_sec;
+            }
+            prev_rtc = rtc;
+            tx_slots = 0;
+            commissioning_us = 0;
+        }
+        if (!w) {
+            continue;                 // Partial wake before the first WAKE record
+        }
+        w->end = i + 1;
+
+        switch (r->type) {
+        case FIELD_TRACE_I2C_TX:
+        case FIELD_TRACE_I2C_RX: {
+            size_t slot = 0;
+            while (slot < tx_slots && last_tx_addr[slot] != r->source) {
+                slot++;
+            }
+            if (r->type == FIELD_TRACE_I2C_TX) {
+                replay.keys[i] = i2c_key(r);
+                if (slot == tx_slots && tx_slots < REPLAY_MAX_DEVICES) {
+                    last_tx_addr[tx_slots++] = r->source;
+                }
+                if (slot < tx_slots) {
+                    last_tx[slot] = replay.keys[i];
+                }
+            } else {
+                replay.keys[i] = slot < tx_slots ? last_tx[slot] : REPLAY_KEY_NONE;
+            }
+            break;
+        }
+        case FIELD_TRACE_ZB_SIGNAL:
+            if (!w->radio) {
+                w->radio = true;
+                w->radio_start_us = r->time_us;
+            }
+            switch (r->source) {
+            case ESP_ZB_ZDO_SIGNAL_SKIP_STARTUP:
+                commissioning_us = r->time_us;
+                break;
+            case ESP_ZB_BDB_SIGNAL_DEVICE_FIRST_START:
+                w->first_start = true;
+                commissioning_us = r->time_us;
+                break;
+            case ESP_ZB_BDB_SIGNAL_DEVICE_REBOOT: {
+                uint32_t ms = (r->time_us - commissioning_us) / 1000;
+                w->rejoin = true;
+                w->rejoin_status = r->status;
+                w->rejoin_ms = ms > REPLAY_SIGNAL_DELAY_MS ? ms - REPLAY_SIGNAL_DELAY_MS : 0;
+                commissioning_us = r->time_us;
+                break;
+            }
+            case ESP_ZB_BDB_SIGNAL_STEERING:
+                if (!w->steering) {
+                    w->steering = true;
+                    w->steering_status = r->status;
+                    w->steering_ms = (r->time_us - commissioning_us) / 1000;
+                }
+                break;
+            default:
+                break;
+            }
+            break;
+        case FIELD_TRACE_SLEEP:
+            w->complete = true;
+            w->awake_us = r->time_us;
+            memcpy(&w->sleep_sec, r->data, sizeof(w->sleep_sec));
+            break;
+        default:
+            break;
+        }
+    }
+    return replay.wake_count ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+/**
+ * @brief Recorded figures, charged with the replay's current model
+ */
+static void account_trace(void)
+{
+    trace_replay_result_t *res = &replay.result;
+    const wake_sim_current_t *cur = &replay.config.current;
+    for (size_t i = 0; i < replay.wake_count; i++) {
+        const trace_wake_t *w = &replay.wakes[i];
+        if (!w->complete) {
+            continue;
+        }
+        double radio_us = w->radio && w->awake_us > w->radio_start_us ? w->awake_us - w->radio_start_us : 0.0;
+        res->trace_wakes++;
+        res->trace_radio_wakes += w->radio ? 1 : 0;
+        res->trace_awake_s += (w->awake_us + cur->boot_ms * 1000.0) / 1e6;
+        res->trace_radio_s += radio_us / 1e6;
+        res->trace_charge_mah += wake_sim_charge_mah(cur, w->awake_us, radio_us, w->sleep_sec * 1e6);
+    }
+    const trace_wake_t *last = &replay.wakes[replay.wake_count - 1];
+    res->trace_days = (last->offset_s + last->awake_us / 1e6 + last->sleep_sec) / SECONDS_PER_DAY;
+}
+
+/**
+ * @brief Recorded wake that was running at this point of the replay
+ */
+static size_t wake_at(double elapsed_s)
+{
+    size_t lo = 0, hi = replay.wake_count;
+    while (hi - lo > 1) {
+        size_t mid = (lo + hi) / 2;
+        if (replay.wakes[mid].offset_s <= elapsed_s + REPLAY_WAKE_SLACK_S) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// ============================================================================
+// RECORD LOOKUP
+// ============================================================================
+
+static uint16_t next_occurrence(uint8_t type, uint16_t source, uint16_t key)
+{
+    for (size_t i = 0; i < replay.counter_count; i++) {
+        replay_counter_t *c = &replay.counters[i];
+        if (c->type == type && c->source == source && c->key == key) {
+            return c->count++;
+        }
+    }
+    if (replay.counter_count < REPLAY_MAX_COUNTERS) {
+        replay.counters[replay.counter_count++] = (replay_counter_t){ type, source, key, 1 };
+    }
+    return 0;
+}
+
+/**
+ * @brief n-th matching record of a recorded wake (the last one if fewer)
+ * @return Record index, or SIZE_MAX if the wake has none
+ */
+static size_t find_in_wake(size_t wake, uint8_t type, uint16_t source, uint16_t key, uint16_t n)
+{
+    const trace_wake_t *w = &replay.wakes[wake];
+    size_t found = SIZE_MAX;
+    uint16_t seen = 0;
+    for (size_t i = w->first; i < w->end; i++) {
+        const field_trace_record_t *r = &replay.records[i];
+        if (r->type == type && r->source == source && replay.keys[i] == key) {
+            found = i;
+            if (seen++ == n) {
+                break;
+            }
+        }
+    }
+    return found;
+}
+
+/**
+ * @brief Record serving the next interaction: matching wake first, then nearest wakes
+ * @param held Set when served from another wake
+ * @return Record index, or SIZE_MAX if the trace never saw this interaction
+ */
+static size_t find_record(uint8_t type, uint16_t source, uint16_t key, bool *held)
+{
+    uint16_t n = next_occurrence(type, source, key);
+    size_t i = find_in_wake(replay.current, type, source, key, n);
+    *held = false;
+    if (i != SIZE_MAX) {
+        return i;
+    }
+    *held = true;
+    for (size_t d = 1; d < replay.wake_count; d++) {
+        if (replay.current >= d &&
+            (i = find_in_wake(replay.current - d, type, source, key, n)) != SIZE_MAX) {
+            return i;
+        }
+        if (replay.current + d < replay.wake_count &&
+            (i = find_in_wake(replay.current + d, type, source, key, n)) != SIZE_MAX) {
+            return i;
+        }
+    }
+    return SIZE_MAX;
+}
+
+// ============================================================================
+// REPLAYED DEVICES
+// ============================================================================
+
+/**
+ * @brief Bus time the host I2C shim already charged for a transfer
+ */
+static uint32_t bus_time_us(size_t len)
+{
+    uint64_t bits = 2 + 9 * (uint64_t)(len + 1);
+    return (uint32_t)((bits * 1000000ULL + REPLAY_I2C_SCL_HZ - 1) / REPLAY_I2C_SCL_HZ);
+}
+
+static esp_err_t serve_i2c(replay_device_t *dev, uint8_t type, uint16_t key, uint8_t *data, size_t len)
+{
+    bool held;
+    size_t i = find_record(type, dev->addr, key, &held);
+    if (data) {
+        memset(data, 0xFF, len);
+    }
+    if (i == SIZE_MAX) {
+        replay.result.i2c_unmatched++;
+        return ESP_OK;
+    }
+    const field_trace_record_t *r = &replay.records[i];
+    if (held) {
+        replay.result.i2c_held++;
+    } else {
+        replay.result.i2c_exact++;
+    }
+    if (r->status != ESP_OK) {
+        replay.result.i2c_errors++;
+    }
+    if (data && r->status == ESP_OK) {
+        size_t n = len < r->len ? len : r->len;
+        memcpy(data, r->data, n < FIELD_TRACE_DATA_BYTES ? n : FIELD_TRACE_DATA_BYTES);
+    }
+    // Clock stretching and driver latency beyond the bus time (the shim charges timeouts)
+    uint32_t bus_us = bus_time_us(r->len);
+    if (r->status != ESP_ERR_TIMEOUT && r->duration_us > bus_us) {
+        host_time_advance_us(r->duration_us - bus_us);
+    }
+    return (esp_err_t)r->status;
+}
+
+static esp_err_t device_transmit(void *ctx, const uint8_t *data, size_t len)
+{
+    replay_device_t *dev = ctx;
+    field_trace_record_t written = { .len = (uint8_t)(len > UINT8_MAX ? UINT8_MAX : len) };
+    memcpy(written.data, data, len < FIELD_TRACE_DATA_BYTES ? len : FIELD_TRACE_DATA_BYTES);
+    dev->last_key = i2c_key(&written);
+    return serve_i2c(dev, FIELD_TRACE_I2C_TX, dev->last_key, NULL, len);
+}
+
+static esp_err_t device_receive(void *ctx, uint8_t *data, size_t len)
+{
+    replay_device_t *dev = ctx;
+    return serve_i2c(dev, FIELD_TRACE_I2C_RX, dev->last_key, data, len);
+}
+
+static const host_i2c_device_ops_t device_ops = {
+    .transmit = device_transmit,
+    .receive = device_receive,
+};
+
+static int adc_source(int channel, void *ctx)
+{
+    (void)ctx;
+    bool held;
+    size_t i = find_record(FIELD_TRACE_ADC, (uint16_t)channel, REPLAY_KEY_NONE, &held);
+    if (i == SIZE_MAX) {
+        replay.result.adc_unmatched++;
+        return 0;
+    }
+    const field_trace_record_t *r = &replay.records[i];
+    if (held) {
+        replay.result.adc_held++;
+    } else {
+        replay.result.adc_exact++;
+    }
+    if (r->duration_us > 0) {
+        host_time_advance_us(r->duration_us);
+    }
+    if (r->status != ESP_OK) {
+        return -1;
+    }
+    int32_t raw;
+    memcpy(&raw, r->data, sizeof(raw));
+    return host_adc_raw_to_mv(raw);
+}
+
+/**
+ * @brief Attach every recorded I2C device and ADC channel
+ */
+static void attach_devices(void)
+{
+    bool channels[REPLAY_MAX_ADC_CHANNELS] = { false };
+    for (size_t i = replay.wakes[0].first; i < replay.wakes[replay.wake_count - 1].end; i++) {
+        const field_trace_record_t *r = &replay.records[i];
+        if (r->type == FIELD_TRACE_I2C_TX || r->type == FIELD_TRACE_I2C_RX) {
+            size_t d = 0;
+            while (d < replay.device_count && replay.devices[d].addr != r->source) {
+                d++;
+            }
+            if (d == replay.device_count && d < REPLAY_MAX_DEVICES) {
+                replay.devices[d].addr = r->source;
+                replay.device_count++;
+                host_i2c_attach(r->source, &device_ops, &replay.devices[d]);
+            }
+        } else if (r->type == FIELD_TRACE_ADC && r->source < REPLAY_MAX_ADC_CHANNELS && !channels[r->source]) {
+            channels[r->source] = true;
+            host_adc_set_source(r->source, adc_source, NULL);
+        }
+    }
+}
+
+/**
+ * @brief Commissioning state at the start of the trace (first radio wake)
+ */
+static void script_first_network(void)
+{
+    bool factory_new = false;
+    esp_err_t status = ESP_OK;
+    uint32_t latency_ms = 2000;
+    bool first_radio = true;
+    for (size_t i = 0; i < replay.wake_count; i++) {
+        const trace_wake_t *w = &replay.wakes[i];
+        if (first_radio && w->radio) {
+            factory_new = w->first_start;
+            first_radio = false;
+        }
+        if (w->steering) {
+            status = w->steering_status;
+            latency_ms = w->steering_ms;
+            break;
+        }
+    }
+    host_zb_set_network(factory_new, status, latency_ms);
+}
+
+/**
+ * @brief Rejoin outcome of the coming wake (nearest recorded radio wake)
+ */
+static void script_network(void)
+{
+    for (size_t d = 0; d < replay.wake_count; d++) {
+        size_t candidates[2] = { replay.current >= d ? replay.current - d : SIZE_MAX, replay.current + d };
+        for (int c = 0; c < 2; c++) {
+            size_t i = candidates[c];
+            if (i < replay.wake_count && replay.wakes[i].rejoin) {
+                host_zb_set_rejoin(replay.wakes[i].rejoin_status, replay.wakes[i].rejoin_ms);
+                return;
+            }
+        }
+    }
+}
+
+static void begin_wake(void)
+{
+    double elapsed_s = (double)(host_time_now_us() - replay.start_us) / 1e6;
+    replay.current = wake_at(elapsed_s);
+    replay.counter_count = 0;
+    for (size_t d = 0; d < replay.device_count; d++) {
+        replay.devices[d].last_key = REPLAY_KEY_NONE;
+    }
+    script_network();
+    replay.reports_before = host_zb_report_count();
+    replay.radio_before_us = host_zb_radio_on_us();
+}
+
+static void account_wake(void)
+{
+    trace_replay_result_t *res = &replay.result;
+    const wake_sim_current_t *cur = &replay.config.current;
+    double awake_us = (double)host_sleep_last_awake_us();
+    double radio_us = (double)(host_zb_radio_on_us() - replay.radio_before_us);
+    if (radio_us > awake_us) {
+        radio_us = awake_us;
+    }
+    res->wakes++;
+    res->radio_wakes += radio_us > 0.0 ? 1 : 0;
+    res->awake_s += (awake_us + cur->boot_ms * 1000.0) / 1e6;
+    res->radio_s += radio_us / 1e6;
+    res->charge_mah += wake_sim_charge_mah(cur, awake_us, radio_us, (double)host_sleep_last_duration_us());
+
+    for (uint32_t i = replay.reports_before; i < host_zb_report_count(); i++) {
+        const host_zb_report_t *r = host_zb_report_get(i);
+        if (r->cluster_id == GLYPH_CLUSTER_ID_STATS && r->attr_id == GLYPH_ATTR_WINDOW_STATS_ID) {
+            res->reports++;
+        }
+    }
+}
+
+/**
+ * @brief End of a replay: simulated days, result copy, trace index freed
+ */
+static esp_err_t finish_run(trace_replay_result_t *result, esp_err_t ret)
+{
+    replay.result.days = (double)(host_time_now_us() - replay.start_us) / 1e6 / SECONDS_PER_DAY;
+    *result = replay.result;
+    free(replay.keys);
+    free(replay.wakes);
+    return ret;
+}
+
+// ============================================================================
+// PUBLIC FUNCTIONS
+// ============================================================================
+
+void trace_replay_default_config(trace_replay_config_t *config)
+{
+    memset(config, 0, sizeof(*config));
+    wake_sim_config_t sim;
+    wake_sim_default_config(&sim);
+    config->current = sim.current;
+}
+
+esp_err_t trace_replay_load(const char *path, field_trace_record_t **records, size_t *count)
+{
+    *records = NULL;
+    *count = 0;
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    size_t cap = 0;
+    char line[256];
+    while (fgets(line, sizeof(line), f)) {
+        const char *p = strstr(line, "FTRACE ");
+        unsigned long w[5];
+        if (!p || sscanf(p + 7, "%lx %lx %lx %lx %lx", &w[0], &w[1], &w[2], &w[3], &w[4]) != 5) {
+            continue;
+        }
+        if (*count == cap) {
+            cap = cap ? cap * 2 : 1024;
+            field_trace_record_t *grown = realloc(*records, cap * sizeof(**records));
+            if (!grown) {
+                fclose(f);
+                free(*records);
+                *records = NULL;
+                *count = 0;
+                return ESP_ERR_NO_MEM;
+            }
+            *records = grown;
+        }
+        uint32_t words[5] = { (uint32_t)w[0], (uint32_t)w[1], (uint32_t)w[2], (uint32_t)w[3], (uint32_t)w[4] };
+        memcpy(&(*records)[(*count)++], words, sizeof(words));
+    }
+    fclose(f);
+    return ESP_OK;
+}
+
+esp_err_t trace_replay_save(const char *path, const field_trace_record_t *records, size_t count)
+{
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        return ESP_FAIL;
+    }
+    for (size_t i = 0; i < count; i++) {
+        uint32_t w[5];
+        memcpy(w, &records[i], sizeof(w));
+        fprintf(f, "FTRACE %08lx %08lx %08lx %08lx %08lx\n", (unsigned long)w[0], (unsigned long)w[1],
+                (unsigned long)w[2], (unsigned long)w[3], (unsigned long)w[4]);
+    }
+    return fclose(f) == 0 ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t trace_replay_run(const field_trace_record_t *records, size_t count,
+                           const trace_replay_config_t *config, trace_replay_result_t *result)
+{
+    memset(&replay, 0, sizeof(replay));
+    replay.records = records;
+    replay.config = *config;
+
+    esp_err_t ret = index_trace(records, count);
+    if (ret != ESP_OK) {
+        free(replay.keys);
+        free(replay.wakes);
+        memset(result, 0, sizeof(*result));
+        return ret;
+    }
+    account_trace();
+
+    host_sim_reset();
+    host_log_set_level(config->log_level);
+    script_first_network();
+    attach_devices();
+
+    replay.start_us = host_time_now_us();
+    double days = config->days ? (double)config->days : replay.result.trace_days;
+    replay.end_us = replay.start_us + (uint64_t)(days * SECONDS_PER_DAY * 1e6);
+
+    // Nothing local changes between the deep sleep setjmp and its longjmp
+    while (host_time_now_us() < replay.end_us) {
+        begin_wake();
+        if (!HOST_DEEP_SLEEP_CATCH()) {
+            app_main();
+            host_task_run("app_loop");
+            // The wake cycle always ends in deep sleep on battery
+            fprintf(stderr, "trace_replay: firmware did not enter deep sleep (recorded wake %zu)\n",
+                    replay.current);
+            return finish_run(result, ESP_FAIL);
+        }
+        account_wake();
+    }
+    return finish_run(result, ESP_OK);
+}
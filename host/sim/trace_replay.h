@@ -0,0 +1,109 @@
+/*
+ * Glyph C6 Monitor - Field Trace Replay
+ *
+ * Version: 1.0.0
+ *
+ * Feeds a trace recorded on a device (main/field_trace.h, dumped as
+ * "FTRACE" lines) back into the host build of the deep-sleep firmware
+ * (main.c, deep_sleep.c, soil_sensor.c, ...) on virtual time:
+ *
+ * - I2C: every recorded device is attached; a transfer gets the status,
+ *   data and extra latency (clock stretching, timeouts) of the matching
+ *   recorded transfer - same device, same register, same occurrence
+ *   within the wake
+ * - ADC: conversions return the recorded raw values and failures
+ * - Zigbee: rejoin and steering status and latency come from the
+ *   recorded stack signals
+ *
+ * Replay wakes are mapped to recorded wakes by elapsed RTC time, not by
+ * index, so a firmware change that moves its wakes or issues different
+ * transfers still runs against the field data: an interaction missing
+ * from the matching recorded wake is served from the nearest recorded
+ * wake that has it ("held"), and only counts as unmatched when the trace
+ * never saw it. Trace and replay are charged with the same current model
+ * (wake_sim.h), so a proposed change is judged on field conditions.
+ */
+
+#ifndef TRACE_REPLAY_H
+#define TRACE_REPLAY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "field_trace.h"
+#include "wake_sim.h"
+
+typedef struct {
+    uint32_t days;                    // Replay duration (0 = span of the trace)
+    int log_level;                    // Firmware log level (ESP_LOG_NONE..)
+    wake_sim_current_t current;       // Charge model for trace and replay
+} trace_replay_config_t;
+
+typedef struct {
+    // Recorded (complete wakes only)
+    uint32_t trace_wakes;
+    uint32_t trace_radio_wakes;
+    double trace_days;
+    double trace_awake_s;
+    double trace_radio_s;             // From the first stack signal to sleep
+    double trace_charge_mah;
+
+    // Replayed
+    uint32_t wakes;
+    uint32_t radio_wakes;
+    uint32_t reports;                 // Window-stats reports sent
+    double days;
+    double awake_s;
+    double radio_s;
+    double charge_mah;
+
+    // Fidelity of the replay
+    uint32_t i2c_exact;               // Served from the matching recorded wake
+    uint32_t i2c_held;                // Served from another recorded wake
+    uint32_t i2c_unmatched;           // No recorded counterpart (answered ESP_OK / 0xFF)
+    uint32_t i2c_errors;              // Recorded failures replayed
+    uint32_t adc_exact;
+    uint32_t adc_held;
+    uint32_t adc_unmatched;
+} trace_replay_result_t;
+
+/**
+ * @brief Replay defaults (trace span, current model of wake_sim)
+ */
+void trace_replay_default_config(trace_replay_config_t *config);
+
+/**
+ * @brief Parse a console capture
+ *
+ * Reads every "FTRACE <5 hex words>" line (other console output and
+ * prefixes are ignored).
+ *
+ * @param path Capture file
+ * @param records Allocated record array (free() it)
+ * @param count Number of records
+ * @return ESP_OK, ESP_ERR_NOT_FOUND (no file), ESP_ERR_NO_MEM
+ */
+esp_err_t trace_replay_load(const char *path, field_trace_record_t **records, size_t *count);
+
+/**
+ * @brief Write records as "FTRACE" lines (the device dump format)
+ * @return ESP_OK, or ESP_FAIL if the file cannot be written
+ */
+esp_err_t trace_replay_save(const char *path, const field_trace_record_t *records, size_t count);
+
+/**
+ * @brief Run the firmware against a trace
+ *
+ * Resets every host fake first (host_sim_reset).
+ *
+ * @param records Trace, oldest first (records before the first wake are skipped)
+ * @param count Number of records
+ * @param config Replay options
+ * @param result Trace and replay figures
+ * @return ESP_OK, ESP_ERR_INVALID_ARG (no complete wake in the trace),
+ *         ESP_ERR_NO_MEM, or ESP_FAIL if the firmware stopped deep sleeping
+ */
+esp_err_t trace_replay_run(const field_trace_record_t *records, size_t count,
+                           const trace_replay_config_t *config, trace_replay_result_t *result);
+
+#endif // TRACE_REPLAY_H
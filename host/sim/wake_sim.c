@@ -0,0 +1,363 @@
+/*
+ * Glyph C6 Monitor - Wake-Cycle Energy Simulator
+ *
+ * Version: 1.0.0
+ */
+
+#include "wake_sim.h"
+#include "host_sim.h"
+#include "gp_sink.h"
+#include "system_config.h"
+#include "zigbee_core.h"
+#include "power_policy.h"
+#include "esp_adc/adc_oneshot.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#define SECONDS_PER_DAY      86400.0
+#define US_PER_HOUR          3600e6
+#define SOLAR_STEP_US        300e6       // Harvest integration step
+#define SOLAR_LIFT_V_PER_MA  0.001       // Pack voltage lift per mA of charge current
+
+// Firmware entry point (main.c) - creates the "app_loop" task
+extern void app_main(void);
+
+// ============================================================================
+// SIMULATION STATE (static: survives the deep sleep longjmp)
+// ============================================================================
+
+typedef struct {
+    wake_sim_config_t config;
+    wake_sim_result_t result;
+    seesaw_sim_t sensor;
+    sht4x_sim_t ambient;
+    gp_sink_t gp_sink;
+    uint32_t rng;
+    uint64_t start_us;
+    uint64_t end_us;
+    uint64_t wake_start_us;
+    uint32_t reports_before;
+    uint64_t radio_before_us;
+    uint64_t ieee_before_us;
+    uint32_t gp_readings_before;
+    size_t parent_before;
+    bool rejoin_fails;
+    bool link_changed;
+} wake_sim_state_t;
+
+static wake_sim_state_t sim;
+
+// ============================================================================
+// MODELS
+// ============================================================================
+
+static float rng_uniform(void)
+{
+    // xorshift32
+    uint32_t x = sim.rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    sim.rng = x;
+    return (float)(x >> 8) / 16777216.0f;   // [0, 1)
+}
+
+static double elapsed_days(void)
+{
+    return (double)(host_time_now_us() - sim.start_us) / 1e6 / SECONDS_PER_DAY;
+}
+
+/**
+ * @brief Panel charge current at a virtual time (half sine over the day)
+ */
+static double solar_ma(uint64_t time_us)
+{
+    const wake_sim_config_t *cfg = &sim.config;
+    if (cfg->solar_peak_ma <= 0.0f) {
+        return 0.0;
+    }
+    double days = (double)(time_us - sim.start_us) / 1e6 / SECONDS_PER_DAY;
+    double hour = fmod(days, 1.0) * 24.0;
+    double sunrise = 12.0 - cfg->solar_day_hours / 2.0;
+    if (hour < sunrise || hour >= sunrise + cfg->solar_day_hours) {
+        return 0.0;
+    }
+    return cfg->solar_peak_ma * sin(M_PI * (hour - sunrise) / cfg->solar_day_hours);
+}
+
+/**
+ * @brief Pack voltage from the net charge used (linear 4.10 V -> 3.40 V)
+ *
+ * While the panel delivers, the charger lifts the terminal voltage (up to
+ * its 4.20 V regulation).
+ */
+static int battery_source(int channel, void *ctx)
+{
+    (void)channel;
+    (void)ctx;
+    double used = (sim.result.charge_mah - sim.result.harvest_mah) / sim.config.battery_mah;
+    if (used > 1.0) {
+        used = 1.0;
+    }
+    double volts = 4.10 - 0.70 * used;
+    double lift = solar_ma(host_time_now_us()) * SOLAR_LIFT_V_PER_MA;
+    if (lift > 0.0) {
+        volts = fmin(volts + lift, 4.20);
+    }
+    return (int)(volts * 1000.0 / BATT_VOLTAGE_DIVIDER);   // Millivolts at the ADC pin
+}
+
+/**
+ * @brief Panel charge over the wake and sleep that just ended
+ */
+static void account_harvest(void)
+{
+    wake_sim_result_t *res = &sim.result;
+    uint64_t now = host_time_now_us();
+    for (uint64_t t = sim.wake_start_us; t < now; t += (uint64_t)SOLAR_STEP_US) {
+        double step_us = fmin(SOLAR_STEP_US, (double)(now - t));
+        double offered = solar_ma(t + (uint64_t)(step_us / 2)) * step_us / US_PER_HOUR;
+        double room = res->charge_mah - res->harvest_mah;    // Charger stops at full
+        res->harvest_mah += fmin(offered, fmax(room, 0.0));
+    }
+}
+
+/**
+ * @brief Soil state at the current virtual time
+ */
+static void update_environment(void)
+{
+    const wake_sim_config_t *cfg = &sim.config;
+    double days = elapsed_days();
+    double since_watering = days;
+    if (cfg->watering_interval_days > 0.0f) {
+        since_watering = fmod(days, cfg->watering_interval_days);
+    }
+    double moisture = cfg->moisture_wet_pct - cfg->drying_pct_per_day * since_watering;
+    if (moisture < cfg->moisture_dry_pct) {
+        moisture = cfg->moisture_dry_pct;
+    }
+    double raw = SOIL_VALUE_DRY + moisture / 100.0 * (SOIL_VALUE_WET - SOIL_VALUE_DRY);
+    seesaw_sim_set_capacitance(&sim.sensor, (uint16_t)lrint(raw));
+
+    double phase = fmod(days, 1.0) * 2.0 * M_PI;
+    seesaw_sim_set_temperature(&sim.sensor, cfg->temp_mean_c + cfg->temp_swing_c * (float)sin(phase));
+
+    // Air: twice the soil's swing, relative humidity moving the other way
+    sht4x_sim_set_air(&sim.ambient, cfg->temp_mean_c + 2.0f * cfg->temp_swing_c * (float)sin(phase),
+                      cfg->air_humidity_pct - 3.0f * cfg->temp_swing_c * (float)sin(phase));
+}
+
+/**
+ * @brief Rejoin outcome of the coming wake
+ */
+static void script_network(void)
+{
+    const wake_sim_config_t *cfg = &sim.config;
+    sim.rejoin_fails = rng_uniform() < cfg->rejoin_failure;
+    uint32_t latency = cfg->rejoin_ms + (uint32_t)(rng_uniform() * (float)cfg->rejoin_jitter_ms);
+    host_zb_set_rejoin(sim.rejoin_fails ? ESP_FAIL : ESP_OK, latency);
+
+    if (!sim.link_changed && cfg->link_change_day > 0.0f && elapsed_days() >= cfg->link_change_day) {
+        host_zb_set_router_link(cfg->link_change_router, cfg->link_change_lqi,
+                                cfg->link_change_rssi, cfg->link_change_loss);
+        sim.link_changed = true;
+    }
+}
+
+/**
+ * @brief Charge and classify the wake that just ended in deep sleep
+ */
+static void account_wake(void)
+{
+    const wake_sim_current_t *cur = &sim.config.current;
+    wake_sim_result_t *res = &sim.result;
+
+    double awake_us = (double)host_sleep_last_awake_us();
+    double zb_us = (double)(host_zb_radio_on_us() - sim.radio_before_us);
+    double ieee_us = (double)(host_ieee802154_on_us() - sim.ieee_before_us);
+    double sleep_us = (double)host_sleep_last_duration_us();
+    double radio_us = zb_us + ieee_us;
+    if (radio_us > awake_us) {
+        radio_us = awake_us;
+    }
+
+    res->charge_mah += wake_sim_charge_mah(cur, awake_us, radio_us, sleep_us);
+    account_harvest();
+    power_profile_id_t profile = power_policy_get_profile()->id;
+    if (profile == POWER_PROFILE_HARVEST) {
+        res->harvest_wakes++;
+    } else if (profile == POWER_PROFILE_NIGHT) {
+        res->night_wakes++;
+    }
+    res->awake_s += (awake_us + cur->boot_ms * 1000.0) / 1e6;
+    res->radio_s += radio_us / 1e6;
+    res->wakes++;
+
+    // The sink stays in commissioning mode until the node paired
+    if (sim.gp_sink.stats.commissioned > 0) {
+        gp_sink_set_commissioning(&sim.gp_sink, false);
+    }
+    if (zb_us <= 0.0 && ieee_us > 0.0) {
+        res->gp_wakes++;
+        if (sim.gp_sink.stats.readings > sim.gp_readings_before) {
+            res->reports++;
+            res->gp_reports++;
+        } else {
+            res->lost_reports++;
+        }
+        return;
+    }
+    if (radio_us <= 0.0) {
+        res->sense_wakes++;
+        return;
+    }
+    res->radio_wakes++;
+    if (sim.rejoin_fails) {
+        res->rejoin_failures++;
+    }
+    if (host_zb_parent_index() != sim.parent_before) {
+        res->parent_changes++;
+    }
+
+    bool sent = false;
+    bool delivered = false;
+    for (uint32_t i = sim.reports_before; i < host_zb_report_count(); i++) {
+        const host_zb_report_t *r = host_zb_report_get(i);
+        if (r->cluster_id != GLYPH_CLUSTER_ID_STATS) {
+            continue;
+        }
+        if (r->attr_id == GLYPH_ATTR_WINDOW_STATS_ID) {
+            sent = true;
+            delivered = delivered || r->delivered;
+        } else if (r->attr_id == GLYPH_ATTR_WATERING_EVENTS_ID && r->delivered) {
+            res->watering_reports++;
+        }
+    }
+    if (delivered) {
+        res->reports++;
+    } else if (sent) {
+        res->lost_reports++;
+    }
+}
+
+static void finish_result(void)
+{
+    wake_sim_result_t *res = &sim.result;
+    res->days = elapsed_days();
+    if (res->days <= 0.0) {
+        return;
+    }
+    res->mah_per_day = res->charge_mah / res->days;
+    res->awake_s_per_day = res->awake_s / res->days;
+    res->reports_per_day = res->reports / res->days;
+    res->uah_per_report = res->reports ? res->charge_mah * 1000.0 / res->reports : 0.0;
+    res->battery_days = res->mah_per_day > 0.0 ? sim.config.battery_mah / res->mah_per_day : 0.0;
+}
+
+// ============================================================================
+// PUBLIC FUNCTIONS
+// ============================================================================
+
+void wake_sim_default_config(wake_sim_config_t *config)
+{
+    memset(config, 0, sizeof(*config));
+    config->days = 30;
+    config->seed = 1;
+    config->log_level = 0;                 // ESP_LOG_NONE
+
+    config->moisture_wet_pct = 70.0f;
+    config->moisture_dry_pct = 15.0f;
+    config->drying_pct_per_day = 8.0f;
+    config->watering_interval_days = 5.0f;
+    config->temp_mean_c = 20.0f;
+    config->temp_swing_c = 3.0f;
+    config->battery_mah = 1000.0f;
+    config->solar_day_hours = 12.0f;
+
+    config->first_join_ms = 4000;
+    config->rejoin_ms = 300;
+    config->rejoin_jitter_ms = 400;
+    config->rejoin_failure = 0.0f;
+
+    seesaw_sim_default_config(&config->sensor);
+    config->air_humidity_pct = 55.0f;
+    sht4x_sim_default_config(&config->ambient_sensor);
+
+    // ESP32-C6 datasheet order of magnitude; calibrate against a power profiler
+    config->current.boot_ms = 250.0f;
+    config->current.boot_ma = 22.0f;
+    config->current.awake_ma = 30.0f;
+    config->current.radio_ma = 80.0f;
+    config->current.sleep_ua = 20.0f;
+}
+
+double wake_sim_charge_mah(const wake_sim_current_t *current, double awake_us, double radio_us, double sleep_us)
+{
+    double ma_us = current->boot_ma * current->boot_ms * 1000.0 +
+                   current->awake_ma * (awake_us - radio_us) +
+                   current->radio_ma * radio_us +
+                   current->sleep_ua / 1000.0 * sleep_us;
+    return ma_us / US_PER_HOUR;
+}
+
+esp_err_t wake_sim_run(const wake_sim_config_t *config, wake_sim_result_t *result)
+{
+    memset(&sim, 0, sizeof(sim));
+    sim.config = *config;
+    sim.rng = config->seed ? config->seed : 0x9E3779B9u;
+
+    host_sim_reset();
+    host_log_set_level(config->log_level);
+    host_zb_set_network(true, ESP_OK, config->first_join_ms);
+    seesaw_sim_attach(&sim.sensor, &config->sensor, SOIL_SENSOR_ADDR);
+    if (config->ambient) {
+        sht4x_sim_attach(&sim.ambient, &config->ambient_sensor, AMBIENT_SENSOR_ADDR);
+    }
+    host_adc_set_source(BATT_MSR_ADC_CHANNEL, battery_source, NULL);
+    host_zb_set_event_hook(config->zb_event_hook, config->zb_event_ctx);
+    if (config->router_count > 0) {
+        host_zb_set_routers(config->routers, config->router_count);
+    }
+    if (config->gp_uplink) {
+        // Written while the sink is in commissioning mode; reaches the node
+        // with its first data request
+        bool enable = true;
+        gp_sink_init(&sim.gp_sink);
+        gp_sink_set_loss(&sim.gp_sink, config->gp_loss, sim.rng);
+        gp_sink_set_commissioning(&sim.gp_sink, true);
+        host_ieee802154_set_tx_hook(gp_sink_tx_hook, &sim.gp_sink);
+        host_zb_queue_write(HA_ESP_SENSOR_ENDPOINT, GLYPH_CLUSTER_ID_CONFIG,
+                            GLYPH_ATTR_CFG_GP_UPLINK_ID, &enable, sizeof(enable));
+    }
+
+    sim.start_us = host_time_now_us();
+    sim.end_us = sim.start_us + (uint64_t)config->days * 86400ULL * 1000000ULL;
+
+    while (host_time_now_us() < sim.end_us) {
+        update_environment();
+        script_network();
+        sim.wake_start_us = host_time_now_us();
+        sim.reports_before = host_zb_report_count();
+        sim.radio_before_us = host_zb_radio_on_us();
+        sim.ieee_before_us = host_ieee802154_on_us();
+        sim.gp_readings_before = sim.gp_sink.stats.readings;
+        sim.parent_before = host_zb_parent_index();
+
+        if (!HOST_DEEP_SLEEP_CATCH()) {
+            app_main();
+            host_task_run("app_loop");
+            // The wake cycle always ends in deep sleep on battery
+            fprintf(stderr, "wake_sim: firmware did not enter deep sleep at day %.2f\n", elapsed_days());
+            finish_result();
+            *result = sim.result;
+            return ESP_FAIL;
+        }
+        account_wake();
+    }
+
+    finish_result();
+    *result = sim.result;
+    return ESP_OK;
+}
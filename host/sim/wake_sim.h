@@ -0,0 +1,143 @@
+/*
+ * Glyph C6 Monitor - Wake-Cycle Energy Simulator
+ *
+ * Version: 1.0.0
+ *
+ * Runs the real deep-sleep application (main.c: app_main and its event
+ * loop, with deep_sleep, power_policy, watering detection, ...)
+ * wake after wake on virtual time, against:
+ *
+ * - a soil model (drying curve, periodic watering, diurnal temperature)
+ *   served by the Seesaw simulator, with its latency and fault model, and
+ *   optionally the air around it served by the SHT4x simulator on the
+ *   same bus
+ * - a battery on the ADC whose voltage follows the consumed charge, and
+ *   optionally a solar panel charging it in daylight (half-sine current,
+ *   charger lift on the pack voltage, nothing absorbed once full)
+ * - a scripted network: first join latency, per-wake rejoin latency and
+ *   rejoin failure probability, routers in range with their link loss,
+ *   and one link change part way through
+ * - optionally a Green Power sink (gp_sink.h): the coordinator requests
+ *   the commissioning-free uplink at the first wake, and frames the sink
+ *   accepts count as delivered reports
+ *
+ * Each wake is charged with a per-phase current model (boot, awake with
+ * the radio off, awake with the Zigbee stack or the raw radio on, deep
+ * sleep), so
+ * months of operation run in seconds and give mAh/day, awake time and
+ * the charge spent per report that reached the coordinator (a report
+ * lost on the parent link is paid for but not counted).
+ */
+
+#ifndef WAKE_SIM_H
+#define WAKE_SIM_H
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "host_sim.h"
+#include "seesaw_sim.h"
+#include "sht4x_sim.h"
+
+// Per-phase current model
+typedef struct {
+    float boot_ms;                    // ROM + bootloader + startup before app_main
+    float boot_ma;
+    float awake_ma;                   // CPU, sensor rail, radio off
+    float radio_ma;                   // Zigbee stack running or raw radio on (RX on, TX bursts)
+    float sleep_ua;                   // Deep sleep, whole board
+} wake_sim_current_t;
+
+typedef struct {
+    uint32_t days;                    // Simulated duration
+    uint32_t seed;                    // PRNG seed (network and sensor faults)
+    int log_level;                    // Firmware log level (ESP_LOG_NONE..)
+
+    // Soil and battery
+    float moisture_wet_pct;           // Right after watering
+    float moisture_dry_pct;           // Floor while drying out
+    float drying_pct_per_day;
+    float watering_interval_days;     // 0 = never watered
+    float temp_mean_c;
+    float temp_swing_c;               // Diurnal amplitude
+    float battery_mah;                // Capacity (voltage follows charge used)
+    float solar_peak_ma;              // Panel charge current at noon (0 = no panel)
+    float solar_day_hours;            // Daylight centred on noon
+
+    // Network
+    uint32_t first_join_ms;           // Steering latency at the first boot
+    uint32_t rejoin_ms;               // Rejoin latency on every later wake
+    uint32_t rejoin_jitter_ms;        // Uniform extra latency 0..jitter
+    float rejoin_failure;             // Probability a wake cannot rejoin
+    host_zb_router_t routers[HOST_ZB_MAX_ROUTERS];   // Routers in range
+    size_t router_count;              // 0 = coordinator only (host default)
+    float link_change_day;            // Day router link_change_router changes (0 = never)
+    size_t link_change_router;
+    uint8_t link_change_lqi;
+    int8_t link_change_rssi;
+    float link_change_loss;
+    bool gp_uplink;                   // Coordinator pairs the uplink at the first wake
+    float gp_loss;                    // Probability the sink misses one frame copy
+
+    seesaw_sim_config_t sensor;       // Sensor latency and faults
+    bool ambient;                     // SHT4x on the bus (else its address NACKs)
+    float air_humidity_pct;           // Daily mean; falls as the air warms
+    sht4x_sim_config_t ambient_sensor;
+    wake_sim_current_t current;
+
+    host_zb_event_hook_t zb_event_hook;   // Optional: stack activity of every wake
+    void *zb_event_ctx;
+} wake_sim_config_t;
+
+typedef struct {
+    double days;                      // Simulated time
+    uint32_t wakes;
+    uint32_t sense_wakes;             // Radio-free watering checks
+    uint32_t radio_wakes;             // Wakes that started the Zigbee stack
+    uint32_t gp_wakes;                // Wakes that sent an uplink frame instead
+    uint32_t rejoin_failures;         // Scripted failures
+    uint32_t reports;                 // Report wakes that reached the coordinator
+    uint32_t gp_reports;              // Of which as uplink frames
+    uint32_t lost_reports;            // Report wakes lost on the parent link
+    uint32_t parent_changes;          // Wakes that ended on a different parent
+    uint32_t watering_reports;        // Of which carried a watering event
+    double awake_s;
+    double radio_s;
+    double charge_mah;
+    double harvest_mah;               // Panel charge absorbed by the pack
+    uint32_t harvest_wakes;           // Wakes that ended on the HARVEST profile
+    uint32_t night_wakes;             // Wakes that ended on the NIGHT profile
+
+    double mah_per_day;
+    double awake_s_per_day;
+    double reports_per_day;
+    double uah_per_report;            // Charge per delivered report
+    double battery_days;              // Projected life on battery_mah
+} wake_sim_result_t;
+
+/**
+ * @brief Nominal models (Balanced profile, healthy network and sensor)
+ */
+void wake_sim_default_config(wake_sim_config_t *config);
+
+/**
+ * @brief Charge of one wake and the sleep that follows it
+ * @param current Current model
+ * @param awake_us Time awake after boot (app_main to deep sleep)
+ * @param radio_us Part of awake_us with the Zigbee stack or raw radio on
+ * @param sleep_us Deep sleep duration
+ * @return Charge in mAh (boot included)
+ */
+double wake_sim_charge_mah(const wake_sim_current_t *current, double awake_us, double radio_us, double sleep_us);
+
+/**
+ * @brief Run the deep-sleep firmware for config->days of virtual time
+ *
+ * Resets every host fake first (host_sim_reset).
+ *
+ * @param config Models
+ * @param result Totals and per-day figures
+ * @return ESP_OK, or ESP_FAIL if the firmware stopped deep sleeping
+ */
+esp_err_t wake_sim_run(const wake_sim_config_t *config, wake_sim_result_t *result);
+
+#endif // WAKE_SIM_H
@@ -0,0 +1,71 @@
+/*
+ * Glyph C6 Monitor - Host Unit Test Runner
+ *
+ * Tests register themselves at load time; host_sim_reset() runs before
+ * each one. A failed assertion ends the current test only.
+ *
+ *     HOST_TEST(soil_sensor, reads_moisture)
+ *     {
+ *         HOST_ASSERT_EQ(ESP_OK, soil_sensor_read_moisture(&raw, &pct));
+ *     }
+ *
+ * Run all tests, or only the suites/tests whose "suite.name" starts with
+ * the given prefix: host_tests [prefix]
+ */
+
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+typedef void (*host_test_fn_t)(void);
+
+typedef struct host_test_case {
+    const char *suite;
+    const char *name;
+    host_test_fn_t fn;
+    struct host_test_case *next;
+} host_test_case_t;
+
+void host_test_register(host_test_case_t *test);
+void host_test_fail(const char *file, int line, const char *fmt, ...)
+    __attribute__((noreturn, format(printf, 3, 4)));
+
+#define HOST_TEST(suite, name)                                                  \
+    static void host_test_##suite##_##name(void);                               \
+    static host_test_case_t host_test_case_##suite##_##name = {                 \
+        #suite, #name, host_test_##suite##_##name, NULL                         \
+    };                                                                          \
+    __attribute__((constructor)) static void host_test_reg_##suite##_##name(void) \
+    {                                                                           \
+        host_test_register(&host_test_case_##suite##_##name);                   \
+    }                                                                           \
+    static void host_test_##suite##_##name(void)
+
+#define HOST_ASSERT(cond) do {                                                  \
+        if (!(cond)) {                                                          \
+            host_test_fail(__FILE__, __LINE__, "%s", #cond);                    \
+        }                                                                       \
+    } while (0)
+
+#define HOST_ASSERT_EQ(expected, actual) do {                                   \
+        long long e_ = (long long)(expected);                                   \
+        long long a_ = (long long)(actual);                                     \
+        if (e_ != a_) {                                                         \
+            host_test_fail(__FILE__, __LINE__, "%s == %s: expected %lld, got %lld", \
+                           #expected, #actual, e_, a_);                         \
+        }                                                                       \
+    } while (0)
+
+#define HOST_ASSERT_NEAR(expected, actual, tolerance) do {                      \
+        double e_ = (double)(expected);                                         \
+        double a_ = (double)(actual);                                           \
+        if (fabs(e_ - a_) > (double)(tolerance)) {                              \
+            host_test_fail(__FILE__, __LINE__, "%s ~= %s: expected %g, got %g (tolerance %g)", \
+                           #expected, #actual, e_, a_, (double)(tolerance));    \
+        }                                                                       \
+    } while (0)
+
+#endif // HOST_TEST_H
@@ -0,0 +1,130 @@
+/*
+ * Glyph C6 Monitor - app_loop host tests
+ *
+ * The loop task runs on the harness stack through host_task_run() and
+ * never returns; each test ends it the way the firmware does, with a
+ * deep sleep caught by HOST_DEEP_SLEEP_CATCH().
+ */
+
+#include "host_test.h"
+#include "host_sim.h"
+#include "app_loop.h"
+#include "esp_sleep.h"
+
+enum {
+    EVT_FIRST = 0,
+    EVT_SECOND,
+    EVT_DELAYED,
+    EVT_TICK,
+    EVT_STOP,
+};
+
+#define MAX_SEEN  16
+
+static struct {
+    uint8_t id;
+    uint32_t arg;
+    uint64_t at_ms;
+} seen[MAX_SEEN];
+static int seen_count;
+static int ticks_until_stop;
+
+static void record(const app_event_t *event)
+{
+    if (seen_count < MAX_SEEN) {
+        seen[seen_count].id = event->id;
+        seen[seen_count].arg = event->arg;
+        seen[seen_count].at_ms = host_time_since_boot_us() / 1000;
+        seen_count++;
+    }
+}
+
+static void handler(const app_event_t *event)
+{
+    record(event);
+    switch (event->id) {
+    case EVT_TICK:
+        if (--ticks_until_stop == 0) {
+            app_loop_cancel(EVT_TICK);
+            app_loop_post_after(EVT_STOP, 50);
+        }
+        break;
+    case EVT_STOP:
+        esp_deep_sleep_start();
+        break;
+    default:
+        break;
+    }
+}
+
+static void run_loop(void)
+{
+    if (!HOST_DEEP_SLEEP_CATCH()) {
+        host_task_run("app_loop");
+        HOST_ASSERT(false);  // The loop only ends in deep sleep
+    }
+}
+
+static void reset_recording(int ticks)
+{
+    seen_count = 0;
+    ticks_until_stop = ticks;
+}
+
+HOST_TEST(app_loop, posts_run_in_order_with_their_args)
+{
+    reset_recording(0);
+    HOST_ASSERT_EQ(ESP_OK, app_loop_start("app_loop", handler));
+    HOST_ASSERT_EQ(ESP_ERR_INVALID_STATE, app_loop_start("app_loop", handler));
+
+    HOST_ASSERT(app_loop_post(EVT_FIRST, 7));
+    HOST_ASSERT(app_loop_post(EVT_SECOND, 9));
+    HOST_ASSERT(app_loop_post(EVT_STOP, 0));
+    run_loop();
+
+    HOST_ASSERT_EQ(3, seen_count);
+    HOST_ASSERT_EQ(EVT_FIRST, seen[0].id);
+    HOST_ASSERT_EQ(7, seen[0].arg);
+    HOST_ASSERT_EQ(EVT_SECOND, seen[1].id);
+    HOST_ASSERT_EQ(9, seen[1].arg);
+    HOST_ASSERT_EQ(0, seen[2].at_ms);  // No virtual time passed
+}
+
+HOST_TEST(app_loop, timers_post_on_virtual_time)
+{
+    reset_recording(3);
+    HOST_ASSERT_EQ(ESP_OK, app_loop_start("app_loop", handler));
+
+    HOST_ASSERT_EQ(ESP_OK, app_loop_post_after(EVT_DELAYED, 1000));
+    HOST_ASSERT_EQ(ESP_OK, app_loop_post_after(EVT_DELAYED, 250));   // Re-arm replaces
+    HOST_ASSERT_EQ(ESP_OK, app_loop_post_every(EVT_TICK, 100));
+    run_loop();
+
+    // Ticks at 100/200/300 ms, the delayed post once at 250 ms, stop 50 ms after the last tick
+    HOST_ASSERT_EQ(5, seen_count);
+    HOST_ASSERT_EQ(EVT_TICK, seen[0].id);
+    HOST_ASSERT_EQ(100, seen[0].at_ms);
+    HOST_ASSERT_EQ(EVT_TICK, seen[1].id);
+    HOST_ASSERT_EQ(200, seen[1].at_ms);
+    HOST_ASSERT_EQ(EVT_DELAYED, seen[2].id);
+    HOST_ASSERT_EQ(250, seen[2].at_ms);
+    HOST_ASSERT_EQ(EVT_TICK, seen[3].id);
+    HOST_ASSERT_EQ(300, seen[3].at_ms);
+    HOST_ASSERT_EQ(EVT_STOP, seen[4].id);
+    HOST_ASSERT_EQ(350, seen[4].at_ms);
+}
+
+HOST_TEST(app_loop, rejects_bad_ids_and_full_queue)
+{
+    HOST_ASSERT(!app_loop_post(EVT_FIRST, 0));  // Not started
+    HOST_ASSERT_EQ(ESP_OK, app_loop_start("app_loop", handler));
+    HOST_ASSERT_EQ(ESP_ERR_INVALID_ARG, app_loop_post_after(APP_LOOP_MAX_EVENTS, 10));
+
+    int queued = 0;
+    while (app_loop_post(EVT_FIRST, 0)) {
+        queued++;
+        HOST_ASSERT(queued <= 64);
+    }
+    HOST_ASSERT(queued > 0);
+    HOST_ASSERT(app_loop_stack_unused() > 0);
+}
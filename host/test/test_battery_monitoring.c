@@ -0,0 +1,74 @@
+/*
+ * Glyph C6 Monitor - battery_monitoring host tests
+ */
+
+#include "host_test.h"
+#include "host_sim.h"
+#include "battery_monitoring.h"
+#include "system_config.h"
+
+#define BATT_CH   0   // BATT_MSR_ADC_CHANNEL
+
+static int ramp_mv;
+
+static int ramp_source(int channel, void *ctx)
+{
+    (void)channel;
+    (void)ctx;
+    return ramp_mv += 10;
+}
+
+HOST_TEST(battery_monitoring, divider_and_curve)
+{
+    host_adc_set_mv(BATT_CH, 1850);              // 3.70 V battery
+    HOST_ASSERT_EQ(ESP_OK, battery_monitoring_init());
+    float v, pct;
+    HOST_ASSERT_EQ(ESP_OK, battery_read(&v, &pct));
+    HOST_ASSERT_NEAR(3.70, v, 0.01);
+    HOST_ASSERT_NEAR(50.0, pct, 2.0);
+    HOST_ASSERT(!battery_is_usb_present());
+}
+
+HOST_TEST(battery_monitoring, usb_reads_as_full)
+{
+    host_adc_set_mv(BATT_CH, 2400);              // 4.8 V on VBUS
+    HOST_ASSERT_EQ(ESP_OK, battery_monitoring_init());
+    float v, pct;
+    HOST_ASSERT_EQ(ESP_OK, battery_read(&v, &pct));
+    HOST_ASSERT_NEAR(100.0, pct, 0.001);
+    HOST_ASSERT(battery_is_usb_present());
+}
+
+HOST_TEST(battery_monitoring, averages_samples_over_virtual_time)
+{
+    ramp_mv = 1800;
+    host_adc_set_source(BATT_CH, ramp_source, NULL);
+    HOST_ASSERT_EQ(ESP_OK, battery_monitoring_init());
+    uint64_t start = host_time_since_boot_us();
+    float v, pct;
+    HOST_ASSERT_EQ(ESP_OK, battery_read(&v, &pct));
+    HOST_ASSERT_EQ(BATTERY_SAMPLES_AVG, host_adc_read_count());
+    HOST_ASSERT_EQ(BATTERY_SAMPLES_AVG * 10000ULL, host_time_since_boot_us() - start);
+    HOST_ASSERT_NEAR((1800 + 5.5 * 10) * 2 / 1000.0, v, 0.01);   // Mean of 1810..1900 mV
+}
+
+HOST_TEST(battery_monitoring, failed_conversions_are_skipped)
+{
+    host_adc_set_mv(BATT_CH, 1850);
+    HOST_ASSERT_EQ(ESP_OK, battery_monitoring_init());
+    host_adc_fail_next(BATTERY_SAMPLES_AVG - 1);
+    float v, pct;
+    HOST_ASSERT_EQ(ESP_OK, battery_read(&v, &pct));
+    HOST_ASSERT_NEAR(3.70, v, 0.01);
+    host_adc_fail_next(BATTERY_SAMPLES_AVG);
+    HOST_ASSERT_EQ(ESP_FAIL, battery_read(&v, &pct));
+}
+
+HOST_TEST(battery_monitoring, no_calibration_no_reading)
+{
+    host_adc_set_mv(BATT_CH, 1850);
+    host_adc_set_calibration_available(false);
+    HOST_ASSERT_EQ(ESP_OK, battery_monitoring_init());
+    float v, pct;
+    HOST_ASSERT_EQ(ESP_FAIL, battery_read(&v, &pct));
+}
@@ -0,0 +1,136 @@
+/*
+ * Glyph C6 Monitor - charge_state host tests
+ *
+ * Pack voltage traces fed at hourly (battery) or 15-minute (harvest)
+ * readings; times in seconds.
+ */
+
+#include "host_test.h"
+#include "host_sim.h"
+#include "charge_state.h"
+#include "system_config.h"
+
+#define HOUR    3600
+
+static charge_phase_t feed(charge_state_t *cs, uint32_t *t, uint32_t step, int n, int mv, int mv_per_step)
+{
+    charge_phase_t phase = CHARGE_PHASE_UNKNOWN;
+    for (int i = 0; i < n; i++) {
+        phase = charge_state_update(cs, (uint16_t)mv, *t);
+        mv += mv_per_step;
+        *t += step;
+    }
+    return phase;
+}
+
+HOST_TEST(charge_state, slope_needs_enough_spread_samples)
+{
+    charge_state_t cs;
+    charge_state_reset(&cs);
+    int32_t slope;
+
+    HOST_ASSERT_EQ(CHARGE_PHASE_UNKNOWN, charge_state_update(&cs, 3900, 1000));
+    HOST_ASSERT_EQ(CHARGE_PHASE_UNKNOWN, charge_state_update(&cs, 3910, 1000 + 60));   // Too close: not stored
+    HOST_ASSERT_EQ(1, cs.count);
+    HOST_ASSERT(!charge_state_slope(&cs, 1060, &slope));
+
+    charge_state_update(&cs, 3910, 1000 + HOUR);
+    charge_state_update(&cs, 3920, 1000 + 2 * HOUR);
+    HOST_ASSERT(charge_state_slope(&cs, 1000 + 2 * HOUR, &slope));
+    HOST_ASSERT_EQ(10, slope);
+
+    // Samples older than the window drop out
+    HOST_ASSERT(!charge_state_slope(&cs, 1000 + 2 * HOUR + CHARGE_WINDOW_SEC, &slope));
+}
+
+HOST_TEST(charge_state, plain_battery_never_harvests)
+{
+    charge_state_t cs;
+    charge_state_reset(&cs);
+    uint32_t t = 0;
+
+    // A week of slow discharge with +-4 mV of ADC noise
+    int mv = 4000;
+    for (int i = 0; i < 7 * 24; i++) {
+        int noise = (i * 7919) % 9 - 4;
+        charge_phase_t phase = charge_state_update(&cs, (uint16_t)(mv + noise), t);
+        HOST_ASSERT(phase != CHARGE_PHASE_HARVEST);
+        t += HOUR;
+        mv -= (i % 3 == 0) ? 1 : 0;
+    }
+    HOST_ASSERT_EQ(CHARGE_PHASE_BATTERY, cs.phase);
+    HOST_ASSERT(!cs.harvest_seen);
+}
+
+HOST_TEST(charge_state, rising_pack_is_a_harvest_then_dark)
+{
+    charge_state_t cs;
+    charge_state_reset(&cs);
+    uint32_t t = 0;
+
+    HOST_ASSERT_EQ(CHARGE_PHASE_BATTERY, feed(&cs, &t, HOUR, 4, 3800, -1));
+    // Two rising slopes in a row
+    HOST_ASSERT_EQ(CHARGE_PHASE_HARVEST, feed(&cs, &t, HOUR, 4, 3800, 15));
+
+    // Harvest readings come every 15 minutes
+    HOST_ASSERT_EQ(CHARGE_PHASE_HARVEST, feed(&cs, &t, 900, 16, 3850, 4));
+    HOST_ASSERT(cs.harvest_gain_mv >= 100);
+    HOST_ASSERT(!cs.last_harvest_full);
+
+    // Sunset: the charger lift goes away and the pack sags
+    HOST_ASSERT_EQ(CHARGE_PHASE_DARK, feed(&cs, &t, 900, 8, 3910, -4));
+    HOST_ASSERT_EQ(1, cs.harvest_periods);
+    HOST_ASSERT(cs.harvest_total_sec > 4 * HOUR);
+
+    // No harvest for a day: plain battery node again
+    HOST_ASSERT_EQ(CHARGE_PHASE_BATTERY, feed(&cs, &t, HOUR, 27, 3880, 0));
+}
+
+HOST_TEST(charge_state, two_hour_samples_still_see_the_next_harvest)
+{
+    charge_state_t cs;
+    charge_state_reset(&cs);
+    uint32_t t = 0;
+
+    HOST_ASSERT_EQ(CHARGE_PHASE_HARVEST, feed(&cs, &t, HOUR, 8, 3800, 15));
+    HOST_ASSERT_EQ(CHARGE_PHASE_DARK, feed(&cs, &t, 900, 8, 3910, -4));
+
+    // Dark after a partial charge: samples every 2 h (Balanced profile),
+    // only 2 of them inside CHARGE_WINDOW_SEC
+    const uint32_t dark = 2 * HOUR;
+    HOST_ASSERT_EQ(CHARGE_PHASE_DARK, feed(&cs, &t, dark, 5, 3880, -2));
+
+    // Morning: +40 mV per sample
+    HOST_ASSERT_EQ(CHARGE_PHASE_HARVEST, feed(&cs, &t, dark, 4, 3880, 40));
+    HOST_ASSERT_EQ(1, cs.harvest_periods);
+}
+
+HOST_TEST(charge_state, sparse_dark_samples_time_out_to_battery)
+{
+    charge_state_t cs;
+    charge_state_reset(&cs);
+    uint32_t t = 0;
+
+    HOST_ASSERT_EQ(CHARGE_PHASE_HARVEST, feed(&cs, &t, HOUR, 8, 3800, 15));
+    HOST_ASSERT_EQ(CHARGE_PHASE_DARK, feed(&cs, &t, 900, 8, 3910, -4));
+
+    // Ultra-low-power interval: no harvest for a day ends the dark phase
+    HOST_ASSERT_EQ(CHARGE_PHASE_BATTERY, feed(&cs, &t, 2 * HOUR, CHARGE_DAY_SEC / (2 * HOUR) + 2, 3880, 0));
+}
+
+HOST_TEST(charge_state, full_pack_at_float_keeps_harvesting)
+{
+    charge_state_t cs;
+    charge_state_reset(&cs);
+    uint32_t t = 0;
+
+    HOST_ASSERT_EQ(CHARGE_PHASE_HARVEST, feed(&cs, &t, HOUR, 6, 4050, 10));
+    // Held at float: no rise, but the charger still supplies the node
+    HOST_ASSERT_EQ(CHARGE_PHASE_HARVEST, feed(&cs, &t, 900, 24, 4110, 0));
+    HOST_ASSERT(cs.last_harvest_full);
+
+    // ... but no daylight period lasts CHARGE_HARVEST_MAX_SEC
+    feed(&cs, &t, 900, CHARGE_HARVEST_MAX_SEC / 900, 4110, 0);
+    HOST_ASSERT_EQ(CHARGE_PHASE_DARK, cs.phase);
+    HOST_ASSERT(cs.last_harvest_full);
+}
@@ -0,0 +1,70 @@
+/*
+ * Glyph C6 Monitor - deep_sleep host tests
+ */
+
+#include "host_test.h"
+#include "host_sim.h"
+#include "deep_sleep.h"
+#include "esp_sleep.h"
+
+HOST_TEST(deep_sleep, first_boot_reads_sensors)
+{
+    HOST_ASSERT_EQ(ESP_OK, deep_sleep_init());
+    deep_sleep_state_t state;
+    HOST_ASSERT(deep_sleep_get_state(&state));
+    HOST_ASSERT_EQ(1, state.boot_count);
+    HOST_ASSERT(state.first_boot);
+    HOST_ASSERT(deep_sleep_should_read_sensors());
+}
+
+HOST_TEST(deep_sleep, sleeps_for_interval_and_wakes_by_timer)
+{
+    HOST_ASSERT_EQ(ESP_OK, deep_sleep_init());
+    deep_sleep_set_interval(600);
+    deep_sleep_mark_sensors_read();
+    uint32_t before = deep_sleep_get_time_sec();
+
+    if (!HOST_DEEP_SLEEP_CATCH()) {
+        deep_sleep_enter();
+        HOST_ASSERT(false);  // Not reached
+    }
+
+    HOST_ASSERT_EQ(1, host_sleep_count());
+    HOST_ASSERT_EQ(600ULL * 1000000, host_sleep_last_duration_us());
+    HOST_ASSERT_EQ(ESP_SLEEP_WAKEUP_TIMER, esp_sleep_get_wakeup_cause());
+    HOST_ASSERT_EQ(0, host_time_since_boot_us());
+    HOST_ASSERT_EQ(before + 600, deep_sleep_get_time_sec());
+
+    HOST_ASSERT_EQ(ESP_OK, deep_sleep_init());
+    deep_sleep_state_t state;
+    HOST_ASSERT(deep_sleep_get_state(&state));
+    HOST_ASSERT_EQ(2, state.boot_count);
+    HOST_ASSERT(!state.first_boot);
+    HOST_ASSERT(deep_sleep_should_read_sensors());
+}
+
+HOST_TEST(deep_sleep, max_sleep_caps_without_moving_schedule)
+{
+    HOST_ASSERT_EQ(ESP_OK, deep_sleep_init());
+    deep_sleep_set_interval(3600);
+    deep_sleep_set_max_sleep(300);
+    deep_sleep_mark_sensors_read();
+
+    if (!HOST_DEEP_SLEEP_CATCH()) {
+        deep_sleep_enter();
+    }
+    HOST_ASSERT_EQ(300ULL * 1000000, host_sleep_last_duration_us());
+
+    HOST_ASSERT_EQ(ESP_OK, deep_sleep_init());
+    HOST_ASSERT(!deep_sleep_should_read_sensors());
+    HOST_ASSERT_NEAR(3300, deep_sleep_time_until_next_reading(), 1);
+}
+
+HOST_TEST(deep_sleep, rtc_state_resets_between_tests)
+{
+    // host_sim_reset() is a power-on: RTC memory back to its initializers
+    HOST_ASSERT_EQ(ESP_OK, deep_sleep_init());
+    deep_sleep_state_t state;
+    HOST_ASSERT(deep_sleep_get_state(&state));
+    HOST_ASSERT_EQ(1, state.boot_count);
+}
@@ -0,0 +1,202 @@
+/*
+ * Glyph C6 Monitor - gp_uplink host tests
+ *
+ * Frames go through the raw 802.15.4 shim into the reference sink
+ * (sim/gp_sink.c). A deep sleep is host_time_reboot() (RTC memory kept),
+ * a power loss host_sim_power_cycle() (NVS kept).
+ */
+
+#include "host_test.h"
+#include "host_sim.h"
+#include "gp_uplink.h"
+#include "gp_sink.h"
+#include "system_config.h"
+#include "nvs_flash.h"
+
+#define CHANNEL    15
+
+static gp_sink_t sink;
+
+static void boot(void)
+{
+    HOST_ASSERT_EQ(ESP_OK, nvs_flash_init());
+    gp_uplink_init();
+}
+
+static gp_reading_t reading(uint16_t moisture)
+{
+    gp_reading_t r = {
+        .flags = GP_READING_FLAG_WATERING,
+        .moisture_centi = moisture,
+        .temp_centi = -1250,
+        .battery_decivolts = 37,
+        .battery_half_pct = 160,
+        .watering_events = 3,
+        .age_sec = 42,
+    };
+    return r;
+}
+
+/**
+ * @brief Request the uplink and commission at the next boot, sink listening
+ */
+static void pair(void)
+{
+    gp_sink_init(&sink);
+    host_ieee802154_set_tx_hook(gp_sink_tx_hook, &sink);
+    boot();
+    HOST_ASSERT_EQ(ESP_OK, gp_uplink_request(true, CHANNEL));
+    HOST_ASSERT(gp_uplink_commission_pending());
+
+    gp_sink_set_commissioning(&sink, true);
+    host_time_reboot();
+    boot();
+    gp_sink_set_commissioning(&sink, false);
+    HOST_ASSERT(!gp_uplink_commission_pending());
+    HOST_ASSERT_EQ(1, sink.stats.commissioned);
+    HOST_ASSERT_EQ(GP_TX_REPEATS - 1, sink.stats.duplicates);
+    HOST_ASSERT_EQ(gp_uplink_src_id(), sink.src_id);
+
+    // The commissioning wake reports the SrcID through a full wake
+    HOST_ASSERT(!gp_uplink_use_this_wake());
+    gp_uplink_full_wake(CHANNEL);
+    HOST_ASSERT(gp_uplink_use_this_wake());
+}
+
+static const host_ieee802154_frame_t *last_frame(void)
+{
+    return host_ieee802154_frame_get(host_ieee802154_frame_count() - 1);
+}
+
+HOST_TEST(gp_uplink, commissioning_then_readings_reach_the_sink)
+{
+    pair();
+    const host_ieee802154_frame_t *f = last_frame();
+    HOST_ASSERT_EQ(CHANNEL, f->channel);
+
+    gp_reading_t sent = reading(4321);
+    HOST_ASSERT_EQ(ESP_OK, gp_uplink_send(&sent));
+    HOST_ASSERT_EQ(1, sink.stats.readings);
+    HOST_ASSERT_EQ(GP_TX_REPEATS - 1 + GP_TX_REPEATS - 1, sink.stats.duplicates);
+    HOST_ASSERT_EQ(sent.flags, sink.last_reading.flags);
+    HOST_ASSERT_EQ(sent.moisture_centi, sink.last_reading.moisture_centi);
+    HOST_ASSERT_EQ(sent.temp_centi, sink.last_reading.temp_centi);
+    HOST_ASSERT_EQ(sent.battery_decivolts, sink.last_reading.battery_decivolts);
+    HOST_ASSERT_EQ(sent.battery_half_pct, sink.last_reading.battery_half_pct);
+    HOST_ASSERT_EQ(sent.watering_events, sink.last_reading.watering_events);
+    HOST_ASSERT_EQ(sent.age_sec, sink.last_reading.age_sec);
+
+    // Secured frame: header, counter, command, reading, MIC
+    f = last_frame();
+    HOST_ASSERT_EQ(7 + 6 + 4 + 1 + GP_READING_LEN + GP_MIC_LEN, f->len);
+    HOST_ASSERT_EQ(GP_EXT_NWK_FC_SECURED, f->psdu[8]);
+
+    // Radio only on for the frame copies, and off afterwards
+    HOST_ASSERT(host_ieee802154_on_us() > 0);
+    HOST_ASSERT(host_ieee802154_on_us() < 3 * (uint64_t)GP_TX_REPEATS * GP_TX_GAP_US);
+}
+
+HOST_TEST(gp_uplink, tampered_frame_is_rejected)
+{
+    pair();
+    gp_reading_t sent = reading(1000);
+    HOST_ASSERT_EQ(ESP_OK, gp_uplink_send(&sent));
+
+    host_ieee802154_frame_t f = *last_frame();
+    f.psdu[7 + 6 + 4 + 1 + 1] ^= 0x01;          // Moisture
+    gp_sink_t copy = sink;
+    copy.next_counter = 0;                       // Not a replay
+    HOST_ASSERT_EQ(GP_SINK_REJECTED, gp_sink_receive(&copy, f.psdu, f.len, NULL));
+}
+
+HOST_TEST(gp_uplink, replayed_frame_is_dropped)
+{
+    pair();
+    gp_reading_t first = reading(1000);
+    HOST_ASSERT_EQ(ESP_OK, gp_uplink_send(&first));
+    host_ieee802154_frame_t old = *last_frame();
+    gp_reading_t second = reading(2000);
+    HOST_ASSERT_EQ(ESP_OK, gp_uplink_send(&second));
+
+    HOST_ASSERT_EQ(GP_SINK_DUPLICATE, gp_sink_receive(&sink, old.psdu, old.len, NULL));
+    HOST_ASSERT_EQ(2000, sink.last_reading.moisture_centi);
+}
+
+HOST_TEST(gp_uplink, counter_survives_power_loss_without_flash_per_frame)
+{
+    pair();
+    gp_reading_t r = reading(1000);
+
+    // Deep sleep cycles: counter in RTC memory, no flash write within a block
+    uint32_t commits_before = host_nvs_commit_count();
+    for (int i = 0; i < 10; i++) {
+        host_time_reboot();
+        boot();
+        gp_uplink_full_wake(CHANNEL);
+        HOST_ASSERT_EQ(ESP_OK, gp_uplink_send(&r));
+    }
+    HOST_ASSERT_EQ(10, sink.stats.readings);
+    HOST_ASSERT_EQ(0, host_nvs_commit_count() - commits_before);
+
+    // Power loss: pairing from NVS, counting resumes past the reserved block
+    host_sim_power_cycle();
+    boot();
+    HOST_ASSERT_EQ(sink.src_id, gp_uplink_src_id());
+    HOST_ASSERT(!gp_uplink_use_this_wake());       // Full wake first after a cold boot
+    gp_uplink_full_wake(CHANNEL);
+    HOST_ASSERT_EQ(ESP_OK, gp_uplink_send(&r));
+    HOST_ASSERT_EQ(11, sink.stats.readings);
+    HOST_ASSERT_EQ(GP_COUNTER_BLOCK + 1, sink.next_counter);
+}
+
+HOST_TEST(gp_uplink, full_wake_every_configured_reports)
+{
+    pair();
+    gp_reading_t r = reading(1000);
+    for (int i = 0; i < GP_FULL_WAKE_REPORTS; i++) {
+        HOST_ASSERT(gp_uplink_use_this_wake());
+        HOST_ASSERT_EQ(ESP_OK, gp_uplink_send(&r));
+    }
+    HOST_ASSERT(!gp_uplink_use_this_wake());
+
+    // The network moved meanwhile: frames follow it
+    gp_uplink_full_wake(CHANNEL + 5);
+    HOST_ASSERT(gp_uplink_use_this_wake());
+    HOST_ASSERT_EQ(ESP_OK, gp_uplink_send(&r));
+    HOST_ASSERT_EQ(CHANNEL + 5, last_frame()->channel);
+}
+
+HOST_TEST(gp_uplink, disabling_forgets_the_pairing)
+{
+    pair();
+    HOST_ASSERT(gp_uplink_requested());
+    HOST_ASSERT_EQ(ESP_OK, gp_uplink_request(false, CHANNEL));
+    HOST_ASSERT(!gp_uplink_requested());
+    HOST_ASSERT(!gp_uplink_use_this_wake());
+    HOST_ASSERT_EQ(0, gp_uplink_src_id());
+
+    gp_reading_t r = reading(1000);
+    HOST_ASSERT_EQ(ESP_ERR_INVALID_STATE, gp_uplink_send(&r));
+
+    // Also after a power loss
+    host_sim_power_cycle();
+    boot();
+    HOST_ASSERT_EQ(0, gp_uplink_src_id());
+}
+
+HOST_TEST(gp_uplink, commissioning_outside_sink_mode_is_ignored)
+{
+    gp_sink_init(&sink);
+    host_ieee802154_set_tx_hook(gp_sink_tx_hook, &sink);
+    boot();
+    HOST_ASSERT_EQ(ESP_ERR_INVALID_ARG, gp_uplink_request(true, 0));
+    HOST_ASSERT_EQ(ESP_OK, gp_uplink_request(true, CHANNEL));
+    host_time_reboot();
+    boot();
+    HOST_ASSERT_EQ(0, sink.stats.commissioned);
+    HOST_ASSERT_EQ(GP_TX_REPEATS, sink.stats.ignored);
+
+    gp_reading_t r = reading(1000);
+    HOST_ASSERT_EQ(ESP_OK, gp_uplink_send(&r));
+    HOST_ASSERT_EQ(0, sink.stats.readings);
+}
@@ -0,0 +1,78 @@
+/*
+ * Glyph C6 Monitor - Host Unit Test Runner
+ *
+ * Version: 1.0.0
+ */
+
+#include "host_test.h"
+#include "host_sim.h"
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+static host_test_case_t *tests;
+static host_test_case_t **tests_tail = &tests;
+static jmp_buf test_exit;
+static int run;                          // File scope: kept across longjmp
+static int failed;
+
+void host_test_register(host_test_case_t *test)
+{
+    // Keep declaration order within a file
+    *tests_tail = test;
+    tests_tail = &test->next;
+}
+
+void host_test_fail(const char *file, int line, const char *fmt, ...)
+{
+    va_list args;
+    printf("    %s:%d: ", file, line);
+    va_start(args, fmt);
+    vprintf(fmt, args);
+    va_end(args);
+    printf("\n");
+    longjmp(test_exit, 1);
+}
+
+static bool matches(const host_test_case_t *test, const char *prefix)
+{
+    char full[128];
+    snprintf(full, sizeof(full), "%s.%s", test->suite, test->name);
+    return strncmp(full, prefix, strlen(prefix)) == 0;
+}
+
+/**
+ * @brief Run one test; a failed assertion longjmps back here
+ */
+static void run_one(const host_test_case_t *test)
+{
+    if (setjmp(test_exit) == 0) {
+        test->fn();
+        printf("[ PASS ] %s.%s\n", test->suite, test->name);
+    } else {
+        printf("[ FAIL ] %s.%s\n", test->suite, test->name);
+        failed++;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const char *prefix = argc > 1 ? argv[1] : "";
+
+    for (host_test_case_t *test = tests; test; test = test->next) {
+        if (!matches(test, prefix)) {
+            continue;
+        }
+        run++;
+        host_sim_reset();
+        run_one(test);
+    }
+
+    printf("%d test(s), %d failed\n", run, failed);
+    if (run == 0) {
+        printf("No test matches '%s'\n", prefix);
+        return 1;
+    }
+    return failed ? 1 : 0;
+}
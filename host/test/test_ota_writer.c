@@ -0,0 +1,201 @@
+/*
+ * Glyph C6 Monitor - ota_writer host tests
+ *
+ * The Zigbee side (ota_writer_write) and the app loop side
+ * (ota_writer_process after each notify) are interleaved by hand, block
+ * by block, the way the two tasks run on the chip.
+ */
+
+#include "host_test.h"
+#include "host_sim.h"
+#include "ota_writer.h"
+#include "system_config.h"
+#include "esp_ota_ops.h"
+#include "esp_partition.h"
+#include "mbedtls/sha256.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define IMAGE_SIZE    50000       // Not a multiple of the page size
+#define BLOCK_SIZE    64          // Zigbee OTA image block payload
+#define TAG_LEN       6
+
+static uint8_t file[TAG_LEN + IMAGE_SIZE];
+static int notifications;
+
+static void notify(void)
+{
+    notifications++;
+}
+
+/**
+ * @brief OTA upgrade image element: tag header + ESP-IDF app image with its SHA-256
+ */
+static void build_file(void)
+{
+    uint8_t *image = file + TAG_LEN;
+    file[0] = 0x00;
+    file[1] = 0x00;
+    file[2] = (uint8_t)IMAGE_SIZE;
+    file[3] = (uint8_t)(IMAGE_SIZE >> 8);
+    file[4] = (uint8_t)(IMAGE_SIZE >> 16);
+    file[5] = (uint8_t)(IMAGE_SIZE >> 24);
+
+    uint32_t x = 12345;
+    for (int i = 0; i < IMAGE_SIZE; i++) {
+        x = x * 1103515245u + 12345u;
+        image[i] = (uint8_t)(x >> 16);
+    }
+    image[0] = 0xE9;              // esp_image_header_t.magic
+    image[23] = 1;                // hash_appended
+    mbedtls_sha256(image, IMAGE_SIZE - 32, image + IMAGE_SIZE - 32, 0);
+    notifications = 0;
+}
+
+/**
+ * @brief Feed the file block by block; the loop runs when asked to, if keeping up
+ */
+static void download(bool loop_keeps_up, uint32_t *flash_ops_in_write)
+{
+    *flash_ops_in_write = 0;
+    for (size_t off = 0; off < sizeof(file); off += BLOCK_SIZE) {
+        size_t n = sizeof(file) - off < BLOCK_SIZE ? sizeof(file) - off : BLOCK_SIZE;
+        uint32_t before = host_partition_write_count() + host_partition_erase_count();
+        HOST_ASSERT_EQ(ESP_OK, ota_writer_write(file + off, n));
+        *flash_ops_in_write += host_partition_write_count() + host_partition_erase_count() - before;
+        if (loop_keeps_up && notifications > 0) {
+            notifications = 0;
+            ota_writer_process();
+        }
+    }
+}
+
+static void assert_slot_holds_image(void)
+{
+    const esp_partition_t *slot = esp_ota_get_next_update_partition(NULL);
+    uint8_t *readback = malloc(IMAGE_SIZE);
+    HOST_ASSERT(readback != NULL);
+    HOST_ASSERT_EQ(ESP_OK, esp_partition_read(slot, 0, readback, IMAGE_SIZE));
+    int same = memcmp(readback, file + TAG_LEN, IMAGE_SIZE) == 0;
+    free(readback);
+    HOST_ASSERT(same);
+}
+
+HOST_TEST(ota_writer, zigbee_side_never_touches_flash)
+{
+    build_file();
+    HOST_ASSERT_EQ(ESP_OK, ota_writer_begin(notify));
+    ota_writer_process();
+
+    uint32_t flash_ops_in_write;
+    download(true, &flash_ops_in_write);
+    HOST_ASSERT_EQ(0, flash_ops_in_write);
+    HOST_ASSERT(ota_writer_complete());
+
+    ota_writer_stats_t stats;
+    ota_writer_get_stats(&stats);
+    HOST_ASSERT_EQ(0, stats.stalls);
+    HOST_ASSERT_EQ(IMAGE_SIZE, stats.received);
+
+    HOST_ASSERT_EQ(ESP_OK, ota_writer_finish());
+    HOST_ASSERT(!ota_writer_active());
+    HOST_ASSERT(strcmp("ota_1", host_partition_boot_label()) == 0);
+    assert_slot_holds_image();
+}
+
+HOST_TEST(ota_writer, erases_incrementally_ahead_of_writes)
+{
+    build_file();
+    HOST_ASSERT_EQ(ESP_OK, ota_writer_begin(notify));
+    HOST_ASSERT_EQ(1, notifications);
+
+    // Before any data: only the erase-ahead window, not the 1.5 MB slot
+    ota_writer_process();
+    ota_writer_stats_t stats;
+    ota_writer_get_stats(&stats);
+    HOST_ASSERT_EQ(OTA_ERASE_AHEAD_SECTORS * 4096, stats.erased);
+
+    // Half way: the window moves with the write position
+    size_t half = TAG_LEN + IMAGE_SIZE / 2;
+    for (size_t off = 0; off < half; off += BLOCK_SIZE) {
+        HOST_ASSERT_EQ(ESP_OK, ota_writer_write(file + off, BLOCK_SIZE));
+        ota_writer_process();
+    }
+    ota_writer_get_stats(&stats);
+    HOST_ASSERT(stats.written > 0);
+    HOST_ASSERT_EQ(stats.written + OTA_ERASE_AHEAD_SECTORS * 4096, stats.erased);
+    ota_writer_abort();
+
+    // A whole download erases only the sectors the image covers
+    build_file();
+    HOST_ASSERT_EQ(ESP_OK, ota_writer_begin(notify));
+    uint32_t erases_before = host_partition_erase_count();
+    uint32_t flash_ops_in_write;
+    download(true, &flash_ops_in_write);
+    HOST_ASSERT_EQ(ESP_OK, ota_writer_finish());
+    HOST_ASSERT_EQ((IMAGE_SIZE + 4095) / 4096, host_partition_erase_count() - erases_before);
+}
+
+HOST_TEST(ota_writer, loop_falling_behind_stalls_without_losing_data)
+{
+    build_file();
+    HOST_ASSERT_EQ(ESP_OK, ota_writer_begin(notify));
+
+    uint32_t flash_ops_in_write;
+    download(false, &flash_ops_in_write);
+
+    ota_writer_stats_t stats;
+    ota_writer_get_stats(&stats);
+    HOST_ASSERT(stats.stalls > 0);
+    HOST_ASSERT(flash_ops_in_write > 0);
+
+    HOST_ASSERT_EQ(ESP_OK, ota_writer_finish());
+    assert_slot_holds_image();
+}
+
+HOST_TEST(ota_writer, digest_mismatch_keeps_running_slot)
+{
+    build_file();
+    file[TAG_LEN + 1000] ^= 0x01;
+    HOST_ASSERT_EQ(ESP_OK, ota_writer_begin(notify));
+
+    uint32_t flash_ops_in_write;
+    download(true, &flash_ops_in_write);
+    HOST_ASSERT_EQ(ESP_ERR_INVALID_CRC, ota_writer_finish());
+    HOST_ASSERT(strcmp("ota_0", host_partition_boot_label()) == 0);
+}
+
+HOST_TEST(ota_writer, incomplete_image_is_rejected)
+{
+    build_file();
+    HOST_ASSERT_EQ(ESP_OK, ota_writer_begin(notify));
+    HOST_ASSERT_EQ(ESP_OK, ota_writer_write(file, 4 * 1024));
+    ota_writer_process();
+
+    HOST_ASSERT(!ota_writer_complete());
+    HOST_ASSERT_EQ(ESP_ERR_INVALID_SIZE, ota_writer_finish());
+    HOST_ASSERT(strcmp("ota_0", host_partition_boot_label()) == 0);
+}
+
+HOST_TEST(ota_writer, foreign_image_fails_the_download)
+{
+    build_file();
+    file[TAG_LEN] = 0x00;         // Not an ESP-IDF app image
+    HOST_ASSERT_EQ(ESP_OK, ota_writer_begin(notify));
+    HOST_ASSERT_EQ(ESP_OK, ota_writer_write(file, TAG_LEN + 4096));
+    ota_writer_process();
+
+    // The next block reports the error so the stack aborts the download
+    HOST_ASSERT_EQ(ESP_ERR_OTA_VALIDATE_FAILED, ota_writer_write(file + TAG_LEN + 4096, BLOCK_SIZE));
+    HOST_ASSERT(!ota_writer_complete());
+    ota_writer_abort();
+    HOST_ASSERT(!ota_writer_active());
+}
+
+HOST_TEST(ota_writer, oversized_image_is_refused)
+{
+    uint8_t tag[TAG_LEN] = { 0x00, 0x00, 0x00, 0x00, 0x20, 0x00 };   // 2 MB
+    HOST_ASSERT_EQ(ESP_OK, ota_writer_begin(notify));
+    HOST_ASSERT_EQ(ESP_ERR_INVALID_SIZE, ota_writer_write(tag, sizeof(tag)));
+    ota_writer_abort();
+}
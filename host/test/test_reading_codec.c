@@ -0,0 +1,216 @@
+/*
+ * Glyph C6 Monitor - reading_codec host tests
+ *
+ * Record format edge cases, and the history log that stores its RTC
+ * staging buffer and flash pages in that format.
+ */
+
+#include "host_test.h"
+#include "host_sim.h"
+#include "reading_codec.h"
+#include "history_log.h"
+#include "system_config.h"
+#include <stdlib.h>
+
+#define HOUR    3600
+
+static history_reading_t reading(uint32_t time, uint16_t moisture, int16_t temp)
+{
+    history_reading_t r = { .time = time, .moisture_centi = moisture, .temp_centi = temp };
+    return r;
+}
+
+/**
+ * @brief Encode a series and decode it back; returns the record bytes
+ */
+static size_t round_trip(const history_reading_t *series, size_t n)
+{
+    uint8_t buf[1024];
+    size_t len = 0;
+    reading_codec_state_t enc;
+    reading_codec_begin(&enc, &series[0]);
+    for (size_t i = 1; i < n; i++) {
+        size_t used = reading_codec_encode(&enc, &series[i], &buf[len], sizeof(buf) - len);
+        HOST_ASSERT(used > 0 && used <= READING_CODEC_MAX_RECORD);
+        len += used;
+    }
+
+    reading_codec_state_t dec;
+    reading_codec_begin(&dec, &series[0]);
+    size_t pos = 0;
+    for (size_t i = 1; i < n; i++) {
+        history_reading_t r;
+        size_t used = reading_codec_decode(&dec, &buf[pos], len - pos, &r);
+        HOST_ASSERT(used > 0);
+        pos += used;
+        HOST_ASSERT_EQ(series[i].time, r.time);
+        HOST_ASSERT_EQ(series[i].moisture_centi, r.moisture_centi);
+        HOST_ASSERT_EQ(series[i].temp_centi, r.temp_centi);
+    }
+    HOST_ASSERT_EQ(len, pos);
+    return len;
+}
+
+HOST_TEST(reading_codec, zigzag_maps_small_magnitudes_to_small_codes)
+{
+    HOST_ASSERT_EQ(0, reading_codec_zigzag(0));
+    HOST_ASSERT_EQ(1, reading_codec_zigzag(-1));
+    HOST_ASSERT_EQ(2, reading_codec_zigzag(1));
+    HOST_ASSERT_EQ(0xFFFFFFFFu, reading_codec_zigzag(INT32_MIN));
+    for (int32_t v = -70000; v <= 70000; v += 7) {
+        HOST_ASSERT_EQ(v, reading_codec_unzigzag(reading_codec_zigzag(v)));
+    }
+}
+
+HOST_TEST(reading_codec, steady_series_is_one_byte_per_reading)
+{
+    history_reading_t series[48];
+    for (size_t i = 0; i < 48; i++) {
+        series[i] = reading(1000 + (uint32_t)i * HOUR, (uint16_t)(5000 - i % 7), (int16_t)(2100 + (i & 1)));
+    }
+    // The first record carries the time step
+    HOST_ASSERT_EQ(47 + 2, round_trip(series, 48));
+}
+
+HOST_TEST(reading_codec, extremes_and_wraps_round_trip_exactly)
+{
+    const history_reading_t series[] = {
+        reading(0, 0, INT16_MIN),
+        reading(0, 10000, INT16_MAX),             // Same second, full swings
+        reading(0xFFFFFFF0u, 0xFFFF, -1),         // Largest gap
+        reading(5, 1, 1),                         // Clock wraps / resets
+        reading(3605, 0, 0),
+        reading(3605 + 59, 9999, -4000),          // Step changes again
+        reading(3605 + 59, 9999, -4000),          // Unchanged reading
+    };
+    round_trip(series, sizeof(series) / sizeof(series[0]));
+
+    // Worst case: every field escaped at its widest
+    uint8_t buf[READING_CODEC_MAX_RECORD];
+    reading_codec_state_t state;
+    history_reading_t origin = reading(0, 0, 0);
+    reading_codec_begin(&state, &origin);
+    history_reading_t far = reading(0x80000000u, 0x8000, INT16_MIN);
+    HOST_ASSERT_EQ(READING_CODEC_MAX_RECORD, reading_codec_encode(&state, &far, buf, sizeof(buf)));
+}
+
+HOST_TEST(reading_codec, no_room_leaves_the_series_unchanged)
+{
+    history_reading_t first = reading(100, 4000, 1500);
+    history_reading_t next = reading(100 + HOUR, 4400, 1200);
+    reading_codec_state_t state;
+    reading_codec_begin(&state, &first);
+
+    uint8_t buf[8];
+    HOST_ASSERT_EQ(0, reading_codec_encode(&state, &next, buf, 2));
+    HOST_ASSERT_EQ(first.time, state.last.time);
+    HOST_ASSERT_EQ(0, state.interval);
+    size_t len = reading_codec_encode(&state, &next, buf, sizeof(buf));
+    HOST_ASSERT(len > 2);
+
+    // A truncated record does not decode either
+    reading_codec_state_t dec;
+    reading_codec_begin(&dec, &first);
+    history_reading_t out;
+    HOST_ASSERT_EQ(0, reading_codec_decode(&dec, buf, len - 1, &out));
+    HOST_ASSERT_EQ(first.time, dec.last.time);
+    HOST_ASSERT_EQ(len, reading_codec_decode(&dec, buf, len, &out));
+    HOST_ASSERT_EQ(next.moisture_centi, out.moisture_centi);
+}
+
+HOST_TEST(reading_codec, erased_flash_ends_the_series)
+{
+    const uint8_t erased[READING_CODEC_MAX_RECORD] = {
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    };
+    history_reading_t first = reading(0, 0, 0);
+    reading_codec_state_t state;
+    reading_codec_begin(&state, &first);
+    history_reading_t out;
+    HOST_ASSERT_EQ(0, reading_codec_decode(&state, erased, sizeof(erased), &out));
+
+    // No reading encodes to a record starting with 0xFF
+    srand(7);
+    uint8_t buf[READING_CODEC_MAX_RECORD];
+    for (int i = 0; i < 20000; i++) {
+        history_reading_t r = reading((uint32_t)rand() * 7919u, (uint16_t)rand(), (int16_t)rand());
+        HOST_ASSERT(reading_codec_encode(&state, &r, buf, sizeof(buf)) > 0);
+        HOST_ASSERT(buf[0] != READING_CODEC_TAG_ERASED);
+    }
+}
+
+HOST_TEST(reading_codec, absolute_form_is_little_endian)
+{
+    uint8_t buf[READING_CODEC_ABSOLUTE_LEN];
+    history_reading_t r = reading(0x04030201u, 0x0605, (int16_t)0xFEFF);
+    reading_codec_put_absolute(&r, buf);
+    const uint8_t want[READING_CODEC_ABSOLUTE_LEN] = { 1, 2, 3, 4, 5, 6, 0xFF, 0xFE };
+    for (size_t i = 0; i < sizeof(want); i++) {
+        HOST_ASSERT_EQ(want[i], buf[i]);
+    }
+    history_reading_t back;
+    reading_codec_get_absolute(buf, &back);
+    HOST_ASSERT_EQ(r.time, back.time);
+    HOST_ASSERT_EQ(r.moisture_centi, back.moisture_centi);
+    HOST_ASSERT_EQ(-257, back.temp_centi);
+}
+
+HOST_TEST(reading_codec, history_log_pages_hold_encoded_readings)
+{
+    HOST_ASSERT_EQ(ESP_OK, history_log_init());
+
+    // Pages' worth of slowly drying soil, 10-minute wakes with a second of jitter
+    const size_t n = 4000;
+    uint32_t writes = host_partition_write_count();
+    for (size_t i = 0; i < n; i++) {
+        history_reading_t r = reading(10 + (uint32_t)i * 600 + (i % 3 == 0),
+                                      (uint16_t)(8000 - i / 2), (int16_t)(1800 + (i % 144) * 3));
+        HOST_ASSERT_EQ(ESP_OK, history_log_append(&r));
+    }
+    writes = host_partition_write_count() - writes;
+
+    history_cursor_t cursor;
+    HOST_ASSERT_EQ(ESP_OK, history_log_query(0, UINT32_MAX, &cursor));
+    history_reading_t out[64];
+    size_t total = 0;
+    size_t got;
+    while ((got = history_log_read(&cursor, out, 64)) > 0) {
+        for (size_t k = 0; k < got; k++, total++) {
+            size_t i = total;
+            HOST_ASSERT_EQ(10 + (uint32_t)i * 600 + (i % 3 == 0), out[k].time);
+            HOST_ASSERT_EQ(8000 - i / 2, out[k].moisture_centi);
+            HOST_ASSERT_EQ(1800 + (i % 144) * 3, out[k].temp_centi);
+        }
+    }
+    HOST_ASSERT_EQ(n, total);
+
+    // Fewer flash programs than 6-byte records in 32-reading batches
+    HOST_ASSERT(writes < n / 32);
+}
+
+HOST_TEST(reading_codec, full_staging_drops_the_oldest_readings)
+{
+    // No partition yet: every flush fails and the RTC buffer keeps the newest
+    for (uint32_t i = 0; i < 400; i++) {
+        history_reading_t r = reading(i * 60, (uint16_t)(3000 + i * 37), (int16_t)(i * 11));
+        history_log_append(&r);
+    }
+    HOST_ASSERT_EQ(ESP_OK, history_log_init());
+
+    history_cursor_t cursor;
+    HOST_ASSERT_EQ(ESP_OK, history_log_query(0, UINT32_MAX, &cursor));
+    history_reading_t out[400];
+    size_t total = 0;
+    size_t got;
+    while ((got = history_log_read(&cursor, &out[total], 400 - total)) > 0) {
+        total += got;
+    }
+    HOST_ASSERT(total > HISTORY_STAGING_BYTES / READING_CODEC_MAX_RECORD);
+    HOST_ASSERT(total < 400);
+    for (size_t k = 0; k < total; k++) {
+        uint32_t i = 400 - (uint32_t)total + (uint32_t)k;
+        HOST_ASSERT_EQ(i * 60, out[k].time);
+        HOST_ASSERT_EQ(3000 + i * 37, out[k].moisture_centi);
+        HOST_ASSERT_EQ(i * 11, out[k].temp_centi);
+    }
+}
@@ -0,0 +1,342 @@
+/*
+ * Glyph C6 Monitor - RV32IMAC simulator host tests
+ *
+ * Hand-assembled programs check the decoder and the instruction and
+ * region accounting that kernel_bench relies on.
+ */
+
+#include "host_test.h"
+#include "rv32_iss.h"
+#include <stdio.h>
+#include <string.h>
+
+#define BASE        0x10000u
+#define MEM_SIZE    0x10000u
+
+enum { ZERO = 0, RA = 1, SP = 2, T0 = 5, T1 = 6, T2 = 7, S0 = 8, A0 = 10, A1 = 11,
+       A2 = 12, A3 = 13, A4 = 14, A5 = 15, A6 = 16, A7 = 17 };
+
+// ============================================================================
+// ENCODERS
+// ============================================================================
+
+static uint32_t enc_r(uint32_t f7, uint32_t rs2, uint32_t rs1, uint32_t f3, uint32_t rd, uint32_t op)
+{
+    return (f7 << 25) | (rs2 << 20) | (rs1 << 15) | (f3 << 12) | (rd << 7) | op;
+}
+
+static uint32_t enc_i(int32_t imm, uint32_t rs1, uint32_t f3, uint32_t rd, uint32_t op)
+{
+    return ((uint32_t)imm << 20) | (rs1 << 15) | (f3 << 12) | (rd << 7) | op;
+}
+
+static uint32_t enc_s(int32_t imm, uint32_t rs2, uint32_t rs1, uint32_t f3)
+{
+    uint32_t u = (uint32_t)imm;
+    return (((u >> 5) & 0x7F) << 25) | (rs2 << 20) | (rs1 << 15) | (f3 << 12) | ((u & 31) << 7) | 0x23;
+}
+
+static uint32_t enc_b(int32_t imm, uint32_t rs2, uint32_t rs1, uint32_t f3)
+{
+    uint32_t u = (uint32_t)imm;
+    return (((u >> 12) & 1) << 31) | (((u >> 5) & 0x3F) << 25) | (rs2 << 20) | (rs1 << 15) |
+           (f3 << 12) | (((u >> 1) & 15) << 8) | (((u >> 11) & 1) << 7) | 0x63;
+}
+
+static uint32_t enc_j(int32_t imm, uint32_t rd)
+{
+    uint32_t u = (uint32_t)imm;
+    return (((u >> 20) & 1) << 31) | (((u >> 1) & 0x3FF) << 21) | (((u >> 11) & 1) << 20) |
+           (((u >> 12) & 0xFF) << 12) | (rd << 7) | 0x6F;
+}
+
+#define ADDI(rd, rs1, imm)   enc_i((imm), (rs1), 0, (rd), 0x13)
+#define LUI(rd, imm20)       (((uint32_t)(imm20) << 12) | ((rd) << 7) | 0x37)
+#define ADD(rd, rs1, rs2)    enc_r(0, (rs2), (rs1), 0, (rd), 0x33)
+#define MOP(f3, rd, rs1, rs2) enc_r(1, (rs2), (rs1), (f3), (rd), 0x33)
+#define JALR(rd, rs1, imm)   enc_i((imm), (rs1), 0, (rd), 0x67)
+#define ECALL                0x00000073u
+#define CSRR(rd, csr)        enc_i((csr), 0, 2, (rd), 0x73)
+
+typedef struct {
+    uint8_t bytes[1024];
+    uint32_t len;
+} program_t;
+
+static void emit32(program_t *p, uint32_t insn)
+{
+    memcpy(&p->bytes[p->len], &insn, 4);
+    p->len += 4;
+}
+
+static void emit16(program_t *p, uint16_t insn)
+{
+    memcpy(&p->bytes[p->len], &insn, 2);
+    p->len += 2;
+}
+
+static void emit_exit(program_t *p)
+{
+    emit32(p, ADDI(A7, ZERO, RV32_SYS_EXIT));
+    emit32(p, ECALL);
+}
+
+static rv32_stop_t run_program(rv32_iss_t *iss, const program_t *p)
+{
+    HOST_ASSERT_EQ(ESP_OK, rv32_iss_init(iss, BASE, MEM_SIZE));
+    HOST_ASSERT(rv32_iss_write_mem(iss, BASE, p->bytes, p->len));
+    return rv32_iss_run(iss, 100000);
+}
+
+// ============================================================================
+// TESTS
+// ============================================================================
+
+HOST_TEST(rv32_iss, loop_retires_exact_count)
+{
+    program_t p = { 0 };
+    emit32(&p, ADDI(A0, ZERO, 0));
+    emit32(&p, ADDI(T0, ZERO, 10));
+    emit32(&p, ADD(A0, A0, T0));                  // loop:
+    emit32(&p, ADDI(T0, T0, -1));
+    emit32(&p, enc_b(-8, ZERO, T0, 1));           // bne t0, zero, loop
+    emit32(&p, CSRR(A1, 0xC02));                  // rdinstret
+    emit_exit(&p);
+
+    rv32_iss_t iss;
+    HOST_ASSERT_EQ(RV32_STOP_EXIT, run_program(&iss, &p));
+    HOST_ASSERT_EQ(55, iss.exit_code);
+    HOST_ASSERT_EQ(32, iss.x[A1]);                // 2 + 3 * 10 before the csrr
+    HOST_ASSERT_EQ(35, iss.instret);
+    rv32_iss_free(&iss);
+}
+
+HOST_TEST(rv32_iss, m_extension_edge_cases)
+{
+    program_t p = { 0 };
+    emit32(&p, ADDI(A0, ZERO, -7));
+    emit32(&p, ADDI(A1, ZERO, 2));
+    emit32(&p, MOP(4, A2, A0, A1));               // div  -7 / 2 = -3
+    emit32(&p, MOP(6, A3, A0, A1));               // rem  -7 % 2 = -1
+    emit32(&p, MOP(5, A4, A0, ZERO));             // divu by zero = all ones
+    emit32(&p, MOP(6, A5, A0, ZERO));             // rem by zero = dividend
+    emit32(&p, LUI(T0, 0x80000));
+    emit32(&p, ADDI(T1, ZERO, -1));
+    emit32(&p, MOP(4, A6, T0, T1));               // INT_MIN / -1 = INT_MIN
+    emit32(&p, MOP(3, T2, T1, T1));               // mulhu 0xFFFFFFFF^2
+    emit32(&p, MOP(2, S0, T1, T1));               // mulhsu -1 * 0xFFFFFFFF
+    emit32(&p, MOP(1, T1, A0, A0));               // mulh -7 * -7
+    emit_exit(&p);
+
+    rv32_iss_t iss;
+    HOST_ASSERT_EQ(RV32_STOP_EXIT, run_program(&iss, &p));
+    HOST_ASSERT_EQ(-3, (int32_t)iss.x[A2]);
+    HOST_ASSERT_EQ(-1, (int32_t)iss.x[A3]);
+    HOST_ASSERT_EQ(0xFFFFFFFFu, iss.x[A4]);
+    HOST_ASSERT_EQ(-7, (int32_t)iss.x[A5]);
+    HOST_ASSERT_EQ(0x80000000u, iss.x[A6]);
+    HOST_ASSERT_EQ(0xFFFFFFFEu, iss.x[T2]);
+    HOST_ASSERT_EQ(0xFFFFFFFFu, iss.x[S0]);
+    HOST_ASSERT_EQ(0, iss.x[T1]);
+    rv32_iss_free(&iss);
+}
+
+HOST_TEST(rv32_iss, loads_extend_and_stores_truncate)
+{
+    program_t p = { 0 };
+    emit32(&p, LUI(S0, 0x10));
+    emit32(&p, ADDI(S0, S0, 0x400));              // s0 = scratch
+    emit32(&p, ADDI(T0, ZERO, -128));
+    emit32(&p, enc_s(0, T0, S0, 0));              // sb
+    emit32(&p, enc_i(0, S0, 0, A0, 0x03));        // lb
+    emit32(&p, enc_i(0, S0, 4, A1, 0x03));        // lbu
+    emit32(&p, LUI(T1, 0x8));
+    emit32(&p, ADDI(T1, T1, 1));                  // 0x8001
+    emit32(&p, enc_s(6, T1, S0, 1));              // sh (unaligned)
+    emit32(&p, enc_i(6, S0, 1, A2, 0x03));        // lh
+    emit32(&p, enc_i(6, S0, 5, A3, 0x03));        // lhu
+    emit32(&p, enc_s(8, T0, S0, 2));              // sw
+    emit32(&p, enc_i(8, S0, 2, A4, 0x03));        // lw
+    emit_exit(&p);
+
+    rv32_iss_t iss;
+    HOST_ASSERT_EQ(RV32_STOP_EXIT, run_program(&iss, &p));
+    HOST_ASSERT_EQ(-128, (int32_t)iss.x[A0]);
+    HOST_ASSERT_EQ(128, iss.x[A1]);
+    HOST_ASSERT_EQ(-32767, (int32_t)iss.x[A2]);
+    HOST_ASSERT_EQ(0x8001, iss.x[A3]);
+    HOST_ASSERT_EQ(-128, (int32_t)iss.x[A4]);
+    rv32_iss_free(&iss);
+}
+
+HOST_TEST(rv32_iss, compressed_instructions)
+{
+    program_t p = { 0 };
+    emit16(&p, 0x4515);                           // c.li   a0, 5
+    emit16(&p, 0x0505);                           // c.addi a0, 1
+    emit16(&p, 0x85AA);                           // c.mv   a1, a0
+    emit16(&p, 0x952E);                           // c.add  a0, a1     = 12
+    emit16(&p, 0x050A);                           // c.slli a0, 2      = 48
+    emit16(&p, 0x8105);                           // c.srli a0, 1      = 24
+    emit16(&p, 0xA011);                           // c.j    +4
+    emit16(&p, 0x0000);                           // (illegal, skipped)
+    emit16(&p, 0xC111);                           // c.beqz a0, +4 (not taken)
+    emit16(&p, 0x0505);                           // c.addi a0, 1      = 25
+    emit_exit(&p);
+
+    rv32_iss_t iss;
+    HOST_ASSERT_EQ(RV32_STOP_EXIT, run_program(&iss, &p));
+    HOST_ASSERT_EQ(25, iss.exit_code);
+    HOST_ASSERT_EQ(11, iss.instret);
+    rv32_iss_free(&iss);
+}
+
+HOST_TEST(rv32_iss, region_counts_callees_only)
+{
+    program_t p = { 0 };
+    // harness @ BASE
+    emit32(&p, ADDI(A7, ZERO, RV32_SYS_REGION_BEGIN));
+    emit32(&p, LUI(A0, 0x10));
+    emit32(&p, ADDI(A0, A0, 0x200));              // name
+    emit32(&p, ADDI(A1, ZERO, 2));                // calls
+    emit32(&p, ECALL);
+    emit32(&p, enc_j(0x100 - 20, RA));            // jal kernel
+    emit32(&p, enc_j(0x100 - 24, RA));            // jal kernel
+    emit32(&p, ADDI(A7, ZERO, RV32_SYS_REGION_END));
+    emit32(&p, ECALL);
+    emit_exit(&p);
+    uint32_t harness_len = p.len;
+    // kernel @ BASE + 0x100: calls a runtime helper
+    p.len = 0x100;
+    emit32(&p, ADDI(A0, A0, 1));
+    emit32(&p, enc_j(0x80 - 4, T0));              // jal t0, helper
+    emit32(&p, JALR(ZERO, RA, 0));
+    // helper @ BASE + 0x180
+    p.len = 0x180;
+    emit32(&p, ADDI(A0, A0, 1));
+    emit32(&p, JALR(ZERO, T0, 0));
+    p.len = 0x200;
+    memcpy(&p.bytes[p.len], "kern", 5);
+    p.len += 5;
+
+    rv32_iss_t iss;
+    HOST_ASSERT_EQ(ESP_OK, rv32_iss_init(&iss, BASE, MEM_SIZE));
+    HOST_ASSERT(rv32_iss_write_mem(&iss, BASE, p.bytes, p.len));
+    HOST_ASSERT_EQ(ESP_OK, rv32_iss_add_symbol(&iss, "__helper", BASE + 0x180, 8));
+    HOST_ASSERT_EQ(ESP_OK, rv32_iss_add_symbol(&iss, "harness", BASE, harness_len));
+    HOST_ASSERT_EQ(ESP_OK, rv32_iss_add_symbol(&iss, "kernel", BASE + 0x100, 12));
+    iss.console = false;
+    HOST_ASSERT_EQ(RV32_STOP_EXIT, rv32_iss_run(&iss, 1000));
+
+    HOST_ASSERT_EQ(1, iss.region_count);
+    const rv32_region_t *r = &iss.regions[0];
+    HOST_ASSERT(strcmp(r->name, "kern") == 0);
+    HOST_ASSERT_EQ(2, r->calls);
+    HOST_ASSERT_EQ(10, r->instructions);
+    HOST_ASSERT_EQ(4, r->helper_instructions);
+    HOST_ASSERT_EQ(2, r->functions);
+    HOST_ASSERT_EQ(20, r->reach_bytes);
+    HOST_ASSERT_EQ(6, rv32_iss_find_symbol(&iss, "kernel")->executed);
+    HOST_ASSERT(rv32_iss_symbol_at(&iss, BASE + 0x184) == rv32_iss_find_symbol(&iss, "__helper"));
+    rv32_iss_free(&iss);
+}
+
+HOST_TEST(rv32_iss, faults_stop_the_run)
+{
+    program_t p = { 0 };
+    emit32(&p, ADDI(A0, ZERO, 1));
+    emit32(&p, LUI(S0, 0x80));                    // Outside memory
+    emit32(&p, enc_i(0, S0, 2, A1, 0x03));        // lw
+    rv32_iss_t iss;
+    HOST_ASSERT_EQ(RV32_STOP_FAULT, run_program(&iss, &p));
+    HOST_ASSERT_EQ(BASE + 8, iss.fault_pc);
+    HOST_ASSERT_EQ(2, iss.instret);
+    rv32_iss_free(&iss);
+
+    p.len = 0;
+    emit16(&p, 0x0000);                           // Defined illegal instruction
+    HOST_ASSERT_EQ(RV32_STOP_FAULT, run_program(&iss, &p));
+    HOST_ASSERT_EQ(BASE, iss.fault_pc);
+    rv32_iss_free(&iss);
+
+    p.len = 0;
+    emit32(&p, enc_j(0, ZERO));                   // j . (spins)
+    HOST_ASSERT_EQ(ESP_OK, rv32_iss_init(&iss, BASE, MEM_SIZE));
+    HOST_ASSERT(rv32_iss_write_mem(&iss, BASE, p.bytes, p.len));
+    HOST_ASSERT_EQ(RV32_STOP_LIMIT, rv32_iss_run(&iss, 500));
+    HOST_ASSERT_EQ(500, iss.instret);
+    rv32_iss_free(&iss);
+}
+
+static void put16(uint8_t *p, uint32_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+static void put32(uint8_t *p, uint32_t v) { put16(p, v); put16(p + 2, v >> 16); }
+
+HOST_TEST(rv32_iss, loads_elf_with_symbols)
+{
+    // Minimal static executable: one PT_LOAD (code + bss), .symtab, .strtab
+    uint8_t elf[0x2C0] = { 0x7F, 'E', 'L', 'F', 1, 1, 1 };
+    put16(elf + 16, 2);                           // ET_EXEC
+    put16(elf + 18, 243);                         // EM_RISCV
+    put32(elf + 20, 1);
+    put32(elf + 24, BASE);                        // Entry
+    put32(elf + 28, 0x34);                        // Program headers
+    put32(elf + 32, 0x240);                       // Section headers
+    put16(elf + 40, 52);
+    put16(elf + 42, 32);
+    put16(elf + 44, 1);
+    put16(elf + 46, 40);
+    put16(elf + 48, 3);
+
+    uint8_t *ph = elf + 0x34;
+    put32(ph, 1);                                 // PT_LOAD
+    put32(ph + 4, 0x100);
+    put32(ph + 8, BASE);
+    put32(ph + 12, BASE);
+    put32(ph + 16, 12);                           // File size
+    put32(ph + 20, 0x100);                        // Memory size (bss)
+    put32(ph + 24, 5);
+
+    put32(elf + 0x100, ADDI(A0, ZERO, 7));
+    put32(elf + 0x104, ADDI(A7, ZERO, RV32_SYS_EXIT));
+    put32(elf + 0x108, ECALL);
+
+    memcpy(elf + 0x200, "\0start", 7);           // .strtab
+    uint8_t *sym = elf + 0x210 + 16;              // .symtab, entry 1
+    put32(sym, 1);
+    put32(sym + 4, BASE);
+    put32(sym + 8, 12);
+    sym[12] = 0x12;                               // GLOBAL FUNC
+
+    uint8_t *sh = elf + 0x240 + 40;
+    put32(sh + 4, 2);                             // SHT_SYMTAB
+    put32(sh + 16, 0x210);
+    put32(sh + 20, 32);
+    put32(sh + 24, 2);                            // Linked .strtab
+    put32(sh + 36, 16);
+    sh += 40;
+    put32(sh + 4, 3);                             // SHT_STRTAB
+    put32(sh + 16, 0x200);
+    put32(sh + 20, 7);
+
+    const char *path = "rv32_iss_test.elf";
+    FILE *f = fopen(path, "wb");
+    HOST_ASSERT(f != NULL);
+    fwrite(elf, 1, sizeof(elf), f);
+    fclose(f);
+
+    rv32_iss_t iss;
+    esp_err_t err = rv32_iss_load_elf(&iss, path);
+    remove(path);
+    HOST_ASSERT_EQ(ESP_OK, err);
+    HOST_ASSERT_EQ(BASE, iss.pc);
+    HOST_ASSERT(iss.mem_size >= 0x1000 + RV32_ISS_STACK_BYTES);
+    HOST_ASSERT_EQ(RV32_STOP_EXIT, rv32_iss_run(&iss, 100));
+    HOST_ASSERT_EQ(7, iss.exit_code);
+    const rv32_symbol_t *start = rv32_iss_find_symbol(&iss, "start");
+    HOST_ASSERT(start != NULL);
+    HOST_ASSERT_EQ(12, start->size);
+    HOST_ASSERT_EQ(3, start->executed);
+    rv32_iss_free(&iss);
+
+    HOST_ASSERT_EQ(ESP_ERR_NOT_FOUND, rv32_iss_load_elf(&iss, "no_such.elf"));
+}
@@ -0,0 +1,141 @@
+/*
+ * Glyph C6 Monitor - Seesaw simulator host tests
+ *
+ * Run the soil_sensor driver against the simulated chip: timing
+ * (boot window, conversion delays) and the fault model.
+ */
+
+#include "host_test.h"
+#include "host_sim.h"
+#include "seesaw_sim.h"
+#include "soil_sensor.h"
+#include "system_config.h"
+#include "driver/i2c_master.h"
+
+static seesaw_sim_t sim;
+
+static void init_sensor(const seesaw_sim_config_t *config)
+{
+    i2c_master_bus_config_t bus_cfg = { .i2c_port = I2C_NUM_0 };
+    i2c_master_bus_handle_t bus;
+    HOST_ASSERT_EQ(ESP_OK, i2c_new_master_bus(&bus_cfg, &bus));
+    seesaw_sim_attach(&sim, config, SOIL_SENSOR_ADDR);
+    HOST_ASSERT_EQ(ESP_OK, soil_sensor_init(bus));
+}
+
+HOST_TEST(seesaw_sim, driver_reads_nominal_chip)
+{
+    init_sensor(NULL);
+    seesaw_sim_set_capacitance(&sim, 800);
+    seesaw_sim_set_temperature(&sim, 23.25f);
+    soil_data_t data;
+    HOST_ASSERT_EQ(ESP_OK, soil_sensor_read_all(&data));
+    HOST_ASSERT_EQ(800, data.moisture_raw);
+    HOST_ASSERT_EQ(2325, data.temperature_centi);
+    HOST_ASSERT_EQ(1, sim.stats.resets);
+    HOST_ASSERT_EQ(0, sim.stats.nacks);
+    HOST_ASSERT_EQ(0, sim.stats.early_reads);
+}
+
+HOST_TEST(seesaw_sim, nacks_while_booting)
+{
+    seesaw_sim_config_t cfg;
+    seesaw_sim_default_config(&cfg);
+    cfg.boot_time_us = 1500000;   // Longer than the driver's 1 s settle time
+    init_sensor(&cfg);
+    uint16_t raw;
+    uint16_t pct;
+    HOST_ASSERT_EQ(ESP_FAIL, soil_sensor_read_moisture(&raw, &pct));
+    HOST_ASSERT(sim.stats.nacks > 0);
+
+    host_time_advance_us(500000);
+    HOST_ASSERT_EQ(ESP_OK, soil_sensor_read_moisture(&raw, &pct));
+}
+
+HOST_TEST(seesaw_sim, early_read_returns_idle_bus)
+{
+    seesaw_sim_config_t cfg;
+    seesaw_sim_default_config(&cfg);
+    cfg.touch_conversion_us = 8000;   // Longer than the driver's 5 ms wait
+    init_sensor(&cfg);
+    uint16_t raw;
+    uint16_t pct;
+    HOST_ASSERT_EQ(ESP_OK, soil_sensor_read_moisture(&raw, &pct));
+    HOST_ASSERT_EQ(0xFFFF, raw);
+    HOST_ASSERT_EQ(1, sim.stats.early_reads);
+}
+
+HOST_TEST(seesaw_sim, noise_has_configured_spread)
+{
+    seesaw_sim_config_t cfg;
+    seesaw_sim_default_config(&cfg);
+    cfg.noise_counts = 10.0f;
+    cfg.seed = 1234;
+    init_sensor(&cfg);
+    seesaw_sim_set_capacitance(&sim, 700);
+
+    const int n = 400;
+    double sum = 0.0, sum_sq = 0.0;
+    for (int i = 0; i < n; i++) {
+        uint16_t raw;
+        HOST_ASSERT_EQ(ESP_OK, soil_sensor_read_moisture(&raw, NULL));
+        sum += raw;
+        sum_sq += (double)raw * raw;
+    }
+    double mean = sum / n;
+    double stdev = sqrt(sum_sq / n - mean * mean);
+    HOST_ASSERT_NEAR(700.0, mean, 2.0);
+    HOST_ASSERT_NEAR(10.0, stdev, 2.0);
+}
+
+HOST_TEST(seesaw_sim, glitches_read_as_all_ones)
+{
+    seesaw_sim_config_t cfg;
+    seesaw_sim_default_config(&cfg);
+    cfg.glitch_probability = 1.0f;
+    init_sensor(&cfg);
+    uint16_t raw;
+    uint16_t pct;
+    HOST_ASSERT_EQ(ESP_OK, soil_sensor_read_moisture(&raw, &pct));
+    HOST_ASSERT_EQ(0xFFFF, raw);
+    HOST_ASSERT_EQ(1, sim.stats.glitches);
+}
+
+HOST_TEST(seesaw_sim, stuck_bus_costs_transfer_timeout)
+{
+    init_sensor(NULL);
+    seesaw_sim_set_stuck(&sim, true);
+    uint64_t start = host_time_since_boot_us();
+    uint16_t raw;
+    uint16_t pct;
+    HOST_ASSERT_EQ(ESP_ERR_TIMEOUT, soil_sensor_read_moisture(&raw, &pct));
+    HOST_ASSERT(host_time_since_boot_us() - start >= 1000000);
+    HOST_ASSERT_EQ(1, sim.stats.timeouts);
+
+    seesaw_sim_set_stuck(&sim, false);
+    HOST_ASSERT_EQ(ESP_OK, soil_sensor_read_moisture(&raw, &pct));
+}
+
+HOST_TEST(seesaw_sim, same_seed_same_run)
+{
+    seesaw_sim_config_t cfg;
+    seesaw_sim_default_config(&cfg);
+    cfg.noise_counts = 25.0f;
+    cfg.nack_probability = 0.2f;
+    cfg.seed = 99;
+
+    uint16_t first[16];
+    esp_err_t first_ret[16];
+    init_sensor(&cfg);
+    for (int i = 0; i < 16; i++) {
+        first_ret[i] = soil_sensor_read_moisture(&first[i], NULL);
+    }
+    init_sensor(&cfg);
+    for (int i = 0; i < 16; i++) {
+        uint16_t raw = 0;
+        HOST_ASSERT_EQ(first_ret[i], soil_sensor_read_moisture(&raw, NULL));
+        if (first_ret[i] == ESP_OK) {
+            HOST_ASSERT_EQ(first[i], raw);
+        }
+    }
+}
@@ -0,0 +1,166 @@
+/*
+ * Glyph C6 Monitor - sensor_bus host tests
+ *
+ * The acquisition scheduler with the soil and ambient drivers registered,
+ * against the Seesaw and SHT4x simulators.
+ */
+
+#include "host_test.h"
+#include "host_sim.h"
+#include "seesaw_sim.h"
+#include "sht4x_sim.h"
+#include "sensor_bus.h"
+#include "soil_sensor.h"
+#include "ambient_sensor.h"
+#include "system_config.h"
+#include "driver/gpio.h"
+#include "driver/i2c_master.h"
+
+static seesaw_sim_t seesaw;
+static sht4x_sim_t sht4x;
+
+static void init_bus(bool with_ambient, const sht4x_sim_config_t *ambient_config)
+{
+    i2c_master_bus_config_t bus_cfg = { .i2c_port = I2C_NUM_0 };
+    i2c_master_bus_handle_t bus;
+    HOST_ASSERT_EQ(ESP_OK, i2c_new_master_bus(&bus_cfg, &bus));
+    seesaw_sim_attach(&seesaw, NULL, SOIL_SENSOR_ADDR);
+    if (with_ambient) {
+        sht4x_sim_attach(&sht4x, ambient_config, AMBIENT_SENSOR_ADDR);
+    }
+    HOST_ASSERT_EQ(ESP_OK, sensor_bus_init(bus));
+    HOST_ASSERT_EQ(ESP_OK, soil_sensor_register());
+    HOST_ASSERT_EQ(ESP_OK, ambient_sensor_register());
+}
+
+HOST_TEST(sensor_bus, registering_does_not_wait_or_power)
+{
+    uint64_t start = host_time_since_boot_us();
+    init_bus(true, NULL);
+    HOST_ASSERT(host_time_since_boot_us() - start < 1000);
+    HOST_ASSERT_EQ(0, gpio_get_level(NEOPIXEL_I2C_POWER));
+    HOST_ASSERT_EQ(0, seesaw.stats.resets);
+}
+
+HOST_TEST(sensor_bus, conversions_of_both_chips_overlap)
+{
+    init_bus(true, NULL);
+    seesaw_sim_set_capacitance(&seesaw, 800);
+    seesaw_sim_set_temperature(&seesaw, 18.5f);
+    sht4x_sim_set_air(&sht4x, 24.0f, 61.5f);
+
+    HOST_ASSERT_EQ(ESP_OK, sensor_bus_acquire(SENSOR_BUS_READING));
+    soil_data_t soil;
+    ambient_data_t air;
+    HOST_ASSERT_EQ(ESP_OK, soil_sensor_get_acquired(&soil));
+    HOST_ASSERT_EQ(ESP_OK, ambient_sensor_get_acquired(&air));
+    HOST_ASSERT_EQ(800, soil.moisture_raw);
+    HOST_ASSERT_EQ(1850, soil.temperature_centi);
+    HOST_ASSERT_NEAR(2400, air.temperature_centi, 1);
+    HOST_ASSERT_NEAR(6150, air.humidity_centi, 1);
+
+    // The SHT4x measures during the Seesaw's chain: longest chain plus bus time
+    const sensor_bus_stats_t *stats = sensor_bus_get_stats();
+    HOST_ASSERT_EQ(3, stats->steps);
+    HOST_ASSERT_EQ(SOIL_MOISTURE_WAIT_US + SOIL_TEMP_WAIT_US + AMBIENT_MEASURE_WAIT_US, stats->wait_sum_us);
+    HOST_ASSERT(stats->window_us >= SOIL_MOISTURE_WAIT_US + SOIL_TEMP_WAIT_US);
+    HOST_ASSERT(stats->window_us < SOIL_MOISTURE_WAIT_US + SOIL_TEMP_WAIT_US + 2000);
+    HOST_ASSERT_EQ(0, seesaw.stats.early_reads);
+    HOST_ASSERT_EQ(0, sht4x.stats.early_reads);
+}
+
+HOST_TEST(sensor_bus, window_boots_once_until_powered_off)
+{
+    init_bus(true, NULL);
+    uint64_t start = host_time_since_boot_us();
+    sensor_bus_power_on();
+    HOST_ASSERT_EQ(1, gpio_get_level(NEOPIXEL_I2C_POWER));
+    HOST_ASSERT_EQ(1, seesaw.stats.resets);
+    HOST_ASSERT_EQ(1, sht4x.stats.resets);
+    HOST_ASSERT_EQ(SOIL_SENSOR_BOOT_MS, sensor_bus_ready_in_ms());
+
+    // Boot time overlaps other work: only the rest is waited for
+    host_time_advance_us(600000);
+    HOST_ASSERT_EQ(SOIL_SENSOR_BOOT_MS - 600, sensor_bus_ready_in_ms());
+    HOST_ASSERT_EQ(ESP_OK, sensor_bus_acquire(SENSOR_BUS_READING));
+    HOST_ASSERT(host_time_since_boot_us() - start >= SOIL_SENSOR_BOOT_MS * 1000ULL);
+    HOST_ASSERT(host_time_since_boot_us() - start < SOIL_SENSOR_BOOT_MS * 1000ULL + 20000);
+
+    // Further samples in the same window start at once
+    start = host_time_since_boot_us();
+    HOST_ASSERT_EQ(ESP_OK, sensor_bus_acquire(SENSOR_BUS_READING));
+    HOST_ASSERT(host_time_since_boot_us() - start < 20000);
+    HOST_ASSERT_EQ(1, seesaw.stats.resets);
+
+    sensor_bus_power_off();
+    HOST_ASSERT_EQ(0, gpio_get_level(NEOPIXEL_I2C_POWER));
+    HOST_ASSERT_EQ(ESP_OK, sensor_bus_acquire(SENSOR_BUS_READING));
+    HOST_ASSERT_EQ(2, seesaw.stats.resets);
+}
+
+HOST_TEST(sensor_bus, sense_acquisition_reads_moisture_only)
+{
+    init_bus(true, NULL);
+    HOST_ASSERT_EQ(ESP_OK, sensor_bus_acquire(SENSOR_BUS_SENSE));
+    HOST_ASSERT_EQ(1, sensor_bus_get_stats()->steps);
+
+    soil_data_t soil;
+    ambient_data_t air;
+    HOST_ASSERT_EQ(ESP_OK, soil_sensor_get_acquired(&soil));
+    HOST_ASSERT_EQ(0, soil.temperature_centi);
+    HOST_ASSERT(ambient_sensor_get_acquired(&air) != ESP_OK);
+    HOST_ASSERT(!air.valid);
+    HOST_ASSERT_EQ(0, sht4x.stats.measurements);
+}
+
+HOST_TEST(sensor_bus, absent_ambient_sensor_fails_only_its_step)
+{
+    init_bus(false, NULL);
+    HOST_ASSERT_EQ(ESP_FAIL, sensor_bus_acquire(SENSOR_BUS_READING));
+    HOST_ASSERT_EQ(1, sensor_bus_get_stats()->failed);
+
+    soil_data_t soil;
+    ambient_data_t air;
+    HOST_ASSERT_EQ(ESP_OK, soil_sensor_get_acquired(&soil));
+    HOST_ASSERT(ambient_sensor_get_acquired(&air) != ESP_OK);
+}
+
+HOST_TEST(sensor_bus, earlier_results_are_not_reused)
+{
+    init_bus(true, NULL);
+    HOST_ASSERT_EQ(ESP_OK, sensor_bus_acquire(SENSOR_BUS_READING));
+    ambient_data_t air;
+    HOST_ASSERT_EQ(ESP_OK, ambient_sensor_get_acquired(&air));
+
+    host_i2c_detach(AMBIENT_SENSOR_ADDR);
+    HOST_ASSERT_EQ(ESP_FAIL, sensor_bus_acquire(SENSOR_BUS_READING));
+    HOST_ASSERT(ambient_sensor_get_acquired(&air) != ESP_OK);
+}
+
+HOST_TEST(sensor_bus, corrupted_crc_invalidates_the_air_reading)
+{
+    sht4x_sim_config_t config;
+    sht4x_sim_default_config(&config);
+    config.crc_error_probability = 1.0f;
+    init_bus(true, &config);
+
+    HOST_ASSERT_EQ(ESP_FAIL, sensor_bus_acquire(SENSOR_BUS_READING));
+    HOST_ASSERT_EQ(1, sht4x.stats.crc_errors);
+    ambient_data_t air;
+    HOST_ASSERT(ambient_sensor_get_acquired(&air) != ESP_OK);
+    soil_data_t soil;
+    HOST_ASSERT_EQ(ESP_OK, soil_sensor_get_acquired(&soil));
+}
+
+HOST_TEST(sensor_bus, ambient_conversion_matches_datasheet)
+{
+    // CRC example from the datasheet
+    const uint8_t word[2] = { 0xBE, 0xEF };
+    HOST_ASSERT_EQ(0x92, ambient_sensor_crc8(word, sizeof(word)));
+
+    HOST_ASSERT_EQ(-4500, ambient_sensor_temp_centi(0));
+    HOST_ASSERT_EQ(13000, ambient_sensor_temp_centi(65535));
+    HOST_ASSERT_EQ(0, ambient_sensor_humidity_centi(0));           // -6 %RH clamped
+    HOST_ASSERT_EQ(10000, ambient_sensor_humidity_centi(65535));   // 119 %RH clamped
+    HOST_ASSERT_EQ(5650, ambient_sensor_humidity_centi(32768));
+}
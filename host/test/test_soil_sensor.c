@@ -0,0 +1,117 @@
+/*
+ * Glyph C6 Monitor - soil_sensor host tests
+ */
+
+#include "host_test.h"
+#include "host_sim.h"
+#include "soil_sensor.h"
+#include "sensor_convert.h"
+#include "system_config.h"
+#include "driver/i2c_master.h"
+
+static host_i2c_script_t seesaw;
+
+static void init_sensor(void)
+{
+    i2c_master_bus_config_t bus_cfg = { .i2c_port = I2C_NUM_0 };
+    i2c_master_bus_handle_t bus;
+    HOST_ASSERT_EQ(ESP_OK, i2c_new_master_bus(&bus_cfg, &bus));
+    host_i2c_script_attach(&seesaw, SOIL_SENSOR_ADDR);
+    HOST_ASSERT_EQ(ESP_OK, soil_sensor_init(bus));
+}
+
+static void push_moisture(uint16_t raw)
+{
+    uint8_t data[2] = { raw >> 8, raw & 0xFF };
+    host_i2c_script_push_read(&seesaw, ESP_OK, data, sizeof(data));
+}
+
+static void push_temperature(int32_t raw)
+{
+    uint8_t data[4] = { (uint32_t)raw >> 24, (uint32_t)raw >> 16, (uint32_t)raw >> 8, (uint32_t)raw };
+    host_i2c_script_push_read(&seesaw, ESP_OK, data, sizeof(data));
+}
+
+HOST_TEST(soil_sensor, init_resets_and_waits_for_boot)
+{
+    uint64_t start = host_time_since_boot_us();
+    init_sensor();
+    HOST_ASSERT_EQ(1, seesaw.write_count);
+    HOST_ASSERT_EQ(3, seesaw.last_write_len);
+    HOST_ASSERT_EQ(0x7F, seesaw.last_write[1]);   // SWRST
+    HOST_ASSERT(host_time_since_boot_us() - start >= 1000000);
+}
+
+HOST_TEST(soil_sensor, moisture_is_big_endian_and_scaled)
+{
+    init_sensor();
+    uint16_t mid = (SOIL_VALUE_DRY + SOIL_VALUE_WET) / 2;
+    push_moisture(mid);
+    uint16_t raw;
+    uint16_t pct;
+    HOST_ASSERT_EQ(ESP_OK, soil_sensor_read_moisture(&raw, &pct));
+    HOST_ASSERT_EQ(mid, raw);
+    HOST_ASSERT_NEAR(5000, pct, 20);
+    HOST_ASSERT_EQ(0x0F, seesaw.last_write[0]);   // Touch base
+    HOST_ASSERT_EQ(0x10, seesaw.last_write[1]);
+}
+
+HOST_TEST(soil_sensor, moisture_is_clamped)
+{
+    init_sensor();
+    uint16_t raw;
+    uint16_t pct;
+    push_moisture(SOIL_VALUE_DRY - 100);
+    HOST_ASSERT_EQ(ESP_OK, soil_sensor_read_moisture(&raw, &pct));
+    HOST_ASSERT_EQ(0, pct);
+    push_moisture(SOIL_VALUE_WET + 100);
+    HOST_ASSERT_EQ(ESP_OK, soil_sensor_read_moisture(&raw, &pct));
+    HOST_ASSERT_EQ(10000, pct);
+}
+
+HOST_TEST(soil_sensor, temperature_is_16_16_fixed_point)
+{
+    init_sensor();
+    push_temperature((int32_t)(21.5 * 65536));
+    int16_t c;
+    HOST_ASSERT_EQ(ESP_OK, soil_sensor_read_temperature(&c));
+    HOST_ASSERT_EQ(2150, c);
+    push_temperature((int32_t)(-5.25 * 65536));
+    HOST_ASSERT_EQ(ESP_OK, soil_sensor_read_temperature(&c));
+    HOST_ASSERT_EQ(-525, c);
+}
+
+HOST_TEST(soil_sensor, integer_conversions_match_float)
+{
+    // The sample path's integer kernels against the float reference
+    for (uint32_t raw = 0; raw <= UINT16_MAX; raw++) {
+        int f = sensor_convert_zcl_humidity(sensor_convert_moisture_percent((uint16_t)raw));
+        HOST_ASSERT_NEAR(f, sensor_convert_moisture_centi((uint16_t)raw), 1);
+    }
+    for (int32_t raw = -40 * 65536; raw <= 85 * 65536; raw += 37) {
+        int f = sensor_convert_zcl_temperature(sensor_convert_temp_c(raw));
+        HOST_ASSERT_NEAR(f, sensor_convert_temp_centi(raw), 1);
+    }
+    HOST_ASSERT_EQ(INT16_MAX, sensor_convert_temp_centi(INT32_MAX));
+    HOST_ASSERT_EQ(INT16_MIN, sensor_convert_temp_centi(INT32_MIN));
+}
+
+HOST_TEST(soil_sensor, read_all_survives_temperature_failure)
+{
+    init_sensor();
+    push_moisture(700);
+    host_i2c_script_push_read(&seesaw, ESP_ERR_TIMEOUT, NULL, 0);
+    soil_data_t data;
+    HOST_ASSERT_EQ(ESP_OK, soil_sensor_read_all(&data));
+    HOST_ASSERT_EQ(700, data.moisture_raw);
+    HOST_ASSERT_EQ(0, data.temperature_centi);
+}
+
+HOST_TEST(soil_sensor, missing_device_fails_read)
+{
+    init_sensor();
+    host_i2c_detach(SOIL_SENSOR_ADDR);
+    uint16_t raw;
+    uint16_t pct;
+    HOST_ASSERT(soil_sensor_read_moisture(&raw, &pct) != ESP_OK);
+}
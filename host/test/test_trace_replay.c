@@ -0,0 +1,126 @@
+/*
+ * Glyph C6 Monitor - Field trace and replay host tests
+ *
+ * Record the deep-sleep firmware under the wake-cycle simulator, then
+ * replay the trace into the same firmware: the replay must reproduce
+ * the recorded run, including the recorded faults.
+ */
+
+#include "host_test.h"
+#include "host_sim.h"
+#include "field_trace.h"
+#include "trace_replay.h"
+#include "wake_sim.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * @brief Run the wake-cycle simulator and export what the firmware recorded
+ */
+static field_trace_record_t *record_run(const wake_sim_config_t *cfg, wake_sim_result_t *sim_res, size_t *count)
+{
+    HOST_ASSERT_EQ(ESP_OK, wake_sim_run(cfg, sim_res));
+    *count = field_trace_export(NULL, 0);
+    field_trace_record_t *records = malloc(*count * sizeof(*records));
+    HOST_ASSERT(records != NULL);
+    HOST_ASSERT_EQ(*count, field_trace_export(records, *count));
+    return records;
+}
+
+static size_t count_failed_i2c(const field_trace_record_t *records, size_t count)
+{
+    size_t n = 0;
+    for (size_t i = 0; i < count; i++) {
+        if ((records[i].type == FIELD_TRACE_I2C_TX || records[i].type == FIELD_TRACE_I2C_RX) &&
+            records[i].status != ESP_OK) {
+            n++;
+        }
+    }
+    return n;
+}
+
+HOST_TEST(trace_replay, replay_reproduces_recorded_run)
+{
+    wake_sim_config_t cfg;
+    wake_sim_default_config(&cfg);
+    cfg.days = 2;
+    wake_sim_result_t sim_res;
+    size_t count;
+    field_trace_record_t *records = record_run(&cfg, &sim_res, &count);
+    HOST_ASSERT(count > FIELD_TRACE_RING_RECORDS);          // Spilled to flash
+
+    trace_replay_config_t replay_cfg;
+    trace_replay_default_config(&replay_cfg);
+    trace_replay_result_t res;
+    HOST_ASSERT_EQ(ESP_OK, trace_replay_run(records, count, &replay_cfg, &res));
+    free(records);
+
+    HOST_ASSERT_EQ(sim_res.wakes, res.trace_wakes);
+    HOST_ASSERT_EQ(sim_res.radio_wakes, res.trace_radio_wakes);
+    HOST_ASSERT_EQ(res.trace_wakes, res.wakes);
+    HOST_ASSERT_EQ(res.trace_radio_wakes, res.radio_wakes);
+    HOST_ASSERT_EQ(sim_res.reports, res.reports);
+    HOST_ASSERT_NEAR(sim_res.awake_s, res.awake_s, sim_res.awake_s * 0.001);
+    HOST_ASSERT_NEAR(res.trace_awake_s, res.awake_s, res.trace_awake_s * 0.001);
+    HOST_ASSERT_NEAR(res.trace_charge_mah, res.charge_mah, res.trace_charge_mah * 0.01);
+    HOST_ASSERT(res.i2c_exact > 0);
+    HOST_ASSERT_EQ(0, res.i2c_held);
+    HOST_ASSERT_EQ(0, res.i2c_unmatched);
+    HOST_ASSERT(res.adc_exact > 0);
+    HOST_ASSERT_EQ(0, res.adc_unmatched);
+}
+
+HOST_TEST(trace_replay, recorded_faults_are_replayed)
+{
+    wake_sim_config_t cfg;
+    wake_sim_default_config(&cfg);
+    cfg.days = 1;
+    cfg.sensor.nack_probability = 0.05f;
+    cfg.rejoin_ms = 1500;
+    cfg.rejoin_jitter_ms = 2000;
+    wake_sim_result_t sim_res;
+    size_t count;
+    field_trace_record_t *records = record_run(&cfg, &sim_res, &count);
+    size_t failed = count_failed_i2c(records, count);
+    HOST_ASSERT(failed > 0);
+
+    trace_replay_config_t replay_cfg;
+    trace_replay_default_config(&replay_cfg);
+    trace_replay_result_t res;
+    HOST_ASSERT_EQ(ESP_OK, trace_replay_run(records, count, &replay_cfg, &res));
+    free(records);
+
+    HOST_ASSERT_EQ(failed, res.i2c_errors);
+    HOST_ASSERT_EQ(sim_res.reports, res.reports);
+    HOST_ASSERT_NEAR(sim_res.radio_s, res.radio_s, sim_res.radio_s * 0.001);
+}
+
+HOST_TEST(trace_replay, loads_console_capture)
+{
+    const char *path = "trace_replay_test.trace";
+    FILE *f = fopen(path, "w");
+    HOST_ASSERT(f != NULL);
+    fprintf(f, "I (1234) GLYPH: boot\n"
+               "FTRACE 00000010 00000000 00000001 00000000 00001000\n"
+               "noise FTRACE 00000200 0000012c 00360202 00000000 0000100f\n"
+               "FTRACE_DROPPED 3\n"
+               "FTRACE 00000400 00000000 00000006 00000000 00000258\n");
+    fclose(f);
+
+    field_trace_record_t *records;
+    size_t count;
+    HOST_ASSERT_EQ(ESP_OK, trace_replay_load(path, &records, &count));
+    remove(path);
+    HOST_ASSERT_EQ(3, count);
+    HOST_ASSERT_EQ(FIELD_TRACE_WAKE, records[0].type);
+    HOST_ASSERT_EQ(FIELD_TRACE_I2C_TX, records[1].type);
+    HOST_ASSERT_EQ(0x36, records[1].source);
+    HOST_ASSERT_EQ(2, records[1].len);
+    HOST_ASSERT_EQ(300, records[1].duration_us);
+    HOST_ASSERT_EQ(0x0F, records[1].data[0]);
+    HOST_ASSERT_EQ(0x10, records[1].data[1]);
+    HOST_ASSERT_EQ(FIELD_TRACE_SLEEP, records[2].type);
+    free(records);
+
+    HOST_ASSERT_EQ(ESP_ERR_NOT_FOUND, trace_replay_load("no_such.trace", &records, &count));
+}
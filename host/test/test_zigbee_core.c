@@ -0,0 +1,469 @@
+/*
+ * Glyph C6 Monitor - zigbee_core host tests
+ */
+
+#include "host_test.h"
+#include "host_sim.h"
+#include "zigbee_core.h"
+#include "perf_config.h"
+#include "freshness.h"
+#include "nvs_flash.h"
+#include <string.h>
+
+// The application provides the signal handler (main.c on target)
+void esp_zb_app_signal_handler(esp_zb_app_signal_t *signal_struct)
+{
+    zigbee_core_app_signal_handler(signal_struct);
+}
+
+static esp_err_t action_handler(esp_zb_core_action_callback_id_t callback_id, const void *message)
+{
+    const esp_zb_zcl_set_attr_value_message_t *msg = message;
+    if (callback_id == ESP_ZB_CORE_SET_ATTR_VALUE_CB_ID && msg->info.cluster == GLYPH_CLUSTER_ID_CONFIG) {
+        return zigbee_core_handle_config_write(msg->attribute.id, msg->attribute.data.value);
+    }
+    return ESP_OK;
+}
+
+static void start_stack(void)
+{
+    HOST_ASSERT_EQ(ESP_OK, nvs_flash_init());
+    HOST_ASSERT_EQ(ESP_OK, perf_config_init());
+    HOST_ASSERT_EQ(ESP_OK, zigbee_core_init());
+    HOST_ASSERT_EQ(ESP_OK, zigbee_core_register_action_handler(action_handler));
+    HOST_ASSERT_EQ(ESP_OK, zigbee_core_start());
+}
+
+HOST_TEST(zigbee_core, joins_after_steering)
+{
+    host_zb_set_network(true, ESP_OK, 1500);
+    start_stack();
+    HOST_ASSERT(!zigbee_core_is_joined());
+    host_time_advance_us(1000000);
+    HOST_ASSERT(!zigbee_core_is_joined());
+    host_time_advance_us(1000000);
+    HOST_ASSERT(zigbee_core_is_joined());
+
+    zigbee_device_info_t info;
+    HOST_ASSERT(zigbee_core_get_device_info(&info));
+    HOST_ASSERT(info.short_address != 0xFFFE);
+}
+
+HOST_TEST(zigbee_core, steering_failure_retries)
+{
+    host_zb_set_network(true, ESP_FAIL, 1000);
+    start_stack();
+    host_time_advance_us(10000000);
+    HOST_ASSERT(!zigbee_core_is_joined());
+
+    host_zb_set_network(true, ESP_OK, 1000);
+    host_time_advance_us(5000000);                 // Next retry 3 s after a failure
+    HOST_ASSERT(zigbee_core_is_joined());
+}
+
+HOST_TEST(zigbee_core, rejoins_without_steering)
+{
+    host_zb_set_network(false, ESP_FAIL, 1000);    // Steering would fail
+    start_stack();
+    host_time_advance_us(100000);
+    HOST_ASSERT(zigbee_core_is_joined());
+}
+
+HOST_TEST(zigbee_core, rejoin_latency_and_failure_are_scripted)
+{
+    host_zb_set_network(false, ESP_OK, 1000);
+    host_zb_set_rejoin(ESP_OK, 800);
+    start_stack();
+    host_time_advance_us(500000);
+    HOST_ASSERT(!zigbee_core_is_joined());
+    host_time_advance_us(500000);
+    HOST_ASSERT(zigbee_core_is_joined());
+
+    // Chip reset: module statics and stack state are lost, then the rejoin fails
+    host_time_reboot();
+    HOST_ASSERT(!zigbee_core_is_joined());
+    host_zb_set_rejoin(ESP_FAIL, 0);
+    start_stack();
+    host_time_advance_us(5000000);
+    HOST_ASSERT(!zigbee_core_is_joined());
+    HOST_ASSERT(host_zb_radio_on_us() >= 6000000);
+}
+
+HOST_TEST(zigbee_core, moisture_update_and_report)
+{
+    host_zb_set_network(true, ESP_OK, 100);
+    start_stack();
+    host_time_advance_us(1000000);
+
+    HOST_ASSERT_EQ(ESP_OK, zigbee_core_update_soil_moisture(4250));
+    uint16_t value = 0;
+    HOST_ASSERT_EQ(2, host_zb_get_attr(HA_ESP_SENSOR_ENDPOINT, ESP_ZB_ZCL_CLUSTER_ID_REL_HUMIDITY_MEASUREMENT,
+                                       ESP_ZB_ZCL_ATTR_REL_HUMIDITY_MEASUREMENT_VALUE_ID, &value, sizeof(value)));
+    HOST_ASSERT_EQ(4250, value);
+
+    uint32_t before = host_zb_report_count();
+    HOST_ASSERT_EQ(ESP_OK, zigbee_core_report_attribute(ESP_ZB_ZCL_CLUSTER_ID_REL_HUMIDITY_MEASUREMENT,
+                                                        ESP_ZB_ZCL_ATTR_REL_HUMIDITY_MEASUREMENT_VALUE_ID));
+    HOST_ASSERT_EQ(before + 1, host_zb_report_count());
+    const host_zb_report_t *r = host_zb_report_get(before);
+    HOST_ASSERT(r != NULL);
+    HOST_ASSERT_EQ(ESP_ZB_ZCL_CLUSTER_ID_REL_HUMIDITY_MEASUREMENT, r->cluster_id);
+    HOST_ASSERT_EQ(2, r->value_len);
+    HOST_ASSERT(memcmp(r->value, &value, 2) == 0);
+}
+
+HOST_TEST(zigbee_core, power_source_is_reported_only_when_it_changes)
+{
+    host_zb_set_network(true, ESP_OK, 100);
+    start_stack();
+    host_time_advance_us(1000000);
+
+    uint32_t before = host_zb_report_count();
+    HOST_ASSERT_EQ(ESP_OK, zigbee_core_update_power_source(false));
+    HOST_ASSERT_EQ(before + 1, host_zb_report_count());
+    HOST_ASSERT_EQ(ESP_ZB_ZCL_CLUSTER_ID_BASIC, host_zb_report_get(before)->cluster_id);
+
+    // Same source on the next wakes: attribute kept, no frame
+    HOST_ASSERT_EQ(ESP_OK, zigbee_core_update_power_source(false));
+    HOST_ASSERT_EQ(before + 1, host_zb_report_count());
+
+    HOST_ASSERT_EQ(ESP_OK, zigbee_core_update_power_source(true));
+    HOST_ASSERT_EQ(before + 2, host_zb_report_count());
+    uint8_t source = 0;
+    HOST_ASSERT_EQ(1, host_zb_get_attr(HA_ESP_SENSOR_ENDPOINT, ESP_ZB_ZCL_CLUSTER_ID_BASIC,
+                                       ESP_ZB_ZCL_ATTR_BASIC_POWER_SOURCE_ID, &source, sizeof(source)));
+    HOST_ASSERT_EQ(ESP_ZB_ZCL_BASIC_POWER_SOURCE_DC_SOURCE, source);
+    HOST_ASSERT_EQ(ESP_OK, zigbee_core_update_power_source(true));
+    HOST_ASSERT_EQ(before + 2, host_zb_report_count());
+
+    // A report the stack refused is not remembered as sent
+    host_zb_set_report_status(ESP_ERR_NO_MEM);
+    HOST_ASSERT_EQ(ESP_ERR_NO_MEM, zigbee_core_update_power_source(false));
+    host_zb_set_report_status(ESP_OK);
+    HOST_ASSERT_EQ(ESP_OK, zigbee_core_update_power_source(false));
+    HOST_ASSERT_EQ(before + 3, host_zb_report_count());
+}
+
+HOST_TEST(zigbee_core, config_write_is_staged_and_attribute_shows_active)
+{
+    host_zb_set_network(true, ESP_OK, 100);
+    start_stack();
+    host_time_advance_us(1000000);
+
+    uint32_t active = perf_config_get(PERF_PARAM_BATT_SAMPLE_INTERVAL_SEC);
+    uint32_t staged = active * 2;
+    HOST_ASSERT_EQ(ESP_OK, host_zb_write_attr(HA_ESP_SENSOR_ENDPOINT, GLYPH_CLUSTER_ID_CONFIG,
+                                              GLYPH_ATTR_CFG_BATT_SAMPLE_INTERVAL_ID, &staged, sizeof(staged)));
+    HOST_ASSERT(perf_config_pending());
+    HOST_ASSERT_EQ(active, perf_config_get(PERF_PARAM_BATT_SAMPLE_INTERVAL_SEC));
+    HOST_ASSERT(host_nvs_commit_count() > 0);
+
+    // The store is restored to the active value by the sync alarm
+    host_time_advance_us(100000);
+    uint32_t shown = 0;
+    HOST_ASSERT_EQ(4, host_zb_get_attr(HA_ESP_SENSOR_ENDPOINT, GLYPH_CLUSTER_ID_CONFIG,
+                                       GLYPH_ATTR_CFG_BATT_SAMPLE_INTERVAL_ID, &shown, sizeof(shown)));
+    HOST_ASSERT_EQ(active, shown);
+    bool pending = false;
+    HOST_ASSERT_EQ(1, host_zb_get_attr(HA_ESP_SENSOR_ENDPOINT, GLYPH_CLUSTER_ID_CONFIG,
+                                       GLYPH_ATTR_CFG_PENDING_ID, &pending, sizeof(pending)));
+    HOST_ASSERT(pending);
+}
+
+HOST_TEST(zigbee_core, out_of_bounds_config_write_is_rejected)
+{
+    host_zb_set_network(true, ESP_OK, 100);
+    start_stack();
+    host_time_advance_us(1000000);
+
+    uint8_t samples = 200;   // Allowed 1..16
+    HOST_ASSERT_EQ(ESP_ERR_INVALID_ARG, host_zb_write_attr(HA_ESP_SENSOR_ENDPOINT, GLYPH_CLUSTER_ID_CONFIG,
+                                                           GLYPH_ATTR_CFG_BATT_NUM_SAMPLES_ID,
+                                                           &samples, sizeof(samples)));
+    HOST_ASSERT(!perf_config_pending());
+
+    // Refused before the store: the attribute never shows the value
+    uint8_t shown = 0;
+    HOST_ASSERT_EQ(1, host_zb_get_attr(HA_ESP_SENSOR_ENDPOINT, GLYPH_CLUSTER_ID_CONFIG,
+                                       GLYPH_ATTR_CFG_BATT_NUM_SAMPLES_ID, &shown, sizeof(shown)));
+    HOST_ASSERT_EQ(perf_config_get(PERF_PARAM_BATT_NUM_SAMPLES), shown);
+}
+
+HOST_TEST(zigbee_core, inconsistent_config_write_is_rejected_until_ordered)
+{
+    host_zb_set_network(true, ESP_OK, 100);
+    start_stack();
+    host_time_advance_us(1000000);
+
+    // Sample interval past the heartbeat: refused, the heartbeat goes first
+    uint32_t report = perf_config_get(PERF_PARAM_BATT_REPORT_INTERVAL_SEC);
+    uint32_t sample = report + 60;
+    HOST_ASSERT_EQ(ESP_ERR_INVALID_ARG, host_zb_write_attr(HA_ESP_SENSOR_ENDPOINT, GLYPH_CLUSTER_ID_CONFIG,
+                                                           GLYPH_ATTR_CFG_BATT_SAMPLE_INTERVAL_ID,
+                                                           &sample, sizeof(sample)));
+    HOST_ASSERT(!perf_config_pending());
+
+    report = sample * 2;
+    HOST_ASSERT_EQ(ESP_OK, host_zb_write_attr(HA_ESP_SENSOR_ENDPOINT, GLYPH_CLUSTER_ID_CONFIG,
+                                              GLYPH_ATTR_CFG_BATT_REPORT_INTERVAL_ID, &report, sizeof(report)));
+    HOST_ASSERT_EQ(ESP_OK, host_zb_write_attr(HA_ESP_SENSOR_ENDPOINT, GLYPH_CLUSTER_ID_CONFIG,
+                                              GLYPH_ATTR_CFG_BATT_SAMPLE_INTERVAL_ID, &sample, sizeof(sample)));
+    HOST_ASSERT(perf_config_pending());
+    HOST_ASSERT(perf_config_apply_pending());
+    HOST_ASSERT_EQ(sample, perf_config_get(PERF_PARAM_BATT_SAMPLE_INTERVAL_SEC));
+}
+
+HOST_TEST(zigbee_core, freshness_record_is_reported)
+{
+    host_zb_set_network(true, ESP_OK, 100);
+    start_stack();
+    host_time_advance_us(1000000);
+
+    freshness_histogram_t hist = {0};
+    freshness_record(&hist, 999);       // < 1 s
+    freshness_record(&hist, 25000);     // < 30 s
+    freshness_record(&hist, 7200000);   // Open-ended last bucket
+
+    // Acquired just before the device clock wrapped, sent 25 s later
+    uint32_t acquired_ms = 0xFFFFF000u;
+    uint32_t sent_ms = acquired_ms + 25000;
+    HOST_ASSERT_EQ(25000, freshness_age_ms(acquired_ms, sent_ms));
+
+    uint8_t record[FRESHNESS_RECORD_LEN];
+    HOST_ASSERT_EQ(0, freshness_encode(&hist, acquired_ms, sent_ms, record, sizeof(record) - 1));
+    size_t len = freshness_encode(&hist, acquired_ms, sent_ms, record, sizeof(record));
+    HOST_ASSERT_EQ(FRESHNESS_RECORD_LEN, len);
+
+    uint32_t before = host_zb_report_count();
+    HOST_ASSERT_EQ(ESP_OK, zigbee_core_update_freshness(record, len));
+    HOST_ASSERT_EQ(before + 1, host_zb_report_count());
+    const host_zb_report_t *r = host_zb_report_get(before);
+    HOST_ASSERT_EQ(GLYPH_CLUSTER_ID_STATS, r->cluster_id);
+    HOST_ASSERT_EQ(GLYPH_ATTR_FRESHNESS_ID, r->attr_id);
+    HOST_ASSERT_EQ(FRESHNESS_RECORD_LEN + 1, r->value_len);
+    HOST_ASSERT_EQ(FRESHNESS_RECORD_LEN, r->value[0]);
+    HOST_ASSERT_EQ(FRESHNESS_RECORD_VERSION, r->value[1]);
+    HOST_ASSERT_EQ(FRESHNESS_BUCKETS, r->value[10]);
+    HOST_ASSERT_EQ(1, r->value[11]);                            // Bucket 0
+    HOST_ASSERT_EQ(1, r->value[11 + 3 * 2]);                    // Bucket 3
+    HOST_ASSERT_EQ(1, r->value[11 + (FRESHNESS_BUCKETS - 1) * 2]);
+
+    HOST_ASSERT_EQ(ESP_ERR_INVALID_ARG, zigbee_core_update_freshness(record, FRESHNESS_RECORD_LEN + 1));
+}
+
+HOST_TEST(zigbee_core, link_reselection_needs_sustained_cost_and_backs_off)
+{
+    link_quality_t lq;
+    link_quality_reset(&lq);
+    HOST_ASSERT(!link_quality_check(&lq, 0));          // Nothing sampled yet
+
+    // A good parent never asks for a reselection
+    link_quality_parent_sample(&lq, 0x0000, 220, -55);
+    for (int i = 0; i < 8; i++) {
+        link_quality_tx_result(&lq, true);
+    }
+    HOST_ASSERT(link_quality_cost(&lq) <= LINK_COST_GOOD);
+    HOST_ASSERT(!link_quality_check(&lq, 160));
+
+    // Costly checks only count while they are consecutive
+    link_quality_reset(&lq);
+    link_quality_parent_sample(&lq, 0x0000, 60, -88);
+    for (int i = 1; i < LINK_BAD_CHECKS; i++) {
+        link_quality_tx_result(&lq, false);
+        HOST_ASSERT(!link_quality_check(&lq, 160));
+    }
+    for (int i = 0; i < 32; i++) {
+        link_quality_tx_result(&lq, true);
+    }
+    link_quality_parent_sample(&lq, 0x0000, 220, -55);
+    link_quality_parent_sample(&lq, 0x0000, 220, -55);
+    link_quality_parent_sample(&lq, 0x0000, 220, -55);
+    HOST_ASSERT(!link_quality_check(&lq, 160));        // Good check clears the count
+    HOST_ASSERT_EQ(0, lq.bad_checks);
+
+    // Sustained cost with a better router in range: reselect once
+    link_quality_reset(&lq);
+    link_quality_parent_sample(&lq, 0x0000, 60, -88);
+    bool reselect = false;
+    for (int i = 0; i < LINK_BAD_CHECKS && !reselect; i++) {
+        for (int f = 0; f < 4; f++) {
+            link_quality_tx_result(&lq, f != 0);
+        }
+        reselect = link_quality_check(&lq, 160);
+    }
+    HOST_ASSERT(reselect);
+    HOST_ASSERT_EQ(1, lq.reselections);
+
+    // The rejoin came back to the same parent: the hold-off doubles
+    link_quality_parent_sample(&lq, 0x0000, 60, -88);
+    HOST_ASSERT(!lq.reselecting);
+    HOST_ASSERT_EQ(2 * LINK_RESELECT_MIN_CHECKS, lq.hold_checks);
+    for (int i = 0; i < 2 * LINK_RESELECT_MIN_CHECKS; i++) {
+        for (int f = 0; f < 4; f++) {
+            link_quality_tx_result(&lq, false);
+        }
+        HOST_ASSERT(!link_quality_check(&lq, 160));
+    }
+    for (int f = 0; f < 4; f++) {
+        link_quality_tx_result(&lq, false);
+    }
+    HOST_ASSERT(link_quality_check(&lq, 160));         // Hold-off over, still costly
+    HOST_ASSERT_EQ(2, lq.reselections);
+}
+
+HOST_TEST(zigbee_core, weak_parent_is_replaced_across_wakes)
+{
+    const host_zb_router_t routers[] = {
+        { .short_addr = 0x0000, .lqi = 200, .rssi = -60, .loss = 0.0f },
+        { .short_addr = 0x7A10, .lqi = 160, .rssi = -71, .loss = 0.0f },
+    };
+    host_zb_set_routers(routers, 2);
+    host_zb_set_network(true, ESP_OK, 100);
+    start_stack();
+    host_time_advance_us(1000000);
+    HOST_ASSERT(zigbee_core_is_joined());
+    HOST_ASSERT_EQ(0, host_zb_parent_index());
+
+    // The coordinator link fades; every wake reboots and rejoins from NVRAM
+    host_zb_set_router_link(0, 60, -88, 0.4f);
+    link_quality_t link;
+    int wakes = 0;
+    while (host_zb_parent_index() == 0 && wakes < 12) {
+        for (int i = 0; i < 6; i++) {
+            zigbee_core_report_attribute(ESP_ZB_ZCL_CLUSTER_ID_REL_HUMIDITY_MEASUREMENT,
+                                         ESP_ZB_ZCL_ATTR_REL_HUMIDITY_MEASUREMENT_VALUE_ID);
+        }
+        host_time_advance_us(100000);                 // Delivery confirmations
+        host_time_reboot();
+        start_stack();
+        host_time_advance_us(2000000);
+        wakes++;
+    }
+    HOST_ASSERT_EQ(1, host_zb_parent_index());
+    HOST_ASSERT(wakes >= LINK_BAD_CHECKS);
+    HOST_ASSERT(zigbee_core_is_joined());
+    HOST_ASSERT(zigbee_core_get_link_quality(&link));
+    HOST_ASSERT_EQ(0x7A10, link.parent);
+    HOST_ASSERT_EQ(1, link.reselections);
+    HOST_ASSERT(link.frames_failed > 0);
+
+    // The new parent is good: no further reselection
+    for (int w = 0; w < 6; w++) {
+        for (int i = 0; i < 6; i++) {
+            zigbee_core_report_attribute(ESP_ZB_ZCL_CLUSTER_ID_REL_HUMIDITY_MEASUREMENT,
+                                         ESP_ZB_ZCL_ATTR_REL_HUMIDITY_MEASUREMENT_VALUE_ID);
+        }
+        host_time_advance_us(100000);
+        host_time_reboot();
+        start_stack();
+        host_time_advance_us(2000000);
+    }
+    HOST_ASSERT(zigbee_core_get_link_quality(&link));
+    HOST_ASSERT_EQ(1, link.reselections);
+    HOST_ASSERT(link_quality_cost(&link) <= LINK_COST_GOOD);
+}
+
+static int radio_idle_calls;
+
+static void count_radio_idle(void)
+{
+    radio_idle_calls++;
+}
+
+HOST_TEST(zigbee_core, parent_queue_is_drained_right_after_rejoin)
+{
+    host_zb_set_network(true, ESP_OK, 100);
+    start_stack();
+    host_time_advance_us(1000000);
+    HOST_ASSERT(zigbee_core_is_joined());
+    host_time_reboot();
+
+    // The coordinator wrote three config attributes while the device slept
+    uint32_t sample_sec = perf_config_get(PERF_PARAM_BATT_SAMPLE_INTERVAL_SEC) * 2;
+    uint32_t report_sec = perf_config_get(PERF_PARAM_BATT_REPORT_INTERVAL_SEC) * 2;
+    uint32_t sense_sec = perf_config_get(PERF_PARAM_SENSE_INTERVAL_SEC) * 2;
+    HOST_ASSERT_EQ(ESP_OK, host_zb_queue_write(HA_ESP_SENSOR_ENDPOINT, GLYPH_CLUSTER_ID_CONFIG,
+                                               GLYPH_ATTR_CFG_BATT_SAMPLE_INTERVAL_ID, &sample_sec, 4));
+    HOST_ASSERT_EQ(ESP_OK, host_zb_queue_write(HA_ESP_SENSOR_ENDPOINT, GLYPH_CLUSTER_ID_CONFIG,
+                                               GLYPH_ATTR_CFG_BATT_REPORT_INTERVAL_ID, &report_sec, 4));
+    HOST_ASSERT_EQ(ESP_OK, host_zb_queue_write(HA_ESP_SENSOR_ENDPOINT, GLYPH_CLUSTER_ID_CONFIG,
+                                               GLYPH_ATTR_CFG_SENSE_INTERVAL_ID, &sense_sec, 4));
+
+    start_stack();
+    HOST_ASSERT_EQ(ESP_OK, zigbee_core_register_radio_idle_callback(count_radio_idle));
+    radio_idle_calls = 0;
+    uint32_t polls_before = host_zb_poll_count();
+    host_time_advance_us(500000);
+    HOST_ASSERT(zigbee_core_is_joined());
+
+    // One poll per queued frame plus the empty one that ends the drain
+    HOST_ASSERT_EQ(0, host_zb_indirect_pending());
+    HOST_ASSERT_EQ(4, host_zb_poll_count() - polls_before);
+    HOST_ASSERT(perf_config_pending());
+    zigbee_drain_stats_t stats;
+    HOST_ASSERT(zigbee_core_get_drain_stats(&stats));
+    HOST_ASSERT_EQ(3, stats.last_frames);
+    HOST_ASSERT_EQ(4, stats.last_polls);
+    HOST_ASSERT(stats.last_ms >= 4 * ZIGBEE_DRAIN_POLL_WAIT_MS);
+    HOST_ASSERT(stats.last_ms < 10 * ZIGBEE_DRAIN_POLL_WAIT_MS);
+    HOST_ASSERT_EQ(2, stats.drains);                 // First join (empty queue) and this rejoin
+    HOST_ASSERT_EQ(1, radio_idle_calls);
+    HOST_ASSERT(zigbee_core_radio_idle());
+}
+
+HOST_TEST(zigbee_core, drain_counts_frames_that_are_not_zcl)
+{
+    host_zb_set_network(true, ESP_OK, 100);
+    start_stack();
+    host_time_advance_us(1000000);
+    host_time_reboot();
+
+    // A ZDO request ahead of a config write in the parent's queue
+    uint32_t sense_sec = perf_config_get(PERF_PARAM_SENSE_INTERVAL_SEC) * 2;
+    HOST_ASSERT_EQ(ESP_OK, host_zb_queue_frame(0x0000, 0x0031));   // ZDO Mgmt_Lqi_req
+    HOST_ASSERT_EQ(ESP_OK, host_zb_queue_write(HA_ESP_SENSOR_ENDPOINT, GLYPH_CLUSTER_ID_CONFIG,
+                                               GLYPH_ATTR_CFG_SENSE_INTERVAL_ID, &sense_sec, 4));
+
+    start_stack();
+    host_time_advance_us(500000);
+    HOST_ASSERT_EQ(0, host_zb_indirect_pending());
+    HOST_ASSERT(perf_config_pending());
+    zigbee_drain_stats_t stats;
+    HOST_ASSERT(zigbee_core_get_drain_stats(&stats));
+    HOST_ASSERT_EQ(2, stats.last_frames);
+    HOST_ASSERT_EQ(3, stats.last_polls);
+}
+
+HOST_TEST(zigbee_core, radio_goes_idle_once_sends_are_confirmed_and_drained)
+{
+    host_zb_set_network(true, ESP_OK, 100);
+    start_stack();
+    HOST_ASSERT_EQ(ESP_OK, zigbee_core_register_radio_idle_callback(count_radio_idle));
+    host_time_advance_us(1000000);
+    radio_idle_calls = 0;
+
+    for (int i = 0; i < 3; i++) {
+        zigbee_core_report_attribute(ESP_ZB_ZCL_CLUSTER_ID_REL_HUMIDITY_MEASUREMENT,
+                                     ESP_ZB_ZCL_ATTR_REL_HUMIDITY_MEASUREMENT_VALUE_ID);
+    }
+    HOST_ASSERT(!zigbee_core_radio_idle());
+
+    // A reply to the reports waits at the parent: the drain after the
+    // last send status picks it up before the radio counts as idle
+    uint32_t staged = perf_config_get(PERF_PARAM_BATT_SAMPLE_INTERVAL_SEC) * 2;
+    HOST_ASSERT_EQ(ESP_OK, host_zb_queue_write(HA_ESP_SENSOR_ENDPOINT, GLYPH_CLUSTER_ID_CONFIG,
+                                               GLYPH_ATTR_CFG_BATT_SAMPLE_INTERVAL_ID, &staged, 4));
+    host_time_advance_us(30000);                      // Send statuses in, drain running
+    HOST_ASSERT(!zigbee_core_radio_idle());
+    HOST_ASSERT_EQ(0, radio_idle_calls);
+
+    host_time_advance_us(100000);
+    HOST_ASSERT(zigbee_core_radio_idle());
+    HOST_ASSERT_EQ(1, radio_idle_calls);
+    HOST_ASSERT_EQ(0, host_zb_indirect_pending());
+    HOST_ASSERT(perf_config_pending());
+    zigbee_drain_stats_t stats;
+    HOST_ASSERT(zigbee_core_get_drain_stats(&stats));
+    HOST_ASSERT_EQ(1, stats.last_frames);
+    HOST_ASSERT_EQ(2, stats.last_polls);
+}
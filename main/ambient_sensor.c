@@ -0,0 +1,144 @@
+/*
+ * Sensirion SHT4x Ambient Sensor Driver Implementation
+ * Scheduled steps only - the acquisition scheduler owns the waits
+ */
+
+#include "ambient_sensor.h"
+#include "system_config.h"
+#include "sensor_bus.h"
+#include "driver/i2c_master.h"
+// Per-read driver chatter is stripped from the wake path at compile time
+#define BINLOG_LEVEL BINLOG_LEVEL_WARN
+#include "binlog.h"
+#include "field_trace.h"
+
+static const char *TAG = "AMBIENT";
+
+// SHT4x commands (single byte, no register address)
+#define SHT4X_CMD_SOFT_RESET        0x94
+#define SHT4X_CMD_MEASURE_HIGH      0xFD
+
+// I2C device handle
+static i2c_master_dev_handle_t i2c_dev_handle = NULL;
+
+// Result of the scheduled measurement, tagged with the acquisition
+static ambient_data_t acquired;
+static uint32_t acquired_sequence;
+
+static esp_err_t sht4x_write_cmd(uint8_t cmd)
+{
+    uint32_t start = field_trace_start();
+    esp_err_t ret = i2c_master_transmit(i2c_dev_handle, &cmd, 1, I2C_MASTER_TIMEOUT_MS);
+    field_trace_i2c(FIELD_TRACE_I2C_TX, AMBIENT_SENSOR_ADDR, &cmd, 1, ret, start);
+    return ret;
+}
+
+// Scheduler steps: soft reset at power-up, then one measurement
+
+static esp_err_t step_reset(void *ctx)
+{
+    (void)ctx;
+    return sht4x_write_cmd(SHT4X_CMD_SOFT_RESET);
+}
+
+static esp_err_t step_measure_start(void *ctx)
+{
+    (void)ctx;
+    return sht4x_write_cmd(SHT4X_CMD_MEASURE_HIGH);
+}
+
+static esp_err_t step_measure_read(void *ctx)
+{
+    (void)ctx;
+    // T word, CRC, RH word, CRC
+    uint8_t data[6];
+    uint32_t start = field_trace_start();
+    esp_err_t ret = i2c_master_receive(i2c_dev_handle, data, sizeof(data), I2C_MASTER_TIMEOUT_MS);
+    field_trace_i2c(FIELD_TRACE_I2C_RX, AMBIENT_SENSOR_ADDR, data, sizeof(data), ret, start);
+    if (ret != ESP_OK) {
+        BLOG_E(TAG, "Failed to read measurement: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    if (ambient_sensor_crc8(&data[0], 2) != data[2] || ambient_sensor_crc8(&data[3], 2) != data[5]) {
+        BLOG_E(TAG, "Measurement CRC mismatch");
+        return ESP_ERR_INVALID_CRC;
+    }
+    acquired.temperature_centi = ambient_sensor_temp_centi((uint16_t)((data[0] << 8) | data[1]));
+    acquired.humidity_centi = ambient_sensor_humidity_centi((uint16_t)((data[3] << 8) | data[4]));
+    acquired_sequence = sensor_bus_sequence();
+    return ESP_OK;
+}
+
+// Register with the acquisition scheduler
+esp_err_t ambient_sensor_register(void)
+{
+    void *bus_handle = sensor_bus_handle();
+    if (bus_handle == NULL) {
+        BLOG_E(TAG, "Invalid bus handle");
+        return ESP_FAIL;
+    }
+    if (i2c_dev_handle == NULL) {
+        i2c_device_config_t dev_cfg = {
+            .dev_addr_length = I2C_ADDR_BIT_LEN_7,
+            .device_address = AMBIENT_SENSOR_ADDR,
+            .scl_speed_hz = 100000,  // 100kHz, shared with the Seesaw
+        };
+        esp_err_t ret = i2c_master_bus_add_device((i2c_master_bus_handle_t)bus_handle, &dev_cfg, &i2c_dev_handle);
+        if (ret != ESP_OK) {
+            BLOG_E(TAG, "Failed to add I2C device: %s", esp_err_to_name(ret));
+            return ESP_FAIL;
+        }
+    }
+
+    sensor_bus_device_t dev = {
+        .name = "sht4x",
+        .ready_ms = AMBIENT_POWER_UP_MS,
+        .power_up = step_reset,
+        .steps = {
+            { AMBIENT_MEASURE_WAIT_US, SENSOR_BUS_READING, step_measure_start, step_measure_read },
+        },
+        .step_count = 1,
+    };
+    return sensor_bus_register(&dev);
+}
+
+// Result of the last scheduled acquisition
+esp_err_t ambient_sensor_get_acquired(ambient_data_t *data)
+{
+    if (!data) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (i2c_dev_handle == NULL || acquired_sequence != sensor_bus_sequence()) {
+        data->valid = false;
+        return ESP_FAIL;
+    }
+    *data = acquired;
+    data->valid = true;
+    return ESP_OK;
+}
+
+uint8_t ambient_sensor_crc8(const uint8_t *data, size_t len)
+{
+    uint8_t crc = 0xFF;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x31) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+int16_t ambient_sensor_temp_centi(uint16_t raw)
+{
+    return (int16_t)(-4500 + (17500 * (int32_t)raw + 32767) / 65535);
+}
+
+uint16_t ambient_sensor_humidity_centi(uint16_t raw)
+{
+    int32_t centi = -600 + (12500 * (int32_t)raw + 32767) / 65535;
+    if (centi < 0) {
+        return 0;
+    }
+    return (uint16_t)(centi > 10000 ? 10000 : centi);
+}
@@ -0,0 +1,55 @@
+/*
+ * Sensirion SHT4x Ambient Sensor Driver
+ *
+ * Air temperature and relative humidity from an SHT40/41/45 on the STEMMA
+ * QT chain (CONFIG_GLYPH_AMBIENT_SHT4X). Runs only through the I2C
+ * acquisition scheduler (sensor_bus.c): soft reset when the bus powers up,
+ * one high-repeatability measurement per reading sample, converted to
+ * 0.01 units. Sense wakes do not measure the air.
+ */
+
+#ifndef AMBIENT_SENSOR_H
+#define AMBIENT_SENSOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+// Ambient sensor data structure
+typedef struct {
+    int16_t temperature_centi;    // Temperature in 0.01 °C
+    uint16_t humidity_centi;      // Relative humidity in 0.01 % (0-10000)
+    bool valid;                   // Data validity flag
+} ambient_data_t;
+
+/**
+ * @brief Register with the I2C acquisition scheduler (no wait)
+ * @return ESP_OK, ESP_FAIL without a bus
+ */
+esp_err_t ambient_sensor_register(void);
+
+/**
+ * @brief Data of the last sensor_bus_acquire()
+ * @param data Output (valid = false if the measurement failed or was not
+ *             part of the acquisition)
+ * @return ESP_OK if the acquisition measured the air
+ */
+esp_err_t ambient_sensor_get_acquired(ambient_data_t *data);
+
+/**
+ * @brief SHT4x CRC-8 (polynomial 0x31, init 0xFF) over one data word
+ */
+uint8_t ambient_sensor_crc8(const uint8_t *data, size_t len);
+
+/**
+ * @brief Convert a raw temperature word to 0.01 °C (-45 + 175 * raw / 65535)
+ */
+int16_t ambient_sensor_temp_centi(uint16_t raw);
+
+/**
+ * @brief Convert a raw humidity word to 0.01 %RH (-6 + 125 * raw / 65535, clamped)
+ */
+uint16_t ambient_sensor_humidity_centi(uint16_t raw);
+
+#endif // AMBIENT_SENSOR_H
@@ -0,0 +1,141 @@
+/*
+ * Glyph C6 Monitor - Application Event Loop
+ *
+ * Version: 1.0.0
+ */
+
+#include "app_loop.h"
+#include "system_config.h"
+#include "binlog.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/timers.h"
+
+static const char *TAG = "APP_LOOP";
+
+static StackType_t loop_stack[APP_LOOP_TASK_STACK];
+static StaticTask_t loop_tcb;
+static TaskHandle_t loop_task = NULL;
+
+static uint8_t queue_storage[APP_LOOP_QUEUE_LENGTH * sizeof(app_event_t)];
+static StaticQueue_t queue_buffer;
+static QueueHandle_t queue = NULL;
+
+// One timer per event id, created on first use
+static StaticTimer_t timer_buffers[APP_LOOP_MAX_EVENTS];
+static TimerHandle_t timers[APP_LOOP_MAX_EVENTS];
+
+static app_loop_handler_t loop_handler = NULL;
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+static void loop_task_fn(void *pvParameters)
+{
+    (void)pvParameters;
+    app_event_t event;
+
+    while (1) {
+        if (xQueueReceive(queue, &event, portMAX_DELAY) == pdPASS) {
+            loop_handler(&event);
+        }
+    }
+}
+
+/**
+ * @brief Timer callback (timer service task) - posts the event stored as ID
+ */
+static void timer_callback(TimerHandle_t timer)
+{
+    uint8_t id = (uint8_t)(uintptr_t)pvTimerGetTimerID(timer);
+    if (!app_loop_post(id, 0)) {
+        BLOG_W(TAG, "Queue full - timer event %u dropped", id);
+    }
+}
+
+static esp_err_t arm_timer(uint8_t id, uint32_t period_ms, bool periodic)
+{
+    if (id >= APP_LOOP_MAX_EVENTS || !queue) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    TickType_t period = pdMS_TO_TICKS(period_ms);
+    if (period == 0) {
+        period = 1;
+    }
+
+    if (!timers[id]) {
+        timers[id] = xTimerCreateStatic("app_evt", period, periodic ? pdTRUE : pdFALSE,
+                                        (void *)(uintptr_t)id, timer_callback, &timer_buffers[id]);
+        if (!timers[id]) {
+            return ESP_FAIL;
+        }
+    }
+    vTimerSetReloadMode(timers[id], periodic ? pdTRUE : pdFALSE);
+
+    // Changing the period also (re)starts the timer from now
+    return xTimerChangePeriod(timers[id], period, portMAX_DELAY) == pdPASS ? ESP_OK : ESP_FAIL;
+}
+
+// ============================================================================
+// PUBLIC FUNCTIONS
+// ============================================================================
+
+esp_err_t app_loop_start(const char *name, app_loop_handler_t handler)
+{
+    if (!handler) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (loop_task) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    queue = xQueueCreateStatic(APP_LOOP_QUEUE_LENGTH, sizeof(app_event_t), queue_storage, &queue_buffer);
+    if (!queue) {
+        return ESP_FAIL;
+    }
+    loop_handler = handler;
+
+    loop_task = xTaskCreateStatic(loop_task_fn, name, APP_LOOP_TASK_STACK, NULL,
+                                  APP_LOOP_TASK_PRIORITY, loop_stack, &loop_tcb);
+    if (!loop_task) {
+        BLOG_E(TAG, "Failed to create event loop task");
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+bool app_loop_post(uint8_t id, uint32_t arg)
+{
+    if (!queue) {
+        return false;
+    }
+    app_event_t event = {
+        .id = id,
+        .arg = arg,
+    };
+    return xQueueSend(queue, &event, 0) == pdPASS;
+}
+
+esp_err_t app_loop_post_after(uint8_t id, uint32_t delay_ms)
+{
+    return arm_timer(id, delay_ms, false);
+}
+
+esp_err_t app_loop_post_every(uint8_t id, uint32_t period_ms)
+{
+    return arm_timer(id, period_ms, true);
+}
+
+void app_loop_cancel(uint8_t id)
+{
+    if (id < APP_LOOP_MAX_EVENTS && timers[id]) {
+        xTimerStop(timers[id], portMAX_DELAY);
+    }
+}
+
+uint32_t app_loop_stack_unused(void)
+{
+    return loop_task ? (uint32_t)uxTaskGetStackHighWaterMark(loop_task) : 0;
+}
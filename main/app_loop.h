@@ -0,0 +1,81 @@
+/*
+ * Glyph C6 Monitor - Application Event Loop
+ *
+ * Version: 1.0.0
+ *
+ * One task runs all application-side work: sampling, reporting decisions
+ * and the end of a wake. It blocks on a message queue and only runs when
+ * an event is posted - by a software timer, a Zigbee callback or its own
+ * handler - so nothing polls and the CPU idles between events.
+ *
+ * Event ids belong to the application (below APP_LOOP_MAX_EVENTS). Each
+ * id has one software timer for delayed or periodic posting; re-arming
+ * an id replaces its pending deadline. The task stack, queue storage and
+ * timers are static, so their RAM shows up in the image size report.
+ */
+
+#ifndef APP_LOOP_H
+#define APP_LOOP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#define APP_LOOP_MAX_EVENTS     16
+
+typedef struct {
+    uint8_t id;                   // Application event id
+    uint32_t arg;                 // Event argument (0 for timer posts)
+} app_event_t;
+
+typedef void (*app_loop_handler_t)(const app_event_t *event);
+
+/**
+ * @brief Create the queue and start the event loop task
+ *
+ * Post the first event right after; the task runs until the device
+ * sleeps or restarts.
+ *
+ * @param name Task name
+ * @param handler Called in the loop task for every event
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if already started
+ */
+esp_err_t app_loop_start(const char *name, app_loop_handler_t handler);
+
+/**
+ * @brief Post an event (any task or timer callback, never blocks)
+ * @param id Event id
+ * @param arg Event argument
+ * @return true if queued, false if the queue is full
+ */
+bool app_loop_post(uint8_t id, uint32_t arg);
+
+/**
+ * @brief Post an event once after a delay
+ * @param id Event id (replaces a pending delayed post of the same id)
+ * @param delay_ms Delay in milliseconds
+ * @return ESP_OK on success
+ */
+esp_err_t app_loop_post_after(uint8_t id, uint32_t delay_ms);
+
+/**
+ * @brief Post an event periodically, first after one period
+ * @param id Event id (restarts a running period of the same id)
+ * @param period_ms Period in milliseconds
+ * @return ESP_OK on success
+ */
+esp_err_t app_loop_post_every(uint8_t id, uint32_t period_ms);
+
+/**
+ * @brief Cancel a delayed or periodic post (already queued events stay)
+ * @param id Event id
+ */
+void app_loop_cancel(uint8_t id);
+
+/**
+ * @brief Smallest amount of loop task stack left unused so far
+ * @return Bytes never used (0 before the task started)
+ */
+uint32_t app_loop_stack_unused(void);
+
+#endif // APP_LOOP_H
@@ -9,7 +9,11 @@
 
 #include "battery_monitoring.h"
 #include "system_config.h"
-#include "esp_log.h"
+#include "sensor_convert.h"
+// Per-read driver chatter is stripped from the wake path at compile time
+#define BINLOG_LEVEL BINLOG_LEVEL_WARN
+#include "binlog.h"
+#include "field_trace.h"
 #include "esp_adc/adc_oneshot.h"
 #include "esp_adc/adc_cali.h"
 #include "esp_adc/adc_cali_scheme.h"
@@ -31,44 +35,6 @@ static adc_cali_handle_t adc_cali_handle = NULL;
 // PRIVATE FUNCTIONS
 // ============================================================================
 
-/**
- * @brief Convert LiPo voltage to percentage using discharge curve
- * Based on typical LiPo discharge characteristics
- */
-static float voltage_to_percentage(float voltage)
-{
-    // USB power detection: If voltage > 4.3V, USB is connected
-    // In this case, we can't accurately measure battery percentage
-    // Return 100% to indicate "powered/charging"
-    if (voltage > 4.3f) {
-        return 100.0f;  // USB connected - report as fully powered
-    }
-    
-    // LiPo discharge curve (simplified) - only valid when on battery
-    // 4.2V = 100%, 3.7V = 50%, 3.0V = 0%
-    
-    if (voltage >= BATT_VOLTAGE_MAX) {
-        return 100.0f;
-    } else if (voltage <= BATT_VOLTAGE_MIN) {
-        return 0.0f;
-    }
-    
-    // Piecewise linear approximation of LiPo curve
-    if (voltage > 3.9f) {
-        // 3.9V-4.2V: 80-100% (steep region)
-        return 80.0f + ((voltage - 3.9f) / 0.3f) * 20.0f;
-    } else if (voltage > 3.7f) {
-        // 3.7V-3.9V: 50-80% (linear region)
-        return 50.0f + ((voltage - 3.7f) / 0.2f) * 30.0f;
-    } else if (voltage > 3.4f) {
-        // 3.4V-3.7V: 20-50% (linear region)
-        return 20.0f + ((voltage - 3.4f) / 0.3f) * 30.0f;
-    } else {
-        // 3.0V-3.4V: 0-20% (steep discharge)
-        return ((voltage - BATT_VOLTAGE_MIN) / 0.4f) * 20.0f;
-    }
-}
-
 /**
  * @brief Read battery voltage from ADC
  * Averages multiple samples for stability
@@ -85,7 +51,9 @@ static esp_err_t read_battery_voltage(float *voltage)
     // Take multiple samples and average
     for (int i = 0; i < BATTERY_SAMPLES_AVG; i++) {
         int adc_raw;
+        uint32_t start = field_trace_start();
         esp_err_t ret = adc_oneshot_read(adc_handle, BATT_MSR_ADC_CHANNEL, &adc_raw);
+        field_trace_adc(BATT_MSR_ADC_CHANNEL, adc_raw, ret, start);
         
         if (ret == ESP_OK) {
             int adc_mv;
@@ -107,11 +75,11 @@ static esp_err_t read_battery_voltage(float *voltage)
     
     // Calculate average and convert to battery voltage
     int avg_mv = total_mv / valid_samples;
-    *voltage = BATT_ADC_TO_VOLTAGE(avg_mv);
+    *voltage = sensor_convert_battery_voltage(avg_mv);
     
     // Debug output
-    ESP_LOGI(TAG, "ADC Debug: raw_avg=%d mV, after_divider=%.2fV (divider=%.2f)", 
-             avg_mv, *voltage, BATT_VOLTAGE_DIVIDER);
+    BLOG_D(TAG, "ADC Debug: raw_avg=%d mV, after_divider=%d mV",
+             avg_mv, (int)(*voltage * 1000.0f));
     
     return ESP_OK;
 }
@@ -122,7 +90,7 @@ static esp_err_t read_battery_voltage(float *voltage)
 
 esp_err_t battery_monitoring_init(void)
 {
-    ESP_LOGI(TAG, "Initializing battery monitoring (GPIO0/A0, ADC1_CH0)...");
+    BLOG_I(TAG, "Initializing battery monitoring (GPIO0/A0, ADC1_CH0)...");
     
     // Configure ADC
     adc_oneshot_unit_init_cfg_t adc_config = {
@@ -131,7 +99,7 @@ esp_err_t battery_monitoring_init(void)
     
     esp_err_t ret = adc_oneshot_new_unit(&adc_config, &adc_handle);
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to initialize ADC unit: %s", esp_err_to_name(ret));
+        BLOG_E(TAG, "Failed to initialize ADC unit: %s", esp_err_to_name(ret));
         return ret;
     }
     
@@ -143,7 +111,7 @@ esp_err_t battery_monitoring_init(void)
     
     ret = adc_oneshot_config_channel(adc_handle, BATT_MSR_ADC_CHANNEL, &chan_config);
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to configure ADC channel: %s", esp_err_to_name(ret));
+        BLOG_E(TAG, "Failed to configure ADC channel: %s", esp_err_to_name(ret));
         return ret;
     }
     
@@ -156,13 +124,13 @@ esp_err_t battery_monitoring_init(void)
     
     ret = adc_cali_create_scheme_curve_fitting(&cali_config, &adc_cali_handle);
     if (ret == ESP_OK) {
-        ESP_LOGI(TAG, "ADC calibration initialized");
+        BLOG_I(TAG, "ADC calibration initialized");
     } else {
-        ESP_LOGW(TAG, "ADC calibration not available, using raw values");
+        BLOG_W(TAG, "ADC calibration not available, using raw values");
         adc_cali_handle = NULL;
     }
     
-    ESP_LOGI(TAG, "Battery monitoring hardware initialized successfully");
+    BLOG_I(TAG, "Battery monitoring hardware initialized successfully");
     return ESP_OK;
 }
 
@@ -179,7 +147,7 @@ esp_err_t battery_read(float *voltage, float *percentage)
     }
     
     // Convert to percentage
-    *percentage = voltage_to_percentage(*voltage);
+    *percentage = sensor_convert_battery_percent(*voltage);
     
     return ESP_OK;
 }
@@ -194,6 +162,6 @@ bool battery_is_usb_present(void)
         return false;  // Unknown state
     }
     
-    // USB present if voltage > 4.3V (USB power is ~4.7V, battery max is 4.2V)
-    return (voltage > 4.3f);
+    // USB power is ~4.7V, battery max is 4.2V
+    return (voltage > BATT_USB_DETECT_VOLTAGE);
 }
@@ -0,0 +1,169 @@
+/*
+ * Glyph C6 Monitor - Deferred Binary Logging
+ *
+ * Version: 1.0.0
+ */
+
+#include "binlog.h"
+#include "esp_attr.h"
+#include "esp_app_desc.h"
+#include "freertos/FreeRTOS.h"
+#include <stdio.h>
+
+#if CONFIG_ESP_CONSOLE_USB_SERIAL_JTAG || CONFIG_ESP_CONSOLE_SECONDARY_USB_SERIAL_JTAG
+#include "driver/usb_serial_jtag.h"
+#endif
+
+// ============================================================================
+// RING FORMAT
+// ============================================================================
+
+// Record (32-bit words): format address, tag address,
+// meta = level << 28 | nargs << 24 | timestamp_ms & 0xFFFFFF, then nargs args
+#define BINLOG_RECORD_HEADER_WORDS   3
+#define BINLOG_RING_MAGIC            0x474C4F42   // "BLOG"
+
+typedef struct {
+    uint32_t magic;
+    uint16_t head;                // Next word to write
+    uint16_t tail;                // Oldest record
+    uint32_t dropped;             // Records overwritten before a dump
+    uint32_t words[BINLOG_RING_WORDS];
+} binlog_ring_t;
+
+// Survives deep sleep (not reset on wake), validated by magic
+static RTC_NOINIT_ATTR binlog_ring_t rtc_ring;
+
+static portMUX_TYPE ring_lock = portMUX_INITIALIZER_UNLOCKED;
+static bool live = false;
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+static uint16_t ring_used(void)
+{
+    return (uint16_t)((rtc_ring.head + BINLOG_RING_WORDS - rtc_ring.tail) % BINLOG_RING_WORDS);
+}
+
+static uint32_t ring_word(uint16_t index)
+{
+    return rtc_ring.words[index % BINLOG_RING_WORDS];
+}
+
+static uint16_t record_words_at(uint16_t index)
+{
+    uint32_t meta = ring_word((uint16_t)(index + 2));
+    return (uint16_t)(BINLOG_RECORD_HEADER_WORDS + ((meta >> 24) & 0x0F));
+}
+
+// ============================================================================
+// PUBLIC FUNCTIONS
+// ============================================================================
+
+void binlog_init(void)
+{
+    if (rtc_ring.magic != BINLOG_RING_MAGIC ||
+        rtc_ring.head >= BINLOG_RING_WORDS || rtc_ring.tail >= BINLOG_RING_WORDS) {
+        memset(&rtc_ring, 0, sizeof(rtc_ring));
+        rtc_ring.magic = BINLOG_RING_MAGIC;
+    }
+}
+
+void binlog_write(uint8_t level, const char *tag, const char *format, const uint32_t *args, uint8_t nargs)
+{
+    if (nargs > BINLOG_MAX_ARGS) {
+        nargs = BINLOG_MAX_ARGS;
+    }
+    uint16_t n = BINLOG_RECORD_HEADER_WORDS + nargs;
+    uint32_t meta = ((uint32_t)(level & 0x0F) << 28) | ((uint32_t)nargs << 24) |
+                    (esp_log_timestamp() & 0x00FFFFFF);
+
+    portENTER_CRITICAL(&ring_lock);
+
+    // Make room: overwrite oldest records (one slot stays empty)
+    while (BINLOG_RING_WORDS - 1 - ring_used() < n) {
+        rtc_ring.tail = (uint16_t)((rtc_ring.tail + record_words_at(rtc_ring.tail)) % BINLOG_RING_WORDS);
+        rtc_ring.dropped++;
+    }
+
+    uint16_t h = rtc_ring.head;
+    rtc_ring.words[h] = (uint32_t)(uintptr_t)format;
+    rtc_ring.words[(h + 1) % BINLOG_RING_WORDS] = (uint32_t)(uintptr_t)tag;
+    rtc_ring.words[(h + 2) % BINLOG_RING_WORDS] = meta;
+    for (uint8_t i = 0; i < nargs; i++) {
+        rtc_ring.words[(h + BINLOG_RECORD_HEADER_WORDS + i) % BINLOG_RING_WORDS] = args[i];
+    }
+    rtc_ring.head = (uint16_t)((h + n) % BINLOG_RING_WORDS);
+
+    portEXIT_CRITICAL(&ring_lock);
+}
+
+void binlog_set_live(bool enable)
+{
+    if (enable && !live) {
+        binlog_dump();
+    }
+    live = enable;
+}
+
+bool binlog_is_live(void)
+{
+    return live;
+}
+
+bool binlog_console_attached(void)
+{
+#if CONFIG_ESP_CONSOLE_USB_SERIAL_JTAG || CONFIG_ESP_CONSOLE_SECONDARY_USB_SERIAL_JTAG
+    return usb_serial_jtag_is_connected();
+#else
+    return BINLOG_UART_CONSOLE_ATTACHED;
+#endif
+}
+
+void binlog_dump(void)
+{
+    char elf_sha[9];
+    esp_app_get_elf_sha256(elf_sha, sizeof(elf_sha));
+    printf("BLOG_ELF %s\n", elf_sha);
+
+    // Records are copied out under the lock, printed outside it
+    while (1) {
+        uint32_t record[BINLOG_RECORD_HEADER_WORDS + BINLOG_MAX_ARGS];
+        uint16_t n = 0;
+
+        portENTER_CRITICAL(&ring_lock);
+        if (rtc_ring.tail != rtc_ring.head) {
+            n = record_words_at(rtc_ring.tail);
+            for (uint16_t i = 0; i < n; i++) {
+                record[i] = ring_word((uint16_t)(rtc_ring.tail + i));
+            }
+            rtc_ring.tail = (uint16_t)((rtc_ring.tail + n) % BINLOG_RING_WORDS);
+        }
+        portEXIT_CRITICAL(&ring_lock);
+
+        if (n == 0) {
+            break;
+        }
+        printf("BLOG");
+        for (uint16_t i = 0; i < n; i++) {
+            printf(" %08lx", (unsigned long)record[i]);
+        }
+        printf("\n");
+    }
+
+    if (rtc_ring.dropped > 0) {
+        printf("BLOG_DROPPED %lu\n", (unsigned long)rtc_ring.dropped);
+        rtc_ring.dropped = 0;
+    }
+    fflush(stdout);
+}
+
+bool binlog_flush_if_attached(void)
+{
+    if (!binlog_console_attached()) {
+        return false;
+    }
+    binlog_dump();
+    return true;
+}
@@ -0,0 +1,162 @@
+/*
+ * Glyph C6 Monitor - Deferred Binary Logging
+ *
+ * Version: 1.0.0
+ *
+ * Drop-in replacement for ESP_LOGx on the wake path. A log call stores a
+ * compact binary record - format string address, tag address, level,
+ * timestamp and the raw 32-bit arguments - in an RTC ring instead of
+ * formatting text and pushing it through the UART. No printf work is
+ * done at the call site.
+ *
+ * The ring is dumped as hex lines ("BLOG ...") only when a console is
+ * attached (binlog_flush_if_attached) or on request (binlog_dump), and
+ * tools/binlog_decode.py renders the text back using the format strings
+ * in the application ELF. Live mode (binlog_set_live) forwards calls to
+ * ESP_LOGx unchanged for always-on builds.
+ *
+ * Compile-time stripping: each module may define BINLOG_LEVEL before
+ * including this header; calls above that level compile to nothing.
+ *
+ * Argument rules: integers, floats/doubles (stored as float) and string
+ * pointers. Strings must be constants in flash (decoded from the ELF);
+ * 64-bit integers are truncated to their low 32 bits. At most 8 args.
+ */
+
+#ifndef BINLOG_H
+#define BINLOG_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+#include "esp_log.h"
+#include "system_config.h"
+
+// Levels (same numbering as esp_log_level_t)
+#define BINLOG_LEVEL_NONE      0
+#define BINLOG_LEVEL_ERROR     1
+#define BINLOG_LEVEL_WARN      2
+#define BINLOG_LEVEL_INFO      3
+#define BINLOG_LEVEL_DEBUG     4
+
+// Per-module compile-time level (define before including this header)
+#ifndef BINLOG_LEVEL
+#define BINLOG_LEVEL           BINLOG_DEFAULT_LEVEL
+#endif
+
+#define BINLOG_MAX_ARGS        8
+
+// ============================================================================
+// ARGUMENT CAPTURE (internal)
+// ============================================================================
+
+static inline uint32_t binlog_arg_u32(uint32_t v) { return v; }
+static inline uint32_t binlog_arg_u64(uint64_t v) { return (uint32_t)v; }
+static inline uint32_t binlog_arg_ptr(const void *p) { return (uint32_t)(uintptr_t)p; }
+static inline uint32_t binlog_arg_float(double v)
+{
+    float f = (float)v;
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(bits));
+    return bits;
+}
+
+#define BINLOG_ARG(x) _Generic((x),                 \
+    float: binlog_arg_float,                        \
+    double: binlog_arg_float,                       \
+    char *: binlog_arg_ptr,                         \
+    const char *: binlog_arg_ptr,                   \
+    long long: binlog_arg_u64,                      \
+    unsigned long long: binlog_arg_u64,             \
+    default: binlog_arg_u32)(x)
+
+#define BINLOG_NARGS(...) BINLOG_NARGS_(0, ##__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define BINLOG_NARGS_(_0, _1, _2, _3, _4, _5, _6, _7, _8, N, ...) N
+
+#define BINLOG_A0()
+#define BINLOG_A1(a)      , BINLOG_ARG(a)
+#define BINLOG_A2(a, ...) , BINLOG_ARG(a) BINLOG_A1(__VA_ARGS__)
+#define BINLOG_A3(a, ...) , BINLOG_ARG(a) BINLOG_A2(__VA_ARGS__)
+#define BINLOG_A4(a, ...) , BINLOG_ARG(a) BINLOG_A3(__VA_ARGS__)
+#define BINLOG_A5(a, ...) , BINLOG_ARG(a) BINLOG_A4(__VA_ARGS__)
+#define BINLOG_A6(a, ...) , BINLOG_ARG(a) BINLOG_A5(__VA_ARGS__)
+#define BINLOG_A7(a, ...) , BINLOG_ARG(a) BINLOG_A6(__VA_ARGS__)
+#define BINLOG_A8(a, ...) , BINLOG_ARG(a) BINLOG_A7(__VA_ARGS__)
+#define BINLOG_CAT_(a, b) a##b
+#define BINLOG_CAT(a, b)  BINLOG_CAT_(a, b)
+#define BINLOG_ARGS(...)  BINLOG_CAT(BINLOG_A, BINLOG_NARGS(__VA_ARGS__))(__VA_ARGS__)
+
+#define BINLOG_EMIT(level, tag, format, ...) do {                                   \
+    if ((level) <= BINLOG_LEVEL) {                                                  \
+        if (binlog_is_live()) {                                                     \
+            ESP_LOG_LEVEL((esp_log_level_t)(level), tag, format, ##__VA_ARGS__);    \
+        } else {                                                                    \
+            const uint32_t binlog_args_[] = { 0 BINLOG_ARGS(__VA_ARGS__) };         \
+            binlog_write((level), (tag), (format), &binlog_args_[1],                \
+                         BINLOG_NARGS(__VA_ARGS__));                                \
+        }                                                                           \
+    }                                                                               \
+} while (0)
+
+// ============================================================================
+// LOGGING MACROS (same signature as ESP_LOGx)
+// ============================================================================
+
+#define BLOG_E(tag, format, ...) BINLOG_EMIT(BINLOG_LEVEL_ERROR, tag, format, ##__VA_ARGS__)
+#define BLOG_W(tag, format, ...) BINLOG_EMIT(BINLOG_LEVEL_WARN, tag, format, ##__VA_ARGS__)
+#define BLOG_I(tag, format, ...) BINLOG_EMIT(BINLOG_LEVEL_INFO, tag, format, ##__VA_ARGS__)
+#define BLOG_D(tag, format, ...) BINLOG_EMIT(BINLOG_LEVEL_DEBUG, tag, format, ##__VA_ARGS__)
+
+// ============================================================================
+// PUBLIC INTERFACE
+// ============================================================================
+
+/**
+ * @brief Initialize the ring (keeps records from previous wakes in RTC memory)
+ */
+void binlog_init(void);
+
+/**
+ * @brief Store one record (use the BLOG_x macros instead)
+ * @param level BINLOG_LEVEL_x
+ * @param tag Module tag (constant string)
+ * @param format Format string (constant string)
+ * @param args Raw 32-bit arguments
+ * @param nargs Number of arguments (<= BINLOG_MAX_ARGS)
+ */
+void binlog_write(uint8_t level, const char *tag, const char *format, const uint32_t *args, uint8_t nargs);
+
+/**
+ * @brief Forward log calls to ESP_LOGx immediately instead of recording
+ *
+ * Records already in the ring are dumped when live mode is enabled.
+ *
+ * @param live true = text logging, false = deferred binary logging
+ */
+void binlog_set_live(bool live);
+
+/**
+ * @brief Check if live (text) mode is enabled
+ * @return true if BLOG_x calls go straight to ESP_LOGx
+ */
+bool binlog_is_live(void);
+
+/**
+ * @brief Check if a host console is attached
+ * @return true if USB-Serial-JTAG is connected (UART: BINLOG_UART_CONSOLE_ATTACHED)
+ */
+bool binlog_console_attached(void);
+
+/**
+ * @brief Dump all records as hex lines and empty the ring
+ */
+void binlog_dump(void);
+
+/**
+ * @brief Dump records only if a console is attached
+ * @return true if the ring was dumped
+ */
+bool binlog_flush_if_attached(void);
+
+#endif // BINLOG_H
@@ -0,0 +1,187 @@
+/*
+ * Glyph C6 Monitor - Charge-State Estimator (solar-assisted nodes)
+ *
+ * Version: 1.0.0
+ */
+
+#include "charge_state.h"
+#include "system_config.h"
+#include "binlog.h"
+#include <string.h>
+
+static const char *TAG = "CHARGE";
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+static const charge_sample_t *newest(const charge_state_t *cs)
+{
+    return &cs->samples[(cs->next + CHARGE_STATE_SAMPLES - 1) % CHARGE_STATE_SAMPLES];
+}
+
+static void store_sample(charge_state_t *cs, uint16_t millivolts, uint32_t now_sec)
+{
+    cs->samples[cs->next].time_sec = now_sec;
+    cs->samples[cs->next].millivolts = millivolts;
+    cs->next = (uint8_t)((cs->next + 1) % CHARGE_STATE_SAMPLES);
+    if (cs->count < CHARGE_STATE_SAMPLES) {
+        cs->count++;
+    }
+}
+
+/**
+ * @brief Slope window: CHARGE_WINDOW_SEC, stretched to CHARGE_MIN_SAMPLES
+ *        samples at the current sample spacing (sparse dark or
+ *        ultra-low-power intervals)
+ */
+static uint32_t window_sec(const charge_state_t *cs)
+{
+    if (cs->count < 2) {
+        return CHARGE_WINDOW_SEC;
+    }
+    const charge_sample_t *last = newest(cs);
+    const charge_sample_t *prev = &cs->samples[(cs->next + CHARGE_STATE_SAMPLES - 2) % CHARGE_STATE_SAMPLES];
+    uint32_t spacing = last->time_sec - prev->time_sec;
+    // Half a spacing of slack for wake jitter
+    uint32_t needed = (CHARGE_MIN_SAMPLES - 1) * spacing + spacing / 2;
+    return needed > CHARGE_WINDOW_SEC ? needed : CHARGE_WINDOW_SEC;
+}
+
+/**
+ * @brief Oldest stored voltage within the slope window (start of a rise)
+ */
+static uint16_t window_start_mv(const charge_state_t *cs, uint32_t now_sec)
+{
+    uint32_t window = window_sec(cs);
+    for (uint8_t i = 0; i < cs->count; i++) {
+        const charge_sample_t *s = &cs->samples[(cs->next + CHARGE_STATE_SAMPLES - cs->count + i) % CHARGE_STATE_SAMPLES];
+        if (now_sec - s->time_sec <= window) {
+            return s->millivolts;
+        }
+    }
+    return newest(cs)->millivolts;
+}
+
+static void start_harvest(charge_state_t *cs, uint16_t millivolts, uint32_t now_sec)
+{
+    cs->phase = CHARGE_PHASE_HARVEST;
+    cs->harvest_seen = true;
+    cs->last_harvest_full = false;
+    cs->harvest_start_mv = window_start_mv(cs, now_sec);
+    cs->harvest_gain_mv = 0;
+    cs->harvest_start_sec = now_sec;
+    BLOG_I(TAG, "Harvest started: %u mV, %d mV/h", millivolts, cs->slope_mv_h);
+}
+
+static void end_harvest(charge_state_t *cs, uint32_t now_sec)
+{
+    cs->phase = CHARGE_PHASE_DARK;
+    cs->harvest_end_sec = now_sec;
+    cs->harvest_periods++;
+    cs->harvest_total_sec += now_sec - cs->harvest_start_sec;
+    BLOG_I(TAG, "Harvest ended after %" PRIu32 " min: +%u mV%s", (now_sec - cs->harvest_start_sec) / 60,
+           cs->harvest_gain_mv, cs->last_harvest_full ? ", reached float" : "");
+}
+
+// ============================================================================
+// PUBLIC FUNCTIONS
+// ============================================================================
+
+void charge_state_reset(charge_state_t *cs)
+{
+    memset(cs, 0, sizeof(*cs));
+}
+
+bool charge_state_slope(const charge_state_t *cs, uint32_t now_sec, int32_t *slope_mv_h)
+{
+    // Times relative to now keep the sums small
+    int64_t n = 0, st = 0, sv = 0, stt = 0, stv = 0;
+    uint32_t oldest = 0;
+    uint32_t window = window_sec(cs);
+    for (uint8_t i = 0; i < cs->count; i++) {
+        const charge_sample_t *s = &cs->samples[i];
+        uint32_t age = now_sec - s->time_sec;
+        if (age > window) {
+            continue;
+        }
+        int64_t t = -(int64_t)age;
+        n++;
+        st += t;
+        sv += s->millivolts;
+        stt += t * t;
+        stv += t * s->millivolts;
+        if (age > oldest) {
+            oldest = age;
+        }
+    }
+    if (n < CHARGE_MIN_SAMPLES || oldest - (now_sec - newest(cs)->time_sec) < CHARGE_MIN_SPAN_SEC) {
+        return false;
+    }
+    int64_t den = n * stt - st * st;
+    if (den == 0) {
+        return false;
+    }
+    *slope_mv_h = (int32_t)((n * stv - st * sv) * 3600 / den);
+    return true;
+}
+
+charge_phase_t charge_state_update(charge_state_t *cs, uint16_t millivolts, uint32_t now_sec)
+{
+    if (cs->count == 0 || now_sec - newest(cs)->time_sec >= CHARGE_SAMPLE_SPACING_SEC) {
+        store_sample(cs, millivolts, now_sec);
+
+        int32_t slope;
+        if (!charge_state_slope(cs, now_sec, &slope)) {
+            // No slope (yet): a dark phase still times out
+            if (cs->phase == CHARGE_PHASE_DARK && now_sec - cs->harvest_end_sec >= CHARGE_DAY_SEC) {
+                cs->phase = CHARGE_PHASE_BATTERY;
+            }
+            return cs->phase;
+        }
+        cs->slope_mv_h = (int16_t)(slope > INT16_MAX ? INT16_MAX : (slope < INT16_MIN ? INT16_MIN : slope));
+        if (slope < CHARGE_HARVEST_ENTER_MV_H) {
+            cs->rise_checks = 0;
+        } else if (cs->rise_checks < UINT8_MAX) {
+            cs->rise_checks++;
+        }
+    } else if (cs->phase == CHARGE_PHASE_UNKNOWN) {
+        return cs->phase;
+    }
+    bool at_float = millivolts >= CHARGE_FLOAT_MV;
+
+    if (cs->phase == CHARGE_PHASE_HARVEST) {
+        // Rising, or held full by the charger; a daylight period has an end
+        bool charging = cs->slope_mv_h >= CHARGE_HARVEST_EXIT_MV_H ||
+                        (at_float && cs->slope_mv_h > -CHARGE_FLOAT_SAG_MV_H);
+        if (charging && now_sec - cs->harvest_start_sec < CHARGE_HARVEST_MAX_SEC) {
+            if (millivolts > cs->harvest_start_mv &&
+                millivolts - cs->harvest_start_mv > cs->harvest_gain_mv) {
+                cs->harvest_gain_mv = millivolts - cs->harvest_start_mv;
+            }
+            cs->last_harvest_full = cs->last_harvest_full || at_float;
+            return cs->phase;
+        }
+        end_harvest(cs, now_sec);
+        cs->rise_checks = 0;
+    } else if (cs->rise_checks >= CHARGE_HARVEST_ENTER_CHECKS) {
+        start_harvest(cs, millivolts, now_sec);
+        cs->last_harvest_full = at_float;
+        return cs->phase;
+    }
+
+    // Between harvests; a day without one makes it a plain battery node again
+    bool recent = cs->harvest_seen && now_sec - cs->harvest_end_sec < CHARGE_DAY_SEC;
+    cs->phase = recent ? CHARGE_PHASE_DARK : CHARGE_PHASE_BATTERY;
+    return cs->phase;
+}
+
+const char *charge_state_phase_string(charge_phase_t phase)
+{
+    switch (phase) {
+        case CHARGE_PHASE_BATTERY: return "BAT";
+        case CHARGE_PHASE_HARVEST: return "SUN";
+        case CHARGE_PHASE_DARK:    return "DARK";
+        default:                   return "???";
+    }
+}
@@ -0,0 +1,103 @@
+/*
+ * Glyph C6 Monitor - Charge-State Estimator (solar-assisted nodes)
+ *
+ * Version: 1.0.0
+ *
+ * Follows the pack voltage across wakes and tells harvest periods from
+ * the rest. The board has no charger status line, so charger activity is
+ * read from the voltage itself:
+ *
+ * - A least-squares slope over the samples of the last
+ *   CHARGE_WINDOW_SEC (longer when samples are too sparse for
+ *   CHARGE_MIN_SAMPLES in it): a pack that rises by CHARGE_HARVEST_ENTER_MV_H or
+ *   more for CHARGE_HARVEST_ENTER_CHECKS samples in a row is being
+ *   charged (charge current plus the charger's IR lift)
+ * - Once harvesting, a pack held at CHARGE_FLOAT_MV or above is full with
+ *   the charger still supplying it (surplus): the period continues until
+ *   the voltage falls faster than CHARGE_FLOAT_SAG_MV_H, for at most
+ *   CHARGE_HARVEST_MAX_SEC
+ *
+ * Phases:
+ * - BATTERY: no harvest seen for CHARGE_DAY_SEC (or ever) - plain battery
+ * - HARVEST: charging now
+ * - DARK: between harvest periods of a solar node (night, heavy cloud)
+ *
+ * Voltages in mV, slopes in mV/h, times in RTC seconds. A zero-initialized
+ * state is a valid reset state, so it can live in RTC memory across deep
+ * sleep.
+ */
+
+#ifndef CHARGE_STATE_H
+#define CHARGE_STATE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define CHARGE_STATE_SAMPLES    6         // Ring of spaced voltage samples
+
+typedef enum {
+    CHARGE_PHASE_UNKNOWN = 0,     // Not enough samples yet
+    CHARGE_PHASE_BATTERY,
+    CHARGE_PHASE_HARVEST,
+    CHARGE_PHASE_DARK,
+} charge_phase_t;
+
+typedef struct {
+    uint32_t time_sec;
+    uint16_t millivolts;
+} charge_sample_t;
+
+// Estimator state
+typedef struct {
+    charge_sample_t samples[CHARGE_STATE_SAMPLES];
+    uint8_t count;                // Valid samples
+    uint8_t next;                 // Ring write index
+    charge_phase_t phase;
+    int16_t slope_mv_h;           // Last slope (0 while unknown)
+    uint8_t rise_checks;          // Consecutive stored samples with a harvest slope
+    bool harvest_seen;            // At least one harvest period since reset
+    bool last_harvest_full;       // Last harvest period reached float voltage
+    uint16_t harvest_start_mv;    // Pack voltage when the current/last harvest began
+    uint16_t harvest_gain_mv;     // Rise during the current/last harvest period
+    uint32_t harvest_start_sec;
+    uint32_t harvest_end_sec;     // End of the last finished harvest period
+    uint16_t harvest_periods;     // Since reset
+    uint32_t harvest_total_sec;   // Finished harvest periods, since reset
+} charge_state_t;
+
+/**
+ * @brief Reset the estimator (e.g. after a period on external power)
+ * @param cs State to reset
+ */
+void charge_state_reset(charge_state_t *cs);
+
+/**
+ * @brief Feed one pack voltage reading and classify the phase
+ *
+ * Readings closer than CHARGE_SAMPLE_SPACING_SEC to the previous stored
+ * sample only update the float check, so the sampling rate does not
+ * change the slope's noise.
+ *
+ * @param cs Estimator state
+ * @param millivolts Pack voltage
+ * @param now_sec RTC time
+ * @return Phase after this reading
+ */
+charge_phase_t charge_state_update(charge_state_t *cs, uint16_t millivolts, uint32_t now_sec);
+
+/**
+ * @brief Least-squares slope over the stored samples within the window
+ *        (CHARGE_WINDOW_SEC, or CHARGE_MIN_SAMPLES at the current spacing)
+ * @param cs Estimator state
+ * @param now_sec RTC time
+ * @param slope_mv_h Output: slope in mV/h
+ * @return false with fewer than CHARGE_MIN_SAMPLES spanning CHARGE_MIN_SPAN_SEC
+ */
+bool charge_state_slope(const charge_state_t *cs, uint32_t now_sec, int32_t *slope_mv_h);
+
+/**
+ * @brief Short phase name for logging ("BAT", "SUN", "DARK", "???")
+ */
+const char *charge_state_phase_string(charge_phase_t phase);
+
+#endif // CHARGE_STATE_H
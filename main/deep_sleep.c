@@ -5,13 +5,15 @@
  */
 
 #include "deep_sleep.h"
-#include "esp_log.h"
+#include "system_config.h"
+#include "binlog.h"
+#include "field_trace.h"
 #include "esp_sleep.h"
-#include "esp_timer.h"
 #include "esp_attr.h"
 #include "esp_system.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include <sys/time.h>
 
 static const char *TAG = "DEEP_SLEEP";
 
@@ -24,6 +26,8 @@ static RTC_DATA_ATTR deep_sleep_state_t rtc_state = {
     .boot_count = 0,
     .sensor_read_count = 0,
     .last_read_time = 0,
+    .sleep_interval_sec = POWER_FRUGAL_SAMPLE_INTERVAL_SEC,
+    .max_sleep_sec = 0,
     .first_boot = true,
 };
 
@@ -32,7 +36,21 @@ static RTC_DATA_ATTR deep_sleep_state_t rtc_state = {
 // ============================================================================
 
 static bool initialized = false;
-static uint64_t wake_time_us = 0;  // Time when device woke up (microseconds)
+static uint64_t wake_time_us = 0;  // Time when device woke up (microseconds, RTC clock)
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+/**
+ * @brief RTC-backed time in microseconds (keeps counting through deep sleep)
+ */
+static uint64_t get_rtc_time_us(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (uint64_t)tv.tv_sec * 1000000ULL + (uint64_t)tv.tv_usec;
+}
 
 // ============================================================================
 // PUBLIC FUNCTIONS
@@ -40,12 +58,10 @@ static uint64_t wake_time_us = 0;  // Time when device woke up (microseconds)
 
 esp_err_t deep_sleep_init(void)
 {
-    ESP_LOGI(TAG, "===========================================");
-    ESP_LOGI(TAG, "  Deep Sleep Manager - Ultra Power Saving");
-    ESP_LOGI(TAG, "===========================================");
+    BLOG_I(TAG, "Deep Sleep Manager - Ultra Power Saving");
     
-    // Get wake time
-    wake_time_us = esp_timer_get_time();
+    // Get wake time (RTC clock - comparable with timestamps from previous wakes)
+    wake_time_us = get_rtc_time_us();
     
     // Increment boot count
     rtc_state.boot_count++;
@@ -55,18 +71,18 @@ esp_err_t deep_sleep_init(void)
     
     switch (wake_cause) {
     case ESP_SLEEP_WAKEUP_TIMER:
-        ESP_LOGI(TAG, "Wake from timer (boot #%lu)", rtc_state.boot_count);
+        BLOG_I(TAG, "Wake from timer (boot #%" PRIu32 ")", rtc_state.boot_count);
         rtc_state.first_boot = false;
         break;
         
     case ESP_SLEEP_WAKEUP_UNDEFINED:
     default:
         if (rtc_state.boot_count == 1) {
-            ESP_LOGI(TAG, "First boot after power-on");
+            BLOG_I(TAG, "First boot after power-on");
             rtc_state.first_boot = true;
             rtc_state.last_read_time = 0;
         } else {
-            ESP_LOGI(TAG, "Wake from reset or other cause");
+            BLOG_I(TAG, "Wake from reset or other cause");
         }
         break;
     }
@@ -95,38 +111,63 @@ bool deep_sleep_should_read_sensors(void)
     
     // Always read on first boot
     if (rtc_state.first_boot) {
-        ESP_LOGI(TAG, "First boot - sensors will be read");
+        BLOG_I(TAG, "First boot - sensors will be read");
         return true;
     }
     
     // Calculate time since last reading
     uint64_t time_since_read_us = wake_time_us - rtc_state.last_read_time;
-    uint64_t read_interval_us = (uint64_t)SLEEP_INTERVAL_SEC * 1000000ULL;
+    uint64_t read_interval_us = (uint64_t)rtc_state.sleep_interval_sec * 1000000ULL;
     
     // Read if interval has elapsed
     bool should_read = time_since_read_us >= read_interval_us;
     
-    ESP_LOGI(TAG, "Sensor check: %lld us since last read, interval: %lld us -> %s",
-             time_since_read_us, read_interval_us, should_read ? "READ" : "SKIP");
+    BLOG_I(TAG, "Sensor check: %" PRIu32 " s since last read, interval: %" PRIu32 " s -> %s",
+           (uint32_t)(time_since_read_us / 1000000ULL), rtc_state.sleep_interval_sec,
+           should_read ? "READ" : "SKIP");
     
     return should_read;
 }
 
 void deep_sleep_mark_sensors_read(void)
 {
-    rtc_state.last_read_time = wake_time_us;
+    rtc_state.last_read_time = get_rtc_time_us();
     rtc_state.sensor_read_count++;
-    ESP_LOGI(TAG, "Sensors reading marked (total: %lu)", rtc_state.sensor_read_count);
+    BLOG_I(TAG, "Sensors reading marked (total: %" PRIu32 ")", rtc_state.sensor_read_count);
+}
+
+void deep_sleep_set_interval(uint32_t interval_sec)
+{
+    if (interval_sec != rtc_state.sleep_interval_sec) {
+        BLOG_I(TAG, "Sleep interval: %" PRIu32 " -> %" PRIu32 " seconds", rtc_state.sleep_interval_sec, interval_sec);
+        rtc_state.sleep_interval_sec = interval_sec;
+    }
+}
+
+void deep_sleep_set_max_sleep(uint32_t max_sleep_sec)
+{
+    rtc_state.max_sleep_sec = max_sleep_sec;
+}
+
+uint32_t deep_sleep_get_time_sec(void)
+{
+    // gettimeofday() is driven by the RTC timer and survives deep sleep
+    return (uint32_t)(get_rtc_time_us() / 1000000ULL);
+}
+
+uint32_t deep_sleep_get_time_ms(void)
+{
+    return (uint32_t)(get_rtc_time_us() / 1000ULL);
 }
 
 uint32_t deep_sleep_time_until_next_reading(void)
 {
     if (!initialized) {
-        return SLEEP_INTERVAL_SEC;
+        return rtc_state.sleep_interval_sec;
     }
     
-    uint64_t time_since_read_us = wake_time_us - rtc_state.last_read_time;
-    uint64_t read_interval_us = (uint64_t)SLEEP_INTERVAL_SEC * 1000000ULL;
+    uint64_t time_since_read_us = get_rtc_time_us() - rtc_state.last_read_time;
+    uint64_t read_interval_us = (uint64_t)rtc_state.sleep_interval_sec * 1000000ULL;
     
     if (time_since_read_us >= read_interval_us) {
         return 0;  // Reading is due now
@@ -138,43 +179,46 @@ uint32_t deep_sleep_time_until_next_reading(void)
 
 void deep_sleep_print_stats(void)
 {
-    ESP_LOGI(TAG, "");
-    ESP_LOGI(TAG, "Deep Sleep Statistics:");
-    ESP_LOGI(TAG, "  Boot count:         %lu", rtc_state.boot_count);
-    ESP_LOGI(TAG, "  Sensor readings:    %lu", rtc_state.sensor_read_count);
-    ESP_LOGI(TAG, "  First boot:         %s", rtc_state.first_boot ? "YES" : "NO");
-    ESP_LOGI(TAG, "  Read interval:      %d seconds (1 hour)", SLEEP_INTERVAL_SEC);
+    BLOG_I(TAG, "Deep Sleep Statistics:");
+    BLOG_I(TAG, "  Boot count:         %" PRIu32, rtc_state.boot_count);
+    BLOG_I(TAG, "  Sensor readings:    %" PRIu32, rtc_state.sensor_read_count);
+    BLOG_I(TAG, "  First boot:         %s", rtc_state.first_boot ? "YES" : "NO");
+    BLOG_I(TAG, "  Read interval:      %" PRIu32 " seconds", rtc_state.sleep_interval_sec);
     
     if (!rtc_state.first_boot) {
         uint32_t next_read_sec = deep_sleep_time_until_next_reading();
-        ESP_LOGI(TAG, "  Next reading:       %lu seconds (%.1f hours)", 
-                 next_read_sec, next_read_sec / 3600.0f);
+        BLOG_I(TAG, "  Next reading:       %" PRIu32 " seconds (%" PRIu32 " min)", 
+                 next_read_sec, next_read_sec / 60);
     }
-    ESP_LOGI(TAG, "");
 }
 
 esp_err_t deep_sleep_enter(void)
 {
     if (!initialized) {
-        ESP_LOGE(TAG, "Deep sleep not initialized!");
+        BLOG_E(TAG, "Deep sleep not initialized!");
         return ESP_ERR_INVALID_STATE;
     }
     
-    ESP_LOGI(TAG, "===========================================");
-    ESP_LOGI(TAG, "  Preparing for Deep Sleep");
-    ESP_LOGI(TAG, "===========================================");
+    BLOG_I(TAG, "Preparing for Deep Sleep");
     
-    // Calculate next wake time (simple: always 1 hour)
-    uint32_t sleep_duration_sec = SLEEP_INTERVAL_SEC;
+    // Calculate next wake time: next reading (interval chosen by the active
+    // power profile), capped for short sense wakes
+    uint32_t sleep_duration_sec = deep_sleep_time_until_next_reading();
+    if (sleep_duration_sec == 0) {
+        // Reading still due (failed this cycle) - retry after a full interval
+        sleep_duration_sec = rtc_state.sleep_interval_sec;
+    }
+    if (rtc_state.max_sleep_sec > 0 && sleep_duration_sec > rtc_state.max_sleep_sec) {
+        sleep_duration_sec = rtc_state.max_sleep_sec;
+    }
     
     // Minimum sleep time is 10 seconds (avoid rapid wake/sleep cycles during testing)
     if (sleep_duration_sec < 10) {
         sleep_duration_sec = 10;
     }
     
-    ESP_LOGI(TAG, "Sleep duration: %lu seconds (%.1f hours)", 
-             sleep_duration_sec, sleep_duration_sec / 3600.0f);
-    ESP_LOGI(TAG, "Next wake: Soil + Battery readings together");
+    BLOG_I(TAG, "Sleep duration: %" PRIu32 " seconds (%" PRIu32 " min)", 
+             sleep_duration_sec, sleep_duration_sec / 60);
     
     // Clear first boot flag
     rtc_state.first_boot = false;
@@ -183,12 +227,16 @@ esp_err_t deep_sleep_enter(void)
     uint64_t sleep_duration_us = (uint64_t)sleep_duration_sec * 1000000ULL;
     esp_sleep_enable_timer_wakeup(sleep_duration_us);
     
-    ESP_LOGI(TAG, "");
-    ESP_LOGI(TAG, "💤 Entering deep sleep... See you in %.1f hours!", sleep_duration_sec / 3600.0f);
-    ESP_LOGI(TAG, "===========================================");
+    BLOG_I(TAG, "Entering deep sleep... See you in %" PRIu32 " min!", sleep_duration_sec / 60);
+    
+    // Field trace: end of this wake (spilled to flash every few wakes)
+    field_trace_sleep(sleep_duration_sec);
+    field_trace_flush_if_attached();
     
-    // Small delay to ensure log is flushed
-    vTaskDelay(pdMS_TO_TICKS(100));
+    // Deferred log records stay in RTC memory unless a console is listening
+    if (binlog_flush_if_attached()) {
+        vTaskDelay(pdMS_TO_TICKS(100));  // Let the console drain
+    }
     
     // Enter deep sleep (device will reset on wake)
     esp_deep_sleep_start();
@@ -6,10 +6,7 @@
  * Manages deep sleep cycles for extreme battery preservation.
  * Uses ESP32-C6 deep sleep with Zigbee Sleepy End Device mode.
  * 
- * Battery Life Estimate:
- * - With 1000mAh battery: 10-16 months
- * - Deep sleep current: ~10µA
- * - Wake/read/transmit: ~50mA for 1 minute per hour
+ * Battery life per power profile: host/bench/energy_bench (simulated).
  */
 
 #ifndef DEEP_SLEEP_H
@@ -23,27 +20,16 @@
 // DEEP SLEEP CONFIGURATION
 // ============================================================================
 
-// Sleep intervals (in seconds)
-// Both soil and battery read at the same time for efficiency
-#define SLEEP_INTERVAL_SEC           3600     // 1 hour between readings (soil + battery)
-
-// Wake behavior
-#define WAKE_TIME_MS                 60000    // Stay awake for 1 minute to read/transmit
-#define ZIGBEE_POLL_TIME_MS          5000     // Poll Zigbee for 5 seconds after wake
-
-// Sensor averaging
-#define NUM_SENSOR_SAMPLES           5        // Take 5 samples and average
-#define SAMPLE_INTERVAL_MS           5000     // 5 seconds between samples (25s total)
-
-// OTA behavior
-#define OTA_CHECK_ENABLED            1        // Check for OTA on wake
-#define OTA_DOWNLOAD_TIMEOUT_MS      300000   // 5 minutes max for OTA download
+// Sleep interval, sample averaging and OTA budget come from the Kconfig
+// performance profile via system_config.h (POWER_FRUGAL_*, OTA_*)
 
 // Boot count tracking (in RTC memory - persists across deep sleep)
 typedef struct {
     uint32_t boot_count;              // Total number of boots
     uint32_t sensor_read_count;       // Number of sensor readings (soil + battery)
-    uint64_t last_read_time;          // Last reading timestamp (us since boot)
+    uint64_t last_read_time;          // Last reading timestamp (us, RTC clock)
+    uint32_t sleep_interval_sec;      // Active sleep interval (set by power policy)
+    uint32_t max_sleep_sec;           // Cap on a single sleep (0 = none), for sense wakes
     bool first_boot;                  // First boot after power-on
 } deep_sleep_state_t;
 
@@ -80,14 +66,51 @@ void deep_sleep_mark_sensors_read(void);
 /**
  * @brief Enter deep sleep mode
  * 
- * This function calculates the next wake time based on pending tasks,
- * prepares the Zigbee stack for sleep, and enters deep sleep.
+ * This function calculates the next wake time (time until the next
+ * reading, capped by deep_sleep_set_max_sleep) and enters deep sleep.
  * Device will wake up after the calculated interval.
  * 
  * @return ESP_OK if sleep was successful (never returns), error otherwise
  */
 esp_err_t deep_sleep_enter(void);
 
+/**
+ * @brief Set the sleep/read interval used by the next deep sleep
+ * @param interval_sec Interval in seconds (stored in RTC memory)
+ */
+void deep_sleep_set_interval(uint32_t interval_sec);
+
+/**
+ * @brief Cap the duration of a single deep sleep
+ * 
+ * Lets the device wake more often than the reading interval for short,
+ * radio-free sense wakes (e.g. watering detection) without moving the
+ * reading schedule. Stored in RTC memory.
+ * 
+ * @param max_sleep_sec Maximum sleep in seconds (0 = sleep until next reading)
+ */
+void deep_sleep_set_max_sleep(uint32_t max_sleep_sec);
+
+/**
+ * @brief Get RTC-backed time in seconds
+ * 
+ * Unlike esp_timer, this clock keeps counting through deep sleep,
+ * so it can be used to compare timestamps across wake cycles.
+ * 
+ * @return Seconds on the RTC clock
+ */
+uint32_t deep_sleep_get_time_sec(void);
+
+/**
+ * @brief Get RTC-backed time in milliseconds
+ * 
+ * Same clock as deep_sleep_get_time_sec(); wraps after ~49 days, so
+ * compare timestamps by unsigned difference.
+ * 
+ * @return Milliseconds on the RTC clock
+ */
+uint32_t deep_sleep_get_time_ms(void);
+
 /**
  * @brief Get time until next sensor readings (seconds)
  * @return Seconds until next readings (soil + battery)
@@ -0,0 +1,473 @@
+/*
+ * Glyph C6 Monitor - Field Trace Recorder
+ *
+ * Version: 1.0.0
+ */
+
+#include "field_trace.h"
+
+#if FIELD_TRACE_ENABLED
+
+#include "deep_sleep.h"
+#include "binlog.h"
+#include "esp_attr.h"
+#include "esp_timer.h"
+#include "esp_sleep.h"
+#include "esp_partition.h"
+#include "freertos/FreeRTOS.h"
+#include <stdio.h>
+#include <string.h>
+
+static const char *TAG = "FIELD_TRACE";
+
+// ============================================================================
+// FLASH LAYOUT
+// ============================================================================
+
+#define TRACE_PAGE_SIZE          4096                  // One flash sector
+#define TRACE_MAX_PAGES          64                    // Pages used at most (256 KB)
+#define TRACE_PAGE_MAGIC         0x31525446            // "FTR1"
+#define TRACE_TYPE_ERASED        0xFF                  // Unprogrammed record
+
+// Page header (16 bytes: 16 + 204 records x 20 bytes = one sector)
+typedef struct {
+    uint32_t magic;
+    uint32_t seq;                 // Monotonic page sequence (ring order)
+    uint32_t reserved[2];
+} trace_page_header_t;
+
+#define TRACE_RECORDS_PER_PAGE   ((TRACE_PAGE_SIZE - sizeof(trace_page_header_t)) / sizeof(field_trace_record_t))
+
+_Static_assert(sizeof(field_trace_record_t) == 20, "record layout is shared with the host replay");
+
+// ============================================================================
+// RTC MEMORY (ring and flash cursors, persist across deep sleep)
+// ============================================================================
+
+#define TRACE_RTC_MAGIC          0x43525446            // "FTRC"
+
+typedef struct {
+    uint32_t magic;
+    uint16_t head;                // Next ring slot
+    uint16_t count;               // Records in the ring
+    uint32_t dropped;             // Overwritten before reaching flash or a console
+
+    // Flash append position (rebuilt from flash when flash_ready is false)
+    bool flash_ready;
+    uint16_t flash_page;          // Page currently appended to
+    uint16_t flash_records;       // Records in flash_page
+    uint32_t next_seq;            // Sequence of the next page (1 = flash empty)
+
+    // Flash records up to (dumped_seq, dumped_records) were printed already
+    uint32_t dumped_seq;
+    uint16_t dumped_records;
+
+    field_trace_record_t ring[FIELD_TRACE_RING_RECORDS];
+} field_trace_rtc_t;
+
+// Survives deep sleep (not reset on wake), validated by magic
+static RTC_NOINIT_ATTR field_trace_rtc_t rtc_trace;
+
+static portMUX_TYPE trace_lock = portMUX_INITIALIZER_UNLOCKED;
+static const esp_partition_t *partition = NULL;
+static bool partition_looked_up = false;
+static uint16_t page_count = 0;
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+/**
+ * @brief Reset the RTC state if it does not hold a valid ring (caller holds trace_lock)
+ */
+static void ring_validate(void)
+{
+    if (rtc_trace.magic != TRACE_RTC_MAGIC ||
+        rtc_trace.head >= FIELD_TRACE_RING_RECORDS || rtc_trace.count > FIELD_TRACE_RING_RECORDS) {
+        memset(&rtc_trace, 0, sizeof(rtc_trace));
+        rtc_trace.magic = TRACE_RTC_MAGIC;
+    }
+}
+
+static uint16_t ring_index(uint16_t i)
+{
+    return (uint16_t)((rtc_trace.head + FIELD_TRACE_RING_RECORDS - rtc_trace.count + i) % FIELD_TRACE_RING_RECORDS);
+}
+
+static void ring_push(const field_trace_record_t *record)
+{
+    portENTER_CRITICAL(&trace_lock);
+    ring_validate();
+    rtc_trace.ring[rtc_trace.head] = *record;
+    rtc_trace.head = (uint16_t)((rtc_trace.head + 1) % FIELD_TRACE_RING_RECORDS);
+    if (rtc_trace.count < FIELD_TRACE_RING_RECORDS) {
+        rtc_trace.count++;
+    } else {
+        rtc_trace.dropped++;
+    }
+    portEXIT_CRITICAL(&trace_lock);
+}
+
+static bool find_partition(void)
+{
+    if (!partition_looked_up) {
+        partition_looked_up = true;
+        partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY,
+                                             FIELD_TRACE_PARTITION_LABEL);
+        if (partition) {
+            page_count = (uint16_t)(partition->size / TRACE_PAGE_SIZE);
+            if (page_count > TRACE_MAX_PAGES) {
+                page_count = TRACE_MAX_PAGES;
+            }
+        } else {
+            BLOG_W(TAG, "No '%s' partition - traces stay in RTC memory", FIELD_TRACE_PARTITION_LABEL);
+        }
+    }
+    return partition != NULL && page_count > 0;
+}
+
+static size_t record_offset(uint16_t page, uint16_t record)
+{
+    return (size_t)page * TRACE_PAGE_SIZE + sizeof(trace_page_header_t) +
+           (size_t)record * sizeof(field_trace_record_t);
+}
+
+/**
+ * @brief Read a page header
+ * @return Page sequence, or 0 if the page holds no trace
+ */
+static uint32_t page_seq(uint16_t page)
+{
+    trace_page_header_t header;
+    if (esp_partition_read(partition, (size_t)page * TRACE_PAGE_SIZE, &header, sizeof(header)) != ESP_OK ||
+        header.magic != TRACE_PAGE_MAGIC) {
+        return 0;
+    }
+    return header.seq;
+}
+
+/**
+ * @brief Number of programmed records in a page
+ */
+static uint16_t page_records(uint16_t page)
+{
+    uint16_t n = 0;
+    while (n < TRACE_RECORDS_PER_PAGE) {
+        uint8_t type;
+        if (esp_partition_read(partition, record_offset(page, n) + offsetof(field_trace_record_t, type),
+                               &type, sizeof(type)) != ESP_OK || type == TRACE_TYPE_ERASED) {
+            break;
+        }
+        n++;
+    }
+    return n;
+}
+
+/**
+ * @brief Locate the append position after a power loss
+ */
+static void scan_flash(void)
+{
+    uint32_t max_seq = 0;
+    for (uint16_t i = 0; i < page_count; i++) {
+        uint32_t seq = page_seq(i);
+        if (seq > max_seq) {
+            max_seq = seq;
+            rtc_trace.flash_page = i;
+        }
+    }
+    rtc_trace.next_seq = max_seq + 1;
+    rtc_trace.flash_records = max_seq ? page_records(rtc_trace.flash_page) : 0;
+    rtc_trace.flash_ready = true;
+}
+
+/**
+ * @brief Erase the next page in the ring and write its header
+ */
+static esp_err_t open_page(void)
+{
+    uint16_t page = rtc_trace.next_seq > 1 ? (uint16_t)((rtc_trace.flash_page + 1) % page_count) : 0;
+    esp_err_t ret = esp_partition_erase_range(partition, (size_t)page * TRACE_PAGE_SIZE, TRACE_PAGE_SIZE);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    trace_page_header_t header = {
+        .magic = TRACE_PAGE_MAGIC,
+        .seq = rtc_trace.next_seq,
+    };
+    ret = esp_partition_write(partition, (size_t)page * TRACE_PAGE_SIZE, &header, sizeof(header));
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    rtc_trace.flash_page = page;
+    rtc_trace.flash_records = 0;
+    rtc_trace.next_seq++;
+    return ESP_OK;
+}
+
+/**
+ * @brief Move the ring to flash (contiguous runs, one program per run)
+ */
+static esp_err_t spill(void)
+{
+    if (!find_partition()) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    portENTER_CRITICAL(&trace_lock);
+    ring_validate();
+    uint16_t pending = rtc_trace.count;
+    uint16_t first = ring_index(0);
+    portEXIT_CRITICAL(&trace_lock);
+
+    if (!rtc_trace.flash_ready) {
+        scan_flash();
+    }
+
+    esp_err_t ret = ESP_OK;
+    uint16_t written = 0;
+    while (written < pending && ret == ESP_OK) {
+        if (rtc_trace.next_seq == 1 || rtc_trace.flash_records >= TRACE_RECORDS_PER_PAGE) {
+            ret = open_page();
+            continue;
+        }
+        uint16_t slot = (uint16_t)((first + written) % FIELD_TRACE_RING_RECORDS);
+        uint16_t run = (uint16_t)(pending - written);
+        if (run > FIELD_TRACE_RING_RECORDS - slot) {
+            run = (uint16_t)(FIELD_TRACE_RING_RECORDS - slot);
+        }
+        if (run > TRACE_RECORDS_PER_PAGE - rtc_trace.flash_records) {
+            run = (uint16_t)(TRACE_RECORDS_PER_PAGE - rtc_trace.flash_records);
+        }
+        ret = esp_partition_write(partition, record_offset(rtc_trace.flash_page, rtc_trace.flash_records),
+                                  &rtc_trace.ring[slot], run * sizeof(field_trace_record_t));
+        if (ret == ESP_OK) {
+            rtc_trace.flash_records += run;
+            written += run;
+        }
+    }
+    if (ret != ESP_OK) {
+        rtc_trace.flash_ready = false;      // Rescan flash next time
+        BLOG_W(TAG, "Spill failed: %s", esp_err_to_name(ret));
+    }
+
+    // Records added meanwhile stay in the ring
+    portENTER_CRITICAL(&trace_lock);
+    rtc_trace.count = (uint16_t)(rtc_trace.count - (written < rtc_trace.count ? written : rtc_trace.count));
+    portEXIT_CRITICAL(&trace_lock);
+    return ret;
+}
+
+/**
+ * @brief Valid pages in sequence order
+ * @return Number of entries in pages/seqs
+ */
+static uint16_t sorted_pages(uint16_t *pages, uint32_t *seqs)
+{
+    uint16_t n = 0;
+    for (uint16_t i = 0; i < page_count; i++) {
+        uint32_t seq = page_seq(i);
+        if (seq == 0) {
+            continue;
+        }
+        uint16_t j = n++;
+        while (j > 0 && seqs[j - 1] > seq) {
+            pages[j] = pages[j - 1];
+            seqs[j] = seqs[j - 1];
+            j--;
+        }
+        pages[j] = i;
+        seqs[j] = seq;
+    }
+    return n;
+}
+
+static void print_record(const field_trace_record_t *record)
+{
+    uint32_t words[sizeof(field_trace_record_t) / sizeof(uint32_t)];
+    memcpy(words, record, sizeof(words));
+    printf("FTRACE %08lx %08lx %08lx %08lx %08lx\n", (unsigned long)words[0], (unsigned long)words[1],
+           (unsigned long)words[2], (unsigned long)words[3], (unsigned long)words[4]);
+}
+
+// ============================================================================
+// PUBLIC FUNCTIONS
+// ============================================================================
+
+void field_trace_init(void)
+{
+    field_trace_record_t record = {
+        .time_us = field_trace_start(),
+        .type = FIELD_TRACE_WAKE,
+        .source = (uint16_t)esp_sleep_get_wakeup_cause(),
+    };
+    uint32_t rtc_sec = deep_sleep_get_time_sec();
+    memcpy(record.data, &rtc_sec, sizeof(rtc_sec));
+    ring_push(&record);
+}
+
+uint32_t field_trace_start(void)
+{
+    return (uint32_t)esp_timer_get_time();
+}
+
+void field_trace_i2c(field_trace_type_t type, uint16_t addr, const uint8_t *data, size_t len,
+                     esp_err_t status, uint32_t start_us)
+{
+    field_trace_record_t record = {
+        .time_us = start_us,
+        .duration_us = field_trace_start() - start_us,
+        .type = (uint8_t)type,
+        .len = (uint8_t)(len > UINT8_MAX ? UINT8_MAX : len),
+        .source = addr,
+        .status = status,
+    };
+    if (data && (type == FIELD_TRACE_I2C_TX || status == ESP_OK)) {
+        memcpy(record.data, data, len < FIELD_TRACE_DATA_BYTES ? len : FIELD_TRACE_DATA_BYTES);
+    }
+    ring_push(&record);
+}
+
+void field_trace_adc(int channel, int raw, esp_err_t status, uint32_t start_us)
+{
+    field_trace_record_t record = {
+        .time_us = start_us,
+        .duration_us = field_trace_start() - start_us,
+        .type = FIELD_TRACE_ADC,
+        .source = (uint16_t)channel,
+        .status = status,
+    };
+    int32_t value = status == ESP_OK ? raw : 0;
+    memcpy(record.data, &value, sizeof(value));
+    ring_push(&record);
+}
+
+void field_trace_zb_signal(uint32_t signal, esp_err_t status)
+{
+    field_trace_record_t record = {
+        .time_us = field_trace_start(),
+        .type = FIELD_TRACE_ZB_SIGNAL,
+        .source = (uint16_t)signal,
+        .status = status,
+    };
+    ring_push(&record);
+}
+
+void field_trace_sleep(uint32_t sleep_sec)
+{
+    field_trace_record_t record = {
+        .time_us = field_trace_start(),
+        .type = FIELD_TRACE_SLEEP,
+    };
+    memcpy(record.data, &sleep_sec, sizeof(sleep_sec));
+    ring_push(&record);
+
+    // Batch flash programs: one spill every few wakes
+    if (rtc_trace.count >= FIELD_TRACE_SPILL_RECORDS && find_partition()) {
+        spill();
+    }
+}
+
+size_t field_trace_export(field_trace_record_t *out, size_t max)
+{
+    size_t n = 0;
+    if (find_partition()) {
+        uint16_t pages[TRACE_MAX_PAGES];
+        uint32_t seqs[TRACE_MAX_PAGES];
+        uint16_t count = sorted_pages(pages, seqs);
+        for (uint16_t p = 0; p < count; p++) {
+            uint16_t records = page_records(pages[p]);
+            for (uint16_t r = 0; r < records; r++, n++) {
+                if (out && n < max) {
+                    esp_partition_read(partition, record_offset(pages[p], r), &out[n], sizeof(out[n]));
+                }
+            }
+        }
+    }
+
+    portENTER_CRITICAL(&trace_lock);
+    ring_validate();
+    for (uint16_t i = 0; i < rtc_trace.count; i++, n++) {
+        if (out && n < max) {
+            out[n] = rtc_trace.ring[ring_index(i)];
+        }
+    }
+    portEXIT_CRITICAL(&trace_lock);
+    return n;
+}
+
+void field_trace_dump(void)
+{
+    if (find_partition() && spill() == ESP_OK) {
+        uint16_t pages[TRACE_MAX_PAGES];
+        uint32_t seqs[TRACE_MAX_PAGES];
+        uint16_t count = sorted_pages(pages, seqs);
+        for (uint16_t p = 0; p < count; p++) {
+            if (seqs[p] < rtc_trace.dumped_seq) {
+                continue;
+            }
+            uint16_t records = page_records(pages[p]);
+            uint16_t r = seqs[p] == rtc_trace.dumped_seq ? rtc_trace.dumped_records : 0;
+            for (; r < records; r++) {
+                field_trace_record_t record;
+                if (esp_partition_read(partition, record_offset(pages[p], r), &record, sizeof(record)) == ESP_OK) {
+                    print_record(&record);
+                }
+            }
+            rtc_trace.dumped_seq = seqs[p];
+            rtc_trace.dumped_records = records;
+        }
+    } else {
+        // No flash: the ring is the only copy, printed and emptied
+        while (1) {
+            field_trace_record_t record;
+            bool have = false;
+            portENTER_CRITICAL(&trace_lock);
+            ring_validate();
+            if (rtc_trace.count > 0) {
+                record = rtc_trace.ring[ring_index(0)];
+                rtc_trace.count--;
+                have = true;
+            }
+            portEXIT_CRITICAL(&trace_lock);
+            if (!have) {
+                break;
+            }
+            print_record(&record);
+        }
+    }
+
+    if (rtc_trace.dropped > 0) {
+        printf("FTRACE_DROPPED %lu\n", (unsigned long)rtc_trace.dropped);
+        rtc_trace.dropped = 0;
+    }
+    fflush(stdout);
+}
+
+bool field_trace_flush_if_attached(void)
+{
+    if (!binlog_console_attached()) {
+        return false;
+    }
+    field_trace_dump();
+    return true;
+}
+
+esp_err_t field_trace_clear(void)
+{
+    portENTER_CRITICAL(&trace_lock);
+    memset(&rtc_trace, 0, sizeof(rtc_trace));
+    rtc_trace.magic = TRACE_RTC_MAGIC;
+    portEXIT_CRITICAL(&trace_lock);
+
+    if (!find_partition()) {
+        return ESP_OK;
+    }
+    esp_err_t ret = esp_partition_erase_range(partition, 0, (size_t)page_count * TRACE_PAGE_SIZE);
+    if (ret == ESP_OK) {
+        rtc_trace.next_seq = 1;
+        rtc_trace.flash_ready = true;
+    }
+    return ret;
+}
+
+#endif // FIELD_TRACE_ENABLED
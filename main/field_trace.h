@@ -0,0 +1,142 @@
+/*
+ * Glyph C6 Monitor - Field Trace Recorder
+ *
+ * Version: 1.0.0
+ *
+ * Records the timing and outcome of every external interaction of a wake
+ * (I2C transfers, ADC conversions, Zigbee stack signals) so that field
+ * behaviour that cannot be reproduced on the bench can be replayed into
+ * the host build (host/sim/trace_replay.h) on virtual time.
+ *
+ * - Records are fixed 20-byte entries in an RTC ring (survives deep sleep)
+ * - At the end of a wake the ring is spilled to the "trace" flash
+ *   partition once it holds FIELD_TRACE_SPILL_RECORDS entries, so flash is
+ *   programmed every few wakes, not per record; the partition is a ring
+ *   of 4 KB pages (oldest page erased on wrap)
+ * - field_trace_dump prints records not dumped before as "FTRACE" hex
+ *   lines (one record, five 32-bit words each) to a listening console
+ *
+ * Enabled with CONFIG_GLYPH_FIELD_TRACE; otherwise the hooks compile to
+ * nothing.
+ */
+
+#ifndef FIELD_TRACE_H
+#define FIELD_TRACE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "system_config.h"
+
+// Record types
+typedef enum {
+    FIELD_TRACE_WAKE = 1,         // source: wake cause, data: RTC seconds
+    FIELD_TRACE_I2C_TX,           // source: 7-bit address, data: first bytes written
+    FIELD_TRACE_I2C_RX,           // source: 7-bit address, data: first bytes read
+    FIELD_TRACE_ADC,              // source: channel, data: raw conversion (int32)
+    FIELD_TRACE_ZB_SIGNAL,        // source: esp_zb_app_signal_type_t
+    FIELD_TRACE_SLEEP,            // data: armed sleep duration (s); last record of a wake
+} field_trace_type_t;
+
+#define FIELD_TRACE_DATA_BYTES    4
+
+// One interaction (5 words; same layout in RTC, flash and dump lines)
+typedef struct {
+    uint32_t time_us;             // Start, microseconds since boot
+    uint32_t duration_us;         // 0 for point events
+    uint8_t type;                 // field_trace_type_t
+    uint8_t len;                  // Bytes transferred (I2C), 0 otherwise
+    uint16_t source;
+    int32_t status;               // esp_err_t of the interaction
+    uint8_t data[FIELD_TRACE_DATA_BYTES];
+} field_trace_record_t;
+
+#if FIELD_TRACE_ENABLED
+
+/**
+ * @brief Validate the RTC ring and record the start of a wake
+ *
+ * Call after deep_sleep_init() (uses the RTC clock and wake cause).
+ */
+void field_trace_init(void);
+
+/**
+ * @brief Start time of an interaction (pass to the record call)
+ * @return Microseconds since boot
+ */
+uint32_t field_trace_start(void);
+
+/**
+ * @brief Record an I2C transfer
+ * @param type FIELD_TRACE_I2C_TX or FIELD_TRACE_I2C_RX
+ * @param addr 7-bit device address
+ * @param data Bytes written or read (the first FIELD_TRACE_DATA_BYTES are kept)
+ * @param len Transfer length
+ * @param status Driver result
+ * @param start_us Value of field_trace_start() before the transfer
+ */
+void field_trace_i2c(field_trace_type_t type, uint16_t addr, const uint8_t *data, size_t len,
+                     esp_err_t status, uint32_t start_us);
+
+/**
+ * @brief Record a oneshot ADC conversion
+ */
+void field_trace_adc(int channel, int raw, esp_err_t status, uint32_t start_us);
+
+/**
+ * @brief Record a Zigbee application signal as delivered to the handler
+ */
+void field_trace_zb_signal(uint32_t signal, esp_err_t status);
+
+/**
+ * @brief Record the end of a wake and spill the ring to flash when due
+ * @param sleep_sec Deep sleep duration about to be armed
+ */
+void field_trace_sleep(uint32_t sleep_sec);
+
+/**
+ * @brief Copy every stored record, oldest first (flash, then the RTC ring)
+ * @param out Destination (NULL to count only)
+ * @param max Capacity of out
+ * @return Number of records stored (may exceed max)
+ */
+size_t field_trace_export(field_trace_record_t *out, size_t max);
+
+/**
+ * @brief Print records not dumped before as "FTRACE" lines
+ */
+void field_trace_dump(void);
+
+/**
+ * @brief Dump only if a console is attached (binlog_console_attached)
+ * @return true if records were dumped
+ */
+bool field_trace_flush_if_attached(void);
+
+/**
+ * @brief Drop all records (RTC ring and flash partition)
+ * @return ESP_OK, or the flash erase error
+ */
+esp_err_t field_trace_clear(void);
+
+#else
+
+static inline void field_trace_init(void) {}
+static inline uint32_t field_trace_start(void) { return 0; }
+static inline void field_trace_i2c(field_trace_type_t type, uint16_t addr, const uint8_t *data, size_t len,
+                                   esp_err_t status, uint32_t start_us)
+{
+    (void)type; (void)addr; (void)data; (void)len; (void)status; (void)start_us;
+}
+static inline void field_trace_adc(int channel, int raw, esp_err_t status, uint32_t start_us)
+{
+    (void)channel; (void)raw; (void)status; (void)start_us;
+}
+static inline void field_trace_zb_signal(uint32_t signal, esp_err_t status) { (void)signal; (void)status; }
+static inline void field_trace_sleep(uint32_t sleep_sec) { (void)sleep_sec; }
+static inline bool field_trace_flush_if_attached(void) { return false; }
+
+#endif // FIELD_TRACE_ENABLED
+
+#endif // FIELD_TRACE_H
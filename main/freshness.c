@@ -0,0 +1,62 @@
+/*
+ * Glyph C6 Monitor - Reading Freshness
+ *
+ * Version: 1.0.0
+ */
+
+#include "freshness.h"
+
+// Upper bucket edges in ms (the last bucket is open-ended)
+static const uint32_t bucket_edges_ms[FRESHNESS_BUCKETS - 1] = {
+    1000, 5000, 15000, 30000, 60000, 300000, 1800000,
+};
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+static uint8_t *put_u16(uint8_t *p, uint16_t value)
+{
+    p[0] = (uint8_t)(value & 0xFF);
+    p[1] = (uint8_t)(value >> 8);
+    return p + 2;
+}
+
+static uint8_t *put_u32(uint8_t *p, uint32_t value)
+{
+    p = put_u16(p, (uint16_t)(value & 0xFFFF));
+    return put_u16(p, (uint16_t)(value >> 16));
+}
+
+// ============================================================================
+// PUBLIC FUNCTIONS
+// ============================================================================
+
+void freshness_record(freshness_histogram_t *hist, uint32_t age_ms)
+{
+    size_t bucket = 0;
+    while (bucket < FRESHNESS_BUCKETS - 1 && age_ms >= bucket_edges_ms[bucket]) {
+        bucket++;
+    }
+    if (hist->counts[bucket] < UINT16_MAX) {
+        hist->counts[bucket]++;
+    }
+}
+
+size_t freshness_encode(const freshness_histogram_t *hist, uint32_t acquired_ms, uint32_t sent_ms,
+                        uint8_t *buf, size_t len)
+{
+    if (len < FRESHNESS_RECORD_LEN) {
+        return 0;
+    }
+
+    uint8_t *p = buf;
+    *p++ = FRESHNESS_RECORD_VERSION;
+    p = put_u32(p, acquired_ms);
+    p = put_u32(p, sent_ms);
+    *p++ = FRESHNESS_BUCKETS;
+    for (size_t i = 0; i < FRESHNESS_BUCKETS; i++) {
+        p = put_u16(p, hist->counts[i]);
+    }
+    return (size_t)(p - buf);
+}
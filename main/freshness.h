@@ -0,0 +1,72 @@
+/*
+ * Glyph C6 Monitor - Reading Freshness
+ *
+ * Version: 1.0.0
+ *
+ * Every reported reading carries the device time it was acquired and the
+ * device time it was sent, so the coordinator can tell a value taken just
+ * now from one that waited through a join or a poll. The difference (the
+ * reading's age at send) also goes into a coarse histogram kept for the
+ * life of the device clock, reported with the same record.
+ *
+ * Times are RTC milliseconds (deep_sleep_get_time_ms): they survive deep
+ * sleep but are not wall-clock time, and wrap after ~49 days. Only
+ * differences are meaningful. The histogram is plain data and may live
+ * in RTC memory.
+ */
+
+#ifndef FRESHNESS_H
+#define FRESHNESS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Record format version (first byte of the encoded record)
+#define FRESHNESS_RECORD_VERSION     1
+
+// Age histogram buckets: < 1 s, < 5 s, < 15 s, < 30 s, < 1 min, < 5 min, < 30 min, longer
+#define FRESHNESS_BUCKETS            8
+
+// Encoded record size in bytes (see freshness_encode)
+#define FRESHNESS_RECORD_LEN         (10 + FRESHNESS_BUCKETS * 2)
+
+// Reading age at send, counts saturate at UINT16_MAX
+typedef struct {
+    uint16_t counts[FRESHNESS_BUCKETS];
+} freshness_histogram_t;
+
+/**
+ * @brief Age of a reading at send time (wrap-safe)
+ * @param acquired_ms Acquisition time (RTC ms)
+ * @param sent_ms Send time (RTC ms)
+ * @return Milliseconds between the two
+ */
+static inline uint32_t freshness_age_ms(uint32_t acquired_ms, uint32_t sent_ms)
+{
+    return sent_ms - acquired_ms;
+}
+
+/**
+ * @brief Count one sent reading in its age bucket
+ * @param hist Histogram
+ * @param age_ms Reading age at send (ms)
+ */
+void freshness_record(freshness_histogram_t *hist, uint32_t age_ms);
+
+/**
+ * @brief Encode a reading's timestamps and the histogram as a little-endian record
+ *
+ * Layout (26 bytes): version u8, acquired_ms u32, sent_ms u32,
+ * bucket count u8, bucket counts u16 x FRESHNESS_BUCKETS.
+ *
+ * @param hist Histogram (already including this reading)
+ * @param acquired_ms Acquisition time of the reading (RTC ms)
+ * @param sent_ms Send time of the reading (RTC ms)
+ * @param buf Output buffer
+ * @param len Buffer size (>= FRESHNESS_RECORD_LEN)
+ * @return Number of bytes written, 0 if buffer too small
+ */
+size_t freshness_encode(const freshness_histogram_t *hist, uint32_t acquired_ms, uint32_t sent_ms,
+                        uint8_t *buf, size_t len);
+
+#endif // FRESHNESS_H
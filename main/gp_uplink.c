@@ -0,0 +1,452 @@
+/*
+ * Glyph C6 Monitor - Commissioning-Free Uplink (Green Power style)
+ *
+ * Version: 1.0.0
+ *
+ * The ESP Zigbee SDK ships Green Power device support only as a separate
+ * stack build, so the GPDFs are assembled here and sent through the raw
+ * 802.15.4 driver on wakes that never start the Zigbee stack.
+ */
+
+#include "gp_uplink.h"
+#include "system_config.h"
+#include "binlog.h"
+#include "esp_attr.h"
+#include "esp_ieee802154.h"
+#include "esp_random.h"
+#include "esp_rom_sys.h"
+#include "esp_timer.h"
+#include "mbedtls/ccm.h"
+#include "nvs.h"
+#include <string.h>
+
+static const char *TAG = "GP_UPLINK";
+
+#define GP_NVS_NAMESPACE         "gp_uplink"
+#define GP_NVS_KEY_PAIRING       "pairing"
+#define GP_NVS_KEY_COUNTER       "fc_limit"   // First frame counter not reserved yet
+#define GP_RTC_MAGIC             0x47505550   // "GPUP"
+
+#define GP_KEY_LEN               16
+#define GP_NONCE_LEN             13
+#define GP_NONCE_SEC_CONTROL     0x05         // Level 2 + 4-byte MIC (CCM* nonce)
+#define GP_HEADER_LEN            14           // PHR + MAC (7) + NWK FC + ext FC + SrcID (4)
+#define GP_FRAME_MAX             64           // PHR + largest frame + FCS
+#define GP_FCS_LEN               2
+#define GP_TX_POLL_US            50
+
+// Zigbee default trust center link key "ZigBeeAlliance09" (encrypts the
+// key in the commissioning frame)
+static const uint8_t tc_link_key[GP_KEY_LEN] = {
+    0x5A, 0x69, 0x67, 0x42, 0x65, 0x65, 0x41, 0x6C, 0x6C, 0x69, 0x61, 0x6E, 0x63, 0x65, 0x30, 0x39,
+};
+
+// ============================================================================
+// RTC MEMORY (persists across deep sleep)
+// ============================================================================
+
+// Pairing as stored in NVS
+typedef struct {
+    uint32_t src_id;                      // 0 = not commissioned
+    uint8_t key[GP_KEY_LEN];              // GPD individual key
+    uint8_t channel;                      // Channel the sink listens on
+    bool requested;                       // gpUplink attribute
+    bool commission_pending;              // Send commissioning frames at the next wake
+} gp_pairing_t;
+
+typedef struct {
+    uint32_t magic;                       // GP_RTC_MAGIC once loaded
+    gp_pairing_t pairing;
+    uint32_t counter;                     // Frame counter of the next frame
+    uint32_t counter_limit;               // Counters below this are reserved in NVS
+    uint16_t since_full_wake;             // Frames sent since the last full wake
+    uint8_t mac_seq;
+} gp_uplink_state_t;
+
+static RTC_DATA_ATTR gp_uplink_state_t rtc_gp;
+
+// ============================================================================
+// PERSISTENCE
+// ============================================================================
+
+static esp_err_t store_pairing(void)
+{
+    nvs_handle_t nvs;
+    esp_err_t ret = nvs_open(GP_NVS_NAMESPACE, NVS_READWRITE, &nvs);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    ret = nvs_set_blob(nvs, GP_NVS_KEY_PAIRING, &rtc_gp.pairing, sizeof(rtc_gp.pairing));
+    if (ret == ESP_OK) {
+        ret = nvs_commit(nvs);
+    }
+    nvs_close(nvs);
+    if (ret != ESP_OK) {
+        BLOG_W(TAG, "Failed to persist pairing: %s", esp_err_to_name(ret));
+    }
+    return ret;
+}
+
+/**
+ * @brief Cold boot: pairing and the reserved counter range from NVS
+ *
+ * Counting resumes at the end of the last reserved block, so counters
+ * used before the power loss are never repeated.
+ */
+static void load_from_nvs(void)
+{
+    memset(&rtc_gp, 0, sizeof(rtc_gp));
+    rtc_gp.since_full_wake = GP_FULL_WAKE_REPORTS;
+
+    nvs_handle_t nvs;
+    if (nvs_open(GP_NVS_NAMESPACE, NVS_READONLY, &nvs) != ESP_OK) {
+        return;  // Never paired
+    }
+    gp_pairing_t pairing;
+    size_t len = sizeof(pairing);
+    if (nvs_get_blob(nvs, GP_NVS_KEY_PAIRING, &pairing, &len) == ESP_OK && len == sizeof(pairing)) {
+        rtc_gp.pairing = pairing;
+    }
+    uint32_t limit = 0;
+    if (nvs_get_u32(nvs, GP_NVS_KEY_COUNTER, &limit) == ESP_OK) {
+        rtc_gp.counter = limit;
+        rtc_gp.counter_limit = limit;
+    }
+    nvs_close(nvs);
+}
+
+/**
+ * @brief Make sure the next frame counter is reserved in NVS
+ */
+static esp_err_t reserve_counter(void)
+{
+    if (rtc_gp.counter < rtc_gp.counter_limit) {
+        return ESP_OK;
+    }
+    uint32_t limit = rtc_gp.counter + GP_COUNTER_BLOCK;
+    nvs_handle_t nvs;
+    esp_err_t ret = nvs_open(GP_NVS_NAMESPACE, NVS_READWRITE, &nvs);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    ret = nvs_set_u32(nvs, GP_NVS_KEY_COUNTER, limit);
+    if (ret == ESP_OK) {
+        ret = nvs_commit(nvs);
+    }
+    nvs_close(nvs);
+    if (ret == ESP_OK) {
+        rtc_gp.counter_limit = limit;
+    }
+    return ret;
+}
+
+// ============================================================================
+// FRAMES
+// ============================================================================
+
+static void put_u16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+/**
+ * @brief PHR placeholder, MAC header and GP NWK header up to the SrcID
+ * @return Bytes written (GP_HEADER_LEN)
+ */
+static size_t put_header(uint8_t *frame, uint8_t ext_fc)
+{
+    uint8_t *p = frame + 1;
+    put_u16(p, GP_MAC_FCF);
+    p[2] = rtc_gp.mac_seq;
+    put_u16(&p[3], 0xFFFF);               // Destination PAN
+    put_u16(&p[5], 0xFFFF);               // Broadcast
+    p[7] = GP_NWK_FC;
+    p[8] = ext_fc;
+    put_u32(&p[9], rtc_gp.pairing.src_id);
+    return GP_HEADER_LEN;
+}
+
+/**
+ * @brief CCM* nonce of a GPD frame: SrcID, SrcID, frame counter, security control
+ */
+static void put_nonce(uint8_t nonce[GP_NONCE_LEN], uint32_t counter)
+{
+    put_u32(&nonce[0], rtc_gp.pairing.src_id);
+    put_u32(&nonce[4], rtc_gp.pairing.src_id);
+    put_u32(&nonce[8], counter);
+    nonce[12] = GP_NONCE_SEC_CONTROL;
+}
+
+/**
+ * @brief AES-128 CCM* with a 4-byte MIC (len 0: authentication only)
+ */
+static esp_err_t ccm_star(const uint8_t *key, const uint8_t *nonce, const uint8_t *ad, size_t ad_len,
+                          const uint8_t *in, uint8_t *out, size_t len, uint8_t *mic)
+{
+    mbedtls_ccm_context ccm;
+    mbedtls_ccm_init(&ccm);
+    int ret = mbedtls_ccm_setkey(&ccm, MBEDTLS_CIPHER_ID_AES, key, GP_KEY_LEN * 8);
+    if (ret == 0) {
+        ret = mbedtls_ccm_encrypt_and_tag(&ccm, len, nonce, GP_NONCE_LEN, ad, ad_len,
+                                          in, out, mic, GP_MIC_LEN);
+    }
+    mbedtls_ccm_free(&ccm);
+    return ret == 0 ? ESP_OK : ESP_FAIL;
+}
+
+static void encode_reading(uint8_t *p, const gp_reading_t *r)
+{
+    p[0] = r->flags;
+    put_u16(&p[1], r->moisture_centi);
+    put_u16(&p[3], (uint16_t)r->temp_centi);
+    p[5] = r->battery_decivolts;
+    p[6] = r->battery_half_pct;
+    put_u16(&p[7], r->watering_events);
+    put_u16(&p[9], r->age_sec);
+}
+
+// ============================================================================
+// RADIO
+// ============================================================================
+
+static esp_err_t wait_tx_done(void)
+{
+    int64_t start = esp_timer_get_time();
+    for (;;) {
+        esp_ieee802154_state_t state = esp_ieee802154_get_state();
+        if (state != ESP_IEEE802154_RADIO_TX_CCA && state != ESP_IEEE802154_RADIO_TRANSMIT) {
+            return ESP_OK;
+        }
+        if (esp_timer_get_time() - start > GP_TX_TIMEOUT_US) {
+            return ESP_ERR_TIMEOUT;
+        }
+        esp_rom_delay_us(GP_TX_POLL_US);
+    }
+}
+
+/**
+ * @brief Send GP_TX_REPEATS copies of a frame on the sink's channel
+ *
+ * The Zigbee platform owns the driver's transmit-done callbacks, so
+ * completion is polled. Without CCA: the copies are the retry scheme.
+ *
+ * @param frame PHR byte (set here), then the MAC frame
+ * @param len MAC frame length without the FCS
+ */
+static esp_err_t transmit(uint8_t *frame, size_t len)
+{
+    frame[0] = (uint8_t)(len + GP_FCS_LEN);
+
+    esp_err_t ret = esp_ieee802154_enable();
+    if (ret == ESP_OK) {
+        esp_ieee802154_set_rx_when_idle(false);
+        ret = esp_ieee802154_set_channel(rtc_gp.pairing.channel);
+    }
+    for (int i = 0; ret == ESP_OK && i < GP_TX_REPEATS; i++) {
+        if (i > 0) {
+            esp_rom_delay_us(GP_TX_GAP_US);
+        }
+        ret = esp_ieee802154_transmit(frame, false);
+        if (ret == ESP_OK) {
+            ret = wait_tx_done();
+        }
+    }
+    esp_ieee802154_disable();
+    rtc_gp.mac_seq++;
+    return ret;
+}
+
+/**
+ * @brief First pairing: random SrcID (outside the reserved values) and key
+ */
+static void new_identity(void)
+{
+    uint32_t src_id;
+    do {
+        src_id = esp_random();
+    } while (src_id == 0x00000000 || src_id >= 0xFFFFFFF9);
+    rtc_gp.pairing.src_id = src_id;
+    esp_fill_random(rtc_gp.pairing.key, GP_KEY_LEN);
+}
+
+/**
+ * @brief Send the commissioning frames (unsecured GPDF, key encrypted)
+ */
+static esp_err_t commission(void)
+{
+    if (rtc_gp.pairing.src_id == 0) {
+        new_identity();
+    }
+    esp_err_t ret = reserve_counter();
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    uint8_t frame[GP_FRAME_MAX];
+    size_t len = put_header(frame, GP_EXT_NWK_FC_PLAIN);
+    uint8_t *p = &frame[len];
+    p[0] = GP_CMD_COMMISSIONING;
+    p[1] = GP_DEVICE_ID;
+    p[2] = GP_COMMISSION_OPTIONS;
+    p[3] = GP_COMMISSION_EXT_OPTIONS;
+
+    // Key protected with the default link key: nonce SrcID x3, a = SrcID
+    uint8_t nonce[GP_NONCE_LEN];
+    put_nonce(nonce, rtc_gp.pairing.src_id);
+    uint8_t src[4];
+    put_u32(src, rtc_gp.pairing.src_id);
+    ret = ccm_star(tc_link_key, nonce, src, sizeof(src), rtc_gp.pairing.key, &p[4], GP_KEY_LEN, &p[20]);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    put_u32(&p[24], rtc_gp.counter);
+    len += 28 - 1;                         // Payload after the PHR byte
+
+    ret = transmit(frame, len);
+    if (ret == ESP_OK) {
+        BLOG_I(TAG, "Commissioning sent: SrcID 0x%08" PRIx32 " on channel %u, counter %" PRIu32,
+               rtc_gp.pairing.src_id, rtc_gp.pairing.channel, rtc_gp.counter);
+    }
+    return ret;
+}
+
+// ============================================================================
+// PUBLIC FUNCTIONS
+// ============================================================================
+
+esp_err_t gp_uplink_init(void)
+{
+    if (rtc_gp.magic != GP_RTC_MAGIC) {
+        load_from_nvs();
+        rtc_gp.magic = GP_RTC_MAGIC;
+    }
+    if (!GP_UPLINK_ENABLED || !rtc_gp.pairing.commission_pending) {
+        return ESP_OK;
+    }
+
+    esp_err_t ret = commission();
+    if (ret != ESP_OK) {
+        BLOG_W(TAG, "Commissioning failed: %s", esp_err_to_name(ret));
+    }
+    // One attempt per request; readings go through a full wake first, which
+    // reports the SrcID
+    rtc_gp.pairing.commission_pending = false;
+    rtc_gp.since_full_wake = GP_FULL_WAKE_REPORTS;
+    store_pairing();
+    return ret;
+}
+
+bool gp_uplink_use_this_wake(void)
+{
+    return GP_UPLINK_ENABLED && rtc_gp.magic == GP_RTC_MAGIC &&
+           rtc_gp.pairing.requested && rtc_gp.pairing.src_id != 0 &&
+           !rtc_gp.pairing.commission_pending &&
+           rtc_gp.since_full_wake < GP_FULL_WAKE_REPORTS;
+}
+
+esp_err_t gp_uplink_send(const gp_reading_t *reading)
+{
+    if (!reading) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (rtc_gp.magic != GP_RTC_MAGIC || rtc_gp.pairing.src_id == 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    esp_err_t ret = reserve_counter();
+    if (ret != ESP_OK) {
+        BLOG_W(TAG, "Frame counter not reserved: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    uint8_t frame[GP_FRAME_MAX];
+    size_t len = put_header(frame, GP_EXT_NWK_FC_SECURED);
+    uint8_t *p = &frame[len];
+    put_u32(p, rtc_gp.counter);
+    p[4] = GP_CMD_READING;
+    encode_reading(&p[5], reading);
+    size_t payload = 5 + GP_READING_LEN;
+
+    // Level 2: MIC over NWK header, frame counter and payload, nothing encrypted
+    uint8_t nonce[GP_NONCE_LEN];
+    put_nonce(nonce, rtc_gp.counter);
+    const uint8_t *ad = &frame[8];        // NWK FC onwards
+    size_t ad_len = len - 8 + payload;
+    ret = ccm_star(rtc_gp.pairing.key, nonce, ad, ad_len, NULL, NULL, 0, &p[payload]);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    len += payload + GP_MIC_LEN - 1;
+
+    ret = transmit(frame, len);
+    rtc_gp.counter++;
+    if (ret != ESP_OK) {
+        BLOG_W(TAG, "Uplink frame failed: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    rtc_gp.since_full_wake++;
+    BLOG_I(TAG, "Uplink frame %" PRIu32 " sent (%u/%d before the next full wake)",
+           rtc_gp.counter - 1, rtc_gp.since_full_wake, GP_FULL_WAKE_REPORTS);
+    return ESP_OK;
+}
+
+void gp_uplink_full_wake(uint8_t channel)
+{
+    if (rtc_gp.magic != GP_RTC_MAGIC) {
+        return;
+    }
+    rtc_gp.since_full_wake = 0;
+    if (rtc_gp.pairing.src_id != 0 && channel != 0 && channel != rtc_gp.pairing.channel) {
+        BLOG_I(TAG, "Network moved to channel %u - uplink follows", channel);
+        rtc_gp.pairing.channel = channel;
+        store_pairing();
+    }
+}
+
+esp_err_t gp_uplink_request(bool enable, uint8_t channel)
+{
+    if (!GP_UPLINK_ENABLED) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    if (rtc_gp.magic != GP_RTC_MAGIC) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (enable && channel == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (enable) {
+        rtc_gp.pairing.requested = true;
+        rtc_gp.pairing.channel = channel;
+        rtc_gp.pairing.commission_pending = true;
+        BLOG_I(TAG, "Uplink requested - commissioning at the next wake");
+    } else {
+        // The key is dropped: pairing again starts with a new identity
+        memset(&rtc_gp.pairing, 0, sizeof(rtc_gp.pairing));
+        BLOG_I(TAG, "Uplink disabled - every wake joins the network");
+    }
+    return store_pairing();
+}
+
+bool gp_uplink_requested(void)
+{
+    return rtc_gp.magic == GP_RTC_MAGIC && rtc_gp.pairing.requested;
+}
+
+bool gp_uplink_commission_pending(void)
+{
+    return GP_UPLINK_ENABLED && rtc_gp.magic == GP_RTC_MAGIC && rtc_gp.pairing.commission_pending;
+}
+
+uint32_t gp_uplink_src_id(void)
+{
+    return (rtc_gp.magic == GP_RTC_MAGIC) ? rtc_gp.pairing.src_id : 0;
+}
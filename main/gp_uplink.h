@@ -0,0 +1,146 @@
+/*
+ * Glyph C6 Monitor - Commissioning-Free Uplink (Green Power style)
+ *
+ * Version: 1.0.0
+ *
+ * Between full Zigbee wakes a paired node sends each report as one
+ * authenticated Green Power data frame (GPDF) straight from the raw
+ * 802.15.4 driver: no rejoin, no data request, no APS ack. A GP proxy or
+ * sink on the coordinator side checks the MIC and frame counter and
+ * forwards the reading.
+ *
+ * - Pairing is a one-time step: the coordinator writes the gpUplink
+ *   configuration attribute while its sink is in commissioning mode, and
+ *   the next wake sends GP Commissioning frames carrying the SrcID, the
+ *   individual key (encrypted with the Zigbee default link key) and the
+ *   frame counter. The pairing is kept in NVS
+ * - Data frames use security level 2 (4-byte frame counter, 4-byte MIC,
+ *   AES-128 CCM*) with the GPD individual key; the payload stays in clear
+ * - The frame counter lives in RTC memory; NVS only records the end of a
+ *   reserved block of GP_COUNTER_BLOCK counters, so a power loss never
+ *   repeats a counter and ordinary wakes never write flash
+ * - Every GP_FULL_WAKE_REPORTS frames the node does a full ZED wake again
+ *   (OTA, configuration, history pull, channel check)
+ *
+ * There are no acks: each frame goes out GP_TX_REPEATS times with the same
+ * MAC sequence number and frame counter, and the sink drops the copies.
+ *
+ * Frame (MAC data frame, broadcast, no source address):
+ *   FCF u16 0x0801, seq u8, dst PAN 0xFFFF, dst addr 0xFFFF,
+ *   NWK FC 0x8C, ext NWK FC 0x30, SrcID u32, frame counter u32,
+ *   command u8, payload, MIC u32 (all little-endian)
+ */
+
+#ifndef GP_UPLINK_H
+#define GP_UPLINK_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+// GPDF header (MAC + GP NWK, application id 0)
+#define GP_MAC_FCF                   0x0801   // Data, no ack, short dst, no src
+#define GP_NWK_FC                    0x8C     // Data frame, protocol 3, ext FC present
+#define GP_EXT_NWK_FC_SECURED        0x30     // Level 2 (FC + MIC), individual key, from GPD
+#define GP_EXT_NWK_FC_PLAIN          0x00     // No security (commissioning)
+#define GP_MIC_LEN                   4
+
+// GPD commands
+#define GP_CMD_READING               0xB0     // Manufacturer-defined: gp_reading_t payload
+#define GP_CMD_COMMISSIONING         0xE0
+
+// Commissioning payload: device id, options, extended options, encrypted
+// key (16) + key MIC (4), outgoing frame counter u32
+#define GP_DEVICE_ID                 0xFE     // Manufacturer-specific GPD
+#define GP_COMMISSION_OPTIONS        0x81     // MAC seq capability, extended options present
+#define GP_COMMISSION_EXT_OPTIONS    0xF2     // Level 2, individual key, key present + encrypted, counter present
+
+// Reading payload (GP_CMD_READING): flags u8, moisture u16 (0.01 %),
+// temperature i16 (0.01 °C), battery voltage u8 (0.1 V), battery u8
+// (0.5 %), watering events u16, reading age u16 (s)
+#define GP_READING_LEN               11
+#define GP_READING_FLAG_WATERING     0x01     // Carries a new watering event
+#define GP_READING_FLAG_EXTERNAL     0x02     // On external power
+
+// One report, in on-air units
+typedef struct {
+    uint8_t flags;                 // GP_READING_FLAG_*
+    uint16_t moisture_centi;
+    int16_t temp_centi;
+    uint8_t battery_decivolts;     // ZCL battery voltage
+    uint8_t battery_half_pct;      // ZCL battery percentage remaining
+    uint16_t watering_events;      // Low 16 bits of the event counter
+    uint16_t age_sec;              // Acquisition to send (saturates)
+} gp_reading_t;
+
+/**
+ * @brief Restore the pairing and send pending commissioning frames
+ *
+ * Uses the RTC copy after deep sleep, NVS after a power loss. If pairing
+ * was requested during the last wake, creates the SrcID and key (first
+ * pairing only) and sends the commissioning frames now, before the
+ * Zigbee stack owns the radio. Call after nvs_flash_init().
+ *
+ * @return ESP_OK on success (unpaired on NVS errors)
+ */
+esp_err_t gp_uplink_init(void);
+
+/**
+ * @brief Send this wake's report as a GPDF instead of starting Zigbee
+ *
+ * True when paired and fewer than GP_FULL_WAKE_REPORTS frames went out
+ * since the last full wake. The caller also requires the deep-sleep
+ * profile.
+ */
+bool gp_uplink_use_this_wake(void);
+
+/**
+ * @brief Send a reading (GP_TX_REPEATS copies of one frame)
+ * @param reading Reading in on-air units
+ * @return ESP_OK if the frame went out, ESP_ERR_INVALID_STATE if not
+ *         paired, or the radio error
+ */
+esp_err_t gp_uplink_send(const gp_reading_t *reading);
+
+/**
+ * @brief A full ZED wake reached the network
+ *
+ * Restarts the count towards the next full wake and follows the network
+ * to a new channel.
+ *
+ * @param channel Current Zigbee channel (0 = unknown)
+ */
+void gp_uplink_full_wake(uint8_t channel);
+
+/**
+ * @brief Coordinator wrote the gpUplink attribute (Zigbee task)
+ *
+ * true: (re)send the commissioning frames at the next wake, keeping an
+ * existing key. false: forget the pairing, every wake is a full wake.
+ *
+ * @param enable Uplink wanted
+ * @param channel Current Zigbee channel (the sink listens there)
+ * @return ESP_OK if stored, ESP_ERR_INVALID_ARG without a channel
+ */
+esp_err_t gp_uplink_request(bool enable, uint8_t channel);
+
+/**
+ * @brief Uplink requested (value of the gpUplink attribute)
+ */
+bool gp_uplink_requested(void);
+
+/**
+ * @brief Commissioning frames due at the next wake
+ *
+ * The caller shortens the coming deep sleep (GP_COMMISSION_SLEEP_SEC) so
+ * they go out while the sink is still in commissioning mode.
+ */
+bool gp_uplink_commission_pending(void);
+
+/**
+ * @brief GPD SrcID once commissioned (0 = not paired)
+ */
+uint32_t gp_uplink_src_id(void);
+
+#endif // GP_UPLINK_H
@@ -0,0 +1,484 @@
+/*
+ * Glyph C6 Monitor - Flash History Log
+ *
+ * Version: 1.0.0
+ */
+
+#include "history_log.h"
+#include "system_config.h"
+#include "binlog.h"
+#include "esp_attr.h"
+#include "esp_partition.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <string.h>
+
+static const char *TAG = "HISTORY";
+
+// ============================================================================
+// FLASH LAYOUT
+// ============================================================================
+
+#define HISTORY_PAGE_SIZE        4096                  // One flash sector
+#define HISTORY_MAX_PAGES        64                    // RAM index capacity (256 KB)
+#define HISTORY_PAGE_MAGIC       0x324C4847            // "GHL2": reading_codec records
+
+// Page header: absolute first reading of the page
+typedef struct __attribute__((packed)) {
+    uint32_t magic;
+    uint32_t seq;                 // Monotonic page sequence (ring order)
+    uint32_t time;
+    uint16_t moisture_centi;
+    int16_t temp_centi;
+} history_page_header_t;
+
+// Header, then reading_codec records up to the first erased byte
+#define HISTORY_RECORDS_START    ((uint16_t)sizeof(history_page_header_t))
+
+// ============================================================================
+// RTC MEMORY (staging buffer, persists across deep sleep)
+// ============================================================================
+
+// First reading absolute, the rest as records (the page format)
+typedef struct {
+    uint16_t count;               // Staged readings
+    uint16_t bytes;               // Record bytes after the first reading
+    reading_codec_state_t first;  // First staged reading (decoder start)
+    reading_codec_state_t last;   // Last staged reading (encoder position)
+    uint8_t records[HISTORY_STAGING_BYTES];
+} history_staging_t;
+
+static RTC_DATA_ATTR history_staging_t rtc_staging;
+
+// ============================================================================
+// PRIVATE VARIABLES (RAM index)
+// ============================================================================
+
+typedef struct {
+    bool valid;
+    uint32_t seq;
+    uint32_t first_time;
+} history_page_info_t;
+
+static const esp_partition_t *partition = NULL;
+static SemaphoreHandle_t history_mutex = NULL;
+
+static history_page_info_t page_index[HISTORY_MAX_PAGES];
+static uint16_t page_count = 0;
+static bool index_ready = false;
+static bool head_valid = false;           // At least one page written
+static uint16_t head_page = 0;            // Page currently appended to
+static uint16_t head_offset = 0;          // End of the records in head page
+static uint16_t head_records = 0;         // Delta records in head page
+static reading_codec_state_t head_state;  // Last reading in head page
+static uint32_t next_seq = 1;
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+static size_t page_address(uint16_t page)
+{
+    return (size_t)page * HISTORY_PAGE_SIZE;
+}
+
+static void header_reading(const history_page_header_t *header, history_reading_t *reading)
+{
+    reading->time = header->time;
+    reading->moisture_centi = header->moisture_centi;
+    reading->temp_centi = header->temp_centi;
+}
+
+/**
+ * @brief Decode the record at a byte offset of a page
+ * @return Bytes it takes, 0 past the page's last record
+ */
+static size_t read_record(uint16_t page, uint16_t offset, reading_codec_state_t *state, history_reading_t *reading)
+{
+    uint8_t buf[READING_CODEC_MAX_RECORD];
+    size_t len = HISTORY_PAGE_SIZE - offset;
+    if (len > sizeof(buf)) {
+        len = sizeof(buf);
+    }
+    if (len == 0 || esp_partition_read(partition, page_address(page) + offset, buf, len) != ESP_OK) {
+        return 0;
+    }
+    return reading_codec_decode(state, buf, len, reading);
+}
+
+/**
+ * @brief Drop the oldest staged reading (the next one becomes absolute)
+ */
+static void staging_drop_oldest(void)
+{
+    history_reading_t next;
+    size_t used = 0;
+    if (rtc_staging.count > 1) {
+        used = reading_codec_decode(&rtc_staging.first, rtc_staging.records, rtc_staging.bytes, &next);
+    }
+    if (used == 0) {
+        rtc_staging.count = 0;
+        return;
+    }
+    memmove(rtc_staging.records, &rtc_staging.records[used], rtc_staging.bytes - used);
+    rtc_staging.bytes = (uint16_t)(rtc_staging.bytes - used);
+    rtc_staging.count--;
+}
+
+/**
+ * @brief Build RAM index from page headers and locate the append position
+ */
+static esp_err_t build_index(void)
+{
+    if (index_ready) {
+        return ESP_OK;
+    }
+    if (!partition) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    uint32_t max_seq = 0;
+    head_valid = false;
+
+    for (uint16_t i = 0; i < page_count; i++) {
+        history_page_header_t header;
+        page_index[i].valid = false;
+        if (esp_partition_read(partition, page_address(i), &header, sizeof(header)) != ESP_OK ||
+            header.magic != HISTORY_PAGE_MAGIC) {
+            continue;
+        }
+        page_index[i].valid = true;
+        page_index[i].seq = header.seq;
+        page_index[i].first_time = header.time;
+
+        if (!head_valid || header.seq > max_seq) {
+            max_seq = header.seq;
+            head_page = i;
+            head_valid = true;
+            history_reading_t first;
+            header_reading(&header, &first);
+            reading_codec_begin(&head_state, &first);
+        }
+    }
+
+    // Walk the head page to find the end of its records
+    head_offset = HISTORY_RECORDS_START;
+    head_records = 0;
+    if (head_valid) {
+        history_reading_t reading;
+        size_t used;
+        while ((used = read_record(head_page, head_offset, &head_state, &reading)) > 0) {
+            head_offset = (uint16_t)(head_offset + used);
+            head_records++;
+        }
+        next_seq = max_seq + 1;
+    }
+
+    index_ready = true;
+    BLOG_I(TAG, "Index: %u pages, head=%u (%u records, %u bytes), seq=%" PRIu32,
+             page_count, head_page, head_records, head_offset, next_seq);
+    return ESP_OK;
+}
+
+/**
+ * @brief Erase the next page in the ring and start it with an absolute reading
+ */
+static esp_err_t open_page(const history_reading_t *reading)
+{
+    uint16_t page = head_valid ? (uint16_t)((head_page + 1) % page_count) : 0;
+
+    esp_err_t ret = esp_partition_erase_range(partition, page_address(page), HISTORY_PAGE_SIZE);
+    if (ret != ESP_OK) {
+        BLOG_E(TAG, "Page %u erase failed: %s", page, esp_err_to_name(ret));
+        return ret;
+    }
+
+    history_page_header_t header = {
+        .magic = HISTORY_PAGE_MAGIC,
+        .seq = next_seq,
+        .time = reading->time,
+        .moisture_centi = reading->moisture_centi,
+        .temp_centi = reading->temp_centi,
+    };
+    ret = esp_partition_write(partition, page_address(page), &header, sizeof(header));
+    if (ret != ESP_OK) {
+        BLOG_E(TAG, "Page %u header write failed: %s", page, esp_err_to_name(ret));
+        page_index[page].valid = false;
+        return ret;
+    }
+
+    page_index[page].valid = true;
+    page_index[page].seq = next_seq++;
+    page_index[page].first_time = reading->time;
+    head_page = page;
+    head_valid = true;
+    head_offset = HISTORY_RECORDS_START;
+    head_records = 0;
+    reading_codec_begin(&head_state, reading);
+    return ESP_OK;
+}
+
+/**
+ * @brief Program a run of encoded records into the head page
+ */
+static esp_err_t write_records(uint16_t offset, const uint8_t *records, size_t len)
+{
+    if (len == 0) {
+        return ESP_OK;
+    }
+    return esp_partition_write(partition, page_address(head_page) + offset, records, len);
+}
+
+/**
+ * @brief Write staged readings to flash (caller holds history_mutex)
+ */
+static esp_err_t flush_locked(void)
+{
+    if (rtc_staging.count == 0) {
+        return ESP_OK;
+    }
+
+    esp_err_t ret = build_index();
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    // Staged records are re-encoded against the head page: only the first
+    // two can differ from (and outgrow) their staged form
+    uint8_t batch[HISTORY_STAGING_BYTES + 2 * READING_CODEC_MAX_RECORD];
+    size_t batch_len = 0;
+    uint16_t batch_start = head_offset;
+    reading_codec_state_t staged = rtc_staging.first;
+    history_reading_t r = staged.last;
+    size_t pos = 0;
+
+    for (uint16_t i = 0; i < rtc_staging.count && ret == ESP_OK; i++) {
+        if (i > 0) {
+            size_t used = reading_codec_decode(&staged, &rtc_staging.records[pos], rtc_staging.bytes - pos, &r);
+            if (used == 0) {
+                break;
+            }
+            pos += used;
+        }
+
+        // A clock reset (power loss) or a full page starts a new page
+        size_t n = 0;
+        if (head_valid && r.time >= head_state.last.time) {
+            size_t room = HISTORY_PAGE_SIZE - head_offset;
+            if (room > sizeof(batch) - batch_len) {
+                room = sizeof(batch) - batch_len;
+            }
+            n = reading_codec_encode(&head_state, &r, &batch[batch_len], room);
+        }
+        if (n == 0) {
+            ret = write_records(batch_start, batch, batch_len);
+            if (ret == ESP_OK) {
+                ret = open_page(&r);
+            }
+            batch_len = 0;
+            batch_start = head_offset;
+            continue;
+        }
+
+        batch_len += n;
+        head_offset = (uint16_t)(head_offset + n);
+        head_records++;
+    }
+
+    if (ret == ESP_OK) {
+        ret = write_records(batch_start, batch, batch_len);
+    }
+
+    if (ret != ESP_OK) {
+        // Index no longer matches flash - rebuild from flash on next use
+        index_ready = false;
+        BLOG_E(TAG, "Flush failed: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    BLOG_I(TAG, "Flushed %u readings in %u bytes (page %u, %u records, %u/%u bytes)",
+             rtc_staging.count, rtc_staging.bytes + READING_CODEC_ABSOLUTE_LEN, head_page,
+             head_records, head_offset, HISTORY_PAGE_SIZE);
+    rtc_staging.count = 0;
+    return ESP_OK;
+}
+
+static void cursor_next_page(history_cursor_t *cursor)
+{
+    cursor->page = (uint16_t)((cursor->page + 1) % page_count);
+    cursor->offset = 0;
+    cursor->pages_left--;
+}
+
+// ============================================================================
+// PUBLIC FUNCTIONS
+// ============================================================================
+
+esp_err_t history_log_init(void)
+{
+    if (!history_mutex) {
+        history_mutex = xSemaphoreCreateMutex();
+        if (!history_mutex) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY,
+                                         HISTORY_PARTITION_LABEL);
+    if (!partition) {
+        BLOG_W(TAG, "No '%s' partition - history disabled", HISTORY_PARTITION_LABEL);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    page_count = (uint16_t)(partition->size / HISTORY_PAGE_SIZE);
+    if (page_count > HISTORY_MAX_PAGES) {
+        page_count = HISTORY_MAX_PAGES;
+    }
+    if (page_count < 2) {
+        BLOG_W(TAG, "History partition too small (%" PRIu32 " bytes)", partition->size);
+        partition = NULL;
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    // Index is built lazily on first flush/query (keeps short wakes cheap)
+    BLOG_I(TAG, "History log: %u pages x %u bytes, %u staged",
+             page_count, HISTORY_PAGE_SIZE, rtc_staging.count);
+    return ESP_OK;
+}
+
+esp_err_t history_log_append(const history_reading_t *reading)
+{
+    if (!reading) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    size_t n = 0;
+    while (rtc_staging.count > 0 &&
+           (n = reading_codec_encode(&rtc_staging.last, reading, &rtc_staging.records[rtc_staging.bytes],
+                                     HISTORY_STAGING_BYTES - rtc_staging.bytes)) == 0) {
+        // Previous flush failed - drop oldest staged reading
+        staging_drop_oldest();
+    }
+    if (rtc_staging.count == 0) {
+        // Keeps the last batch's time step: the next record stays short
+        rtc_staging.first.last = *reading;
+        rtc_staging.first.interval = rtc_staging.last.interval;
+        rtc_staging.last = rtc_staging.first;
+        rtc_staging.bytes = 0;
+    }
+    rtc_staging.bytes = (uint16_t)(rtc_staging.bytes + n);
+    rtc_staging.count++;
+
+    if (HISTORY_STAGING_BYTES - rtc_staging.bytes >= READING_CODEC_MAX_RECORD) {
+        return ESP_OK;
+    }
+    return history_log_flush();
+}
+
+esp_err_t history_log_flush(void)
+{
+    if (!partition || !history_mutex) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    xSemaphoreTake(history_mutex, portMAX_DELAY);
+    esp_err_t ret = flush_locked();
+    xSemaphoreGive(history_mutex);
+    return ret;
+}
+
+esp_err_t history_log_query(uint32_t start_time, uint32_t end_time, history_cursor_t *cursor)
+{
+    if (!cursor || start_time > end_time) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memset(cursor, 0, sizeof(*cursor));
+
+    if (!partition || !history_mutex) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    xSemaphoreTake(history_mutex, portMAX_DELAY);
+    esp_err_t ret = flush_locked();
+    if (ret == ESP_OK) {
+        ret = build_index();
+    }
+    if (ret == ESP_OK && head_valid) {
+        // Oldest page follows the head in ring order
+        cursor->active = true;
+        cursor->page = (uint16_t)((head_page + 1) % page_count);
+        cursor->pages_left = page_count;
+        cursor->start_time = start_time;
+        cursor->end_time = end_time;
+    }
+    xSemaphoreGive(history_mutex);
+    return ret;
+}
+
+size_t history_log_read(history_cursor_t *cursor, history_reading_t *out, size_t max)
+{
+    size_t n = 0;
+
+    if (!cursor || !out || !cursor->active) {
+        return 0;
+    }
+
+    xSemaphoreTake(history_mutex, portMAX_DELAY);
+
+    while (n < max && cursor->pages_left > 0) {
+        uint16_t page = cursor->page;
+
+        if (cursor->offset == 0) {
+            if (!page_index[page].valid) {
+                cursor_next_page(cursor);
+                continue;
+            }
+
+            // Whole page older than the range: the next (newer) page starts before it
+            uint16_t next = (uint16_t)((page + 1) % page_count);
+            if (page != head_page && page_index[next].valid &&
+                page_index[next].first_time < cursor->start_time) {
+                cursor_next_page(cursor);
+                continue;
+            }
+
+            history_page_header_t header;
+            if (page_index[page].first_time > cursor->end_time ||
+                esp_partition_read(partition, page_address(page), &header, sizeof(header)) != ESP_OK) {
+                cursor->pages_left = 0;
+                break;
+            }
+            history_reading_t first;
+            header_reading(&header, &first);
+            reading_codec_begin(&cursor->state, &first);
+            cursor->offset = HISTORY_RECORDS_START;
+        } else {
+            uint16_t limit = (page == head_page) ? head_offset : HISTORY_PAGE_SIZE;
+            history_reading_t reading;
+            size_t used = 0;
+            if (cursor->offset < limit) {
+                used = read_record(page, cursor->offset, &cursor->state, &reading);
+            }
+            if (used == 0) {
+                cursor_next_page(cursor);
+                continue;
+            }
+            cursor->offset = (uint16_t)(cursor->offset + used);
+        }
+
+        if (cursor->state.last.time > cursor->end_time) {
+            cursor->pages_left = 0;
+            break;
+        }
+        if (cursor->state.last.time >= cursor->start_time) {
+            out[n++] = cursor->state.last;
+        }
+    }
+
+    if (cursor->pages_left == 0) {
+        cursor->active = false;
+    }
+
+    xSemaphoreGive(history_mutex);
+    return n;
+}
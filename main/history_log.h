@@ -0,0 +1,88 @@
+/*
+ * Glyph C6 Monitor - Flash History Log
+ *
+ * Version: 1.0.0
+ *
+ * Append-only time series of readings in a dedicated flash partition
+ * ("history" in partitions.csv), so readings survive a coordinator outage
+ * and can be pulled later.
+ *
+ * - Readings are staged in RTC memory, encoded, and written to flash in
+ *   batches (one program per full HISTORY_STAGING_BYTES buffer, not per
+ *   sample)
+ * - The partition is a ring of 4 KB pages; the oldest page is erased
+ *   when the log wraps, so erases rotate evenly over all sectors
+ * - Each page starts with a header holding an absolute reading; the
+ *   following records are reading_codec.h delta records (1-3 bytes for
+ *   a typical reading), ended by erased flash
+ * - A small RAM index (per-page sequence and start time) is built lazily
+ *   on first flush or query and serves range queries by time
+ *
+ * Units: time in RTC seconds (deep_sleep_get_time_sec), moisture in
+ * 0.01 %, temperature in 0.01 °C.
+ */
+
+#ifndef HISTORY_LOG_H
+#define HISTORY_LOG_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "reading_codec.h"
+
+// Range query cursor (opaque to callers)
+typedef struct {
+    bool active;
+    uint16_t pages_left;          // Pages still to visit (ring order)
+    uint16_t page;                // Current page slot
+    uint16_t offset;              // Next record's byte offset within page (0 = header)
+    uint32_t start_time;          // Range start (inclusive)
+    uint32_t end_time;            // Range end (inclusive)
+    reading_codec_state_t state;  // Running values for delta decoding
+} history_cursor_t;
+
+/**
+ * @brief Initialize history log (locates the flash partition)
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND if the partition is missing
+ */
+esp_err_t history_log_init(void);
+
+/**
+ * @brief Append one reading to the RTC staging buffer
+ *
+ * Flushes the staging buffer to flash when it is full.
+ *
+ * @param reading Reading to store
+ * @return ESP_OK on success, error code from the flush otherwise
+ */
+esp_err_t history_log_append(const history_reading_t *reading);
+
+/**
+ * @brief Write all staged readings to flash
+ * @return ESP_OK on success (also when nothing was staged)
+ */
+esp_err_t history_log_flush(void);
+
+/**
+ * @brief Start a range query over flash history
+ *
+ * Staged readings are flushed first so the query sees everything.
+ *
+ * @param start_time Range start (RTC seconds, inclusive)
+ * @param end_time Range end (RTC seconds, inclusive)
+ * @param cursor Cursor to initialize
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t history_log_query(uint32_t start_time, uint32_t end_time, history_cursor_t *cursor);
+
+/**
+ * @brief Read the next readings of a range query
+ * @param cursor Cursor from history_log_query
+ * @param out Output readings
+ * @param max Capacity of out
+ * @return Number of readings written (0 = range exhausted)
+ */
+size_t history_log_read(history_cursor_t *cursor, history_reading_t *out, size_t max);
+
+#endif // HISTORY_LOG_H
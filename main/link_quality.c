@@ -0,0 +1,188 @@
+/*
+ * Glyph C6 Monitor - Parent Link Quality
+ *
+ * Version: 1.0.0
+ */
+
+#include "link_quality.h"
+#include "system_config.h"
+#include "binlog.h"
+#include <string.h>
+
+static const char *TAG = "LINK";
+
+// Failure fraction full scale (fail_avg units)
+#define FAIL_ONE            4096
+
+// Expected transmissions per frame (x100) by LQI, interpolated between points.
+// LQI maps roughly linearly to the 802.15.4 PER curve; the ends are clamped.
+typedef struct {
+    uint8_t lqi;
+    uint16_t cost;
+} lqi_point_t;
+
+static const lqi_point_t lqi_cost_table[] = {
+    {   0, 800 },
+    {  40, 400 },
+    {  60, 250 },
+    {  80, 170 },
+    { 110, 130 },
+    { 150, 110 },
+    { 200, 103 },
+    { 255, 101 },
+};
+
+#define LQI_COST_POINTS     (sizeof(lqi_cost_table) / sizeof(lqi_cost_table[0]))
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+static void prime(link_quality_t *lq, uint16_t parent, uint8_t lqi, int8_t rssi)
+{
+    lq->primed = true;
+    lq->parent = parent;
+    lq->lqi_avg = (uint16_t)(lqi << 4);
+    lq->rssi_avg = (int16_t)(rssi * 16);
+    lq->fail_avg = 0;
+    lq->bad_checks = 0;
+}
+
+// Judge a finished reselection: a new parent that is cheaper resets the
+// hold-off, anything else doubles it so a bad spot does not rejoin hourly
+static void finish_reselection(link_quality_t *lq, bool parent_changed)
+{
+    uint16_t cost_after = link_quality_cost(lq);
+    lq->reselecting = false;
+
+    if (parent_changed && cost_after < lq->cost_before) {
+        lq->backoff_checks = LINK_RESELECT_MIN_CHECKS;
+        BLOG_I(TAG, "Reselection found a better parent 0x%04x (cost %u -> %u)",
+               lq->parent, lq->cost_before, cost_after);
+    } else {
+        uint16_t backoff = (uint16_t)lq->backoff_checks * 2;
+        lq->backoff_checks = (uint8_t)(backoff > LINK_RESELECT_MAX_CHECKS ? LINK_RESELECT_MAX_CHECKS : backoff);
+        lq->hold_checks = lq->backoff_checks;
+        BLOG_I(TAG, "Reselection kept a %s parent (cost %u -> %u), holding %u checks",
+               parent_changed ? "no better" : "the same", lq->cost_before, cost_after, lq->hold_checks);
+    }
+}
+
+// ============================================================================
+// PUBLIC FUNCTIONS
+// ============================================================================
+
+void link_quality_reset(link_quality_t *lq)
+{
+    memset(lq, 0, sizeof(*lq));
+}
+
+void link_quality_parent_sample(link_quality_t *lq, uint16_t parent, uint8_t lqi, int8_t rssi)
+{
+    bool parent_changed = lq->primed && parent != lq->parent;
+
+    if (!lq->primed || parent_changed) {
+        prime(lq, parent, lqi, rssi);
+    } else {
+        lq->lqi_avg = (uint16_t)(lq->lqi_avg + ((int32_t)(lqi << 4) - lq->lqi_avg) / (1 << LINK_LQI_SHIFT));
+        lq->rssi_avg = (int16_t)(lq->rssi_avg + ((int32_t)rssi * 16 - lq->rssi_avg) / (1 << LINK_LQI_SHIFT));
+    }
+
+    if (lq->reselecting) {
+        finish_reselection(lq, parent_changed);
+    }
+}
+
+void link_quality_tx_result(link_quality_t *lq, bool delivered)
+{
+    int32_t target = delivered ? 0 : FAIL_ONE;
+    lq->fail_avg = (uint16_t)(lq->fail_avg + (target - (int32_t)lq->fail_avg) / (1 << LINK_FAIL_SHIFT));
+
+    lq->frames_sent++;
+    if (!delivered) {
+        lq->frames_failed++;
+    }
+    if (lq->frames_since_check < UINT16_MAX) {
+        lq->frames_since_check++;
+    }
+}
+
+uint16_t link_quality_cost_for_lqi(uint8_t lqi)
+{
+    for (size_t i = 1; i < LQI_COST_POINTS; i++) {
+        const lqi_point_t *hi = &lqi_cost_table[i];
+        if (lqi <= hi->lqi) {
+            const lqi_point_t *lo = &lqi_cost_table[i - 1];
+            int32_t span = hi->lqi - lo->lqi;
+            int32_t delta = (int32_t)hi->cost - lo->cost;
+            return (uint16_t)(lo->cost + delta * (lqi - lo->lqi) / span);
+        }
+    }
+    return lqi_cost_table[LQI_COST_POINTS - 1].cost;
+}
+
+uint16_t link_quality_cost(const link_quality_t *lq)
+{
+    uint32_t attempts = lq->primed ? link_quality_cost_for_lqi((uint8_t)(lq->lqi_avg >> 4)) : 100;
+
+    // A frame the stack gave up on was still paid for: scale by 1 / delivered fraction
+    uint32_t delivered = FAIL_ONE - (lq->fail_avg < FAIL_ONE - 64 ? lq->fail_avg : FAIL_ONE - 64);
+    uint32_t cost = attempts * FAIL_ONE / delivered;
+    return (uint16_t)(cost > UINT16_MAX ? UINT16_MAX : cost);
+}
+
+bool link_quality_check(link_quality_t *lq, uint8_t candidate_lqi)
+{
+    uint16_t frames = lq->frames_since_check;
+    lq->frames_since_check = 0;
+
+    if (!lq->primed) {
+        return false;
+    }
+
+    // A reselection whose rejoin never reported a parent counts as fruitless
+    if (lq->reselecting) {
+        finish_reselection(lq, false);
+    }
+
+    uint16_t cost = link_quality_cost(lq);
+
+    // Hysteresis: only a link that stays costly counts, a good check clears it
+    if (cost >= LINK_COST_BAD) {
+        if (lq->bad_checks < UINT8_MAX) {
+            lq->bad_checks++;
+        }
+    } else if (cost <= LINK_COST_GOOD) {
+        lq->bad_checks = 0;
+    }
+
+    if (lq->hold_checks > 0) {
+        lq->hold_checks--;
+        return false;
+    }
+
+    if (lq->bad_checks < LINK_BAD_CHECKS) {
+        return false;
+    }
+
+    // Expected saving until the next chance to reselect must beat the rejoin.
+    // With no other router heard, assume a rejoin finds an ideal link.
+    uint16_t expected = candidate_lqi ? link_quality_cost_for_lqi(candidate_lqi) : 100;
+    if (expected >= cost) {
+        return false;
+    }
+    uint32_t saving = (uint32_t)(cost - expected) * frames * LINK_RESELECT_MIN_CHECKS;
+    if (saving < (uint32_t)LINK_REJOIN_COST_FRAMES * 100) {
+        return false;
+    }
+
+    if (lq->backoff_checks < LINK_RESELECT_MIN_CHECKS) {
+        lq->backoff_checks = LINK_RESELECT_MIN_CHECKS;
+    }
+    lq->reselecting = true;
+    lq->cost_before = cost;
+    lq->hold_checks = lq->backoff_checks;
+    lq->bad_checks = 0;
+    lq->reselections++;
+    return true;
+}
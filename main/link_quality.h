@@ -0,0 +1,101 @@
+/*
+ * Glyph C6 Monitor - Parent Link Quality
+ *
+ * Version: 1.0.0
+ *
+ * Tracks the link to the Zigbee parent across wakes: parent LQI and RSSI
+ * (averaged per check) and the fraction of frames the stack failed to
+ * deliver (averaged per frame). Both fold into one figure, the expected
+ * transmissions per delivered frame, which is what every report costs in
+ * radio energy.
+ *
+ * A link whose cost stays high for several checks asks for a parent
+ * reselection (a rejoin that picks the best beacon) when the expected
+ * saving outweighs the cost of the rejoin. Hysteresis and a hold-off that
+ * doubles after a reselection that found no better parent keep the node
+ * from flapping between parents.
+ *
+ * Costs are in 0.01 transmissions (100 = every frame delivered first
+ * time). A zero-initialized state is a valid reset state, so it can live
+ * in RTC memory across deep sleep.
+ */
+
+#ifndef LINK_QUALITY_H
+#define LINK_QUALITY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Link state
+typedef struct {
+    bool primed;                  // Averages hold a parent's samples
+    bool reselecting;             // Reselection started, outcome not seen yet
+    uint16_t parent;              // Short address of the tracked parent
+    uint16_t lqi_avg;             // Parent LQI EWMA (x16)
+    int16_t rssi_avg;             // Parent RSSI EWMA (dBm x16)
+    uint16_t fail_avg;            // Undelivered frame fraction EWMA (1/4096)
+    uint16_t cost_before;         // Link cost when the reselection started
+    uint16_t frames_since_check;  // Frames sent since the previous check
+    uint8_t bad_checks;           // Consecutive checks with a costly link
+    uint8_t hold_checks;          // Checks left before another reselection
+    uint8_t backoff_checks;       // Hold-off applied at the next reselection
+    uint16_t reselections;        // Since power-on
+    uint32_t frames_sent;         // Since power-on
+    uint32_t frames_failed;       // Since power-on
+} link_quality_t;
+
+/**
+ * @brief Reset link state
+ * @param lq State to reset
+ */
+void link_quality_reset(link_quality_t *lq);
+
+/**
+ * @brief Feed one parent sample (LQI/RSSI from the neighbor table)
+ *
+ * A different parent restarts the averages. If a reselection was
+ * running, its outcome sets the hold-off for the next one.
+ *
+ * @param lq Link state
+ * @param parent Parent short address
+ * @param lqi Parent link quality (0-255)
+ * @param rssi Parent RSSI (dBm)
+ */
+void link_quality_parent_sample(link_quality_t *lq, uint16_t parent, uint8_t lqi, int8_t rssi);
+
+/**
+ * @brief Count the delivery outcome of one frame sent through the parent
+ * @param lq Link state
+ * @param delivered true if the stack confirmed delivery
+ */
+void link_quality_tx_result(link_quality_t *lq, bool delivered);
+
+/**
+ * @brief Expected transmissions per delivered frame on the current parent
+ * @param lq Link state
+ * @return Cost in 0.01 transmissions (100 = ideal link)
+ */
+uint16_t link_quality_cost(const link_quality_t *lq);
+
+/**
+ * @brief Expected transmissions per frame on a link of the given LQI
+ * @param lqi Link quality (0-255)
+ * @return Cost in 0.01 transmissions
+ */
+uint16_t link_quality_cost_for_lqi(uint8_t lqi);
+
+/**
+ * @brief Periodic check (once per wake, or per interval while awake)
+ *
+ * Starts a reselection (returns true) when the link has been costly for
+ * LINK_BAD_CHECKS checks, no hold-off is running, and the saving over
+ * the hold-off period beats LINK_REJOIN_COST_FRAMES. The caller then
+ * rejoins and feeds the new parent with link_quality_parent_sample().
+ *
+ * @param lq Link state
+ * @param candidate_lqi Best LQI of another router heard (0 = none known)
+ * @return true if the caller should reselect its parent now
+ */
+bool link_quality_check(link_quality_t *lq, uint8_t candidate_lqi);
+
+#endif // LINK_QUALITY_H
@@ -6,15 +6,13 @@
  * Version: 2.0.0 - Deep Sleep Implementation
  * 
  * Features:
- * - Deep sleep with 6-hour wake intervals
+ * - Deep sleep between readings (CONFIG_GLYPH_BATT_SAMPLE_INTERVAL_SEC)
  * - Synchronized soil + battery readings
  * - Zigbee rejoin on wake
- * - 14-18 month battery life (1000mAh)
  * 
  * Power Profile:
- * - Deep sleep: ~10µA (23.9 hours/day)
- * - Wake/read/transmit: ~50mA (4 minutes/day)
- * - Average: ~3.5 mAh/day
+ * - Charge per day and battery life are simulated by host/bench/energy_bench
+ *   (current model in host/sim/wake_sim.c); no figure here is measured
  */
 
 #include <stdio.h>
@@ -28,6 +26,7 @@
 #include "esp_chip_info.h"
 #include "esp_flash.h"
 #include "esp_check.h"
+#include "esp_attr.h"
 
 // ESP Zigbee SDK includes
 #include "esp_zigbee_core.h"
@@ -41,7 +40,21 @@
 #include "zigbee_core.h"
 #include "battery_monitoring.h"
 #include "soil_sensor.h"
+#include "ambient_sensor.h"
+#include "sensor_bus.h"
 #include "deep_sleep.h"
+#include "power_policy.h"
+#include "perf_config.h"
+#include "sample_window.h"
+#include "freshness.h"
+#include "sensor_convert.h"
+#include "watering_detect.h"
+#include "history_log.h"
+#include "binlog.h"
+#include "field_trace.h"
+#include "ota_writer.h"
+#include "gp_uplink.h"
+#include "app_loop.h"
 
 // Define missing Power Config cluster attribute IDs
 #ifndef ESP_ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_PERCENTAGE_REMAINING_ID
@@ -54,30 +67,98 @@
 
 static const char *TAG = "GLYPH_C6_SLEEP";
 
-// LED state tracking
+// LED state tracking (requested state - only driven when the profile allows it)
 static bool led_state = false;
 
-// Timing control
-static TickType_t zigbee_join_start = 0;
-static bool zigbee_join_attempted = false;
-static bool readings_complete = false;
+// Sample window spanning wake cycles (RTC memory) - one stats record per report
+static RTC_DATA_ATTR sample_window_t rtc_window;
+
+// Watering detector state (RTC memory - fed by sense wakes and full readings)
+static RTC_DATA_ATTR watering_detector_t rtc_watering;
+
+// Age of reported readings at send (RTC memory - counts since power-on)
+static RTC_DATA_ATTR freshness_histogram_t rtc_freshness;
+
+// This wake was triggered by a watering event (or end of its burst)
+static bool watering_wake = false;
+
+// Report goes out as a commissioning-free uplink frame; Zigbee not started
+static bool gp_wake = false;
+
+// Coordinator-driven OTA download running (set from the Zigbee task)
+static volatile bool ota_in_progress = false;
+
+// Wake cycle events (app_loop ids) - the loop task sleeps between them
+typedef enum {
+    WAKE_EVT_READ = 0,            // Start a reading (wake start or awake interval elapsed)
+    WAKE_EVT_SAMPLE,              // Next sample of the running reading is due
+    WAKE_EVT_JOIN_CHANGED,        // Zigbee join state changed (arg: joined)
+    WAKE_EVT_JOIN_TIMEOUT,        // Stop waiting for the network this reading
+    WAKE_EVT_LINGER_DONE,         // Linger cap reached (radio never went idle)
+    WAKE_EVT_FINISH,              // Nothing to read this wake - go back to sleep
+    WAKE_EVT_PULL_DONE,           // History pull finished
+    WAKE_EVT_PULL_TIMEOUT,        // Stop waiting for the history pull
+    WAKE_EVT_OTA_DONE,            // OTA download aborted
+    WAKE_EVT_OTA_TIMEOUT,         // Stop waiting for the OTA download
+    WAKE_EVT_RADIO_IDLE,          // Sends confirmed and parent queue drained
+    WAKE_EVT_OTA_FLASH,           // OTA page buffer full / erase-ahead due
+    WAKE_EVT_OTA_APPLY,           // OTA download finished - check and switch slots
+    WAKE_EVT_OTA_RESTART,         // Boot into the new image
+} wake_event_t;
+
+typedef enum {
+    WAKE_SAMPLING,                // Samples spaced by the profile
+    WAKE_JOINING,                 // Reading due for report, network not joined yet
+    WAKE_LINGERING,               // Report sent, radio kept up until it goes idle
+    WAKE_IDLE,                    // External power, waiting for the next reading
+    WAKE_PULL_WAIT,               // Letting a history pull finish
+    WAKE_OTA_WAIT,                // Letting an OTA download finish
+} wake_state_t;
+
+// Reading being taken, one sample per WAKE_EVT_SAMPLE
+typedef struct {
+    int samples;                  // Samples taken so far
+    int valid_soil;
+    int valid_battery;
+    int valid_ambient;
+    int32_t moisture_sum;         // Soil in 0.01 units (no soft-float on the sample path)
+    int32_t temp_sum;
+    int32_t ambient_temp_sum;     // Air in 0.01 units
+    int32_t ambient_humidity_sum;
+    float voltage_sum;
+    float percent_sum;
+    uint16_t moisture;            // Averages once all samples are in
+    int16_t temp;
+    int16_t ambient_temp;
+    uint16_t ambient_humidity;
+    float voltage;
+    float percent;
+    uint32_t acquired_ms;         // RTC time the last sample was taken
+} wake_reading_t;
+
+static wake_state_t wake_state = WAKE_SAMPLING;
+static wake_reading_t reading;
+
+// Current reading bypasses the deadband (watering event)
+static bool watering_event = false;
 
 /**
- * @brief Set LED state
+ * @brief Set LED state (forced off while the power profile disallows the LED)
  */
 static void set_led(bool state)
 {
     led_state = state;
-    gpio_set_level(GPIO_NUM_14, state ? 1 : 0);
-    ESP_LOGI(TAG, "LED: %s", state ? "ON 💡" : "OFF");
+    bool drive = state && power_policy_get_profile()->led_enabled;
+    gpio_set_level(GPIO_NUM_14, drive ? 1 : 0);
+    BLOG_I(TAG, "LED: %s%s", drive ? "ON" : "OFF", (state && !drive) ? " (suppressed on battery)" : "");
 }
 
 /**
- * @brief Initialize GPIO pins (LED + NeoPixel/I2C power)
+ * @brief Initialize GPIO pins (LED; the I2C rail belongs to sensor_bus.c)
  */
 static void gpio_init(void)
 {
-    ESP_LOGI(TAG, "Initializing GPIO pins...");
+    BLOG_I(TAG, "Initializing GPIO pins...");
 
     // Configure LED (GPIO14) as output
     gpio_config_t led_conf = {
@@ -89,94 +170,202 @@ static void gpio_init(void)
     };
     gpio_config(&led_conf);
     gpio_set_level(GPIO_NUM_14, 0);
+    
+    BLOG_I(TAG, "GPIO initialized");
+}
 
-    // Configure NeoPixel/I2C power pin as output and set HIGH
-    gpio_config_t power_conf = {
-        .pin_bit_mask = (1ULL << NEOPIXEL_I2C_POWER),
-        .mode = GPIO_MODE_OUTPUT,
-        .pull_up_en = GPIO_PULLUP_DISABLE,
-        .pull_down_en = GPIO_PULLDOWN_DISABLE,
-        .intr_type = GPIO_INTR_DISABLE,
-    };
-    gpio_config(&power_conf);
-    gpio_set_level(NEOPIXEL_I2C_POWER, 1);
+/**
+ * @brief Add one soil sample to the RTC sample window
+ */
+static void window_add_sample(const soil_data_t *soil_data)
+{
+    if (rtc_window.count == 0) {
+        sample_window_reset(&rtc_window, deep_sleep_get_time_sec());
+    }
+    sample_window_add(&rtc_window, soil_data->moisture_centi, soil_data->temperature_centi);
+}
+
+/**
+ * @brief Report statistics of the current sample window and start a new one
+ */
+static void report_window_stats(void)
+{
+    sample_window_stats_t stats;
+    uint32_t now = deep_sleep_get_time_sec();
     
-    ESP_LOGI(TAG, "GPIO initialized - NeoPixel/I2C Power: ON");
+    if (!sample_window_get_stats(&rtc_window, now, &stats)) {
+        return;
+    }
+    
+    uint8_t record[SAMPLE_WINDOW_RECORD_LEN];
+    size_t len = sample_window_encode(&stats, record, sizeof(record));
+    if (zigbee_core_update_window_stats(record, len) == ESP_OK) {
+        BLOG_I(TAG, "  Window: %u samples over %u min, moisture %u-%u (sd %u)",
+                 stats.count, stats.duration_min, stats.moisture_min, stats.moisture_max,
+                 stats.moisture_stddev);
+        sample_window_reset(&rtc_window, now);
+    }
 }
 
 /**
- * @brief Take multiple sensor samples and average them (direct hardware reads)
+ * @brief Feed a moisture reading to the watering detector
+ * @return true if a watering event started or its burst just completed
+ */
+static bool watering_update(uint16_t moisture_centi)
+{
+    bool burst_done = false;
+    bool event = watering_detect_update(&rtc_watering, moisture_centi, &burst_done);
+    return event || burst_done;
+}
+
+/**
+ * @brief Cap the next deep sleep for watering sense wakes / burst sampling
+ */
+static void watering_schedule_sleep(void)
+{
+    if (watering_detect_in_burst(&rtc_watering)) {
+        deep_sleep_set_max_sleep(WATERING_BURST_INTERVAL_SEC);
+    } else {
+        deep_sleep_set_max_sleep(perf_config_get(PERF_PARAM_SENSE_INTERVAL_SEC));
+    }
+}
+
+/**
+ * @brief Radio-free sense wake between readings
  * 
- * This function performs fresh I2C/ADC reads for each sample.
- * No background tasks needed - suitable for deep sleep mode.
+ * Takes one quick moisture sample and feeds the watering detector. If
+ * nothing happened the device goes straight back to deep sleep without
+ * ever starting the Zigbee stack. On a watering event (or the end of
+ * its burst) the wake continues into a full reading and immediate report.
  */
-static bool read_averaged_sensors(float *avg_moisture, float *avg_temp, float *avg_voltage, float *avg_battery_percent)
+static void sense_only_wake(void)
 {
-    ESP_LOGI(TAG, "");
-    ESP_LOGI(TAG, "📊 Taking %d sensor samples (averaging for accuracy)...", NUM_SENSOR_SAMPLES);
+    // Moisture conversion only; the rail stays up if a reading follows
+    soil_data_t soil_data;
+    sensor_bus_acquire(SENSOR_BUS_SENSE);
+    if (soil_sensor_get_acquired(&soil_data) != ESP_OK) {
+        BLOG_W(TAG, "Sense wake: soil read failed");
+        sensor_bus_power_off();
+        watering_schedule_sleep();
+        deep_sleep_enter();
+        return;
+    }
     
-    float moisture_sum = 0.0f, temp_sum = 0.0f, voltage_sum = 0.0f, percent_sum = 0.0f;
-    int valid_soil_samples = 0;
-    int valid_battery_samples = 0;
+    window_add_sample(&soil_data);
+    BLOG_I(TAG, "Sense wake: " SENSOR_CENTI_FMT "%% moisture", SENSOR_CENTI_ARGS(soil_data.moisture_centi));
     
-    for (int i = 0; i < NUM_SENSOR_SAMPLES; i++) {
-        ESP_LOGI(TAG, "  Sample %d/%d...", i + 1, NUM_SENSOR_SAMPLES);
-        
-        // Read soil sensor directly (fresh I2C transaction)
-        soil_data_t soil_data;
-        if (soil_sensor_read_all(&soil_data) == ESP_OK) {
-            moisture_sum += soil_data.moisture_percent;
-            temp_sum += soil_data.temperature_c;
-            valid_soil_samples++;
-            ESP_LOGI(TAG, "    Soil: %.1f%% moisture, %.1f°C", 
-                     soil_data.moisture_percent, soil_data.temperature_c);
-        }
-        
-        // Read battery directly (fresh ADC read)
-        float voltage, percent;
-        if (battery_read(&voltage, &percent) == ESP_OK) {
-            voltage_sum += voltage;
-            percent_sum += percent;
-            valid_battery_samples++;
-            ESP_LOGI(TAG, "    Battery: %.2fV (%.1f%%)", voltage, percent);
-        }
-        
-        // Wait between samples for stability
-        if (i < NUM_SENSOR_SAMPLES - 1) {
-            vTaskDelay(pdMS_TO_TICKS(SAMPLE_INTERVAL_MS));
-        }
+    if (watering_update(soil_data.moisture_centi)) {
+        watering_wake = true;
+        return;
+    }
+    
+    sensor_bus_power_off();
+    watering_schedule_sleep();
+    deep_sleep_enter();
+}
+
+/**
+ * @brief Take one sample of the running reading (direct hardware reads)
+ * 
+ * Each sample is one scheduled acquisition of every I2C sensor (their
+ * conversions overlap) plus a fresh ADC read. The event loop sleeps for
+ * the profile's sample spacing between samples instead of blocking in a
+ * delay.
+ */
+static void take_sample(void)
+{
+    reading.samples++;
+    BLOG_I(TAG, "  Sample %d/%d...", reading.samples, power_policy_get_profile()->num_samples);
+    
+    // All I2C conversions in one pass, then the results per driver
+    sensor_bus_acquire(SENSOR_BUS_READING);
+    soil_data_t soil_data;
+    if (soil_sensor_get_acquired(&soil_data) == ESP_OK) {
+        reading.moisture_sum += soil_data.moisture_centi;
+        reading.temp_sum += soil_data.temperature_centi;
+        reading.valid_soil++;
+        window_add_sample(&soil_data);
+        BLOG_I(TAG, "    Soil: " SENSOR_CENTI_FMT "%% moisture, " SENSOR_CENTI_FMT "°C",
+                 SENSOR_CENTI_ARGS(soil_data.moisture_centi), SENSOR_CENTI_ARGS(soil_data.temperature_centi));
+    }
+    
+    ambient_data_t ambient;
+    if (AMBIENT_SENSOR_ENABLED && ambient_sensor_get_acquired(&ambient) == ESP_OK) {
+        reading.ambient_temp_sum += ambient.temperature_centi;
+        reading.ambient_humidity_sum += ambient.humidity_centi;
+        reading.valid_ambient++;
+        BLOG_I(TAG, "    Air: " SENSOR_CENTI_FMT "°C, " SENSOR_CENTI_FMT "%% RH",
+                 SENSOR_CENTI_ARGS(ambient.temperature_centi), SENSOR_CENTI_ARGS(ambient.humidity_centi));
+    }
+    
+    // Read battery directly (fresh ADC read)
+    float voltage, percent;
+    if (battery_read(&voltage, &percent) == ESP_OK) {
+        reading.voltage_sum += voltage;
+        reading.percent_sum += percent;
+        reading.valid_battery++;
+        BLOG_I(TAG, "    Battery: %d mV (%d%%)", (int)(voltage * 1000.0f), (int)percent);
+    }
+
+    // The averaged reading is as fresh as its last sample
+    reading.acquired_ms = deep_sleep_get_time_ms();
+}
+
+/**
+ * @brief Average the samples of the finished reading
+ * @return true if both soil and battery had at least one valid sample
+ */
+static bool average_reading(void)
+{
+    if (reading.valid_soil > 0) {
+        reading.moisture = (uint16_t)(reading.moisture_sum / reading.valid_soil);
+        reading.temp = (int16_t)(reading.temp_sum / reading.valid_soil);
     }
     
-    // Calculate averages
-    if (valid_soil_samples > 0) {
-        *avg_moisture = moisture_sum / valid_soil_samples;
-        *avg_temp = temp_sum / valid_soil_samples;
+    if (reading.valid_ambient > 0) {
+        reading.ambient_temp = (int16_t)(reading.ambient_temp_sum / reading.valid_ambient);
+        reading.ambient_humidity = (uint16_t)(reading.ambient_humidity_sum / reading.valid_ambient);
     }
     
-    if (valid_battery_samples > 0) {
-        *avg_voltage = voltage_sum / valid_battery_samples;
-        *avg_battery_percent = percent_sum / valid_battery_samples;
+    if (reading.valid_battery > 0) {
+        reading.voltage = reading.voltage_sum / reading.valid_battery;
+        reading.percent = reading.percent_sum / reading.valid_battery;
     }
     
-    ESP_LOGI(TAG, "");
-    ESP_LOGI(TAG, "📈 Averaged Results (%d samples):", NUM_SENSOR_SAMPLES);
-    ESP_LOGI(TAG, "  Soil: %.1f%% moisture, %.1f°C", *avg_moisture, *avg_temp);
-    ESP_LOGI(TAG, "  Battery: %.2fV (%.1f%%)", *avg_voltage, *avg_battery_percent);
+    BLOG_I(TAG, "Averaged Results (%d samples):", reading.samples);
+    BLOG_I(TAG, "  Soil: " SENSOR_CENTI_FMT "%% moisture, " SENSOR_CENTI_FMT "°C",
+             SENSOR_CENTI_ARGS(reading.moisture), SENSOR_CENTI_ARGS(reading.temp));
+    BLOG_I(TAG, "  Battery: %d mV (%d%%)", (int)(reading.voltage * 1000.0f), (int)reading.percent);
     
-    return (valid_soil_samples > 0 && valid_battery_samples > 0);
+    return (reading.valid_soil > 0 && reading.valid_battery > 0);
+}
+
+/**
+ * @brief Report when the reading was taken and sent, and count its age
+ */
+static void report_freshness(uint32_t acquired_ms)
+{
+    uint32_t sent_ms = deep_sleep_get_time_ms();
+    uint32_t age_ms = freshness_age_ms(acquired_ms, sent_ms);
+    freshness_record(&rtc_freshness, age_ms);
+    
+    uint8_t record[FRESHNESS_RECORD_LEN];
+    size_t len = freshness_encode(&rtc_freshness, acquired_ms, sent_ms, record, sizeof(record));
+    if (zigbee_core_update_freshness(record, len) == ESP_OK) {
+        BLOG_I(TAG, "  Reading age at send: %" PRIu32 " ms", age_ms);
+    }
 }
 
 /**
  * @brief Report averaged sensor data to Zigbee
  */
-static void report_sensor_data(float moisture, float temp, float voltage, float percent)
+static void report_sensor_data(uint16_t moisture, int16_t temp, float voltage, float percent,
+                               uint32_t acquired_ms)
 {
-    ESP_LOGI(TAG, "");
-    ESP_LOGI(TAG, "📊 Reporting averaged sensor data to Zigbee...");
+    BLOG_I(TAG, "Reporting averaged sensor data to Zigbee...");
     
     // Report battery percentage
-    uint16_t battery_percent_raw = (uint16_t)(percent * 2.0f);
-    uint8_t battery_percent = (battery_percent_raw <= 200) ? (uint8_t)battery_percent_raw : 200;
+    uint8_t battery_percent = sensor_convert_zcl_battery_percent(percent);
     
     esp_zb_zcl_status_t status = esp_zb_zcl_set_attribute_val(
         HA_ESP_SENSOR_ENDPOINT,
@@ -188,13 +377,12 @@ static void report_sensor_data(float moisture, float temp, float voltage, float
     );
     
     if (status == ESP_ZB_ZCL_STATUS_SUCCESS) {
-        ESP_LOGI(TAG, "  ✅ Battery: %.2fV (%.1f%%)", voltage, percent);
+        BLOG_I(TAG, "  Battery: %d mV (%d%%)", (int)(voltage * 1000.0f), (int)percent);
     }
     
     // Report battery voltage
-    uint16_t battery_voltage_raw = (uint16_t)(voltage * 10.0f);
-    if (battery_voltage_raw <= 255) {
-        uint8_t battery_voltage_dv = (uint8_t)battery_voltage_raw;
+    uint8_t battery_voltage_dv;
+    if (sensor_convert_zcl_battery_voltage(voltage, &battery_voltage_dv)) {
         esp_zb_zcl_set_attribute_val(
             HA_ESP_SENSOR_ENDPOINT,
             ESP_ZB_ZCL_CLUSTER_ID_POWER_CONFIG,
@@ -208,13 +396,36 @@ static void report_sensor_data(float moisture, float temp, float voltage, float
     // Report moisture
     esp_err_t ret = zigbee_core_update_soil_moisture(moisture);
     if (ret == ESP_OK) {
-        ESP_LOGI(TAG, "  ✅ Soil: %.1f%% moisture, %.1f°C", moisture, temp);
+        BLOG_I(TAG, "  Soil: " SENSOR_CENTI_FMT "%% moisture, " SENSOR_CENTI_FMT "°C",
+                 SENSOR_CENTI_ARGS(moisture), SENSOR_CENTI_ARGS(temp));
     }
     
     // Report temperature
     zigbee_core_update_soil_temperature(temp);
     
-    ESP_LOGI(TAG, "📊 Averaged sensor data reported to Zigbee");
+    // Air around the plant (ambient endpoint), if the sensor answered
+    if (AMBIENT_SENSOR_ENABLED && reading.valid_ambient > 0) {
+        zigbee_core_update_ambient(reading.ambient_temp, reading.ambient_humidity);
+    }
+    
+    // Acquisition and send time of the values just reported
+    report_freshness(acquired_ms);
+    
+    // Statistics of all samples since the previous report
+    report_window_stats();
+    
+    // Power source (sends an explicit report only when it changed)
+    zigbee_core_update_power_source(power_policy_get_source() == POWER_SOURCE_EXTERNAL);
+    
+    BLOG_I(TAG, "Averaged sensor data reported to Zigbee");
+}
+
+/**
+ * @brief OTA page ready callback (Zigbee task context)
+ */
+static void ota_flash_callback(void)
+{
+    app_loop_post(WAKE_EVT_OTA_FLASH, 0);
 }
 
 /**
@@ -224,160 +435,451 @@ static void report_sensor_data(float moisture, float temp, float voltage, float
  * - Z2M (coordinator) pushes updates when available
  * - Device receives callbacks during download
  * - No manual query needed!
+ * 
+ * Blocks only go into RAM page buffers here (ota_writer.h); erasing,
+ * programming and the slot switch run in the app loop, so the Zigbee task
+ * never waits on flash. An error return makes the stack abort the download.
  */
-static void ota_upgrade_status_handler(esp_zb_zcl_ota_upgrade_value_message_t *message)
+static esp_err_t ota_upgrade_status_handler(esp_zb_zcl_ota_upgrade_value_message_t *message)
 {
+    static uint32_t block_count = 0;
+    esp_err_t ret = ESP_OK;
+    
     if (!message) {
-        return;
+        return ESP_FAIL;
     }
     
-    ESP_LOGI(TAG, "📦 OTA Status: %d", message->info.status);
-    
     switch (message->info.status) {
     case ESP_ZB_ZCL_STATUS_SUCCESS:
         switch (message->upgrade_status) {
         case ESP_ZB_ZCL_OTA_UPGRADE_STATUS_START:
-            ESP_LOGI(TAG, "🔄 OTA Download started");
-            ESP_LOGI(TAG, "  Firmware size: %lu bytes", message->ota_header.image_size);
-            ESP_LOGI(TAG, "  Version: 0x%08lx", message->ota_header.file_version);
+            if (!power_policy_get_profile()->ota_allowed) {
+                // Solar node in the dark: the coordinator offers it again later
+                BLOG_I(TAG, "OTA deferred - %s profile", power_policy_get_profile()->name);
+                return ESP_FAIL;
+            }
+            ota_in_progress = true;
+            block_count = 0;
+            BLOG_I(TAG, "OTA Download started");
+            BLOG_I(TAG, "  Firmware size: %" PRIu32 " bytes", message->ota_header.image_size);
+            BLOG_I(TAG, "  Version: 0x%08" PRIx32, message->ota_header.file_version);
+            ret = ota_writer_begin(ota_flash_callback);
             break;
             
         case ESP_ZB_ZCL_OTA_UPGRADE_STATUS_RECEIVE:
-            // Log progress every ~10 blocks to avoid spam
-            static uint32_t block_count = 0;
+            ret = ota_writer_write(message->payload, message->payload_size);
             block_count++;
-            if (block_count % 10 == 0) {
-                ESP_LOGI(TAG, "  Downloading... received %u blocks", block_count);
+            if (block_count % OTA_PROGRESS_LOG_BLOCKS == 0) {
+                ota_writer_stats_t stats;
+                ota_writer_get_stats(&stats);
+                BLOG_I(TAG, "  Downloading... %" PRIu32 " blocks, %" PRIu32 "/%" PRIu32 " bytes (%" PRIu32 " written)",
+                         block_count, stats.received, stats.image_size, stats.written);
             }
             break;
             
         case ESP_ZB_ZCL_OTA_UPGRADE_STATUS_APPLY:
-            ESP_LOGI(TAG, "✅ OTA Download complete!");
-            ESP_LOGI(TAG, "  Applying firmware...");
+            BLOG_I(TAG, "OTA Download complete!");
             break;
             
         case ESP_ZB_ZCL_OTA_UPGRADE_STATUS_CHECK:
-            ESP_LOGI(TAG, "📋 OTA Check: Version 0x%08lx available", 
-                     message->ota_header.file_version);
+            // Image check before the upgrade end request: all bytes in, no flash error
+            ret = ota_writer_complete() ? ESP_OK : ESP_FAIL;
+            BLOG_I(TAG, "OTA Check: %s", ret == ESP_OK ? "image complete" : "image incomplete");
             break;
             
         case ESP_ZB_ZCL_OTA_UPGRADE_STATUS_FINISH:
-            ESP_LOGI(TAG, "🎉 OTA Update complete - rebooting in 3 seconds...");
-            vTaskDelay(pdMS_TO_TICKS(3000));
-            esp_restart();
+            BLOG_I(TAG, "OTA Update complete - applying image...");
+            app_loop_post(WAKE_EVT_OTA_APPLY, 0);
             break;
             
         default:
-            ESP_LOGI(TAG, "  OTA status: %d", message->upgrade_status);
+            BLOG_I(TAG, "  OTA status: %d", message->upgrade_status);
             break;
         }
         break;
         
     case ESP_ZB_ZCL_STATUS_ABORT:
-        ESP_LOGW(TAG, "❌ OTA Download aborted");
+        ota_writer_abort();
+        ota_in_progress = false;
+        app_loop_post(WAKE_EVT_OTA_DONE, 0);
+        BLOG_W(TAG, "OTA Download aborted");
         break;
         
     default:
-        ESP_LOGW(TAG, "⚠️ OTA Status error: %d", message->info.status);
+        BLOG_W(TAG, "OTA Status error: %d", message->info.status);
         break;
     }
+    
+    if (ret != ESP_OK && ota_in_progress) {
+        BLOG_E(TAG, "OTA failed at status %d: %s", message->upgrade_status, esp_err_to_name(ret));
+    }
+    return ret;
+}
+
+/**
+ * @brief Download finished - program the rest and switch slots (app loop)
+ */
+static void apply_ota(void)
+{
+    esp_err_t ret = ota_writer_finish();
+    if (ret == ESP_OK) {
+        BLOG_I(TAG, "New image selected for boot - rebooting in %d ms...", OTA_RESTART_DELAY_MS);
+        app_loop_post_after(WAKE_EVT_OTA_RESTART, OTA_RESTART_DELAY_MS);
+        return;
+    }
+    BLOG_E(TAG, "OTA image rejected: %s - keeping the running firmware", esp_err_to_name(ret));
+    ota_in_progress = false;
+    app_loop_post(WAKE_EVT_OTA_DONE, 0);
+}
+
+// ============================================================================
+// WAKE CYCLE (event loop handler)
+// ============================================================================
+
+/**
+ * @brief Log how much of each task stack was never used
+ * 
+ * Field numbers for sizing APP_LOOP_TASK_STACK and ZIGBEE_TASK_STACK.
+ */
+static void log_stack_usage(void)
+{
+    uint32_t loop_unused = app_loop_stack_unused();
+    // Uplink wakes never start the Zigbee task
+    uint32_t zigbee_unused = gp_wake ? ZIGBEE_TASK_STACK : zigbee_core_stack_unused();
+    
+    BLOG_I(TAG, "Stack unused: app loop %" PRIu32 "/%d bytes, zigbee %" PRIu32 "/%d bytes",
+             loop_unused, APP_LOOP_TASK_STACK, zigbee_unused, ZIGBEE_TASK_STACK);
+    if (loop_unused < TASK_STACK_WARN_BYTES || zigbee_unused < TASK_STACK_WARN_BYTES) {
+        BLOG_W(TAG, "Task stack almost exhausted - raise it in system_config.h");
+    }
+}
+
+static void enter_sleep(void)
+{
+    BLOG_I(TAG, "Wake cycle complete - entering deep sleep");
+    sensor_bus_power_off();
+    log_stack_usage();
+    if (gp_uplink_commission_pending()) {
+        // Commissioning frames go out at the next wake, while the sink still listens
+        deep_sleep_set_max_sleep(GP_COMMISSION_SLEEP_SEC);
+    }
+    deep_sleep_enter();
+}
+
+/**
+ * @brief Don't cut off an OTA download the coordinator started during this wake
+ */
+static void wait_for_ota(void)
+{
+    app_loop_cancel(WAKE_EVT_PULL_TIMEOUT);
+    if (ota_in_progress) {
+        wake_state = WAKE_OTA_WAIT;
+        app_loop_post_after(WAKE_EVT_OTA_TIMEOUT, OTA_DOWNLOAD_TIMEOUT_SEC * 1000UL);
+        return;  // WAKE_EVT_OTA_DONE or the timeout continues
+    }
+    enter_sleep();
+}
+
+/**
+ * @brief End of the reading part of the wake
+ * 
+ * Lets a running history pull finish before the radio goes down.
+ */
+static void finish_wake(void)
+{
+    if (zigbee_core_history_pull_active()) {
+        wake_state = WAKE_PULL_WAIT;
+        app_loop_post_after(WAKE_EVT_PULL_TIMEOUT, HISTORY_PULL_MAX_WAIT_MS);
+        return;  // WAKE_EVT_PULL_DONE or the timeout continues
+    }
+    wait_for_ota();
+}
+
+/**
+ * @brief Reading handled - deep sleep, or stay awake on external power
+ */
+static void reading_done(void)
+{
+    watering_event = false;
+    
+    // An uplink wake that found external power sleeps briefly and comes
+    // back as a full wake (the fresh profile interval is already set)
+    const power_profile_t *profile = power_policy_get_profile();
+    if (profile->deep_sleep || gp_wake) {
+        watering_schedule_sleep();
+        finish_wake();
+        return;
+    }
+    
+    // External power: stay awake and joined, sample again after the profile
+    // interval (or the burst interval while following a watering event)
+    uint32_t next_sec = watering_detect_in_burst(&rtc_watering) ?
+                        WATERING_BURST_INTERVAL_SEC : profile->sample_interval_sec;
+    BLOG_I(TAG, "%s profile - staying awake, next reading in %" PRIu32 " seconds",
+             profile->name, next_sec);
+    wake_state = WAKE_IDLE;
+    app_loop_post_after(WAKE_EVT_READ, next_sec * 1000);
+}
+
+/**
+ * @brief Send the averaged reading (network joined)
+ */
+static void report_reading(void)
+{
+    app_loop_cancel(WAKE_EVT_JOIN_TIMEOUT);
+    
+    BLOG_I(TAG, "Zigbee joined! Reporting averaged data...");
+    zigbee_device_info_t info;
+    if (zigbee_core_get_device_info(&info)) {
+        gp_uplink_full_wake(info.channel);
+    }
+    report_sensor_data(reading.moisture, reading.temp, reading.voltage, reading.percent, reading.acquired_ms);
+    if (watering_event) {
+        zigbee_core_update_watering_events(watering_detect_event_count(&rtc_watering));
+    }
+    power_policy_mark_reported(reading.moisture, reading.temp);
+    
+    BLOG_I(TAG, "Averaged data transmitted successfully!");
+    
+    // Stay awake until every send is confirmed and the parent's queue is
+    // drained (WAKE_EVT_RADIO_IDLE), at most ZIGBEE_TX_LINGER_MS
+    if (zigbee_core_radio_idle()) {
+        reading_done();
+        return;
+    }
+    wake_state = WAKE_LINGERING;
+    app_loop_post_after(WAKE_EVT_LINGER_DONE, ZIGBEE_TX_LINGER_MS);
 }
 
 /**
- * @brief Wake cycle task - handles readings, OTA, and sleep
+ * @brief Send the averaged reading as one uplink frame (no join)
+ * 
+ * The window statistics stay in RTC memory and go out with the next full
+ * wake's report.
  */
-static void wake_cycle_task(void *pvParameters)
+static void report_reading_uplink(void)
 {
-    ESP_LOGI(TAG, "");
-    ESP_LOGI(TAG, "⏰ Wake cycle started");
+    uint32_t sent_ms = deep_sleep_get_time_ms();
+    uint32_t age_ms = freshness_age_ms(reading.acquired_ms, sent_ms);
+    uint32_t age_sec = age_ms / 1000;
+    uint8_t battery_decivolts = 0;
+    sensor_convert_zcl_battery_voltage(reading.voltage, &battery_decivolts);
     
-    const TickType_t wake_duration = pdMS_TO_TICKS(WAKE_TIME_MS);
-    const TickType_t max_join_wait = pdMS_TO_TICKS(30000);  // 30 seconds max for join
+    gp_reading_t frame = {
+        .flags = (uint8_t)((watering_event ? GP_READING_FLAG_WATERING : 0) |
+                           (power_policy_get_source() == POWER_SOURCE_EXTERNAL ? GP_READING_FLAG_EXTERNAL : 0)),
+        .moisture_centi = reading.moisture,
+        .temp_centi = reading.temp,
+        .battery_decivolts = battery_decivolts,
+        .battery_half_pct = sensor_convert_zcl_battery_percent(reading.percent),
+        .watering_events = (uint16_t)watering_detect_event_count(&rtc_watering),
+        .age_sec = (uint16_t)(age_sec > UINT16_MAX ? UINT16_MAX : age_sec),
+    };
+    if (gp_uplink_send(&frame) == ESP_OK) {
+        freshness_record(&rtc_freshness, age_ms);
+        power_policy_mark_reported(reading.moisture, reading.temp);
+        BLOG_I(TAG, "Reading sent as uplink frame: " SENSOR_CENTI_FMT "%% moisture, " SENSOR_CENTI_FMT "°C",
+                 SENSOR_CENTI_ARGS(reading.moisture), SENSOR_CENTI_ARGS(reading.temp));
+    }
+    reading_done();
+}
+
+/**
+ * @brief All samples in - log, re-evaluate power and decide on a report
+ * 
+ * The active power profile decides whether the reading is worth a report
+ * (deadband / heartbeat). A watering event bypasses the deadband and is
+ * reported immediately, followed by a short burst of fast readings.
+ */
+static void process_reading(void)
+{
+    // Last sample taken: the sensors boot again for the next reading
+    sensor_bus_power_off();
+    
+    if (!average_reading()) {
+        BLOG_W(TAG, "Failed to read sensors");
+        finish_wake();
+        return;
+    }
+    deep_sleep_mark_sensors_read();
     
-    TickType_t start_time = xTaskGetTickCount();
-    bool sensors_read = false;
-    bool data_transmitted = false;
+    // Keep the reading in flash history (RTC-staged, batched flash writes)
+    history_reading_t entry = {
+        .time = deep_sleep_get_time_sec(),
+        .moisture_centi = reading.moisture,
+        .temp_centi = reading.temp,
+    };
+    history_log_append(&entry);
     
-    // Averaged sensor values
-    float avg_moisture = 0.0f, avg_temp = 0.0f, avg_voltage = 0.0f, avg_percent = 0.0f;
+    // Sense wakes already fed the detector with this wake's sample
+    if (!watering_wake && watering_update(reading.moisture)) {
+        watering_event = true;
+    }
+    watering_wake = false;
     
-    // Wait for Zigbee to join
-    zigbee_join_start = xTaskGetTickCount();
-    zigbee_join_attempted = true;
+    // Re-evaluate power source and switch profile on the fly
+    if (power_policy_update(reading.voltage)) {
+        set_led(led_state);  // Re-apply LED policy
+    }
+    deep_sleep_set_interval(power_policy_get_profile()->sample_interval_sec);
     
-    while (1) {
-        TickType_t now = xTaskGetTickCount();
-        TickType_t elapsed = now - start_time;
+    if (!watering_event && !power_policy_should_report(reading.moisture, reading.temp)) {
+        reading_done();
+        return;
+    }
+    if (gp_wake) {
+        report_reading_uplink();
+        return;
+    }
+    if (zigbee_core_is_joined()) {
+        report_reading();
+        return;
+    }
+    
+    // The join callback posts WAKE_EVT_JOIN_CHANGED - nothing polls meanwhile
+    BLOG_I(TAG, "Status: Joining network... (up to %d seconds)", ZIGBEE_JOIN_TIMEOUT_MS / 1000);
+    wake_state = WAKE_JOINING;
+    app_loop_post_after(WAKE_EVT_JOIN_TIMEOUT, ZIGBEE_JOIN_TIMEOUT_MS);
+}
+
+/**
+ * @brief Start a reading (Zigbee keeps joining meanwhile)
+ */
+static void start_reading(void)
+{
+    // Staying awake on external power: pick up tuning written meanwhile
+    if (perf_config_apply_pending()) {
+        power_policy_reload_config();
+        zigbee_core_sync_config();
+    }
+    
+    memset(&reading, 0, sizeof(reading));
+    wake_state = WAKE_SAMPLING;
+    BLOG_I(TAG, "Taking %d sensor samples (averaging for accuracy)...",
+             power_policy_get_profile()->num_samples);
+    
+    // Usually the sensors booted while Zigbee started; otherwise the loop
+    // sleeps out the rest of their boot time
+    uint32_t ready_ms = sensor_bus_ready_in_ms();
+    if (ready_ms > 0) {
+        app_loop_post_after(WAKE_EVT_SAMPLE, ready_ms);
+    } else {
+        app_loop_post(WAKE_EVT_SAMPLE, 0);
+    }
+}
+
+/**
+ * @brief Wake cycle - one event at a time in the app loop task
+ * 
+ * Readings, the report, OTA and history pull grace periods and the final
+ * deep sleep are a small state machine. Waits are software timers or
+ * Zigbee callbacks, so the task only runs when there is work to do.
+ */
+static void wake_event_handler(const app_event_t *event)
+{
+    switch (event->id) {
+    case WAKE_EVT_READ:
+        start_reading();
+        break;
         
-        // Check if Zigbee joined
-        if (zigbee_core_is_joined()) {
-            // NOTE: OTA updates handled automatically by callbacks
-            // Z2M (coordinator) pushes updates when available
-            // Device stays awake if OTA download is in progress
-            
-            // Read sensors (if not already done)
-            if (!sensors_read && deep_sleep_should_read_sensors()) {
-                ESP_LOGI(TAG, "✅ Zigbee joined! Taking sensor readings...");
-                
-                // Take multiple samples and average
-                if (read_averaged_sensors(&avg_moisture, &avg_temp, &avg_voltage, &avg_percent)) {
-                    sensors_read = true;
-                } else {
-                    ESP_LOGW(TAG, "❌ Failed to read sensors");
-                    break;
-                }
-            }
-            
-            // Transmit averaged data
-            if (sensors_read && !data_transmitted) {
-                report_sensor_data(avg_moisture, avg_temp, avg_voltage, avg_percent);
-                data_transmitted = true;
-                
-                // Mark readings as complete
-                deep_sleep_mark_sensors_read();
-                readings_complete = true;
-                
-                ESP_LOGI(TAG, "✅ Averaged data transmitted successfully!");
-                
-                // Stay awake a bit longer to ensure transmission completes
-                vTaskDelay(pdMS_TO_TICKS(5000));
-                
-                // Done with this wake cycle
-                break;
-            }
+    case WAKE_EVT_SAMPLE:
+        if (wake_state != WAKE_SAMPLING) {
+            break;
+        }
+        take_sample();
+        if (reading.samples < power_policy_get_profile()->num_samples) {
+            // Wait between samples for stability
+            app_loop_post_after(WAKE_EVT_SAMPLE, power_policy_get_profile()->sample_spacing_ms);
+        } else {
+            process_reading();
         }
+        break;
         
-        // Check timeouts
-        if (elapsed >= wake_duration) {
-            ESP_LOGW(TAG, "⏰ Wake time expired");
-            break;
+    case WAKE_EVT_JOIN_CHANGED:
+        if (wake_state == WAKE_JOINING && event->arg) {
+            report_reading();
         }
+        break;
         
-        if (!zigbee_core_is_joined() && (now - zigbee_join_start) >= max_join_wait) {
-            ESP_LOGW(TAG, "⏰ Zigbee join timeout - will retry next wake");
-            break;
+    case WAKE_EVT_JOIN_TIMEOUT:
+        if (wake_state == WAKE_JOINING) {
+            BLOG_W(TAG, "Zigbee join timeout - will retry next cycle");
+            reading_done();
         }
+        break;
         
-        // Status log every 5 seconds
-        if (elapsed % pdMS_TO_TICKS(5000) == 0) {
-            if (zigbee_core_is_joined()) {
-                ESP_LOGI(TAG, "Status: JOINED, processing...");
-            } else {
-                ESP_LOGI(TAG, "Status: Joining network... (%lu seconds elapsed)", 
-                         (now - zigbee_join_start) / configTICK_RATE_HZ);
-            }
+    case WAKE_EVT_LINGER_DONE:
+        if (wake_state == WAKE_LINGERING) {
+            BLOG_W(TAG, "Radio still busy after %d ms - moving on", ZIGBEE_TX_LINGER_MS);
+            reading_done();
+        }
+        break;
+        
+    case WAKE_EVT_RADIO_IDLE:
+        if (wake_state == WAKE_LINGERING) {
+            app_loop_cancel(WAKE_EVT_LINGER_DONE);
+            reading_done();
         }
+        break;
+        
+    case WAKE_EVT_FINISH:
+        finish_wake();
+        break;
+        
+    case WAKE_EVT_PULL_DONE:
+    case WAKE_EVT_PULL_TIMEOUT:
+        if (wake_state == WAKE_PULL_WAIT) {
+            wait_for_ota();
+        }
+        break;
+        
+    case WAKE_EVT_OTA_DONE:
+    case WAKE_EVT_OTA_TIMEOUT:
+        if (wake_state == WAKE_OTA_WAIT) {
+            ota_writer_abort();
+            enter_sleep();
+        }
+        break;
+        
+    case WAKE_EVT_OTA_FLASH:
+        ota_writer_process();
+        break;
+        
+    case WAKE_EVT_OTA_APPLY:
+        apply_ota();
+        break;
+        
+    case WAKE_EVT_OTA_RESTART:
+        esp_restart();
+        break;
         
-        vTaskDelay(pdMS_TO_TICKS(1000));
+    default:
+        break;
     }
-    
-    // Enter deep sleep
-    ESP_LOGI(TAG, "");
-    ESP_LOGI(TAG, "Wake cycle complete - entering deep sleep");
-    deep_sleep_enter();
-    
-    // Never reached
-    vTaskDelete(NULL);
+}
+
+/**
+ * @brief Zigbee join state callback (Zigbee task context)
+ */
+static void join_state_callback(bool joined)
+{
+    app_loop_post(WAKE_EVT_JOIN_CHANGED, joined);
+}
+
+/**
+ * @brief History pull finished callback (Zigbee task context)
+ */
+static void history_pull_callback(void)
+{
+    app_loop_post(WAKE_EVT_PULL_DONE, 0);
+}
+
+/**
+ * @brief Radio idle callback (Zigbee task context)
+ */
+static void radio_idle_callback(void)
+{
+    app_loop_post(WAKE_EVT_RADIO_IDLE, 0);
 }
 
 /**
@@ -390,6 +892,7 @@ static esp_err_t zb_attribute_handler(const esp_zb_zcl_set_attr_value_message_t
     ESP_RETURN_ON_FALSE(message->info.status == ESP_ZB_ZCL_STATUS_SUCCESS, ESP_ERR_INVALID_ARG, TAG, 
                        "Received message: error status(%d)", message->info.status);
     
+#if CONFIG_GLYPH_ZCL_LED
     // Handle On/Off cluster for LED control
     if (message->info.dst_endpoint == HA_ESP_SENSOR_ENDPOINT &&
         message->info.cluster == ESP_ZB_ZCL_CLUSTER_ID_ON_OFF) {
@@ -402,6 +905,22 @@ static esp_err_t zb_attribute_handler(const esp_zb_zcl_set_attr_value_message_t
             set_led(new_state);
         }
     }
+#endif
+    
+    // History pull request from the coordinator (manufacturer stats cluster)
+    if (message->info.dst_endpoint == HA_ESP_SENSOR_ENDPOINT &&
+        message->info.cluster == GLYPH_CLUSTER_ID_STATS &&
+        message->attribute.id == GLYPH_ATTR_HISTORY_REQUEST_ID &&
+        message->attribute.data.value) {
+        zigbee_core_handle_history_request((const uint8_t *)message->attribute.data.value);
+    }
+    
+    // Runtime tuning (manufacturer config cluster) - staged for the next wake
+    if (message->info.dst_endpoint == HA_ESP_SENSOR_ENDPOINT &&
+        message->info.cluster == GLYPH_CLUSTER_ID_CONFIG &&
+        message->attribute.data.value) {
+        ret = zigbee_core_handle_config_write(message->attribute.id, message->attribute.data.value);
+    }
     
     return ret;
 }
@@ -418,10 +937,10 @@ static esp_err_t zb_action_handler(esp_zb_core_action_callback_id_t callback_id,
         break;
     case ESP_ZB_CORE_OTA_UPGRADE_VALUE_CB_ID:
         // Handle OTA upgrade status updates
-        ota_upgrade_status_handler((esp_zb_zcl_ota_upgrade_value_message_t *)message);
+        ret = ota_upgrade_status_handler((esp_zb_zcl_ota_upgrade_value_message_t *)message);
         break;
     default:
-        ESP_LOGW(TAG, "Receive Zigbee action(0x%x) callback", callback_id);
+        BLOG_W(TAG, "Receive Zigbee action(0x%x) callback", callback_id);
         break;
     }
     return ret;
@@ -440,24 +959,39 @@ void esp_zb_app_signal_handler(esp_zb_app_signal_t *signal_struct)
  */
 void app_main(void)
 {
-    ESP_LOGI(TAG, "===========================================");
-    ESP_LOGI(TAG, "  Glyph C6 Plant Monitor - Deep Sleep Mode");
-    ESP_LOGI(TAG, "  Firmware: %s", FIRMWARE_VERSION_STRING);
-    ESP_LOGI(TAG, "  Version: 0x%08lX, Built: %s", FIRMWARE_VERSION, FIRMWARE_BUILD_DATE);
-    ESP_LOGI(TAG, "  Battery Life: 14-18 months (1000mAh)");
-    ESP_LOGI(TAG, "===========================================");
+    // Deferred binary logging: records stay in RTC memory, dumped only to a listening console
+    binlog_init();
+
+    BLOG_I(TAG, "  Glyph C6 Plant Monitor - Deep Sleep Mode");
+    BLOG_I(TAG, "  Firmware: %s", FIRMWARE_VERSION_STRING);
+    BLOG_I(TAG, "  Version: 0x%08" PRIX32 ", Built: %s", (uint32_t)FIRMWARE_VERSION, FIRMWARE_BUILD_DATE);
 
     // Initialize deep sleep management FIRST
     esp_err_t ret = deep_sleep_init();
     ESP_ERROR_CHECK(ret);
-
-    // Initialize NVS (required for Zigbee)
+    
+    // Field trace: marks the start of this wake (no-op unless CONFIG_GLYPH_FIELD_TRACE)
+    field_trace_init();
+    
+    // Initialize NVS (required for Zigbee and runtime configuration)
     ret = nvs_flash_init();
     if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
         ESP_ERROR_CHECK(nvs_flash_erase());
         ret = nvs_flash_init();
     }
     ESP_ERROR_CHECK(ret);
+    
+    // Runtime tuning: applies values written over Zigbee during the last wake
+    perf_config_init();
+    
+    // Restore power policy (profile survives deep sleep in RTC memory)
+    power_policy_init();
+    
+    // Flash reading history (staging buffer survives deep sleep in RTC memory)
+    history_log_init();
+    
+    // Commissioning-free uplink: pairing, and commissioning frames if requested
+    gp_uplink_init();
 
     // Initialize GPIO
     gpio_init();
@@ -465,20 +999,16 @@ void app_main(void)
     // Print chip information
     esp_chip_info_t chip_info;
     esp_chip_info(&chip_info);
-    ESP_LOGI(TAG, "Chip: ESP32-C6, Cores: %d, Revision: %d", 
+    BLOG_I(TAG, "Chip: ESP32-C6, Cores: %d, Revision: %d", 
              chip_info.cores, chip_info.revision);
     
     uint32_t flash_size;
     esp_flash_get_size(NULL, &flash_size);
-    ESP_LOGI(TAG, "Flash: %lu MB, Free heap: %lu bytes", 
+    BLOG_I(TAG, "Flash: %" PRIu32 " MB, Free heap: %" PRIu32 " bytes", 
              flash_size / (1024 * 1024), esp_get_free_heap_size());
 
-    // Wait for I2C sensors to power up
-    ESP_LOGI(TAG, "Waiting 500ms for I2C devices...");
-    vTaskDelay(pdMS_TO_TICKS(500));
-
     // Initialize I2C bus
-    ESP_LOGI(TAG, "Initializing I2C bus...");
+    BLOG_I(TAG, "Initializing I2C bus...");
     i2c_master_bus_config_t i2c_bus_config = {
         .clk_source = I2C_CLK_SRC_DEFAULT,
         .i2c_port = I2C_NUM_0,
@@ -490,35 +1020,67 @@ void app_main(void)
     i2c_master_bus_handle_t bus_handle;
     esp_err_t i2c_ret = i2c_new_master_bus(&i2c_bus_config, &bus_handle);
     if (i2c_ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to initialize I2C bus: %s", esp_err_to_name(i2c_ret));
+        BLOG_E(TAG, "Failed to initialize I2C bus: %s", esp_err_to_name(i2c_ret));
     }
 
-    // Initialize Zigbee core
-    ESP_LOGI(TAG, "Initializing Zigbee SDK...");
-    ESP_ERROR_CHECK(zigbee_core_init());
-    ESP_ERROR_CHECK(zigbee_core_register_action_handler(zb_action_handler));
-    ESP_ERROR_CHECK(zigbee_core_start());
-    ESP_ERROR_CHECK(zigbee_core_start_main_loop_task());
-    
-    vTaskDelay(pdMS_TO_TICKS(100));
-
     // Initialize battery monitoring (hardware only - no background tasks)
-    ESP_LOGI(TAG, "Initializing battery monitoring...");
+    BLOG_I(TAG, "Initializing battery monitoring...");
     battery_monitoring_init();
 
-    // Initialize soil sensor (hardware only - no background tasks)
-    ESP_LOGI(TAG, "Initializing soil sensor...");
-    soil_sensor_init(bus_handle);
+    // I2C sensors: registered with the acquisition scheduler, which owns
+    // the rail. A reading wake powers them up now so their boot runs
+    // alongside the Zigbee start; sense wakes power up when they sample
+    BLOG_I(TAG, "Initializing I2C sensors...");
+    if (i2c_ret == ESP_OK && sensor_bus_init(bus_handle) == ESP_OK) {
+        soil_sensor_register();
+        if (AMBIENT_SENSOR_ENABLED) {
+            ambient_sensor_register();
+        }
+    }
+    if (deep_sleep_should_read_sensors()) {
+        sensor_bus_power_on();
+    }
+
+    // Between readings on battery: quick radio-free watering check only
+    if (power_policy_get_profile()->deep_sleep && !deep_sleep_should_read_sensors()) {
+        sense_only_wake();  // Returns only if a watering event needs reporting
+    }
+
+    // Paired for the uplink: this wake's report is one frame, no network
+    // join; every GP_FULL_WAKE_REPORTS frames a full wake starts Zigbee
+    gp_wake = power_policy_get_profile()->deep_sleep && gp_uplink_use_this_wake();
+    if (gp_wake) {
+        BLOG_I(TAG, "Uplink wake - Zigbee stays off");
+    } else {
+        // Initialize Zigbee core
+        BLOG_I(TAG, "Initializing Zigbee SDK...");
+        ESP_ERROR_CHECK(zigbee_core_init());
+        ESP_ERROR_CHECK(zigbee_core_register_action_handler(zb_action_handler));
+        ESP_ERROR_CHECK(zigbee_core_start());
+        ESP_ERROR_CHECK(zigbee_core_start_main_loop_task());
+        
+        vTaskDelay(pdMS_TO_TICKS(100));
+    }
 
-    ESP_LOGI(TAG, "");
-    ESP_LOGI(TAG, "Application initialized successfully");
-    ESP_LOGI(TAG, "Sensors read on-demand (direct I2C/ADC reads)");
-    ESP_LOGI(TAG, "Readings every 1 hour (soil + battery together)");
-    ESP_LOGI(TAG, "Free heap: %lu bytes", esp_get_free_heap_size());
+    BLOG_I(TAG, "Application initialized successfully");
+    BLOG_I(TAG, "Sensors read on-demand (direct I2C/ADC reads)");
+    BLOG_I(TAG, "Active power profile: %s (readings every %" PRIu32 " seconds)",
+             power_policy_get_profile()->name, power_policy_get_profile()->sample_interval_sec);
+    BLOG_I(TAG, "Free heap: %" PRIu32 " bytes", esp_get_free_heap_size());
 
-    // Create wake cycle task
-    xTaskCreate(wake_cycle_task, "wake_cycle", 4096, NULL, 5, NULL);
+    // Everything else runs in the event loop; app_main returns and its
+    // stack goes back to the heap
+    ESP_ERROR_CHECK(app_loop_start("app_loop", wake_event_handler));
+    zigbee_core_register_join_callback(join_state_callback);
+    zigbee_core_register_history_pull_callback(history_pull_callback);
+    zigbee_core_register_radio_idle_callback(radio_idle_callback);
+    
+    // NOTE: OTA updates handled automatically by callbacks
+    // Z2M (coordinator) pushes updates when available
+    bool reading_due = deep_sleep_should_read_sensors() || watering_wake;
+    watering_event = watering_wake;
+    app_loop_post(reading_due ? WAKE_EVT_READ : WAKE_EVT_FINISH, 0);
     
-    ESP_LOGI(TAG, "Wake cycle task started - waiting for Zigbee join...");
+    BLOG_I(TAG, "Wake cycle started - waiting for Zigbee join...");
 }
 
@@ -14,7 +14,7 @@
  * - NVRAM corruption fix (required esp_zb_nvram_erase_at_start on first flash)
  * - Reduced TX power (10dBm) for board compatibility
  * - Brownout detector disabled (CONFIG_ESP_BROWNOUT_DET=n)
- * - Increased Zigbee task stack (8192 bytes)
+ * - Zigbee task stack (8192 bytes), statically allocated
  * - Device type changed from ON_OFF_LIGHT to SIMPLE_SENSOR
  * - Main loop task started before any BDB commissioning calls
  * 
@@ -37,6 +37,7 @@
 #include <string.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/semphr.h"
 #include "esp_log.h"
 #include "nvs_flash.h"
 #include "driver/gpio.h"
@@ -44,6 +45,7 @@
 #include "esp_chip_info.h"
 #include "esp_flash.h"
 #include "esp_check.h"
+#include "esp_pm.h"
 
 // ESP Zigbee SDK includes
 #include "esp_zigbee_core.h"
@@ -57,6 +59,16 @@
 #include "zigbee_core.h"
 #include "battery_monitoring.h"
 #include "soil_sensor.h"
+#include "power_policy.h"
+#include "perf_config.h"
+#include "sample_window.h"
+#include "freshness.h"
+#include "sensor_convert.h"
+#include "deep_sleep.h"
+#include "watering_detect.h"
+#include "history_log.h"
+#include "binlog.h"
+#include "app_loop.h"
 
 // Define missing Power Config cluster attribute IDs (not in ESP Zigbee SDK headers)
 #ifndef ESP_ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_PERCENTAGE_REMAINING_ID
@@ -73,13 +85,14 @@ static const char *TAG = "GLYPH_C6";
 static bool led_state = false;
 
 /**
- * @brief Set LED state
+ * @brief Set LED state (forced off while the power profile disallows the LED)
  */
 static void set_led(bool state)
 {
     led_state = state;
-    gpio_set_level(GPIO_NUM_14, state ? 1 : 0);
-    ESP_LOGI(TAG, "LED: %s", state ? "ON 💡" : "OFF");
+    bool drive = state && power_policy_get_profile()->led_enabled;
+    gpio_set_level(GPIO_NUM_14, drive ? 1 : 0);
+    ESP_LOGI(TAG, "LED: %s%s", drive ? "ON" : "OFF", (state && !drive) ? " (suppressed on battery)" : "");
 }
 
 /**
@@ -116,6 +129,81 @@ static void gpio_init(void)
     ESP_LOGI(TAG, "NeoPixel/I2C Power: GPIO20 (enabled)");
 }
 
+// ============================================================================
+// LATEST READINGS (written by the app loop, read by Zigbee scheduler callbacks)
+// ============================================================================
+
+static SemaphoreHandle_t readings_mutex = NULL;
+static soil_data_t latest_soil = {0};
+static uint32_t latest_soil_ms = 0;       // RTC time latest_soil was read
+static float latest_voltage = 0.0f;
+static float latest_percent = 0.0f;
+static bool latest_battery_valid = false;
+
+// Window of all samples since the last heartbeat report (owned by the app loop)
+static sample_window_t sample_window;
+
+// Watering event detector (owned by the app loop)
+static watering_detector_t watering;
+
+// Age of reported readings at send (owned by the Zigbee scheduler callback)
+static freshness_histogram_t freshness;
+
+/**
+ * @brief Copy latest battery reading (thread-safe)
+ */
+static bool get_latest_battery(float *voltage, float *percent)
+{
+    bool valid = false;
+    if (xSemaphoreTake(readings_mutex, pdMS_TO_TICKS(BATTERY_MUTEX_TIMEOUT_MS)) == pdTRUE) {
+        *voltage = latest_voltage;
+        *percent = latest_percent;
+        valid = latest_battery_valid;
+        xSemaphoreGive(readings_mutex);
+    }
+    return valid;
+}
+
+/**
+ * @brief Copy latest soil reading (thread-safe)
+ */
+static bool get_latest_soil(soil_data_t *data)
+{
+    bool valid = false;
+    if (xSemaphoreTake(readings_mutex, pdMS_TO_TICKS(BATTERY_MUTEX_TIMEOUT_MS)) == pdTRUE) {
+        *data = latest_soil;
+        valid = latest_soil.valid;
+        xSemaphoreGive(readings_mutex);
+    }
+    return valid;
+}
+
+/**
+ * @brief RTC time of the latest soil reading (thread-safe)
+ */
+static uint32_t get_latest_soil_time(void)
+{
+    uint32_t acquired_ms = 0;
+    if (xSemaphoreTake(readings_mutex, pdMS_TO_TICKS(BATTERY_MUTEX_TIMEOUT_MS)) == pdTRUE) {
+        acquired_ms = latest_soil_ms;
+        xSemaphoreGive(readings_mutex);
+    }
+    return acquired_ms;
+}
+
+// Event loop ids - each event runs one status pass with its bit set
+// (STATUS_EVT_SOIL_REPORTED only records the reported values)
+enum {
+    STATUS_EVT_SAMPLE_DUE = 0,      // Sample timer expired
+    STATUS_EVT_SOIL_REPORT_DUE,     // Soil heartbeat report due
+    STATUS_EVT_BATTERY_REPORT_DUE,  // Battery report due
+    STATUS_EVT_JOIN_CHANGED,        // Zigbee join state changed
+    STATUS_EVT_SOIL_REPORTED,       // Soil report sent (arg: moisture << 16 | temperature)
+    STATUS_EVT_WATERING,            // Watering event detected (internal, never posted)
+};
+
+#define STATUS_BIT(evt)                (1UL << (evt))
+
 // ============================================================================
 // ZIGBEE ATTRIBUTE REPORTING
 // ============================================================================
@@ -130,8 +218,8 @@ static void scheduled_battery_report(uint8_t param)
     float voltage = 0.0f;
     float percent = 0.0f;
     
-    // Get battery data from cache (thread-safe)
-    if (battery_get_cached_data(&voltage, &percent)) {
+    // Get latest battery reading (thread-safe)
+    if (get_latest_battery(&voltage, &percent)) {
         // Report battery percentage (Zigbee uses 0-200 scale, 0.5% units)
         uint16_t battery_percent_raw = (uint16_t)(percent * 2.0f);
         uint8_t battery_percent = (battery_percent_raw <= 200) ? (uint8_t)battery_percent_raw : 200;
@@ -168,8 +256,8 @@ static void scheduled_battery_report(uint8_t param)
             }
         }
         
-        ESP_LOGI(TAG, "Battery attributes updated: %.2fV (%.1f%%) - percent=%d, voltage_dv=%d (Z2M will poll)", 
-                 voltage, percent, battery_percent, (uint8_t)(voltage * 10.0f));
+        ESP_LOGI(TAG, "Battery attributes updated: %d mV (%d%%) - percent=%d, voltage_dv=%d (Z2M will poll)", 
+                 (int)(voltage * 1000.0f), (int)percent, battery_percent, (uint8_t)(voltage * 10.0f));
     }
 }
 
@@ -182,96 +270,310 @@ static void scheduled_soil_report(uint8_t param)
     
     soil_data_t soil_data;
     
-    // Get soil data from cache (thread-safe)
-    if (soil_sensor_get_cached_data(&soil_data) == ESP_OK) {
-        ESP_LOGI(TAG, "📊 Reporting soil data to Z2M: %.1f%% moisture, %.1f°C, raw=%d", 
-                 soil_data.moisture_percent, soil_data.temperature_c, soil_data.moisture_raw);
+    // Get latest soil reading (thread-safe)
+    if (get_latest_soil(&soil_data)) {
+        ESP_LOGI(TAG, "Reporting soil data to Z2M: " SENSOR_CENTI_FMT "%% moisture, " SENSOR_CENTI_FMT "°C, raw=%d", 
+                 SENSOR_CENTI_ARGS(soil_data.moisture_centi), SENSOR_CENTI_ARGS(soil_data.temperature_centi),
+                 soil_data.moisture_raw);
         
         // Update moisture (using Relative Humidity cluster)
-        esp_err_t ret = zigbee_core_update_soil_moisture(soil_data.moisture_percent);
+        esp_err_t ret = zigbee_core_update_soil_moisture(soil_data.moisture_centi);
         if (ret == ESP_OK) {
-            ESP_LOGI(TAG, "   ✅ Moisture reported successfully");
+            ESP_LOGI(TAG, "  Moisture reported");
         } else {
-            ESP_LOGW(TAG, "   ❌ Failed to report moisture: %s", esp_err_to_name(ret));
+            ESP_LOGW(TAG, "  Failed to report moisture: %s", esp_err_to_name(ret));
         }
         
         // Update temperature
-        ret = zigbee_core_update_soil_temperature(soil_data.temperature_c);
+        ret = zigbee_core_update_soil_temperature(soil_data.temperature_centi);
         if (ret == ESP_OK) {
-            ESP_LOGI(TAG, "   ✅ Temperature reported successfully");
+            ESP_LOGI(TAG, "  Temperature reported");
         } else {
-            ESP_LOGW(TAG, "   ❌ Failed to report temperature: %s", esp_err_to_name(ret));
+            ESP_LOGW(TAG, "  Failed to report temperature: %s", esp_err_to_name(ret));
+        }
+        
+        // Acquisition and send time of the values just reported
+        uint32_t acquired_ms = get_latest_soil_time();
+        uint32_t sent_ms = deep_sleep_get_time_ms();
+        freshness_record(&freshness, freshness_age_ms(acquired_ms, sent_ms));
+        uint8_t record[FRESHNESS_RECORD_LEN];
+        size_t len = freshness_encode(&freshness, acquired_ms, sent_ms, record, sizeof(record));
+        if (zigbee_core_update_freshness(record, len) != ESP_OK) {
+            ESP_LOGW(TAG, "  Failed to report freshness");
         }
+        
+        // Deadband state belongs to the app loop task - mark it there
+        app_loop_post(STATUS_EVT_SOIL_REPORTED,
+                      ((uint32_t)soil_data.moisture_centi << 16) | (uint16_t)soil_data.temperature_centi);
     } else {
-        ESP_LOGW(TAG, "📊 Cannot report soil data - no valid data in cache");
+        ESP_LOGW(TAG, "Cannot report soil data - no valid data in cache");
     }
 }
 
 // ============================================================================
-// STATUS MONITORING TASK
+// STATUS MONITORING (app event loop)
 // ============================================================================
 
+#define STATUS_LOG_MIN_INTERVAL_MS     600000       // Periodic status line at most every 10 minutes
+
+/**
+ * @brief Zigbee join state callback (runs in Zigbee task context)
+ */
+static void join_state_callback(bool joined)
+{
+    app_loop_post(STATUS_EVT_JOIN_CHANGED, joined);
+}
+
+/**
+ * @brief Apply sampling and heartbeat periods of the active power profile
+ */
+static void apply_power_profile(const power_profile_t *profile)
+{
+    app_loop_post_every(STATUS_EVT_SAMPLE_DUE, profile->sample_interval_sec * 1000);
+    app_loop_post_every(STATUS_EVT_SOIL_REPORT_DUE, profile->report_interval_sec * 1000);
+    set_led(led_state);  // Re-apply LED policy
+    ESP_LOGI(TAG, "Profile %s: sample every %" PRIu32 "s, heartbeat every %" PRIu32 "s",
+             profile->name, profile->sample_interval_sec, profile->report_interval_sec);
+}
+
+/**
+ * @brief Take one soil + battery sample and publish it as the latest reading
+ * 
+ * A single battery ADC read feeds both the percentage and the power source
+ * classification (no separate battery_is_usb_present() read).
+ * 
+ * @return true if the soil read succeeded
+ */
+static bool take_sample(void)
+{
+    soil_data_t soil_data;
+    float voltage = 0.0f, percent = 0.0f;
+    
+    bool soil_ok = (soil_sensor_read_all(&soil_data) == ESP_OK);
+    bool battery_ok = (battery_read(&voltage, &percent) == ESP_OK);
+    
+    if (xSemaphoreTake(readings_mutex, pdMS_TO_TICKS(BATTERY_MUTEX_TIMEOUT_MS)) == pdTRUE) {
+        if (soil_ok) {
+            latest_soil = soil_data;
+            latest_soil_ms = deep_sleep_get_time_ms();
+        }
+        if (battery_ok) {
+            latest_voltage = voltage;
+            latest_percent = percent;
+            latest_battery_valid = true;
+        }
+        xSemaphoreGive(readings_mutex);
+    }
+    
+    if (soil_ok) {
+        history_reading_t reading = {
+            .time = deep_sleep_get_time_sec(),
+            .moisture_centi = soil_data.moisture_centi,
+            .temp_centi = soil_data.temperature_centi,
+        };
+        sample_window_add(&sample_window, reading.moisture_centi, reading.temp_centi);
+        history_log_append(&reading);  // Staged in RTC, flushed to flash in batches
+    } else {
+        ESP_LOGW(TAG, "Soil sample failed - keeping previous reading");
+    }
+    return soil_ok;
+}
+
+/**
+ * @brief Run the watering detector on the latest soil sample
+ * 
+ * On a new event the sample timer switches to the burst interval to
+ * capture the infiltration curve; when the burst completes it returns
+ * to the profile interval.
+ * 
+ * @return Extra STATUS_BIT() bits to handle in this pass
+ */
+static uint32_t update_watering(const soil_data_t *soil_data)
+{
+    bool burst_done = false;
+    bool event = watering_detect_update(&watering, soil_data->moisture_centi, &burst_done);
+    
+    if (event) {
+        app_loop_post_every(STATUS_EVT_SAMPLE_DUE, WATERING_BURST_INTERVAL_SEC * 1000);
+        return STATUS_BIT(STATUS_EVT_SOIL_REPORT_DUE) | STATUS_BIT(STATUS_EVT_WATERING);
+    }
+    if (burst_done) {
+        apply_power_profile(power_policy_get_profile());
+        return STATUS_BIT(STATUS_EVT_SOIL_REPORT_DUE);  // Close the window over the burst
+    }
+    return 0;
+}
+
+/**
+ * @brief Report statistics of the current sample window and start a new one
+ */
+static void report_window_stats(void)
+{
+    sample_window_stats_t stats;
+    uint32_t now = deep_sleep_get_time_sec();
+    
+    if (sample_window_get_stats(&sample_window, now, &stats)) {
+        uint8_t record[SAMPLE_WINDOW_RECORD_LEN];
+        size_t len = sample_window_encode(&stats, record, sizeof(record));
+        if (zigbee_core_update_window_stats(record, len) == ESP_OK) {
+            ESP_LOGI(TAG, "Window reported: %u samples over %u min", stats.count, stats.duration_min);
+        }
+    }
+    sample_window_reset(&sample_window, now);
+}
+
 /**
- * @brief Status monitoring task (logs Zigbee, LED, and Battery status)
+ * @brief Log one status line (rate-limited unless forced by a state change)
  */
-static void status_task(void *pvParameters)
+static void log_status(bool force)
 {
-    ESP_LOGI(TAG, "Starting status monitoring task with battery and soil reporting");
-    TickType_t last_battery_report = 0;
-    TickType_t last_soil_report = 0;
-    const TickType_t battery_report_interval = pdMS_TO_TICKS(14400000);  // 4 hours
-    const TickType_t soil_report_interval = pdMS_TO_TICKS(3600000);      // 1 hour
-    bool first_report_sent = false;  // Track if we've sent initial values to Z2M
-    
-    while (1) {
-        TickType_t now = xTaskGetTickCount();
-        float voltage = 0.0f, percent = 0.0f;
-        bool battery_valid = battery_get_cached_data(&voltage, &percent);
-        bool usb_present = battery_is_usb_present();
-        const char *power_source = usb_present ? "USB⚡" : "BAT🔋";
+    static TickType_t last_log = 0;
+    static bool logged_once = false;
+    TickType_t now = xTaskGetTickCount();
+    
+    if (!force && logged_once && (now - last_log) < pdMS_TO_TICKS(STATUS_LOG_MIN_INTERVAL_MS)) {
+        return;
+    }
+    last_log = now;
+    logged_once = true;
+    
+    float voltage = 0.0f, percent = 0.0f;
+    get_latest_battery(&voltage, &percent);
+    soil_data_t soil_data;
+    bool soil_valid = get_latest_soil(&soil_data);
+    const char *power_source = power_policy_source_string(power_policy_get_source());
+    
+    if (soil_valid) {
+        ESP_LOGI(TAG, "Status: Zigbee %s | LED: %s | Power: %s %d mV (%d%%) | Soil: " SENSOR_CENTI_FMT "%% @ " SENSOR_CENTI_FMT "°C",
+                 zigbee_core_is_joined() ? "JOINED" : "SEARCHING", led_state ? "ON" : "OFF",
+                 power_source, (int)(voltage * 1000.0f), (int)percent,
+                 SENSOR_CENTI_ARGS(soil_data.moisture_centi), SENSOR_CENTI_ARGS(soil_data.temperature_centi));
+    } else {
+        ESP_LOGI(TAG, "Status: Zigbee %s | LED: %s | Power: %s %d mV (%d%%)",
+                 zigbee_core_is_joined() ? "JOINED" : "SEARCHING", led_state ? "ON" : "OFF",
+                 power_source, (int)(voltage * 1000.0f), (int)percent);
+    }
+    
+    // Field numbers for APP_LOOP_TASK_STACK / ZIGBEE_TASK_STACK
+    ESP_LOGI(TAG, "Stack unused: app loop %" PRIu32 " bytes, zigbee %" PRIu32 " bytes",
+             app_loop_stack_unused(), zigbee_core_stack_unused());
+}
+
+/**
+ * @brief Status and report pass (app loop handler)
+ * 
+ * Runs only when a sample or report is due (software timers) or the join
+ * state changed (Zigbee callback). Between events the loop task blocks on
+ * its queue and the CPU stays idle and can light-sleep.
+ */
+static void status_event_handler(const app_event_t *event)
+{
+    uint32_t events = STATUS_BIT(event->id);
+    
+    if (events & STATUS_BIT(STATUS_EVT_SOIL_REPORTED)) {
+        power_policy_mark_reported((uint16_t)(event->arg >> 16), (int16_t)(event->arg & 0xFFFF));
+        return;  // Bookkeeping only - no status pass
+    }
+    
+    bool joined = zigbee_core_is_joined();
+    bool heartbeat = (events & STATUS_BIT(STATUS_EVT_SOIL_REPORT_DUE)) != 0;  // Window closes on heartbeat
+    bool state_changed = false;
+    soil_data_t soil_data;
+    float voltage = 0.0f, percent = 0.0f;
+    
+    if (events & STATUS_BIT(STATUS_EVT_JOIN_CHANGED)) {
+        state_changed = true;
+        if (joined) {
+            // Send initial values immediately when (re)joined (for Z2M to see values)
+            ESP_LOGI(TAG, "Joined - sending initial values to Z2M...");
+            zigbee_core_update_power_source(power_policy_get_source() == POWER_SOURCE_EXTERNAL);
+            events |= STATUS_BIT(STATUS_EVT_SOIL_REPORT_DUE) | STATUS_BIT(STATUS_EVT_BATTERY_REPORT_DUE);
+        }
+    }
+    
+    if (events & STATUS_BIT(STATUS_EVT_SAMPLE_DUE)) {
+        // Tuning written over Zigbee takes effect at the next sample pass
+        if (perf_config_apply_pending()) {
+            power_policy_reload_config();
+            if (!watering_detect_in_burst(&watering)) {
+                apply_power_profile(power_policy_get_profile());  // Burst end applies it otherwise
+            }
+            zigbee_core_sync_config();
+        }
         
-        soil_data_t soil_data;
-        bool soil_valid = (soil_sensor_get_cached_data(&soil_data) == ESP_OK);
+        bool soil_ok = take_sample();
         
-        if (zigbee_core_is_joined()) {
-            if (soil_valid) {
-                ESP_LOGI(TAG, "Status: Zigbee JOINED ✅ | LED: %s | Power: %s %.2fV (%.1f%%) | Soil: %.1f%% @ %.1f°C", 
-                         led_state ? "ON 💡" : "OFF", power_source, voltage, percent,
-                         soil_data.moisture_percent, soil_data.temperature_c);
-            } else {
-                ESP_LOGI(TAG, "Status: Zigbee JOINED ✅ | LED: %s | Power: %s %.2fV (%.1f%%)", 
-                         led_state ? "ON 💡" : "OFF", power_source, voltage, percent);
-            }
-            
-            // Send initial report immediately when first joined (for Z2M to see values)
-            if (!first_report_sent && battery_valid && soil_valid) {
-                ESP_LOGI(TAG, "📤 Sending initial values to Z2M...");
-                esp_zb_scheduler_alarm(scheduled_battery_report, 0, 10);
-                esp_zb_scheduler_alarm(scheduled_soil_report, 0, 50);  // Slight delay between reports
-                first_report_sent = true;
-                last_battery_report = now;
-                last_soil_report = now;
-            }
-            
-            // Schedule battery report via Zigbee scheduler (safe from task context)
-            if ((now - last_battery_report) >= battery_report_interval && battery_valid) {
-                esp_zb_scheduler_alarm(scheduled_battery_report, 0, 10);  // 10ms delay
-                last_battery_report = now;
-            }
-            
-            // Schedule soil report via Zigbee scheduler (safe from task context)
-            if ((now - last_soil_report) >= soil_report_interval && soil_valid) {
-                esp_zb_scheduler_alarm(scheduled_soil_report, 0, 10);  // 10ms delay
-                last_soil_report = now;
-            }
-        } else {
-            ESP_LOGI(TAG, "Status: Zigbee SEARCHING... 🔍 | LED: %s | Power: %s %.2fV (%.1f%%)", 
-                     led_state ? "ON 💡" : "OFF", power_source, voltage, percent);
-            first_report_sent = false;  // Reset when disconnected
+        // Power source from the fresh voltage - switches profile on the fly
+        if (get_latest_battery(&voltage, &percent) && power_policy_update(voltage)) {
+            apply_power_profile(power_policy_get_profile());
+            zigbee_core_update_power_source(power_policy_get_source() == POWER_SOURCE_EXTERNAL);
+            state_changed = true;
         }
         
-        vTaskDelay(pdMS_TO_TICKS(5000));  // Log every 5 seconds
+        // Reading changed beyond the profile deadband -> report now
+        if (get_latest_soil(&soil_data) &&
+            power_policy_should_report(soil_data.moisture_centi, soil_data.temperature_centi)) {
+            events |= STATUS_BIT(STATUS_EVT_SOIL_REPORT_DUE);
+        }
+        
+        // Watering: report immediately, then burst-sample the infiltration
+        if (soil_ok && get_latest_soil(&soil_data)) {
+            uint32_t watering_events = update_watering(&soil_data);
+            if (watering_events && !(watering_events & STATUS_BIT(STATUS_EVT_WATERING))) {
+                heartbeat = true;  // Burst complete - report its window
+            }
+            events |= watering_events;
+        }
     }
+    
+    if (joined) {
+        // Schedule reports via Zigbee scheduler (safe from task context)
+        if ((events & STATUS_BIT(STATUS_EVT_BATTERY_REPORT_DUE)) && get_latest_battery(&voltage, &percent)) {
+            esp_zb_scheduler_alarm(scheduled_battery_report, 0, 10);
+        }
+        if ((events & STATUS_BIT(STATUS_EVT_SOIL_REPORT_DUE)) && get_latest_soil(&soil_data)) {
+            esp_zb_scheduler_alarm(scheduled_soil_report, 0, 50);  // Slight delay between reports
+            app_loop_post_every(STATUS_EVT_SOIL_REPORT_DUE,      // Restart heartbeat
+                                power_policy_get_profile()->report_interval_sec * 1000);
+        }
+        if (heartbeat) {
+            report_window_stats();  // One compact record per report interval
+        }
+        if (events & STATUS_BIT(STATUS_EVT_WATERING)) {
+            zigbee_core_update_watering_events(watering_detect_event_count(&watering));
+        }
+    }
+    
+    log_status(state_changed);
+}
+
+/**
+ * @brief Start the status event loop and its deadline timers
+ */
+static esp_err_t status_scheduler_start(void)
+{
+    readings_mutex = xSemaphoreCreateMutex();
+    if (!readings_mutex) {
+        ESP_LOGE(TAG, "Failed to create status scheduler resources");
+        return ESP_ERR_NO_MEM;
+    }
+    
+    esp_err_t ret = app_loop_start("app_loop", status_event_handler);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start event loop: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    
+    ESP_LOGI(TAG, "Starting event-driven status loop with battery and soil reporting");
+    apply_power_profile(power_policy_get_profile());
+    app_loop_post_every(STATUS_EVT_BATTERY_REPORT_DUE, BATTERY_REPORT_INTERVAL_SEC * 1000UL);
+    
+    // First sample right away so the initial report has data
+    sample_window_reset(&sample_window, deep_sleep_get_time_sec());
+    app_loop_post(STATUS_EVT_SAMPLE_DUE, 0);
+    
+    zigbee_core_register_join_callback(join_state_callback);
+    return ESP_OK;
 }
 
 // ============================================================================
@@ -307,6 +609,21 @@ static esp_err_t zb_attribute_handler(const esp_zb_zcl_set_attr_value_message_t
         }
     }
     
+    // History pull request from the coordinator (manufacturer stats cluster)
+    if (message->info.dst_endpoint == HA_ESP_SENSOR_ENDPOINT &&
+        message->info.cluster == GLYPH_CLUSTER_ID_STATS &&
+        message->attribute.id == GLYPH_ATTR_HISTORY_REQUEST_ID &&
+        message->attribute.data.value) {
+        zigbee_core_handle_history_request((const uint8_t *)message->attribute.data.value);
+    }
+    
+    // Runtime tuning (manufacturer config cluster) - staged for the next wake
+    if (message->info.dst_endpoint == HA_ESP_SENSOR_ENDPOINT &&
+        message->info.cluster == GLYPH_CLUSTER_ID_CONFIG &&
+        message->attribute.data.value) {
+        ret = zigbee_core_handle_config_write(message->attribute.id, message->attribute.data.value);
+    }
+    
     return ret;
 }
 
@@ -340,6 +657,10 @@ void esp_zb_app_signal_handler(esp_zb_app_signal_t *signal_struct)
  */
 void app_main(void)
 {
+    // Always-on: shared modules log as text immediately
+    binlog_init();
+    binlog_set_live(true);
+
     ESP_LOGI(TAG, "===========================================");
     ESP_LOGI(TAG, "  Glyph C6 Monitor with Zigbee");
     ESP_LOGI(TAG, "  Board: ESP32-C6-MINI-1");
@@ -357,6 +678,14 @@ void app_main(void)
 
     // Initialize GPIO
     gpio_init();
+    
+    // Runtime tuning written over Zigbee (NVS), then power policy
+    // (USB = fresh profile, battery = frugal profile)
+    perf_config_init();
+    power_policy_init();
+    
+    // Flash reading history (survives coordinator outages)
+    history_log_init();
 
     // Print chip information
     esp_chip_info_t chip_info;
@@ -367,10 +696,10 @@ void app_main(void)
     
     uint32_t flash_size;
     esp_flash_get_size(NULL, &flash_size);
-    ESP_LOGI(TAG, "Flash: %lu MB %s", 
+    ESP_LOGI(TAG, "Flash: %" PRIu32 " MB %s", 
              flash_size / (1024 * 1024),
              (chip_info.features & CHIP_FEATURE_EMB_FLASH) ? "embedded" : "external");
-    ESP_LOGI(TAG, "Free heap: %lu bytes", esp_get_free_heap_size());
+    ESP_LOGI(TAG, "Free heap: %" PRIu32 " bytes", esp_get_free_heap_size());
 
     // Wait for I2C sensors to power up
     ESP_LOGI(TAG, "");
@@ -395,6 +724,18 @@ void app_main(void)
         ESP_LOGI(TAG, "I2C bus initialized successfully (SDA=%d, SCL=%d)", I2C_SDA_PIN, I2C_SCL_PIN);
     }
 
+#if CONFIG_PM_ENABLE && CONFIG_GLYPH_PM_LIGHT_SLEEP
+    // Automatic light sleep between events (tickless idle)
+    esp_pm_config_t pm_config = {
+        .max_freq_mhz = CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ,
+        .min_freq_mhz = CONFIG_XTAL_FREQ,
+        .light_sleep_enable = true,
+    };
+    ESP_ERROR_CHECK(esp_pm_configure(&pm_config));
+    zigbee_core_set_sleep_enabled(true);
+    ESP_LOGI(TAG, "Automatic light sleep enabled");
+#endif
+
     // Initialize Zigbee core system
     ESP_LOGI(TAG, "Initializing Zigbee SDK...");
     
@@ -433,48 +774,33 @@ void app_main(void)
     ESP_LOGI(TAG, "Waiting for Zigbee main loop to stabilize...");
     vTaskDelay(pdMS_TO_TICKS(100));
 
-    // Initialize battery monitoring
+    // Initialize battery monitoring (sampled by the app loop - no background task)
     ESP_LOGI(TAG, "Initializing battery monitoring...");
     esp_err_t battery_ret = battery_monitoring_init();
     if (battery_ret == ESP_OK) {
         ESP_LOGI(TAG, "Battery monitoring initialized successfully");
-        
-        // Start battery monitoring task
-        battery_ret = battery_monitoring_start_task();
-        if (battery_ret == ESP_OK) {
-            ESP_LOGI(TAG, "Battery monitoring task started");
-        } else {
-            ESP_LOGW(TAG, "Failed to start battery monitoring task: %s", esp_err_to_name(battery_ret));
-        }
     } else {
         ESP_LOGW(TAG, "Failed to initialize battery monitoring: %s", esp_err_to_name(battery_ret));
     }
 
-    // Initialize soil sensor (pass I2C bus handle)
+    // Initialize soil sensor (pass I2C bus handle, sampled by the app loop)
     ESP_LOGI(TAG, "Initializing soil moisture sensor...");
     esp_err_t soil_ret = soil_sensor_init(bus_handle);
     if (soil_ret == ESP_OK) {
         ESP_LOGI(TAG, "Soil sensor initialized successfully");
-        
-        // Start soil monitoring task
-        soil_ret = soil_sensor_start_task();
-        if (soil_ret == ESP_OK) {
-            ESP_LOGI(TAG, "Soil monitoring task started (reads every 60 seconds)");
-        } else {
-            ESP_LOGW(TAG, "Failed to start soil monitoring task: %s", esp_err_to_name(soil_ret));
-        }
     } else {
         ESP_LOGW(TAG, "Soil sensor not found or failed to initialize");
         ESP_LOGW(TAG, "Continuing without soil monitoring...");
     }
 
-    // Create status monitoring task
-    xTaskCreate(status_task, "status_task", 4096, NULL, 5, NULL);
-    ESP_LOGI(TAG, "Status monitoring task started");
+    // Start the event-driven status loop (timers + event queue)
+    if (status_scheduler_start() == ESP_OK) {
+        ESP_LOGI(TAG, "Status scheduler started");
+    }
 
     ESP_LOGI(TAG, "Application started successfully");
-    ESP_LOGI(TAG, "Free heap: %lu bytes", esp_get_free_heap_size());
+    ESP_LOGI(TAG, "Free heap: %" PRIu32 " bytes", esp_get_free_heap_size());
     ESP_LOGI(TAG, "Zigbee device ready for commissioning");
     ESP_LOGI(TAG, "Use Zigbee2MQTT or Home Assistant to pair and control LED");
-    ESP_LOGI(TAG, "Soil reporting: 1 hour | Battery reporting: 4 hours (ultra power saving)");
+    ESP_LOGI(TAG, "Soil reporting: profile heartbeat + deadband | Battery reporting: 4 hours");
 }
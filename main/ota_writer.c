@@ -0,0 +1,409 @@
+/*
+ * Glyph C6 Monitor - OTA Image Writer
+ *
+ * Version: 1.0.0
+ */
+
+#include "ota_writer.h"
+#include "system_config.h"
+#include "binlog.h"
+#include "esp_ota_ops.h"
+#include "esp_partition.h"
+#include "esp_timer.h"
+#include "mbedtls/sha256.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <string.h>
+
+static const char *TAG = "OTA_WRITER";
+
+// ============================================================================
+// IMAGE FORMAT
+// ============================================================================
+
+#define OTA_SECTOR_SIZE          4096
+#define OTA_TAG_HEADER_LEN       6             // Tag id (u16 LE) + length (u32 LE)
+#define OTA_TAG_UPGRADE_IMAGE    0x0000
+#define OTA_DIGEST_LEN           32            // SHA-256 appended to the app image
+#define OTA_IMAGE_MAGIC          0xE9          // esp_image_header_t.magic
+#define OTA_HASH_APPENDED_OFFSET 23            // esp_image_header_t.hash_appended
+
+// ============================================================================
+// PRIVATE VARIABLES
+// ============================================================================
+
+typedef struct {
+    uint8_t *data;
+    uint32_t offset;              // Slot offset of the first byte
+    uint32_t len;
+    volatile bool pending;        // Full, waiting for flash (set by Zigbee, cleared by loop)
+} ota_page_t;
+
+static SemaphoreHandle_t flash_mutex = NULL;
+static const esp_partition_t *partition = NULL;
+static ota_writer_notify_t notify_cb = NULL;
+static bool active = false;
+static volatile esp_err_t error = ESP_OK;
+
+static ota_page_t pages[2];
+static uint8_t buffers[2][OTA_WRITE_PAGE_SIZE];   // Static: no heap failure mid-upgrade
+static uint8_t fill = 0;                   // Page the Zigbee task copies into
+
+static uint8_t tag_header[OTA_TAG_HEADER_LEN];
+static uint8_t tag_received = 0;
+
+static mbedtls_sha256_context sha;
+static bool hash_appended = false;
+static uint32_t hash_end = 0;              // Image bytes covered by the digest
+static uint8_t expected_digest[OTA_DIGEST_LEN];
+
+static ota_writer_stats_t stats;
+
+// ============================================================================
+// PRIVATE FUNCTIONS (flash side, caller holds flash_mutex)
+// ============================================================================
+
+static uint32_t erase_limit(void)
+{
+    if (stats.image_size == 0) {
+        return partition->size;    // Size not known yet: stay within the slot
+    }
+    return (stats.image_size + OTA_SECTOR_SIZE - 1) / OTA_SECTOR_SIZE * OTA_SECTOR_SIZE;
+}
+
+static void fail(esp_err_t ret, const char *what)
+{
+    if (error == ESP_OK) {
+        error = ret;
+        BLOG_E(TAG, "%s failed: %s", what, esp_err_to_name(ret));
+    }
+}
+
+/**
+ * @brief Erase sectors until end (sector-aligned) is erased
+ */
+static void erase_to(uint32_t end)
+{
+    while (error == ESP_OK && stats.erased < end) {
+        int64_t t0 = esp_timer_get_time();
+        esp_err_t ret = esp_partition_erase_range(partition, stats.erased, OTA_SECTOR_SIZE);
+        stats.flash_us += (uint32_t)(esp_timer_get_time() - t0);
+        if (ret != ESP_OK) {
+            fail(ret, "Erase");
+            return;
+        }
+        stats.erased += OTA_SECTOR_SIZE;
+    }
+}
+
+/**
+ * @brief Keep OTA_ERASE_AHEAD_SECTORS erased past the write position
+ */
+static void erase_ahead(void)
+{
+    uint32_t target = stats.written + OTA_ERASE_AHEAD_SECTORS * OTA_SECTOR_SIZE;
+    uint32_t limit = erase_limit();
+    erase_to(target < limit ? target : limit);
+}
+
+/**
+ * @brief Feed image bytes to the hash; the appended digest is kept aside
+ */
+static void hash_bytes(uint32_t offset, const uint8_t *data, uint32_t len)
+{
+    if (offset == 0) {
+        hash_appended = stats.image_size > OTA_HASH_APPENDED_OFFSET + OTA_DIGEST_LEN &&
+                        data[OTA_HASH_APPENDED_OFFSET] == 1;
+        hash_end = hash_appended ? stats.image_size - OTA_DIGEST_LEN : stats.image_size;
+    }
+    uint32_t end = offset + len;
+    if (offset < hash_end) {
+        uint32_t n = (end < hash_end ? end : hash_end) - offset;
+        mbedtls_sha256_update(&sha, data, n);
+    }
+    if (end > hash_end) {
+        uint32_t from = offset > hash_end ? offset : hash_end;
+        memcpy(expected_digest + (from - hash_end), data + (from - offset), end - from);
+    }
+}
+
+/**
+ * @brief Hash and program one full page
+ */
+static void program_page(ota_page_t *page)
+{
+    if (!page->pending) {
+        return;
+    }
+    if (error == ESP_OK && page->offset == 0 && page->data[0] != OTA_IMAGE_MAGIC) {
+        fail(ESP_ERR_OTA_VALIDATE_FAILED, "Image header check");
+    }
+    if (error == ESP_OK) {
+        // Erase-ahead normally got here first
+        erase_to(page->offset + (page->len + OTA_SECTOR_SIZE - 1) / OTA_SECTOR_SIZE * OTA_SECTOR_SIZE);
+    }
+    if (error == ESP_OK) {
+        hash_bytes(page->offset, page->data, page->len);
+        int64_t t0 = esp_timer_get_time();
+        esp_err_t ret = esp_partition_write(partition, page->offset, page->data, page->len);
+        stats.flash_us += (uint32_t)(esp_timer_get_time() - t0);
+        if (ret == ESP_OK) {
+            stats.written += page->len;
+            stats.pages++;
+        } else {
+            fail(ret, "Write");
+        }
+    }
+    page->pending = false;
+}
+
+/**
+ * @brief Program pending pages in image order
+ */
+static void program_pending(void)
+{
+    ota_page_t *a = &pages[0];
+    ota_page_t *b = &pages[1];
+    if (a->pending && b->pending && b->offset < a->offset) {
+        a = &pages[1];
+        b = &pages[0];
+    }
+    program_page(a);
+    program_page(b);
+}
+
+static void release(void)
+{
+    memset(pages, 0, sizeof(pages));
+    mbedtls_sha256_free(&sha);
+    active = false;
+}
+
+// ============================================================================
+// PRIVATE FUNCTIONS (Zigbee side)
+// ============================================================================
+
+/**
+ * @brief Parse the upgrade image tag header
+ */
+static esp_err_t parse_tag(void)
+{
+    uint16_t tag = (uint16_t)(tag_header[0] | (tag_header[1] << 8));
+    uint32_t len = (uint32_t)tag_header[2] | ((uint32_t)tag_header[3] << 8) |
+                   ((uint32_t)tag_header[4] << 16) | ((uint32_t)tag_header[5] << 24);
+    if (tag != OTA_TAG_UPGRADE_IMAGE) {
+        BLOG_E(TAG, "Unsupported OTA element tag 0x%04x", tag);
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    if (len == 0 || len > partition->size) {
+        BLOG_E(TAG, "Image of %" PRIu32 " bytes does not fit the %" PRIu32 " byte slot", len, partition->size);
+        return ESP_ERR_INVALID_SIZE;
+    }
+    stats.image_size = len;
+    BLOG_I(TAG, "Image: %" PRIu32 " bytes into %s", len, partition->label);
+    return ESP_OK;
+}
+
+/**
+ * @brief Hand the filled page to the app loop and switch buffers
+ */
+static void hand_off(void)
+{
+    ota_page_t *full = &pages[fill];
+    full->pending = true;
+    if (notify_cb) {
+        notify_cb();
+    }
+
+    fill ^= 1;
+    ota_page_t *next = &pages[fill];
+    if (next->pending) {
+        // Flash a whole page behind: program it here rather than overwrite it
+        xSemaphoreTake(flash_mutex, portMAX_DELAY);
+        if (next->pending) {
+            stats.stalls++;
+            program_page(next);
+        }
+        xSemaphoreGive(flash_mutex);
+    }
+    next->offset = stats.received;
+    next->len = 0;
+}
+
+// ============================================================================
+// PUBLIC FUNCTIONS
+// ============================================================================
+
+esp_err_t ota_writer_begin(ota_writer_notify_t notify)
+{
+    if (!flash_mutex) {
+        flash_mutex = xSemaphoreCreateMutex();
+        if (!flash_mutex) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    if (active) {
+        BLOG_W(TAG, "Restarting a running download");
+        ota_writer_abort();
+    }
+
+    partition = esp_ota_get_next_update_partition(NULL);
+    if (!partition) {
+        BLOG_E(TAG, "No OTA update slot");
+        return ESP_ERR_NOT_FOUND;
+    }
+    memset(pages, 0, sizeof(pages));
+    pages[0].data = buffers[0];
+    pages[1].data = buffers[1];
+    fill = 0;
+    tag_received = 0;
+    memset(&stats, 0, sizeof(stats));
+    hash_appended = false;
+    hash_end = 0;
+    mbedtls_sha256_init(&sha);
+    mbedtls_sha256_starts(&sha, 0);
+    notify_cb = notify;
+    error = ESP_OK;
+    active = true;
+
+    BLOG_I(TAG, "Download into %s (0x%" PRIx32 ", %" PRIu32 " bytes)", partition->label, partition->address, partition->size);
+
+    // First erase-ahead runs while the first blocks arrive
+    if (notify_cb) {
+        notify_cb();
+    }
+    return ESP_OK;
+}
+
+esp_err_t ota_writer_write(const uint8_t *data, size_t len)
+{
+    if (!active) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (error != ESP_OK) {
+        return error;
+    }
+
+    while (len > 0) {
+        if (tag_received < OTA_TAG_HEADER_LEN) {
+            tag_header[tag_received++] = *data++;
+            len--;
+            if (tag_received == OTA_TAG_HEADER_LEN && (error = parse_tag()) != ESP_OK) {
+                return error;
+            }
+            continue;
+        }
+        if (stats.received >= stats.image_size) {
+            break;  // Further sub-elements are not part of the app image
+        }
+
+        ota_page_t *page = &pages[fill];
+        uint32_t n = OTA_WRITE_PAGE_SIZE - page->len;
+        if (n > len) {
+            n = (uint32_t)len;
+        }
+        if (n > stats.image_size - stats.received) {
+            n = stats.image_size - stats.received;
+        }
+        memcpy(page->data + page->len, data, n);
+        page->len += n;
+        stats.received += n;
+        data += n;
+        len -= n;
+
+        if (page->len == OTA_WRITE_PAGE_SIZE || stats.received == stats.image_size) {
+            hand_off();
+        }
+    }
+    return error;
+}
+
+void ota_writer_process(void)
+{
+    if (!flash_mutex) {
+        return;
+    }
+    xSemaphoreTake(flash_mutex, portMAX_DELAY);
+    if (active && error == ESP_OK) {
+        program_pending();
+        erase_ahead();
+    }
+    xSemaphoreGive(flash_mutex);
+}
+
+bool ota_writer_complete(void)
+{
+    return active && error == ESP_OK && stats.image_size > 0 && stats.received == stats.image_size;
+}
+
+esp_err_t ota_writer_finish(void)
+{
+    if (!flash_mutex) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    xSemaphoreTake(flash_mutex, portMAX_DELAY);
+    if (!active) {
+        xSemaphoreGive(flash_mutex);
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    esp_err_t ret = error;
+    if (ret == ESP_OK && (stats.image_size == 0 || stats.received != stats.image_size)) {
+        BLOG_E(TAG, "Image incomplete: %" PRIu32 " of %" PRIu32 " bytes", stats.received, stats.image_size);
+        ret = ESP_ERR_INVALID_SIZE;
+    }
+    if (ret == ESP_OK) {
+        program_pending();
+        ret = error;
+    }
+
+    uint8_t digest[OTA_DIGEST_LEN];
+    if (ret == ESP_OK) {
+        mbedtls_sha256_finish(&sha, digest);
+        if (hash_appended && memcmp(digest, expected_digest, OTA_DIGEST_LEN) != 0) {
+            BLOG_E(TAG, "Image digest mismatch - not switching slots");
+            ret = ESP_ERR_INVALID_CRC;
+        }
+    }
+    if (ret == ESP_OK) {
+        // Verifies the image once more (esp_image_verify) before writing otadata
+        ret = esp_ota_set_boot_partition(partition);
+        if (ret != ESP_OK) {
+            BLOG_E(TAG, "Boot partition switch failed: %s", esp_err_to_name(ret));
+        }
+    }
+    if (ret == ESP_OK) {
+        BLOG_I(TAG, "Image in %s: %" PRIu32 " bytes, %" PRIu32 " pages, %" PRIu32 " sectors erased, flash %" PRIu32 " ms, %" PRIu32 " stalls%s",
+               partition->label, stats.written, stats.pages, stats.erased / OTA_SECTOR_SIZE,
+               stats.flash_us / 1000, stats.stalls, hash_appended ? ", digest ok" : "");
+    }
+
+    release();
+    xSemaphoreGive(flash_mutex);
+    return ret;
+}
+
+void ota_writer_abort(void)
+{
+    if (!flash_mutex) {
+        return;
+    }
+    xSemaphoreTake(flash_mutex, portMAX_DELAY);
+    if (active) {
+        BLOG_W(TAG, "Download dropped at %" PRIu32 " of %" PRIu32 " bytes", stats.received, stats.image_size);
+        release();
+    }
+    xSemaphoreGive(flash_mutex);
+}
+
+bool ota_writer_active(void)
+{
+    return active;
+}
+
+void ota_writer_get_stats(ota_writer_stats_t *out)
+{
+    if (out) {
+        *out = stats;
+    }
+}
@@ -0,0 +1,109 @@
+/*
+ * Glyph C6 Monitor - OTA Image Writer
+ *
+ * Version: 1.0.0
+ *
+ * Streams a Zigbee OTA download into the inactive app slot (ota_0/ota_1)
+ * without flash work in the Zigbee task:
+ *
+ * - Blocks are copied into one of two 4 KB page buffers. A full page is
+ *   handed to the app loop (notify callback) and the other buffer takes
+ *   the next blocks, so the Zigbee callback is a memcpy
+ * - The app loop hashes (SHA-256) and programs each page in order and
+ *   keeps OTA_ERASE_AHEAD_SECTORS erased ahead of the write position,
+ *   instead of erasing the whole 1.5 MB slot when the download starts
+ * - At finish the running hash is checked against the digest the ESP-IDF
+ *   image carries in its last 32 bytes before the slot becomes the boot
+ *   partition, so a corrupt image never touches otadata
+ *
+ * Should the app loop fall a whole page behind, the Zigbee task programs
+ * the older page itself (counted as a stall) rather than drop data.
+ *
+ * Payload is the upgrade image sub-element of the OTA file: a 6-byte tag
+ * header (tag id 0x0000, length) followed by the ESP-IDF app image.
+ */
+
+#ifndef OTA_WRITER_H
+#define OTA_WRITER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+// Called when a page is ready for flash (Zigbee task context, never blocks)
+typedef void (*ota_writer_notify_t)(void);
+
+// Progress of the current (or last) download
+typedef struct {
+    uint32_t image_size;          // App image bytes (0 until the tag header arrived)
+    uint32_t received;            // Image bytes received
+    uint32_t written;             // Image bytes programmed
+    uint32_t erased;              // Slot bytes erased from offset 0
+    uint32_t pages;               // Pages programmed
+    uint32_t stalls;              // Pages the Zigbee task had to program itself
+    uint32_t flash_us;            // Time spent erasing and programming
+} ota_writer_stats_t;
+
+/**
+ * @brief Start a download into the inactive app slot
+ *
+ * Allocates the page buffers and asks for the first erase-ahead; restarts
+ * a download that was still running.
+ *
+ * @param notify Called whenever ota_writer_process() has work
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND without an update slot,
+ *         ESP_ERR_NO_MEM if the buffers cannot be allocated
+ */
+esp_err_t ota_writer_begin(ota_writer_notify_t notify);
+
+/**
+ * @brief Take received OTA payload (Zigbee task)
+ *
+ * Copies into the page buffers only; flash work is left to
+ * ota_writer_process(). Bytes after the image are ignored.
+ *
+ * @param data Payload bytes
+ * @param len Payload length
+ * @return ESP_OK, or the first error of this download (abort it)
+ */
+esp_err_t ota_writer_write(const uint8_t *data, size_t len);
+
+/**
+ * @brief Program full pages and erase ahead (app loop, after notify)
+ */
+void ota_writer_process(void);
+
+/**
+ * @brief Whole image received without error
+ */
+bool ota_writer_complete(void);
+
+/**
+ * @brief Program the rest, check the digest and select the new slot for boot
+ *
+ * Frees the buffers; the caller restarts into the new image on success.
+ *
+ * @return ESP_OK on success, ESP_ERR_INVALID_SIZE if the image is
+ *         incomplete, ESP_ERR_INVALID_CRC on a digest mismatch, or the
+ *         flash / boot partition error
+ */
+esp_err_t ota_writer_finish(void);
+
+/**
+ * @brief Drop the download (slot left as written, boot partition untouched)
+ */
+void ota_writer_abort(void);
+
+/**
+ * @brief Download running (between begin and finish/abort)
+ */
+bool ota_writer_active(void);
+
+/**
+ * @brief Progress of the current or last download
+ * @param stats Output
+ */
+void ota_writer_get_stats(ota_writer_stats_t *stats);
+
+#endif // OTA_WRITER_H
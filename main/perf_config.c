@@ -0,0 +1,253 @@
+/*
+ * Glyph C6 Monitor - Runtime Performance Configuration
+ *
+ * Version: 1.0.0
+ */
+
+#include "perf_config.h"
+#include "system_config.h"
+#include "binlog.h"
+#include "esp_attr.h"
+#include "nvs.h"
+#include <string.h>
+
+static const char *TAG = "PERF_CONFIG";
+
+// ============================================================================
+// PARAMETERS (bounds match the Kconfig ranges)
+// ============================================================================
+
+static const perf_param_desc_t params[PERF_PARAM_COUNT] = {
+    [PERF_PARAM_BATT_SAMPLE_INTERVAL_SEC]     = { "batt_sample_s",   4, 10,  86400,  POWER_FRUGAL_SAMPLE_INTERVAL_SEC },
+    [PERF_PARAM_BATT_REPORT_INTERVAL_SEC]     = { "batt_report_s",   4, 10,  259200, POWER_FRUGAL_REPORT_INTERVAL_SEC },
+    [PERF_PARAM_BATT_NUM_SAMPLES]             = { "batt_samples",    1, 1,   16,     POWER_FRUGAL_NUM_SAMPLES },
+    [PERF_PARAM_BATT_SAMPLE_SPACING_MS]       = { "batt_spacing_ms", 2, 100, 60000,  POWER_FRUGAL_SAMPLE_SPACING_MS },
+    [PERF_PARAM_BATT_MOISTURE_DEADBAND_CENTI] = { "batt_moist_db",   2, 0,   10000,  CONFIG_GLYPH_BATT_MOISTURE_DEADBAND_CENTI },
+    [PERF_PARAM_BATT_TEMP_DEADBAND_CENTI]     = { "batt_temp_db",    2, 0,   10000,  CONFIG_GLYPH_BATT_TEMP_DEADBAND_CENTI },
+    [PERF_PARAM_USB_SAMPLE_INTERVAL_SEC]      = { "usb_sample_s",    4, 5,   86400,  POWER_FRESH_SAMPLE_INTERVAL_SEC },
+    [PERF_PARAM_USB_REPORT_INTERVAL_SEC]      = { "usb_report_s",    4, 5,   259200, POWER_FRESH_REPORT_INTERVAL_SEC },
+    [PERF_PARAM_USB_NUM_SAMPLES]              = { "usb_samples",     1, 1,   16,     POWER_FRESH_NUM_SAMPLES },
+    [PERF_PARAM_USB_SAMPLE_SPACING_MS]        = { "usb_spacing_ms",  2, 100, 60000,  POWER_FRESH_SAMPLE_SPACING_MS },
+    [PERF_PARAM_USB_MOISTURE_DEADBAND_CENTI]  = { "usb_moist_db",    2, 0,   10000,  CONFIG_GLYPH_USB_MOISTURE_DEADBAND_CENTI },
+    [PERF_PARAM_USB_TEMP_DEADBAND_CENTI]      = { "usb_temp_db",     2, 0,   10000,  CONFIG_GLYPH_USB_TEMP_DEADBAND_CENTI },
+    [PERF_PARAM_SENSE_INTERVAL_SEC]           = { "sense_s",         4, 30,  86400,  WATERING_SENSE_INTERVAL_SEC },
+};
+
+#define PERF_NVS_NAMESPACE       "perf_cfg"
+#define PERF_NVS_KEY_STAGED      "staged"     // Last written set (may be pending)
+#define PERF_NVS_KEY_ACTIVE      "active"     // Last applied set
+#define PERF_RTC_MAGIC           0x50434647   // "PCFG"
+
+// ============================================================================
+// RTC MEMORY (persists across deep sleep)
+// ============================================================================
+
+typedef struct {
+    uint32_t magic;                       // PERF_RTC_MAGIC once loaded
+    bool staged_dirty;                    // Staged set written since the last apply
+    uint32_t active[PERF_PARAM_COUNT];
+    uint32_t staged[PERF_PARAM_COUNT];
+} perf_config_state_t;
+
+static RTC_DATA_ATTR perf_config_state_t rtc_cfg;
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+static void load_defaults(uint32_t *values)
+{
+    for (int i = 0; i < PERF_PARAM_COUNT; i++) {
+        values[i] = params[i].def;
+    }
+}
+
+static bool in_bounds(perf_param_t param, uint32_t value)
+{
+    return value >= params[param].min && value <= params[param].max;
+}
+
+/**
+ * @brief Check a full parameter set (same rules as the build-time asserts)
+ */
+static bool set_is_consistent(const uint32_t *v)
+{
+    for (int i = 0; i < PERF_PARAM_COUNT; i++) {
+        if (!in_bounds(i, v[i])) {
+            return false;
+        }
+    }
+    return v[PERF_PARAM_BATT_REPORT_INTERVAL_SEC] >= v[PERF_PARAM_BATT_SAMPLE_INTERVAL_SEC] &&
+           v[PERF_PARAM_USB_REPORT_INTERVAL_SEC] >= v[PERF_PARAM_USB_SAMPLE_INTERVAL_SEC] &&
+           (uint64_t)v[PERF_PARAM_BATT_NUM_SAMPLES] * v[PERF_PARAM_BATT_SAMPLE_SPACING_MS] <
+               (uint64_t)v[PERF_PARAM_BATT_SAMPLE_INTERVAL_SEC] * 1000 &&
+           (uint64_t)v[PERF_PARAM_USB_NUM_SAMPLES] * v[PERF_PARAM_USB_SAMPLE_SPACING_MS] <
+               (uint64_t)v[PERF_PARAM_USB_SAMPLE_INTERVAL_SEC] * 1000 &&
+           v[PERF_PARAM_USB_SAMPLE_INTERVAL_SEC] <= v[PERF_PARAM_BATT_SAMPLE_INTERVAL_SEC] &&
+           v[PERF_PARAM_SENSE_INTERVAL_SEC] <= v[PERF_PARAM_BATT_SAMPLE_INTERVAL_SEC] &&
+           v[PERF_PARAM_SENSE_INTERVAL_SEC] > WATERING_BURST_INTERVAL_SEC &&
+           (uint64_t)ZIGBEE_JOIN_TIMEOUT_MS + ZIGBEE_TX_LINGER_MS <
+               (uint64_t)v[PERF_PARAM_BATT_SAMPLE_INTERVAL_SEC] * 1000;
+}
+
+static bool nvs_load_set(nvs_handle_t nvs, const char *key, uint32_t *values)
+{
+    uint32_t tmp[PERF_PARAM_COUNT];
+    size_t len = sizeof(tmp);
+    // A size mismatch (parameter list changed by a firmware update) counts as absent
+    if (nvs_get_blob(nvs, key, tmp, &len) != ESP_OK || len != sizeof(tmp)) {
+        return false;
+    }
+    memcpy(values, tmp, sizeof(tmp));
+    return true;
+}
+
+static esp_err_t nvs_store_set(const char *key, const uint32_t *values)
+{
+    nvs_handle_t nvs;
+    esp_err_t ret = nvs_open(PERF_NVS_NAMESPACE, NVS_READWRITE, &nvs);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    ret = nvs_set_blob(nvs, key, values, sizeof(uint32_t) * PERF_PARAM_COUNT);
+    if (ret == ESP_OK) {
+        ret = nvs_commit(nvs);
+    }
+    nvs_close(nvs);
+    return ret;
+}
+
+/**
+ * @brief Cold boot: restore active and staged sets from NVS
+ */
+static void load_from_nvs(void)
+{
+    load_defaults(rtc_cfg.active);
+    load_defaults(rtc_cfg.staged);
+    rtc_cfg.staged_dirty = false;
+
+    nvs_handle_t nvs;
+    if (nvs_open(PERF_NVS_NAMESPACE, NVS_READONLY, &nvs) != ESP_OK) {
+        return;  // Nothing stored yet - Kconfig defaults
+    }
+    uint32_t values[PERF_PARAM_COUNT];
+    if (nvs_load_set(nvs, PERF_NVS_KEY_ACTIVE, values) && set_is_consistent(values)) {
+        memcpy(rtc_cfg.active, values, sizeof(values));
+        memcpy(rtc_cfg.staged, values, sizeof(values));
+    }
+    if (nvs_load_set(nvs, PERF_NVS_KEY_STAGED, values)) {
+        memcpy(rtc_cfg.staged, values, sizeof(values));
+        rtc_cfg.staged_dirty = (memcmp(rtc_cfg.staged, rtc_cfg.active, sizeof(values)) != 0);
+    }
+    nvs_close(nvs);
+}
+
+// ============================================================================
+// PUBLIC FUNCTIONS
+// ============================================================================
+
+esp_err_t perf_config_init(void)
+{
+    if (rtc_cfg.magic != PERF_RTC_MAGIC) {
+        load_from_nvs();
+        rtc_cfg.magic = PERF_RTC_MAGIC;
+    }
+
+    perf_config_apply_pending();
+
+    BLOG_I(TAG, "Config: batt %" PRIu32 "s/%" PRIu32 "s x%" PRIu32 ", usb %" PRIu32 "s/%" PRIu32 "s x%" PRIu32 ", sense %" PRIu32 "s%s",
+           rtc_cfg.active[PERF_PARAM_BATT_SAMPLE_INTERVAL_SEC],
+           rtc_cfg.active[PERF_PARAM_BATT_REPORT_INTERVAL_SEC],
+           rtc_cfg.active[PERF_PARAM_BATT_NUM_SAMPLES],
+           rtc_cfg.active[PERF_PARAM_USB_SAMPLE_INTERVAL_SEC],
+           rtc_cfg.active[PERF_PARAM_USB_REPORT_INTERVAL_SEC],
+           rtc_cfg.active[PERF_PARAM_USB_NUM_SAMPLES],
+           rtc_cfg.active[PERF_PARAM_SENSE_INTERVAL_SEC],
+           perf_config_pending() ? " (change pending)" : "");
+    return ESP_OK;
+}
+
+uint32_t perf_config_get(perf_param_t param)
+{
+    if (param >= PERF_PARAM_COUNT) {
+        return 0;
+    }
+    return (rtc_cfg.magic == PERF_RTC_MAGIC) ? rtc_cfg.active[param] : params[param].def;
+}
+
+const perf_param_desc_t *perf_config_describe(perf_param_t param)
+{
+    return (param < PERF_PARAM_COUNT) ? &params[param] : NULL;
+}
+
+esp_err_t perf_config_check(perf_param_t param, uint32_t value)
+{
+    if (param >= PERF_PARAM_COUNT || rtc_cfg.magic != PERF_RTC_MAGIC) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (!in_bounds(param, value)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    uint32_t values[PERF_PARAM_COUNT];
+    memcpy(values, rtc_cfg.staged, sizeof(values));
+    values[param] = value;
+    if (set_is_consistent(rtc_cfg.staged) && !set_is_consistent(values)) {
+        BLOG_W(TAG, "Rejected %s=%" PRIu32 " (inconsistent with the staged set)", params[param].name, value);
+        return ESP_ERR_INVALID_ARG;
+    }
+    return ESP_OK;
+}
+
+esp_err_t perf_config_set(perf_param_t param, uint32_t value)
+{
+    if (param >= PERF_PARAM_COUNT || rtc_cfg.magic != PERF_RTC_MAGIC) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (!in_bounds(param, value)) {
+        BLOG_W(TAG, "Rejected %s=%" PRIu32 " (allowed %" PRIu32 "..%" PRIu32 ")", params[param].name, value,
+               params[param].min, params[param].max);
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (rtc_cfg.staged[param] == value) {
+        return ESP_OK;
+    }
+
+    rtc_cfg.staged[param] = value;
+    rtc_cfg.staged_dirty = true;
+    esp_err_t ret = nvs_store_set(PERF_NVS_KEY_STAGED, rtc_cfg.staged);
+    if (ret != ESP_OK) {
+        BLOG_W(TAG, "Failed to persist %s: %s", params[param].name, esp_err_to_name(ret));
+    }
+    BLOG_I(TAG, "Staged %s=%" PRIu32 " (active %" PRIu32 ") - applied at next wake", params[param].name,
+           value, rtc_cfg.active[param]);
+    return ESP_OK;
+}
+
+bool perf_config_pending(void)
+{
+    return memcmp(rtc_cfg.staged, rtc_cfg.active, sizeof(rtc_cfg.active)) != 0;
+}
+
+bool perf_config_apply_pending(void)
+{
+    if (!rtc_cfg.staged_dirty) {
+        return false;
+    }
+    rtc_cfg.staged_dirty = false;
+
+    if (!set_is_consistent(rtc_cfg.staged)) {
+        BLOG_W(TAG, "Staged config inconsistent (e.g. heartbeat < sample interval) - keeping active set");
+        return false;
+    }
+    if (!perf_config_pending()) {
+        return false;
+    }
+
+    memcpy(rtc_cfg.active, rtc_cfg.staged, sizeof(rtc_cfg.active));
+    esp_err_t ret = nvs_store_set(PERF_NVS_KEY_ACTIVE, rtc_cfg.active);
+    if (ret != ESP_OK) {
+        BLOG_W(TAG, "Failed to persist active config: %s", esp_err_to_name(ret));
+    }
+    BLOG_I(TAG, "Staged config applied");
+    return true;
+}
@@ -0,0 +1,122 @@
+/*
+ * Glyph C6 Monitor - Runtime Performance Configuration
+ *
+ * Version: 1.0.0
+ *
+ * Performance knobs (sampling, averaging, deadbands, heartbeat, sense
+ * wake interval) that can be tuned over Zigbee without a new firmware:
+ *
+ * - Defaults come from the Kconfig performance profile (system_config.h)
+ * - Writes are bounds-checked per parameter and persisted in NVS
+ * - A written set becomes active at the next wake (next sample pass in
+ *   the always-on build), after a cross-parameter consistency check;
+ *   an inconsistent set is not applied and stays pending
+ * - The active set is cached in RTC memory, so ordinary wakes never
+ *   touch NVS
+ *
+ * Deadbands are in 0.01 units (% moisture, °C), as on the air.
+ */
+
+#ifndef PERF_CONFIG_H
+#define PERF_CONFIG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+// Tunable parameters
+typedef enum {
+    PERF_PARAM_BATT_SAMPLE_INTERVAL_SEC = 0,
+    PERF_PARAM_BATT_REPORT_INTERVAL_SEC,
+    PERF_PARAM_BATT_NUM_SAMPLES,
+    PERF_PARAM_BATT_SAMPLE_SPACING_MS,
+    PERF_PARAM_BATT_MOISTURE_DEADBAND_CENTI,
+    PERF_PARAM_BATT_TEMP_DEADBAND_CENTI,
+    PERF_PARAM_USB_SAMPLE_INTERVAL_SEC,
+    PERF_PARAM_USB_REPORT_INTERVAL_SEC,
+    PERF_PARAM_USB_NUM_SAMPLES,
+    PERF_PARAM_USB_SAMPLE_SPACING_MS,
+    PERF_PARAM_USB_MOISTURE_DEADBAND_CENTI,
+    PERF_PARAM_USB_TEMP_DEADBAND_CENTI,
+    PERF_PARAM_SENSE_INTERVAL_SEC,
+    PERF_PARAM_COUNT
+} perf_param_t;
+
+// Parameter description (safe bounds and on-air size)
+typedef struct {
+    const char *name;             // Short name for logging
+    uint8_t size;                 // Attribute size in bytes (1, 2 or 4, unsigned)
+    uint32_t min;                 // Smallest accepted value
+    uint32_t max;                 // Largest accepted value
+    uint32_t def;                 // Kconfig profile default
+} perf_param_desc_t;
+
+/**
+ * @brief Initialize runtime configuration
+ *
+ * Uses the RTC-cached active set when nothing was written since the last
+ * wake; otherwise loads NVS (cold boot) or applies the pending set.
+ * Call after nvs_flash_init() and before power_policy_init().
+ *
+ * @return ESP_OK on success (falls back to Kconfig defaults on NVS errors)
+ */
+esp_err_t perf_config_init(void);
+
+/**
+ * @brief Get the active value of a parameter
+ * @param param Parameter
+ * @return Active value (Kconfig default for an invalid param)
+ */
+uint32_t perf_config_get(perf_param_t param);
+
+/**
+ * @brief Get the description of a parameter
+ * @param param Parameter
+ * @return Description, or NULL for an invalid param
+ */
+const perf_param_desc_t *perf_config_describe(perf_param_t param);
+
+/**
+ * @brief Check a value before it is written
+ *
+ * Besides the parameter bounds, the staged set with this value must keep
+ * the consistency rules (e.g. heartbeat >= sample interval), so a change
+ * of related parameters is written in an order that keeps them. A staged
+ * set that is already inconsistent is only bounds-checked.
+ *
+ * @param param Parameter
+ * @param value Proposed value
+ * @return ESP_OK if acceptable, ESP_ERR_INVALID_ARG otherwise
+ */
+esp_err_t perf_config_check(perf_param_t param, uint32_t value);
+
+/**
+ * @brief Stage a new value for the next wake
+ *
+ * The value is checked against the parameter bounds and persisted in
+ * NVS. The active value does not change until perf_config_apply_pending()
+ * (or the next perf_config_init() after deep sleep).
+ *
+ * @param param Parameter
+ * @param value New value
+ * @return ESP_OK if staged, ESP_ERR_INVALID_ARG if out of bounds
+ */
+esp_err_t perf_config_set(perf_param_t param, uint32_t value);
+
+/**
+ * @brief Check whether staged values differ from the active set
+ * @return true if a change is waiting for the next wake (or was rejected)
+ */
+bool perf_config_pending(void);
+
+/**
+ * @brief Apply staged values now (always-on build)
+ *
+ * The staged set is applied only if it is consistent as a whole
+ * (heartbeat >= sample interval, averaging fits in one interval, ...).
+ *
+ * @return true if the active set changed
+ */
+bool perf_config_apply_pending(void);
+
+#endif // PERF_CONFIG_H
@@ -0,0 +1,253 @@
+/*
+ * Glyph C6 Monitor - Power Policy Module
+ *
+ * Version: 1.0.0
+ */
+
+#include "power_policy.h"
+#include "system_config.h"
+#include "deep_sleep.h"
+#include "perf_config.h"
+#include "sensor_convert.h"
+#include "binlog.h"
+#include "esp_attr.h"
+#include <stdlib.h>
+
+static const char *TAG = "POWER_POLICY";
+
+// ============================================================================
+// PROFILES
+// ============================================================================
+
+// Timing and deadbands are filled from the runtime configuration
+static power_profile_t profiles[] = {
+    [POWER_PROFILE_FRUGAL] = {
+        .id = POWER_PROFILE_FRUGAL,
+        .name = "FRUGAL",
+        .deep_sleep = true,
+        .led_enabled = false,
+        .ota_allowed = true,
+    },
+    [POWER_PROFILE_FRESH] = {
+        .id = POWER_PROFILE_FRESH,
+        .name = "FRESH",
+        .deep_sleep = false,
+        .led_enabled = true,
+        .ota_allowed = true,
+    },
+    [POWER_PROFILE_HARVEST] = {
+        .id = POWER_PROFILE_HARVEST,
+        .name = "HARVEST",
+        .deep_sleep = true,
+        .led_enabled = false,
+        .ota_allowed = true,
+    },
+    [POWER_PROFILE_NIGHT] = {
+        .id = POWER_PROFILE_NIGHT,
+        .name = "NIGHT",
+        .deep_sleep = true,
+        .led_enabled = false,
+        .ota_allowed = false,
+    },
+};
+
+// ============================================================================
+// RTC MEMORY (persists across deep sleep)
+// ============================================================================
+
+typedef struct {
+    power_source_t source;          // Last classified power source
+    power_profile_id_t profile;     // Active profile
+    bool reported_once;             // At least one report since power-on
+    bool report_forced;             // Profile switched - next reading must be reported
+    uint16_t last_moisture;         // Last reported moisture (0.01 %)
+    int16_t last_temperature;       // Last reported temperature (0.01 °C)
+    uint32_t last_report_time;      // Last report time (RTC seconds)
+    uint32_t switch_count;          // Number of profile switches since power-on
+    charge_state_t charge;          // Pack voltage history (battery only)
+} power_policy_state_t;
+
+static RTC_DATA_ATTR power_policy_state_t rtc_policy = {
+    .source = POWER_SOURCE_UNKNOWN,
+    .profile = POWER_PROFILE_FRUGAL,
+    .reported_once = false,
+    .report_forced = false,
+    .last_moisture = 0,
+    .last_temperature = 0,
+    .last_report_time = 0,
+    .switch_count = 0,
+    .charge = { .phase = CHARGE_PHASE_UNKNOWN },
+};
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+static uint32_t max_u32(uint32_t a, uint32_t b)
+{
+    return a > b ? a : b;
+}
+
+/**
+ * @brief Battery profile for the charge phase
+ *
+ * Dark periods only save when the last harvest left the pack short (the
+ * day did not cover the night) or the pack is low anyway.
+ */
+static power_profile_id_t battery_profile(charge_phase_t phase, float battery_voltage)
+{
+    if (phase == CHARGE_PHASE_HARVEST) {
+        return POWER_PROFILE_HARVEST;
+    }
+    if (phase == CHARGE_PHASE_DARK &&
+        (!rtc_policy.charge.last_harvest_full ||
+         sensor_convert_battery_percent(battery_voltage) < CHARGE_DARK_SAVE_PERCENT)) {
+        return POWER_PROFILE_NIGHT;
+    }
+    return POWER_PROFILE_FRUGAL;
+}
+
+// ============================================================================
+// PUBLIC FUNCTIONS
+// ============================================================================
+
+esp_err_t power_policy_init(void)
+{
+    power_policy_reload_config();
+    BLOG_I(TAG, "Power policy: source=%s, profile=%s, switches=%" PRIu32,
+             power_policy_source_string(rtc_policy.source),
+             profiles[rtc_policy.profile].name, rtc_policy.switch_count);
+    return ESP_OK;
+}
+
+bool power_policy_update(float battery_voltage)
+{
+    power_source_t source = rtc_policy.source;
+
+    // Hysteresis: enter EXTERNAL above detect threshold, leave below release threshold
+    if (battery_voltage > BATT_USB_DETECT_VOLTAGE) {
+        source = POWER_SOURCE_EXTERNAL;
+    } else if (battery_voltage < BATT_USB_RELEASE_VOLTAGE || source == POWER_SOURCE_UNKNOWN) {
+        source = POWER_SOURCE_BATTERY;
+    }
+
+    rtc_policy.source = source;
+
+    power_profile_id_t profile = POWER_PROFILE_FRESH;
+    if (source == POWER_SOURCE_EXTERNAL) {
+        // The rail shows USB, not the pack: start over when back on battery
+        charge_state_reset(&rtc_policy.charge);
+    } else {
+        charge_phase_t phase = charge_state_update(&rtc_policy.charge, (uint16_t)(battery_voltage * 1000.0f),
+                                                   deep_sleep_get_time_sec());
+        profile = battery_profile(phase, battery_voltage);
+    }
+    if (profile == rtc_policy.profile) {
+        return false;
+    }
+
+    BLOG_I(TAG, "Power %s (%d mV, charge %s, %d mV/h) - profile %s -> %s",
+             power_policy_source_string(source), (int)(battery_voltage * 1000.0f),
+             charge_state_phase_string(rtc_policy.charge.phase), rtc_policy.charge.slope_mv_h,
+             profiles[rtc_policy.profile].name, profiles[profile].name);
+
+    rtc_policy.profile = profile;
+    rtc_policy.report_forced = true;
+    rtc_policy.switch_count++;
+    return true;
+}
+
+void power_policy_reload_config(void)
+{
+    power_profile_t *frugal = &profiles[POWER_PROFILE_FRUGAL];
+    frugal->sample_interval_sec = perf_config_get(PERF_PARAM_BATT_SAMPLE_INTERVAL_SEC);
+    frugal->report_interval_sec = perf_config_get(PERF_PARAM_BATT_REPORT_INTERVAL_SEC);
+    frugal->num_samples = (uint8_t)perf_config_get(PERF_PARAM_BATT_NUM_SAMPLES);
+    frugal->sample_spacing_ms = perf_config_get(PERF_PARAM_BATT_SAMPLE_SPACING_MS);
+    frugal->moisture_deadband = (uint16_t)perf_config_get(PERF_PARAM_BATT_MOISTURE_DEADBAND_CENTI);
+    frugal->temperature_deadband = (uint16_t)perf_config_get(PERF_PARAM_BATT_TEMP_DEADBAND_CENTI);
+
+    power_profile_t *fresh = &profiles[POWER_PROFILE_FRESH];
+    fresh->sample_interval_sec = perf_config_get(PERF_PARAM_USB_SAMPLE_INTERVAL_SEC);
+    fresh->report_interval_sec = perf_config_get(PERF_PARAM_USB_REPORT_INTERVAL_SEC);
+    fresh->num_samples = (uint8_t)perf_config_get(PERF_PARAM_USB_NUM_SAMPLES);
+    fresh->sample_spacing_ms = perf_config_get(PERF_PARAM_USB_SAMPLE_SPACING_MS);
+    fresh->moisture_deadband = (uint16_t)perf_config_get(PERF_PARAM_USB_MOISTURE_DEADBAND_CENTI);
+    fresh->temperature_deadband = (uint16_t)perf_config_get(PERF_PARAM_USB_TEMP_DEADBAND_CENTI);
+
+    // Harvest: FRESH sampling and deadbands at a rate the battery schedule
+    // can afford to raise; the averaged samples fit in the FRESH interval
+    power_profile_t *harvest = &profiles[POWER_PROFILE_HARVEST];
+    harvest->sample_interval_sec = max_u32(fresh->sample_interval_sec,
+                                           frugal->sample_interval_sec / CHARGE_HARVEST_RATE_DIVISOR);
+    harvest->report_interval_sec = max_u32(max_u32(fresh->report_interval_sec,
+                                                   frugal->report_interval_sec / CHARGE_HARVEST_RATE_DIVISOR),
+                                           harvest->sample_interval_sec);
+    harvest->num_samples = fresh->num_samples;
+    harvest->sample_spacing_ms = fresh->sample_spacing_ms;
+    harvest->moisture_deadband = fresh->moisture_deadband;
+    harvest->temperature_deadband = fresh->temperature_deadband;
+
+    power_profile_t *night = &profiles[POWER_PROFILE_NIGHT];
+    night->sample_interval_sec = frugal->sample_interval_sec * CHARGE_DARK_RATE_MULTIPLIER;
+    night->report_interval_sec = frugal->report_interval_sec * CHARGE_DARK_RATE_MULTIPLIER;
+    night->num_samples = frugal->num_samples;
+    night->sample_spacing_ms = frugal->sample_spacing_ms;
+    night->moisture_deadband = frugal->moisture_deadband;
+    night->temperature_deadband = frugal->temperature_deadband;
+}
+
+const power_profile_t *power_policy_get_profile(void)
+{
+    return &profiles[rtc_policy.profile];
+}
+
+power_source_t power_policy_get_source(void)
+{
+    return rtc_policy.source;
+}
+
+const charge_state_t *power_policy_get_charge_state(void)
+{
+    return &rtc_policy.charge;
+}
+
+bool power_policy_should_report(uint16_t moisture_centi, int16_t temp_centi)
+{
+    const power_profile_t *profile = power_policy_get_profile();
+
+    if (!rtc_policy.reported_once || rtc_policy.report_forced) {
+        return true;
+    }
+
+    uint32_t since_report = deep_sleep_get_time_sec() - rtc_policy.last_report_time;
+    if (since_report >= profile->report_interval_sec) {
+        return true;
+    }
+
+    if (abs((int)moisture_centi - rtc_policy.last_moisture) >= profile->moisture_deadband ||
+        abs((int)temp_centi - rtc_policy.last_temperature) >= profile->temperature_deadband) {
+        return true;
+    }
+
+    BLOG_I(TAG, "Within deadband (last report %" PRIu32 "s ago) - skipping report", since_report);
+    return false;
+}
+
+void power_policy_mark_reported(uint16_t moisture_centi, int16_t temp_centi)
+{
+    rtc_policy.reported_once = true;
+    rtc_policy.report_forced = false;
+    rtc_policy.last_moisture = moisture_centi;
+    rtc_policy.last_temperature = temp_centi;
+    rtc_policy.last_report_time = deep_sleep_get_time_sec();
+}
+
+const char *power_policy_source_string(power_source_t source)
+{
+    switch (source) {
+        case POWER_SOURCE_BATTERY:  return "BAT";
+        case POWER_SOURCE_EXTERNAL: return "USB";
+        default:                    return "???";
+    }
+}
@@ -0,0 +1,137 @@
+/*
+ * Glyph C6 Monitor - Power Policy Module
+ *
+ * Version: 1.0.0
+ *
+ * Watches the power source (USB/external vs battery) and switches the
+ * operating profile on the fly - no reboot required:
+ * - FRESH profile on external power: fast sampling, tight deadbands,
+ *   stay awake, LED allowed
+ * - FRUGAL profile on battery: hourly sampling, wide deadbands,
+ *   deep sleep between cycles, LED forced off
+ *
+ * On battery, the charge-state estimator (charge_state.h) makes the
+ * schedule energy-neutral for solar-assisted nodes:
+ * - HARVEST profile while the pack is charging: FRUGAL intervals divided
+ *   by CHARGE_HARVEST_RATE_DIVISOR with the FRESH deadbands, still deep
+ *   sleeping; surplus sunlight becomes fresher data
+ * - NIGHT profile between harvests when the last one did not fill the
+ *   pack (or the pack is low): FRUGAL intervals times
+ *   CHARGE_DARK_RATE_MULTIPLIER, no OTA sessions
+ * A node that never sees a harvest stays on FRUGAL.
+ *
+ * Policy state lives in RTC memory so it survives deep sleep.
+ */
+
+#ifndef POWER_POLICY_H
+#define POWER_POLICY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "charge_state.h"
+
+// Detected power source
+typedef enum {
+    POWER_SOURCE_UNKNOWN = 0,
+    POWER_SOURCE_BATTERY,
+    POWER_SOURCE_EXTERNAL,
+} power_source_t;
+
+// Operating profile identifiers
+typedef enum {
+    POWER_PROFILE_FRUGAL = 0,     // Battery - full frugality
+    POWER_PROFILE_FRESH,          // External power - near-real-time data
+    POWER_PROFILE_HARVEST,        // Battery, charging from the panel - spend the surplus
+    POWER_PROFILE_NIGHT,          // Battery, solar node between harvests - save
+} power_profile_id_t;
+
+// Operating profile parameters
+typedef struct {
+    power_profile_id_t id;
+    const char *name;
+    uint32_t sample_interval_sec;   // Time between sensor readings
+    uint32_t report_interval_sec;   // Heartbeat: max time between reports
+    uint8_t num_samples;            // Samples averaged per reading
+    uint32_t sample_spacing_ms;     // Delay between averaged samples
+    uint16_t moisture_deadband;     // Min moisture change (0.01 %) to report early
+    uint16_t temperature_deadband;  // Min temperature change (0.01 °C) to report early
+    bool deep_sleep;                // true = deep sleep between cycles, false = stay awake
+    bool led_enabled;               // true = LED may be driven
+    bool ota_allowed;               // true = accept coordinator OTA downloads
+} power_profile_t;
+
+/**
+ * @brief Initialize power policy (restores state from RTC memory)
+ *
+ * Call after perf_config_init() - profile timing comes from the
+ * runtime configuration.
+ *
+ * @return ESP_OK on success
+ */
+esp_err_t power_policy_init(void);
+
+/**
+ * @brief Rebuild profile timing and deadbands from the runtime configuration
+ *
+ * Call after perf_config_apply_pending() reports a change.
+ */
+void power_policy_reload_config(void);
+
+/**
+ * @brief Feed a fresh battery-rail voltage into the policy
+ *
+ * Classifies the power source with hysteresis, feeds the charge-state
+ * estimator on battery and switches the active profile when the source
+ * or the charge phase changes.
+ *
+ * @param battery_voltage Measured voltage on the battery rail (V)
+ * @return true if the active profile changed with this update
+ */
+bool power_policy_update(float battery_voltage);
+
+/**
+ * @brief Get the active operating profile
+ * @return Pointer to the active profile (never NULL)
+ */
+const power_profile_t *power_policy_get_profile(void);
+
+/**
+ * @brief Get the currently detected power source
+ * @return power_source_t value
+ */
+power_source_t power_policy_get_source(void);
+
+/**
+ * @brief Get the charge-state estimator (valid on battery)
+ * @return Pointer to the estimator state (never NULL)
+ */
+const charge_state_t *power_policy_get_charge_state(void);
+
+/**
+ * @brief Check whether a reading should be reported to the coordinator
+ *
+ * True on first report, after a profile switch, when the heartbeat
+ * interval elapsed, or when a value moved beyond the profile deadband.
+ *
+ * @param moisture_centi Current soil moisture (0.01 %)
+ * @param temp_centi Current soil temperature (0.01 °C)
+ * @return true if a report should be sent
+ */
+bool power_policy_should_report(uint16_t moisture_centi, int16_t temp_centi);
+
+/**
+ * @brief Record that a reading was reported (resets deadband/heartbeat)
+ * @param moisture_centi Reported soil moisture (0.01 %)
+ * @param temp_centi Reported soil temperature (0.01 °C)
+ */
+void power_policy_mark_reported(uint16_t moisture_centi, int16_t temp_centi);
+
+/**
+ * @brief Get power source name for logging
+ * @param source power_source_t value
+ * @return Short string ("USB", "BAT", "???")
+ */
+const char *power_policy_source_string(power_source_t source);
+
+#endif // POWER_POLICY_H
@@ -0,0 +1,162 @@
+/*
+ * Glyph C6 Monitor - Reading Codec
+ *
+ * Version: 1.0.0
+ */
+
+#include "reading_codec.h"
+#include <stdbool.h>
+
+#define TAG_TIME                0x80
+#define TAG_MOISTURE_SHIFT      3
+#define TAG_MOISTURE_ESCAPE     15
+#define TAG_TEMP_MASK           0x07
+#define TAG_TEMP_ESCAPE         6
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+static size_t varint_len(uint32_t value)
+{
+    size_t len = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        len++;
+    }
+    return len;
+}
+
+static uint8_t *put_varint(uint8_t *p, uint32_t value)
+{
+    while (value >= 0x80) {
+        *p++ = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    *p++ = (uint8_t)value;
+    return p;
+}
+
+/**
+ * @brief Read a varint of at most 5 bytes; NULL if truncated
+ */
+static const uint8_t *get_varint(const uint8_t *p, const uint8_t *end, uint32_t *value)
+{
+    uint32_t result = 0;
+    for (unsigned shift = 0; shift < 35 && p < end; shift += 7) {
+        uint8_t byte = *p++;
+        result |= (uint32_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            *value = result;
+            return p;
+        }
+    }
+    return NULL;
+}
+
+// ============================================================================
+// PUBLIC FUNCTIONS
+// ============================================================================
+
+void reading_codec_begin(reading_codec_state_t *state, const history_reading_t *first)
+{
+    state->last = *first;
+    state->interval = 0;
+}
+
+size_t reading_codec_encode(reading_codec_state_t *state, const history_reading_t *reading,
+                            uint8_t *out, size_t cap)
+{
+    uint32_t dt = reading->time - state->last.time;
+    uint32_t z_time = reading_codec_zigzag((int32_t)(dt - state->interval));
+    uint32_t z_moisture = reading_codec_zigzag((int16_t)(reading->moisture_centi - state->last.moisture_centi));
+    uint32_t z_temp = reading_codec_zigzag((int16_t)(reading->temp_centi - state->last.temp_centi));
+
+    bool time_changed = dt != state->interval;
+    uint8_t m = z_moisture < TAG_MOISTURE_ESCAPE ? (uint8_t)z_moisture : TAG_MOISTURE_ESCAPE;
+    uint8_t c = z_temp < TAG_TEMP_ESCAPE ? (uint8_t)z_temp : TAG_TEMP_ESCAPE;
+
+    size_t len = 1;
+    if (time_changed) {
+        len += varint_len(z_time);
+    }
+    if (m == TAG_MOISTURE_ESCAPE) {
+        len += varint_len(z_moisture);
+    }
+    if (c == TAG_TEMP_ESCAPE) {
+        len += varint_len(z_temp);
+    }
+    if (len > cap) {
+        return 0;
+    }
+
+    uint8_t *p = out;
+    *p++ = (uint8_t)((time_changed ? TAG_TIME : 0) | (m << TAG_MOISTURE_SHIFT) | c);
+    if (time_changed) {
+        p = put_varint(p, z_time);
+    }
+    if (m == TAG_MOISTURE_ESCAPE) {
+        p = put_varint(p, z_moisture);
+    }
+    if (c == TAG_TEMP_ESCAPE) {
+        p = put_varint(p, z_temp);
+    }
+
+    state->last = *reading;
+    state->interval = dt;
+    return len;
+}
+
+size_t reading_codec_decode(reading_codec_state_t *state, const uint8_t *in, size_t len,
+                            history_reading_t *reading)
+{
+    if (len == 0) {
+        return 0;
+    }
+    const uint8_t *p = in;
+    const uint8_t *end = in + len;
+    uint8_t tag = *p++;
+    uint32_t z_time = 0;
+    uint32_t z_moisture = (tag >> TAG_MOISTURE_SHIFT) & 0x0F;
+    uint32_t z_temp = tag & TAG_TEMP_MASK;
+
+    if (z_temp > TAG_TEMP_ESCAPE) {
+        return 0;  // Reserved: erased flash or not a record
+    }
+    if ((tag & TAG_TIME) && !(p = get_varint(p, end, &z_time))) {
+        return 0;
+    }
+    if (z_moisture == TAG_MOISTURE_ESCAPE && !(p = get_varint(p, end, &z_moisture))) {
+        return 0;
+    }
+    if (z_temp == TAG_TEMP_ESCAPE && !(p = get_varint(p, end, &z_temp))) {
+        return 0;
+    }
+
+    state->interval += (uint32_t)reading_codec_unzigzag(z_time);
+    state->last.time += state->interval;
+    state->last.moisture_centi = (uint16_t)(state->last.moisture_centi + reading_codec_unzigzag(z_moisture));
+    state->last.temp_centi = (int16_t)(state->last.temp_centi + reading_codec_unzigzag(z_temp));
+    *reading = state->last;
+    return (size_t)(p - in);
+}
+
+void reading_codec_put_absolute(const history_reading_t *reading, uint8_t *out)
+{
+    uint16_t temp = (uint16_t)reading->temp_centi;
+    out[0] = (uint8_t)reading->time;
+    out[1] = (uint8_t)(reading->time >> 8);
+    out[2] = (uint8_t)(reading->time >> 16);
+    out[3] = (uint8_t)(reading->time >> 24);
+    out[4] = (uint8_t)reading->moisture_centi;
+    out[5] = (uint8_t)(reading->moisture_centi >> 8);
+    out[6] = (uint8_t)temp;
+    out[7] = (uint8_t)(temp >> 8);
+}
+
+void reading_codec_get_absolute(const uint8_t *in, history_reading_t *reading)
+{
+    reading->time = (uint32_t)in[0] | ((uint32_t)in[1] << 8) | ((uint32_t)in[2] << 16) | ((uint32_t)in[3] << 24);
+    reading->moisture_centi = (uint16_t)(in[4] | (in[5] << 8));
+    reading->temp_centi = (int16_t)(uint16_t)(in[6] | (in[7] << 8));
+}
@@ -0,0 +1,103 @@
+/*
+ * Glyph C6 Monitor - Reading Codec
+ *
+ * Version: 1.0.0
+ *
+ * Compact time series of readings, shared by the RTC staging buffer and
+ * flash pages of history_log.c and the historyChunk uplink (v2). A series
+ * starts with one absolute reading; every further reading is a record of
+ * deltas to the previous one:
+ *
+ *     tag u8: T:1 | M:4 | C:3
+ *       T  1 = the time step changed: zigzag varint (dt - previous dt) follows
+ *       M  moisture delta, zigzag 0..14 inline, 15 = zigzag varint follows
+ *       C  temperature delta, zigzag 0..5 inline, 6 = zigzag varint follows,
+ *          7 reserved (so 0xFF, erased flash, never starts a record)
+ *     then the varints in T, M, C order (7 bits per byte, LSB first)
+ *
+ * A reading at the usual interval that moved by at most 0.07 % and
+ * 0.02 °C is a single byte; the worst case is READING_CODEC_MAX_RECORD.
+ * Deltas wrap like the field types, so every reading round-trips exactly.
+ *
+ * Readings are fixed point: time in RTC seconds, moisture in 0.01 %,
+ * temperature in 0.01 °C. The absolute form is 8 bytes little-endian
+ * (time u32, moisture u16, temperature i16).
+ *
+ * Host decoder: decodeReadings() in z2m/glyph_c6_converter.js.
+ */
+
+#ifndef READING_CODEC_H
+#define READING_CODEC_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// One reading
+typedef struct {
+    uint32_t time;                // RTC seconds
+    uint16_t moisture_centi;      // 0.01 %
+    int16_t temp_centi;           // 0.01 °C
+} history_reading_t;
+
+// Encoder / decoder position in a series
+typedef struct {
+    history_reading_t last;       // Previous reading
+    uint32_t interval;            // Previous time step (s)
+} reading_codec_state_t;
+
+#define READING_CODEC_ABSOLUTE_LEN    8
+#define READING_CODEC_MAX_RECORD      12    // Tag, 5-byte and two 3-byte varints
+#define READING_CODEC_TAG_ERASED      0xFF
+
+/**
+ * @brief Start a series at an absolute reading (time step unknown)
+ */
+void reading_codec_begin(reading_codec_state_t *state, const history_reading_t *first);
+
+/**
+ * @brief Append one reading as a delta record
+ * @param state Series position, advanced on success
+ * @param reading Next reading
+ * @param out Output buffer
+ * @param cap Room in out
+ * @return Bytes written, 0 if the record does not fit (state unchanged)
+ */
+size_t reading_codec_encode(reading_codec_state_t *state, const history_reading_t *reading,
+                            uint8_t *out, size_t cap);
+
+/**
+ * @brief Decode the next delta record
+ * @param state Series position, advanced on success
+ * @param in Encoded bytes
+ * @param len Bytes available
+ * @param reading Output reading
+ * @return Bytes consumed, 0 at the end of the series (erased or reserved
+ *         tag, truncated record; state unchanged)
+ */
+size_t reading_codec_decode(reading_codec_state_t *state, const uint8_t *in, size_t len,
+                            history_reading_t *reading);
+
+/**
+ * @brief Write a reading in the 8-byte absolute form
+ */
+void reading_codec_put_absolute(const history_reading_t *reading, uint8_t *out);
+
+/**
+ * @brief Read a reading in the 8-byte absolute form
+ */
+void reading_codec_get_absolute(const uint8_t *in, history_reading_t *reading);
+
+/**
+ * @brief Zigzag mapping of a signed delta (0, -1, 1, -2 ... to 0, 1, 2, 3 ...)
+ */
+static inline uint32_t reading_codec_zigzag(int32_t value)
+{
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static inline int32_t reading_codec_unzigzag(uint32_t value)
+{
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+#endif // READING_CODEC_H
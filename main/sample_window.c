@@ -0,0 +1,137 @@
+/*
+ * Glyph C6 Monitor - Windowed Sample Aggregation
+ *
+ * Version: 1.0.0
+ */
+
+#include "sample_window.h"
+#include <string.h>
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+/**
+ * @brief Integer square root (floor) of a 64-bit value
+ */
+static uint32_t isqrt64(uint64_t value)
+{
+    uint64_t result = 0;
+    uint64_t bit = 1ULL << 62;
+
+    while (bit > value) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (value >= result + bit) {
+            value -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)result;
+}
+
+/**
+ * @brief Standard deviation from integer sums: sqrt(n*sq - sum^2) / n
+ */
+static uint16_t stddev_from_sums(uint16_t count, int64_t sum, uint64_t sq_sum)
+{
+    uint64_t n_sq = (uint64_t)count * sq_sum;
+    uint64_t sum_sq = (uint64_t)(sum * sum);
+    if (n_sq <= sum_sq) {
+        return 0;
+    }
+    return (uint16_t)(isqrt64(n_sq - sum_sq) / count);
+}
+
+static uint8_t *put_u16(uint8_t *p, uint16_t value)
+{
+    p[0] = (uint8_t)(value & 0xFF);
+    p[1] = (uint8_t)(value >> 8);
+    return p + 2;
+}
+
+// ============================================================================
+// PUBLIC FUNCTIONS
+// ============================================================================
+
+void sample_window_reset(sample_window_t *window, uint32_t now_sec)
+{
+    memset(window, 0, sizeof(*window));
+    window->start_time = now_sec;
+}
+
+void sample_window_add(sample_window_t *window, uint16_t moisture_centi, int16_t temp_centi)
+{
+    if (window->count == UINT16_MAX) {
+        return;  // Window full - keep statistics of what we have
+    }
+
+    if (window->count == 0) {
+        window->moisture_min = window->moisture_max = moisture_centi;
+        window->temp_min = window->temp_max = temp_centi;
+    } else {
+        if (moisture_centi < window->moisture_min) window->moisture_min = moisture_centi;
+        if (moisture_centi > window->moisture_max) window->moisture_max = moisture_centi;
+        if (temp_centi < window->temp_min) window->temp_min = temp_centi;
+        if (temp_centi > window->temp_max) window->temp_max = temp_centi;
+    }
+
+    window->count++;
+    window->moisture_sum += moisture_centi;
+    window->moisture_sq_sum += (uint32_t)moisture_centi * moisture_centi;
+    window->temp_sum += temp_centi;
+    window->temp_sq_sum += (uint32_t)((int32_t)temp_centi * temp_centi);
+}
+
+bool sample_window_get_stats(const sample_window_t *window, uint32_t now_sec, sample_window_stats_t *stats)
+{
+    if (!window || !stats || window->count == 0) {
+        return false;
+    }
+
+    uint16_t n = window->count;
+    uint32_t duration_min = (now_sec - window->start_time) / 60;
+
+    stats->count = n;
+    stats->duration_min = (duration_min > UINT16_MAX) ? UINT16_MAX : (uint16_t)duration_min;
+
+    stats->moisture_min = window->moisture_min;
+    stats->moisture_max = window->moisture_max;
+    stats->moisture_mean = (uint16_t)((window->moisture_sum + n / 2) / n);
+    stats->moisture_stddev = stddev_from_sums(n, window->moisture_sum, window->moisture_sq_sum);
+
+    // Round half away from zero for the signed mean
+    int32_t half = (window->temp_sum >= 0) ? (n / 2) : -(int32_t)(n / 2);
+    stats->temp_min = window->temp_min;
+    stats->temp_max = window->temp_max;
+    stats->temp_mean = (int16_t)((window->temp_sum + half) / (int32_t)n);
+    stats->temp_stddev = stddev_from_sums(n, window->temp_sum, window->temp_sq_sum);
+
+    return true;
+}
+
+size_t sample_window_encode(const sample_window_stats_t *stats, uint8_t *buf, size_t len)
+{
+    if (!stats || !buf || len < SAMPLE_WINDOW_RECORD_LEN) {
+        return 0;
+    }
+
+    uint8_t *p = buf;
+    *p++ = SAMPLE_WINDOW_RECORD_VERSION;
+    p = put_u16(p, stats->count);
+    p = put_u16(p, stats->duration_min);
+    p = put_u16(p, stats->moisture_min);
+    p = put_u16(p, stats->moisture_max);
+    p = put_u16(p, stats->moisture_mean);
+    p = put_u16(p, stats->moisture_stddev);
+    p = put_u16(p, (uint16_t)stats->temp_min);
+    p = put_u16(p, (uint16_t)stats->temp_max);
+    p = put_u16(p, (uint16_t)stats->temp_mean);
+    p = put_u16(p, stats->temp_stddev);
+
+    return (size_t)(p - buf);
+}
@@ -0,0 +1,95 @@
+/*
+ * Glyph C6 Monitor - Windowed Sample Aggregation
+ *
+ * Version: 1.0.0
+ *
+ * Collects high-rate internal samples into a window and summarizes them
+ * as min/max/mean/stddev/count using integer accumulators only (no
+ * soft-float on the RV32 core). One compact record is reported per
+ * report interval, so the coordinator sees the dynamics between reports
+ * at the radio cost of a single attribute.
+ *
+ * Units: moisture in 0.01 % (0-10000), temperature in 0.01 °C.
+ * The window struct is plain data and may live in RTC memory.
+ */
+
+#ifndef SAMPLE_WINDOW_H
+#define SAMPLE_WINDOW_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// Record format version (first byte of the encoded record)
+#define SAMPLE_WINDOW_RECORD_VERSION   1
+
+// Encoded record size in bytes (see sample_window_encode)
+#define SAMPLE_WINDOW_RECORD_LEN       21
+
+// Running window accumulators
+typedef struct {
+    uint16_t count;               // Samples in window
+    uint16_t moisture_min;        // 0.01 %
+    uint16_t moisture_max;        // 0.01 %
+    int16_t temp_min;             // 0.01 °C
+    int16_t temp_max;             // 0.01 °C
+    uint32_t moisture_sum;        // Sum of samples
+    uint64_t moisture_sq_sum;     // Sum of squared samples
+    int32_t temp_sum;             // Sum of samples
+    uint64_t temp_sq_sum;         // Sum of squared samples
+    uint32_t start_time;          // Window start (RTC seconds)
+} sample_window_t;
+
+// Finalized window statistics
+typedef struct {
+    uint16_t count;               // Samples in window
+    uint16_t duration_min;        // Window length in minutes
+    uint16_t moisture_min;        // 0.01 %
+    uint16_t moisture_max;        // 0.01 %
+    uint16_t moisture_mean;       // 0.01 %
+    uint16_t moisture_stddev;     // 0.01 %
+    int16_t temp_min;             // 0.01 °C
+    int16_t temp_max;             // 0.01 °C
+    int16_t temp_mean;            // 0.01 °C
+    uint16_t temp_stddev;         // 0.01 °C
+} sample_window_stats_t;
+
+/**
+ * @brief Reset window and start a new one
+ * @param window Window to reset
+ * @param now_sec Window start time (RTC seconds)
+ */
+void sample_window_reset(sample_window_t *window, uint32_t now_sec);
+
+/**
+ * @brief Add one sample to the window
+ * @param window Window accumulators
+ * @param moisture_centi Moisture in 0.01 % units (0-10000)
+ * @param temp_centi Temperature in 0.01 °C units
+ */
+void sample_window_add(sample_window_t *window, uint16_t moisture_centi, int16_t temp_centi);
+
+/**
+ * @brief Compute statistics of the current window
+ * @param window Window accumulators
+ * @param now_sec Current time (RTC seconds) for the window duration
+ * @param stats Output statistics
+ * @return false if the window is empty
+ */
+bool sample_window_get_stats(const sample_window_t *window, uint32_t now_sec, sample_window_stats_t *stats);
+
+/**
+ * @brief Encode statistics as a compact little-endian record
+ *
+ * Layout (21 bytes): version u8, count u16, duration_min u16,
+ * moisture min/max/mean/stddev u16 x4, temperature min/max/mean i16 x3,
+ * temperature stddev u16.
+ *
+ * @param stats Statistics to encode
+ * @param buf Output buffer
+ * @param len Buffer size (>= SAMPLE_WINDOW_RECORD_LEN)
+ * @return Number of bytes written, 0 if buffer too small
+ */
+size_t sample_window_encode(const sample_window_stats_t *stats, uint8_t *buf, size_t len);
+
+#endif // SAMPLE_WINDOW_H
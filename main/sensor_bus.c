@@ -0,0 +1,261 @@
+/*
+ * Glyph C6 Monitor - I2C Acquisition Scheduler
+ *
+ * Version: 1.0.0
+ */
+
+#include "sensor_bus.h"
+#include "system_config.h"
+#include "driver/gpio.h"
+#include "esp_timer.h"
+#include "esp_rom_sys.h"
+#include "binlog.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <string.h>
+
+static const char *TAG = "SENSOR_BUS";
+
+// Chain progress of one driver during an acquisition
+typedef struct {
+    uint8_t next;                 // Next step index
+    bool busy;                    // Conversion running
+    int64_t ready_us;             // When the running conversion's data is ready
+} device_run_t;
+
+static void *bus;
+static sensor_bus_device_t devices[SENSOR_BUS_MAX_DEVICES];
+static uint8_t device_count;
+static bool powered;
+static int64_t ready_at_us;       // Slowest driver accepts commands
+static uint32_t sequence;
+static sensor_bus_stats_t stats;
+
+// ============================================================================
+// PRIVATE FUNCTIONS
+// ============================================================================
+
+/**
+ * @brief Sleep until a point in time (ms in the scheduler, the rest busy)
+ */
+static void wait_until(int64_t when_us)
+{
+    int64_t now;
+    while ((now = esp_timer_get_time()) < when_us) {
+        int64_t remaining = when_us - now;
+        if (remaining >= 1000) {
+            vTaskDelay(pdMS_TO_TICKS(remaining / 1000));
+        } else {
+            esp_rom_delay_us((uint32_t)remaining);
+        }
+    }
+}
+
+/**
+ * @brief Skip steps that are not part of this acquisition
+ */
+static void skip_other_kinds(const sensor_bus_device_t *dev, device_run_t *run, uint8_t kinds)
+{
+    while (run->next < dev->step_count && !(dev->steps[run->next].kinds & kinds)) {
+        run->next++;
+    }
+}
+
+/**
+ * @brief Conversion time left in a driver's chain
+ */
+static uint32_t remaining_wait_us(const sensor_bus_device_t *dev, const device_run_t *run, uint8_t kinds)
+{
+    uint32_t sum = 0;
+    for (uint8_t i = run->next; i < dev->step_count; i++) {
+        if (dev->steps[i].kinds & kinds) {
+            sum += dev->steps[i].wait_us;
+        }
+    }
+    return sum;
+}
+
+/**
+ * @brief Idle driver with the longest chain left (-1 = none)
+ */
+static int pick_idle(const device_run_t *runs, uint8_t kinds)
+{
+    int best = -1;
+    uint32_t best_wait = 0;
+    for (int i = 0; i < device_count; i++) {
+        if (runs[i].busy || runs[i].next >= devices[i].step_count) {
+            continue;
+        }
+        uint32_t wait = remaining_wait_us(&devices[i], &runs[i], kinds);
+        if (best < 0 || wait > best_wait) {
+            best = i;
+            best_wait = wait;
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief Busy driver whose conversion is ready first (-1 = none)
+ */
+static int pick_ready(const device_run_t *runs)
+{
+    int best = -1;
+    for (int i = 0; i < device_count; i++) {
+        if (runs[i].busy && (best < 0 || runs[i].ready_us < runs[best].ready_us)) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+// ============================================================================
+// PUBLIC FUNCTIONS
+// ============================================================================
+
+esp_err_t sensor_bus_init(void *bus_handle)
+{
+    if (bus_handle == NULL) {
+        BLOG_E(TAG, "Invalid bus handle");
+        return ESP_ERR_INVALID_ARG;
+    }
+    bus = bus_handle;
+    device_count = 0;
+    powered = false;
+    memset(&stats, 0, sizeof(stats));
+
+    // Rail stays off until a reading needs it
+    gpio_config_t power_conf = {
+        .pin_bit_mask = (1ULL << NEOPIXEL_I2C_POWER),
+        .mode = GPIO_MODE_OUTPUT,
+        .pull_up_en = GPIO_PULLUP_DISABLE,
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+        .intr_type = GPIO_INTR_DISABLE,
+    };
+    gpio_config(&power_conf);
+    gpio_set_level(NEOPIXEL_I2C_POWER, 0);
+    return ESP_OK;
+}
+
+void *sensor_bus_handle(void)
+{
+    return bus;
+}
+
+esp_err_t sensor_bus_register(const sensor_bus_device_t *device)
+{
+    if (device == NULL || device->step_count > SENSOR_BUS_MAX_STEPS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (device_count >= SENSOR_BUS_MAX_DEVICES) {
+        BLOG_E(TAG, "No room for %s", device->name);
+        return ESP_ERR_NO_MEM;
+    }
+    devices[device_count++] = *device;
+    return ESP_OK;
+}
+
+void sensor_bus_power_on(void)
+{
+    if (powered) {
+        return;
+    }
+    gpio_set_level(NEOPIXEL_I2C_POWER, 1);
+    powered = true;
+
+    int64_t now = esp_timer_get_time();
+    ready_at_us = now;
+    for (uint8_t i = 0; i < device_count; i++) {
+        // A missing chip NACKs its reset; its steps fail later on their own
+        if (devices[i].power_up) {
+            devices[i].power_up(devices[i].ctx);
+        }
+        int64_t ready = now + (int64_t)devices[i].ready_ms * 1000;
+        if (ready > ready_at_us) {
+            ready_at_us = ready;
+        }
+    }
+    BLOG_I(TAG, "Rail on, %u drivers ready in %" PRIu32 " ms", device_count,
+           (uint32_t)((ready_at_us - now) / 1000));
+}
+
+void sensor_bus_power_off(void)
+{
+    if (!powered) {
+        return;
+    }
+    gpio_set_level(NEOPIXEL_I2C_POWER, 0);
+    powered = false;
+}
+
+uint32_t sensor_bus_ready_in_ms(void)
+{
+    sensor_bus_power_on();
+    int64_t remaining = ready_at_us - esp_timer_get_time();
+    return remaining > 0 ? (uint32_t)((remaining + 999) / 1000) : 0;
+}
+
+esp_err_t sensor_bus_acquire(uint8_t kinds)
+{
+    sensor_bus_power_on();
+    wait_until(ready_at_us);
+
+    device_run_t runs[SENSOR_BUS_MAX_DEVICES] = {0};
+    memset(&stats, 0, sizeof(stats));
+    sequence++;
+    for (uint8_t i = 0; i < device_count; i++) {
+        skip_other_kinds(&devices[i], &runs[i], kinds);
+        stats.wait_sum_us += remaining_wait_us(&devices[i], &runs[i], kinds);
+    }
+
+    int64_t first_us = esp_timer_get_time();
+    for (;;) {
+        // Every idle chip gets its next conversion before the bus waits
+        int idle;
+        while ((idle = pick_idle(runs, kinds)) >= 0) {
+            const sensor_bus_device_t *dev = &devices[idle];
+            device_run_t *run = &runs[idle];
+            const sensor_bus_step_t *step = &dev->steps[run->next];
+            stats.steps++;
+            if (step->start(dev->ctx) == ESP_OK) {
+                run->busy = true;
+                run->ready_us = esp_timer_get_time() + step->wait_us;
+            } else {
+                stats.failed++;
+                run->next++;
+                skip_other_kinds(dev, run, kinds);
+            }
+        }
+
+        int ready = pick_ready(runs);
+        if (ready < 0) {
+            break;
+        }
+        const sensor_bus_device_t *dev = &devices[ready];
+        device_run_t *run = &runs[ready];
+        wait_until(run->ready_us);
+        if (dev->steps[run->next].read(dev->ctx) != ESP_OK) {
+            stats.failed++;
+        }
+        run->busy = false;
+        run->next++;
+        skip_other_kinds(dev, run, kinds);
+    }
+    stats.window_us = (uint32_t)(esp_timer_get_time() - first_us);
+
+    if (stats.failed > 0) {
+        BLOG_W(TAG, "%u of %u steps failed", stats.failed, stats.steps);
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+uint32_t sensor_bus_sequence(void)
+{
+    return sequence;
+}
+
+const sensor_bus_stats_t *sensor_bus_get_stats(void)
+{
+    return &stats;
+}
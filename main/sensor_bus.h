@@ -0,0 +1,120 @@
+/*
+ * Glyph C6 Monitor - I2C Acquisition Scheduler
+ *
+ * Version: 1.0.0
+ *
+ * Owns the STEMMA QT rail (NEOPIXEL_I2C_POWER) and runs every registered
+ * sensor driver's conversions inside one powered bus window:
+ *
+ * - Window: the rail comes up once per reading; each driver's power-up
+ *   command goes out at once and the window is ready when the slowest
+ *   driver's ready time has passed, so boot times overlap (and overlap
+ *   with the Zigbee start, since the wake only waits for them when the
+ *   first sample is due)
+ * - Acquisition: a driver is a chain of steps (start command, conversion
+ *   wait, readout), one at a time per chip. Chips convert in parallel:
+ *   whenever a chip is idle its next step starts, the chip with the
+ *   longest remaining chain first, and the bus reads out whichever
+ *   conversion finishes first. The acquisition takes as long as the
+ *   longest chain instead of the sum of all waits
+ *
+ * Drivers keep their own results; a step's readout tags them with
+ * sensor_bus_sequence() so a driver can tell this acquisition's values
+ * from stale ones.
+ */
+
+#ifndef SENSOR_BUS_H
+#define SENSOR_BUS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "system_config.h"
+
+// Acquisition kinds a step takes part in
+#define SENSOR_BUS_SENSE        (1u << 0)   // Radio-free watering check (moisture only)
+#define SENSOR_BUS_READING      (1u << 1)   // Full reading sample
+
+typedef struct {
+    uint32_t wait_us;                 // Start command to data ready
+    uint8_t kinds;                    // SENSOR_BUS_x
+    esp_err_t (*start)(void *ctx);    // Conversion command
+    esp_err_t (*read)(void *ctx);     // Readout and conversion to driver units
+} sensor_bus_step_t;
+
+typedef struct {
+    const char *name;
+    uint32_t ready_ms;                // Rail on to first conversion command
+    esp_err_t (*power_up)(void *ctx); // Optional: sent when the rail comes up (reset)
+    sensor_bus_step_t steps[SENSOR_BUS_MAX_STEPS]; // In chain order
+    uint8_t step_count;
+    void *ctx;
+} sensor_bus_device_t;
+
+// Outcome of the last acquisition
+typedef struct {
+    uint8_t steps;                    // Steps run
+    uint8_t failed;                   // Start or readout failed
+    uint32_t window_us;               // First start command to last readout
+    uint32_t wait_sum_us;             // Conversion waits if run one after another
+} sensor_bus_stats_t;
+
+/**
+ * @brief Take over the rail GPIO (off) and the I2C bus
+ * @param bus_handle I2C master bus handle (from i2c_new_master_bus)
+ * @return ESP_OK, ESP_ERR_INVALID_ARG without a bus
+ */
+esp_err_t sensor_bus_init(void *bus_handle);
+
+/**
+ * @brief I2C bus the drivers add their devices to
+ */
+void *sensor_bus_handle(void);
+
+/**
+ * @brief Add a driver (copied); the rail must be off
+ * @return ESP_ERR_NO_MEM beyond SENSOR_BUS_MAX_DEVICES
+ */
+esp_err_t sensor_bus_register(const sensor_bus_device_t *device);
+
+/**
+ * @brief Open the window: rail on and power-up commands (no wait)
+ *
+ * Does nothing while the window is open.
+ */
+void sensor_bus_power_on(void);
+
+/**
+ * @brief Close the window: rail off (drivers boot again next window)
+ */
+void sensor_bus_power_off(void);
+
+/**
+ * @brief Time until every driver accepts commands (0 = ready)
+ *
+ * Opens the window if it is closed.
+ */
+uint32_t sensor_bus_ready_in_ms(void);
+
+/**
+ * @brief Run every step of the given kind, interleaved across chips
+ *
+ * Opens the window and waits for it to be ready if needed.
+ *
+ * @param kinds SENSOR_BUS_SENSE or SENSOR_BUS_READING
+ * @return ESP_OK if every step succeeded, ESP_FAIL otherwise (drivers
+ *         hold what did succeed)
+ */
+esp_err_t sensor_bus_acquire(uint8_t kinds);
+
+/**
+ * @brief Number of the last acquisition (tags driver results)
+ */
+uint32_t sensor_bus_sequence(void);
+
+/**
+ * @brief Timing of the last acquisition
+ */
+const sensor_bus_stats_t *sensor_bus_get_stats(void);
+
+#endif // SENSOR_BUS_H
@@ -0,0 +1,127 @@
+/*
+ * Glyph C6 Monitor - Sensor Value Conversions
+ *
+ * Version: 1.0.0
+ */
+
+#include "sensor_convert.h"
+#include "system_config.h"
+
+// ============================================================================
+// SENSOR READINGS
+// ============================================================================
+
+uint16_t sensor_convert_moisture_centi(uint16_t raw)
+{
+    if (raw <= SOIL_VALUE_DRY) {
+        return 0;
+    }
+    if (raw >= SOIL_VALUE_WET) {
+        return 10000;
+    }
+    return (uint16_t)(((uint32_t)(raw - SOIL_VALUE_DRY) * 10000u) / (SOIL_VALUE_WET - SOIL_VALUE_DRY));
+}
+
+int16_t sensor_convert_temp_centi(int32_t raw)
+{
+    // Clamp to the int16 range first so raw * 100 cannot overflow
+    if (raw > (int32_t)INT16_MAX * 65536 / 100) {
+        return INT16_MAX;
+    }
+    if (raw < (int32_t)INT16_MIN * 65536 / 100) {
+        return INT16_MIN;
+    }
+    return (int16_t)((raw * 100) / 65536);
+}
+
+float sensor_convert_moisture_percent(uint16_t raw)
+{
+    float pct = ((float)(raw - SOIL_VALUE_DRY) / (float)(SOIL_VALUE_WET - SOIL_VALUE_DRY)) * 100.0f;
+    if (pct < 0.0f) pct = 0.0f;
+    if (pct > 100.0f) pct = 100.0f;
+    return pct;
+}
+
+float sensor_convert_temp_c(int32_t raw)
+{
+    return (float)raw / 65536.0f;
+}
+
+float sensor_convert_c_to_f(float celsius)
+{
+    return (celsius * 9.0f / 5.0f) + 32.0f;
+}
+
+// ============================================================================
+// BATTERY
+// ============================================================================
+
+float sensor_convert_battery_voltage(int adc_mv)
+{
+    return BATT_ADC_TO_VOLTAGE(adc_mv);
+}
+
+float sensor_convert_battery_percent(float voltage)
+{
+    // USB power detection: If voltage > 4.3V, USB is connected
+    // In this case, we can't accurately measure battery percentage
+    // Return 100% to indicate "powered/charging"
+    if (voltage > 4.3f) {
+        return 100.0f;  // USB connected - report as fully powered
+    }
+
+    // LiPo discharge curve (simplified) - only valid when on battery
+    // 4.2V = 100%, 3.7V = 50%, 3.0V = 0%
+
+    if (voltage >= BATT_VOLTAGE_MAX) {
+        return 100.0f;
+    } else if (voltage <= BATT_VOLTAGE_MIN) {
+        return 0.0f;
+    }
+
+    // Piecewise linear approximation of LiPo curve
+    if (voltage > 3.9f) {
+        // 3.9V-4.2V: 80-100% (steep region)
+        return 80.0f + ((voltage - 3.9f) / 0.3f) * 20.0f;
+    } else if (voltage > 3.7f) {
+        // 3.7V-3.9V: 50-80% (linear region)
+        return 50.0f + ((voltage - 3.7f) / 0.2f) * 30.0f;
+    } else if (voltage > 3.4f) {
+        // 3.4V-3.7V: 20-50% (linear region)
+        return 20.0f + ((voltage - 3.4f) / 0.3f) * 30.0f;
+    } else {
+        // 3.0V-3.4V: 0-20% (steep discharge)
+        return ((voltage - BATT_VOLTAGE_MIN) / 0.4f) * 20.0f;
+    }
+}
+
+// ============================================================================
+// ZCL ENCODING
+// ============================================================================
+
+uint16_t sensor_convert_zcl_humidity(float percent)
+{
+    uint16_t value = (uint16_t)(percent * 100.0f);
+    return (value > 10000) ? 10000 : value;
+}
+
+int16_t sensor_convert_zcl_temperature(float celsius)
+{
+    return (int16_t)(celsius * 100.0f);
+}
+
+uint8_t sensor_convert_zcl_battery_percent(float percent)
+{
+    uint16_t half_percent = (uint16_t)(percent * 2.0f);
+    return (half_percent <= 200) ? (uint8_t)half_percent : 200;
+}
+
+bool sensor_convert_zcl_battery_voltage(float voltage, uint8_t *decivolts)
+{
+    uint16_t value = (uint16_t)(voltage * 10.0f);
+    if (value > UINT8_MAX) {
+        return false;
+    }
+    *decivolts = (uint8_t)value;
+    return true;
+}
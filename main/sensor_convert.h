@@ -0,0 +1,103 @@
+/*
+ * Glyph C6 Monitor - Sensor Value Conversions
+ *
+ * Version: 1.0.0
+ *
+ * The arithmetic between the hardware and the Zigbee attributes, kept
+ * free of I/O so it can be measured on its own: raw Seesaw readings to
+ * percent and degrees, battery millivolts to volts and state of charge,
+ * and engineering units to ZCL attribute encodings.
+ *
+ * These run on every sample of every wake on an FPU-less RV32 core, where
+ * each float operation is a libgcc soft-float call. host/bench/kernel_bench
+ * cross-compiles this file with the firmware flags and reports the retired
+ * instructions and code size of every function. The soil sample path uses
+ * the integer *_centi conversions; the float ones remain for the battery
+ * and for comparison.
+ */
+
+#ifndef SENSOR_CONVERT_H
+#define SENSOR_CONVERT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// printf format and arguments for a centi value (0.01 units) without
+// floating point: BLOG_I(TAG, "T=" SENSOR_CENTI_FMT " C", SENSOR_CENTI_ARGS(t))
+#define SENSOR_CENTI_FMT        "%s%d.%02d"
+#define SENSOR_CENTI_ARGS(v)    sensor_centi_sign(v), sensor_centi_abs(v) / 100, sensor_centi_abs(v) % 100
+
+static inline const char *sensor_centi_sign(int centi)
+{
+    return centi < 0 ? "-" : "";
+}
+
+static inline int sensor_centi_abs(int centi)
+{
+    return centi < 0 ? -centi : centi;
+}
+
+/**
+ * @brief Seesaw capacitance to moisture in 0.01 % (0-10000, clamped)
+ *
+ * Integer only; equals sensor_convert_zcl_humidity(sensor_convert_moisture_percent(raw))
+ * up to float rounding (1 count).
+ */
+uint16_t sensor_convert_moisture_centi(uint16_t raw);
+
+/**
+ * @brief Seesaw temperature register (16.16 fixed point) to 0.01 °C
+ *
+ * Integer only, truncated toward zero like sensor_convert_zcl_temperature().
+ */
+int16_t sensor_convert_temp_centi(int32_t raw);
+
+/**
+ * @brief Seesaw capacitance to moisture percent (SOIL_VALUE_DRY..WET, clamped 0-100)
+ */
+float sensor_convert_moisture_percent(uint16_t raw);
+
+/**
+ * @brief Seesaw temperature register (16.16 fixed point) to °C
+ */
+float sensor_convert_temp_c(int32_t raw);
+
+/**
+ * @brief °C to °F
+ */
+float sensor_convert_c_to_f(float celsius);
+
+/**
+ * @brief Calibrated ADC pin millivolts to battery volts (divider compensated)
+ */
+float sensor_convert_battery_voltage(int adc_mv);
+
+/**
+ * @brief LiPo voltage to state of charge (piecewise discharge curve)
+ *
+ * Above 4.3 V USB is powering the board and 100 % is reported.
+ */
+float sensor_convert_battery_percent(float voltage);
+
+/**
+ * @brief Moisture percent to RelativeHumidity MeasuredValue (0.01 %, max 10000)
+ */
+uint16_t sensor_convert_zcl_humidity(float percent);
+
+/**
+ * @brief °C to TemperatureMeasurement MeasuredValue (0.01 °C)
+ */
+int16_t sensor_convert_zcl_temperature(float celsius);
+
+/**
+ * @brief Percent to PowerConfiguration BatteryPercentageRemaining (0.5 %, max 200)
+ */
+uint8_t sensor_convert_zcl_battery_percent(float percent);
+
+/**
+ * @brief Volts to PowerConfiguration BatteryVoltage (0.1 V)
+ * @return false if the voltage does not fit the attribute
+ */
+bool sensor_convert_zcl_battery_voltage(float voltage, uint8_t *decivolts);
+
+#endif // SENSOR_CONVERT_H
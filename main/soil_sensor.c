@@ -5,8 +5,13 @@
 
 #include "soil_sensor.h"
 #include "system_config.h"
+#include "sensor_convert.h"
+#include "sensor_bus.h"
 #include "driver/i2c_master.h"
-#include "esp_log.h"
+// Per-read driver chatter is stripped from the wake path at compile time
+#define BINLOG_LEVEL BINLOG_LEVEL_WARN
+#include "binlog.h"
+#include "field_trace.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 
@@ -27,13 +32,21 @@ static i2c_master_dev_handle_t i2c_dev_handle = NULL;
 // Sensor state
 static bool sensor_initialized = false;
 
+// Results of the scheduled steps (sensor_bus.c), tagged with the acquisition
+static soil_data_t acquired;
+static uint32_t moisture_sequence;
+static uint32_t temp_sequence;
+
 /**
  * @brief Write command to Seesaw sensor (new I2C master API)
  */
 static esp_err_t seesaw_write_cmd(uint8_t base, uint8_t func)
 {
     uint8_t write_buf[2] = {base, func};
-    return i2c_master_transmit(i2c_dev_handle, write_buf, sizeof(write_buf), I2C_MASTER_TIMEOUT_MS);
+    uint32_t start = field_trace_start();
+    esp_err_t ret = i2c_master_transmit(i2c_dev_handle, write_buf, sizeof(write_buf), I2C_MASTER_TIMEOUT_MS);
+    field_trace_i2c(FIELD_TRACE_I2C_TX, SOIL_SENSOR_ADDR, write_buf, sizeof(write_buf), ret, start);
+    return ret;
 }
 
 /**
@@ -42,7 +55,10 @@ static esp_err_t seesaw_write_cmd(uint8_t base, uint8_t func)
 static esp_err_t seesaw_write_cmd_data(uint8_t base, uint8_t func, uint8_t data)
 {
     uint8_t write_buf[3] = {base, func, data};
-    return i2c_master_transmit(i2c_dev_handle, write_buf, sizeof(write_buf), I2C_MASTER_TIMEOUT_MS);
+    uint32_t start = field_trace_start();
+    esp_err_t ret = i2c_master_transmit(i2c_dev_handle, write_buf, sizeof(write_buf), I2C_MASTER_TIMEOUT_MS);
+    field_trace_i2c(FIELD_TRACE_I2C_TX, SOIL_SENSOR_ADDR, write_buf, sizeof(write_buf), ret, start);
+    return ret;
 }
 
 /**
@@ -50,62 +66,176 @@ static esp_err_t seesaw_write_cmd_data(uint8_t base, uint8_t func, uint8_t data)
  */
 static esp_err_t seesaw_read_data(uint8_t *buffer, size_t len)
 {
-    return i2c_master_receive(i2c_dev_handle, buffer, len, I2C_MASTER_TIMEOUT_MS);
+    uint32_t start = field_trace_start();
+    esp_err_t ret = i2c_master_receive(i2c_dev_handle, buffer, len, I2C_MASTER_TIMEOUT_MS);
+    field_trace_i2c(FIELD_TRACE_I2C_RX, SOIL_SENSOR_ADDR, buffer, len, ret, start);
+    return ret;
 }
 
-// Initialize sensor
-esp_err_t soil_sensor_init(void *bus_handle)
+/**
+ * @brief Add the sensor to the I2C bus (no wait)
+ */
+static esp_err_t add_device(void *bus_handle)
 {
-    ESP_LOGI(TAG, "Initializing Adafruit Soil Sensor...");
-    
-    if (bus_handle == NULL) {
-        ESP_LOGE(TAG, "Invalid bus handle");
-        return ESP_FAIL;
+    if (i2c_dev_handle != NULL) {
+        return ESP_OK;
     }
-    
-    // Create I2C device handle (new API)
     i2c_device_config_t dev_cfg = {
         .dev_addr_length = I2C_ADDR_BIT_LEN_7,
         .device_address = SOIL_SENSOR_ADDR,
         .scl_speed_hz = 100000,  // 100kHz
     };
+    esp_err_t ret = i2c_master_bus_add_device((i2c_master_bus_handle_t)bus_handle, &dev_cfg, &i2c_dev_handle);
+    if (ret != ESP_OK) {
+        BLOG_E(TAG, "Failed to add I2C device: %s", esp_err_to_name(ret));
+    }
+    return ret;
+}
+
+// Scheduler steps: the chip boots after SWRST and runs one conversion at a time
+
+static esp_err_t step_reset(void *ctx)
+{
+    (void)ctx;
+    return seesaw_write_cmd_data(SEESAW_STATUS_BASE, SEESAW_STATUS_SWRST, 0xFF);
+}
+
+static esp_err_t step_moisture_start(void *ctx)
+{
+    (void)ctx;
+    return seesaw_write_cmd(SEESAW_TOUCH_BASE, SEESAW_TOUCH_CHANNEL_OFFSET);
+}
+
+static esp_err_t step_moisture_read(void *ctx)
+{
+    (void)ctx;
+    uint8_t data[2];
+    esp_err_t ret = seesaw_read_data(data, sizeof(data));
+    if (ret != ESP_OK) {
+        BLOG_E(TAG, "Failed to read moisture data: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    acquired.moisture_raw = (data[0] << 8) | data[1];
+    acquired.moisture_centi = sensor_convert_moisture_centi(acquired.moisture_raw);
+    acquired.timestamp = xTaskGetTickCount() * portTICK_PERIOD_MS;
+    moisture_sequence = sensor_bus_sequence();
+    return ESP_OK;
+}
+
+static esp_err_t step_temp_start(void *ctx)
+{
+    (void)ctx;
+    return seesaw_write_cmd(SEESAW_STATUS_BASE, SEESAW_STATUS_TEMP);
+}
+
+static esp_err_t step_temp_read(void *ctx)
+{
+    (void)ctx;
+    uint8_t data[4];
+    esp_err_t ret = seesaw_read_data(data, sizeof(data));
+    if (ret != ESP_OK) {
+        BLOG_E(TAG, "Failed to read temperature data: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    int32_t temp_raw = (data[0] << 24) | (data[1] << 16) | (data[2] << 8) | data[3];
+    acquired.temperature_centi = sensor_convert_temp_centi(temp_raw);
+    temp_sequence = sensor_bus_sequence();
+    return ESP_OK;
+}
+
+// Initialize sensor
+esp_err_t soil_sensor_init(void *bus_handle)
+{
+    BLOG_I(TAG, "Initializing Adafruit Soil Sensor...");
+    
+    if (bus_handle == NULL) {
+        BLOG_E(TAG, "Invalid bus handle");
+        return ESP_FAIL;
+    }
     
     // Add device to the I2C bus (bus_handle passed from main.c)
-    esp_err_t ret = i2c_master_bus_add_device((i2c_master_bus_handle_t)bus_handle, &dev_cfg, &i2c_dev_handle);
+    esp_err_t ret = add_device(bus_handle);
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to add I2C device: %s", esp_err_to_name(ret));
         return ESP_FAIL;
     }
     
     // Perform soft reset
-    ESP_LOGI(TAG, "Performing soft reset...");
+    BLOG_I(TAG, "Performing soft reset...");
     ret = seesaw_write_cmd_data(SEESAW_STATUS_BASE, SEESAW_STATUS_SWRST, 0xFF);
     if (ret != ESP_OK) {
-        ESP_LOGW(TAG, "Soft reset failed (may be expected): %s", esp_err_to_name(ret));
+        BLOG_W(TAG, "Soft reset failed (may be expected): %s", esp_err_to_name(ret));
     }
     
     // Wait longer for sensor to fully boot and stabilize
-    ESP_LOGI(TAG, "Waiting for sensor to stabilize...");
+    BLOG_I(TAG, "Waiting for sensor to stabilize...");
     vTaskDelay(pdMS_TO_TICKS(1000));
     
     sensor_initialized = true;
-    ESP_LOGI(TAG, "Soil sensor initialized successfully");
+    BLOG_I(TAG, "Soil sensor initialized successfully");
     
     return ESP_OK;
 }
 
+// Register with the acquisition scheduler
+esp_err_t soil_sensor_register(void)
+{
+    void *bus_handle = sensor_bus_handle();
+    if (bus_handle == NULL) {
+        BLOG_E(TAG, "Invalid bus handle");
+        return ESP_FAIL;
+    }
+    esp_err_t ret = add_device(bus_handle);
+    if (ret != ESP_OK) {
+        return ESP_FAIL;
+    }
+
+    sensor_bus_device_t dev = {
+        .name = "seesaw",
+        .ready_ms = SOIL_SENSOR_BOOT_MS,
+        .power_up = step_reset,
+        .steps = {
+            { SOIL_MOISTURE_WAIT_US, SENSOR_BUS_SENSE | SENSOR_BUS_READING, step_moisture_start, step_moisture_read },
+            { SOIL_TEMP_WAIT_US, SENSOR_BUS_READING, step_temp_start, step_temp_read },
+        },
+        .step_count = 2,
+    };
+    ret = sensor_bus_register(&dev);
+    sensor_initialized = (ret == ESP_OK);
+    return ret;
+}
+
+// Results of the last scheduled acquisition
+esp_err_t soil_sensor_get_acquired(soil_data_t *data)
+{
+    if (!data) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    uint32_t seq = sensor_bus_sequence();
+    if (!sensor_initialized || moisture_sequence != seq) {
+        data->valid = false;
+        return ESP_FAIL;
+    }
+    *data = acquired;
+    if (temp_sequence != seq) {
+        // Not part of this acquisition, or failed: moisture is still valid
+        data->temperature_centi = 0;
+    }
+    data->valid = true;
+    return ESP_OK;
+}
+
 // Read moisture
-esp_err_t soil_sensor_read_moisture(uint16_t *raw_value, float *percent)
+esp_err_t soil_sensor_read_moisture(uint16_t *raw_value, uint16_t *moisture_centi)
 {
     if (!sensor_initialized) {
-        ESP_LOGE(TAG, "Sensor not initialized");
+        BLOG_E(TAG, "Sensor not initialized");
         return ESP_FAIL;
     }
     
     // Request capacitance reading
     esp_err_t ret = seesaw_write_cmd(SEESAW_TOUCH_BASE, SEESAW_TOUCH_CHANNEL_OFFSET);
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to request moisture reading: %s", esp_err_to_name(ret));
+        BLOG_E(TAG, "Failed to request moisture reading: %s", esp_err_to_name(ret));
         return ret;
     }
     
@@ -116,36 +246,31 @@ esp_err_t soil_sensor_read_moisture(uint16_t *raw_value, float *percent)
     uint8_t data[2];
     ret = seesaw_read_data(data, 2);
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to read moisture data: %s", esp_err_to_name(ret));
+        BLOG_E(TAG, "Failed to read moisture data: %s", esp_err_to_name(ret));
         return ret;
     }
     
     // Combine bytes (big-endian)
     uint16_t raw = (data[0] << 8) | data[1];
     
-    // Convert to percentage
-    float pct = ((float)(raw - SOIL_VALUE_DRY) / (float)(SOIL_VALUE_WET - SOIL_VALUE_DRY)) * 100.0f;
-    if (pct < 0.0f) pct = 0.0f;
-    if (pct > 100.0f) pct = 100.0f;
-    
     if (raw_value) *raw_value = raw;
-    if (percent) *percent = pct;
+    if (moisture_centi) *moisture_centi = sensor_convert_moisture_centi(raw);
     
     return ESP_OK;
 }
 
 // Read temperature
-esp_err_t soil_sensor_read_temperature(float *temp_c, float *temp_f)
+esp_err_t soil_sensor_read_temperature(int16_t *temp_centi)
 {
     if (!sensor_initialized) {
-        ESP_LOGE(TAG, "Sensor not initialized");
+        BLOG_E(TAG, "Sensor not initialized");
         return ESP_FAIL;
     }
     
     // Request temperature reading
     esp_err_t ret = seesaw_write_cmd(SEESAW_STATUS_BASE, SEESAW_STATUS_TEMP);
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to request temperature reading: %s", esp_err_to_name(ret));
+        BLOG_E(TAG, "Failed to request temperature reading: %s", esp_err_to_name(ret));
         return ret;
     }
     
@@ -156,17 +281,13 @@ esp_err_t soil_sensor_read_temperature(float *temp_c, float *temp_f)
     uint8_t data[4];
     ret = seesaw_read_data(data, 4);
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to read temperature data: %s", esp_err_to_name(ret));
+        BLOG_E(TAG, "Failed to read temperature data: %s", esp_err_to_name(ret));
         return ret;
     }
     
     // Combine bytes (big-endian, signed)
     int32_t temp_raw = (data[0] << 24) | (data[1] << 16) | (data[2] << 8) | data[3];
-    float celsius = (float)temp_raw / 65536.0f;
-    float fahrenheit = (celsius * 9.0f / 5.0f) + 32.0f;
-    
-    if (temp_c) *temp_c = celsius;
-    if (temp_f) *temp_f = fahrenheit;
+    if (temp_centi) *temp_centi = sensor_convert_temp_centi(temp_raw);
     
     return ESP_OK;
 }
@@ -182,19 +303,18 @@ esp_err_t soil_sensor_read_all(soil_data_t *data)
     temp_data.timestamp = xTaskGetTickCount() * portTICK_PERIOD_MS;
     
     // Read moisture
-    esp_err_t ret = soil_sensor_read_moisture(&temp_data.moisture_raw, &temp_data.moisture_percent);
+    esp_err_t ret = soil_sensor_read_moisture(&temp_data.moisture_raw, &temp_data.moisture_centi);
     if (ret != ESP_OK) {
         temp_data.valid = false;
         return ret;
     }
     
     // Read temperature
-    ret = soil_sensor_read_temperature(&temp_data.temperature_c, &temp_data.temperature_f);
+    ret = soil_sensor_read_temperature(&temp_data.temperature_centi);
     if (ret != ESP_OK) {
         // Temperature read failed, but moisture is valid
-        ESP_LOGW(TAG, "Temperature read failed, continuing with moisture data");
-        temp_data.temperature_c = 0.0f;
-        temp_data.temperature_f = 32.0f;
+        BLOG_W(TAG, "Temperature read failed, continuing with moisture data");
+        temp_data.temperature_centi = 0;
     }
     
     temp_data.valid = true;
@@ -222,13 +342,13 @@ soil_status_t soil_sensor_get_status(float percent)
 const char* soil_sensor_status_string(soil_status_t status)
 {
     switch (status) {
-        case SOIL_STATUS_CRITICAL:  return "💀 CRITICAL - Water NOW!";
-        case SOIL_STATUS_LOW:       return "💧 Low - Water soon";
-        case SOIL_STATUS_GOOD:      return "✅ Good - Happy plant";
-        case SOIL_STATUS_HIGH:      return "💦 High - Don't water";
-        case SOIL_STATUS_SATURATED: return "🌊 Saturated - Too wet";
-        case SOIL_STATUS_ERROR:     return "❌ Error";
-        default:                    return "❓ Unknown";
+        case SOIL_STATUS_CRITICAL:  return "CRITICAL - Water NOW!";
+        case SOIL_STATUS_LOW:       return "Low - Water soon";
+        case SOIL_STATUS_GOOD:      return "Good - Happy plant";
+        case SOIL_STATUS_HIGH:      return "High - Don't water";
+        case SOIL_STATUS_SATURATED: return "Saturated - Too wet";
+        case SOIL_STATUS_ERROR:     return "Error";
+        default:                    return "Unknown";
     }
 }
 
@@ -243,7 +363,9 @@ bool soil_sensor_is_present(void)
     
     // Simple probe by attempting to read a byte
     uint8_t dummy;
+    uint32_t start = field_trace_start();
     esp_err_t ret = i2c_master_receive(i2c_dev_handle, &dummy, 1, 100);
+    field_trace_i2c(FIELD_TRACE_I2C_RX, SOIL_SENSOR_ADDR, &dummy, 1, ret, start);
     return (ret == ESP_OK || ret == ESP_ERR_TIMEOUT); // Sensor present if we get any response
 }
 
@@ -15,9 +15,8 @@
 // Soil sensor data structure
 typedef struct {
     uint16_t moisture_raw;        // Raw capacitance value (200-2000)
-    float moisture_percent;       // Moisture percentage (0-100%)
-    float temperature_c;          // Temperature in Celsius
-    float temperature_f;          // Temperature in Fahrenheit
+    uint16_t moisture_centi;      // Moisture in 0.01 % (0-10000)
+    int16_t temperature_centi;    // Temperature in 0.01 °C
     bool valid;                   // Data validity flag
     uint32_t timestamp;           // Last reading timestamp (ms)
 } soil_data_t;
@@ -42,23 +41,44 @@ typedef enum {
  */
 esp_err_t soil_sensor_init(void *bus_handle);
 
+/**
+ * @brief Register with the I2C acquisition scheduler (no wait)
+ * 
+ * Adds the sensor to the scheduler's bus. SWRST goes out when the bus
+ * powers up; the moisture conversion takes part in sense and reading
+ * acquisitions, the temperature conversion in readings only.
+ * 
+ * @return ESP_OK on success, ESP_FAIL without a bus
+ */
+esp_err_t soil_sensor_register(void);
+
+/**
+ * @brief Data of the last sensor_bus_acquire()
+ * 
+ * Temperature is 0 if its conversion was not part of the acquisition or
+ * failed (moisture still valid), as in soil_sensor_read_all().
+ * 
+ * @param data Pointer to soil_data_t structure
+ * @return ESP_OK if the acquisition read the moisture
+ */
+esp_err_t soil_sensor_get_acquired(soil_data_t *data);
+
 /**
  * @brief Read soil moisture (capacitance)
  * 
  * @param raw_value Pointer to store raw value (200-2000)
- * @param percent Pointer to store percentage (0-100%)
+ * @param moisture_centi Pointer to store moisture in 0.01 % (0-10000)
  * @return ESP_OK on success
  */
-esp_err_t soil_sensor_read_moisture(uint16_t *raw_value, float *percent);
+esp_err_t soil_sensor_read_moisture(uint16_t *raw_value, uint16_t *moisture_centi);
 
 /**
  * @brief Read soil temperature
  * 
- * @param temp_c Pointer to store temperature in Celsius
- * @param temp_f Pointer to store temperature in Fahrenheit
+ * @param temp_centi Pointer to store temperature in 0.01 °C
  * @return ESP_OK on success
  */
-esp_err_t soil_sensor_read_temperature(float *temp_c, float *temp_f);
+esp_err_t soil_sensor_read_temperature(int16_t *temp_centi);
 
 /**
  * @brief Read all sensor data at once (performs fresh I2C reads)
@@ -83,7 +103,7 @@ soil_status_t soil_sensor_get_status(float percent);
  * @brief Get status string for logging
  * 
  * @param status soil_status_t value
- * @return String representation with emoji
+ * @return String representation
  */
 const char* soil_sensor_status_string(soil_status_t status);
 
@@ -6,12 +6,18 @@
  * 
  * This file contains all system constants, pin definitions,
  * thresholds, and configuration parameters.
+ * 
+ * Performance parameters (sampling, reporting, join, OTA, PM) come from
+ * the Kconfig performance profile (menuconfig -> Glyph C6 Monitor
+ * Configuration -> Performance profile) and are checked for consistency
+ * at build time at the end of this file.
  */
 
 #ifndef SYSTEM_CONFIG_H
 #define SYSTEM_CONFIG_H
 
 #include <stdint.h>
+#include "sdkconfig.h"
 
 // ============================================================================
 // HARDWARE PIN DEFINITIONS (Glyph C6 / Adafruit ESP32-C6 Feather)
@@ -69,10 +75,30 @@
 #define SOIL_MOISTURE_GOOD      65.0f             // Above this = good (happy plant)
 #define SOIL_MOISTURE_HIGH      85.0f             // Above this = too wet (don't water)
 
-// Sampling Configuration
-#define SOIL_READ_INTERVAL      60000             // 60 seconds between readings
-#define SOIL_TASK_STACK         4096              // Stack size for soil task
-#define SOIL_TASK_PRIORITY      4                 // Task priority
+// Acquisition steps (sensor_bus.c): the Seesaw runs one conversion at a time
+#define SOIL_SENSOR_BOOT_MS     1000              // Rail on / SWRST to first command
+#define SOIL_MOISTURE_WAIT_US   5000              // Capacitance request to data ready
+#define SOIL_TEMP_WAIT_US       10000             // Temperature request to data ready
+
+// ============================================================================
+// AMBIENT SENSOR CONFIGURATION (Sensirion SHT4x, STEMMA QT)
+// ============================================================================
+
+#ifdef CONFIG_GLYPH_AMBIENT_SHT4X
+#define AMBIENT_SENSOR_ENABLED  1
+#else
+#define AMBIENT_SENSOR_ENABLED  0
+#endif
+#define AMBIENT_SENSOR_ADDR     0x44              // SHT40/41/45-AD1B
+#define AMBIENT_POWER_UP_MS     1                 // Power-up / soft reset time (datasheet max)
+#define AMBIENT_MEASURE_WAIT_US 8300              // High repeatability measurement (datasheet max)
+
+// ============================================================================
+// SENSOR BUS (sensor_bus.c)
+// ============================================================================
+
+#define SENSOR_BUS_MAX_DEVICES  4                 // Registered drivers
+#define SENSOR_BUS_MAX_STEPS    4                 // Conversions per driver
 
 // ============================================================================
 // BATTERY MONITORING CONFIGURATION (from Glyph C6 schematic)
@@ -100,12 +126,15 @@
 
 // Battery Sampling
 #define BATTERY_SAMPLES_AVG     10                // Number of ADC samples to average
-#define BATTERY_READ_INTERVAL   60000             // 60 seconds between reads
 
 // Battery Thresholds
 #define BATTERY_LOW_PERCENT     20.0f             // Below this = low battery
 #define BATTERY_FULL_PERCENT    99.0f             // Above this = full
 
+// USB / external power detection (USB rail is ~4.7V, LiPo max is 4.2V)
+#define BATT_USB_DETECT_VOLTAGE  4.3f             // Above this = external power present
+#define BATT_USB_RELEASE_VOLTAGE 4.25f            // Below this = back on battery (hysteresis)
+
 // ============================================================================
 // ZIGBEE CONFIGURATION
 // ============================================================================
@@ -113,6 +142,7 @@
 // Device Information
 #define ESP_MANUFACTURER_NAME    "\x09""FloraTech"     // Your custom manufacturer
 #define ESP_MODEL_IDENTIFIER     "\x0F""PlantMonitor-C6"  // Generic model name
+#define ESP_MANUFACTURER_CODE    0x1234                // FloraTech manufacturer code (OTA + custom clusters)
 
 // Firmware Version (for OTA and identification)
 // ⚠️ SINGLE SOURCE OF TRUTH - Update ONLY these values ⚠️
@@ -132,41 +162,169 @@
 // Zigbee Network Configuration
 #define INSTALLCODE_POLICY_ENABLE false
 #define ED_AGING_TIMEOUT         ESP_ZB_ED_AGING_TIMEOUT_64MIN
-#define ED_KEEP_ALIVE           3000              // 3000 milliseconds
+#define ED_KEEP_ALIVE           CONFIG_GLYPH_ED_KEEP_ALIVE_MS     // Keep-alive (ms)
 #define HA_ESP_SENSOR_ENDPOINT  1                 // Main endpoint
+#define HA_ESP_AMBIENT_ENDPOINT 2                 // Ambient temperature/humidity (CONFIG_GLYPH_AMBIENT_SHT4X)
 #define ESP_ZB_PRIMARY_CHANNEL_MASK ESP_ZB_TRANSCEIVER_ALL_CHANNELS_MASK
 
-// Reporting Intervals (for always-on mode)
-#define ZIGBEE_REPORT_INTERVAL  30000             // 30 seconds between reports
+// Per-wake network timing (Kconfig performance profile)
+#define ZIGBEE_JOIN_TIMEOUT_MS  CONFIG_GLYPH_JOIN_TIMEOUT_MS      // Max wait for (re)join
+#define ZIGBEE_TX_LINGER_MS     CONFIG_GLYPH_TX_LINGER_MS         // Max stay awake after a report
+#define OTA_DOWNLOAD_TIMEOUT_SEC CONFIG_GLYPH_OTA_DOWNLOAD_TIMEOUT_SEC  // Deep sleep: max awake for OTA
+
+// Parent queue drain: back-to-back data polls after a (re)join and after
+// each send burst, until a poll comes back empty (no frame pending)
+#define ZIGBEE_DRAIN_POLL_WAIT_MS  20     // Data request to queued frame or empty ack
+#define ZIGBEE_DRAIN_MAX_POLLS     32     // Per drain: a chatty parent cannot hold the radio on
+
+// Battery level report interval (always-on build)
+#define BATTERY_REPORT_INTERVAL_SEC CONFIG_GLYPH_BATTERY_REPORT_INTERVAL_SEC
 
 // ============================================================================
-// DEEP SLEEP CONFIGURATION
+// POWER POLICY PROFILES (switched at runtime by power_policy.c)
 // ============================================================================
 
-// Enable/disable deep sleep mode (set to 1 for battery operation)
-#define DEEP_SLEEP_ENABLED      0                 // 0=always-on, 1=deep sleep
+// Values come from the Kconfig performance profile. Deadbands are taken
+// straight from CONFIG_GLYPH_*_DEADBAND_CENTI (0.01 units) by perf_config.c.
 
-// Deep sleep intervals (when DEEP_SLEEP_ENABLED=1)
-#define DEEP_SLEEP_INTERVAL_SEC 3600              // 1 hour (3600 seconds)
-#define DEEP_SLEEP_WAKE_TIME_MS 60000             // Stay awake for 1 minute
+// High-freshness profile - used while on USB/external power (energy is free)
+#define POWER_FRESH_SAMPLE_INTERVAL_SEC   CONFIG_GLYPH_USB_SAMPLE_INTERVAL_SEC
+#define POWER_FRESH_REPORT_INTERVAL_SEC   CONFIG_GLYPH_USB_REPORT_INTERVAL_SEC
+#define POWER_FRESH_NUM_SAMPLES           CONFIG_GLYPH_USB_NUM_SAMPLES
+#define POWER_FRESH_SAMPLE_SPACING_MS     CONFIG_GLYPH_USB_SAMPLE_SPACING_MS
 
-// Expected battery life with deep sleep (1-hour readings)
-// 1000mAh battery: ~2-3 months (24 wake cycles/day)
-// 2500mAh battery: ~6-8 months
+// Frugal profile - used while on battery (deep sleep between readings)
+#define POWER_FRUGAL_SAMPLE_INTERVAL_SEC  CONFIG_GLYPH_BATT_SAMPLE_INTERVAL_SEC
+#define POWER_FRUGAL_REPORT_INTERVAL_SEC  CONFIG_GLYPH_BATT_REPORT_INTERVAL_SEC
+#define POWER_FRUGAL_NUM_SAMPLES          CONFIG_GLYPH_BATT_NUM_SAMPLES
+#define POWER_FRUGAL_SAMPLE_SPACING_MS    CONFIG_GLYPH_BATT_SAMPLE_SPACING_MS
 
 // ============================================================================
-// TASK CONFIGURATION
+// WATERING EVENT DETECTION (watering_detect.c)
 // ============================================================================
 
-// Task Stack Sizes (INCREASED for stability)
-#define MONITORING_TASK_STACK   4096
-#define BATTERY_TASK_STACK      4096  // INCREASED - ADC + logging needs more space
-#define ZIGBEE_TASK_STACK       8192  // DOUBLED - Zigbee stack needs more space
+// Step-change detector on moisture (0.01 % units)
+#define WATERING_STEP_THRESHOLD      800          // Single-sample rise >= 8% = watering
+#define WATERING_CUSUM_DRIFT         100          // Rise per sample ignored by CUSUM (1%)
+#define WATERING_CUSUM_THRESHOLD     500          // Accumulated rise >= 5% = watering
+#define WATERING_BASELINE_SHIFT      4            // Baseline EWMA weight 1/16 (slow drying drift)
+
+// After an event: fast re-sampling to capture the infiltration curve
+#define WATERING_BURST_SAMPLES       10           // Samples in burst
+#define WATERING_BURST_INTERVAL_SEC  30           // 30 seconds between burst samples
+
+// Deep sleep: radio-free sense wakes between full readings
+#define WATERING_SENSE_INTERVAL_SEC  CONFIG_GLYPH_SENSE_INTERVAL_SEC  // Quick moisture check
+
+// ============================================================================
+// PARENT LINK QUALITY (link_quality.c)
+// ============================================================================
+
+// Checked once per radio wake (deep sleep) or every LINK_CHECK_INTERVAL_MS (always-on)
+#define LINK_LQI_SHIFT               2            // Parent LQI/RSSI EWMA weight 1/4 per check
+#define LINK_FAIL_SHIFT              3            // Failure EWMA weight 1/8 per frame
+#define LINK_COST_BAD                200          // >= 2 transmissions per delivered frame = costly
+#define LINK_COST_GOOD               140          // <= 1.4 clears the costly-check count (hysteresis)
+#define LINK_BAD_CHECKS              3            // Consecutive costly checks before reselecting
+#define LINK_REJOIN_COST_FRAMES      20           // Rejoin (scan + association) in frame transmissions
+#define LINK_RESELECT_MIN_CHECKS     6            // Hold-off after a reselection
+#define LINK_RESELECT_MAX_CHECKS     192          // Hold-off cap after repeated fruitless reselections
+#define LINK_CHECK_INTERVAL_MS       3600000      // Always-on: check hourly
+
+// ============================================================================
+// CHARGE-AWARE SCHEDULING (charge_state.c, power_policy.c)
+// ============================================================================
+
+// Harvest detection from the pack voltage across wakes (no charger status line)
+#define CHARGE_SAMPLE_SPACING_SEC    900          // Min spacing of slope samples
+#define CHARGE_WINDOW_SEC            10800        // Slope over the last 3 h
+#define CHARGE_MIN_SAMPLES           3
+#define CHARGE_MIN_SPAN_SEC          1800
+#define CHARGE_HARVEST_ENTER_MV_H    6            // Rise that means charging
+#define CHARGE_HARVEST_ENTER_CHECKS  2            // ... on consecutive samples (ADC noise)
+#define CHARGE_HARVEST_EXIT_MV_H     2            // Harvest continues while rising this much
+#define CHARGE_FLOAT_MV              4100         // ... or held at/near full by the charger
+#define CHARGE_FLOAT_SAG_MV_H        10           // Steeper fall at float = charger dropped out
+#define CHARGE_HARVEST_MAX_SEC       57600        // No daylight period is longer (16 h)
+#define CHARGE_DAY_SEC               93600        // No harvest for 26 h: plain battery node
+
+// Energy-neutral profiles on battery: spend while harvesting, save in the dark
+#define CHARGE_HARVEST_RATE_DIVISOR  4            // Harvest: battery intervals / 4 (not below USB's)
+#define CHARGE_DARK_RATE_MULTIPLIER  2            // Dark after a harvest that did not fill the pack
+#define CHARGE_DARK_SAVE_PERCENT     60.0f        // Dark below this charge, even after a full pack
+
+// ============================================================================
+// READING HISTORY (history_log.c)
+// ============================================================================
 
-// Task Priorities
-#define MONITORING_TASK_PRIORITY 5
-#define BATTERY_TASK_PRIORITY    4
+#define HISTORY_PARTITION_LABEL      "history"    // Flash partition (partitions.csv)
+#define HISTORY_STAGING_BYTES        224          // Encoded readings staged in RTC per flash write
+#define HISTORY_PULL_CHUNK_RECORDS   32           // Max readings per historyChunk report (bytes permitting)
+#define HISTORY_PULL_INTERVAL_MS     250          // Delay between chunk reports
+#define HISTORY_PULL_MAX_WAIT_MS     60000        // Deep sleep: max time to stay awake for a pull
+
+// ============================================================================
+// OTA IMAGE WRITER (ota_writer.c)
+// ============================================================================
+
+// Blocks are copied into one of two page buffers in the Zigbee callback;
+// hashing, erasing and programming run in the app loop
+#define OTA_WRITE_PAGE_SIZE          4096         // One flash sector per buffer (2 static in ota_writer.c)
+#define OTA_ERASE_AHEAD_SECTORS      4            // Sectors kept erased ahead of the write position
+#define OTA_PROGRESS_LOG_BLOCKS      64           // Log download progress every N blocks
+#define OTA_RESTART_DELAY_MS         3000         // Upgrade end response goes out before the restart
+
+// ============================================================================
+// COMMISSIONING-FREE UPLINK (gp_uplink.c)
+// ============================================================================
+
+#ifdef CONFIG_GLYPH_GP_UPLINK
+#define GP_UPLINK_ENABLED            1
+#define GP_FULL_WAKE_REPORTS         CONFIG_GLYPH_GP_FULL_WAKE_REPORTS
+#else
+#define GP_UPLINK_ENABLED            0
+#define GP_FULL_WAKE_REPORTS         0
+#endif
+#define GP_TX_REPEATS                3            // Copies of every frame (no acks)
+#define GP_TX_GAP_US                 2000         // Between copies
+#define GP_TX_TIMEOUT_US             10000        // Transmit of one copy
+#define GP_COUNTER_BLOCK             256          // Frame counters reserved per NVS write
+#define GP_COMMISSION_SLEEP_SEC      5            // Sleep before the commissioning wake
+
+// ============================================================================
+// DEFERRED BINARY LOGGING (binlog.c)
+// ============================================================================
+
+#define BINLOG_DEFAULT_LEVEL         3            // BINLOG_LEVEL_INFO (modules may override)
+#define BINLOG_RING_WORDS            512          // RTC ring size in 32-bit words (2 KB)
+#define BINLOG_UART_CONSOLE_ATTACHED false        // UART console: dump only on request
+
+// ============================================================================
+// FIELD TRACE (field_trace.c)
+// ============================================================================
+
+#ifdef CONFIG_GLYPH_FIELD_TRACE
+#define FIELD_TRACE_ENABLED          1
+#else
+#define FIELD_TRACE_ENABLED          0
+#endif
+#define FIELD_TRACE_PARTITION_LABEL  "trace"      // Flash partition (partitions.csv)
+#define FIELD_TRACE_RING_RECORDS     128          // RTC ring (20 bytes per record, 2.5 KB)
+#define FIELD_TRACE_SPILL_RECORDS    64           // Spill the ring to flash from this fill level
+
+// ============================================================================
+// TASK CONFIGURATION
+// ============================================================================
+
+// Two tasks with static stacks: the application event loop (app_loop.h)
+// and the Zigbee stack. Both log their stack high-water mark at the end of
+// every wake; size them from those numbers, not by doubling.
+#define APP_LOOP_TASK_STACK      3072  // Bytes (I2C read + ZCL set + flash write deep)
+#define APP_LOOP_TASK_PRIORITY   5
+#define APP_LOOP_QUEUE_LENGTH    8     // Pending events (timers + Zigbee callbacks)
+#define ZIGBEE_TASK_STACK        8192  // Bytes (ZBOSS main loop)
 #define ZIGBEE_TASK_PRIORITY     6
+#define TASK_STACK_WARN_BYTES    512   // Warn when less than this was never used
 
 // ============================================================================
 // THREAD SAFETY CONFIGURATION
@@ -175,5 +333,33 @@
 // Mutex Timeout Values
 #define BATTERY_MUTEX_TIMEOUT_MS 100
 
+// ============================================================================
+// BUILD-TIME CONSISTENCY CHECKS (reject contradictory profile overrides)
+// ============================================================================
+
+_Static_assert(POWER_FRUGAL_REPORT_INTERVAL_SEC >= POWER_FRUGAL_SAMPLE_INTERVAL_SEC,
+               "Battery heartbeat must not be shorter than the battery sample interval");
+_Static_assert(POWER_FRESH_REPORT_INTERVAL_SEC >= POWER_FRESH_SAMPLE_INTERVAL_SEC,
+               "USB heartbeat must not be shorter than the USB sample interval");
+_Static_assert((uint64_t)POWER_FRUGAL_NUM_SAMPLES * POWER_FRUGAL_SAMPLE_SPACING_MS <
+               (uint64_t)POWER_FRUGAL_SAMPLE_INTERVAL_SEC * 1000,
+               "Battery sample averaging must finish within one sample interval");
+_Static_assert((uint64_t)POWER_FRESH_NUM_SAMPLES * POWER_FRESH_SAMPLE_SPACING_MS <
+               (uint64_t)POWER_FRESH_SAMPLE_INTERVAL_SEC * 1000,
+               "USB sample averaging must finish within one sample interval");
+_Static_assert(POWER_FRESH_SAMPLE_INTERVAL_SEC <= POWER_FRUGAL_SAMPLE_INTERVAL_SEC,
+               "USB (fresh) sampling must not be slower than battery (frugal) sampling");
+_Static_assert(WATERING_SENSE_INTERVAL_SEC <= POWER_FRUGAL_SAMPLE_INTERVAL_SEC,
+               "Watering sense wakes must be more frequent than full readings");
+_Static_assert(WATERING_BURST_INTERVAL_SEC < WATERING_SENSE_INTERVAL_SEC,
+               "Watering burst sampling must be faster than sense wakes");
+_Static_assert((uint64_t)ZIGBEE_JOIN_TIMEOUT_MS + ZIGBEE_TX_LINGER_MS <
+               (uint64_t)POWER_FRUGAL_SAMPLE_INTERVAL_SEC * 1000,
+               "Join wait plus linger must fit inside one battery sample interval");
+_Static_assert(OTA_WRITE_PAGE_SIZE % 4096 == 0,
+               "OTA page buffers must hold whole flash sectors");
+_Static_assert(ED_KEEP_ALIVE < 64UL * 60 * 1000,
+               "End device keep-alive must be shorter than the 64 min aging timeout");
+
 #endif // SYSTEM_CONFIG_H
 
@@ -0,0 +1,89 @@
+/*
+ * Glyph C6 Monitor - Watering Event Detector
+ *
+ * Version: 1.0.0
+ */
+
+#include "watering_detect.h"
+#include "system_config.h"
+#include "binlog.h"
+#include <string.h>
+
+static const char *TAG = "WATERING";
+
+// ============================================================================
+// PUBLIC FUNCTIONS
+// ============================================================================
+
+void watering_detect_reset(watering_detector_t *detector)
+{
+    memset(detector, 0, sizeof(*detector));
+}
+
+bool watering_detect_update(watering_detector_t *detector, uint16_t moisture_centi, bool *burst_done)
+{
+    int32_t sample = moisture_centi;
+
+    if (burst_done) {
+        *burst_done = false;
+    }
+
+    if (!detector->primed) {
+        detector->baseline = sample;
+        detector->last = moisture_centi;
+        detector->cusum = 0;
+        detector->primed = true;
+        return false;
+    }
+
+    // Slope: rise since the previous sample
+    int32_t step = sample - (int32_t)detector->last;
+    detector->last = moisture_centi;
+
+    // One-sided CUSUM of rises above baseline (drift term absorbs noise)
+    detector->cusum += sample - detector->baseline - WATERING_CUSUM_DRIFT;
+    if (detector->cusum < 0) {
+        detector->cusum = 0;
+    }
+
+    bool triggered = (step >= WATERING_STEP_THRESHOLD) || (detector->cusum >= WATERING_CUSUM_THRESHOLD);
+
+    if (triggered) {
+        // Re-arm on the new moisture level
+        detector->baseline = sample;
+        detector->cusum = 0;
+
+        if (detector->burst_remaining == 0) {
+            detector->event_count++;
+            detector->burst_remaining = WATERING_BURST_SAMPLES;
+            BLOG_I(TAG, "Watering detected (step %+" PRId32 ", event #%" PRIu32 ") - starting %d-sample burst",
+                     step, detector->event_count, WATERING_BURST_SAMPLES);
+            return true;
+        }
+    } else {
+        // Baseline follows slow drying/wetting drift
+        detector->baseline += (sample - detector->baseline) >> WATERING_BASELINE_SHIFT;
+    }
+
+    if (detector->burst_remaining > 0) {
+        detector->burst_remaining--;
+        if (detector->burst_remaining == 0) {
+            BLOG_I(TAG, "Burst complete - back to normal schedule");
+            if (burst_done) {
+                *burst_done = true;
+            }
+        }
+    }
+
+    return false;
+}
+
+bool watering_detect_in_burst(const watering_detector_t *detector)
+{
+    return detector->burst_remaining > 0;
+}
+
+uint32_t watering_detect_event_count(const watering_detector_t *detector)
+{
+    return detector->event_count;
+}
@@ -0,0 +1,65 @@
+/*
+ * Glyph C6 Monitor - Watering Event Detector
+ *
+ * Version: 1.0.0
+ *
+ * Step-change detector on the moisture stream. Combines a single-sample
+ * slope threshold (fast, large rises) with a one-sided CUSUM (slower,
+ * accumulated rises) against a slowly tracking baseline. On detection the
+ * caller reports immediately and runs a short burst of fast re-sampling
+ * to capture the infiltration curve before returning to its schedule.
+ *
+ * Moisture is in 0.01 % units. A zero-initialized detector is a valid
+ * reset state, so it can live in RTC memory across deep sleep.
+ */
+
+#ifndef WATERING_DETECT_H
+#define WATERING_DETECT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Detector state
+typedef struct {
+    bool primed;                  // Baseline initialized
+    uint16_t last;                // Previous sample (0.01 %)
+    int32_t baseline;             // Tracked baseline (0.01 %)
+    int32_t cusum;                // One-sided CUSUM of rises above baseline
+    uint8_t burst_remaining;      // Fast samples left in the current burst
+    uint32_t event_count;         // Watering events since power-on
+} watering_detector_t;
+
+/**
+ * @brief Reset detector state
+ * @param detector Detector to reset
+ */
+void watering_detect_reset(watering_detector_t *detector);
+
+/**
+ * @brief Feed one moisture sample
+ *
+ * Also advances a running burst: samples taken during a burst count
+ * towards WATERING_BURST_SAMPLES.
+ *
+ * @param detector Detector state
+ * @param moisture_centi Moisture in 0.01 % units
+ * @param burst_done Set true when this sample completed a burst (may be NULL)
+ * @return true if this sample started a new watering event
+ */
+bool watering_detect_update(watering_detector_t *detector, uint16_t moisture_centi, bool *burst_done);
+
+/**
+ * @brief Check if a fast re-sampling burst is running
+ * @param detector Detector state
+ * @return true while burst samples remain
+ */
+bool watering_detect_in_burst(const watering_detector_t *detector);
+
+/**
+ * @brief Get number of watering events detected since power-on
+ * @param detector Detector state
+ * @return Event count
+ */
+uint32_t watering_detect_event_count(const watering_detector_t *detector);
+
+#endif // WATERING_DETECT_H
@@ -10,9 +10,19 @@
 #include "zigbee_core.h"
 #include "esp_log.h"
 #include "esp_check.h"
+#include "esp_attr.h"
 #include "esp_zigbee_attribute.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "sample_window.h"
+#include "freshness.h"
+#include "sensor_convert.h"
+#include "history_log.h"
+#include "deep_sleep.h"
+#include "perf_config.h"
+#include "field_trace.h"
+#include "gp_uplink.h"
+#include "zboss_api.h"
 #include <string.h>  // For strlen, strcpy
 
 // Define missing Power Config cluster attribute IDs (not in ESP Zigbee SDK headers)
@@ -39,18 +49,95 @@ static zigbee_device_info_t device_info = {
     .short_address = 0
 };
 
-// Task handles
+// Task handle and its static stack (counted in the image RAM report)
 static TaskHandle_t zigbee_main_loop_task_handle = NULL;
+static StackType_t zigbee_main_loop_stack[ZIGBEE_TASK_STACK];
+static StaticTask_t zigbee_main_loop_tcb;
 
 // Action handler callback
 static esp_err_t (*action_handler_callback)(esp_zb_core_action_callback_id_t, const void *) = NULL;
 
+// Join state change callback
+static void (*join_callback)(bool joined) = NULL;
+
+// History pull finished callback
+static void (*history_pull_callback)(void) = NULL;
+
+// Stack sleep (light sleep) requested before init
+static bool sleep_enabled = false;
+
+// History pull in progress (driven by Zigbee scheduler alarms)
+static history_cursor_t history_cursor;
+static bool history_pull_active = false;
+static uint8_t history_chunk_seq = 0;
+static history_reading_t history_pending[HISTORY_PULL_CHUNK_RECORDS];  // Read, not yet sent
+static size_t history_pending_count = 0;
+
+// Parent link quality (survives deep sleep: one check per radio wake)
+static RTC_DATA_ATTR link_quality_t rtc_link;
+
+// Leave-with-rejoin for a parent reselection in progress
+static bool link_rejoining = false;
+
+// Radio idle callback (sends confirmed, parent queue drained)
+static void (*radio_idle_callback)(void) = NULL;
+
+// Parent queue drain, driven by Zigbee scheduler alarms
+static bool drain_active = false;
+static uint16_t drain_polls = 0;
+static uint32_t drain_start_ms = 0;
+static uint32_t drain_rx_start = 0;      // rx_frames when the drain started
+static uint32_t drain_rx_at_poll = 0;    // rx_frames when the last poll went out
+static uint32_t rx_frames = 0;           // Incoming APS data frames (APS indication handler)
+static uint16_t tx_pending = 0;          // Reports still waiting for their send status
+static RTC_DATA_ATTR zigbee_drain_stats_t rtc_drain;
+
+// Power source last reported to the coordinator (0 = unknown, not yet reported)
+static RTC_DATA_ATTR uint8_t rtc_reported_power_source;
+
+// Configuration cluster attribute -> runtime parameter
+static const struct {
+    uint16_t attr_id;
+    perf_param_t param;
+} config_attrs[] = {
+    { GLYPH_ATTR_CFG_BATT_SAMPLE_INTERVAL_ID, PERF_PARAM_BATT_SAMPLE_INTERVAL_SEC },
+    { GLYPH_ATTR_CFG_BATT_REPORT_INTERVAL_ID, PERF_PARAM_BATT_REPORT_INTERVAL_SEC },
+    { GLYPH_ATTR_CFG_BATT_NUM_SAMPLES_ID,     PERF_PARAM_BATT_NUM_SAMPLES },
+    { GLYPH_ATTR_CFG_BATT_SAMPLE_SPACING_ID,  PERF_PARAM_BATT_SAMPLE_SPACING_MS },
+    { GLYPH_ATTR_CFG_BATT_MOISTURE_DB_ID,     PERF_PARAM_BATT_MOISTURE_DEADBAND_CENTI },
+    { GLYPH_ATTR_CFG_BATT_TEMP_DB_ID,         PERF_PARAM_BATT_TEMP_DEADBAND_CENTI },
+    { GLYPH_ATTR_CFG_USB_SAMPLE_INTERVAL_ID,  PERF_PARAM_USB_SAMPLE_INTERVAL_SEC },
+    { GLYPH_ATTR_CFG_USB_REPORT_INTERVAL_ID,  PERF_PARAM_USB_REPORT_INTERVAL_SEC },
+    { GLYPH_ATTR_CFG_USB_NUM_SAMPLES_ID,      PERF_PARAM_USB_NUM_SAMPLES },
+    { GLYPH_ATTR_CFG_USB_SAMPLE_SPACING_ID,   PERF_PARAM_USB_SAMPLE_SPACING_MS },
+    { GLYPH_ATTR_CFG_USB_MOISTURE_DB_ID,      PERF_PARAM_USB_MOISTURE_DEADBAND_CENTI },
+    { GLYPH_ATTR_CFG_USB_TEMP_DB_ID,          PERF_PARAM_USB_TEMP_DEADBAND_CENTI },
+    { GLYPH_ATTR_CFG_SENSE_INTERVAL_ID,       PERF_PARAM_SENSE_INTERVAL_SEC },
+};
+#define CONFIG_ATTR_COUNT (sizeof(config_attrs) / sizeof(config_attrs[0]))
+
 // ============================================================================
 // PRIVATE FUNCTION PROTOTYPES
 // ============================================================================
 
 static void zigbee_main_loop_task(void *param);
 static void bdb_start_top_level_commissioning_wrapper(uint8_t mode_mask);
+static void set_joined(bool joined);
+static void link_sample_parent(uint8_t *candidate_lqi);
+static bool link_check(void);
+static void link_check_step(uint8_t param);
+static void link_arm_check(void);
+static void send_status_cb(esp_zb_zcl_command_send_status_message_t message);
+static bool aps_data_cb(esp_zb_apsde_data_ind_t ind);
+static void drain_start(void);
+static void drain_poll(void);
+static void drain_step(uint8_t param);
+static void drain_finish(void);
+static void history_pull_step(uint8_t param);
+static void config_sync_step(uint8_t param);
+static bool config_attr_value(uint16_t attr_id, const void *value, perf_param_t *param, uint32_t *v);
+static esp_err_t config_check_value(uint16_t attr_id, uint8_t endpoint, uint8_t *value);
+static uint8_t config_attr_type(perf_param_t param);
 
 // ============================================================================
 // PUBLIC FUNCTIONS
@@ -79,6 +166,12 @@ esp_err_t zigbee_core_init(void)
         },
     };
     
+    // Stack sleep must be enabled before esp_zb_init()
+    if (sleep_enabled) {
+        esp_zb_sleep_enable(true);
+        ESP_LOGI(TAG, "Zigbee stack sleep enabled");
+    }
+    
     // Initialize Zigbee stack
     esp_zb_init(&zb_nwk_cfg);
     
@@ -132,6 +225,19 @@ esp_err_t zigbee_core_start(void)
     // Register the device
     esp_zb_device_register(esp_zb_sensor_ep);
     
+    // Delivery confirmations feed the parent link quality and the idle
+    // tracking; incoming frames are counted for the parent queue drain
+    esp_zb_zcl_command_send_status_handler_register(send_status_cb);
+    esp_zb_aps_data_indication_handler_register(aps_data_cb);
+    
+    // Configuration writes perf_config would reject are refused by the stack
+    esp_zb_zcl_custom_cluster_handlers_t config_handlers = {
+        .cluster_id = GLYPH_CLUSTER_ID_CONFIG,
+        .cluster_role = ESP_ZB_ZCL_CLUSTER_SERVER_ROLE,
+        .check_value_cb = config_check_value,
+    };
+    esp_zb_zcl_custom_cluster_handlers_update(config_handlers);
+    
     // Set primary network channel
     esp_zb_set_primary_network_channel_set(ESP_ZB_PRIMARY_CHANNEL_MASK);
     
@@ -173,16 +279,17 @@ esp_err_t zigbee_core_start_main_loop_task(void)
         return ESP_OK;
     }
     
-    BaseType_t ret = xTaskCreate(
+    zigbee_main_loop_task_handle = xTaskCreateStatic(
         zigbee_main_loop_task,
         "zigbee_main",
         ZIGBEE_TASK_STACK,
         NULL,
         ZIGBEE_TASK_PRIORITY,
-        &zigbee_main_loop_task_handle
+        zigbee_main_loop_stack,
+        &zigbee_main_loop_tcb
     );
     
-    if (ret != pdPASS) {
+    if (zigbee_main_loop_task_handle == NULL) {
         ESP_LOGE(TAG, "Failed to create Zigbee main loop task");
         return ESP_FAIL;
     }
@@ -212,6 +319,29 @@ bool zigbee_core_get_device_info(zigbee_device_info_t *info)
     return true;
 }
 
+bool zigbee_core_get_link_quality(link_quality_t *link)
+{
+    if (!link) {
+        return false;
+    }
+    *link = rtc_link;
+    return rtc_link.primed;
+}
+
+bool zigbee_core_get_drain_stats(zigbee_drain_stats_t *stats)
+{
+    if (!stats) {
+        return false;
+    }
+    *stats = rtc_drain;
+    return rtc_drain.drains > 0;
+}
+
+bool zigbee_core_radio_idle(void)
+{
+    return !drain_active && tx_pending == 0;
+}
+
 bool zigbee_core_is_joined(void)
 {
     return device_info.zigbee_joined;
@@ -299,7 +429,8 @@ esp_zb_cluster_list_t *zigbee_core_create_sensor_clusters(
     ESP_ERROR_CHECK(esp_zb_cluster_list_add_basic_cluster(cluster_list, basic_cluster, 
         ESP_ZB_ZCL_CLUSTER_SERVER_ROLE));
     
-    // Identify cluster (required)
+#if CONFIG_GLYPH_ZCL_IDENTIFY
+    // Identify cluster (HA-mandatory, nothing in the firmware reacts to it)
     esp_zb_attribute_list_t *identify_cluster = esp_zb_identify_cluster_create(identify_cfg);
     if (!identify_cluster) {
         ESP_LOGE(TAG, "Failed to create identify cluster");
@@ -307,6 +438,9 @@ esp_zb_cluster_list_t *zigbee_core_create_sensor_clusters(
     }
     ESP_ERROR_CHECK(esp_zb_cluster_list_add_identify_cluster(cluster_list, identify_cluster, 
         ESP_ZB_ZCL_CLUSTER_SERVER_ROLE));
+#else
+    (void)identify_cfg;
+#endif
     
     // Power Configuration cluster for battery reporting
     esp_zb_power_config_cluster_cfg_t power_config_cfg = {
@@ -337,6 +471,7 @@ esp_zb_cluster_list_t *zigbee_core_create_sensor_clusters(
     ESP_ERROR_CHECK(esp_zb_cluster_list_add_power_config_cluster(cluster_list, power_config_cluster, 
         ESP_ZB_ZCL_CLUSTER_SERVER_ROLE));
     
+#if CONFIG_GLYPH_ZCL_LED
     // On/Off cluster for remote LED control
     esp_zb_on_off_cluster_cfg_t on_off_cfg = {
         .on_off = ESP_ZB_ZCL_ON_OFF_ON_OFF_DEFAULT_VALUE,
@@ -348,6 +483,7 @@ esp_zb_cluster_list_t *zigbee_core_create_sensor_clusters(
     }
     ESP_ERROR_CHECK(esp_zb_cluster_list_add_on_off_cluster(cluster_list, on_off_cluster, 
         ESP_ZB_ZCL_CLUSTER_SERVER_ROLE));
+#endif
     
     // Temperature Measurement cluster for soil temperature
     // Min/Max: -40°C to +80°C in 0.01°C units (-4000 to 8000)
@@ -383,7 +519,7 @@ esp_zb_cluster_list_t *zigbee_core_create_sensor_clusters(
     esp_zb_ota_cluster_cfg_t ota_cfg = {
         .ota_upgrade_file_version = FIRMWARE_VERSION,  // Current firmware version from config
         .ota_upgrade_downloaded_file_ver = 0xFFFFFFFF,
-        .ota_upgrade_manufacturer = 0x1234,      // FloraTech manufacturer code
+        .ota_upgrade_manufacturer = ESP_MANUFACTURER_CODE,  // FloraTech manufacturer code
         .ota_upgrade_image_type = 0x0000,
     };
     esp_zb_attribute_list_t *ota_cluster = esp_zb_ota_cluster_create(&ota_cfg);
@@ -395,7 +531,114 @@ esp_zb_cluster_list_t *zigbee_core_create_sensor_clusters(
         ESP_LOGI(TAG, "OTA cluster added (client role) - firmware updates enabled");
     }
     
-    ESP_LOGI(TAG, "All clusters created successfully (Basic, Identify, PowerConfig, OnOff, Temperature, Humidity, OTA)");
+    // FloraTech statistics cluster (manufacturer-specific)
+    // Octet string attributes are sized by their initial length byte, so start at full length
+    uint8_t window_stats_init[SAMPLE_WINDOW_RECORD_LEN + 1] = { SAMPLE_WINDOW_RECORD_LEN };
+    esp_zb_attribute_list_t *stats_cluster = esp_zb_zcl_attr_list_create(GLYPH_CLUSTER_ID_STATS);
+    if (!stats_cluster) {
+        ESP_LOGW(TAG, "Failed to create statistics cluster");
+    } else {
+        ESP_ERROR_CHECK(esp_zb_custom_cluster_add_custom_attr(stats_cluster,
+            GLYPH_ATTR_WINDOW_STATS_ID,
+            ESP_ZB_ZCL_ATTR_TYPE_OCTET_STRING,
+            ESP_ZB_ZCL_ATTR_ACCESS_READ_ONLY | ESP_ZB_ZCL_ATTR_ACCESS_REPORTING,
+            window_stats_init));
+        uint32_t watering_events_init = 0;
+        ESP_ERROR_CHECK(esp_zb_custom_cluster_add_custom_attr(stats_cluster,
+            GLYPH_ATTR_WATERING_EVENTS_ID,
+            ESP_ZB_ZCL_ATTR_TYPE_U32,
+            ESP_ZB_ZCL_ATTR_ACCESS_READ_ONLY | ESP_ZB_ZCL_ATTR_ACCESS_REPORTING,
+            &watering_events_init));
+        uint8_t history_request_init[9] = { 8 };
+        ESP_ERROR_CHECK(esp_zb_custom_cluster_add_custom_attr(stats_cluster,
+            GLYPH_ATTR_HISTORY_REQUEST_ID,
+            ESP_ZB_ZCL_ATTR_TYPE_OCTET_STRING,
+            ESP_ZB_ZCL_ATTR_ACCESS_READ_WRITE,
+            history_request_init));
+        uint8_t history_chunk_init[GLYPH_HISTORY_CHUNK_MAX_LEN + 1] = { GLYPH_HISTORY_CHUNK_MAX_LEN };
+        ESP_ERROR_CHECK(esp_zb_custom_cluster_add_custom_attr(stats_cluster,
+            GLYPH_ATTR_HISTORY_CHUNK_ID,
+            ESP_ZB_ZCL_ATTR_TYPE_OCTET_STRING,
+            ESP_ZB_ZCL_ATTR_ACCESS_READ_ONLY | ESP_ZB_ZCL_ATTR_ACCESS_REPORTING,
+            history_chunk_init));
+        uint8_t freshness_init[FRESHNESS_RECORD_LEN + 1] = { FRESHNESS_RECORD_LEN };
+        ESP_ERROR_CHECK(esp_zb_custom_cluster_add_custom_attr(stats_cluster,
+            GLYPH_ATTR_FRESHNESS_ID,
+            ESP_ZB_ZCL_ATTR_TYPE_OCTET_STRING,
+            ESP_ZB_ZCL_ATTR_ACCESS_READ_ONLY | ESP_ZB_ZCL_ATTR_ACCESS_REPORTING,
+            freshness_init));
+        ESP_ERROR_CHECK(esp_zb_cluster_list_add_custom_cluster(cluster_list, stats_cluster,
+            ESP_ZB_ZCL_CLUSTER_SERVER_ROLE));
+    }
+    
+    // FloraTech runtime configuration cluster (manufacturer-specific)
+    esp_zb_attribute_list_t *config_cluster = esp_zb_zcl_attr_list_create(GLYPH_CLUSTER_ID_CONFIG);
+    if (!config_cluster) {
+        ESP_LOGW(TAG, "Failed to create configuration cluster");
+    } else {
+        for (size_t i = 0; i < CONFIG_ATTR_COUNT; i++) {
+            // Attribute store copies the value - a 32-bit LE buffer serves U8/U16/U32
+            uint32_t value = perf_config_get(config_attrs[i].param);
+            ESP_ERROR_CHECK(esp_zb_custom_cluster_add_custom_attr(config_cluster,
+                config_attrs[i].attr_id,
+                config_attr_type(config_attrs[i].param),
+                ESP_ZB_ZCL_ATTR_ACCESS_READ_WRITE,
+                &value));
+        }
+        bool pending = perf_config_pending();
+        ESP_ERROR_CHECK(esp_zb_custom_cluster_add_custom_attr(config_cluster,
+            GLYPH_ATTR_CFG_PENDING_ID,
+            ESP_ZB_ZCL_ATTR_TYPE_BOOL,
+            ESP_ZB_ZCL_ATTR_ACCESS_READ_ONLY | ESP_ZB_ZCL_ATTR_ACCESS_REPORTING,
+            &pending));
+        bool gp_uplink = gp_uplink_requested();
+        ESP_ERROR_CHECK(esp_zb_custom_cluster_add_custom_attr(config_cluster,
+            GLYPH_ATTR_CFG_GP_UPLINK_ID,
+            ESP_ZB_ZCL_ATTR_TYPE_BOOL,
+            ESP_ZB_ZCL_ATTR_ACCESS_READ_WRITE,
+            &gp_uplink));
+        uint32_t gp_src_id = gp_uplink_src_id();
+        ESP_ERROR_CHECK(esp_zb_custom_cluster_add_custom_attr(config_cluster,
+            GLYPH_ATTR_CFG_GP_SRC_ID,
+            ESP_ZB_ZCL_ATTR_TYPE_U32,
+            ESP_ZB_ZCL_ATTR_ACCESS_READ_ONLY | ESP_ZB_ZCL_ATTR_ACCESS_REPORTING,
+            &gp_src_id));
+        ESP_ERROR_CHECK(esp_zb_cluster_list_add_custom_cluster(cluster_list, config_cluster,
+            ESP_ZB_ZCL_CLUSTER_SERVER_ROLE));
+    }
+    
+    ESP_LOGI(TAG, "All clusters created successfully (Basic, Identify, PowerConfig, OnOff, Temperature, Humidity, OTA, Stats, Config)");
+    return cluster_list;
+}
+
+/**
+ * @brief Ambient air endpoint: the standard clusters, this time for air
+ */
+static esp_zb_cluster_list_t *create_ambient_clusters(esp_zb_basic_cluster_cfg_t *basic_cfg)
+{
+    esp_zb_cluster_list_t *cluster_list = esp_zb_zcl_cluster_list_create();
+    if (!cluster_list) {
+        return NULL;
+    }
+    ESP_ERROR_CHECK(esp_zb_cluster_list_add_basic_cluster(cluster_list,
+        esp_zb_basic_cluster_create(basic_cfg), ESP_ZB_ZCL_CLUSTER_SERVER_ROLE));
+    
+    // SHT4x range: -40°C to +125°C, 0-100 %RH
+    esp_zb_temperature_meas_cluster_cfg_t temp_cfg = {
+        .measured_value = ESP_ZB_ZCL_TEMP_MEASUREMENT_MEASURED_VALUE_DEFAULT,
+        .min_value = -4000,
+        .max_value = 12500,
+    };
+    ESP_ERROR_CHECK(esp_zb_cluster_list_add_temperature_meas_cluster(cluster_list,
+        esp_zb_temperature_meas_cluster_create(&temp_cfg), ESP_ZB_ZCL_CLUSTER_SERVER_ROLE));
+    
+    esp_zb_humidity_meas_cluster_cfg_t humidity_cfg = {
+        .measured_value = ESP_ZB_ZCL_REL_HUMIDITY_MEASUREMENT_MEASURED_VALUE_DEFAULT,
+        .min_value = 0,
+        .max_value = 10000,
+    };
+    ESP_ERROR_CHECK(esp_zb_cluster_list_add_humidity_meas_cluster(cluster_list,
+        esp_zb_humidity_meas_cluster_create(&humidity_cfg), ESP_ZB_ZCL_CLUSTER_SERVER_ROLE));
     return cluster_list;
 }
 
@@ -424,6 +667,18 @@ esp_zb_ep_list_t *zigbee_core_create_sensor_endpoint(
     }
     
     esp_zb_ep_list_add_ep(ep_list, cluster_list, endpoint_config);
+    
+    if (AMBIENT_SENSOR_ENABLED) {
+        esp_zb_cluster_list_t *ambient_list = create_ambient_clusters(basic_cfg);
+        if (!ambient_list) {
+            ESP_LOGE(TAG, "Failed to create ambient clusters");
+            return NULL;
+        }
+        esp_zb_endpoint_config_t ambient_config = endpoint_config;
+        ambient_config.endpoint = HA_ESP_AMBIENT_ENDPOINT;
+        ambient_config.app_device_id = ESP_ZB_HA_TEMPERATURE_SENSOR_DEVICE_ID;
+        esp_zb_ep_list_add_ep(ep_list, ambient_list, ambient_config);
+    }
     ESP_LOGI(TAG, "Sensor endpoint created successfully");
     return ep_list;
 }
@@ -434,6 +689,8 @@ void zigbee_core_app_signal_handler(esp_zb_app_signal_t *signal_struct)
     esp_err_t err_status = signal_struct->esp_err_status;
     esp_zb_app_signal_type_t sig_type = *p_sg_p;
     
+    field_trace_zb_signal(sig_type, err_status);
+    
     switch (sig_type) {
     case ESP_ZB_ZDO_SIGNAL_SKIP_STARTUP:
         ESP_LOGI(TAG, "Zigbee stack initialized");
@@ -448,16 +705,29 @@ void zigbee_core_app_signal_handler(esp_zb_app_signal_t *signal_struct)
             if (esp_zb_bdb_is_factory_new()) {
                 ESP_LOGI(TAG, "Start network steering");
                 esp_zb_bdb_start_top_level_commissioning(ESP_ZB_BDB_MODE_NETWORK_STEERING);
+            } else if (link_rejoining) {
+                // Leave-with-rejoin done: the stack picked the best parent it heard
+                link_rejoining = false;
+                link_sample_parent(NULL);
+                device_info.short_address = esp_zb_get_short_address();
+                set_joined(true);
+                link_arm_check();
+                ESP_LOGI(TAG, "Rejoined through parent 0x%04hx - Zigbee reporting ready", rtc_link.parent);
             } else {
                 ESP_LOGI(TAG, "Device rebooted - already joined");
-                device_info.zigbee_joined = true;
+                if (link_check()) {
+                    break;  // Reporting resumes once the rejoin completes
+                }
                 device_info.pan_id = esp_zb_get_pan_id();
                 device_info.channel = esp_zb_get_current_channel();
                 device_info.short_address = esp_zb_get_short_address();
+                set_joined(true);
+                link_arm_check();
                 
                 ESP_LOGI(TAG, "Zigbee reporting ready");
             }
         } else {
+            link_rejoining = false;
             ESP_LOGW(TAG, "Failed to initialize Zigbee stack (status: %s)", esp_err_to_name(err_status));
         }
         break;
@@ -466,27 +736,51 @@ void zigbee_core_app_signal_handler(esp_zb_app_signal_t *signal_struct)
         if (err_status == ESP_OK) {
             esp_zb_ieee_addr_t extended_pan_id;
             esp_zb_get_extended_pan_id(extended_pan_id);
-            ESP_LOGI(TAG, "✅✅✅ JOINED NETWORK SUCCESSFULLY! ✅✅✅");
+            ESP_LOGI(TAG, "JOINED NETWORK SUCCESSFULLY!");
             ESP_LOGI(TAG, "Extended PAN ID: %02x:%02x:%02x:%02x:%02x:%02x:%02x:%02x",
                      extended_pan_id[7], extended_pan_id[6], extended_pan_id[5], extended_pan_id[4],
                      extended_pan_id[3], extended_pan_id[2], extended_pan_id[1], extended_pan_id[0]);
             
-            device_info.zigbee_joined = true;
             device_info.pan_id = esp_zb_get_pan_id();
             device_info.channel = esp_zb_get_current_channel();
             device_info.short_address = esp_zb_get_short_address();
+            link_sample_parent(NULL);
+            set_joined(true);
+            link_arm_check();
             
             ESP_LOGI(TAG, "PAN ID: 0x%04hx, Channel:%d, Short Address: 0x%04hx",
                      device_info.pan_id, device_info.channel, device_info.short_address);
-            ESP_LOGI(TAG, "✅ Device should now appear in Zigbee2MQTT!");
+            ESP_LOGI(TAG, "Device should now appear in Zigbee2MQTT!");
             ESP_LOGI(TAG, "Zigbee reporting ready");
         } else {
-            ESP_LOGW(TAG, "❌ Network steering FAILED: %s", esp_err_to_name(err_status));
+            ESP_LOGW(TAG, "Network steering FAILED: %s", esp_err_to_name(err_status));
             ESP_LOGI(TAG, "Retrying in 3 seconds... (Make sure Permit Join is enabled in Z2M!)");
             esp_zb_scheduler_alarm(bdb_start_top_level_commissioning_wrapper, ESP_ZB_BDB_MODE_NETWORK_STEERING, 3000);
         }
         break;
         
+    case ESP_ZB_ZDO_SIGNAL_LEAVE: {
+        esp_zb_zdo_signal_leave_params_t *leave_params = esp_zb_app_signal_get_params(p_sg_p);
+        set_joined(false);
+        esp_zb_scheduler_alarm_cancel(link_check_step, 0);
+        esp_zb_scheduler_alarm_cancel(drain_step, 0);
+        drain_active = false;
+        tx_pending = 0;  // Frames of the old link get no send status
+        if (leave_params && leave_params->leave_type == ESP_ZB_NWK_LEAVE_TYPE_REJOIN) {
+            // The stack rejoins by itself and signals DEVICE_REBOOT
+            ESP_LOGI(TAG, "Left network to rejoin - scanning for a parent");
+            break;
+        }
+        ESP_LOGW(TAG, "Left network - restarting network steering");
+        esp_zb_scheduler_alarm(bdb_start_top_level_commissioning_wrapper, ESP_ZB_BDB_MODE_NETWORK_STEERING, 1000);
+        break;
+    }
+        
+    case ESP_ZB_COMMON_SIGNAL_CAN_SLEEP:
+        // Only raised when stack sleep is enabled (zigbee_core_set_sleep_enabled)
+        esp_zb_sleep_now();
+        break;
+        
     default:
         ESP_LOGI(TAG, "ZDO signal: %s (0x%x), status: %s", esp_zb_zdo_signal_to_string(sig_type), sig_type,
                  esp_err_to_name(err_status));
@@ -507,16 +801,42 @@ esp_err_t zigbee_core_register_action_handler(esp_err_t (*handler_func)(esp_zb_c
     return ESP_OK;
 }
 
-esp_err_t zigbee_core_update_soil_moisture(float moisture_percent)
+esp_err_t zigbee_core_register_join_callback(void (*callback)(bool joined))
 {
-    // Zigbee Humidity is in 0.01% units (0-10000)
-    // Convert from 0-100% to 0-10000
-    uint16_t humidity_value = (uint16_t)(moisture_percent * 100.0f);
-    
-    // Clamp to valid range
-    if (humidity_value > 10000) {
-        humidity_value = 10000;
+    join_callback = callback;
+    return ESP_OK;
+}
+
+esp_err_t zigbee_core_register_history_pull_callback(void (*callback)(void))
+{
+    history_pull_callback = callback;
+    return ESP_OK;
+}
+
+esp_err_t zigbee_core_register_radio_idle_callback(void (*callback)(void))
+{
+    radio_idle_callback = callback;
+    return ESP_OK;
+}
+
+uint32_t zigbee_core_stack_unused(void)
+{
+    if (zigbee_main_loop_task_handle == NULL) {
+        return 0;
     }
+    return (uint32_t)uxTaskGetStackHighWaterMark(zigbee_main_loop_task_handle);
+}
+
+esp_err_t zigbee_core_set_sleep_enabled(bool enabled)
+{
+    sleep_enabled = enabled;
+    return ESP_OK;
+}
+
+esp_err_t zigbee_core_update_soil_moisture(uint16_t moisture_centi)
+{
+    // Zigbee Humidity is in 0.01% units (0-10000)
+    uint16_t humidity_value = (moisture_centi > 10000) ? 10000 : moisture_centi;
     
     // Update Zigbee attribute (Humidity cluster ID 0x0405, Measured Value attribute 0x0000)
     esp_zb_zcl_status_t status = esp_zb_zcl_set_attribute_val(
@@ -529,7 +849,7 @@ esp_err_t zigbee_core_update_soil_moisture(float moisture_percent)
     );
     
     if (status == ESP_ZB_ZCL_STATUS_SUCCESS) {
-        ESP_LOGI(TAG, "Soil moisture updated: %.1f%% (ZB value: %d)", moisture_percent, humidity_value);
+        ESP_LOGI(TAG, "Soil moisture updated: " SENSOR_CENTI_FMT "%%", SENSOR_CENTI_ARGS(humidity_value));
         return ESP_OK;
     } else {
         ESP_LOGW(TAG, "Failed to update soil moisture: %d", status);
@@ -537,11 +857,10 @@ esp_err_t zigbee_core_update_soil_moisture(float moisture_percent)
     }
 }
 
-esp_err_t zigbee_core_update_soil_temperature(float temp_celsius)
+esp_err_t zigbee_core_update_soil_temperature(int16_t temp_centi)
 {
     // Zigbee Temperature is in 0.01°C units
-    // Convert from Celsius to int16_t (centidegrees)
-    int16_t temp_value = (int16_t)(temp_celsius * 100.0f);
+    int16_t temp_value = temp_centi;
     
     // Update Zigbee attribute (Temperature cluster ID 0x0402, Measured Value attribute 0x0000)
     esp_zb_zcl_status_t status = esp_zb_zcl_set_attribute_val(
@@ -554,7 +873,7 @@ esp_err_t zigbee_core_update_soil_temperature(float temp_celsius)
     );
     
     if (status == ESP_ZB_ZCL_STATUS_SUCCESS) {
-        ESP_LOGI(TAG, "Soil temperature updated: %.1f°C (ZB value: %d)", temp_celsius, temp_value);
+        ESP_LOGI(TAG, "Soil temperature updated: " SENSOR_CENTI_FMT "°C", SENSOR_CENTI_ARGS(temp_value));
         return ESP_OK;
     } else {
         ESP_LOGW(TAG, "Failed to update soil temperature: %d", status);
@@ -562,6 +881,269 @@ esp_err_t zigbee_core_update_soil_temperature(float temp_celsius)
     }
 }
 
+esp_err_t zigbee_core_update_ambient(int16_t temp_centi, uint16_t humidity_centi)
+{
+    uint16_t humidity_value = (humidity_centi > 10000) ? 10000 : humidity_centi;
+    esp_zb_zcl_status_t temp_status = esp_zb_zcl_set_attribute_val(
+        HA_ESP_AMBIENT_ENDPOINT,
+        ESP_ZB_ZCL_CLUSTER_ID_TEMP_MEASUREMENT,
+        ESP_ZB_ZCL_CLUSTER_SERVER_ROLE,
+        ESP_ZB_ZCL_ATTR_TEMP_MEASUREMENT_VALUE_ID,
+        &temp_centi,
+        false
+    );
+    esp_zb_zcl_status_t humidity_status = esp_zb_zcl_set_attribute_val(
+        HA_ESP_AMBIENT_ENDPOINT,
+        ESP_ZB_ZCL_CLUSTER_ID_REL_HUMIDITY_MEASUREMENT,
+        ESP_ZB_ZCL_CLUSTER_SERVER_ROLE,
+        ESP_ZB_ZCL_ATTR_REL_HUMIDITY_MEASUREMENT_VALUE_ID,
+        &humidity_value,
+        false
+    );
+    
+    if (temp_status == ESP_ZB_ZCL_STATUS_SUCCESS && humidity_status == ESP_ZB_ZCL_STATUS_SUCCESS) {
+        ESP_LOGI(TAG, "Ambient updated: " SENSOR_CENTI_FMT "°C, " SENSOR_CENTI_FMT "%%",
+                 SENSOR_CENTI_ARGS(temp_centi), SENSOR_CENTI_ARGS(humidity_value));
+        return ESP_OK;
+    }
+    ESP_LOGW(TAG, "Failed to update ambient: %d/%d", temp_status, humidity_status);
+    return ESP_FAIL;
+}
+
+esp_err_t zigbee_core_update_power_source(bool external_power)
+{
+    uint8_t power_source = external_power ? ESP_ZB_ZCL_BASIC_POWER_SOURCE_DC_SOURCE :
+                                            ESP_ZB_ZCL_BASIC_POWER_SOURCE_BATTERY;
+    
+    esp_zb_lock_acquire(portMAX_DELAY);
+    esp_zb_zcl_status_t status = esp_zb_zcl_set_attribute_val(
+        HA_ESP_SENSOR_ENDPOINT,
+        ESP_ZB_ZCL_CLUSTER_ID_BASIC,
+        ESP_ZB_ZCL_CLUSTER_SERVER_ROLE,
+        ESP_ZB_ZCL_ATTR_BASIC_POWER_SOURCE_ID,
+        &power_source,
+        false
+    );
+    esp_zb_lock_release();
+    
+    if (status != ESP_ZB_ZCL_STATUS_SUCCESS) {
+        ESP_LOGW(TAG, "Failed to update power source: %d", status);
+        return ESP_FAIL;
+    }
+    
+    ESP_LOGI(TAG, "Power source updated: %s", external_power ? "DC/USB" : "Battery");
+    
+    if (!device_info.zigbee_joined) {
+        return ESP_OK;  // Value is picked up by the next read after join
+    }
+    if (power_source == rtc_reported_power_source) {
+        return ESP_OK;  // Coordinator already has it
+    }
+    esp_err_t ret = zigbee_core_report_attribute(ESP_ZB_ZCL_CLUSTER_ID_BASIC, ESP_ZB_ZCL_ATTR_BASIC_POWER_SOURCE_ID);
+    if (ret == ESP_OK) {
+        rtc_reported_power_source = power_source;
+    }
+    return ret;
+}
+
+esp_err_t zigbee_core_report_attribute(uint16_t cluster_id, uint16_t attr_id)
+{
+    // Report straight to the coordinator (short address 0x0000)
+    esp_zb_zcl_report_attr_cmd_t report_cmd = {
+        .zcl_basic_cmd = {
+            .dst_addr_u.addr_short = 0x0000,
+            .dst_endpoint = HA_ESP_SENSOR_ENDPOINT,
+            .src_endpoint = HA_ESP_SENSOR_ENDPOINT,
+        },
+        .address_mode = ESP_ZB_APS_ADDR_MODE_16_ENDP_PRESENT,
+        .clusterID = cluster_id,
+        .direction = ESP_ZB_ZCL_CMD_DIRECTION_TO_CLI,
+        .attributeID = attr_id,
+    };
+    
+    // Delivery status arrives asynchronously via the command send status callback
+    esp_zb_lock_acquire(portMAX_DELAY);
+    esp_err_t ret = esp_zb_zcl_report_attr_cmd_req(&report_cmd);
+    if (ret == ESP_OK) {
+        tx_pending++;
+    }
+    esp_zb_lock_release();
+    
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Report of attribute 0x%04x/0x%04x not queued: %s", cluster_id, attr_id, esp_err_to_name(ret));
+        return ret;
+    }
+    ESP_LOGI(TAG, "Reported attribute 0x%04x/0x%04x to coordinator", cluster_id, attr_id);
+    return ESP_OK;
+}
+
+esp_err_t zigbee_core_update_window_stats(const uint8_t *record, size_t len)
+{
+    if (!record || len == 0 || len > SAMPLE_WINDOW_RECORD_LEN) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    // ZCL octet string: length byte followed by payload
+    uint8_t value[SAMPLE_WINDOW_RECORD_LEN + 1];
+    value[0] = (uint8_t)len;
+    memcpy(&value[1], record, len);
+    
+    esp_zb_lock_acquire(portMAX_DELAY);
+    esp_zb_zcl_status_t status = esp_zb_zcl_set_attribute_val(
+        HA_ESP_SENSOR_ENDPOINT,
+        GLYPH_CLUSTER_ID_STATS,
+        ESP_ZB_ZCL_CLUSTER_SERVER_ROLE,
+        GLYPH_ATTR_WINDOW_STATS_ID,
+        value,
+        false
+    );
+    esp_zb_lock_release();
+    
+    if (status != ESP_ZB_ZCL_STATUS_SUCCESS) {
+        ESP_LOGW(TAG, "Failed to update window statistics: %d", status);
+        return ESP_FAIL;
+    }
+    
+    return zigbee_core_report_attribute(GLYPH_CLUSTER_ID_STATS, GLYPH_ATTR_WINDOW_STATS_ID);
+}
+
+esp_err_t zigbee_core_update_watering_events(uint32_t event_count)
+{
+    esp_zb_lock_acquire(portMAX_DELAY);
+    esp_zb_zcl_status_t status = esp_zb_zcl_set_attribute_val(
+        HA_ESP_SENSOR_ENDPOINT,
+        GLYPH_CLUSTER_ID_STATS,
+        ESP_ZB_ZCL_CLUSTER_SERVER_ROLE,
+        GLYPH_ATTR_WATERING_EVENTS_ID,
+        &event_count,
+        false
+    );
+    esp_zb_lock_release();
+    
+    if (status != ESP_ZB_ZCL_STATUS_SUCCESS) {
+        ESP_LOGW(TAG, "Failed to update watering events: %d", status);
+        return ESP_FAIL;
+    }
+    
+    return zigbee_core_report_attribute(GLYPH_CLUSTER_ID_STATS, GLYPH_ATTR_WATERING_EVENTS_ID);
+}
+
+esp_err_t zigbee_core_update_freshness(const uint8_t *record, size_t len)
+{
+    if (!record || len == 0 || len > FRESHNESS_RECORD_LEN) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    // ZCL octet string: length byte followed by payload
+    uint8_t value[FRESHNESS_RECORD_LEN + 1];
+    value[0] = (uint8_t)len;
+    memcpy(&value[1], record, len);
+    
+    esp_zb_lock_acquire(portMAX_DELAY);
+    esp_zb_zcl_status_t status = esp_zb_zcl_set_attribute_val(
+        HA_ESP_SENSOR_ENDPOINT,
+        GLYPH_CLUSTER_ID_STATS,
+        ESP_ZB_ZCL_CLUSTER_SERVER_ROLE,
+        GLYPH_ATTR_FRESHNESS_ID,
+        value,
+        false
+    );
+    esp_zb_lock_release();
+    
+    if (status != ESP_ZB_ZCL_STATUS_SUCCESS) {
+        ESP_LOGW(TAG, "Failed to update freshness: %d", status);
+        return ESP_FAIL;
+    }
+    
+    return zigbee_core_report_attribute(GLYPH_CLUSTER_ID_STATS, GLYPH_ATTR_FRESHNESS_ID);
+}
+
+esp_err_t zigbee_core_handle_history_request(const uint8_t *value)
+{
+    if (!value || value[0] < 8) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    const uint8_t *p = &value[1];
+    uint32_t start_age = p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+    uint32_t end_age = p[4] | (p[5] << 8) | (p[6] << 16) | ((uint32_t)p[7] << 24);
+    uint32_t now = deep_sleep_get_time_sec();
+    
+    if (end_age > start_age) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    uint32_t start_time = (start_age < now) ? now - start_age : 0;
+    uint32_t end_time = (end_age < now) ? now - end_age : 0;
+    
+    esp_err_t ret = history_log_query(start_time, end_time, &history_cursor);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "History query failed: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    
+    ESP_LOGI(TAG, "History pull: ages %" PRIu32 "..%" PRIu32 " s", start_age, end_age);
+    bool was_active = history_pull_active;
+    history_pull_active = true;
+    history_chunk_seq = 0;
+    history_pending_count = 0;
+    if (!was_active) {
+        esp_zb_scheduler_alarm(history_pull_step, 0, HISTORY_PULL_INTERVAL_MS);
+    }
+    return ESP_OK;
+}
+
+bool zigbee_core_history_pull_active(void)
+{
+    return history_pull_active;
+}
+
+esp_err_t zigbee_core_handle_config_write(uint16_t attr_id, const void *value)
+{
+    if (!value) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    esp_err_t ret;
+    perf_param_t param;
+    uint32_t v;
+    if (attr_id == GLYPH_ATTR_CFG_GP_UPLINK_ID) {
+        ret = gp_uplink_request(*(const bool *)value, device_info.channel);
+    } else if (config_attr_value(attr_id, value, &param, &v)) {
+        ret = perf_config_set(param, v);
+    } else {
+        return ESP_ERR_NOT_FOUND;
+    }
+    
+    // Attributes show the active set: restore them once the write completed
+    esp_zb_scheduler_alarm(config_sync_step, 0, 10);
+    return ret;
+}
+
+esp_err_t zigbee_core_sync_config(void)
+{
+    esp_zb_lock_acquire(portMAX_DELAY);
+    for (size_t i = 0; i < CONFIG_ATTR_COUNT; i++) {
+        uint32_t value = perf_config_get(config_attrs[i].param);
+        esp_zb_zcl_set_attribute_val(HA_ESP_SENSOR_ENDPOINT, GLYPH_CLUSTER_ID_CONFIG,
+            ESP_ZB_ZCL_CLUSTER_SERVER_ROLE, config_attrs[i].attr_id, &value, false);
+    }
+    bool pending = perf_config_pending();
+    esp_zb_zcl_set_attribute_val(HA_ESP_SENSOR_ENDPOINT, GLYPH_CLUSTER_ID_CONFIG,
+        ESP_ZB_ZCL_CLUSTER_SERVER_ROLE, GLYPH_ATTR_CFG_PENDING_ID, &pending, false);
+    bool gp_uplink = gp_uplink_requested();
+    esp_zb_zcl_set_attribute_val(HA_ESP_SENSOR_ENDPOINT, GLYPH_CLUSTER_ID_CONFIG,
+        ESP_ZB_ZCL_CLUSTER_SERVER_ROLE, GLYPH_ATTR_CFG_GP_UPLINK_ID, &gp_uplink, false);
+    uint32_t gp_src_id = gp_uplink_src_id();
+    esp_zb_zcl_set_attribute_val(HA_ESP_SENSOR_ENDPOINT, GLYPH_CLUSTER_ID_CONFIG,
+        ESP_ZB_ZCL_CLUSTER_SERVER_ROLE, GLYPH_ATTR_CFG_GP_SRC_ID, &gp_src_id, false);
+    esp_zb_lock_release();
+    
+    if (!device_info.zigbee_joined) {
+        return ESP_OK;
+    }
+    return zigbee_core_report_attribute(GLYPH_CLUSTER_ID_CONFIG, GLYPH_ATTR_CFG_PENDING_ID);
+}
+
 // ============================================================================
 // PRIVATE FUNCTIONS
 // ============================================================================
@@ -581,3 +1163,298 @@ static void bdb_start_top_level_commissioning_wrapper(uint8_t mode_mask)
     esp_zb_bdb_start_top_level_commissioning(mode_mask);
 }
 
+/**
+ * @brief Restore configuration attributes after a write (Zigbee scheduler context)
+ */
+static void config_sync_step(uint8_t param)
+{
+    (void)param;
+    zigbee_core_sync_config();
+}
+
+/**
+ * @brief Parameter and value of a configuration attribute
+ * @return false if the attribute has no parameter (pending flag, uplink)
+ */
+static bool config_attr_value(uint16_t attr_id, const void *value, perf_param_t *param, uint32_t *v)
+{
+    for (size_t i = 0; i < CONFIG_ATTR_COUNT; i++) {
+        if (config_attrs[i].attr_id != attr_id) {
+            continue;
+        }
+        *param = config_attrs[i].param;
+        switch (perf_config_describe(*param)->size) {
+            case 1:  *v = *(const uint8_t *)value; break;
+            case 2:  *v = *(const uint16_t *)value; break;
+            default: *v = *(const uint32_t *)value; break;
+        }
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Configuration cluster pre-write check (stack context)
+ *
+ * A value perf_config would not stage fails here, so the stack answers
+ * the write with INVALID_VALUE instead of SUCCESS.
+ */
+static esp_err_t config_check_value(uint16_t attr_id, uint8_t endpoint, uint8_t *value)
+{
+    perf_param_t param;
+    uint32_t v;
+    if (endpoint != HA_ESP_SENSOR_ENDPOINT || !value || !config_attr_value(attr_id, value, &param, &v)) {
+        return ESP_OK;
+    }
+    return perf_config_check(param, v);
+}
+
+/**
+ * @brief ZCL type of a configuration attribute (unsigned, sized per parameter)
+ */
+static uint8_t config_attr_type(perf_param_t param)
+{
+    switch (perf_config_describe(param)->size) {
+        case 1:  return ESP_ZB_ZCL_ATTR_TYPE_U8;
+        case 2:  return ESP_ZB_ZCL_ATTR_TYPE_U16;
+        default: return ESP_ZB_ZCL_ATTR_TYPE_U32;
+    }
+}
+
+/**
+ * @brief Send the next historyChunk (Zigbee scheduler context)
+ */
+static void history_pull_step(uint8_t param)
+{
+    (void)param;
+    history_pending_count += history_log_read(&history_cursor, &history_pending[history_pending_count],
+                                              HISTORY_PULL_CHUNK_RECORDS - history_pending_count);
+    uint32_t now = deep_sleep_get_time_sec();
+    
+    // ZCL octet string: length byte followed by chunk payload
+    uint8_t value[GLYPH_HISTORY_CHUNK_MAX_LEN + 1];
+    uint8_t *chunk = &value[1];
+    size_t len = 3;
+    size_t count = 0;
+    if (history_pending_count > 0) {
+        // Oldest reading by age, the rest as records while they fit
+        history_reading_t first = history_pending[0];
+        first.time = (now > first.time) ? now - first.time : 0;
+        reading_codec_put_absolute(&first, &chunk[len]);
+        len += READING_CODEC_ABSOLUTE_LEN;
+        
+        reading_codec_state_t state;
+        reading_codec_begin(&state, &history_pending[0]);
+        for (count = 1; count < history_pending_count; count++) {
+            const history_reading_t *r = &history_pending[count];
+            size_t n = 0;
+            if (r->time >= state.last.time) {  // A clock reset starts the next chunk
+                n = reading_codec_encode(&state, r, &chunk[len], GLYPH_HISTORY_CHUNK_MAX_LEN - len);
+            }
+            if (n == 0) {
+                break;
+            }
+            len += n;
+        }
+        history_pending_count -= count;
+        memmove(history_pending, &history_pending[count], history_pending_count * sizeof(history_reading_t));
+    }
+    chunk[0] = GLYPH_HISTORY_CHUNK_VERSION;
+    chunk[1] = history_chunk_seq++;
+    chunk[2] = (uint8_t)count;
+    value[0] = (uint8_t)len;
+    
+    esp_zb_lock_acquire(portMAX_DELAY);
+    esp_zb_zcl_set_attribute_val(HA_ESP_SENSOR_ENDPOINT, GLYPH_CLUSTER_ID_STATS,
+        ESP_ZB_ZCL_CLUSTER_SERVER_ROLE, GLYPH_ATTR_HISTORY_CHUNK_ID, value, false);
+    esp_zb_lock_release();
+    zigbee_core_report_attribute(GLYPH_CLUSTER_ID_STATS, GLYPH_ATTR_HISTORY_CHUNK_ID);
+    
+    if (count == 0) {
+        ESP_LOGI(TAG, "History pull complete (%u chunks)", history_chunk_seq);
+        history_pull_active = false;
+        if (history_pull_callback) {
+            history_pull_callback();
+        }
+        return;
+    }
+    esp_zb_scheduler_alarm(history_pull_step, 0, HISTORY_PULL_INTERVAL_MS);
+}
+
+/**
+ * @brief Feed the parent's LQI/RSSI from the neighbor table to the link state
+ * @param candidate_lqi Set to the best LQI of another router heard (NULL to skip)
+ */
+static void link_sample_parent(uint8_t *candidate_lqi)
+{
+    esp_zb_nwk_info_iterator_t it = ESP_ZB_NWK_INFO_ITERATOR_INIT;
+    esp_zb_nwk_neighbor_info_t nbr;
+    uint8_t best_other = 0;
+    
+    while (esp_zb_nwk_get_next_neighbor(&it, &nbr) == ESP_OK) {
+        if (nbr.relationship == ESP_ZB_NWK_RELATIONSHIP_PARENT) {
+            link_quality_parent_sample(&rtc_link, nbr.short_addr, nbr.lqi, nbr.rssi);
+            ESP_LOGI(TAG, "Parent 0x%04hx: LQI %u, RSSI %d dBm, %u.%02u tx per delivered frame",
+                     nbr.short_addr, nbr.lqi, nbr.rssi,
+                     link_quality_cost(&rtc_link) / 100, link_quality_cost(&rtc_link) % 100);
+        } else if (nbr.device_type != ESP_ZB_DEVICE_TYPE_ED && nbr.lqi > best_other) {
+            best_other = nbr.lqi;
+        }
+    }
+    if (candidate_lqi) {
+        *candidate_lqi = best_other;
+    }
+}
+
+/**
+ * @brief Check the parent link and start a reselection if it pays off
+ * @return true if a leave-with-rejoin was requested
+ */
+static bool link_check(void)
+{
+    uint8_t candidate_lqi = 0;
+    link_sample_parent(&candidate_lqi);
+    if (!link_quality_check(&rtc_link, candidate_lqi)) {
+        return false;
+    }
+    
+    ESP_LOGW(TAG, "Parent 0x%04hx costs %u.%02u tx per delivered frame - rejoining for a better parent",
+             rtc_link.parent, rtc_link.cost_before / 100, rtc_link.cost_before % 100);
+    esp_zb_zdo_mgmt_leave_req_param_t leave_req = {
+        .dst_nwk_addr = esp_zb_get_short_address(),
+        .rejoin = 1,
+    };
+    esp_zb_get_long_address(leave_req.device_address);
+    link_rejoining = true;
+    esp_zb_zdo_device_leave_req(&leave_req, NULL, NULL);
+    return true;
+}
+
+/**
+ * @brief Periodic parent link check while awake (Zigbee scheduler context)
+ */
+static void link_check_step(uint8_t param)
+{
+    (void)param;
+    if (!device_info.zigbee_joined || link_check()) {
+        return;  // A rejoin re-arms the check once it completes
+    }
+    link_arm_check();
+}
+
+static void link_arm_check(void)
+{
+    esp_zb_scheduler_alarm_cancel(link_check_step, 0);
+    esp_zb_scheduler_alarm(link_check_step, 0, LINK_CHECK_INTERVAL_MS);
+}
+
+/**
+ * @brief Delivery outcome of a sent command (Zigbee stack context)
+ *
+ * Once the last pending send is confirmed, drain the parent's queue:
+ * replies to what was just sent wait there until the device polls.
+ */
+static void send_status_cb(esp_zb_zcl_command_send_status_message_t message)
+{
+    link_quality_tx_result(&rtc_link, message.status == ESP_OK);
+    if (tx_pending > 0 && --tx_pending == 0 && device_info.zigbee_joined) {
+        drain_start();
+    }
+}
+
+/**
+ * @brief Count every incoming APS data frame (Zigbee stack context)
+ *
+ * ZCL, ZDO and any other profile the parent buffered: each one is a frame
+ * a poll released. APS acks to our own sends need no count, tx_pending
+ * only reaches 0 once they arrived.
+ *
+ * @return false: the stack still handles the frame
+ */
+static bool aps_data_cb(esp_zb_apsde_data_ind_t ind)
+{
+    (void)ind;
+    rx_frames++;
+    return false;
+}
+
+/**
+ * @brief Start polling the parent until its queue for us is empty
+ */
+static void drain_start(void)
+{
+    if (drain_active) {
+        return;
+    }
+    drain_active = true;
+    drain_polls = 0;
+    drain_start_ms = deep_sleep_get_time_ms();
+    drain_rx_start = rx_frames;
+    drain_poll();
+}
+
+static void drain_poll(void)
+{
+    drain_polls++;
+    drain_rx_at_poll = rx_frames;
+    zb_zdo_pim_start_turbo_poll_packets(1);
+    esp_zb_scheduler_alarm(drain_step, 0, ZIGBEE_DRAIN_POLL_WAIT_MS);
+}
+
+/**
+ * @brief Poll again while the last poll brought a frame (Zigbee scheduler context)
+ *
+ * The ESP-Zigbee API does not expose the frame-pending bit of the poll
+ * ack, so an APS data frame arriving after the poll stands for it and an
+ * empty poll means the queue is empty. Frames without APS data for this
+ * device (MAC or NWK commands) are not counted and end the drain early;
+ * the next scheduled poll picks up anything behind them.
+ */
+static void drain_step(uint8_t param)
+{
+    (void)param;
+    if (!drain_active) {
+        return;
+    }
+    if (rx_frames != drain_rx_at_poll && drain_polls < ZIGBEE_DRAIN_MAX_POLLS) {
+        drain_poll();
+        return;
+    }
+    drain_finish();
+}
+
+static void drain_finish(void)
+{
+    uint32_t frames = rx_frames - drain_rx_start;
+    uint32_t elapsed_ms = deep_sleep_get_time_ms() - drain_start_ms;
+    drain_active = false;
+    
+    rtc_drain.drains++;
+    rtc_drain.frames += frames;
+    rtc_drain.polls += drain_polls;
+    rtc_drain.time_ms += elapsed_ms;
+    rtc_drain.last_frames = (uint16_t)frames;
+    rtc_drain.last_polls = drain_polls;
+    rtc_drain.last_ms = elapsed_ms;
+    ESP_LOGI(TAG, "Parent queue drained: %" PRIu32 " frames in %u polls, %" PRIu32 " ms", frames, drain_polls, elapsed_ms);
+    
+    if (tx_pending == 0 && radio_idle_callback) {
+        radio_idle_callback();
+    }
+}
+
+static void set_joined(bool joined)
+{
+    bool changed = (device_info.zigbee_joined != joined);
+    device_info.zigbee_joined = joined;
+    
+    // Fresh (re)join: the parent may hold frames queued while we slept
+    if (changed && joined) {
+        drain_start();
+    }
+    
+    if (changed && join_callback) {
+        join_callback(joined);
+    }
+}
+
@@ -11,16 +11,70 @@
 #define ZIGBEE_CORE_H
 
 #include <stdbool.h>
+#include <stddef.h>
 #include "esp_err.h"
 #include "esp_zigbee_core.h"
 #include "esp_zigbee_cluster.h"
 #include "esp_zigbee_endpoint.h"
 #include "system_config.h"
+#include "link_quality.h"
+
+// ============================================================================
+// MANUFACTURER-SPECIFIC CLUSTERS (FloraTech)
+// ============================================================================
+
+// Statistics/diagnostics cluster (server role on HA_ESP_SENSOR_ENDPOINT)
+#define GLYPH_CLUSTER_ID_STATS           0xFC00
+#define GLYPH_ATTR_WINDOW_STATS_ID       0x0000   // Octet string: sample_window record
+#define GLYPH_ATTR_WATERING_EVENTS_ID    0x0001   // U32: watering events since power-on
+#define GLYPH_ATTR_HISTORY_REQUEST_ID    0x0002   // Octet string (write): start_age u32, end_age u32
+#define GLYPH_ATTR_HISTORY_CHUNK_ID      0x0003   // Octet string (report): history readings
+#define GLYPH_ATTR_FRESHNESS_ID          0x0004   // Octet string: freshness record of the last report
+
+// historyChunk payload: version u8, chunk u8, count u8, then the oldest reading
+// (age_sec u32, moisture u16 0.01 %, temperature i16 0.01 °C) and count - 1
+// reading_codec.h records in time order; count 0 = end of range
+#define GLYPH_HISTORY_CHUNK_VERSION      2
+#define GLYPH_HISTORY_CHUNK_MAX_LEN      51       // Frame size of the 6 fixed readings of v1
+
+// Runtime configuration cluster (server role on HA_ESP_SENSOR_ENDPOINT)
+// Writes are bounds-checked, persisted in NVS and take effect at the next
+// wake; reads always return the active values (see perf_config.h)
+#define GLYPH_CLUSTER_ID_CONFIG              0xFC01
+#define GLYPH_ATTR_CFG_BATT_SAMPLE_INTERVAL_ID   0x0000   // U32: battery sample interval (s)
+#define GLYPH_ATTR_CFG_BATT_REPORT_INTERVAL_ID   0x0001   // U32: battery heartbeat (s)
+#define GLYPH_ATTR_CFG_BATT_NUM_SAMPLES_ID       0x0002   // U8: samples averaged per reading
+#define GLYPH_ATTR_CFG_BATT_SAMPLE_SPACING_ID    0x0003   // U16: spacing between samples (ms)
+#define GLYPH_ATTR_CFG_BATT_MOISTURE_DB_ID       0x0004   // U16: moisture deadband (0.01 %)
+#define GLYPH_ATTR_CFG_BATT_TEMP_DB_ID           0x0005   // U16: temperature deadband (0.01 °C)
+#define GLYPH_ATTR_CFG_USB_SAMPLE_INTERVAL_ID    0x0010   // U32: USB sample interval (s)
+#define GLYPH_ATTR_CFG_USB_REPORT_INTERVAL_ID    0x0011   // U32: USB heartbeat (s)
+#define GLYPH_ATTR_CFG_USB_NUM_SAMPLES_ID        0x0012   // U8: samples averaged per reading
+#define GLYPH_ATTR_CFG_USB_SAMPLE_SPACING_ID     0x0013   // U16: spacing between samples (ms)
+#define GLYPH_ATTR_CFG_USB_MOISTURE_DB_ID        0x0014   // U16: moisture deadband (0.01 %)
+#define GLYPH_ATTR_CFG_USB_TEMP_DB_ID            0x0015   // U16: temperature deadband (0.01 °C)
+#define GLYPH_ATTR_CFG_SENSE_INTERVAL_ID         0x0020   // U32: watering sense wake interval (s)
+#define GLYPH_ATTR_CFG_GP_UPLINK_ID              0x0030   // Bool: commissioning-free uplink (pairs at the next wake)
+#define GLYPH_ATTR_CFG_GP_SRC_ID                 0x0031   // U32: uplink SrcID once commissioned (0 = none)
+#define GLYPH_ATTR_CFG_PENDING_ID                0x00F0   // Bool: written values not active yet
 
 // ============================================================================
 // ZIGBEE CORE PUBLIC INTERFACE
 // ============================================================================
 
+/**
+ * @brief Parent queue drains (kept across deep sleep)
+ */
+typedef struct {
+    uint32_t drains;             // Drains run since power-on
+    uint32_t frames;             // Frames pulled from the parent's queue
+    uint32_t polls;              // Data requests sent
+    uint32_t time_ms;            // Radio time spent draining
+    uint16_t last_frames;        // Frames of the last drain
+    uint16_t last_polls;         // Data requests of the last drain
+    uint32_t last_ms;            // Duration of the last drain
+} zigbee_drain_stats_t;
+
 /**
  * @brief Zigbee device configuration structure
  */
@@ -75,6 +129,30 @@ esp_err_t zigbee_core_stop_main_loop_task(void);
  */
 bool zigbee_core_get_device_info(zigbee_device_info_t *info);
 
+/**
+ * @brief Get the parent link state (LQI/RSSI averages, failures, reselections)
+ * @param link Pointer to store the link state
+ * @return true if a parent has been sampled, false otherwise
+ */
+bool zigbee_core_get_link_quality(link_quality_t *link);
+
+/**
+ * @brief Get the parent queue drain statistics
+ * @param stats Pointer to store the statistics
+ * @return true if at least one drain has finished, false otherwise
+ */
+bool zigbee_core_get_drain_stats(zigbee_drain_stats_t *stats);
+
+/**
+ * @brief Check whether the radio has nothing left to do
+ *
+ * Idle means every report got its send status and the parent's queue
+ * was drained after the last of them.
+ *
+ * @return true if idle, false while sends or a drain are in flight
+ */
+bool zigbee_core_radio_idle(void);
+
 /**
  * @brief Check if Zigbee network is joined
  * @return true if joined, false otherwise
@@ -122,19 +200,174 @@ void zigbee_core_app_signal_handler(esp_zb_app_signal_t *signal_struct);
  */
 esp_err_t zigbee_core_register_action_handler(esp_err_t (*handler_func)(esp_zb_core_action_callback_id_t, const void *));
 
+/**
+ * @brief Register callback for Zigbee join state changes
+ * 
+ * Called from the Zigbee task context whenever the device joins,
+ * rejoins or leaves the network. Keep the callback short.
+ * 
+ * @param callback Function receiving the new join state (NULL to clear)
+ * @return ESP_OK on success
+ */
+esp_err_t zigbee_core_register_join_callback(void (*callback)(bool joined));
+
+/**
+ * @brief Register callback for the end of a history pull
+ * 
+ * Called from the Zigbee task context after the last historyChunk was
+ * queued. Keep the callback short.
+ * 
+ * @param callback Function to call (NULL to clear)
+ * @return ESP_OK on success
+ */
+esp_err_t zigbee_core_register_history_pull_callback(void (*callback)(void));
+
+/**
+ * @brief Register a callback for the radio going idle
+ *
+ * Called from the Zigbee stack context each time the last pending send
+ * is confirmed and the drain that follows finds the parent's queue
+ * empty (see zigbee_core_radio_idle).
+ *
+ * @param callback Function to call (NULL to clear)
+ * @return ESP_OK on success
+ */
+esp_err_t zigbee_core_register_radio_idle_callback(void (*callback)(void));
+
+/**
+ * @brief Smallest amount of Zigbee task stack left unused so far
+ * @return Bytes never used (0 if the main loop task is not running)
+ */
+uint32_t zigbee_core_stack_unused(void);
+
+/**
+ * @brief Enable Zigbee stack sleep (light sleep between radio events)
+ * 
+ * Must be called before zigbee_core_init(). Requires
+ * CONFIG_IEEE802154_SLEEP_ENABLE and an esp_pm light-sleep configuration.
+ * 
+ * @param enabled true to let the stack sleep when idle
+ * @return ESP_OK on success
+ */
+esp_err_t zigbee_core_set_sleep_enabled(bool enabled);
+
 /**
  * @brief Update soil moisture attribute
- * @param moisture_percent Moisture percentage (0-100%)
+ * @param moisture_centi Moisture in 0.01 % (0-10000, the ZCL encoding)
  * @return ESP_OK on success, error code otherwise
  */
-esp_err_t zigbee_core_update_soil_moisture(float moisture_percent);
+esp_err_t zigbee_core_update_soil_moisture(uint16_t moisture_centi);
 
 /**
  * @brief Update soil temperature attribute
- * @param temp_celsius Temperature in Celsius
+ * @param temp_centi Temperature in 0.01 °C (the ZCL encoding)
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t zigbee_core_update_soil_temperature(int16_t temp_centi);
+
+/**
+ * @brief Update the ambient endpoint's temperature and humidity attributes
+ * @param temp_centi Air temperature in 0.01 °C
+ * @param humidity_centi Relative humidity in 0.01 % (0-10000)
+ * @return ESP_OK on success, ESP_FAIL without the ambient endpoint
+ */
+esp_err_t zigbee_core_update_ambient(int16_t temp_centi, uint16_t humidity_centi);
+
+/**
+ * @brief Update Basic cluster power source attribute, report it when changed
+ *
+ * The last reported source is kept in RTC memory, so an unchanged source
+ * costs no frame on later wakes; the first report after power-on always goes.
+ * @param external_power true = DC/USB source, false = battery
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t zigbee_core_update_power_source(bool external_power);
+
+/**
+ * @brief Send an immediate attribute report to the coordinator
+ * 
+ * Bypasses the reporting configuration so that event-driven values
+ * (e.g. a power source change) reach the coordinator without delay.
+ * 
+ * @param cluster_id Cluster identifier (server role)
+ * @param attr_id Attribute identifier
+ * @return ESP_OK once the report is queued (delivery is confirmed later
+ *         through the send status), the stack's error if it was not
+ */
+esp_err_t zigbee_core_report_attribute(uint16_t cluster_id, uint16_t attr_id);
+
+/**
+ * @brief Update windowed statistics attribute and report it
+ * @param record Encoded sample_window record
+ * @param len Record length in bytes
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t zigbee_core_update_window_stats(const uint8_t *record, size_t len);
+
+/**
+ * @brief Update watering event counter and report it immediately
+ * @param event_count Watering events detected since power-on
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t zigbee_core_update_watering_events(uint32_t event_count);
+
+/**
+ * @brief Update the freshness attribute and report it
+ * 
+ * Send right after the reading it describes, so the coordinator receives
+ * it with the values it timestamps.
+ * 
+ * @param record Encoded freshness record
+ * @param len Record length in bytes
  * @return ESP_OK on success, error code otherwise
  */
-esp_err_t zigbee_core_update_soil_temperature(float temp_celsius);
+esp_err_t zigbee_core_update_freshness(const uint8_t *record, size_t len);
+
+/**
+ * @brief Start streaming a history range to the coordinator
+ * 
+ * Called from the attribute handler when historyRequest is written.
+ * Readings are sent as a series of historyChunk reports from the Zigbee
+ * scheduler, terminated by an empty chunk. Ages are relative to the
+ * device clock at the time each chunk is sent.
+ * 
+ * @param value ZCL octet string (length byte + start_age u32 + end_age u32)
+ * @return ESP_OK if the pull was started, error code otherwise
+ */
+esp_err_t zigbee_core_handle_history_request(const uint8_t *value);
+
+/**
+ * @brief Stage a configuration attribute write
+ * 
+ * Called from the attribute handler when a GLYPH_CLUSTER_ID_CONFIG
+ * attribute is written. Values perf_config_check() rejects are refused
+ * with INVALID_VALUE before the write (the cluster's check_value
+ * handler); here the value is validated again and persisted; the
+ * attributes are then restored to the active values and the pending
+ * flag is reported. A gpUplink write pairs or unpairs the
+ * commissioning-free uplink (gp_uplink.h) on the current channel.
+ * 
+ * @param attr_id Written attribute
+ * @param value Attribute value (U8/U16/U32/Bool as per the attribute)
+ * @return ESP_OK if staged, ESP_ERR_INVALID_ARG if rejected,
+ *         ESP_ERR_NOT_FOUND for an attribute that is not writable
+ */
+esp_err_t zigbee_core_handle_config_write(uint16_t attr_id, const void *value);
+
+/**
+ * @brief Refresh configuration attributes from the active values
+ * 
+ * Call after perf_config_apply_pending() changed the active set.
+ * 
+ * @return ESP_OK on success
+ */
+esp_err_t zigbee_core_sync_config(void);
+
+/**
+ * @brief Check if a history pull is in progress
+ * @return true while chunks remain to be sent
+ */
+bool zigbee_core_history_pull_active(void);
 
 #endif // ZIGBEE_CORE_H
 
@@ -0,0 +1,133 @@
+#!/usr/bin/env python3
+"""
+Glyph C6 Monitor - binlog decoder
+
+Renders deferred binary log records (main/binlog.h) back to text using the
+format and tag strings stored in the application ELF. Lines that are not
+binlog records are passed through unchanged, so a whole serial capture can
+be piped through:
+
+    idf.py monitor | tools/binlog_decode.py build/glyph_c6_monitor.elf
+    tools/binlog_decode.py build/glyph_c6_monitor.elf capture.log
+
+Requires pyelftools (installed with the ESP-IDF Python environment).
+"""
+
+import argparse
+import hashlib
+import re
+import struct
+import sys
+
+from elftools.elf.elffile import ELFFile
+
+LEVELS = {1: 'E', 2: 'W', 3: 'I', 4: 'D'}
+COLORS = {'E': '\033[0;31m', 'W': '\033[0;33m', 'I': '\033[0;32m', 'D': ''}
+
+# printf conversion: flags, width, precision, length, conversion
+SPEC_RE = re.compile(r'%([-+ #0]*)(\d*)(?:\.(\d+))?(hh|h|ll|l|z|j|t)?([diuxXofFeEgGcsp%])')
+
+
+class ElfStrings:
+    """Reads NUL-terminated strings from loadable ELF sections by address."""
+
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            self.sha256 = hashlib.sha256(f.read()).hexdigest()
+        with open(path, 'rb') as f:
+            elf = ELFFile(f)
+            self.sections = []
+            for section in elf.iter_sections():
+                if section['sh_addr'] and section['sh_type'] == 'SHT_PROGBITS':
+                    self.sections.append((section['sh_addr'], section.data()))
+
+    def string(self, addr):
+        for base, data in self.sections:
+            if base <= addr < base + len(data):
+                end = data.find(b'\0', addr - base)
+                return data[addr - base:end].decode('utf-8', errors='replace')
+        return None
+
+
+def render(fmt, args, strings):
+    """Apply a C format string to raw 32-bit argument words."""
+    out = []
+    pos = 0
+    arg_iter = iter(args)
+    for m in SPEC_RE.finditer(fmt):
+        out.append(fmt[pos:m.start()])
+        pos = m.end()
+        flags, width, precision, _, conv = m.groups()
+        if conv == '%':
+            out.append('%')
+            continue
+        word = next(arg_iter, 0)
+        spec = '%' + flags + width + ('.' + precision if precision is not None else '')
+        if conv in 'fFeEgG':
+            value = struct.unpack('<f', struct.pack('<I', word))[0]
+        elif conv in 'di':
+            value = struct.unpack('<i', struct.pack('<I', word))[0]
+            conv = 'd'
+        elif conv == 's':
+            value = strings.string(word)
+            if value is None:
+                value = '<str@0x%08x>' % word
+        elif conv == 'c':
+            value = chr(word & 0xFF)
+        elif conv == 'p':
+            value, conv = word, 'x'
+            spec = '0x' + spec
+        else:  # u, x, X, o
+            value = word
+            conv = 'd' if conv == 'u' else conv
+        out.append((spec + conv) % value)
+    out.append(fmt[pos:])
+    return ''.join(out)
+
+
+def decode_record(words, strings, color):
+    fmt = strings.string(words[0]) or '<fmt@0x%08x>' % words[0]
+    tag = strings.string(words[1]) or '?'
+    meta = words[2]
+    level = LEVELS.get(meta >> 28, '?')
+    nargs = (meta >> 24) & 0x0F
+    timestamp = meta & 0x00FFFFFF
+    text = '%s (%d) %s: %s' % (level, timestamp, tag, render(fmt, words[3:3 + nargs], strings))
+    if color and COLORS.get(level):
+        text = COLORS[level] + text + '\033[0m'
+    return text
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode binlog records from a serial capture')
+    parser.add_argument('elf', help='Application ELF matching the running firmware')
+    parser.add_argument('log', nargs='?', help='Serial capture (default: stdin)')
+    parser.add_argument('--color', action='store_true', help='Color output like ESP_LOGx')
+    args = parser.parse_args()
+
+    strings = ElfStrings(args.elf)
+    source = open(args.log, 'r', errors='replace') if args.log else sys.stdin
+
+    for line in source:
+        stripped = line.strip()
+        if stripped.startswith('BLOG_ELF '):
+            sha = stripped.split()[1]
+            if not strings.sha256.startswith(sha):
+                print('binlog: ELF mismatch (device %s, file %s) - output may be wrong'
+                      % (sha, strings.sha256[:8]), file=sys.stderr)
+            continue
+        if stripped.startswith('BLOG_DROPPED '):
+            print('binlog: %s records overwritten before dump' % stripped.split()[1])
+            continue
+        if stripped.startswith('BLOG '):
+            try:
+                words = [int(w, 16) for w in stripped.split()[1:]]
+                print(decode_record(words, strings, args.color))
+            except (ValueError, IndexError):
+                print(line, end='')
+            continue
+        print(line, end='')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,323 @@
+#!/usr/bin/env python3
+"""
+Glyph C6 Monitor - image size report and budget check
+
+Attributes every input section of a GNU ld map file to its component (the
+static library it came from, e.g. main, zboss_stack.ed, newlib's c) and to
+a symbol, sums them per memory region, and checks the totals against a
+budget file. Run after every firmware build (--warn-only unless
+CONFIG_GLYPH_SIZE_BUDGET is set), or by hand:
+
+    tools/size_report.py build/glyph_c6_monitor.map --budget size_budget.csv
+    tools/size_report.py build/glyph_c6_monitor.map --max main:flash=96K
+    tools/size_report.py build/glyph_c6_monitor.map --budget size_budget.csv \\
+        --update-budget --headroom 10
+
+Regions: text (flash code), rodata (flash constants and strings), iram
+(code run from RAM), data (initialised RAM) and bss (zeroed RAM); flash is
+what the image carries (text + rodata + iram + data), ram is data + bss.
+Exits 1 when a budget is exceeded, 2 on bad arguments or an unreadable map.
+"""
+
+import argparse
+import math
+import os
+import re
+import sys
+from collections import defaultdict
+
+REGIONS = ('text', 'rodata', 'iram', 'data', 'bss')
+DERIVED = {
+    'flash': ('text', 'rodata', 'iram', 'data'),
+    'ram': ('data', 'bss'),
+}
+ALL_REGIONS = REGIONS + tuple(DERIVED)
+
+# Output section -> region, first match wins. ESP-IDF names first, then the
+# generic ELF names of a host link; None = not part of the image or RAM.
+SECTION_RULES = [
+    ('.flash.rodata_noload', None),
+    ('.flash_rodata_dummy', None),
+    ('.dram0.heap_start', None),
+    ('.flash.text', 'text'),
+    ('.flash.appdesc', 'rodata'),
+    ('.flash.rodata', 'rodata'),
+    ('.flash.tdata', 'rodata'),
+    ('.flash.tbss', 'bss'),
+    ('.iram0.bss', 'bss'),
+    ('.iram0.', 'iram'),
+    ('.rtc.text', 'iram'),
+    ('.rtc.force_fast', 'iram'),
+    ('.rtc.bss', 'bss'),
+    ('.rtc_noinit', 'bss'),
+    ('.rtc.', 'data'),
+    ('.dram0.bss', 'bss'),
+    ('.dram0.data', 'data'),
+    ('.noinit', 'bss'),
+    ('.text', 'text'),
+    ('.init', 'text'),
+    ('.fini', 'text'),
+    ('.plt', 'text'),
+    ('.rodata', 'rodata'),
+    ('.srodata', 'rodata'),
+    ('.eh_frame', 'rodata'),
+    ('.gcc_except_table', 'rodata'),
+    ('.tbss', 'bss'),
+    ('.bss', 'bss'),
+    ('.sbss', 'bss'),
+    ('.tdata', 'data'),
+    ('.data', 'data'),
+    ('.sdata', 'data'),
+    ('.init_array', 'data'),
+    ('.fini_array', 'data'),
+    ('.got', 'data'),
+]
+
+# Input section prefixes that -ffunction-sections/-fdata-sections put in
+# front of the symbol name
+SYMBOL_PREFIXES = ('.literal.', '.text.', '.rodata.', '.srodata.', '.data.', '.sdata.',
+                   '.bss.', '.sbss.', '.iram1.', '.dram1.', '.rtc.text.', '.rtc.data.',
+                   '.rtc.bss.')
+
+OUTPUT_SECTION_RE = re.compile(r'^(\S+)(?:\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+))?\s*$')
+INPUT_SECTION_RE = re.compile(r'^ (\S+)(?:\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(.+))?\s*$')
+CONTINUATION_RE = re.compile(r'^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(.+?)\s*$')
+SYMBOL_RE = re.compile(r'^\s+0x[0-9a-fA-F]+\s+([A-Za-z_.$][\w.$@]*)\s*$')
+SIZE_RE = re.compile(r'^(0x[0-9a-fA-F]+|\d+)([KM]?)$')
+
+
+def section_region(name):
+    for prefix, region in SECTION_RULES:
+        if name == prefix or name.startswith(prefix):
+            return region
+    # Renamed RAM sections (the host build's fw_data/fw_bss, rtc_noinit)
+    if name.endswith('bss') or name.endswith('noinit'):
+        return 'bss'
+    if name.endswith('data'):
+        return 'data'
+    return None
+
+
+def component_of(path):
+    """lib<name>.a(obj) -> name; a plain object file -> (objects)."""
+    m = re.match(r'^(.*?)\(([^()]*)\)$', path)
+    if not m:
+        return '(objects)', os.path.basename(path)
+    lib = os.path.basename(m.group(1))
+    if lib.startswith('lib'):
+        lib = lib[3:]
+    if lib.endswith('.a'):
+        lib = lib[:-2]
+    return lib, m.group(2)
+
+
+def symbol_of(section, obj, symbols):
+    for prefix in SYMBOL_PREFIXES:
+        if section.startswith(prefix):
+            rest = section[len(prefix):]
+            # .rodata.str1.4, .iram1.12: merged strings or numbered sections
+            if rest and not re.match(r'^(str\d|cst\d|\d+$)', rest):
+                return rest
+            break
+    if len(symbols) == 1:
+        return symbols[0]
+    return '%s(%s)' % (obj, section)
+
+
+class MapFile:
+    """Per-component and per-symbol sizes from a GNU ld map file."""
+
+    def __init__(self, path):
+        self.components = defaultdict(lambda: dict.fromkeys(REGIONS, 0))
+        self.symbols = defaultdict(int)   # (component, symbol, region) -> bytes
+        with open(path, 'r', errors='replace') as f:
+            lines = f.read().splitlines()
+        try:
+            start = lines.index('Linker script and memory map')
+        except ValueError:
+            raise ValueError('%s: no "Linker script and memory map" section' % path)
+        self._parse(lines[start + 1:])
+
+    def _parse(self, lines):
+        region = None
+        pending = None        # input section name waiting for its address line
+        current = None        # [component, obj, section, size, symbols]
+        for line in lines:
+            if not line.strip():
+                continue
+            if not line.startswith(' '):
+                self._flush(current, region)
+                current = pending = None
+                m = OUTPUT_SECTION_RE.match(line)
+                region = section_region(m.group(1)) if m else None
+                continue
+            if region is None:
+                continue
+            if pending is not None:
+                m = CONTINUATION_RE.match(line)
+                if m:
+                    self._flush(current, region)
+                    current = self._input(pending, m.group(2), m.group(3))
+                    pending = None
+                    continue
+                pending = None
+            m = SYMBOL_RE.match(line)
+            if m and current is not None:
+                current[4].append(m.group(1))
+                continue
+            m = INPUT_SECTION_RE.match(line)
+            if m and not m.group(1).startswith('*'):
+                self._flush(current, region)
+                current = None
+                if m.group(2) is None:
+                    pending = m.group(1)
+                else:
+                    current = self._input(m.group(1), m.group(3), m.group(4))
+                continue
+            if line.lstrip().startswith('*fill*'):
+                continue
+        self._flush(current, region)
+
+    @staticmethod
+    def _input(section, size, path):
+        component, obj = component_of(path.strip())
+        return [component, obj, section, int(size, 16), []]
+
+    def _flush(self, current, region):
+        if current is None or region is None or current[3] == 0:
+            return
+        component, obj, section, size, symbols = current
+        self.components[component][region] += size
+        self.symbols[(component, symbol_of(section, obj, symbols), region)] += size
+
+    def total(self, component, region):
+        """Bytes of one region (or derived region) for a component or '*'."""
+        parts = DERIVED.get(region, (region,))
+        rows = self.components.values() if component == '*' else [self.components.get(component)]
+        return sum(row[p] for row in rows if row for p in parts)
+
+
+def parse_size(text):
+    m = SIZE_RE.match(text.strip())
+    if not m:
+        raise ValueError('bad size "%s"' % text)
+    value = int(m.group(1), 0)
+    return value * {'': 1, 'K': 1024, 'M': 1024 * 1024}[m.group(2)]
+
+
+def read_budget(path):
+    """Budget rows: (component, region, limit) from a partitions.csv-like file."""
+    rows = []
+    with open(path, 'r') as f:
+        for number, line in enumerate(f, 1):
+            line = line.split('#', 1)[0].strip()
+            if not line:
+                continue
+            fields = [x.strip() for x in line.split(',')]
+            if len(fields) != 3 or fields[1] not in ALL_REGIONS:
+                raise ValueError('%s:%d: expected "component, region, limit"' % (path, number))
+            rows.append((fields[0], fields[1], parse_size(fields[2])))
+    return rows
+
+
+def parse_max(text):
+    m = re.match(r'^([^:=]+):(\w+)=(\S+)$', text)
+    if not m or m.group(2) not in ALL_REGIONS:
+        raise argparse.ArgumentTypeError('expected COMPONENT:REGION=SIZE, got "%s"' % text)
+    return (m.group(1), m.group(2), parse_size(m.group(3)))
+
+
+def update_budget(path, sizes, headroom):
+    """Rewrite the limits of a budget file to measured size + headroom %."""
+    row_re = re.compile(r'^(\s*([^,#]+?)\s*,\s*(\w+)\s*,\s*)(\S+)(.*)$', re.S)
+    out = []
+    with open(path, 'r') as f:
+        for line in f:
+            m = row_re.match(line)
+            if m and (m.group(2), m.group(3)) in sizes:
+                limit = sizes[(m.group(2), m.group(3))] * (100 + headroom) / 100.0
+                line = '%s%dK%s' % (m.group(1), max(1, int(math.ceil(limit / 1024.0))), m.group(5))
+            out.append(line)
+    with open(path, 'w') as f:
+        f.writelines(out)
+
+
+def format_report(mapfile, top):
+    lines = []
+    header = '%-24s' % 'Component' + ''.join('%10s' % r for r in ('flash',) + REGIONS)
+    lines.append(header)
+    lines.append('-' * len(header))
+    order = sorted(mapfile.components, key=lambda c: -mapfile.total(c, 'flash'))
+    for component in order:
+        lines.append('%-24s' % component[:24] +
+                     ''.join('%10d' % mapfile.total(component, r) for r in ('flash',) + REGIONS))
+    lines.append('-' * len(header))
+    lines.append('%-24s' % 'Total' + ''.join('%10d' % mapfile.total('*', r) for r in ('flash',) + REGIONS))
+    if top:
+        lines.append('')
+        lines.append('Largest symbols')
+        lines.append('%-8s %-7s %-20s %s' % ('Bytes', 'Region', 'Component', 'Symbol'))
+        biggest = sorted(mapfile.symbols.items(), key=lambda kv: -kv[1])[:top]
+        for (component, symbol, region), size in biggest:
+            lines.append('%-8d %-7s %-20s %s' % (size, region, component[:20], symbol))
+    return lines
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Per-component image size report and budget check')
+    parser.add_argument('map', help='GNU ld map file of the application link')
+    parser.add_argument('--budget', help='Budget file (component, region, limit per line)')
+    parser.add_argument('--max', action='append', type=parse_max, default=[],
+                        metavar='COMPONENT:REGION=SIZE', help='Extra limit; * is the whole image')
+    parser.add_argument('--top', type=int, default=25, help='Largest symbols to list (default 25)')
+    parser.add_argument('--output', help='Also write the report to this file')
+    parser.add_argument('--warn-only', action='store_true', help='Report budget overruns, exit 0')
+    parser.add_argument('--update-budget', action='store_true',
+                        help='Set the budget file limits to the measured sizes plus --headroom')
+    parser.add_argument('--headroom', type=int, default=10, help='Percent over measured (default 10)')
+    args = parser.parse_args()
+
+    try:
+        mapfile = MapFile(args.map)
+        budget = read_budget(args.budget) if args.budget else []
+    except (OSError, ValueError) as e:
+        print('size_report: %s' % e, file=sys.stderr)
+        return 2
+    budget += args.max
+
+    lines = format_report(mapfile, args.top)
+    over = []
+    if budget:
+        lines.append('')
+        lines.append('Budget')
+        for component, region, limit in budget:
+            used = mapfile.total(component, region)
+            status = 'OVER' if used > limit else 'ok'
+            if used > limit:
+                over.append(component)
+            lines.append('%-4s %-20s %-6s %9d / %-9d %5.1f%%' % (
+                status, component[:20], region, used, limit, 100.0 * used / limit if limit else 0))
+
+    text = '\n'.join(lines) + '\n'
+    sys.stdout.write(text)
+    if args.output:
+        with open(args.output, 'w') as f:
+            f.write(text)
+
+    if args.update_budget:
+        if not args.budget:
+            parser.error('--update-budget needs --budget')
+        sizes = {(c, r): mapfile.total(c, r) for c, r, _ in read_budget(args.budget)}
+        update_budget(args.budget, sizes, args.headroom)
+        print('size_report: %s updated with %d%% headroom' % (args.budget, args.headroom))
+        return 0
+
+    if over:
+        print('size_report: over budget: %s%s' % (', '.join(sorted(set(over))),
+              ' (warning only)' if args.warn_only else ''), file=sys.stderr)
+        return 0 if args.warn_only else 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -15,9 +15,222 @@ const fz = require('zigbee-herdsman-converters/converters/fromZigbee');
 const tz = require('zigbee-herdsman-converters/converters/toZigbee');
 const exposes = require('zigbee-herdsman-converters/lib/exposes');
 const reporting = require('zigbee-herdsman-converters/lib/reporting');
+const {Zcl} = require('zigbee-herdsman');
 const e = exposes.presets;
 const ea = exposes.access;
 
+// Air temperature/humidity endpoint (HA_ESP_AMBIENT_ENDPOINT in main/system_config.h)
+const AMBIENT_ENDPOINT = 2;
+
+// FloraTech manufacturer-specific statistics cluster (see main/zigbee_core.h)
+const GLYPH_MANUFACTURER_CODE = 0x1234;
+const glyphStatsCluster = {
+    ID: 0xFC00,
+    manufacturerCode: GLYPH_MANUFACTURER_CODE,
+    attributes: {
+        windowStats: {ID: 0x0000, type: Zcl.DataType.OCTET_STR},
+        wateringEvents: {ID: 0x0001, type: Zcl.DataType.UINT32},
+        historyRequest: {ID: 0x0002, type: Zcl.DataType.OCTET_STR},
+        historyChunk: {ID: 0x0003, type: Zcl.DataType.OCTET_STR},
+        freshness: {ID: 0x0004, type: Zcl.DataType.OCTET_STR},
+    },
+    commands: {},
+    commandsResponse: {},
+};
+
+// Runtime tuning (0xFC01): written values are bounds-checked on the device,
+// persisted and applied at its next wake; reads return the active values.
+// scale converts the exposed unit to the on-air integer (deadbands in 0.01).
+const glyphConfigSettings = [
+    {key: 'battery_sample_interval', attr: 'battSampleInterval', ID: 0x0000, type: Zcl.DataType.UINT32, unit: 's', min: 10, max: 86400, scale: 1, description: 'Battery: time between readings'},
+    {key: 'battery_report_interval', attr: 'battReportInterval', ID: 0x0001, type: Zcl.DataType.UINT32, unit: 's', min: 10, max: 259200, scale: 1, description: 'Battery: heartbeat (max time between reports)'},
+    {key: 'battery_num_samples', attr: 'battNumSamples', ID: 0x0002, type: Zcl.DataType.UINT8, unit: undefined, min: 1, max: 16, scale: 1, description: 'Battery: samples averaged per reading'},
+    {key: 'battery_sample_spacing', attr: 'battSampleSpacing', ID: 0x0003, type: Zcl.DataType.UINT16, unit: 'ms', min: 100, max: 60000, scale: 1, description: 'Battery: delay between averaged samples'},
+    {key: 'battery_moisture_deadband', attr: 'battMoistureDeadband', ID: 0x0004, type: Zcl.DataType.UINT16, unit: '%', min: 0, max: 100, scale: 100, description: 'Battery: moisture change that triggers an early report'},
+    {key: 'battery_temperature_deadband', attr: 'battTempDeadband', ID: 0x0005, type: Zcl.DataType.UINT16, unit: '°C', min: 0, max: 100, scale: 100, description: 'Battery: temperature change that triggers an early report'},
+    {key: 'usb_sample_interval', attr: 'usbSampleInterval', ID: 0x0010, type: Zcl.DataType.UINT32, unit: 's', min: 5, max: 86400, scale: 1, description: 'USB power: time between readings'},
+    {key: 'usb_report_interval', attr: 'usbReportInterval', ID: 0x0011, type: Zcl.DataType.UINT32, unit: 's', min: 5, max: 259200, scale: 1, description: 'USB power: heartbeat (max time between reports)'},
+    {key: 'usb_num_samples', attr: 'usbNumSamples', ID: 0x0012, type: Zcl.DataType.UINT8, unit: undefined, min: 1, max: 16, scale: 1, description: 'USB power: samples averaged per reading'},
+    {key: 'usb_sample_spacing', attr: 'usbSampleSpacing', ID: 0x0013, type: Zcl.DataType.UINT16, unit: 'ms', min: 100, max: 60000, scale: 1, description: 'USB power: delay between averaged samples'},
+    {key: 'usb_moisture_deadband', attr: 'usbMoistureDeadband', ID: 0x0014, type: Zcl.DataType.UINT16, unit: '%', min: 0, max: 100, scale: 100, description: 'USB power: moisture change that triggers an early report'},
+    {key: 'usb_temperature_deadband', attr: 'usbTempDeadband', ID: 0x0015, type: Zcl.DataType.UINT16, unit: '°C', min: 0, max: 100, scale: 100, description: 'USB power: temperature change that triggers an early report'},
+    {key: 'sense_interval', attr: 'senseInterval', ID: 0x0020, type: Zcl.DataType.UINT32, unit: 's', min: 30, max: 86400, scale: 1, description: 'Battery: radio-free watering check interval'},
+];
+
+const glyphConfigCluster = {
+    ID: 0xFC01,
+    manufacturerCode: GLYPH_MANUFACTURER_CODE,
+    attributes: {
+        ...Object.fromEntries(glyphConfigSettings.map((s) => [s.attr, {ID: s.ID, type: s.type}])),
+        gpUplink: {ID: 0x0030, type: Zcl.DataType.BOOLEAN},
+        gpSrcId: {ID: 0x0031, type: Zcl.DataType.UINT32},
+        configPending: {ID: 0x00F0, type: Zcl.DataType.BOOLEAN},
+    },
+    commands: {},
+    commandsResponse: {},
+};
+
+const addGlyphClusters = (device) => {
+    device.addCustomCluster('manuSpecificGlyphStats', glyphStatsCluster);
+    device.addCustomCluster('manuSpecificGlyphConfig', glyphConfigCluster);
+};
+
+/**
+ * Decode a sample_window record (main/sample_window.h, 21 bytes little-endian)
+ */
+const decodeWindowStats = (data) => {
+    const buf = Buffer.from(data);
+    if (buf.length < 21 || buf.readUInt8(0) !== 1) {
+        return {};
+    }
+    return {
+        window_samples: buf.readUInt16LE(1),
+        window_minutes: buf.readUInt16LE(3),
+        soil_moisture_min: buf.readUInt16LE(5) / 100.0,
+        soil_moisture_max: buf.readUInt16LE(7) / 100.0,
+        soil_moisture_mean: buf.readUInt16LE(9) / 100.0,
+        soil_moisture_stddev: buf.readUInt16LE(11) / 100.0,
+        soil_temperature_min: buf.readInt16LE(13) / 100.0,
+        soil_temperature_max: buf.readInt16LE(15) / 100.0,
+        soil_temperature_mean: buf.readInt16LE(17) / 100.0,
+        soil_temperature_stddev: buf.readUInt16LE(19) / 100.0,
+    };
+};
+
+/**
+ * Decode count - 1 reading records (main/reading_codec.h) after an absolute
+ * reading; times are seconds since the first reading
+ */
+const decodeReadings = (buf, offset, count, first) => {
+    const readings = [first];
+    let {time, moisture, temperature} = first;
+    let interval = 0;
+    const varint = () => {
+        let value = 0;
+        for (let shift = 0; shift < 35 && offset < buf.length; shift += 7) {
+            const byte = buf[offset++];
+            value += (byte & 0x7F) * 2 ** shift;
+            if (!(byte & 0x80)) {
+                return value;
+            }
+        }
+        return undefined;
+    };
+    const unzigzag = (z) => (z >>> 1) ^ -(z & 1);
+    while (readings.length < count && offset < buf.length) {
+        const tag = buf[offset++];
+        let zTime = 0;
+        let zMoisture = (tag >> 3) & 0x0F;
+        let zTemp = tag & 0x07;
+        if (zTemp > 6 ||
+            ((tag & 0x80) && (zTime = varint()) === undefined) ||
+            (zMoisture === 15 && (zMoisture = varint()) === undefined) ||
+            (zTemp === 6 && (zTemp = varint()) === undefined)) {
+            break;
+        }
+        interval = (interval + unzigzag(zTime)) >>> 0;
+        time = (time + interval) >>> 0;
+        moisture = (moisture + unzigzag(zMoisture)) & 0xFFFF;
+        temperature = ((temperature + unzigzag(zTemp)) << 16) >> 16;
+        readings.push({time, moisture, temperature});
+    }
+    return readings;
+};
+
+/**
+ * Decode a historyChunk (main/zigbee_core.h): version u8, chunk u8, count u8,
+ * then the oldest reading (age_sec u32, moisture u16, temperature i16,
+ * little-endian) and count - 1 reading records. Version 1 (older firmware)
+ * sends count fixed 8-byte readings.
+ */
+const decodeHistoryChunk = (data) => {
+    const buf = Buffer.from(data);
+    const version = buf.length >= 3 ? buf.readUInt8(0) : 0;
+    if (version !== 1 && version !== 2) {
+        return {};
+    }
+    const count = buf.readUInt8(2);
+    if (count === 0) {
+        return {history_complete: true};
+    }
+    const now = Date.now();
+    const at = (age) => new Date(now - age * 1000).toISOString();
+    const readings = [];
+    if (version === 1) {
+        for (let i = 0; i < count && 3 + (i + 1) * 8 <= buf.length; i++) {
+            const offset = 3 + i * 8;
+            readings.push({
+                time: at(buf.readUInt32LE(offset)),
+                soil_moisture: buf.readUInt16LE(offset + 4) / 100.0,
+                soil_temperature: buf.readInt16LE(offset + 6) / 100.0,
+            });
+        }
+    } else if (buf.length >= 11) {
+        const age = buf.readUInt32LE(3);
+        const first = {time: 0, moisture: buf.readUInt16LE(7), temperature: buf.readInt16LE(9)};
+        for (const r of decodeReadings(buf, 11, count, first)) {
+            readings.push({
+                time: at(age - r.time),
+                soil_moisture: r.moisture / 100.0,
+                soil_temperature: r.temperature / 100.0,
+            });
+        }
+    }
+    return {history: readings, history_chunk: buf.readUInt8(1), history_complete: false};
+};
+
+// Reading age buckets of the freshness record (main/freshness.h)
+const FRESHNESS_BUCKETS = ['<1s', '<5s', '<15s', '<30s', '<1min', '<5min', '<30min', '>=30min'];
+
+// Device send time vs. receive time: the smallest offset of recent reports
+// is taken as zero transit. The device clock is not synced and drifts, so
+// only reports of the last few minutes count, and a jump beyond
+// FRESHNESS_MAX_TRANSIT_MS (reboot, clock wrap) starts over.
+const FRESHNESS_WINDOW_MS = 15 * 60 * 1000;
+const FRESHNESS_MAX_TRANSIT_MS = 60 * 1000;
+const transitState = new WeakMap();
+
+/**
+ * Estimate the transit time (ms) of a report sent at device time sentMs
+ */
+const estimateTransit = (device, sentMs, receivedMs) => {
+    const offset = receivedMs - sentMs;
+    let recent = (transitState.get(device) || []).filter((o) => receivedMs - o.receivedMs < FRESHNESS_WINDOW_MS);
+    let base = Math.min(offset, ...recent.map((o) => o.offset));
+    if (offset - base > FRESHNESS_MAX_TRANSIT_MS) {
+        recent = [];
+        base = offset;
+    }
+    recent.push({offset, receivedMs});
+    transitState.set(device, recent);
+    return offset - base;
+};
+
+/**
+ * Decode a freshness record (main/freshness.h): version u8, acquired_ms u32,
+ * sent_ms u32 (device RTC, wrapping), bucket count u8, counts u16 x count
+ */
+const decodeFreshness = (data, device) => {
+    const buf = Buffer.from(data);
+    if (buf.length < 9 || buf.readUInt8(0) !== 1) {
+        return {};
+    }
+    const acquiredMs = buf.readUInt32LE(1);
+    const sentMs = buf.readUInt32LE(5);
+    const ageMs = (sentMs - acquiredMs) >>> 0;
+    const transitMs = estimateTransit(device, sentMs, Date.now());
+    const result = {
+        reading_age: ageMs / 1000,
+        sample_to_receive_latency: (ageMs + transitMs) / 1000,
+    };
+    const buckets = buf.length > 9 ? buf.readUInt8(9) : 0;
+    if (buckets === FRESHNESS_BUCKETS.length && buf.length >= 10 + buckets * 2) {
+        result.reading_age_histogram = Object.fromEntries(
+            FRESHNESS_BUCKETS.map((label, i) => [label, buf.readUInt16LE(10 + i * 2)]));
+    }
+    return result;
+};
+
 const definition = {
     zigbeeModel: ['PlantMonitor-C6'],
     model: 'PlantMonitor-C6',
@@ -38,6 +251,22 @@ const definition = {
             },
         },
         
+        // Power source (0x0000 Basic cluster) - reported by the device when it
+        // switches between USB (fresh profile) and battery (frugal profile)
+        {
+            cluster: 'genBasic',
+            type: ['attributeReport', 'readResponse'],
+            convert: (model, msg, publish, options, meta) => {
+                const result = {};
+                if (msg.data.powerSource !== undefined) {
+                    // 0x03 = Battery, 0x04 = DC source (USB)
+                    result.power_source = (msg.data.powerSource & 0x7F) === 0x04 ? 'usb' : 'battery';
+                    result.power_profile = result.power_source === 'usb' ? 'fresh' : 'frugal';
+                }
+                return result;
+            },
+        },
+        
         // Battery reports (0x0001 cluster) - if you add Power Config later
         {
             cluster: 'genPowerCfg',
@@ -61,13 +290,15 @@ const definition = {
             },
         },
         
-        // Soil Moisture as Humidity (0x0405 cluster)
+        // Soil Moisture as Humidity (0x0405 cluster); air humidity on endpoint 2
         {
             cluster: 'msRelativeHumidity',
             type: ['attributeReport', 'readResponse'],
             convert: (model, msg, publish, options, meta) => {
                 const result = {};
-                if (msg.data.measuredValue !== undefined) {
+                if (msg.data.measuredValue !== undefined && msg.endpoint.ID === AMBIENT_ENDPOINT) {
+                    result.ambient_humidity = msg.data.measuredValue / 100.0;
+                } else if (msg.data.measuredValue !== undefined) {
                     // Zigbee uses 0.01% units (0-10000), convert to 0-100%
                     result.soil_moisture = msg.data.measuredValue / 100.0;
                     result.humidity = result.soil_moisture;  // Also expose as humidity for compatibility
@@ -76,13 +307,15 @@ const definition = {
             },
         },
         
-        // Soil Temperature (0x0402 cluster)
+        // Soil Temperature (0x0402 cluster); air temperature on endpoint 2
         {
             cluster: 'msTemperatureMeasurement',
             type: ['attributeReport', 'readResponse'],
             convert: (model, msg, publish, options, meta) => {
                 const result = {};
-                if (msg.data.measuredValue !== undefined) {
+                if (msg.data.measuredValue !== undefined && msg.endpoint.ID === AMBIENT_ENDPOINT) {
+                    result.ambient_temperature = msg.data.measuredValue / 100.0;
+                } else if (msg.data.measuredValue !== undefined) {
                     // Zigbee uses 0.01°C units, convert to °C
                     result.soil_temperature = msg.data.measuredValue / 100.0;
                     result.temperature = result.soil_temperature;  // Also expose as temperature
@@ -90,9 +323,105 @@ const definition = {
                 return result;
             },
         },
+        
+        // Windowed statistics (0xFC00 manufacturer cluster) - one record per report interval
+        {
+            cluster: 'manuSpecificGlyphStats',
+            type: ['attributeReport', 'readResponse'],
+            convert: (model, msg, publish, options, meta) => {
+                const result = {};
+                if (msg.data.windowStats !== undefined) {
+                    Object.assign(result, decodeWindowStats(msg.data.windowStats));
+                }
+                if (msg.data.historyChunk !== undefined) {
+                    Object.assign(result, decodeHistoryChunk(msg.data.historyChunk));
+                }
+                if (msg.data.freshness !== undefined) {
+                    Object.assign(result, decodeFreshness(msg.data.freshness, meta.device));
+                }
+                if (msg.data.wateringEvents !== undefined) {
+                    result.watering_events = msg.data.wateringEvents;
+                    // Counter moved = a new watering event was just detected
+                    if (msg.type === 'attributeReport' && msg.data.wateringEvents > 0 &&
+                        msg.data.wateringEvents !== meta.state.watering_events) {
+                        result.last_watering = new Date().toISOString();
+                    }
+                }
+                return result;
+            },
+        },
+        
+        // Runtime tuning (0xFC01) - active values and pending flag
+        {
+            cluster: 'manuSpecificGlyphConfig',
+            type: ['attributeReport', 'readResponse'],
+            convert: (model, msg, publish, options, meta) => {
+                const result = {};
+                for (const setting of glyphConfigSettings) {
+                    if (msg.data[setting.attr] !== undefined) {
+                        result[setting.key] = msg.data[setting.attr] / setting.scale;
+                    }
+                }
+                if (msg.data.configPending !== undefined) {
+                    result.config_pending = !!msg.data.configPending;
+                }
+                if (msg.data.gpUplink !== undefined) {
+                    result.gp_uplink = !!msg.data.gpUplink;
+                }
+                if (msg.data.gpSrcId !== undefined) {
+                    result.gp_src_id = msg.data.gpSrcId;
+                }
+                return result;
+            },
+        },
     ],
     
     toZigbee: [
+        // Pull stored readings of the last N hours from flash history
+        {
+            key: ['history_request'],
+            convertSet: async (entity, key, value, meta) => {
+                addGlyphClusters(meta.device);
+                const startAge = Math.round(Number(value) * 3600);
+                const payload = Buffer.alloc(8);
+                payload.writeUInt32LE(startAge, 0);
+                payload.writeUInt32LE(0, 4);
+                await entity.write('manuSpecificGlyphStats', {historyRequest: payload});
+                return {state: {history_request: value}};
+            },
+        },
+        // Runtime tuning - staged on the device, active from its next wake
+        {
+            key: glyphConfigSettings.map((s) => s.key),
+            convertSet: async (entity, key, value, meta) => {
+                addGlyphClusters(meta.device);
+                const setting = glyphConfigSettings.find((s) => s.key === key);
+                const raw = Math.round(Number(value) * setting.scale);
+                await entity.write('manuSpecificGlyphConfig', {[setting.attr]: raw});
+                // Device answers with the still-active value and raises configPending
+                await entity.read('manuSpecificGlyphConfig', ['configPending']);
+            },
+            convertGet: async (entity, key, meta) => {
+                addGlyphClusters(meta.device);
+                const setting = glyphConfigSettings.find((s) => s.key === key);
+                await entity.read('manuSpecificGlyphConfig', [setting.attr]);
+            },
+        },
+        // Commissioning-free uplink: the device sends commissioning frames at
+        // its next wake, so put the Green Power sink in commissioning mode first
+        {
+            key: ['gp_uplink'],
+            convertSet: async (entity, key, value, meta) => {
+                addGlyphClusters(meta.device);
+                const enable = value === true || String(value).toUpperCase() === 'ON';
+                await entity.write('manuSpecificGlyphConfig', {gpUplink: enable ? 1 : 0});
+                return {state: {gp_uplink: enable}};
+            },
+            convertGet: async (entity, key, meta) => {
+                addGlyphClusters(meta.device);
+                await entity.read('manuSpecificGlyphConfig', ['gpUplink', 'gpSrcId']);
+            },
+        },
         // LED On/Off control using commands (not attribute writes)
         {
             key: ['state'],
@@ -122,10 +451,58 @@ const definition = {
         
         // Soil temperature
         e.temperature().withDescription('Soil temperature'),
+        
+        // Air around the plant (SHT4x builds, endpoint 2)
+        e.numeric('ambient_temperature', ea.STATE).withUnit('°C').withDescription('Air temperature'),
+        e.numeric('ambient_humidity', ea.STATE).withUnit('%').withDescription('Air relative humidity'),
+        
+        // Windowed statistics (since previous report)
+        e.numeric('window_samples', ea.STATE).withDescription('Samples aggregated in the last window'),
+        e.numeric('window_minutes', ea.STATE).withUnit('min').withDescription('Length of the last window'),
+        e.numeric('soil_moisture_min', ea.STATE).withUnit('%').withDescription('Minimum soil moisture in window'),
+        e.numeric('soil_moisture_max', ea.STATE).withUnit('%').withDescription('Maximum soil moisture in window'),
+        e.numeric('soil_moisture_mean', ea.STATE).withUnit('%').withDescription('Mean soil moisture in window'),
+        e.numeric('soil_moisture_stddev', ea.STATE).withUnit('%').withDescription('Soil moisture standard deviation in window'),
+        e.numeric('soil_temperature_min', ea.STATE).withUnit('°C').withDescription('Minimum soil temperature in window'),
+        e.numeric('soil_temperature_max', ea.STATE).withUnit('°C').withDescription('Maximum soil temperature in window'),
+        e.numeric('soil_temperature_mean', ea.STATE).withUnit('°C').withDescription('Mean soil temperature in window'),
+        e.numeric('soil_temperature_stddev', ea.STATE).withUnit('°C').withDescription('Soil temperature standard deviation in window'),
+        
+        // Reading freshness (published with each report; histogram since device power-on)
+        e.numeric('reading_age', ea.STATE).withUnit('s')
+            .withDescription('Time between taking the reading and sending it'),
+        e.numeric('sample_to_receive_latency', ea.STATE).withUnit('s')
+            .withDescription('Time between taking the reading and its arrival here'),
+        
+        // Flash history pull (results arrive as 'history' chunks)
+        e.numeric('history_request', ea.SET).withUnit('h').withValueMin(1).withValueMax(2160)
+            .withDescription('Pull stored readings of the last N hours (published as history chunks)'),
+        
+        // Watering detection
+        e.numeric('watering_events', ea.STATE).withDescription('Watering events detected since device power-on'),
+        e.text('last_watering', ea.STATE).withDescription('Time the last watering event was reported'),
+        
+        // Power policy
+        e.enum('power_source', ea.STATE, ['usb', 'battery']).withDescription('Detected power source'),
+        e.enum('power_profile', ea.STATE, ['fresh', 'frugal']).withDescription('Active operating profile (fresh on USB, frugal on battery)'),
+        
+        // Runtime tuning (applied at the device's next wake - write while it is awake)
+        ...glyphConfigSettings.map((s) => {
+            const setting = e.numeric(s.key, ea.ALL).withValueMin(s.min).withValueMax(s.max)
+                .withValueStep(1 / s.scale).withDescription(s.description).withCategory('config');
+            return s.unit ? setting.withUnit(s.unit) : setting;
+        }),
+        e.binary('config_pending', ea.STATE, true, false)
+            .withDescription('Written settings waiting for the next wake (stays on if the set is inconsistent)'),
+        e.binary('gp_uplink', ea.ALL, true, false).withCategory('config')
+            .withDescription('Send reports as Green Power frames between full wakes (sink must be in commissioning mode)'),
+        e.numeric('gp_src_id', ea.STATE)
+            .withDescription('Green Power SrcID of the uplink (0 until commissioned)'),
     ],
     
     // Configure binding and reporting
     configure: async (device, coordinatorEndpoint) => {
+        addGlyphClusters(device);
         const endpoint = device.getEndpoint(1);
         
         // Bind clusters
@@ -152,10 +529,28 @@ const definition = {
         }]);
         
         // Read initial states
+        await endpoint.read('genBasic', ['powerSource']);
         await endpoint.read('genOnOff', ['onOff']);
         await endpoint.read('genPowerCfg', ['batteryPercentageRemaining', 'batteryVoltage']);
         await endpoint.read('msRelativeHumidity', ['measuredValue']);
         await endpoint.read('msTemperatureMeasurement', ['measuredValue']);
+        await endpoint.read('manuSpecificGlyphConfig',
+            [...glyphConfigSettings.map((s) => s.attr), 'gpUplink', 'gpSrcId', 'configPending']);
+        
+        // Ambient sensor endpoint (firmware built with CONFIG_GLYPH_AMBIENT_SHT4X)
+        const ambient = device.getEndpoint(AMBIENT_ENDPOINT);
+        if (ambient) {
+            await reporting.bind(ambient, coordinatorEndpoint, ['msRelativeHumidity', 'msTemperatureMeasurement']);
+            await ambient.read('msRelativeHumidity', ['measuredValue']);
+            await ambient.read('msTemperatureMeasurement', ['measuredValue']);
+        }
+    },
+    
+    // Custom clusters are not persisted by herdsman - re-add them on every start
+    onEvent: async (type, data, device) => {
+        if (type === 'start' || type === 'deviceInterview') {
+            addGlyphClusters(device);
+        }
     },
     
     endpoint: (device) => {
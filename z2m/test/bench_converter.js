@@ -0,0 +1,191 @@
+/**
+ * Glyph C6 converter throughput benchmark (Node.js, no npm packages)
+ *
+ *     node bench_converter.js [--messages N] [--records R] [--min-rate MSG_PER_S]
+ *
+ * Pushes N historyChunk reports (R readings each, default the firmware's
+ * per-chunk cap HISTORY_PULL_CHUNK_RECORDS) and N windowStats reports through the
+ * converter's fromZigbee dispatch on the herdsman stand-in, as Zigbee2MQTT
+ * delivers them, and prints messages and readings per second. Every decoded
+ * reading is checked against what was encoded, so a faster but wrong
+ * decoder does not pass.
+ *
+ * Chunks are version 2 (main/reading_codec.h records), encoded here the
+ * way the firmware does; R up to 200 still fits a ZCL octet string (254
+ * bytes) with this curve. --min-rate fails the run when history chunks
+ * convert slower than MSG_PER_S.
+ */
+
+'use strict';
+
+const fs = require('fs');
+const path = require('path');
+const {loadConverter, Coordinator} = require('./herdsman');
+
+const FIRMWARE_CONFIG = path.join(__dirname, '..', '..', 'main', 'system_config.h');
+const DEFAULT_MESSAGES = 100000;
+const WARMUP_MESSAGES = 20000;
+const MAX_RECORDS = 200;
+const MAX_CHUNK_LEN = 254;
+
+const usage = () => {
+    console.error('usage: bench_converter.js [--messages N] [--records R] [--min-rate MSG_PER_S]');
+    process.exit(2);
+};
+
+const firmwareChunkRecords = () => {
+    const m = fs.readFileSync(FIRMWARE_CONFIG, 'utf8').match(/^#define\s+HISTORY_PULL_CHUNK_RECORDS\s+(\d+)/m);
+    return m ? Number(m[1]) : 6;
+};
+
+const zigzag = (v) => ((v << 1) ^ (v >> 31)) >>> 0;
+
+const varint = (bytes, value) => {
+    while (value >= 0x80) {
+        bytes.push((value & 0x7F) | 0x80);
+        value = Math.floor(value / 128);
+    }
+    bytes.push(value);
+};
+
+/**
+ * historyChunk payload (main/zigbee_core.h) with a deterministic drying curve:
+ * the oldest reading absolute, then reading_codec_encode() records
+ */
+const encodeChunk = (chunk, records) => {
+    const reading = (n) => ({time: n * 600, moisture: 7000 - (n % 5000), temperature: (n % 4000) - 1000});
+    const first = reading(chunk * records);
+    const head = Buffer.alloc(11);
+    head.writeUInt8(2, 0);
+    head.writeUInt8(chunk & 0xFF, 1);
+    head.writeUInt8(records, 2);
+    head.writeUInt32LE(1000000, 3);
+    head.writeUInt16LE(first.moisture, 7);
+    head.writeInt16LE(first.temperature, 9);
+    const bytes = [];
+    let last = first;
+    let interval = 0;
+    for (let i = 1; i < records; i++) {
+        const r = reading(chunk * records + i);
+        const dt = r.time - last.time;
+        const zTime = zigzag(dt - interval);
+        const zMoisture = zigzag(((r.moisture - last.moisture) << 16) >> 16);
+        const zTemp = zigzag(((r.temperature - last.temperature) << 16) >> 16);
+        const m = Math.min(zMoisture, 15);
+        const c = Math.min(zTemp, 6);
+        bytes.push((dt !== interval ? 0x80 : 0) | (m << 3) | c);
+        if (dt !== interval) {
+            varint(bytes, zTime);
+        }
+        if (m === 15) {
+            varint(bytes, zMoisture);
+        }
+        if (c === 6) {
+            varint(bytes, zTemp);
+        }
+        last = r;
+        interval = dt;
+    }
+    const buf = Buffer.concat([head, Buffer.from(bytes)]);
+    if (buf.length > MAX_CHUNK_LEN) {
+        throw new Error(`historyChunk x${records} takes ${buf.length} bytes`);
+    }
+    return buf;
+};
+
+// sample_window record (main/sample_window.h)
+const encodeWindow = (n) => {
+    const buf = Buffer.alloc(21);
+    buf.writeUInt8(1, 0);
+    buf.writeUInt16LE(12, 1);
+    buf.writeUInt16LE(60, 3);
+    [6900, 7100, 7000, 50].forEach((v, i) => buf.writeUInt16LE(v + (n % 100), 5 + i * 2));
+    [1900, 2100, 2000, 30].forEach((v, i) => buf.writeInt16LE(v + (n % 100), 13 + i * 2));
+    return buf;
+};
+
+/**
+ * Deliver every message; returns seconds spent in dispatch
+ */
+const run = (coordinator, messages, check) => {
+    const start = process.hrtime.bigint();
+    for (let i = 0; i < messages.length; i++) {
+        check(coordinator.deliver(messages[i]), i);
+    }
+    return Number(process.hrtime.bigint() - start) / 1e9;
+};
+
+const main = async () => {
+    let count = DEFAULT_MESSAGES;
+    let records = firmwareChunkRecords();
+    let minRate = 0;
+    const args = process.argv.slice(2);
+    for (let i = 0; i < args.length; i++) {
+        if (args[i] === '--messages' && i + 1 < args.length) {
+            count = Number(args[++i]);
+        } else if (args[i] === '--records' && i + 1 < args.length) {
+            records = Number(args[++i]);
+        } else if (args[i] === '--min-rate' && i + 1 < args.length) {
+            minRate = Number(args[++i]);
+        } else {
+            usage();
+        }
+    }
+    if (!(count > 0) || !(records >= 1 && records <= MAX_RECORDS) || !(minRate >= 0)) {
+        usage();
+    }
+
+    const coordinator = new Coordinator(loadConverter());
+    await coordinator.start();
+
+    const history = Array.from({length: count}, (_, i) => ({type: 'attributeReport',
+        cluster: 'manuSpecificGlyphStats', data: {historyChunk: encodeChunk(i, records)}}));
+    const windows = Array.from({length: count}, (_, i) => ({type: 'attributeReport',
+        cluster: 'manuSpecificGlyphStats', data: {windowStats: encodeWindow(i)}}));
+
+    let readings = 0;
+    const chunkBytes = history.reduce((sum, m) => sum + m.data.historyChunk.length, 0) / count;
+    const checkChunk = (payload, i) => {
+        const last = (i + 1) * records - 1;
+        const reading = payload.history && payload.history[records - 1];
+        if (!reading || payload.history_chunk !== (i & 0xFF) ||
+            Math.round(reading.soil_moisture * 100) !== 7000 - (last % 5000) ||
+            Math.round(reading.soil_temperature * 100) !== (last % 4000) - 1000) {
+            throw new Error(`historyChunk ${i} decoded wrong: ${JSON.stringify(payload).slice(0, 200)}`);
+        }
+        readings += payload.history.length;
+    };
+    const checkWindow = (payload, i) => {
+        if (payload.window_samples !== 12 ||
+            Math.round(payload.soil_moisture_mean * 100) !== 7000 + (i % 100)) {
+            throw new Error(`windowStats ${i} decoded wrong: ${JSON.stringify(payload)}`);
+        }
+    };
+
+    run(coordinator, history.slice(0, WARMUP_MESSAGES), checkChunk);
+    run(coordinator, windows.slice(0, WARMUP_MESSAGES), checkWindow);
+    readings = 0;
+    const historyS = run(coordinator, history, checkChunk);
+    const windowS = run(coordinator, windows, checkWindow);
+
+    const historyRate = count / historyS;
+    console.log(`Converter dispatch on node ${process.version}, ${count} messages per kind`);
+    console.log(`${'message'.padEnd(24)} ${'bytes'.padStart(6)} ${'msg/s'.padStart(10)} ` +
+        `${'readings/s'.padStart(11)} ${'us/msg'.padStart(8)}`);
+    console.log(`${`historyChunk x${records}`.padEnd(24)} ${chunkBytes.toFixed(0).padStart(6)} ` +
+        `${historyRate.toFixed(0).padStart(10)} ${(readings / historyS).toFixed(0).padStart(11)} ` +
+        `${(historyS * 1e6 / count).toFixed(2).padStart(8)}`);
+    console.log(`${'windowStats'.padEnd(24)} ${'21'.padStart(6)} ${(count / windowS).toFixed(0).padStart(10)} ` +
+        `${'-'.padStart(11)} ${(windowS * 1e6 / count).toFixed(2).padStart(8)}`);
+
+    if (minRate > 0 && historyRate < minRate) {
+        console.log(`FAIL: historyChunk rate ${historyRate.toFixed(0)} msg/s below ${minRate}`);
+        return 1;
+    }
+    return 0;
+};
+
+main().then((code) => process.exit(code), (err) => {
+    console.error(`bench_converter: ${err.message}`);
+    process.exit(1);
+});
@@ -0,0 +1,357 @@
+/**
+ * Local zigbee-herdsman stand-in for the Glyph C6 converter harness
+ *
+ * Loads ../glyph_c6_converter.js without npm packages: the four modules it
+ * requires are answered from here. The stand-in covers what the converter
+ * uses, with the semantics Zigbee2MQTT gives them:
+ *
+ * - Zcl.DataType codes and the standard clusters the device reports on
+ * - a mocked device and endpoint that log writes, reads, commands, binds
+ *   and reporting configuration, and hold the custom clusters the
+ *   converter adds
+ * - ZCL attribute value decoding, so recorded raw reports (cluster and
+ *   attribute IDs, value bytes) become the msg.data herdsman would emit
+ * - fromZigbee dispatch (cluster + message type, results merged into the
+ *   device state) and toZigbee set/get dispatch
+ * - exposes presets as plain chainable records
+ */
+
+'use strict';
+
+const Module = require('module');
+const path = require('path');
+
+// ============================================================================
+// ZCL
+// ============================================================================
+
+// ZCL data type codes (ZCL spec table 2-10), as zigbee-herdsman names them
+const DataType = {
+    BOOLEAN: 0x10,
+    BITMAP8: 0x18,
+    UINT8: 0x20,
+    UINT16: 0x21,
+    UINT32: 0x23,
+    INT8: 0x28,
+    INT16: 0x29,
+    INT32: 0x2B,
+    ENUM8: 0x30,
+    OCTET_STR: 0x41,
+    CHAR_STR: 0x42,
+};
+
+// Standard clusters of the device (main/zigbee_core.c endpoints 1 and 2)
+const standardClusters = {
+    genBasic: {ID: 0x0000, attributes: {
+        zclVersion: {ID: 0x0000, type: DataType.UINT8},
+        manufacturerName: {ID: 0x0004, type: DataType.CHAR_STR},
+        modelId: {ID: 0x0005, type: DataType.CHAR_STR},
+        powerSource: {ID: 0x0007, type: DataType.ENUM8},
+        swBuildId: {ID: 0x4000, type: DataType.CHAR_STR},
+    }},
+    genPowerCfg: {ID: 0x0001, attributes: {
+        batteryVoltage: {ID: 0x0020, type: DataType.UINT8},
+        batteryPercentageRemaining: {ID: 0x0021, type: DataType.UINT8},
+    }},
+    genIdentify: {ID: 0x0003, attributes: {
+        identifyTime: {ID: 0x0000, type: DataType.UINT16},
+    }},
+    genOnOff: {ID: 0x0006, attributes: {
+        onOff: {ID: 0x0000, type: DataType.BOOLEAN},
+    }},
+    genOta: {ID: 0x0019, attributes: {}},
+    msTemperatureMeasurement: {ID: 0x0402, attributes: {
+        measuredValue: {ID: 0x0000, type: DataType.INT16},
+        minMeasuredValue: {ID: 0x0001, type: DataType.INT16},
+        maxMeasuredValue: {ID: 0x0002, type: DataType.INT16},
+    }},
+    msRelativeHumidity: {ID: 0x0405, attributes: {
+        measuredValue: {ID: 0x0000, type: DataType.UINT16},
+        minMeasuredValue: {ID: 0x0001, type: DataType.UINT16},
+        maxMeasuredValue: {ID: 0x0002, type: DataType.UINT16},
+    }},
+};
+
+/**
+ * Decode one attribute value (little-endian, strings length-prefixed)
+ * @returns {{value: *, length: number}} value as herdsman emits it
+ */
+const decodeValue = (type, buf, offset = 0) => {
+    switch (type) {
+    case DataType.BOOLEAN:
+    case DataType.BITMAP8:
+    case DataType.UINT8:
+    case DataType.ENUM8:
+        return {value: buf.readUInt8(offset), length: 1};
+    case DataType.INT8:
+        return {value: buf.readInt8(offset), length: 1};
+    case DataType.UINT16:
+        return {value: buf.readUInt16LE(offset), length: 2};
+    case DataType.INT16:
+        return {value: buf.readInt16LE(offset), length: 2};
+    case DataType.UINT32:
+        return {value: buf.readUInt32LE(offset), length: 4};
+    case DataType.INT32:
+        return {value: buf.readInt32LE(offset), length: 4};
+    case DataType.OCTET_STR: {
+        const len = buf.readUInt8(offset);
+        return {value: buf.subarray(offset + 1, offset + 1 + len), length: 1 + len};
+    }
+    case DataType.CHAR_STR: {
+        const len = buf.readUInt8(offset);
+        return {value: buf.toString('latin1', offset + 1, offset + 1 + len), length: 1 + len};
+    }
+    default:
+        throw new Error(`unsupported ZCL data type 0x${type.toString(16)}`);
+    }
+};
+
+// ============================================================================
+// DEVICE
+// ============================================================================
+
+class MockEndpoint {
+    constructor(device, ID) {
+        this.device = device;
+        this.ID = ID;
+        this.calls = [];
+    }
+
+    async write(cluster, payload, options) {
+        this.calls.push({op: 'write', cluster, payload, options});
+    }
+
+    async read(cluster, attributes, options) {
+        this.calls.push({op: 'read', cluster, attributes, options});
+        return {};
+    }
+
+    async command(cluster, command, payload, options) {
+        this.calls.push({op: 'command', cluster, command, payload, options});
+    }
+
+    async bind(cluster, target) {
+        this.calls.push({op: 'bind', cluster, target});
+    }
+
+    async configureReporting(cluster, items, options) {
+        this.calls.push({op: 'configureReporting', cluster, items, options});
+    }
+
+    /**
+     * Logged calls of one kind (and cluster), oldest first
+     */
+    callsOf(op, cluster) {
+        return this.calls.filter((c) => c.op === op && (cluster === undefined || c.cluster === cluster));
+    }
+}
+
+class MockDevice {
+    constructor(modelID) {
+        this.modelID = modelID;
+        this.ieeeAddr = '0x00124b0000c6a1f0';
+        this.customClusters = {};
+        // Soil endpoint, and the ambient one of CONFIG_GLYPH_AMBIENT_SHT4X builds
+        this.endpoints = [new MockEndpoint(this, 1), new MockEndpoint(this, 2)];
+    }
+
+    addCustomCluster(name, cluster) {
+        this.customClusters[name] = cluster;
+    }
+
+    getEndpoint(ID) {
+        return this.endpoints.find((ep) => ep.ID === ID);
+    }
+
+    /**
+     * Cluster by name or numeric ID (custom clusters first, as in herdsman)
+     */
+    findCluster(key) {
+        const all = {...standardClusters, ...this.customClusters};
+        for (const [name, cluster] of Object.entries(all)) {
+            if (name === key || cluster.ID === key) {
+                return {name, ...cluster};
+            }
+        }
+        return undefined;
+    }
+}
+
+// ============================================================================
+// EXPOSES
+// ============================================================================
+
+const access = {STATE: 1, SET: 2, STATE_SET: 3, GET: 4, STATE_GET: 5, ALL: 7};
+
+class Expose {
+    constructor(type, name, accessMask, extra = {}) {
+        Object.assign(this, {type, name, property: name, access: accessMask}, extra);
+    }
+
+    withEndpoint(endpoint) { this.endpoint = endpoint; this.property = `${this.name}_${endpoint}`; return this; }
+    withDescription(description) { this.description = description; return this; }
+    withUnit(unit) { this.unit = unit; return this; }
+    withValueMin(min) { this.value_min = min; return this; }
+    withValueMax(max) { this.value_max = max; return this; }
+    withValueStep(step) { this.value_step = step; return this; }
+    withCategory(category) { this.category = category; return this; }
+}
+
+const presets = {
+    numeric: (name, a) => new Expose('numeric', name, a),
+    binary: (name, a, valueOn, valueOff) => new Expose('binary', name, a, {value_on: valueOn, value_off: valueOff}),
+    enum: (name, a, values) => new Expose('enum', name, a, {values}),
+    text: (name, a) => new Expose('text', name, a),
+    switch: () => new Expose('switch', 'state', access.ALL),
+    battery: () => presets.numeric('battery', access.STATE_GET).withUnit('%').withValueMin(0).withValueMax(100),
+    battery_voltage: () => presets.numeric('voltage', access.STATE_GET).withUnit('mV'),
+    humidity: () => presets.numeric('humidity', access.STATE_GET).withUnit('%'),
+    temperature: () => presets.numeric('temperature', access.STATE_GET).withUnit('°C'),
+};
+
+// ============================================================================
+// MODULE STAND-INS
+// ============================================================================
+
+const standIns = {
+    'zigbee-herdsman': {Zcl: {DataType}},
+    'zigbee-herdsman-converters/converters/fromZigbee': {},
+    'zigbee-herdsman-converters/converters/toZigbee': {},
+    'zigbee-herdsman-converters/lib/exposes': {presets, access},
+    'zigbee-herdsman-converters/lib/reporting': {
+        bind: async (endpoint, target, clusters) => {
+            for (const cluster of clusters) {
+                await endpoint.bind(cluster, target);
+            }
+        },
+    },
+};
+
+const CONVERTER_PATH = path.join(__dirname, '..', 'glyph_c6_converter.js');
+
+/**
+ * Load (or reload) the converter definition against the stand-ins
+ */
+const loadConverter = (file = CONVERTER_PATH) => {
+    const load = Module._load;
+    Module._load = function (request, ...rest) {
+        return Object.prototype.hasOwnProperty.call(standIns, request) ? standIns[request] : load.call(this, request, ...rest);
+    };
+    try {
+        delete require.cache[require.resolve(file)];
+        return require(file);
+    } finally {
+        Module._load = load;
+    }
+};
+
+// ============================================================================
+// COORDINATOR
+// ============================================================================
+
+/**
+ * One paired device as Zigbee2MQTT drives it: state, published payloads,
+ * fromZigbee / toZigbee dispatch and the device lifecycle events
+ */
+class Coordinator {
+    constructor(definition) {
+        this.definition = definition;
+        this.device = new MockDevice(definition.zigbeeModel[0]);
+        this.endpoint = this.device.getEndpoint(1);
+        this.coordinatorEndpoint = {ID: 1, deviceIeeeAddress: '0x00124b0000000000'};
+        this.state = {};
+        this.published = [];
+        this.options = {};
+    }
+
+    async start() {
+        if (this.definition.onEvent) {
+            await this.definition.onEvent('start', {}, this.device);
+        }
+    }
+
+    async configure() {
+        await this.definition.configure(this.device, this.coordinatorEndpoint);
+    }
+
+    /**
+     * Raw recorded report -> herdsman message (msg.data keyed by attribute name)
+     * @param {{type?: string, ep?: number, cluster: number, attr: number, value: string}} raw
+     */
+    decode(raw) {
+        const cluster = this.device.findCluster(raw.cluster);
+        if (!cluster) {
+            throw new Error(`unknown cluster 0x${raw.cluster.toString(16)}`);
+        }
+        const entry = Object.entries(cluster.attributes).find(([, a]) => a.ID === raw.attr);
+        if (!entry) {
+            throw new Error(`unknown attribute 0x${raw.attr.toString(16)} of ${cluster.name}`);
+        }
+        const [name, attr] = entry;
+        const buf = Buffer.from(raw.value, 'hex');
+        const {value, length} = decodeValue(attr.type, buf);
+        if (length !== buf.length) {
+            throw new Error(`${cluster.name}.${name}: ${buf.length} value bytes, type takes ${length}`);
+        }
+        const endpoint = this.device.getEndpoint(raw.ep || 1);
+        if (!endpoint) {
+            throw new Error(`unknown endpoint ${raw.ep}`);
+        }
+        return {type: raw.type || 'attributeReport', endpoint, cluster: cluster.name, data: {[name]: value}};
+    }
+
+    /**
+     * Deliver one message: run every matching fromZigbee converter, merge
+     * their results into the device state and publish
+     * @param {{type: string, cluster: string, data: object}} msg
+     * @returns {object} the payload converted from this message
+     */
+    deliver(msg) {
+        const full = {endpoint: this.endpoint, device: this.device, linkquality: 120, groupID: 0,
+            meta: {zclTransactionSequenceNumber: 1}, ...msg};
+        const meta = {state: this.state, device: this.device, logger: console};
+        const payload = {};
+        for (const converter of this.definition.fromZigbee) {
+            const types = Array.isArray(converter.type) ? converter.type : [converter.type];
+            if (converter.cluster !== full.cluster || !types.includes(full.type)) {
+                continue;
+            }
+            const result = converter.convert(this.definition, full, () => {}, this.options, meta);
+            if (result) {
+                Object.assign(payload, result);
+            }
+        }
+        if (Object.keys(payload).length > 0) {
+            this.state = {...this.state, ...payload};
+            this.published.push(payload);
+        }
+        return payload;
+    }
+
+    toZigbee(key) {
+        const converter = this.definition.toZigbee.find((c) => c.key.includes(key));
+        if (!converter) {
+            throw new Error(`no toZigbee converter for ${key}`);
+        }
+        return converter;
+    }
+
+    async set(key, value) {
+        const meta = {device: this.device, state: this.state, message: {[key]: value}, options: this.options,
+            logger: console, endpoint_name: undefined};
+        const result = await this.toZigbee(key).convertSet(this.endpoint, key, value, meta);
+        if (result && result.state) {
+            this.state = {...this.state, ...result.state};
+        }
+        return result;
+    }
+
+    async get(key) {
+        const meta = {device: this.device, state: this.state, message: {[key]: ''}, options: this.options,
+            logger: console};
+        return this.toZigbee(key).convertGet(this.endpoint, key, meta);
+    }
+}
+
+module.exports = {DataType, standardClusters, decodeValue, MockDevice, MockEndpoint, presets, access,
+    loadConverter, Coordinator};
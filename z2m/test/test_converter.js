@@ -0,0 +1,372 @@
+/**
+ * Glyph C6 converter tests (Node.js, no npm packages)
+ *
+ *     node test_converter.js [PREFIX] [--recording FILE]
+ *
+ * Loads ../glyph_c6_converter.js on the local zigbee-herdsman stand-in
+ * (herdsman.js) and checks:
+ *
+ * - fixtures: every recorded report / read response of fixtures/reports.json
+ *   publishes the expected state
+ * - converter: toZigbee writes, reads and commands, configure(), exposes,
+ *   and the custom cluster layout against main/zigbee_core.h
+ * - recording: with --recording, the reports the host build of the firmware
+ *   sent (host/bench/z2m_record) all decode, and the history pull they
+ *   contain reproduces the readings of the flash history exactly
+ *
+ * PREFIX selects tests by "suite.name" prefix, as host_tests does.
+ */
+
+'use strict';
+
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+const {loadConverter, Coordinator, DataType} = require('./herdsman');
+
+const FIXTURES = path.join(__dirname, 'fixtures', 'reports.json');
+const FIRMWARE_DIR = path.join(__dirname, '..', '..', 'main');
+const TOLERANCE = 1e-9;
+const AGE_TOLERANCE_S = 2;         // History times are published as wall clock
+
+const tests = [];
+const test = (suite, name, fn) => tests.push({suite, name, fn});
+
+// ============================================================================
+// HELPERS
+// ============================================================================
+
+const newCoordinator = async () => {
+    const coordinator = new Coordinator(loadConverter());
+    await coordinator.start();
+    return coordinator;
+};
+
+const ageOf = (isoTime) => (Date.now() - Date.parse(isoTime)) / 1000;
+
+/**
+ * Match a published payload against a fixture expectation ("<now>" is any
+ * timestamp of the last few seconds, history readings are matched by age)
+ */
+const expectPayload = (payload, expect, where) => {
+    for (const [key, want] of Object.entries(expect)) {
+        const got = payload[key];
+        const at = `${where}: ${key}`;
+        if (want === '<now>') {
+            assert.ok(typeof got === 'string' && Math.abs(ageOf(got)) < AGE_TOLERANCE_S, `${at} = ${got}, want now`);
+        } else if (key === 'history') {
+            assert.ok(Array.isArray(got), `${at} missing`);
+            assert.strictEqual(got.length, want.length, `${at} length`);
+            want.forEach((reading, i) => {
+                assert.ok(Math.abs(ageOf(got[i].time) - reading.age) < AGE_TOLERANCE_S,
+                    `${at}[${i}] age ${ageOf(got[i].time)}, want ${reading.age}`);
+                expectPayload(got[i], {soil_moisture: reading.soil_moisture,
+                    soil_temperature: reading.soil_temperature}, `${at}[${i}]`);
+            });
+        } else if (typeof want === 'number') {
+            assert.ok(typeof got === 'number' && Math.abs(got - want) < TOLERANCE, `${at} = ${got}, want ${want}`);
+        } else {
+            assert.deepStrictEqual(got, want, at);
+        }
+    }
+};
+
+/**
+ * #define NAME VALUE // comment, of a firmware header
+ */
+const firmwareDefines = (header) => {
+    const defines = {};
+    const text = fs.readFileSync(path.join(FIRMWARE_DIR, header), 'utf8');
+    for (const m of text.matchAll(/^#define\s+(\w+)\s+(0x[0-9A-Fa-f]+|\d+)\b(?:\s*\/\/\s*(.*))?$/gm)) {
+        // "// U16: moisture deadband", "// Octet string (write): ..." -> U16, Octet string
+        const type = m[3] ? m[3].split(':')[0].replace(/\(.*\)/, '').trim() : undefined;
+        defines[m[1]] = {value: Number(m[2]), type};
+    }
+    return defines;
+};
+
+// Attribute types in main/zigbee_core.h comments -> ZCL data types
+const firmwareTypes = {'U8': DataType.UINT8, 'U16': DataType.UINT16, 'U32': DataType.UINT32,
+    'Bool': DataType.BOOLEAN, 'Octet string': DataType.OCTET_STR};
+
+// ============================================================================
+// FIXTURES
+// ============================================================================
+
+for (const fixture of JSON.parse(fs.readFileSync(FIXTURES, 'utf8')).cases) {
+    test('fixtures', fixture.name, async () => {
+        const coordinator = await newCoordinator();
+        coordinator.state = {...(fixture.state || {})};
+        let payload = {};
+        for (const raw of fixture.messages) {
+            payload = coordinator.deliver(coordinator.decode(raw));
+        }
+        expectPayload(payload, fixture.expect, fixture.name);
+        for (const key of fixture.absent || []) {
+            assert.ok(!(key in payload), `${fixture.name}: unexpected ${key}`);
+        }
+        if (fixture.state_after) {
+            expectPayload(coordinator.state, fixture.state_after, `${fixture.name} (state)`);
+        }
+    });
+}
+
+// ============================================================================
+// CONVERTER
+// ============================================================================
+
+test('converter', 'custom_clusters_match_firmware', async () => {
+    const coordinator = await newCoordinator();
+    const defines = {...firmwareDefines('zigbee_core.h'), ...firmwareDefines('system_config.h')};
+    const stats = coordinator.device.customClusters.manuSpecificGlyphStats;
+    const config = coordinator.device.customClusters.manuSpecificGlyphConfig;
+    assert.ok(stats && config, 'custom clusters not added on start');
+
+    const manufacturer = defines.ESP_MANUFACTURER_CODE.value;
+    for (const [cluster, prefix, define] of [[stats, 'GLYPH_ATTR_', 'GLYPH_CLUSTER_ID_STATS'],
+        [config, 'GLYPH_ATTR_CFG_', 'GLYPH_CLUSTER_ID_CONFIG']]) {
+        assert.strictEqual(cluster.ID, defines[define].value, define);
+        assert.strictEqual(cluster.manufacturerCode, manufacturer, `${define} manufacturer code`);
+
+        const firmware = Object.entries(defines)
+            .filter(([name]) => name.startsWith(prefix) && name.endsWith('_ID') &&
+                (prefix === 'GLYPH_ATTR_CFG_') === name.startsWith('GLYPH_ATTR_CFG_'))
+            .map(([name, d]) => ({name, ID: d.value, type: firmwareTypes[d.type]}))
+            .sort((a, b) => a.ID - b.ID);
+        const converter = Object.values(cluster.attributes).sort((a, b) => a.ID - b.ID);
+        assert.deepStrictEqual(converter.map((a) => a.ID), firmware.map((a) => a.ID), `${define} attribute IDs`);
+        firmware.forEach((a, i) => {
+            assert.strictEqual(converter[i].type, a.type, `${a.name} type`);
+        });
+    }
+});
+
+test('converter', 'exposes_cover_converters', async () => {
+    const {definition} = await newCoordinator();
+    const exposes = new Map(definition.exposes.map((e) => [e.name, e]));
+    assert.strictEqual(exposes.size, definition.exposes.length, 'duplicate expose names');
+    for (const converter of definition.toZigbee) {
+        for (const key of converter.key) {
+            const expose = exposes.get(key);
+            assert.ok(expose, `toZigbee key ${key} not exposed`);
+            assert.ok(expose.access & 2, `${key} exposed without SET access`);
+            if (converter.convertGet) {
+                assert.ok(expose.access & 4, `${key} has convertGet but no GET access`);
+            }
+        }
+    }
+});
+
+test('converter', 'configure_binds_and_reads', async () => {
+    const coordinator = await newCoordinator();
+    await coordinator.configure();
+    const ep = coordinator.endpoint;
+    assert.deepStrictEqual(ep.callsOf('bind').map((c) => c.cluster),
+        ['genOnOff', 'genPowerCfg', 'msRelativeHumidity', 'msTemperatureMeasurement']);
+    const ambient = coordinator.device.getEndpoint(firmwareDefines('system_config.h').HA_ESP_AMBIENT_ENDPOINT.value);
+    assert.deepStrictEqual(ambient.callsOf('bind').map((c) => c.cluster),
+        ['msRelativeHumidity', 'msTemperatureMeasurement']);
+    const reporting = ep.callsOf('configureReporting', 'genPowerCfg').map((c) => c.items[0].attribute);
+    assert.deepStrictEqual(reporting, ['batteryPercentageRemaining', 'batteryVoltage']);
+    const configRead = ep.callsOf('read', 'manuSpecificGlyphConfig')[0];
+    assert.ok(configRead, 'configuration not read back');
+    const attributes = coordinator.device.customClusters.manuSpecificGlyphConfig.attributes;
+    assert.deepStrictEqual([...configRead.attributes].sort(), Object.keys(attributes).sort());
+});
+
+test('converter', 'history_request_write', async () => {
+    const coordinator = await newCoordinator();
+    const result = await coordinator.set('history_request', 24);
+    const [write] = coordinator.endpoint.callsOf('write', 'manuSpecificGlyphStats');
+    const payload = write.payload.historyRequest;
+    assert.strictEqual(payload.length, 8);
+    assert.strictEqual(payload.readUInt32LE(0), 24 * 3600, 'start age');
+    assert.strictEqual(payload.readUInt32LE(4), 0, 'end age');
+    assert.deepStrictEqual(result.state, {history_request: 24});
+});
+
+test('converter', 'config_write_is_scaled', async () => {
+    const coordinator = await newCoordinator();
+    await coordinator.set('battery_moisture_deadband', 2.5);
+    await coordinator.set('usb_sample_interval', 120);
+    const ep = coordinator.endpoint;
+    assert.deepStrictEqual(ep.callsOf('write', 'manuSpecificGlyphConfig').map((c) => c.payload),
+        [{battMoistureDeadband: 250}, {usbSampleInterval: 120}]);
+    // Each write is followed by a read of the pending flag
+    assert.deepStrictEqual(ep.callsOf('read', 'manuSpecificGlyphConfig').map((c) => c.attributes),
+        [['configPending'], ['configPending']]);
+});
+
+test('converter', 'config_get_reads_attribute', async () => {
+    const coordinator = await newCoordinator();
+    await coordinator.get('sense_interval');
+    assert.deepStrictEqual(coordinator.endpoint.callsOf('read', 'manuSpecificGlyphConfig')[0].attributes,
+        ['senseInterval']);
+});
+
+test('converter', 'freshness_latency_adds_transit', async () => {
+    const coordinator = await newCoordinator();
+    const report = (acquiredMs, sentMs) => {
+        const record = Buffer.alloc(9);
+        record.writeUInt8(1, 0);
+        record.writeUInt32LE(acquiredMs, 1);
+        record.writeUInt32LE(sentMs, 5);
+        return coordinator.deliver({type: 'attributeReport', cluster: 'manuSpecificGlyphStats',
+            data: {freshness: record}});
+    };
+    // The first report is the transit reference
+    assert.strictEqual(report(98000, 100000).sample_to_receive_latency, 2);
+    // Arrives now but was sent 5 s before the reference: 5 s in transit
+    const late = report(94000, 95000);
+    assert.strictEqual(late.reading_age, 1);
+    assert.ok(Math.abs(late.sample_to_receive_latency - 6) < 0.5, `latency ${late.sample_to_receive_latency}`);
+    // Device clock restarted: more than a minute "in transit" resets the reference
+    assert.strictEqual(report(1000, 3000).sample_to_receive_latency, 2);
+});
+
+test('converter', 'led_command', async () => {
+    const coordinator = await newCoordinator();
+    await coordinator.set('state', 'on');
+    await coordinator.set('state', 'OFF');
+    assert.deepStrictEqual(coordinator.endpoint.callsOf('command', 'genOnOff').map((c) => c.command), ['on', 'off']);
+    assert.strictEqual(coordinator.state.state, 'OFF');
+});
+
+// ============================================================================
+// RECORDING
+// ============================================================================
+
+const recordingIndex = process.argv.indexOf('--recording');
+const recordingPath = recordingIndex > 0 ? process.argv[recordingIndex + 1] : undefined;
+
+if (recordingPath) {
+    const loadRecording = () => JSON.parse(fs.readFileSync(recordingPath, 'utf8'));
+
+    test('recording', 'every_report_publishes', async () => {
+        const recording = loadRecording();
+        const coordinator = await newCoordinator();
+        assert.ok(recording.messages.length > 0, 'empty recording');
+        recording.messages.forEach((raw, i) => {
+            const payload = coordinator.deliver(coordinator.decode(raw));
+            assert.ok(Object.keys(payload).length > 0, `message ${i} (t=${raw.t_ms} ms) published nothing`);
+        });
+        const state = coordinator.state;
+        assert.ok(state.soil_moisture >= 0 && state.soil_moisture <= 100, `soil_moisture ${state.soil_moisture}`);
+        assert.ok(state.soil_temperature > -40 && state.soil_temperature < 85, `soil_temperature ${state.soil_temperature}`);
+        assert.ok(state.battery >= 0 && state.battery <= 100, `battery ${state.battery}`);
+        assert.ok(state.voltage > 2500 && state.voltage < 4500, `voltage ${state.voltage}`);
+        assert.ok(state.watering_events > 0 && state.last_watering, 'no watering event over the recording');
+        assert.ok(state.ambient_temperature > -40 && state.ambient_temperature < 85,
+            `ambient_temperature ${state.ambient_temperature}`);
+        assert.ok(state.ambient_humidity >= 0 && state.ambient_humidity <= 100, `ambient_humidity ${state.ambient_humidity}`);
+    });
+
+    test('recording', 'window_stats_consistent', async () => {
+        const coordinator = await newCoordinator();
+        let windows = 0;
+        for (const raw of loadRecording().messages) {
+            const p = coordinator.deliver(coordinator.decode(raw));
+            if (p.window_samples === undefined) {
+                continue;
+            }
+            windows++;
+            assert.ok(p.window_samples > 0, `empty window at ${raw.t_ms} ms`);
+            for (const q of ['soil_moisture', 'soil_temperature']) {
+                assert.ok(p[`${q}_min`] <= p[`${q}_mean`] && p[`${q}_mean`] <= p[`${q}_max`],
+                    `${q} min/mean/max out of order at ${raw.t_ms} ms`);
+                assert.ok(p[`${q}_stddev`] >= 0, `${q} stddev at ${raw.t_ms} ms`);
+            }
+        }
+        assert.ok(windows > 0, 'no windowStats report');
+    });
+
+    test('recording', 'every_reading_has_freshness', async () => {
+        const coordinator = await newCoordinator();
+        let readings = 0;
+        let total = 0;
+        for (const raw of loadRecording().messages) {
+            const p = coordinator.deliver(coordinator.decode(raw));
+            if (p.soil_moisture !== undefined) {
+                readings++;
+            }
+            if (p.reading_age === undefined) {
+                continue;
+            }
+            assert.ok(p.reading_age >= 0 && p.sample_to_receive_latency >= p.reading_age,
+                `age ${p.reading_age} s, latency ${p.sample_to_receive_latency} s at ${raw.t_ms} ms`);
+            // One count per report, from 1 again after a chip reset
+            const counted = Object.values(p.reading_age_histogram).reduce((a, b) => a + b, 0);
+            assert.ok(counted === total + 1 || counted === 1, `histogram total ${counted} after ${total}`);
+            total = counted;
+            readings--;
+        }
+        assert.ok(total > 0, 'no freshness report');
+        assert.strictEqual(readings, 0, 'soil readings without a freshness record');
+    });
+
+    test('recording', 'history_pull_matches_flash', async () => {
+        const recording = loadRecording();
+        const coordinator = await newCoordinator();
+        const readings = [];
+        let nextChunk = 0;
+        let complete = false;
+        for (const raw of recording.messages) {
+            const p = coordinator.deliver(coordinator.decode(raw));
+            if (p.history_complete === undefined) {
+                continue;
+            }
+            assert.ok(!complete, 'history chunk after completion');
+            if (p.history_complete) {
+                complete = true;
+                continue;
+            }
+            assert.strictEqual(p.history_chunk, nextChunk++ & 0xFF, 'chunk sequence');
+            readings.push(...p.history);
+        }
+        assert.ok(complete, 'history pull never completed');
+        assert.strictEqual(readings.length, recording.history.length, 'readings pulled');
+        recording.history.forEach(([moisture, temp], i) => {
+            assert.strictEqual(Math.round(readings[i].soil_moisture * 100), moisture, `reading ${i} moisture`);
+            assert.strictEqual(Math.round(readings[i].soil_temperature * 100), temp, `reading ${i} temperature`);
+            assert.ok(i === 0 || Date.parse(readings[i].time) >= Date.parse(readings[i - 1].time),
+                `reading ${i} out of time order`);
+        });
+        const oldest = ageOf(readings[0].time);
+        assert.ok(oldest <= recording.history_request_hours * 3600 + AGE_TOLERANCE_S,
+            `oldest reading ${oldest} s outside the requested range`);
+    });
+}
+
+// ============================================================================
+// RUNNER
+// ============================================================================
+
+const main = async () => {
+    const prefix = process.argv.slice(2).find((arg, i, args) => !arg.startsWith('--') &&
+        args[i - 1] !== '--recording') || '';
+    let run = 0;
+    let failed = 0;
+    for (const t of tests) {
+        const full = `${t.suite}.${t.name}`;
+        if (!full.startsWith(prefix)) {
+            continue;
+        }
+        run++;
+        try {
+            await t.fn();
+            console.log(`[ PASS ] ${full}`);
+        } catch (err) {
+            console.log(`    ${err.message}`);
+            console.log(`[ FAIL ] ${full}`);
+            failed++;
+        }
+    }
+    console.log(`${run} test(s), ${failed} failed`);
+    if (run === 0) {
+        console.log(`No test matches '${prefix}'`);
+        return 1;
+    }
+    return failed ? 1 : 0;
+};
+
+main().then((code) => process.exit(code));